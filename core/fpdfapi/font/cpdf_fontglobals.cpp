@@ -22,6 +22,7 @@
 namespace {
 
 CPDF_FontGlobals* g_FontGlobals = nullptr;
+thread_local CPDF_FontGlobals* g_ThreadFontGlobals = nullptr;
 
 RetainPtr<const CPDF_CMap> LoadPredefinedCMap(ByteStringView name) {
   if (!name.IsEmpty() && name[0] == '/') {
@@ -47,10 +48,26 @@ void CPDF_FontGlobals::Destroy() {
 
 // static
 CPDF_FontGlobals* CPDF_FontGlobals::GetInstance() {
+  if (g_ThreadFontGlobals) {
+    return g_ThreadFontGlobals;
+  }
   DCHECK(g_FontGlobals);
   return g_FontGlobals;
 }
 
+// static
+void CPDF_FontGlobals::CreateForCurrentThread() {
+  DCHECK(!g_ThreadFontGlobals);
+  g_ThreadFontGlobals = new CPDF_FontGlobals();
+}
+
+// static
+void CPDF_FontGlobals::DestroyForCurrentThread() {
+  DCHECK(g_ThreadFontGlobals);
+  delete g_ThreadFontGlobals;
+  g_ThreadFontGlobals = nullptr;
+}
+
 CPDF_FontGlobals::CPDF_FontGlobals() = default;
 
 CPDF_FontGlobals::~CPDF_FontGlobals() = default;
@@ -29,6 +29,11 @@ class CPDF_FontGlobals {
   static void Destroy();
   static CPDF_FontGlobals* GetInstance();
 
+  // Per-thread instance which shadows the process-wide one on the calling
+  // thread. See CFX_GEModule::CreateForCurrentThread().
+  static void CreateForCurrentThread();
+  static void DestroyForCurrentThread();
+
   // Caller must load the maps before using font globals.
   void LoadEmbeddedMaps();
 
@@ -25,6 +25,7 @@
 #include "core/fpdfapi/page/cpdf_indexedcs.h"
 #include "core/fpdfapi/page/cpdf_pattern.h"
 #include "core/fpdfapi/page/cpdf_patterncs.h"
+#include "core/fpdfapi/page/lab_simd.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
@@ -45,6 +46,7 @@
 #include "core/fxcrt/maybe_owned.h"
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/scoped_set_insertion.h"
+#include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxcrt/zip.h"
 #include "core/fxge/dib/fx_dib.h"
@@ -188,6 +190,8 @@ class CPDF_LabCS final : public CPDF_ColorSpace {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void GetRGBs(pdfium::span<const float> comps,
+               pdfium::span<FX_RGB_STRUCT<float>> rgbs) const override;
   void GetDefaultValue(int iComponent,
                        float* value,
                        float* min,
@@ -220,6 +224,8 @@ class CPDF_ICCBasedCS final : public CPDF_BasedCS {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void GetRGBs(pdfium::span<const float> comps,
+               pdfium::span<FX_RGB_STRUCT<float>> rgbs) const override;
   RetainPtr<CPDF_IccProfile> GetIccProfile() const override;
   void TranslateImageLine(pdfium::span<uint8_t> dest_span,
                           pdfium::span<const uint8_t> src_span,
@@ -258,6 +264,8 @@ class CPDF_SeparationCS final : public CPDF_BasedCS {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void GetRGBs(pdfium::span<const float> comps,
+               pdfium::span<FX_RGB_STRUCT<float>> rgbs) const override;
   void GetDefaultValue(int iComponent,
                        float* value,
                        float* min,
@@ -281,6 +289,8 @@ class CPDF_DeviceNCS final : public CPDF_BasedCS {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void GetRGBs(pdfium::span<const float> comps,
+               pdfium::span<FX_RGB_STRUCT<float>> rgbs) const override;
   void GetDefaultValue(int iComponent,
                        float* value,
                        float* min,
@@ -366,15 +376,26 @@ class Matrix_3by3 {
   float i;
 };
 
-float RGB_Conversion(float colorComponent) {
+// How many colors TranslateImageLine() converts with each GetRGBs() call.
+constexpr size_t kTranslateChunkPixels = 256;
+
+// The index into the sRGB samples for `colorComponent`, in [0, 1023].
+int RGB_ConversionScale(float colorComponent) {
   colorComponent = std::clamp(colorComponent, 0.0f, 1.0f);
-  int scale = std::max(static_cast<int>(colorComponent * 1023), 0);
+  return std::max(static_cast<int>(colorComponent * 1023), 0);
+}
+
+float RGB_ConversionFromScale(int scale) {
   if (scale < 192) {
     return kSRGBSamples1[scale] / 255.0f;
   }
   return kSRGBSamples2[scale / 4 - 48] / 255.0f;
 }
 
+float RGB_Conversion(float colorComponent) {
+  return RGB_ConversionFromScale(RGB_ConversionScale(colorComponent));
+}
+
 FX_RGB_STRUCT<float> XYZ_to_sRGB(float X, float Y, float Z) {
   const float R1 = 3.2410f * X - 1.5374f * Y - 0.4986f * Z;
   const float G1 = -0.9692f * X + 1.8760f * Y + 0.0416f * Z;
@@ -451,6 +472,39 @@ class StockColorSpaces {
 };
 
 StockColorSpaces* g_stock_colorspaces = nullptr;
+thread_local StockColorSpaces* g_thread_stock_colorspaces = nullptr;
+
+// Runs `func` on each color in `comps`, which has `input_count` values for
+// each, and converts the results in `base_cs`. Gives the same results as
+// CPDF_SeparationCS::GetRGB() and CPDF_DeviceNCS::GetRGB() do for one color at
+// a time, but with one call to `base_cs`.
+void GetRGBsThroughFunction(const CPDF_Function& func,
+                            const CPDF_ColorSpace& base_cs,
+                            size_t input_count,
+                            pdfium::span<const float> comps,
+                            pdfium::span<FX_RGB_STRUCT<float>> rgbs) {
+  const size_t base_count = base_cs.ComponentCount();
+  // Using at least 16 elements, as GetRGB() does.
+  std::vector<float> results(std::max(func.OutputCount(), 16u));
+  std::vector<float> base_comps(rgbs.size() * base_count);
+  std::vector<bool> failed(rgbs.size());
+  for (size_t i = 0; i < rgbs.size(); ++i) {
+    std::ranges::fill(results, 0.0f);
+    if (!func.Call(comps.subspan(i * input_count, input_count), results)
+             .value_or(0)) {
+      failed[i] = true;
+      continue;
+    }
+    fxcrt::spancpy(pdfium::span(base_comps).subspan(i * base_count),
+                   pdfium::span(results).first(base_count));
+  }
+  base_cs.GetRGBs(base_comps, rgbs);
+  for (size_t i = 0; i < rgbs.size(); ++i) {
+    if (failed[i]) {
+      rgbs[i] = FX_RGB_STRUCT<float>{};
+    }
+  }
+}
 
 }  // namespace
 
@@ -476,8 +530,23 @@ void CPDF_ColorSpace::DestroyGlobals() {
   g_stock_colorspaces = nullptr;
 }
 
+// static
+void CPDF_ColorSpace::InitializeGlobalsForCurrentThread() {
+  CHECK(!g_thread_stock_colorspaces);
+  g_thread_stock_colorspaces = new StockColorSpaces();
+}
+
+// static
+void CPDF_ColorSpace::DestroyGlobalsForCurrentThread() {
+  delete g_thread_stock_colorspaces;
+  g_thread_stock_colorspaces = nullptr;
+}
+
 // static
 RetainPtr<CPDF_ColorSpace> CPDF_ColorSpace::GetStockCS(Family family) {
+  if (g_thread_stock_colorspaces) {
+    return g_thread_stock_colorspaces->GetStockCS(family);
+  }
   return g_stock_colorspaces->GetStockCS(family);
 }
 
@@ -637,6 +706,14 @@ void CPDF_ColorSpace::GetDefaultValue(int iComponent,
   *max = 1.0f;
 }
 
+void CPDF_ColorSpace::GetRGBs(pdfium::span<const float> comps,
+                              pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  const size_t count = components_;
+  for (size_t i = 0; i < rgbs.size(); ++i) {
+    rgbs[i] = GetRGBOrZerosOnError(comps.subspan(i * count, count));
+  }
+}
+
 void CPDF_ColorSpace::TranslateImageLine(pdfium::span<uint8_t> dest_span,
                                          pdfium::span<const uint8_t> src_span,
                                          int pixels,
@@ -647,21 +724,27 @@ void CPDF_ColorSpace::TranslateImageLine(pdfium::span<uint8_t> dest_span,
   // generic base implementation are CMYK.
   CHECK(!bTransMask);
 
-  uint8_t* dest_buf = dest_span.data();
-  const uint8_t* src_buf = src_span.data();
-  std::vector<float> src(components_);
+  auto bgr_span = fxcrt::reinterpret_span<FX_BGR_STRUCT<uint8_t>>(dest_span);
+  src_span = src_span.first(static_cast<size_t>(pixels) * components_);
+  std::vector<float> src(kTranslateChunkPixels * components_);
+  std::array<FX_RGB_STRUCT<float>, kTranslateChunkPixels> rgbs;
   const int divisor = family_ != Family::kIndexed ? 255 : 1;
-  UNSAFE_TODO({
-    for (int i = 0; i < pixels; i++) {
-      for (uint32_t j = 0; j < components_; j++) {
-        src[j] = static_cast<float>(*src_buf++) / divisor;
-      }
-      auto rgb = GetRGBOrZerosOnError(src);
-      *dest_buf++ = static_cast<int32_t>(rgb.blue * 255);
-      *dest_buf++ = static_cast<int32_t>(rgb.green * 255);
-      *dest_buf++ = static_cast<int32_t>(rgb.red * 255);
+  while (!src_span.empty()) {
+    const size_t chunk_size = std::min(src_span.size(), src.size());
+    auto chunk_src = pdfium::span(src).first(chunk_size);
+    for (auto [in, out] : fxcrt::Zip(src_span.first(chunk_size), chunk_src)) {
+      out = static_cast<float>(in) / divisor;
     }
-  });
+    auto chunk_rgbs = pdfium::span(rgbs).first(chunk_size / components_);
+    GetRGBs(chunk_src, chunk_rgbs);
+    for (auto [rgb, bgr] : fxcrt::Zip(chunk_rgbs, bgr_span)) {
+      bgr.blue = static_cast<int32_t>(rgb.blue * 255);
+      bgr.green = static_cast<int32_t>(rgb.green * 255);
+      bgr.red = static_cast<int32_t>(rgb.red * 255);
+    }
+    src_span = src_span.subspan(chunk_size);
+    bgr_span = bgr_span.subspan(chunk_rgbs.size());
+  }
 }
 
 void CPDF_ColorSpace::EnableStdConversion(bool bEnabled) {
@@ -900,6 +983,27 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_LabCS::GetRGB(
   return XYZ_to_sRGB(X, Y, Z);
 }
 
+void CPDF_LabCS::GetRGBs(pdfium::span<const float> comps,
+                         pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  comps = comps.first(rgbs.size() * 3);
+  std::vector<int32_t> scales(comps.size());
+  const size_t converted = LabToSRGBScales(comps, scales);
+  for (size_t i = 0; i < converted; ++i) {
+    rgbs[i] = {
+        RGB_ConversionFromScale(scales[i * 3]),
+        RGB_ConversionFromScale(scales[i * 3 + 1]),
+        RGB_ConversionFromScale(scales[i * 3 + 2]),
+    };
+  }
+  for (size_t i = converted; i < rgbs.size(); ++i) {
+    // Better code than the equivalent GetRGBOrZerosOnError() since that
+    // is implemented in a base class and can't devirtualize the GetRGB()
+    // call despite this class being marked final.
+    rgbs[i] =
+        GetRGB(comps.subspan(i * 3, 3u)).value_or(FX_RGB_STRUCT<float>{});
+  }
+}
+
 void CPDF_LabCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
                                     pdfium::span<const uint8_t> src_span,
                                     int pixels,
@@ -912,19 +1016,28 @@ void CPDF_LabCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
   auto lab_span =
       fxcrt::reinterpret_span<const FX_LAB_STRUCT<uint8_t>>(src_span).first(
           static_cast<size_t>(pixels));
-  for (auto [lab_ref, bgr_ref] : fxcrt::Zip(lab_span, bgr_span)) {
-    const float lab[3] = {
-        static_cast<float>(lab_ref.lightness_star * 100) / 255.0f,
-        static_cast<float>(lab_ref.a_star - 128),
-        static_cast<float>(lab_ref.b_star - 128),
-    };
-    // Better code than the equivalent GetRGBOrZerosOnError() since that
-    // is implemented in a base class and can't devirtualize the GetRGB()
-    // call despite this class being marked final.
-    auto rgb = GetRGB(lab).value_or(FX_RGB_STRUCT<float>{});
-    bgr_ref.blue = static_cast<int32_t>(rgb.blue * 255);
-    bgr_ref.green = static_cast<int32_t>(rgb.green * 255);
-    bgr_ref.red = static_cast<int32_t>(rgb.red * 255);
+  std::array<FX_LAB_STRUCT<float>, kTranslateChunkPixels> lab;
+  std::array<FX_RGB_STRUCT<float>, kTranslateChunkPixels> rgbs;
+  while (!lab_span.empty()) {
+    const size_t chunk_size = std::min(lab_span.size(), lab.size());
+    auto chunk_lab = pdfium::span(lab).first(chunk_size);
+    for (auto [lab_ref, lab_values] :
+         fxcrt::Zip(lab_span.first(chunk_size), chunk_lab)) {
+      lab_values = {
+          static_cast<float>(lab_ref.lightness_star * 100) / 255.0f,
+          static_cast<float>(lab_ref.a_star - 128),
+          static_cast<float>(lab_ref.b_star - 128),
+      };
+    }
+    auto chunk_rgbs = pdfium::span(rgbs).first(chunk_size);
+    GetRGBs(fxcrt::reinterpret_span<const float>(chunk_lab), chunk_rgbs);
+    for (auto [rgb, bgr_ref] : fxcrt::Zip(chunk_rgbs, bgr_span)) {
+      bgr_ref.blue = static_cast<int32_t>(rgb.blue * 255);
+      bgr_ref.green = static_cast<int32_t>(rgb.green * 255);
+      bgr_ref.red = static_cast<int32_t>(rgb.red * 255);
+    }
+    lab_span = lab_span.subspan(chunk_size);
+    bgr_span = bgr_span.subspan(chunk_size);
   }
 }
 
@@ -988,6 +1101,23 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_ICCBasedCS::GetRGB(
   return FX_RGB_STRUCT<float>{};
 }
 
+void CPDF_ICCBasedCS::GetRGBs(pdfium::span<const float> comps,
+                              pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  if (profile_->IsSRGB()) {
+    CPDF_ColorSpace::GetRGBs(comps, rgbs);
+    return;
+  }
+  if (profile_->IsSupported()) {
+    profile_->TranslateColors(comps, fxcrt::reinterpret_span<float>(rgbs));
+    return;
+  }
+  if (base_cs_) {
+    base_cs_->GetRGBs(comps, rgbs);
+    return;
+  }
+  std::ranges::fill(rgbs, FX_RGB_STRUCT<float>{});
+}
+
 RetainPtr<CPDF_IccProfile> CPDF_ICCBasedCS::GetIccProfile() const {
   return profile_;
 }
@@ -1210,6 +1340,28 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_SeparationCS::GetRGB(
   return std::nullopt;
 }
 
+void CPDF_SeparationCS::GetRGBs(
+    pdfium::span<const float> comps,
+    pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  if (is_none_type_ || !base_cs_) {
+    std::ranges::fill(rgbs, FX_RGB_STRUCT<float>{});
+    return;
+  }
+  if (func_) {
+    GetRGBsThroughFunction(*func_, *base_cs_, 1, comps, rgbs);
+    return;
+  }
+
+  const size_t base_count = base_cs_->ComponentCount();
+  std::vector<float> base_comps(rgbs.size() * base_count);
+  for (size_t i = 0; i < rgbs.size(); ++i) {
+    std::ranges::fill(pdfium::span(base_comps).subspan(i * base_count,
+                                                       base_count),
+                      comps[i]);
+  }
+  base_cs_->GetRGBs(base_comps, rgbs);
+}
+
 CPDF_DeviceNCS::CPDF_DeviceNCS() : CPDF_BasedCS(Family::kDeviceN) {}
 
 CPDF_DeviceNCS::~CPDF_DeviceNCS() = default;
@@ -1268,3 +1420,12 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_DeviceNCS::GetRGB(
   }
   return base_cs_->GetRGB(results);
 }
+
+void CPDF_DeviceNCS::GetRGBs(pdfium::span<const float> comps,
+                             pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  if (!func_) {
+    std::ranges::fill(rgbs, FX_RGB_STRUCT<float>{});
+    return;
+  }
+  GetRGBsThroughFunction(*func_, *base_cs_, ComponentCount(), comps, rgbs);
+}
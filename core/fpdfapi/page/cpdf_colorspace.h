@@ -71,6 +71,11 @@ class CPDF_ColorSpace : public Retainable, public Observable {
   static void InitializeGlobals();
   static void DestroyGlobals();
 
+  // Stock colorspaces private to the calling thread, used instead of the
+  // process-wide ones by GetStockCS() on that thread.
+  static void InitializeGlobalsForCurrentThread();
+  static void DestroyGlobalsForCurrentThread();
+
   // `family` must be one of the following:
   // - `kDeviceGray`
   // - `kDeviceRGB`
@@ -111,6 +116,13 @@ class CPDF_ColorSpace : public Retainable, public Observable {
   virtual std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const = 0;
 
+  // Batch version of GetRGBOrZerosOnError(), for the colors in `comps`, which
+  // has ComponentCount() values for each element of `rgbs`. Subclasses that
+  // can convert many colors faster than one at a time override this, and give
+  // the same results. Not for patterns.
+  virtual void GetRGBs(pdfium::span<const float> comps,
+                       pdfium::span<FX_RGB_STRUCT<float>> rgbs) const;
+
   virtual RetainPtr<CPDF_IccProfile> GetIccProfile() const;
 
   virtual void GetDefaultValue(int iComponent,
@@ -8,13 +8,111 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <bit>
+#include <memory>
+#include <set>
+#include <vector>
 
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_string.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/simd_test_support.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using ::testing::ElementsAre;
 
+namespace {
+
+// Values inside and outside of the usual [0, 1] range.
+constexpr float kUnitValues[] = {-0.5f, 0.0f,  0.1f, 0.25f, 0.3f,
+                                 0.5f,  0.75f, 0.9f, 1.0f,  1.5f};
+
+void AppendNumbers(CPDF_Array* array, pdfium::span<const float> values) {
+  for (float value : values) {
+    array->AppendNew<CPDF_Number>(value);
+  }
+}
+
+RetainPtr<CPDF_Dictionary> MakeType2Function(
+    pdfium::span<const float> c1_values) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("FunctionType", 2);
+  dict->SetNewFor<CPDF_Number>("N", 1);
+  static constexpr float kDomain[] = {0.0f, 1.0f};
+  AppendNumbers(dict->SetNewFor<CPDF_Array>("Domain").Get(), kDomain);
+  AppendNumbers(dict->SetNewFor<CPDF_Array>("C1").Get(), c1_values);
+  return dict;
+}
+
+// Compares bit patterns, so that the results must be exactly the same.
+uint32_t ToBits(float value) {
+  return std::bit_cast<uint32_t>(value);
+}
+
+class CPDFColorSpaceGetRGBsTest : public TestWithPageModule {
+ public:
+  void SetUp() override {
+    TestWithPageModule::SetUp();
+    doc_ = std::make_unique<CPDF_TestDocument>();
+  }
+
+  void TearDown() override {
+    doc_.reset();
+    TestWithPageModule::TearDown();
+  }
+
+ protected:
+  RetainPtr<CPDF_ColorSpace> Load(const CPDF_Array* array) {
+    std::set<const CPDF_Object*> visited;
+    return CPDF_ColorSpace::Load(doc_.get(), array, &visited);
+  }
+
+  CPDF_TestDocument* doc() { return doc_.get(); }
+
+  // Expects GetRGBs() to give what GetRGBOrZerosOnError() gives for each
+  // color in `comps`, at each SIMD level.
+  void ExpectSameAsGetRGB(const CPDF_ColorSpace& cs,
+                          const std::vector<float>& comps) {
+    const size_t cs_count = cs.ComponentCount();
+    ASSERT_EQ(0u, comps.size() % cs_count);
+    const size_t color_count = comps.size() / cs_count;
+    std::vector<FX_RGB_STRUCT<float>> expected(color_count);
+    for (size_t i = 0; i < color_count; ++i) {
+      // GetRGB() may read up to 16 values.
+      std::vector<float> buf(std::max<size_t>(cs_count, 16));
+      std::copy_n(comps.begin() + i * cs_count, cs_count, buf.begin());
+      expected[i] = cs.GetRGBOrZerosOnError(buf);
+    }
+
+    auto check = [&] {
+      std::vector<FX_RGB_STRUCT<float>> actual(color_count);
+      cs.GetRGBs(comps, actual);
+      for (size_t i = 0; i < color_count; ++i) {
+        ASSERT_EQ(ToBits(expected[i].red), ToBits(actual[i].red)) << i;
+        ASSERT_EQ(ToBits(expected[i].green), ToBits(actual[i].green)) << i;
+        ASSERT_EQ(ToBits(expected[i].blue), ToBits(actual[i].blue)) << i;
+      }
+    };
+    fxge::RunWithoutSimd(check);
+    fxge::ForEachSupportedSimdLevel(check);
+  }
+
+ private:
+  std::unique_ptr<CPDF_TestDocument> doc_;
+};
+
+}  // namespace
+
 TEST(CPDFCalGrayTest, TranslateImageLine) {
   RetainPtr<CPDF_ColorSpace> pCal = CPDF_ColorSpace::AllocateColorSpace("CalG");
   ASSERT_TRUE(pCal);
@@ -38,3 +136,107 @@ TEST(CPDFCalRGBTest, TranslateImageLine) {
   pCal->TranslateImageLine(dst, kSrc, 4, 4, 1, /*bTransMask=*/false);
   EXPECT_THAT(dst, ElementsAre(0, 0, 255, 0, 255, 0, 255, 0, 0, 128, 128, 128));
 }
+
+TEST_F(CPDFColorSpaceGetRGBsTest, DeviceCMYK) {
+  RetainPtr<CPDF_ColorSpace> cs =
+      CPDF_ColorSpace::GetStockCS(CPDF_ColorSpace::Family::kDeviceCMYK);
+  std::vector<float> comps;
+  for (float c : kUnitValues) {
+    for (float m : kUnitValues) {
+      for (float y : kUnitValues) {
+        for (float k : kUnitValues) {
+          comps.insert(comps.end(), {c, m, y, k});
+        }
+      }
+    }
+  }
+  // Leave a few colors for the scalar tail.
+  comps.resize(comps.size() - 3 * 4);
+  ExpectSameAsGetRGB(*cs, comps);
+}
+
+TEST_F(CPDFColorSpaceGetRGBsTest, Lab) {
+  auto array = pdfium::MakeRetain<CPDF_Array>();
+  array->AppendNew<CPDF_Name>("Lab");
+  auto dict = array->AppendNew<CPDF_Dictionary>();
+  static constexpr float kWhitePoint[] = {0.9505f, 1.0f, 1.089f};
+  AppendNumbers(dict->SetNewFor<CPDF_Array>("WhitePoint").Get(), kWhitePoint);
+  RetainPtr<CPDF_ColorSpace> cs = Load(array.Get());
+  ASSERT_TRUE(cs);
+
+  static constexpr float kL[] = {-10.0f, 0.0f,  8.0f,  25.0f,
+                                 50.0f,  99.0f, 120.0f};
+  static constexpr float kAB[] = {-150.0f, -100.0f, -35.5f, 0.0f,
+                                  12.25f,  64.0f,   100.0f, 150.0f};
+  std::vector<float> comps;
+  for (float l : kL) {
+    for (float a : kAB) {
+      for (float b : kAB) {
+        comps.insert(comps.end(), {l, a, b});
+      }
+    }
+  }
+  comps.resize(comps.size() - 3 * 3);
+  ExpectSameAsGetRGB(*cs, comps);
+}
+
+TEST_F(CPDFColorSpaceGetRGBsTest, Indexed) {
+  auto array = pdfium::MakeRetain<CPDF_Array>();
+  array->AppendNew<CPDF_Name>("Indexed");
+  array->AppendNew<CPDF_Name>("DeviceRGB");
+  array->AppendNew<CPDF_Number>(5);
+  static constexpr uint8_t kLookup[] = {255, 0,   0,  0,  255, 0,
+                                        0,   0,   255, 40, 80,  120};
+  array->AppendNew<CPDF_String>(ByteString(ByteStringView(kLookup)));
+  RetainPtr<CPDF_ColorSpace> cs = Load(array.Get());
+  ASSERT_TRUE(cs);
+
+  // Includes indices past the lookup table and past the maximum index.
+  ExpectSameAsGetRGB(*cs, {-1.0f, 0.0f, 1.0f, 1.5f, 2.0f, 3.0f, 4.0f, 2.9f,
+                           5.0f, 6.0f, 255.0f});
+}
+
+TEST_F(CPDFColorSpaceGetRGBsTest, Separation) {
+  auto array = pdfium::MakeRetain<CPDF_Array>();
+  array->AppendNew<CPDF_Name>("Separation");
+  array->AppendNew<CPDF_Name>("Spot");
+  array->AppendNew<CPDF_Name>("DeviceCMYK");
+  static constexpr float kC1[] = {0.1f, 0.5f, 0.9f, 0.2f};
+  array->Append(MakeType2Function(kC1));
+  RetainPtr<CPDF_ColorSpace> cs = Load(array.Get());
+  ASSERT_TRUE(cs);
+
+  ExpectSameAsGetRGB(*cs, std::vector<float>(std::begin(kUnitValues),
+                                             std::end(kUnitValues)));
+}
+
+TEST_F(CPDFColorSpaceGetRGBsTest, DeviceN) {
+  auto array = pdfium::MakeRetain<CPDF_Array>();
+  array->AppendNew<CPDF_Name>("DeviceN");
+  auto names = array->AppendNew<CPDF_Array>();
+  names->AppendNew<CPDF_Name>("A");
+  names->AppendNew<CPDF_Name>("B");
+  array->AppendNew<CPDF_Name>("DeviceCMYK");
+  auto func_dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  func_dict->SetNewFor<CPDF_Number>("FunctionType", 4);
+  static constexpr float kDomain[] = {0.0f, 1.0f, 0.0f, 1.0f};
+  static constexpr float kRange[] = {0.0f, 1.0f, 0.0f, 1.0f,
+                                     0.0f, 1.0f, 0.0f, 1.0f};
+  AppendNumbers(func_dict->SetNewFor<CPDF_Array>("Domain").Get(), kDomain);
+  AppendNumbers(func_dict->SetNewFor<CPDF_Array>("Range").Get(), kRange);
+  pdfium::span<const uint8_t> program =
+      ByteStringView("{ 2 copy mul 0.5 }").unsigned_span();
+  auto func = doc()->NewIndirect<CPDF_Stream>(
+      DataVector<uint8_t>(program.begin(), program.end()), func_dict);
+  array->AppendNew<CPDF_Reference>(doc(), func->GetObjNum());
+  RetainPtr<CPDF_ColorSpace> cs = Load(array.Get());
+  ASSERT_TRUE(cs);
+
+  std::vector<float> comps;
+  for (float a : kUnitValues) {
+    for (float b : kUnitValues) {
+      comps.insert(comps.end(), {a, b});
+    }
+  }
+  ExpectSameAsGetRGB(*cs, comps);
+}
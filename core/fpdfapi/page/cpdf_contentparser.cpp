@@ -7,11 +7,11 @@
 #include "core/fpdfapi/page/cpdf_contentparser.h"
 
 #include <utility>
-#include <variant>
 
 #include "constants/page_object.h"
 #include "core/fpdfapi/font/cpdf_type3char.h"
 #include "core/fpdfapi/page/cpdf_allstates.h"
+#include "core/fpdfapi/page/cpdf_contentstreamreader.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
 #include "core/fpdfapi/page/cpdf_path.h"
@@ -21,10 +21,7 @@
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
-#include "core/fxcrt/fixed_size_data_vector.h"
-#include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/pauseindicator_iface.h"
-#include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxge/cfx_fillrenderoptions.h"
 
@@ -162,11 +159,8 @@ CPDF_ContentParser::Stage CPDF_ContentParser::GetContent() {
   RetainPtr<const CPDF_Array> pContent =
       page_object_holder_->GetDict()->GetArrayFor(
           pdfium::page_object::kContents);
-  RetainPtr<const CPDF_Stream> pStreamObj = ToStream(
+  stream_array_[current_offset_] = ToStream(
       pContent ? pContent->GetDirectObjectAt(current_offset_) : nullptr);
-  stream_array_[current_offset_] =
-      pdfium::MakeRetain<CPDF_StreamAcc>(std::move(pStreamObj));
-  stream_array_[current_offset_]->LoadAllDataFiltered();
   current_offset_++;
 
   return current_offset_ == streams_ ? Stage::kPrepareContent
@@ -175,37 +169,11 @@ CPDF_ContentParser::Stage CPDF_ContentParser::GetContent() {
 
 CPDF_ContentParser::Stage CPDF_ContentParser::PrepareContent() {
   current_offset_ = 0;
-
-  if (stream_array_.empty()) {
-    data_ = single_stream_->GetSpan();
-    return Stage::kParse;
-  }
-
-  FX_SAFE_UINT32 safe_size = 0;
-  for (const auto& stream : stream_array_) {
-    stream_segment_offsets_.push_back(safe_size.ValueOrDie());
-    safe_size += stream->GetSize();
-    safe_size += 1;
-    if (!safe_size.IsValid()) {
-      return Stage::kComplete;
-    }
+  if (!stream_array_.empty()) {
+    content_reader_ = std::make_unique<CPDF_ContentStreamReader>(
+        std::move(stream_array_), /*separate_streams=*/true);
+    stream_array_.clear();
   }
-
-  const size_t buffer_size = safe_size.ValueOrDie();
-  auto buffer = FixedSizeDataVector<uint8_t>::TryZeroed(buffer_size);
-  if (buffer.empty()) {
-    data_.emplace<pdfium::raw_span<const uint8_t>>();
-    return Stage::kComplete;
-  }
-
-  auto data_span = buffer.span();
-  for (const auto& stream : stream_array_) {
-    data_span = fxcrt::spancpy(data_span, stream->GetSpan());
-    data_span.front() = ' ';
-    data_span = data_span.subspan<1u>();
-  }
-  stream_array_.clear();
-  data_ = std::move(buffer);
   return Stage::kParse;
 }
 
@@ -219,7 +187,25 @@ CPDF_ContentParser::Stage CPDF_ContentParser::Parse() {
         page_object_holder_->GetBBox(), nullptr, &recursion_state_);
     parser_->GetCurStates()->mutable_color_state().SetDefault();
   }
-  if (current_offset_ >= GetData().size()) {
+
+  static constexpr uint32_t kParseStepLimit = 100;
+  if (content_reader_) {
+    // Parsing never goes back to before where the last step stopped.
+    content_reader_->DiscardBefore(current_offset_);
+    pdfium::span<const uint8_t> data = content_reader_->data();
+    if (data.empty()) {
+      data = content_reader_->ReadMore(1);
+      if (data.empty()) {
+        return Stage::kCheckClip;
+      }
+    }
+    current_offset_ += parser_->Parse(
+        data, current_offset_, kParseStepLimit,
+        content_reader_->stream_start_offsets(), content_reader_.get());
+    return Stage::kParse;
+  }
+
+  if (current_offset_ >= data_.size()) {
     return Stage::kCheckClip;
   }
 
@@ -227,9 +213,10 @@ CPDF_ContentParser::Stage CPDF_ContentParser::Parse() {
     stream_segment_offsets_.push_back(0);
   }
 
-  static constexpr uint32_t kParseStepLimit = 100;
-  current_offset_ += parser_->Parse(GetData(), current_offset_, kParseStepLimit,
-                                    stream_segment_offsets_);
+  current_offset_ += parser_->Parse(data_.subspan(current_offset_),
+                                    current_offset_, kParseStepLimit,
+                                    stream_segment_offsets_,
+                                    /*source=*/nullptr);
   return Stage::kParse;
 }
 
@@ -270,9 +257,10 @@ CPDF_ContentParser::Stage CPDF_ContentParser::CheckClip() {
 }
 
 void CPDF_ContentParser::HandlePageContentStream(const CPDF_Stream* pStream) {
-  single_stream_ =
-      pdfium::MakeRetain<CPDF_StreamAcc>(pdfium::WrapRetain(pStream));
-  single_stream_->LoadAllDataFiltered();
+  std::vector<RetainPtr<const CPDF_Stream>> streams;
+  streams.push_back(pdfium::WrapRetain(pStream));
+  content_reader_ = std::make_unique<CPDF_ContentStreamReader>(
+      std::move(streams), /*separate_streams=*/false);
   current_stage_ = Stage::kPrepareContent;
 }
 
@@ -289,10 +277,3 @@ bool CPDF_ContentParser::HandlePageContentArray(const CPDF_Array* pArray) {
 void CPDF_ContentParser::HandlePageContentFailure() {
   current_stage_ = Stage::kComplete;
 }
-
-pdfium::span<const uint8_t> CPDF_ContentParser::GetData() const {
-  if (is_owned()) {
-    return std::get<FixedSizeDataVector<uint8_t>>(data_).span();
-  }
-  return std::get<pdfium::raw_span<const uint8_t>>(data_);
-}
@@ -10,19 +10,18 @@
 #include <stdint.h>
 
 #include <memory>
-#include <variant>
 #include <vector>
 
 #include "core/fpdfapi/page/cpdf_form.h"
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fpdfapi/page/cpdf_streamcontentparser.h"
-#include "core/fxcrt/fixed_size_data_vector.h"
 #include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/unowned_ptr.h"
 
 class CPDF_AllStates;
 class CPDF_Array;
+class CPDF_ContentStreamReader;
 class CPDF_Page;
 class CPDF_PageObjectHolder;
 class CPDF_Stream;
@@ -64,19 +63,16 @@ class CPDF_ContentParser {
   bool HandlePageContentArray(const CPDF_Array* pArray);
   void HandlePageContentFailure();
 
-  bool is_owned() const {
-    return std::holds_alternative<FixedSizeDataVector<uint8_t>>(data_);
-  }
-  pdfium::span<const uint8_t> GetData() const;
-
   Stage current_stage_;
   UnownedPtr<CPDF_PageObjectHolder> const page_object_holder_;
   UnownedPtr<CPDF_Type3Char> type3_char_;  // Only used when parsing forms.
+  // Only used when parsing forms, which are parsed from all of their data.
   RetainPtr<CPDF_StreamAcc> single_stream_;
-  std::vector<RetainPtr<CPDF_StreamAcc>> stream_array_;
   std::vector<uint32_t> stream_segment_offsets_;
-  std::variant<pdfium::raw_span<const uint8_t>, FixedSizeDataVector<uint8_t>>
-      data_;
+  pdfium::raw_span<const uint8_t> data_;
+  // Only used when parsing pages, which read their content a piece at a time.
+  std::vector<RetainPtr<const CPDF_Stream>> stream_array_;
+  std::unique_ptr<CPDF_ContentStreamReader> content_reader_;
   uint32_t streams_ = 0;
   uint32_t current_offset_ = 0;
   // Only used when parsing pages.
@@ -0,0 +1,151 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_contentstreamreader.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_stream_acc.h"
+#include "core/fpdfapi/parser/fpdf_parser_decode.h"
+#include "core/fxcodec/streamdecoder.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/span_util.h"
+
+namespace {
+
+// Large enough to keep the overhead per read low, and small enough not to
+// matter next to the page objects parsed from it.
+constexpr size_t kReadSize = 64 * 1024;
+
+bool HasOnlyFlateFilter(const DecoderArray& decoders) {
+  return decoders.size() == 1 && (decoders[0].first == "FlateDecode" ||
+                                   decoders[0].first == "Fl");
+}
+
+}  // namespace
+
+CPDF_ContentStreamReader::CPDF_ContentStreamReader(
+    std::vector<RetainPtr<const CPDF_Stream>> streams,
+    bool separate_streams)
+    : streams_(std::move(streams)), separate_streams_(separate_streams) {}
+
+CPDF_ContentStreamReader::~CPDF_ContentStreamReader() = default;
+
+pdfium::span<const uint8_t> CPDF_ContentStreamReader::ReadMore(size_t size) {
+  // Offsets in the merged stream are 32-bit.
+  size = std::min<size_t>(std::max(size, kReadSize),
+                          std::numeric_limits<uint32_t>::max() - read_size_);
+  const size_t old_size = buffer_.size();
+  buffer_.resize(old_size + size);
+  const size_t filled = Fill(pdfium::span(buffer_).subspan(old_size));
+  buffer_.resize(old_size + filled);
+  return data();
+}
+
+pdfium::span<const uint8_t> CPDF_ContentStreamReader::data() const {
+  return pdfium::span(buffer_).subspan(buffer_start_);
+}
+
+void CPDF_ContentStreamReader::DiscardBefore(uint32_t offset) {
+  DCHECK_GE(offset, data_offset_);
+  const size_t size =
+      std::min<size_t>(offset - data_offset_, buffer_.size() - buffer_start_);
+  buffer_start_ += size;
+  data_offset_ += size;
+  // Only moves what is kept to the front once more was dropped, so that the
+  // copying stays proportional to what gets read.
+  if (buffer_start_ > buffer_.size() - buffer_start_) {
+    buffer_.erase(buffer_.begin(), buffer_.begin() + buffer_start_);
+    buffer_start_ = 0;
+  }
+}
+
+size_t CPDF_ContentStreamReader::Fill(pdfium::span<uint8_t> dest) {
+  size_t filled = 0;
+  while (true) {
+    if (reading_stream_) {
+      const size_t size = ReadStream(dest.subspan(filled));
+      filled += size;
+      read_size_ += size;
+      if (filled == dest.size()) {
+        break;
+      }
+      reading_stream_ = false;
+      need_separator_ = separate_streams_;
+    }
+    if (need_separator_) {
+      if (filled == dest.size()) {
+        break;
+      }
+      dest[filled++] = ' ';
+      ++read_size_;
+      need_separator_ = false;
+    }
+    if (!OpenNextStream()) {
+      break;
+    }
+  }
+  return filled;
+}
+
+bool CPDF_ContentStreamReader::OpenNextStream() {
+  if (next_stream_ == streams_.size()) {
+    return false;
+  }
+
+  stream_start_offsets_.push_back(read_size_);
+  RetainPtr<const CPDF_Stream> stream = std::move(streams_[next_stream_++]);
+  reading_stream_ = true;
+  stream_acc_.Reset();
+  decoder_.reset();
+  decoded_any_ = false;
+  remaining_ = pdfium::span<const uint8_t>();
+  if (!stream) {
+    return true;
+  }
+
+  std::optional<DecoderArray> decoders = GetDecoderArray(stream->GetDict());
+  if (decoders.has_value() && HasOnlyFlateFilter(decoders.value())) {
+    stream_acc_ = pdfium::MakeRetain<CPDF_StreamAcc>(stream);
+    stream_acc_->LoadAllDataRaw();
+    decoder_ = CreateFlateStreamDecoder(
+        stream_acc_->GetSpan(), ToDictionary(decoders.value()[0].second).Get());
+    if (decoder_) {
+      return true;
+    }
+  }
+
+  stream_acc_ = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(stream));
+  stream_acc_->LoadAllDataFiltered();
+  remaining_ = stream_acc_->GetSpan();
+  return true;
+}
+
+size_t CPDF_ContentStreamReader::ReadStream(pdfium::span<uint8_t> dest) {
+  if (dest.empty()) {
+    return 0;
+  }
+
+  if (decoder_) {
+    const size_t size = decoder_->Read(dest);
+    if (size > 0 || decoded_any_) {
+      decoded_any_ = true;
+      return size;
+    }
+    // Like CPDF_StreamAcc, falls back to the raw data when it decodes to
+    // nothing.
+    decoder_.reset();
+    remaining_ = stream_acc_->GetSpan();
+  }
+
+  const size_t size = std::min(dest.size(), remaining_.size());
+  fxcrt::spancpy(dest, remaining_.first(size));
+  remaining_ = remaining_.subspan(size);
+  return size;
+}
@@ -0,0 +1,91 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_CONTENTSTREAMREADER_H_
+#define CORE_FPDFAPI_PAGE_CPDF_CONTENTSTREAMREADER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_streamparser.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+
+class CPDF_Stream;
+class CPDF_StreamAcc;
+
+namespace fxcodec {
+class StreamDecoder;
+}  // namespace fxcodec
+
+// Reads the content streams of a page one after another, as one merged
+// stream, a piece at a time. Streams with only Flate compression get decoded
+// as they are read, so that content which decodes to hundreds of megabytes
+// never has to be in memory all at once. Other streams get decoded whole, one
+// at a time. Keeps what it read from the offset it last got told to keep.
+class CPDF_ContentStreamReader final : public CPDF_StreamParser::DataSource {
+ public:
+  // Null entries in `streams` read as empty streams. With `separate_streams`,
+  // follows each stream with a space, as content may only be split between
+  // streams where it can be split by whitespace.
+  CPDF_ContentStreamReader(std::vector<RetainPtr<const CPDF_Stream>> streams,
+                           bool separate_streams);
+  ~CPDF_ContentStreamReader() override;
+
+  // CPDF_StreamParser::DataSource:
+  pdfium::span<const uint8_t> ReadMore(size_t size) override;
+
+  // What was read and kept so far, which starts at `data_offset()` in the
+  // merged stream.
+  pdfium::span<const uint8_t> data() const;
+  uint32_t data_offset() const { return data_offset_; }
+
+  // The offsets in the merged stream at which each stream starts, for the
+  // streams read so far.
+  const std::vector<uint32_t>& stream_start_offsets() const {
+    return stream_start_offsets_;
+  }
+
+  // Drops what was read before `offset` in the merged stream.
+  void DiscardBefore(uint32_t offset);
+
+ private:
+  // Fills as much of `dest` as there is data for, and returns how much.
+  size_t Fill(pdfium::span<uint8_t> dest);
+
+  // Returns whether there was another stream.
+  bool OpenNextStream();
+
+  // Reads from the current stream. Returns less than `dest.size()` only at
+  // its end.
+  size_t ReadStream(pdfium::span<uint8_t> dest);
+
+  std::vector<RetainPtr<const CPDF_Stream>> streams_;
+  const bool separate_streams_;
+  size_t next_stream_ = 0;
+  bool reading_stream_ = false;
+  bool need_separator_ = false;
+
+  // The current stream. Holds its raw data while `decoder_` decodes it, and
+  // all of its decoded data otherwise.
+  RetainPtr<CPDF_StreamAcc> stream_acc_;
+  std::unique_ptr<fxcodec::StreamDecoder> decoder_;
+  bool decoded_any_ = false;
+  pdfium::raw_span<const uint8_t> remaining_;
+
+  DataVector<uint8_t> buffer_;
+  // Where `data()` starts in `buffer_`.
+  size_t buffer_start_ = 0;
+  uint32_t data_offset_ = 0;
+  // The size of the merged stream read so far.
+  uint32_t read_size_ = 0;
+  std::vector<uint32_t> stream_start_offsets_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_CONTENTSTREAMREADER_H_
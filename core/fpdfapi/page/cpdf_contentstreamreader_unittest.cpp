@@ -0,0 +1,117 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_contentstreamreader.h"
+
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcodec/flate/flatemodule.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using testing::ElementsAre;
+
+namespace {
+
+RetainPtr<const CPDF_Stream> MakeStream(ByteStringView data) {
+  return pdfium::MakeRetain<CPDF_Stream>(data.unsigned_span());
+}
+
+RetainPtr<const CPDF_Stream> MakeFlateStream(
+    pdfium::span<const uint8_t> encoded) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Name>("Filter", "FlateDecode");
+  return pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(encoded.begin(), encoded.end()), std::move(dict));
+}
+
+ByteString ReadAll(CPDF_ContentStreamReader& reader) {
+  while (true) {
+    const size_t size = reader.data().size();
+    if (reader.ReadMore(1).size() == size) {
+      return ByteString(ByteStringView(reader.data()));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(CPDFContentStreamReaderTest, Empty) {
+  CPDF_ContentStreamReader reader({}, /*separate_streams=*/true);
+  EXPECT_TRUE(reader.ReadMore(1).empty());
+  EXPECT_TRUE(reader.stream_start_offsets().empty());
+}
+
+TEST(CPDFContentStreamReaderTest, SingleStream) {
+  std::vector<RetainPtr<const CPDF_Stream>> streams;
+  streams.push_back(MakeStream("0 0 m 1 1 l S"));
+  CPDF_ContentStreamReader reader(std::move(streams),
+                                  /*separate_streams=*/false);
+  EXPECT_EQ("0 0 m 1 1 l S", ReadAll(reader));
+  EXPECT_THAT(reader.stream_start_offsets(), ElementsAre(0));
+}
+
+TEST(CPDFContentStreamReaderTest, SeparateStreams) {
+  // Long enough to take several reads.
+  ByteString text;
+  for (int i = 0; i < 20000; ++i) {
+    text += "1 0 0 1 0 0 cm\n";
+  }
+  const DataVector<uint8_t> encoded =
+      FlateModule::Encode(text.unsigned_span());
+
+  std::vector<RetainPtr<const CPDF_Stream>> streams;
+  streams.push_back(MakeStream("q"));
+  streams.push_back(MakeFlateStream(encoded));
+  streams.push_back(nullptr);
+  streams.push_back(MakeStream("Q"));
+  CPDF_ContentStreamReader reader(std::move(streams),
+                                  /*separate_streams=*/true);
+  EXPECT_EQ("q " + text + "  Q ", ReadAll(reader));
+  const uint32_t text_end = 2 + text.GetLength();
+  EXPECT_THAT(reader.stream_start_offsets(),
+              ElementsAre(0, 2, text_end + 1, text_end + 2));
+}
+
+TEST(CPDFContentStreamReaderTest, FlateDecodesToNothing) {
+  // Like CPDF_StreamAcc, gives the raw data instead.
+  static constexpr uint8_t kNotFlate[] = {'B', 'T', ' ', 'E', 'T'};
+  std::vector<RetainPtr<const CPDF_Stream>> streams;
+  streams.push_back(MakeFlateStream(kNotFlate));
+  CPDF_ContentStreamReader reader(std::move(streams),
+                                  /*separate_streams=*/false);
+  EXPECT_EQ("BT ET", ReadAll(reader));
+}
+
+TEST(CPDFContentStreamReaderTest, DiscardBefore) {
+  std::vector<RetainPtr<const CPDF_Stream>> streams;
+  streams.push_back(MakeStream("abc"));
+  streams.push_back(MakeStream("def"));
+  CPDF_ContentStreamReader reader(std::move(streams),
+                                  /*separate_streams=*/true);
+  EXPECT_EQ("abc def ", ByteStringView(reader.ReadMore(1)));
+  EXPECT_EQ(0u, reader.data_offset());
+
+  reader.DiscardBefore(2);
+  EXPECT_EQ(2u, reader.data_offset());
+  EXPECT_EQ("c def ", ByteStringView(reader.data()));
+
+  reader.DiscardBefore(5);
+  EXPECT_EQ(5u, reader.data_offset());
+  EXPECT_EQ("ef ", ByteStringView(reader.data()));
+
+  reader.DiscardBefore(8);
+  EXPECT_EQ(8u, reader.data_offset());
+  EXPECT_TRUE(reader.data().empty());
+  EXPECT_TRUE(reader.ReadMore(1).empty());
+}
@@ -7,6 +7,7 @@
 #include "core/fpdfapi/page/cpdf_devicecs.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
@@ -17,6 +18,8 @@
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/notreached.h"
+#include "core/fxcrt/span_util.h"
+#include "core/fxcrt/zip.h"
 #include "core/fxge/dib/cfx_cmyk_to_srgb.h"
 
 namespace {
@@ -78,6 +81,26 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_DeviceCS::GetRGB(
   }
 }
 
+void CPDF_DeviceCS::GetRGBs(pdfium::span<const float> comps,
+                            pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  if (GetFamily() != Family::kDeviceCMYK || IsStdConversionEnabled()) {
+    CPDF_ColorSpace::GetRGBs(comps, rgbs);
+    return;
+  }
+
+  auto cmyk_in = fxcrt::reinterpret_span<const FX_CMYK_STRUCT<float>>(comps);
+  std::vector<FX_CMYK_STRUCT<float>> normalized(rgbs.size());
+  for (auto [normalized_cmyk, cmyk] : fxcrt::Zip(normalized, cmyk_in)) {
+    normalized_cmyk = {
+        NormalizeChannel(cmyk.cyan),
+        NormalizeChannel(cmyk.magenta),
+        NormalizeChannel(cmyk.yellow),
+        NormalizeChannel(cmyk.key),
+    };
+  }
+  AdobeCMYK_to_sRGBRow(normalized, rgbs);
+}
+
 void CPDF_DeviceCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
                                        pdfium::span<const uint8_t> src_span,
                                        int pixels,
@@ -128,15 +151,9 @@ void CPDF_DeviceCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
         }
         break;
       }
-      for (const auto& cmyk : cmyk_in.first(static_cast<size_t>(pixels))) {
-        // TODO(tsepez): maybe this is a FX_BGR_STRUCT in reality?
-        FX_RGB_STRUCT<uint8_t> rgb =
-            AdobeCMYK_to_sRGB1(cmyk.cyan, cmyk.magenta, cmyk.yellow, cmyk.key);
-        rgb_out.front().red = rgb.blue;
-        rgb_out.front().green = rgb.green;
-        rgb_out.front().blue = rgb.red;
-        rgb_out = rgb_out.subspan<1u>();
-      }
+      AdobeCMYK_to_sRGB1Row(
+          cmyk_in.first(static_cast<size_t>(pixels)),
+          fxcrt::reinterpret_span<FX_BGR_STRUCT<uint8_t>>(dest_span));
       break;
     }
     default:
@@ -20,6 +20,8 @@ class CPDF_DeviceCS final : public CPDF_ColorSpace {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void GetRGBs(pdfium::span<const float> comps,
+               pdfium::span<FX_RGB_STRUCT<float>> rgbs) const override;
   void TranslateImageLine(pdfium::span<uint8_t> dest_span,
                           pdfium::span<const uint8_t> src_span,
                           int pixels,
@@ -19,6 +19,7 @@
 #include "core/fpdfapi/page/cpdf_image.h"
 #include "core/fpdfapi/page/cpdf_imageobject.h"
 #include "core/fpdfapi/page/cpdf_indexedcs.h"
+#include "core/fpdfapi/page/cpdf_jpxtilecache.h"
 #include "core/fpdfapi/page/jpx_decode_conversion.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
@@ -30,6 +31,7 @@
 #include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fxcodec/basic/basicmodule.h"
+#include "core/fxcodec/bilevel_reducer.h"
 #include "core/fxcodec/icc/icc_transform.h"
 #include "core/fxcodec/jbig2/jbig2_decoder.h"
 #include "core/fxcodec/jpeg/jpegmodule.h"
@@ -43,12 +45,20 @@
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxcrt/zip.h"
 #include "core/fxge/calculate_pitch.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 
 namespace {
 
+// Smaller JPEG 2000 images decode on one thread. Where this should lie has not
+// been measured on a machine with spare cores, which is where it matters. On
+// one core, JpxDecoderPerfTest.ImageSizes only shows what threads cost: 128 to
+// 512 px squares decode 17-30% slower on 4 threads than on one, and from
+// 1024 px on the cost is lost in the noise.
+constexpr int64_t kMinJpxPixelsForThreads = 1 << 20;
+
 bool IsValidDimension(int value) {
   static constexpr int kMaxImageDimension = 0x01FFFF;
   return value > 0 && value <= kMaxImageDimension;
@@ -73,6 +83,20 @@ bool GetBitValue(pdfium::span<const uint8_t> pSrc, uint32_t pos) {
   return pSrc[pos / 8] & (1 << (7 - pos % 8));
 }
 
+// Moves indexes that take fewer than 8 bits into the low bits of each pixel.
+void ScaleDownIndexedPixels(CFX_DIBitmap* bitmap,
+                            uint32_t width,
+                            uint32_t height,
+                            int shift) {
+  for (uint32_t row = 0; row < height; ++row) {
+    pdfium::span<uint8_t> scanline =
+        bitmap->GetWritableScanline(row).first(width);
+    for (auto& pixel : scanline) {
+      pixel >>= shift;
+    }
+  }
+}
+
 // Just to sanity check and filter out obvious bad values.
 bool IsMaybeValidBitsPerComponent(int bpc) {
   return bpc >= 0 && bpc <= 16;
@@ -118,12 +142,20 @@ CPDF_DIB::JpxSMaskInlineData::JpxSMaskInlineData() = default;
 
 CPDF_DIB::JpxSMaskInlineData::~JpxSMaskInlineData() = default;
 
+CPDF_DIB::JpxTile::JpxTile(const FX_RECT& area,
+                           RetainPtr<const CFX_DIBitmap> bitmap)
+    : area(area), bitmap(std::move(bitmap)) {}
+
+CPDF_DIB::JpxTile::JpxTile(const JpxTile& that) = default;
+
+CPDF_DIB::JpxTile::~JpxTile() = default;
+
 bool CPDF_DIB::Load() {
   if (!LoadInternal(nullptr, nullptr)) {
     return false;
   }
 
-  if (CreateDecoder(0) == LoadState::kFail) {
+  if (CreateDecoder(0, FX_RECT()) == LoadState::kFail) {
     return false;
   }
 
@@ -184,7 +216,8 @@ CPDF_DIB::LoadState CPDF_DIB::StartLoadDIBBase(
     bool bStdCS,
     CPDF_ColorSpace::Family GroupFamily,
     bool bLoadMask,
-    const CFX_Size& max_size_required) {
+    const CFX_Size& max_size_required,
+    const FX_RECT& region_required) {
   std_cs_ = bStdCS;
   has_mask_ = bHasMask;
   group_family_ = GroupFamily;
@@ -205,7 +238,8 @@ CPDF_DIB::LoadState CPDF_DIB::StartLoadDIBBase(
                              GetHeight() / max_size_required.height))));
   }
 
-  LoadState iCreatedDecoder = CreateDecoder(resolution_levels_to_skip);
+  LoadState iCreatedDecoder =
+      CreateDecoder(resolution_levels_to_skip, region_required);
   if (iCreatedDecoder == LoadState::kFail) {
     return LoadState::kFail;
   }
@@ -271,10 +305,10 @@ CPDF_DIB::LoadState CPDF_DIB::ContinueLoadDIBBase(PauseIndicatorIface* pPause) {
     }
     const bool reject_large_regions_when_fuzzing = false;
     iDecodeStatus = Jbig2Decoder::StartDecode(
-        jbig_2context_.get(), document_->GetOrCreateCodecContext(), GetWidth(),
-        GetHeight(), pSrcSpan, nSrcKey, pGlobalSpan, nGlobalKey,
-        cached_bitmap_->GetWritableBuffer(), cached_bitmap_->GetPitch(), pPause,
-        reject_large_regions_when_fuzzing);
+        jbig_2context_.get(), document_->GetOrCreateCodecContext(),
+        cached_bitmap_->GetWidth(), cached_bitmap_->GetHeight(), pSrcSpan,
+        nSrcKey, pGlobalSpan, nGlobalKey, cached_bitmap_->GetWritableBuffer(),
+        cached_bitmap_->GetPitch(), pPause, reject_large_regions_when_fuzzing);
   } else {
     iDecodeStatus = Jbig2Decoder::ContinueDecode(jbig_2context_.get(), pPause);
   }
@@ -288,6 +322,12 @@ CPDF_DIB::LoadState CPDF_DIB::ContinueLoadDIBBase(PauseIndicatorIface* pPause) {
   if (iDecodeStatus == FXCODEC_STATUS::kDecodeToBeContinued) {
     return LoadState::kContinue;
   }
+  if (bilevel_reduce_factor_ > 1 && !ReduceCachedBilevelBitmap()) {
+    jbig_2context_.reset();
+    cached_bitmap_.Reset();
+    global_acc_.Reset();
+    return LoadState::kFail;
+  }
 
   LoadState iContinueStatus = LoadState::kSuccess;
   if (has_mask_) {
@@ -439,7 +479,8 @@ bool CPDF_DIB::GetDecodeAndMaskArray() {
   return true;
 }
 
-CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
+CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip,
+                                            const FX_RECT& region_required) {
   ByteString decoder = stream_acc_->GetImageDecoder();
   if (decoder.IsEmpty()) {
     return LoadState::kSuccess;
@@ -450,11 +491,25 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
   }
 
   if (decoder == "JPXDecode") {
+    if (!region_required.IsEmpty() &&
+        LoadJpxTiles(resolution_levels_to_skip, region_required)) {
+      return LoadState::kSuccess;
+    }
     cached_bitmap_ = LoadJpxBitmap(resolution_levels_to_skip);
     return cached_bitmap_ ? LoadState::kSuccess : LoadState::kFail;
   }
 
+  // Bilevel images get reduced right as they decode, so the full size 1 bit
+  // per pixel image never reaches the renderer, which would otherwise have to
+  // expand it all before shrinking it.
+  const int bilevel_reduce_factor =
+      CanReduceBilevel() ? 1 << std::min<int>(resolution_levels_to_skip, 5)
+                         : 1;
+  static_assert(1 << 5 == BilevelReducer::kMaxFactor);
+
   if (decoder == "JBIG2Decode") {
+    // JBIG2 decodes into regions of a page all over the image, so it still
+    // needs the full size image, which gets reduced once it is done.
     cached_bitmap_ = pdfium::MakeRetain<CFX_DIBitmap>();
     if (!cached_bitmap_->Create(
             GetWidth(), GetHeight(),
@@ -462,6 +517,12 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
       cached_bitmap_.Reset();
       return LoadState::kFail;
     }
+    if (bilevel_reduce_factor > 1) {
+      SetBilevelReduceFactor(bilevel_reduce_factor);
+      if (!GetDecodeAndMaskArray()) {
+        return LoadState::kFail;
+      }
+    }
     status_ = LoadState::kSuccess;
     return LoadState::kContinue;
   }
@@ -470,6 +531,15 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
   RetainPtr<const CPDF_Dictionary> pParams = stream_acc_->GetImageParam();
   if (decoder == "CCITTFaxDecode") {
     decoder_ = CreateFaxDecoder(src_span, GetWidth(), GetHeight(), pParams);
+    if (decoder_ && bilevel_reduce_factor > 1 &&
+        decoder_->GetWidth() >= GetWidth()) {
+      decoder_ = BilevelReducer::CreateDecoder(
+          std::move(decoder_), GetWidth(), GetHeight(), bilevel_reduce_factor);
+      SetBilevelReduceFactor(bilevel_reduce_factor);
+      if (!GetDecodeAndMaskArray()) {
+        return LoadState::kFail;
+      }
+    }
   } else if (decoder == "FlateDecode") {
     decoder_ = CreateFlateDecoder(src_span, GetWidth(), GetHeight(),
                                   components_, bpc_, pParams);
@@ -477,9 +547,20 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
     decoder_ = BasicModule::CreateRunLengthDecoder(
         src_span, GetWidth(), GetHeight(), components_, bpc_);
   } else if (decoder == "DCTDecode") {
-    if (!CreateDCTDecoder(src_span, pParams)) {
+    // libjpeg can scale down by up to 8 while it decodes.
+    const uint32_t scale_denom =
+        image_mask_ ? 1 : 1 << std::min<int>(resolution_levels_to_skip, 3);
+    if (!CreateDCTDecoder(src_span, pParams, scale_denom)) {
       return LoadState::kFail;
     }
+    if (decoder_ && scale_denom > 1) {
+      // Scale the size from the dictionary the way libjpeg scales, rather
+      // than taking the decoder's size, so the decoded rows still get clipped
+      // or padded to the dictionary's size.
+      const int denom = static_cast<int>(scale_denom);
+      SetWidth((GetWidth() + denom - 1) / denom);
+      SetHeight((GetHeight() + denom - 1) / denom);
+    }
   }
   if (!decoder_) {
     return LoadState::kFail;
@@ -502,10 +583,11 @@ CPDF_DIB::LoadState CPDF_DIB::CreateDecoder(uint8_t resolution_levels_to_skip) {
 }
 
 bool CPDF_DIB::CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
-                                const CPDF_Dictionary* pParams) {
+                                const CPDF_Dictionary* pParams,
+                                uint32_t scale_denom) {
   decoder_ = JpegModule::CreateDecoder(
       src_span, GetWidth(), GetHeight(), components_,
-      !pParams || pParams->GetIntegerFor("ColorTransform", 1));
+      !pParams || pParams->GetIntegerFor("ColorTransform", 1), scale_denom);
   if (decoder_) {
     return true;
   }
@@ -528,7 +610,8 @@ bool CPDF_DIB::CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
   if (components_ == static_cast<uint32_t>(info.num_components)) {
     bpc_ = info.bits_per_components;
     decoder_ = JpegModule::CreateDecoder(src_span, GetWidth(), GetHeight(),
-                                         components_, info.color_transform);
+                                         components_, info.color_transform,
+                                         scale_denom);
     return true;
   }
 
@@ -578,16 +661,64 @@ bool CPDF_DIB::CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
 
   bpc_ = info.bits_per_components;
   decoder_ = JpegModule::CreateDecoder(src_span, GetWidth(), GetHeight(),
-                                       components_, info.color_transform);
+                                       components_, info.color_transform,
+                                       scale_denom);
+  return true;
+}
+
+bool CPDF_DIB::CanReduceBilevel() const {
+  // Image masks and color keys need the exact bits, and only gray values can
+  // stand in for the bits in between.
+  return !image_mask_ && !color_key_ && bpc_ == 1 && components_ == 1 &&
+         family_ == CPDF_ColorSpace::Family::kDeviceGray;
+}
+
+void CPDF_DIB::SetBilevelReduceFactor(int factor) {
+  bilevel_reduce_factor_ = factor;
+  SetWidth(BilevelReducer::ReducedSize(GetWidth(), factor));
+  SetHeight(BilevelReducer::ReducedSize(GetHeight(), factor));
+  bpc_ = 8;
+}
+
+bool CPDF_DIB::ReduceCachedBilevelBitmap() {
+  auto reduced = pdfium::MakeRetain<CFX_DIBitmap>();
+  if (!reduced->Create(GetWidth(), GetHeight(), FXDIB_Format::k8bppRgb)) {
+    return false;
+  }
+
+  const int src_height = cached_bitmap_->GetHeight();
+  BilevelReducer reducer(cached_bitmap_->GetWidth(), bilevel_reduce_factor_);
+  int src_row = 0;
+  for (int row = 0; row < GetHeight(); ++row) {
+    for (int i = 0; i < bilevel_reduce_factor_ && src_row < src_height; ++i) {
+      reducer.AddRow(cached_bitmap_->GetScanline(src_row++));
+    }
+    reducer.TakeRow(reduced->GetWritableScanline(row).first(
+        static_cast<size_t>(GetWidth())));
+  }
+  cached_bitmap_ = std::move(reduced);
   return true;
 }
 
+std::unique_ptr<CJPX_Decoder> CPDF_DIB::CreateJpxDecoder(
+    uint8_t resolution_levels_to_skip) const {
+  const int64_t pixels =
+      static_cast<int64_t>(GetWidth() >> resolution_levels_to_skip) *
+      (GetHeight() >> resolution_levels_to_skip);
+  const uint32_t max_threads =
+      pixels < kMinJpxPixelsForThreads
+          ? 1
+          : static_cast<uint32_t>(ThreadPool::GetMaxLibraryThreads());
+  return CJPX_Decoder::Create(
+      stream_acc_->GetSpan(),
+      ColorSpaceOptionFromColorSpace(color_space_.Get()),
+      resolution_levels_to_skip, /*strict_mode=*/true, max_threads);
+}
+
 RetainPtr<CFX_DIBitmap> CPDF_DIB::LoadJpxBitmap(
     uint8_t resolution_levels_to_skip) {
   std::unique_ptr<CJPX_Decoder> decoder =
-      CJPX_Decoder::Create(stream_acc_->GetSpan(),
-                           ColorSpaceOptionFromColorSpace(color_space_.Get()),
-                           resolution_levels_to_skip, /*strict_mode=*/true);
+      CreateJpxDecoder(resolution_levels_to_skip);
   if (!decoder) {
     return nullptr;
   }
@@ -651,14 +782,8 @@ RetainPtr<CFX_DIBitmap> CPDF_DIB::LoadJpxBitmap(
   } else if (color_space_ &&
              color_space_->GetFamily() == CPDF_ColorSpace::Family::kIndexed &&
              bpc_ < 8) {
-    int scale = 8 - bpc_;
-    for (uint32_t row = 0; row < image_info.height; ++row) {
-      pdfium::span<uint8_t> scanline =
-          result_bitmap->GetWritableScanline(row).first(image_info.width);
-      for (auto& pixel : scanline) {
-        pixel >>= scale;
-      }
-    }
+    ScaleDownIndexedPixels(result_bitmap.Get(), image_info.width,
+                           image_info.height, 8 - bpc_);
   }
 
   // TODO(crbug.com/pdfium/1747): Handle SMaskInData entries for different
@@ -668,6 +793,216 @@ RetainPtr<CFX_DIBitmap> CPDF_DIB::LoadJpxBitmap(
   return result_bitmap;
 }
 
+bool CPDF_DIB::LoadJpxTiles(uint8_t resolution_levels_to_skip,
+                            const FX_RECT& region_required) {
+  // Images with an alpha channel or samples that do not fit the bitmap
+  // formats need the whole image at once, so LoadJpxBitmap() handles those.
+  if (dict_->GetIntegerFor("SMaskInData") == 1) {
+    return false;
+  }
+  FX_RECT region = region_required;
+  region.Intersect(FX_RECT(0, 0, GetWidth(), GetHeight()));
+  if (region.IsEmpty() || region == FX_RECT(0, 0, GetWidth(), GetHeight())) {
+    return false;
+  }
+
+  std::unique_ptr<CJPX_Decoder> decoder =
+      CreateJpxDecoder(resolution_levels_to_skip);
+  if (!decoder) {
+    return false;
+  }
+
+  const CFX_Size grid = decoder->GetTileGridSize();
+  const int scale = 1 << resolution_levels_to_skip;
+  const FX_RECT tiles = decoder->GetTilesForArea(
+      FX_RECT(region.left / scale, region.top / scale,
+              (region.right + scale - 1) / scale,
+              (region.bottom + scale - 1) / scale));
+  if (tiles.IsEmpty() || tiles == FX_RECT(0, 0, grid.width, grid.height)) {
+    return false;
+  }
+
+  // Like LoadJpxBitmap(), leaves out the odd pixels on the right and bottom
+  // edges of images that do not scale down evenly.
+  const FX_RECT image_area(0, 0, GetWidth() >> resolution_levels_to_skip,
+                           GetHeight() >> resolution_levels_to_skip);
+  auto get_tile_area = [&decoder, &image_area](int col, int row) {
+    FX_RECT area = decoder->GetAreaForTiles(FX_RECT(col, row, col + 1, row + 1));
+    area.Intersect(image_area);
+    return area;
+  };
+  auto get_tile_index = [&grid](int col, int row) {
+    return static_cast<uint32_t>(row) * static_cast<uint32_t>(grid.width) +
+           static_cast<uint32_t>(col);
+  };
+
+  CPDF_JpxTileCache* cache =
+      CPDF_DocPageData::FromDocument(document_)->GetJpxTileCache();
+  std::vector<CPDF_JpxTileCache::Tile> found(
+      static_cast<size_t>(tiles.Width()) * tiles.Height());
+  // Decodes the tiles that are still missing in one go, even though that may
+  // decode again some tiles in between that were there.
+  FX_RECT missing(tiles.right, tiles.bottom, tiles.left, tiles.top);
+  for (int row = tiles.top; row < tiles.bottom; ++row) {
+    for (int col = tiles.left; col < tiles.right; ++col) {
+      std::optional<CPDF_JpxTileCache::Tile> tile =
+          cache->Lookup(CPDF_JpxTileCache::Key(stream_, color_space_,
+                                               resolution_levels_to_skip,
+                                               get_tile_index(col, row)));
+      if (tile.has_value()) {
+        found[(row - tiles.top) * tiles.Width() + col - tiles.left] =
+            std::move(tile.value());
+        continue;
+      }
+      missing.left = std::min(missing.left, col);
+      missing.top = std::min(missing.top, row);
+      missing.right = std::max(missing.right, col + 1);
+      missing.bottom = std::max(missing.bottom, row + 1);
+    }
+  }
+  if (!missing.IsEmpty()) {
+    if (!decoder->StartDecodeTiles(missing)) {
+      return false;
+    }
+    const FX_RECT area = decoder->GetAreaForTiles(missing);
+    const CJPX_Decoder::JpxImageInfo image_info = decoder->GetInfo();
+    if (static_cast<int>(image_info.width) != area.Width() ||
+        static_cast<int>(image_info.height) != area.Height()) {
+      return false;
+    }
+
+    auto maybe_conversion =
+        JpxDecodeConversion::Create(image_info, color_space_.Get());
+    if (!maybe_conversion.has_value()) {
+      return false;
+    }
+    const auto& conversion = maybe_conversion.value();
+    if (conversion.convert_argb_to_rgb() ||
+        conversion.width() != image_info.width) {
+      return false;
+    }
+
+    RetainPtr<CPDF_ColorSpace> color_space =
+        conversion.override_colorspace().value_or(color_space_);
+    const int components = conversion.jpx_components_count().value_or(
+        static_cast<int>(components_));
+    if (components <= 0) {
+      return false;
+    }
+
+    auto area_bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+    if (!area_bitmap->Create(area.Width(), area.Height(),
+                             conversion.format())) {
+      return false;
+    }
+    area_bitmap->Clear(0xFFFFFFFF);
+    if (!decoder->Decode(area_bitmap->GetWritableBuffer(),
+                         area_bitmap->GetPitch(), conversion.swap_rgb(),
+                         components)) {
+      return false;
+    }
+    if (color_space &&
+        color_space->GetFamily() == CPDF_ColorSpace::Family::kIndexed &&
+        bpc_ < 8) {
+      ScaleDownIndexedPixels(area_bitmap.Get(), area.Width(), area.Height(),
+                             8 - bpc_);
+    }
+
+    // Split the area into tiles, which is what the cache keeps.
+    const size_t bytes_per_pixel = area_bitmap->GetBPP() / 8;
+    for (int row = missing.top; row < missing.bottom; ++row) {
+      for (int col = missing.left; col < missing.right; ++col) {
+        const FX_RECT tile_area = get_tile_area(col, row);
+        if (tile_area.IsEmpty()) {
+          continue;
+        }
+        auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+        if (!bitmap->Create(tile_area.Width(), tile_area.Height(),
+                            conversion.format())) {
+          return false;
+        }
+        for (int y = 0; y < tile_area.Height(); ++y) {
+          fxcrt::Copy(
+              area_bitmap->GetScanline(tile_area.top - area.top + y)
+                  .subspan((tile_area.left - area.left) * bytes_per_pixel,
+                           tile_area.Width() * bytes_per_pixel),
+              bitmap->GetWritableScanline(y));
+        }
+        CPDF_JpxTileCache::Tile tile;
+        tile.bitmap = std::move(bitmap);
+        tile.color_space = color_space;
+        tile.components = components;
+        cache->Store(CPDF_JpxTileCache::Key(stream_, color_space_,
+                                            resolution_levels_to_skip,
+                                            get_tile_index(col, row)),
+                     tile);
+        if (tiles.Contains(col, row)) {
+          found[(row - tiles.top) * tiles.Width() + col - tiles.left] =
+              std::move(tile);
+        }
+      }
+    }
+  }
+
+  // All tiles decode to the same format, so any of them tells what that is.
+  const CPDF_JpxTileCache::Tile* first = nullptr;
+  std::vector<JpxTile> visible_tiles;
+  for (int row = tiles.top; row < tiles.bottom; ++row) {
+    for (int col = tiles.left; col < tiles.right; ++col) {
+      const CPDF_JpxTileCache::Tile& tile =
+          found[(row - tiles.top) * tiles.Width() + col - tiles.left];
+      const FX_RECT tile_area = get_tile_area(col, row);
+      if (tile_area.IsEmpty()) {
+        continue;
+      }
+      if (!tile.bitmap || tile.bitmap->GetWidth() != tile_area.Width() ||
+          tile.bitmap->GetHeight() != tile_area.Height()) {
+        return false;
+      }
+      if (!first) {
+        first = &tile;
+      } else if (tile.bitmap->GetFormat() != first->bitmap->GetFormat() ||
+                 tile.color_space != first->color_space ||
+                 tile.components != first->components) {
+        return false;
+      }
+      visible_tiles.emplace_back(tile_area, tile.bitmap);
+    }
+  }
+  // GetScanline() reads `components_` bytes per pixel from composed rows.
+  if (!first || first->components > first->bitmap->GetBPP() / 8) {
+    return false;
+  }
+
+  SetWidth(image_area.Width());
+  SetHeight(image_area.Height());
+  color_space_ = first->color_space;
+  components_ = first->components;
+  bpc_ = 8;
+  jpx_tiles_ = std::move(visible_tiles);
+  partially_decoded_ = true;
+  return true;
+}
+
+pdfium::span<const uint8_t> CPDF_DIB::ComposeJpxScanline(int line) const {
+  const size_t bytes_per_pixel = jpx_tiles_.front().bitmap->GetBPP() / 8;
+  const size_t size = static_cast<size_t>(GetWidth()) * bytes_per_pixel;
+  if (jpx_line_buf_.size() != size) {
+    jpx_line_buf_ = DataVector<uint8_t>(size);
+  }
+  std::ranges::fill(jpx_line_buf_, 0xFF);
+  for (const JpxTile& tile : jpx_tiles_) {
+    if (line < tile.area.top || line >= tile.area.bottom) {
+      continue;
+    }
+    fxcrt::Copy(tile.bitmap->GetScanline(line - tile.area.top)
+                    .first(tile.area.Width() * bytes_per_pixel),
+                pdfium::span(jpx_line_buf_)
+                    .subspan(tile.area.left * bytes_per_pixel));
+  }
+  return jpx_line_buf_;
+}
+
 RetainPtr<CFX_DIBitmap> CPDF_DIB::ConvertArgbJpxBitmapToRgb(
     RetainPtr<CFX_DIBitmap> argb_bitmap,
     uint32_t width,
@@ -823,7 +1158,8 @@ CPDF_DIB::LoadState CPDF_DIB::StartLoadMaskDIB(
   mask_ = pdfium::MakeRetain<CPDF_DIB>(document_, std::move(mask_stream));
   LoadState ret =
       mask_->StartLoadDIBBase(false, nullptr, nullptr, true,
-                              CPDF_ColorSpace::Family::kUnknown, false, {0, 0});
+                              CPDF_ColorSpace::Family::kUnknown, false, {0, 0},
+                              FX_RECT());
   if (ret == LoadState::kContinue) {
     if (status_ == LoadState::kFail) {
       status_ = LoadState::kContinue;
@@ -899,26 +1235,34 @@ void CPDF_DIB::LoadPalette() {
     return;
   }
 
-  int palette_count = 1 << bits;
-  // Using at least 16 elements due to the call color_space_->GetRGB().
-  std::vector<float> color_values(std::max(components_, 16u));
+  const int palette_count = 1 << bits;
+  const uint32_t cs_count = color_space_->ComponentCount();
+  // ICC based colorspaces with more components than the image get the one
+  // image component for all of theirs.
+  const bool replicate = components_ == 1 &&
+                         family_ == CPDF_ColorSpace::Family::kICCBased &&
+                         cs_count > 1;
+  std::vector<float> comps(palette_count * cs_count);
   for (int i = 0; i < palette_count; i++) {
+    pdfium::span<float> color_comps =
+        pdfium::span(comps).subspan(i * cs_count, cs_count);
     int color_data = i;
     for (uint32_t j = 0; j < components_; j++) {
       int encoded_component = color_data % (1 << bpc_);
       color_data /= 1 << bpc_;
-      color_values[j] = comp_data_[j].decode_min_ +
-                        comp_data_[j].decode_step_ * encoded_component;
-    }
-    FX_RGB_STRUCT<float> rgb;
-    if (components_ == 1 && family_ == CPDF_ColorSpace::Family::kICCBased &&
-        color_space_->ComponentCount() > 1) {
-      const size_t nComponents = color_space_->ComponentCount();
-      std::vector<float> temp_buf(nComponents, color_values[0]);
-      rgb = color_space_->GetRGBOrZerosOnError(temp_buf);
-    } else {
-      rgb = color_space_->GetRGBOrZerosOnError(color_values);
+      const float value = comp_data_[j].decode_min_ +
+                          comp_data_[j].decode_step_ * encoded_component;
+      if (replicate) {
+        std::ranges::fill(color_comps, value);
+      } else if (j < cs_count) {
+        color_comps[j] = value;
+      }
     }
+  }
+  std::vector<FX_RGB_STRUCT<float>> rgbs(palette_count);
+  color_space_->GetRGBs(comps, rgbs);
+  for (int i = 0; i < palette_count; i++) {
+    const FX_RGB_STRUCT<float>& rgb = rgbs[i];
     SetPaletteArgb(i, ArgbEncode(255, FXSYS_roundf(rgb.red * 255),
                                  FXSYS_roundf(rgb.green * 255),
                                  FXSYS_roundf(rgb.blue * 255)));
@@ -961,41 +1305,65 @@ void CPDF_DIB::TranslateScanline24bpp(
     return;
   }
 
-  // Using at least 16 elements due to the call color_space_->GetRGB().
-  std::vector<float> color_values(std::max(components_, 16u));
-  FX_RGB_STRUCT<float> rgb = {};
+  // Converts the columns in chunks, so that the colorspace can convert many
+  // colors at once.
+  static constexpr int kChunkColumns = 256;
+  const bool use_color_space =
+      !TransMask() && family_ != CPDF_ColorSpace::Family::kPattern;
+  const uint32_t cs_count =
+      use_color_space ? color_space_->ComponentCount() : 0;
+  // Using at least 16 elements, as the single color GetRGB() calls do.
+  std::vector<float> color_values(std::max({components_, 16u, cs_count}));
+  std::vector<float> chunk_comps(kChunkColumns * cs_count);
+  std::vector<FX_RGB_STRUCT<float>> chunk_rgbs(kChunkColumns);
   uint64_t src_bit_pos = 0;
   uint64_t src_byte_pos = 0;
   size_t dest_byte_pos = 0;
   const bool bpp8 = bpc_ == 8;
-  for (int column = 0; column < GetWidth(); column++) {
-    for (uint32_t color = 0; color < components_; color++) {
-      if (bpp8) {
-        uint8_t data = src_scan[src_byte_pos++];
-        color_values[color] = comp_data_[color].decode_min_ +
-                              comp_data_[color].decode_step_ * data;
+  const int width = GetWidth();
+  for (int chunk_start = 0; chunk_start < width; chunk_start += kChunkColumns) {
+    const int chunk_size = std::min(kChunkColumns, width - chunk_start);
+    for (int i = 0; i < chunk_size; i++) {
+      for (uint32_t color = 0; color < components_; color++) {
+        if (bpp8) {
+          uint8_t data = src_scan[src_byte_pos++];
+          color_values[color] = comp_data_[color].decode_min_ +
+                                comp_data_[color].decode_step_ * data;
+        } else {
+          unsigned int data = GetBits8(src_scan, src_bit_pos, bpc_);
+          color_values[color] = comp_data_[color].decode_min_ +
+                                comp_data_[color].decode_step_ * data;
+          src_bit_pos += bpc_;
+        }
+      }
+      FX_RGB_STRUCT<float>& rgb = chunk_rgbs[i];
+      if (TransMask()) {
+        float k = 1.0f - color_values[3];
+        rgb.red = (1.0f - color_values[0]) * k;
+        rgb.green = (1.0f - color_values[1]) * k;
+        rgb.blue = (1.0f - color_values[2]) * k;
+      } else if (use_color_space) {
+        fxcrt::spancpy(pdfium::span(chunk_comps).subspan(i * cs_count),
+                       pdfium::span(color_values).first(cs_count));
       } else {
-        unsigned int data = GetBits8(src_scan, src_bit_pos, bpc_);
-        color_values[color] = comp_data_[color].decode_min_ +
-                              comp_data_[color].decode_step_ * data;
-        src_bit_pos += bpc_;
+        rgb = {};
       }
     }
-    if (TransMask()) {
-      float k = 1.0f - color_values[3];
-      rgb.red = (1.0f - color_values[0]) * k;
-      rgb.green = (1.0f - color_values[1]) * k;
-      rgb.blue = (1.0f - color_values[2]) * k;
-    } else if (family_ != CPDF_ColorSpace::Family::kPattern) {
-      rgb = color_space_->GetRGBOrZerosOnError(color_values);
+    if (use_color_space) {
+      color_space_->GetRGBs(
+          pdfium::span(chunk_comps).first(chunk_size * cs_count),
+          pdfium::span(chunk_rgbs).first(static_cast<size_t>(chunk_size)));
+    }
+    for (const auto& rgb :
+         pdfium::span(chunk_rgbs).first(static_cast<size_t>(chunk_size))) {
+      const float R = std::clamp(rgb.red, 0.0f, 1.0f);
+      const float G = std::clamp(rgb.green, 0.0f, 1.0f);
+      const float B = std::clamp(rgb.blue, 0.0f, 1.0f);
+      dest_scan[dest_byte_pos] = static_cast<uint8_t>(B * 255);
+      dest_scan[dest_byte_pos + 1] = static_cast<uint8_t>(G * 255);
+      dest_scan[dest_byte_pos + 2] = static_cast<uint8_t>(R * 255);
+      dest_byte_pos += 3;
     }
-    const float R = std::clamp(rgb.red, 0.0f, 1.0f);
-    const float G = std::clamp(rgb.green, 0.0f, 1.0f);
-    const float B = std::clamp(rgb.blue, 0.0f, 1.0f);
-    dest_scan[dest_byte_pos] = static_cast<uint8_t>(B * 255);
-    dest_scan[dest_byte_pos + 1] = static_cast<uint8_t>(G * 255);
-    dest_scan[dest_byte_pos + 2] = static_cast<uint8_t>(R * 255);
-    dest_byte_pos += 3;
   }
 }
 
@@ -1094,6 +1462,8 @@ pdfium::span<const uint8_t> CPDF_DIB::GetScanline(int line) const {
       line = cached_bitmap_->GetHeight() - 1;
     }
     pSrcLine = cached_bitmap_->GetScanline(line);
+  } else if (!jpx_tiles_.empty() && line >= 0 && line < GetHeight()) {
+    pSrcLine = ComposeJpxScanline(line);
   } else if (decoder_) {
     pSrcLine = decoder_->GetScanline(line);
   } else if (stream_acc_->GetSize() > line * src_pitch_value) {
@@ -1226,7 +1596,12 @@ bool CPDF_DIB::SkipToScanline(int line, PauseIndicatorIface* pPause) const {
 }
 
 size_t CPDF_DIB::GetEstimatedImageMemoryBurden() const {
-  return cached_bitmap_ ? cached_bitmap_->GetEstimatedImageMemoryBurden() : 0;
+  size_t burden =
+      cached_bitmap_ ? cached_bitmap_->GetEstimatedImageMemoryBurden() : 0;
+  for (const JpxTile& tile : jpx_tiles_) {
+    burden += tile.bitmap->GetEstimatedImageMemoryBurden();
+  }
+  return burden;
 }
 
 bool CPDF_DIB::TransMask() const {
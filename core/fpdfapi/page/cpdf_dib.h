@@ -14,6 +14,7 @@
 
 #include "core/fpdfapi/page/cpdf_colorspace.h"
 #include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
@@ -32,6 +33,7 @@ struct DIB_COMP_DATA {
 };
 
 namespace fxcodec {
+class CJPX_Decoder;
 class Jbig2Context;
 class ScanlineDecoder;
 }  // namespace fxcodec
@@ -53,14 +55,23 @@ class CPDF_DIB final : public CFX_DIBBase {
   uint32_t GetMatteColor() const { return matte_color_; }
   bool IsJBigImage() const;
 
+  // Whether only the `region_required` given to StartLoadDIBBase() is sure to
+  // have been decoded. The rest of the image may be blank.
+  bool IsPartiallyDecoded() const { return partially_decoded_; }
+
   bool Load();
+
+  // `region_required` is the part of the image that needs to be decoded, in
+  // pixels of the full size image, or empty for all of it. Decoders that can
+  // decode parts of an image skip what is outside of it.
   LoadState StartLoadDIBBase(bool bHasMask,
                              const CPDF_Dictionary* pFormResources,
                              const CPDF_Dictionary* pPageResources,
                              bool bStdCS,
                              CPDF_ColorSpace::Family GroupFamily,
                              bool bLoadMask,
-                             const CFX_Size& max_size_required);
+                             const CFX_Size& max_size_required,
+                             const FX_RECT& region_required);
   LoadState ContinueLoadDIBBase(PauseIndicatorIface* pPause);
   RetainPtr<CPDF_DIB> DetachMask();
 
@@ -77,6 +88,16 @@ class CPDF_DIB final : public CFX_DIBBase {
     DataVector<uint8_t> data;
   };
 
+  // A decoded tile of a JPEG 2000 image, and the part of the image it covers.
+  struct JpxTile {
+    JpxTile(const FX_RECT& area, RetainPtr<const CFX_DIBitmap> bitmap);
+    JpxTile(const JpxTile& that);
+    ~JpxTile();
+
+    FX_RECT area;
+    RetainPtr<const CFX_DIBitmap> bitmap;
+  };
+
   bool LoadInternal(const CPDF_Dictionary* pFormResources,
                     const CPDF_Dictionary* pPageResources);
   bool ContinueInternal();
@@ -87,15 +108,27 @@ class CPDF_DIB final : public CFX_DIBBase {
   bool LoadColorInfo(const CPDF_Dictionary* pFormResources,
                      const CPDF_Dictionary* pPageResources);
   bool GetDecodeAndMaskArray();
+  std::unique_ptr<fxcodec::CJPX_Decoder> CreateJpxDecoder(
+      uint8_t resolution_levels_to_skip) const;
   RetainPtr<CFX_DIBitmap> LoadJpxBitmap(uint8_t resolution_levels_to_skip);
+  // Decodes only the tiles that `region_required` needs, into `jpx_tiles_`.
+  // Returns false for images to decode whole instead.
+  bool LoadJpxTiles(uint8_t resolution_levels_to_skip,
+                    const FX_RECT& region_required);
+  pdfium::span<const uint8_t> ComposeJpxScanline(int line) const;
   RetainPtr<CFX_DIBitmap> ConvertArgbJpxBitmapToRgb(
       RetainPtr<CFX_DIBitmap> argb_bitmap,
       uint32_t width,
       uint32_t height);
   void LoadPalette();
-  LoadState CreateDecoder(uint8_t resolution_levels_to_skip);
+  LoadState CreateDecoder(uint8_t resolution_levels_to_skip,
+                          const FX_RECT& region_required);
   bool CreateDCTDecoder(pdfium::span<const uint8_t> src_span,
-                        const CPDF_Dictionary* pParams);
+                        const CPDF_Dictionary* pParams,
+                        uint32_t scale_denom);
+  bool CanReduceBilevel() const;
+  void SetBilevelReduceFactor(int factor);
+  bool ReduceCachedBilevelBitmap();
   void TranslateScanline24bpp(pdfium::span<uint8_t> dest_scan,
                               pdfium::span<const uint8_t> src_scan) const;
   bool TranslateScanline24bppDefaultDecode(
@@ -119,6 +152,9 @@ class CPDF_DIB final : public CFX_DIBBase {
   CPDF_ColorSpace::Family family_ = CPDF_ColorSpace::Family::kUnknown;
   CPDF_ColorSpace::Family group_family_ = CPDF_ColorSpace::Family::kUnknown;
   uint32_t matte_color_ = 0;
+  // When more than 1, 1 bit per pixel source data shrinks by this factor in
+  // both directions into 8 bit per pixel gray as it decodes.
+  int bilevel_reduce_factor_ = 1;
   LoadState status_ = LoadState::kFail;
   bool load_mask_ = false;
   bool default_decode_ = true;
@@ -127,10 +163,16 @@ class CPDF_DIB final : public CFX_DIBBase {
   bool color_key_ = false;
   bool has_mask_ = false;
   bool std_cs_ = false;
+  bool partially_decoded_ = false;
   std::vector<DIB_COMP_DATA> comp_data_;
   mutable DataVector<uint8_t> line_buf_;
   mutable DataVector<uint8_t> mask_buf_;
   RetainPtr<CFX_DIBitmap> cached_bitmap_;
+  // Set instead of `cached_bitmap_` when only the visible tiles of a JPEG 2000
+  // image got decoded. Rows are composed from them as they are read, and the
+  // rest of the image is white.
+  std::vector<JpxTile> jpx_tiles_;
+  mutable DataVector<uint8_t> jpx_line_buf_;
   // Note: Must not create a cycle between CPDF_DIB instances.
   RetainPtr<CPDF_DIB> mask_;
   RetainPtr<CPDF_StreamAcc> global_acc_;
@@ -0,0 +1,75 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_dib.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/utils/file_util.h"
+#include "testing/utils/path_service.h"
+
+using CPDFDIBTest = TestWithPageModule;
+
+TEST_F(CPDFDIBTest, ReducedJpegKeepsDictionarySize) {
+  // The JPEG is 120 by 120 pixels, so the decoded rows need clipping to the
+  // width, and padding to the height.
+  const std::string path = PathService::GetTestFilePath("mona_lisa.jpg");
+  ASSERT_FALSE(path.empty());
+  const std::vector<uint8_t> jpeg = GetFileContents(path.c_str());
+  ASSERT_FALSE(jpeg.empty());
+
+  CPDF_TestDocument doc;
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Name>("Type", "XObject");
+  dict->SetNewFor<CPDF_Name>("Subtype", "Image");
+  dict->SetNewFor<CPDF_Number>("Width", 100);
+  dict->SetNewFor<CPDF_Number>("Height", 130);
+  dict->SetNewFor<CPDF_Name>("ColorSpace", "DeviceRGB");
+  dict->SetNewFor<CPDF_Number>("BitsPerComponent", 8);
+  dict->SetNewFor<CPDF_Name>("Filter", "DCTDecode");
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(jpeg.begin(), jpeg.end()), std::move(dict));
+
+  auto full = pdfium::MakeRetain<CPDF_DIB>(&doc, stream);
+  ASSERT_EQ(CPDF_DIB::LoadState::kSuccess,
+            full->StartLoadDIBBase(false, nullptr, nullptr, false,
+                                   CPDF_ColorSpace::Family::kUnknown, false,
+                                   CFX_Size(), FX_RECT()));
+  EXPECT_EQ(100, full->GetWidth());
+  EXPECT_EQ(130, full->GetHeight());
+
+  // A quarter of the size makes libjpeg decode at 1/4 scale.
+  auto reduced = pdfium::MakeRetain<CPDF_DIB>(&doc, stream);
+  ASSERT_EQ(CPDF_DIB::LoadState::kSuccess,
+            reduced->StartLoadDIBBase(false, nullptr, nullptr, false,
+                                      CPDF_ColorSpace::Family::kUnknown, false,
+                                      CFX_Size(25, 25), FX_RECT()));
+  EXPECT_EQ(25, reduced->GetWidth());
+  EXPECT_EQ(33, reduced->GetHeight());
+
+  // Decoded rows are as wide as the dictionary says, and the rows past the
+  // end of the JPEG are blank, as at full size.
+  pdfium::span<const uint8_t> last_decoded_row = reduced->GetScanline(29);
+  EXPECT_EQ(75u, last_decoded_row.size());
+  EXPECT_TRUE(std::ranges::any_of(last_decoded_row,
+                                  [](uint8_t value) { return value != 0; }));
+  EXPECT_TRUE(std::ranges::all_of(reduced->GetScanline(32),
+                                  [](uint8_t value) { return value == 0; }));
+}
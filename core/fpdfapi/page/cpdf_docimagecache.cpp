@@ -0,0 +1,125 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
+
+#include <tuple>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxge/dib/cfx_dibbase.h"
+
+namespace {
+
+// Decoders may size images without a required size as they please, so these
+// all count as full size.
+CFX_Size NormalizeSize(const CFX_Size& size) {
+  return size.width && size.height ? size : CFX_Size();
+}
+
+// Counts pixels rather than what GetEstimatedImageMemoryBurden() reports, as
+// that leaves out images that are still being decoded scanline by scanline,
+// though those too hold on to decoded data.
+size_t EstimateSize(const CFX_DIBBase* dib) {
+  return dib ? static_cast<size_t>(dib->GetPitch()) * dib->GetHeight() : 0;
+}
+
+bool IsLargeEnough(const CFX_DIBBase* bitmap,
+                   const CFX_Size& decoded_size,
+                   const CFX_Size& max_size_required) {
+  if (decoded_size == CFX_Size()) {
+    return true;
+  }
+  if (max_size_required.width == 0 && max_size_required.height == 0) {
+    return false;
+  }
+  return bitmap->GetWidth() >= max_size_required.width &&
+         bitmap->GetHeight() >= max_size_required.height;
+}
+
+bool HaveSameOptions(const CPDF_DocImageCache::Options& a,
+                     const CPDF_DocImageCache::Options& b) {
+  return a.std_cs == b.std_cs && a.family == b.family &&
+         a.load_mask == b.load_mask;
+}
+
+}  // namespace
+
+CPDF_DocImageCache::Image::Image() = default;
+
+CPDF_DocImageCache::Image::Image(const Image& that) = default;
+
+CPDF_DocImageCache::Image::~Image() = default;
+
+CPDF_DocImageCache::Key::Key(RetainPtr<const CPDF_Stream> stream,
+                             const Options& options,
+                             const CFX_Size& size)
+    : stream(std::move(stream)), options(options), size(size) {}
+
+CPDF_DocImageCache::Key::Key(const Key& that) = default;
+
+CPDF_DocImageCache::Key::~Key() = default;
+
+bool CPDF_DocImageCache::Key::operator<(const Key& other) const {
+  return std::tie(stream, options.std_cs, options.family, options.load_mask,
+                  size.width, size.height) <
+         std::tie(other.stream, other.options.std_cs, other.options.family,
+                  other.options.load_mask, other.size.width,
+                  other.size.height);
+}
+
+CPDF_DocImageCache::CPDF_DocImageCache() : cache_(kDefaultLimit) {}
+
+CPDF_DocImageCache::~CPDF_DocImageCache() = default;
+
+std::optional<CPDF_DocImageCache::Image> CPDF_DocImageCache::Lookup(
+    const CPDF_Stream* stream,
+    const Options& options,
+    const CFX_Size& max_size_required) {
+  // All sizes of one stream and `options` are next to each other, with the
+  // full size one first.
+  const Key first(pdfium::WrapRetain(stream), options, CFX_Size());
+  const Image* image = cache_.LookupInRange(
+      first,
+      [&first](const Key& key) {
+        return key.stream == first.stream &&
+               HaveSameOptions(key.options, first.options);
+      },
+      [&max_size_required](const Key& key, const Image& image) {
+        return IsLargeEnough(image.bitmap.Get(), key.size, max_size_required);
+      });
+  if (!image) {
+    return std::nullopt;
+  }
+  return *image;
+}
+
+void CPDF_DocImageCache::Store(RetainPtr<const CPDF_Stream> stream,
+                               const Options& options,
+                               const CFX_Size& max_size_required,
+                               Image image) {
+  if (!image.bitmap) {
+    return;
+  }
+  const size_t size =
+      EstimateSize(image.bitmap.Get()) + EstimateSize(image.mask.Get());
+  cache_.Store(
+      Key(std::move(stream), options, NormalizeSize(max_size_required)),
+      std::move(image), size);
+}
+
+void CPDF_DocImageCache::Invalidate(const CPDF_Stream* stream) {
+  const Key first(pdfium::WrapRetain(stream), Options(), CFX_Size());
+  cache_.EraseRange(first, [&first](const Key& key) {
+    return key.stream == first.stream;
+  });
+}
+
+void CPDF_DocImageCache::SetLimit(size_t limit) {
+  cache_.SetLimit(limit);
+}
+
+CPDF_DocImageCache::Stats CPDF_DocImageCache::GetStats() const {
+  return cache_.GetStats();
+}
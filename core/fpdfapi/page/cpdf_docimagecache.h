@@ -0,0 +1,95 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_DOCIMAGECACHE_H_
+#define CORE_FPDFAPI_PAGE_CPDF_DOCIMAGECACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+
+#include "core/fpdfapi/page/cpdf_colorspace.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/lru_cache.h"
+#include "core/fxcrt/retain_ptr.h"
+
+class CFX_DIBBase;
+class CPDF_Stream;
+
+// Decoded images of one document, shared by all of its pages, so that an
+// image decoded for one page is still there when another page, or the same
+// page loaded again, shows it, up to SetLimit() bytes of them.
+//
+// Images are keyed by their stream, and by the size they were decoded for,
+// as images may be decoded at less than their full size when they are drawn
+// small.
+class CPDF_DocImageCache {
+ public:
+  // Besides the stream, what an image decodes to depends on these.
+  struct Options {
+    bool std_cs = false;
+    CPDF_ColorSpace::Family family = CPDF_ColorSpace::Family::kUnknown;
+    bool load_mask = false;
+  };
+
+  struct Image {
+    Image();
+    Image(const Image& that);
+    ~Image();
+
+    RetainPtr<CFX_DIBBase> bitmap;
+    RetainPtr<CFX_DIBBase> mask;
+    uint32_t matte_color = 0;
+  };
+
+  using Stats = LruCacheStats;
+
+  static constexpr size_t kDefaultLimit = 32 * 1024 * 1024;
+
+  CPDF_DocImageCache();
+  ~CPDF_DocImageCache();
+
+  // Returns an image of `stream` that was decoded with `options`, and that is
+  // at least `max_size_required`, or at full size if that is empty.
+  std::optional<Image> Lookup(const CPDF_Stream* stream,
+                              const Options& options,
+                              const CFX_Size& max_size_required);
+
+  // Adds `image`, which `stream` decoded to for `max_size_required`, unless
+  // it alone is over the limit.
+  void Store(RetainPtr<const CPDF_Stream> stream,
+             const Options& options,
+             const CFX_Size& max_size_required,
+             Image image);
+
+  // Drops all images of `stream`, for when it changes.
+  void Invalidate(const CPDF_Stream* stream);
+
+  // 0 turns the cache off.
+  void SetLimit(size_t limit);
+
+  Stats GetStats() const;
+
+ private:
+  struct Key {
+    Key(RetainPtr<const CPDF_Stream> stream,
+        const Options& options,
+        const CFX_Size& size);
+    Key(const Key& that);
+    ~Key();
+
+    bool operator<(const Key& other) const;
+
+    // Keeps `stream` alive, so no other stream can take its address.
+    RetainPtr<const CPDF_Stream> stream;
+    Options options;
+    // Empty for images decoded at full size.
+    CFX_Size size;
+  };
+
+  LruCache<Key, Image> cache_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_DOCIMAGECACHE_H_
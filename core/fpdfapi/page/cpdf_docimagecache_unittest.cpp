@@ -0,0 +1,123 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
+
+#include <optional>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Image = CPDF_DocImageCache::Image;
+using Options = CPDF_DocImageCache::Options;
+
+constexpr Options kOptions;
+
+RetainPtr<CPDF_Stream> MakeStream() {
+  return pdfium::MakeRetain<CPDF_Stream>(
+      pdfium::MakeRetain<CPDF_Dictionary>());
+}
+
+// Each image takes 4 bytes per pixel.
+Image MakeImage(int width, int height) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, FXDIB_Format::kBgra));
+  Image image;
+  image.bitmap = bitmap;
+  return image;
+}
+
+}  // namespace
+
+TEST(CPDFDocImageCache, LookupAndStats) {
+  CPDF_DocImageCache cache;
+  RetainPtr<CPDF_Stream> stream = MakeStream();
+  EXPECT_FALSE(cache.Lookup(stream.Get(), kOptions, CFX_Size()));
+
+  Image image = MakeImage(10, 10);
+  cache.Store(stream, kOptions, CFX_Size(), image);
+  std::optional<Image> found = cache.Lookup(stream.Get(), kOptions, {5, 5});
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(image.bitmap, found->bitmap);
+
+  // Other options make for other images.
+  const Options other_options = {.load_mask = true};
+  EXPECT_FALSE(cache.Lookup(stream.Get(), other_options, CFX_Size()));
+  EXPECT_FALSE(cache.Lookup(MakeStream().Get(), kOptions, CFX_Size()));
+
+  const CPDF_DocImageCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(CPDF_DocImageCache::kDefaultLimit, stats.limit);
+  EXPECT_EQ(400u, stats.size);
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+}
+
+TEST(CPDFDocImageCache, DecodedSize) {
+  CPDF_DocImageCache cache;
+  RetainPtr<CPDF_Stream> stream = MakeStream();
+
+  // Decoded for 20x20, and the decoder picked 25x25.
+  cache.Store(stream, kOptions, {20, 20}, MakeImage(25, 25));
+  EXPECT_TRUE(cache.Lookup(stream.Get(), kOptions, {20, 20}));
+  EXPECT_TRUE(cache.Lookup(stream.Get(), kOptions, {25, 10}));
+  EXPECT_FALSE(cache.Lookup(stream.Get(), kOptions, {30, 30}));
+  EXPECT_FALSE(cache.Lookup(stream.Get(), kOptions, CFX_Size()));
+
+  // Both sizes stay around, and the larger one serves larger requests.
+  cache.Store(stream, kOptions, {40, 40}, MakeImage(50, 50));
+  EXPECT_EQ(2u, cache.GetStats().count);
+  std::optional<Image> found = cache.Lookup(stream.Get(), kOptions, {30, 30});
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(50, found->bitmap->GetWidth());
+
+  // A full size image serves every request.
+  cache.Store(stream, kOptions, CFX_Size(), MakeImage(100, 100));
+  EXPECT_TRUE(cache.Lookup(stream.Get(), kOptions, CFX_Size()));
+  EXPECT_TRUE(cache.Lookup(stream.Get(), kOptions, {80, 80}));
+
+  cache.Invalidate(stream.Get());
+  EXPECT_EQ(0u, cache.GetStats().count);
+  EXPECT_EQ(0u, cache.GetStats().size);
+  EXPECT_FALSE(cache.Lookup(stream.Get(), kOptions, {20, 20}));
+}
+
+TEST(CPDFDocImageCache, EvictsLeastRecentlyUsed) {
+  CPDF_DocImageCache cache;
+  cache.SetLimit(1000);
+  RetainPtr<CPDF_Stream> stream1 = MakeStream();
+  RetainPtr<CPDF_Stream> stream2 = MakeStream();
+  RetainPtr<CPDF_Stream> stream3 = MakeStream();
+
+  cache.Store(stream1, kOptions, CFX_Size(), MakeImage(10, 10));
+  cache.Store(stream2, kOptions, CFX_Size(), MakeImage(10, 10));
+  EXPECT_TRUE(cache.Lookup(stream1.Get(), kOptions, CFX_Size()));
+
+  // Makes room by dropping `stream2`, which was used longest ago.
+  cache.Store(stream3, kOptions, CFX_Size(), MakeImage(10, 10));
+  EXPECT_EQ(800u, cache.GetStats().size);
+  EXPECT_TRUE(cache.Lookup(stream1.Get(), kOptions, CFX_Size()));
+  EXPECT_FALSE(cache.Lookup(stream2.Get(), kOptions, CFX_Size()));
+  EXPECT_TRUE(cache.Lookup(stream3.Get(), kOptions, CFX_Size()));
+
+  // Too large on its own.
+  cache.Store(stream2, kOptions, CFX_Size(), MakeImage(20, 20));
+  EXPECT_FALSE(cache.Lookup(stream2.Get(), kOptions, CFX_Size()));
+  EXPECT_EQ(2u, cache.GetStats().count);
+
+  cache.SetLimit(500);
+  EXPECT_EQ(1u, cache.GetStats().count);
+  EXPECT_TRUE(cache.Lookup(stream3.Get(), kOptions, CFX_Size()));
+
+  cache.SetLimit(0);
+  EXPECT_EQ(0u, cache.GetStats().count);
+  cache.Store(stream1, kOptions, CFX_Size(), MakeImage(1, 1));
+  EXPECT_EQ(0u, cache.GetStats().count);
+}
@@ -4,12 +4,41 @@
 
 #include "core/fpdfapi/page/cpdf_function.h"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+// A type 4 function with 2 inputs and 1 output in [0, 10].
+std::unique_ptr<CPDF_Function> LoadPostScriptFunction(ByteStringView program) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("FunctionType", 4);
+  auto domain = dict->SetNewFor<CPDF_Array>("Domain");
+  for (int value : {0, 1, 0, 1}) {
+    domain->AppendNew<CPDF_Number>(value);
+  }
+  auto range = dict->SetNewFor<CPDF_Array>("Range");
+  range->AppendNew<CPDF_Number>(0);
+  range->AppendNew<CPDF_Number>(10);
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(program.unsigned_span().begin(),
+                          program.unsigned_span().end()),
+      std::move(dict));
+  return CPDF_Function::Load(stream);
+}
+
+}  // namespace
+
 TEST(CPDFFunction, BadFunctionType) {
   auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
   dict->SetNewFor<CPDF_Number>("FunctionType", -2);
@@ -41,3 +70,40 @@ TEST(CPDFFunction, NoRange) {
   pArray->AppendNew<CPDF_Number>(10);
   EXPECT_FALSE(CPDF_Function::Load(dict));
 }
+
+TEST(CPDFFunction, PostScript) {
+  // The first program compiles. The second one does not, as the count for
+  // `copy` depends on the inputs, so it runs on CPDF_PSEngine.
+  for (ByteStringView program :
+       {"{ exch 2 mul exch sub }",
+        "{ dup 0 mul cvi 1 add copy pop exch 2 mul exch sub }"}) {
+    std::unique_ptr<CPDF_Function> func = LoadPostScriptFunction(program);
+    ASSERT_TRUE(func);
+
+    // Call twice, so that the second calls hit the cache of recent results.
+    for (int pass = 0; pass < 2; ++pass) {
+      std::vector<float> results(1);
+      const float inputs1[] = {0.5f, 0.25f};
+      ASSERT_EQ(1u, func->Call(inputs1, results).value_or(0));
+      EXPECT_FLOAT_EQ(0.75f, results[0]);
+
+      const float inputs2[] = {1.0f, 0.0f};
+      ASSERT_EQ(1u, func->Call(inputs2, results).value_or(0));
+      EXPECT_FLOAT_EQ(2.0f, results[0]);
+
+      // Clamped to the range.
+      const float inputs3[] = {0.0f, 1.0f};
+      ASSERT_EQ(1u, func->Call(inputs3, results).value_or(0));
+      EXPECT_FLOAT_EQ(0.0f, results[0]);
+    }
+  }
+}
+
+TEST(CPDFFunction, PostScriptTooFewResults) {
+  std::unique_ptr<CPDF_Function> func =
+      LoadPostScriptFunction("{ pop pop pop }");
+  ASSERT_TRUE(func);
+  std::vector<float> results(1);
+  const float inputs[] = {0.5f, 0.25f};
+  EXPECT_FALSE(func->Call(inputs, results).has_value());
+}
@@ -56,6 +56,11 @@ void CPDF_IccProfile::Translate(pdfium::span<const float> pSrcValues,
   transform_->Translate(pSrcValues, pDestValues);
 }
 
+void CPDF_IccProfile::TranslateColors(pdfium::span<const float> src_values,
+                                      pdfium::span<float> dest_values) {
+  transform_->TranslateColors(src_values, dest_values);
+}
+
 void CPDF_IccProfile::TranslateScanline(pdfium::span<uint8_t> pDest,
                                         pdfium::span<const uint8_t> pSrc,
                                         int pixels) {
@@ -32,6 +32,8 @@ class CPDF_IccProfile final : public Retainable {
   bool IsNormal() const;
   void Translate(pdfium::span<const float> pSrcValues,
                  pdfium::span<float> pDestValues);
+  void TranslateColors(pdfium::span<const float> src_values,
+                       pdfium::span<float> dest_values);
   void TranslateScanline(pdfium::span<uint8_t> pDest,
                          pdfium::span<const uint8_t> pSrc,
                          int pixels);
@@ -362,11 +362,12 @@ bool CPDF_Image::StartLoadDIBBase(const CPDF_Dictionary* pFormResource,
                                   bool bStdCS,
                                   CPDF_ColorSpace::Family GroupFamily,
                                   bool bLoadMask,
-                                  const CFX_Size& max_size_required) {
+                                  const CFX_Size& max_size_required,
+                                  const FX_RECT& region_required) {
   RetainPtr<CPDF_DIB> source = CreateNewDIB();
-  CPDF_DIB::LoadState ret =
-      source->StartLoadDIBBase(true, pFormResource, pPageResource, bStdCS,
-                               GroupFamily, bLoadMask, max_size_required);
+  CPDF_DIB::LoadState ret = source->StartLoadDIBBase(
+      true, pFormResource, pPageResource, bStdCS, GroupFamily, bLoadMask,
+      max_size_required, region_required);
   if (ret == CPDF_DIB::LoadState::kFail) {
     dibbase_.Reset();
     return false;
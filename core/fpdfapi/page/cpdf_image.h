@@ -66,7 +66,8 @@ class CPDF_Image final : public Retainable {
                         bool bStdCS,
                         CPDF_ColorSpace::Family GroupFamily,
                         bool bLoadMask,
-                        const CFX_Size& max_size_required);
+                        const CFX_Size& max_size_required,
+                        const FX_RECT& region_required);
 
   // Returns whether to Continue() or not.
   bool Continue(PauseIndicatorIface* pPause);
@@ -5,6 +5,7 @@
 #include "core/fpdfapi/page/cpdf_indexedcs.h"
 
 #include <set>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_colorspace.h"
 #include "core/fpdfapi/page/cpdf_docpagedata.h"
@@ -85,15 +86,53 @@ uint32_t CPDF_IndexedCS::v_Load(CPDF_Document* doc,
     pdfium::span<const uint8_t> str_span = acc->GetSpan();
     lookup_table_ = DataVector<uint8_t>(str_span.begin(), str_span.end());
   }
+  BuildPalette();
   return 1;
 }
 
 std::optional<FX_RGB_STRUCT<float>> CPDF_IndexedCS::GetRGB(
     pdfium::span<const float> pBuf) const {
-  int32_t index = static_cast<int32_t>(pBuf[0]);
-  if (index < 0 || index > max_index_) {
+  DataVector<float> comps(component_min_max_.size());
+  if (!GetBaseComps(pBuf[0], comps)) {
     return std::nullopt;
   }
+  return base_cs_->GetRGB(comps);
+}
+
+void CPDF_IndexedCS::GetRGBs(pdfium::span<const float> comps,
+                             pdfium::span<FX_RGB_STRUCT<float>> rgbs) const {
+  for (size_t i = 0; i < rgbs.size(); ++i) {
+    const int32_t index = static_cast<int32_t>(comps[i]);
+    rgbs[i] = index >= 0 && index <= max_index_ ? palette_[index]
+                                                : FX_RGB_STRUCT<float>{};
+  }
+}
+
+void CPDF_IndexedCS::BuildPalette() {
+  const size_t count = max_index_ + 1;
+  const size_t base_count = component_min_max_.size();
+  DataVector<float> base_comps(count * base_count);
+  std::vector<bool> failed(count);
+  for (size_t i = 0; i < count; ++i) {
+    failed[i] = !GetBaseComps(
+        static_cast<float>(i),
+        pdfium::span(base_comps).subspan(i * base_count, base_count));
+  }
+  palette_.resize(count);
+  base_cs_->GetRGBs(base_comps, palette_);
+  for (size_t i = 0; i < count; ++i) {
+    if (failed[i]) {
+      palette_[i] = FX_RGB_STRUCT<float>{};
+    }
+  }
+}
+
+bool CPDF_IndexedCS::GetBaseComps(float value,
+                                  pdfium::span<float> base_comps) const {
+  int32_t index = static_cast<int32_t>(value);
+  if (index < 0 || index > max_index_) {
+    return false;
+  }
 
   DCHECK(!component_min_max_.empty());
   DCHECK_EQ(component_min_max_.size(), base_cs_->ComponentCount());
@@ -102,15 +141,14 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_IndexedCS::GetRGB(
   length += 1;
   length *= component_min_max_.size();
   if (!length.IsValid() || length.ValueOrDie() > lookup_table_.size()) {
-    return std::nullopt;
+    return false;
   }
 
-  DataVector<float> comps(component_min_max_.size());
   for (uint32_t i = 0; i < component_min_max_.size(); ++i) {
     const IndexedColorMinMax& comp = component_min_max_[i];
-    comps[i] =
+    base_comps[i] =
         comp.min +
         comp.max * lookup_table_[index * component_min_max_.size() + i] / 255;
   }
-  return base_cs_->GetRGB(comps);
+  return true;
 }
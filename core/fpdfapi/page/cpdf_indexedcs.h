@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <set>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_basedcs.h"
 #include "core/fxcrt/data_vector.h"
@@ -30,6 +31,8 @@ class CPDF_IndexedCS final : public CPDF_BasedCS {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void GetRGBs(pdfium::span<const float> comps,
+               pdfium::span<FX_RGB_STRUCT<float>> rgbs) const override;
   const CPDF_IndexedCS* AsIndexedCS() const override;
   uint32_t v_Load(CPDF_Document* doc,
                   const CPDF_Array* pArray,
@@ -40,9 +43,21 @@ class CPDF_IndexedCS final : public CPDF_BasedCS {
  private:
   CPDF_IndexedCS();
 
+  // Looks `value` up in the table, and sets `base_comps` to the color in the
+  // base color space. Returns false where `value` is not a valid index.
+  bool GetBaseComps(float value, pdfium::span<float> base_comps) const;
+
+  // Converts every color in the table to RGB, so GetRGBs() only looks colors
+  // up in `palette_`.
+  void BuildPalette();
+
   int max_index_ = 0;
   DataVector<uint8_t> lookup_table_;
   DataVector<IndexedColorMinMax> component_min_max_;
+
+  // The RGB color for each index up to `max_index_`, with zeros for the ones
+  // past the end of `lookup_table_`.
+  std::vector<FX_RGB_STRUCT<float>> palette_;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_INDEXEDCS_H_
@@ -0,0 +1,71 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_jpxtilecache.h"
+
+#include <tuple>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+CPDF_JpxTileCache::Key::Key(RetainPtr<const CPDF_Stream> stream,
+                            RetainPtr<const CPDF_ColorSpace> color_space,
+                            uint8_t resolution_levels_to_skip,
+                            uint32_t tile_index)
+    : stream(std::move(stream)),
+      color_space(std::move(color_space)),
+      resolution_levels_to_skip(resolution_levels_to_skip),
+      tile_index(tile_index) {}
+
+CPDF_JpxTileCache::Key::Key(const Key& that) = default;
+
+CPDF_JpxTileCache::Key::~Key() = default;
+
+bool CPDF_JpxTileCache::Key::operator<(const Key& other) const {
+  return std::tie(stream, color_space, resolution_levels_to_skip, tile_index) <
+         std::tie(other.stream, other.color_space,
+                  other.resolution_levels_to_skip, other.tile_index);
+}
+
+CPDF_JpxTileCache::Tile::Tile() = default;
+
+CPDF_JpxTileCache::Tile::Tile(const Tile& that) = default;
+
+CPDF_JpxTileCache::Tile::~Tile() = default;
+
+CPDF_JpxTileCache::CPDF_JpxTileCache() : cache_(kDefaultLimit) {}
+
+CPDF_JpxTileCache::~CPDF_JpxTileCache() = default;
+
+std::optional<CPDF_JpxTileCache::Tile> CPDF_JpxTileCache::Lookup(
+    const Key& key) {
+  const Tile* tile = cache_.Lookup(key);
+  if (!tile) {
+    return std::nullopt;
+  }
+  return *tile;
+}
+
+void CPDF_JpxTileCache::Store(const Key& key, Tile tile) {
+  if (!tile.bitmap) {
+    return;
+  }
+  const size_t size =
+      static_cast<size_t>(tile.bitmap->GetPitch()) * tile.bitmap->GetHeight();
+  cache_.Store(key, std::move(tile), size);
+}
+
+void CPDF_JpxTileCache::Invalidate(const CPDF_Stream* stream) {
+  cache_.EraseRange(Key(pdfium::WrapRetain(stream), nullptr, 0, 0),
+                    [stream](const Key& key) { return key.stream == stream; });
+}
+
+void CPDF_JpxTileCache::SetLimit(size_t limit) {
+  cache_.SetLimit(limit);
+}
+
+CPDF_JpxTileCache::Stats CPDF_JpxTileCache::GetStats() const {
+  return cache_.GetStats();
+}
@@ -0,0 +1,82 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_JPXTILECACHE_H_
+#define CORE_FPDFAPI_PAGE_CPDF_JPXTILECACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+
+#include "core/fpdfapi/page/cpdf_colorspace.h"
+#include "core/fxcrt/lru_cache.h"
+#include "core/fxcrt/retain_ptr.h"
+
+class CFX_DIBitmap;
+class CPDF_Stream;
+
+// The tiles of tiled JPEG 2000 images of one document that have been decoded
+// so far, for images that only get decoded where they are visible. Showing
+// another part of such an image then only decodes the tiles it did not have
+// yet. Like CPDF_DocImageCache, this keeps up to SetLimit() bytes.
+class CPDF_JpxTileCache {
+ public:
+  struct Key {
+    Key(RetainPtr<const CPDF_Stream> stream,
+        RetainPtr<const CPDF_ColorSpace> color_space,
+        uint8_t resolution_levels_to_skip,
+        uint32_t tile_index);
+    Key(const Key& that);
+    ~Key();
+
+    bool operator<(const Key& other) const;
+
+    // Keeps `stream` alive, so no other stream can take its address.
+    RetainPtr<const CPDF_Stream> stream;
+    // The color space the image was decoded for.
+    RetainPtr<const CPDF_ColorSpace> color_space;
+    uint8_t resolution_levels_to_skip;
+    // Counts tiles row by row.
+    uint32_t tile_index;
+  };
+
+  // One decoded tile of an image at one resolution.
+  struct Tile {
+    Tile();
+    Tile(const Tile& that);
+    ~Tile();
+
+    // The part of the image the tile covers. Never modified once stored.
+    RetainPtr<const CFX_DIBitmap> bitmap;
+    // What decoding made of the image's color space and component count.
+    RetainPtr<CPDF_ColorSpace> color_space;
+    uint32_t components = 0;
+  };
+
+  using Stats = LruCacheStats;
+
+  static constexpr size_t kDefaultLimit = 64 * 1024 * 1024;
+
+  CPDF_JpxTileCache();
+  ~CPDF_JpxTileCache();
+
+  std::optional<Tile> Lookup(const Key& key);
+
+  // Adds or replaces the tile of `key`, unless it alone is over the limit.
+  void Store(const Key& key, Tile tile);
+
+  // Drops all tiles of `stream`, for when it changes.
+  void Invalidate(const CPDF_Stream* stream);
+
+  // 0 turns the cache off.
+  void SetLimit(size_t limit);
+
+  Stats GetStats() const;
+
+ private:
+  LruCache<Key, Tile> cache_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_JPXTILECACHE_H_
@@ -0,0 +1,90 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_jpxtilecache.h"
+
+#include <optional>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Key = CPDF_JpxTileCache::Key;
+using Tile = CPDF_JpxTileCache::Tile;
+
+RetainPtr<CPDF_Stream> MakeStream() {
+  return pdfium::MakeRetain<CPDF_Stream>(
+      pdfium::MakeRetain<CPDF_Dictionary>());
+}
+
+// Each tile takes 4 bytes per pixel.
+Tile MakeTile(int width, int height) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, FXDIB_Format::kBgrx));
+  Tile tile;
+  tile.bitmap = bitmap;
+  tile.components = 3;
+  return tile;
+}
+
+}  // namespace
+
+TEST(CPDFJpxTileCache, LookupAndInvalidate) {
+  CPDF_JpxTileCache cache;
+  RetainPtr<CPDF_Stream> stream = MakeStream();
+  const Key key(stream, nullptr, 0, 0);
+  EXPECT_FALSE(cache.Lookup(key));
+
+  Tile tile = MakeTile(10, 10);
+  cache.Store(key, tile);
+  EXPECT_EQ(400u, cache.GetStats().size);
+  std::optional<Tile> found = cache.Lookup(key);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(tile.bitmap, found->bitmap);
+  EXPECT_EQ(3u, found->components);
+
+  // Other tiles, resolutions and streams have their own entries.
+  EXPECT_FALSE(cache.Lookup(Key(stream, nullptr, 0, 1)));
+  EXPECT_FALSE(cache.Lookup(Key(stream, nullptr, 1, 0)));
+  EXPECT_FALSE(cache.Lookup(Key(MakeStream(), nullptr, 0, 0)));
+
+  // Replaces what was there.
+  cache.Store(key, MakeTile(5, 5));
+  EXPECT_EQ(100u, cache.GetStats().size);
+  cache.Store(Key(stream, nullptr, 0, 1), MakeTile(5, 5));
+  cache.Store(Key(stream, nullptr, 1, 0), MakeTile(5, 5));
+  EXPECT_EQ(300u, cache.GetStats().size);
+  EXPECT_EQ(3u, cache.GetStats().count);
+
+  // Tiles of other streams stay.
+  RetainPtr<CPDF_Stream> other_stream = MakeStream();
+  const Key other_key(other_stream, nullptr, 0, 0);
+  cache.Store(other_key, MakeTile(5, 5));
+  cache.Invalidate(stream.Get());
+  EXPECT_EQ(100u, cache.GetStats().size);
+  EXPECT_FALSE(cache.Lookup(key));
+  EXPECT_FALSE(cache.Lookup(Key(stream, nullptr, 0, 1)));
+  EXPECT_TRUE(cache.Lookup(other_key));
+}
+
+TEST(CPDFJpxTileCache, Limit) {
+  // The eviction itself is LruCache's, and tested with it.
+  CPDF_JpxTileCache cache;
+  EXPECT_EQ(CPDF_JpxTileCache::kDefaultLimit, cache.GetStats().limit);
+  const Key key(MakeStream(), nullptr, 0, 0);
+  cache.Store(key, MakeTile(10, 10));
+  EXPECT_TRUE(cache.Lookup(key));
+
+  cache.SetLimit(399);
+  EXPECT_EQ(0u, cache.GetStats().count);
+  cache.Store(key, MakeTile(10, 10));
+  EXPECT_FALSE(cache.Lookup(key));
+  EXPECT_EQ(1u, cache.GetStats().hits);
+  EXPECT_EQ(1u, cache.GetStats().misses);
+}
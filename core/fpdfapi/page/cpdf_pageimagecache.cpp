@@ -10,18 +10,23 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <iterator>
+#include <set>
 #include <utility>
 #include <vector>
 
 #include "core/fpdfapi/page/cpdf_dib.h"
+#include "core/fpdfapi/page/cpdf_docpagedata.h"
 #include "core/fpdfapi/page/cpdf_image.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/stl_util.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxge/dib/cfx_dibbase.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 
@@ -44,6 +49,14 @@ struct CacheInfo {
   bool operator<(const CacheInfo& other) const { return time < other.time; }
 };
 
+// At most two batches of prefetches realize at a time, the one being drawn and
+// the next, so this keeps them to 64 MiB together.
+constexpr size_t kMaxPrefetchBatchSize = 32 * 1024 * 1024;
+
+size_t GetBufferSize(const CFX_DIBBase* dib) {
+  return dib ? static_cast<size_t>(dib->GetPitch()) * dib->GetHeight() : 0;
+}
+
 #if defined(PDF_USE_SKIA)
 // Wrapper around a `CFX_DIBBase` that memoizes `RealizeSkImage()`. This is only
 // safe if the underlying `CFX_DIBBase` is not mutable.
@@ -110,6 +123,62 @@ RetainPtr<CFX_DIBBase> MakeCachedImage(RetainPtr<CFX_DIBBase> image,
   return realize_hint ? image->Realize() : image;
 }
 
+// Whether `image` decodes the same on every page of its document. Inline
+// images belong to one content stream, and color spaces given by a name
+// other than a device one come from the resources where the image is drawn.
+bool CanShareAcrossPages(const CPDF_Image* image) {
+  RetainPtr<const CPDF_Stream> stream = image->GetStream();
+  if (!stream || !stream->GetObjNum()) {
+    return false;
+  }
+
+  RetainPtr<const CPDF_Object> color_space =
+      stream->GetDict()->GetDirectObjectFor("ColorSpace");
+  return !color_space || !color_space->IsName() ||
+         CPDF_ColorSpace::GetStockCSForName(color_space->GetString());
+}
+
+// JBIG2 and JPEG 2000 images decode while loading, which stays on the
+// rendering thread, and the renderer may only need part of a JPEG 2000 image.
+bool DecodesWhileLoading(const CPDF_Image* image) {
+  std::optional<DecoderArray> decoders =
+      GetDecoderArray(image->GetStream()->GetDict());
+  if (!decoders.has_value() || decoders.value().empty()) {
+    return false;
+  }
+  const ByteString& decoder = decoders.value().back().first;
+  return decoder == "JBIG2Decode" || decoder == "JPXDecode";
+}
+
+// Whether getting scanlines from `dib` reads nothing but its own data. Up to
+// 8 bits per pixel, CPDF_DIB looks colors up in a palette it made while
+// loading. Otherwise it converts every pixel through its color space, if any,
+// and only DeviceGray and DeviceRGB do that without reading anything that
+// other images change: DeviceCMYK checks for the standard conversion, which
+// images that are drawn meanwhile switch on and off.
+bool ReadsOnlyOwnData(const CFX_DIBBase* dib) {
+  if (dib->GetBPP() <= 8) {
+    return true;
+  }
+  RetainPtr<CPDF_ColorSpace> color_space =
+      static_cast<const CPDF_DIB*>(dib)->GetColorSpace();
+  if (!color_space) {
+    return true;
+  }
+  switch (color_space->GetFamily()) {
+    case CPDF_ColorSpace::Family::kDeviceGray:
+    case CPDF_ColorSpace::Family::kDeviceRGB:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool RectContains(const FX_RECT& outer, const FX_RECT& inner) {
+  return outer.left <= inner.left && outer.top <= inner.top &&
+         outer.right >= inner.right && outer.bottom >= inner.bottom;
+}
+
 }  // namespace
 
 CPDF_PageImageCache::CPDF_PageImageCache(CPDF_Page* pPage) : page_(pPage) {}
@@ -167,6 +236,10 @@ void CPDF_PageImageCache::ClearImageCacheEntry(const CPDF_Stream* pStream) {
   image_cache_.erase(it);
 }
 
+CPDF_DocImageCache* CPDF_PageImageCache::GetDocImageCache() const {
+  return CPDF_DocPageData::FromDocument(page_->GetDocument())->GetImageCache();
+}
+
 bool CPDF_PageImageCache::StartGetCachedBitmap(
     RetainPtr<CPDF_Image> pImage,
     const CPDF_Dictionary* pFormResources,
@@ -174,13 +247,15 @@ bool CPDF_PageImageCache::StartGetCachedBitmap(
     bool bStdCS,
     CPDF_ColorSpace::Family eFamily,
     bool bLoadMask,
-    const CFX_Size& max_size_required) {
+    const CFX_Size& max_size_required,
+    const FX_RECT& region_required) {
   // A cross-document image may have come from the embedder.
   if (page_->GetDocument() != pImage->GetDocument()) {
     return false;
   }
 
   RetainPtr<const CPDF_Stream> pStream = pImage->GetStream();
+  FinishPrefetch(pStream.Get());
   const auto it = image_cache_.find(pStream);
   cur_find_cache_ = it != image_cache_.end();
   if (cur_find_cache_) {
@@ -190,7 +265,7 @@ bool CPDF_PageImageCache::StartGetCachedBitmap(
   }
   CPDF_DIB::LoadState ret = cur_image_cache_entry_->StartGetCachedBitmap(
       this, pFormResources, pPageResources, bStdCS, eFamily, bLoadMask,
-      max_size_required);
+      max_size_required, region_required);
   if (ret == CPDF_DIB::LoadState::kContinue) {
     return true;
   }
@@ -222,8 +297,131 @@ bool CPDF_PageImageCache::Continue(PauseIndicatorIface* pPause) {
   return false;
 }
 
+void CPDF_PageImageCache::PrefetchBitmaps(
+    ThreadPool* pool,
+    pdfium::span<const PrefetchRequest> requests,
+    const CPDF_Dictionary* pFormResources,
+    const CPDF_Dictionary* pPageResources,
+    bool bStdCS,
+    CPDF_ColorSpace::Family eFamily,
+    bool bLoadMask) {
+#if defined(PDF_USE_SKIA)
+  // Skia realizes images when it draws them, so there is nothing to prefetch.
+  if (CFX_DefaultRenderDevice::UseSkiaRenderer()) {
+    return;
+  }
+#endif
+  if (!pool || pool->max_concurrency() < 2) {
+    return;
+  }
+
+  prefetch_pool_ = pool;
+  std::vector<std::unique_ptr<PrefetchBatch>> batches;
+  std::set<const CPDF_Stream*> seen;
+  for (const PrefetchRequest& request : requests) {
+    const RetainPtr<CPDF_Image>& image = request.image;
+    RetainPtr<const CPDF_Stream> stream = image->GetStream();
+    if (page_->GetDocument() != image->GetDocument() || !stream ||
+        image_cache_.contains(stream) ||
+        pending_prefetches_.contains(stream.Get()) ||
+        DecodesWhileLoading(image.Get()) || !seen.insert(stream.Get()).second) {
+      continue;
+    }
+
+    // Loading parses the image dictionaries and touches shared objects, so
+    // it stays on this thread.
+    auto entry = std::make_unique<Entry>(image);
+    CPDF_DIB::LoadState ret = entry->StartLoad(
+        this, pFormResources, pPageResources, bStdCS, eFamily, bLoadMask,
+        request.max_size_required, FX_RECT());
+    if (ret == CPDF_DIB::LoadState::kContinue) {
+      continue;
+    }
+
+    Prefetch prefetch;
+    prefetch.entry = std::move(entry);
+    size_t size = 0;
+    if (ret == CPDF_DIB::LoadState::kSuccess) {
+      prefetch.loaded = prefetch.entry->TakeLoadedImage();
+      prefetch.on_worker = Entry::CanRealizeOnWorkerThread(prefetch.loaded);
+      size = GetBufferSize(prefetch.loaded.bitmap.Get()) +
+             GetBufferSize(prefetch.loaded.mask.Get());
+    }
+    if (batches.empty() ||
+        (!batches.back()->prefetches.empty() &&
+         batches.back()->size + size > kMaxPrefetchBatchSize)) {
+      batches.push_back(std::make_unique<PrefetchBatch>());
+    }
+    PrefetchBatch* batch = batches.back().get();
+    pending_prefetches_[stream.Get()] = {batch, batch->prefetches.size()};
+    batch->prefetches.push_back(std::move(prefetch));
+    batch->size += size;
+  }
+  if (batches.empty()) {
+    return;
+  }
+
+  // Later batches start as drawing reaches the ones before them.
+  StartPrefetchBatch(batches.front().get());
+  std::ranges::move(batches, std::back_inserter(prefetch_batches_));
+}
+
+void CPDF_PageImageCache::StartPrefetchBatch(PrefetchBatch* batch) {
+  if (batch->batch.has_value()) {
+    return;
+  }
+  batch->batch.emplace(
+      prefetch_pool_->Start(batch->prefetches.size(), [batch](size_t i) {
+        Prefetch& prefetch = batch->prefetches[i];
+        if (prefetch.on_worker) {
+          Entry::RealizeLoadedImage(&prefetch.loaded);
+        }
+      }));
+}
+
+void CPDF_PageImageCache::FinishPrefetch(const CPDF_Stream* pStream) {
+  const auto pending_it = pending_prefetches_.find(pStream);
+  if (pending_it == pending_prefetches_.end()) {
+    return;
+  }
+  auto [batch, index] = pending_it->second;
+  pending_prefetches_.erase(pending_it);
+
+  // Keep the next batch realizing while this one gets drawn, but no more, so
+  // that a page of large images does not hold all of them at once.
+  const auto batch_it = std::ranges::find(
+      prefetch_batches_, batch, &std::unique_ptr<PrefetchBatch>::get);
+  CHECK(batch_it != prefetch_batches_.end());
+  StartPrefetchBatch(batch);
+  if (std::next(batch_it) != prefetch_batches_.end()) {
+    StartPrefetchBatch(std::next(batch_it)->get());
+  }
+  batch->batch->Wait(index);
+
+  Prefetch& prefetch = batch->prefetches[index];
+  if (prefetch.loaded.bitmap) {
+    if (!prefetch.on_worker) {
+      Entry::RealizeLoadedImage(&prefetch.loaded);
+    }
+    prefetch.entry->StoreLoadedImage(std::move(prefetch.loaded), this);
+  }
+  time_count_++;
+  cache_size_ += prefetch.entry->EstimateSize();
+  CPDF_Image* image = prefetch.entry->GetImage();
+  image_cache_[image->GetStream()] = std::move(prefetch.entry);
+
+  if (++batch->finished_count == batch->prefetches.size()) {
+    prefetch_batches_.erase(batch_it);
+  }
+}
+
 void CPDF_PageImageCache::ResetBitmapForImage(RetainPtr<CPDF_Image> pImage) {
   RetainPtr<const CPDF_Stream> pStream = pImage->GetStream();
+  FinishPrefetch(pStream.Get());
+  GetDocImageCache()->Invalidate(pStream.Get());
+  CPDF_DocPageData::FromDocument(page_->GetDocument())
+      ->GetJpxTileCache()
+      ->Invalidate(pStream.Get());
   const auto it = image_cache_.find(pStream);
   if (it == image_cache_.end()) {
     return;
@@ -247,6 +445,40 @@ RetainPtr<CFX_DIBBase> CPDF_PageImageCache::DetachCurMask() {
   return cur_image_cache_entry_->DetachMask();
 }
 
+CPDF_PageImageCache::PrefetchBatch::PrefetchBatch() = default;
+
+CPDF_PageImageCache::PrefetchBatch::~PrefetchBatch() = default;
+
+CPDF_PageImageCache::Entry::LoadedImage::LoadedImage() = default;
+
+CPDF_PageImageCache::Entry::LoadedImage::LoadedImage(LoadedImage&&) = default;
+
+CPDF_PageImageCache::Entry::LoadedImage&
+CPDF_PageImageCache::Entry::LoadedImage::operator=(LoadedImage&&) = default;
+
+CPDF_PageImageCache::Entry::LoadedImage::~LoadedImage() = default;
+
+// static
+void CPDF_PageImageCache::Entry::RealizeLoadedImage(LoadedImage* loaded) {
+  // Partially decoded images only hold their visible tiles, and realizing
+  // them would make a bitmap the size of the whole image.
+  const bool realize_hint =
+      !loaded->partial &&
+      loaded->bitmap->GetPitch() * loaded->bitmap->GetHeight() <
+          kHugeImageSize;
+  loaded->image.bitmap = MakeCachedImage(loaded->bitmap, realize_hint);
+  if (loaded->mask) {
+    loaded->image.mask = MakeCachedImage(loaded->mask, /*realize_hint=*/true);
+  }
+}
+
+// static
+bool CPDF_PageImageCache::Entry::CanRealizeOnWorkerThread(
+    const LoadedImage& loaded) {
+  return ReadsOnlyOwnData(loaded.bitmap.Get()) &&
+         (!loaded.mask || ReadsOnlyOwnData(loaded.mask.Get()));
+}
+
 CPDF_PageImageCache::Entry::Entry(RetainPtr<CPDF_Image> pImage)
     : image_(std::move(pImage)) {}
 
@@ -272,29 +504,65 @@ CPDF_DIB::LoadState CPDF_PageImageCache::Entry::StartGetCachedBitmap(
     bool bStdCS,
     CPDF_ColorSpace::Family eFamily,
     bool bLoadMask,
-    const CFX_Size& max_size_required) {
-  if (cached_bitmap_ && IsCacheValid(max_size_required)) {
+    const CFX_Size& max_size_required,
+    const FX_RECT& region_required) {
+  if (cached_bitmap_ && IsCacheValid(max_size_required, region_required)) {
     cur_bitmap_ = cached_bitmap_;
     cur_mask_ = cached_mask_;
     return CPDF_DIB::LoadState::kSuccess;
   }
 
+  CPDF_DIB::LoadState ret = StartLoad(
+      pPageImageCache, pFormResources, pPageResources, bStdCS, eFamily,
+      bLoadMask, max_size_required, region_required);
+  if (ret == CPDF_DIB::LoadState::kSuccess) {
+    ContinueGetCachedBitmap(pPageImageCache);
+    return CPDF_DIB::LoadState::kFail;
+  }
+  return ret;
+}
+
+CPDF_DIB::LoadState CPDF_PageImageCache::Entry::StartLoad(
+    CPDF_PageImageCache* pPageImageCache,
+    const CPDF_Dictionary* pFormResources,
+    const CPDF_Dictionary* pPageResources,
+    bool bStdCS,
+    CPDF_ColorSpace::Family eFamily,
+    bool bLoadMask,
+    const CFX_Size& max_size_required,
+    const FX_RECT& region_required) {
+  cur_max_size_required_ = max_size_required;
+  doc_cache_options_.reset();
+  if (CanShareAcrossPages(image_.Get())) {
+    doc_cache_options_ = CPDF_DocImageCache::Options{
+        .std_cs = bStdCS, .family = eFamily, .load_mask = bLoadMask};
+    doc_cache_size_ = max_size_required;
+    std::optional<CPDF_DocImageCache::Image> shared =
+        pPageImageCache->GetDocImageCache()->Lookup(
+            image_->GetStream().Get(), doc_cache_options_.value(),
+            max_size_required);
+    if (shared.has_value()) {
+      cached_set_max_size_required_ =
+          (max_size_required.width != 0 && max_size_required.height != 0);
+      cur_region_ = FX_RECT();
+      SetCachedImage(shared.value(), pPageImageCache);
+      // Like a load that finished right away, so the caller accounts for the
+      // size of this entry.
+      return CPDF_DIB::LoadState::kFail;
+    }
+  }
+
   cur_bitmap_ = image_->CreateNewDIB();
   CPDF_DIB::LoadState ret = cur_bitmap_.AsRaw<CPDF_DIB>()->StartLoadDIBBase(
       true, pFormResources, pPageResources, bStdCS, eFamily, bLoadMask,
-      max_size_required);
+      max_size_required, region_required);
+  cur_region_ = region_required;
   cached_set_max_size_required_ =
       (max_size_required.width != 0 && max_size_required.height != 0);
-  if (ret == CPDF_DIB::LoadState::kContinue) {
-    return CPDF_DIB::LoadState::kContinue;
-  }
-
-  if (ret == CPDF_DIB::LoadState::kSuccess) {
-    ContinueGetCachedBitmap(pPageImageCache);
-  } else {
+  if (ret == CPDF_DIB::LoadState::kFail) {
     cur_bitmap_.Reset();
   }
-  return CPDF_DIB::LoadState::kFail;
+  return ret;
 }
 
 bool CPDF_PageImageCache::Entry::Continue(
@@ -316,19 +584,51 @@ bool CPDF_PageImageCache::Entry::Continue(
 
 void CPDF_PageImageCache::Entry::ContinueGetCachedBitmap(
     CPDF_PageImageCache* pPageImageCache) {
-  matte_color_ = cur_bitmap_.AsRaw<CPDF_DIB>()->GetMatteColor();
-  cur_mask_ = cur_bitmap_.AsRaw<CPDF_DIB>()->DetachMask();
-  time_count_ = pPageImageCache->GetTimeCount();
-  if (cur_bitmap_->GetPitch() * cur_bitmap_->GetHeight() < kHugeImageSize) {
-    cached_bitmap_ = MakeCachedImage(cur_bitmap_, /*realize_hint=*/true);
-    cur_bitmap_.Reset();
-  } else {
-    cached_bitmap_ = MakeCachedImage(cur_bitmap_, /*realize_hint=*/false);
-  }
-  if (cur_mask_) {
-    cached_mask_ = MakeCachedImage(cur_mask_, /*realize_hint=*/true);
-    cur_mask_.Reset();
+  LoadedImage loaded = TakeLoadedImage();
+  RealizeLoadedImage(&loaded);
+  StoreLoadedImage(std::move(loaded), pPageImageCache);
+}
+
+CPDF_PageImageCache::Entry::LoadedImage
+CPDF_PageImageCache::Entry::TakeLoadedImage() {
+  LoadedImage loaded;
+  loaded.partial = cur_bitmap_.AsRaw<CPDF_DIB>()->IsPartiallyDecoded();
+  loaded.image.matte_color = cur_bitmap_.AsRaw<CPDF_DIB>()->GetMatteColor();
+  loaded.mask = cur_bitmap_.AsRaw<CPDF_DIB>()->DetachMask();
+  loaded.bitmap = std::move(cur_bitmap_);
+  return loaded;
+}
+
+void CPDF_PageImageCache::Entry::StoreLoadedImage(
+    LoadedImage loaded,
+    CPDF_PageImageCache* pPageImageCache) {
+  if (!loaded.partial) {
+    cur_region_ = FX_RECT();
+  }
+  SetCachedImage(loaded.image, pPageImageCache);
+  // Other pages may show other parts of a partially decoded image.
+  if (doc_cache_options_.has_value() && !loaded.partial) {
+    // Images smaller than the size they are drawn at decode at full size,
+    // which serves any size.
+    const CFX_DIBBase* bitmap = loaded.image.bitmap.Get();
+    const bool full_size = bitmap &&
+                           bitmap->GetWidth() >= image_->GetPixelWidth() &&
+                           bitmap->GetHeight() >= image_->GetPixelHeight();
+    pPageImageCache->GetDocImageCache()->Store(
+        image_->GetStream(), doc_cache_options_.value(),
+        full_size ? CFX_Size() : doc_cache_size_, loaded.image);
   }
+}
+
+void CPDF_PageImageCache::Entry::SetCachedImage(
+    const CPDF_DocImageCache::Image& image,
+    CPDF_PageImageCache* pPageImageCache) {
+  matte_color_ = image.matte_color;
+  time_count_ = pPageImageCache->GetTimeCount();
+  cached_bitmap_ = image.bitmap;
+  cached_mask_ = image.mask;
+  cached_region_ = cur_region_;
+  cached_max_size_required_ = cur_max_size_required_;
   cur_bitmap_ = cached_bitmap_;
   cur_mask_ = cached_mask_;
   CalcSize();
@@ -345,13 +645,22 @@ void CPDF_PageImageCache::Entry::CalcSize() {
 }
 
 bool CPDF_PageImageCache::Entry::IsCacheValid(
-    const CFX_Size& max_size_required) const {
+    const CFX_Size& max_size_required,
+    const FX_RECT& region_required) const {
+  if (!cached_region_.IsEmpty() &&
+      (region_required.IsEmpty() ||
+       !RectContains(cached_region_, region_required))) {
+    return false;
+  }
   if (!cached_set_max_size_required_) {
     return true;
   }
   if (max_size_required.width == 0 && max_size_required.height == 0) {
     return false;
   }
+  if (max_size_required == cached_max_size_required_) {
+    return true;
+  }
 
   return (cached_bitmap_->GetWidth() >= max_size_required.width) &&
          (cached_bitmap_->GetHeight() >= max_size_required.height);
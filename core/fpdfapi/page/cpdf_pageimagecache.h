@@ -12,10 +12,16 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_dib.h"
+#include "core/fpdfapi/page/cpdf_docimagecache.h"
 #include "core/fxcrt/maybe_owned.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxcrt/unowned_ptr.h"
 
 class CPDF_Dictionary;
@@ -40,10 +46,32 @@ class CPDF_PageImageCache {
                             bool bStdCS,
                             CPDF_ColorSpace::Family eFamily,
                             bool bLoadMask,
-                            const CFX_Size& max_size_required);
+                            const CFX_Size& max_size_required,
+                            const FX_RECT& region_required);
 
   bool Continue(PauseIndicatorIface* pPause);
 
+  struct PrefetchRequest {
+    RetainPtr<CPDF_Image> image;
+    CFX_Size max_size_required;
+  };
+
+  // Loads those of the `requests` images that are not cached yet, and starts
+  // realizing their bitmaps on `pool` where that is safe, so that later
+  // StartGetCachedBitmap() calls with the same arguments find them. Those
+  // calls only wait for their own image, so drawing can start as soon as the
+  // first one is ready. Images that load progressively are left for
+  // StartGetCachedBitmap(), and so is everything without a `pool` of several
+  // threads. `pool` must outlive the prefetches, which last until their images
+  // are drawn or this cache goes away.
+  void PrefetchBitmaps(ThreadPool* pool,
+                       pdfium::span<const PrefetchRequest> requests,
+                       const CPDF_Dictionary* pFormResources,
+                       const CPDF_Dictionary* pPageResources,
+                       bool bStdCS,
+                       CPDF_ColorSpace::Family eFamily,
+                       bool bLoadMask);
+
   uint32_t GetCurMatteColor() const;
   RetainPtr<CFX_DIBBase> DetachCurBitmap();
   RetainPtr<CFX_DIBBase> DetachCurMask();
@@ -51,6 +79,27 @@ class CPDF_PageImageCache {
  private:
   class Entry {
    public:
+    // A loaded image on its way from TakeLoadedImage() to
+    // StoreLoadedImage(). `bitmap` and `mask` keep the loaded DIBs alive
+    // until then, so that RealizeLoadedImage() never releases them.
+    struct LoadedImage {
+      LoadedImage();
+      LoadedImage(LoadedImage&&);
+      LoadedImage& operator=(LoadedImage&&);
+      ~LoadedImage();
+
+      RetainPtr<CFX_DIBBase> bitmap;
+      RetainPtr<CFX_DIBBase> mask;
+      bool partial = false;
+      CPDF_DocImageCache::Image image;
+    };
+
+    // Fills in `loaded->image`. Only reads the loaded DIBs and creates new
+    // bitmaps, so it may run on a worker thread when
+    // CanRealizeOnWorkerThread() allows.
+    static void RealizeLoadedImage(LoadedImage* loaded);
+    static bool CanRealizeOnWorkerThread(const LoadedImage& loaded);
+
     explicit Entry(RetainPtr<CPDF_Image> pImage);
     ~Entry();
 
@@ -68,19 +117,39 @@ class CPDF_PageImageCache {
         bool bStdCS,
         CPDF_ColorSpace::Family eFamily,
         bool bLoadMask,
-        const CFX_Size& max_size_required);
+        const CFX_Size& max_size_required,
+        const FX_RECT& region_required);
+
+    // Like StartGetCachedBitmap() without a cache hit in this entry, but
+    // returns kSuccess when the image still needs TakeLoadedImage(),
+    // RealizeLoadedImage() and StoreLoadedImage().
+    CPDF_DIB::LoadState StartLoad(CPDF_PageImageCache* pPageImageCache,
+                                  const CPDF_Dictionary* pFormResources,
+                                  const CPDF_Dictionary* pPageResources,
+                                  bool bStdCS,
+                                  CPDF_ColorSpace::Family eFamily,
+                                  bool bLoadMask,
+                                  const CFX_Size& max_size_required,
+                                  const FX_RECT& region_required);
 
     // Returns whether to Continue() or not.
     bool Continue(PauseIndicatorIface* pPause,
                   CPDF_PageImageCache* pPageImageCache);
 
+    LoadedImage TakeLoadedImage();
+    void StoreLoadedImage(LoadedImage loaded,
+                          CPDF_PageImageCache* pPageImageCache);
+
     RetainPtr<CFX_DIBBase> DetachBitmap();
     RetainPtr<CFX_DIBBase> DetachMask();
 
    private:
     void ContinueGetCachedBitmap(CPDF_PageImageCache* pPageImageCache);
+    void SetCachedImage(const CPDF_DocImageCache::Image& image,
+                        CPDF_PageImageCache* pPageImageCache);
     void CalcSize();
-    bool IsCacheValid(const CFX_Size& max_size_required) const;
+    bool IsCacheValid(const CFX_Size& max_size_required,
+                      const FX_RECT& region_required) const;
 
     uint32_t time_count_ = 0;
     uint32_t matte_color_ = 0;
@@ -91,9 +160,44 @@ class CPDF_PageImageCache {
     RetainPtr<CFX_DIBBase> cached_bitmap_;
     RetainPtr<CFX_DIBBase> cached_mask_;
     bool cached_set_max_size_required_ = false;
+    // The size `cached_bitmap_` was decoded for, which a request for the
+    // same size can always reuse.
+    CFX_Size cached_max_size_required_;
+    CFX_Size cur_max_size_required_;
+    // Empty unless `cached_bitmap_` only has this part of the image decoded.
+    FX_RECT cached_region_;
+    FX_RECT cur_region_;
+    // Set while loading an image that the document's cache can share.
+    std::optional<CPDF_DocImageCache::Options> doc_cache_options_;
+    CFX_Size doc_cache_size_;
+  };
+
+  // An image that PrefetchBitmaps() loaded, which may still be realizing on
+  // another thread.
+  struct Prefetch {
+    std::unique_ptr<Entry> entry;
+    Entry::LoadedImage loaded;
+    bool on_worker = false;
+  };
+
+  // Prefetches that realize together.
+  struct PrefetchBatch {
+    PrefetchBatch();
+    ~PrefetchBatch();
+
+    std::vector<Prefetch> prefetches;
+    size_t size = 0;
+    size_t finished_count = 0;
+    // Set once started. Waits for the realizing when it goes, so comes after
+    // `prefetches`.
+    std::optional<ThreadPool::Batch> batch;
   };
 
+  void StartPrefetchBatch(PrefetchBatch* batch);
+  // If `pStream` has a prefetch, waits for it and moves it to `image_cache_`.
+  void FinishPrefetch(const CPDF_Stream* pStream);
   void ClearImageCacheEntry(const CPDF_Stream* pStream);
+  CPDF_DocImageCache* GetDocImageCache() const;
 
   UnownedPtr<CPDF_Page> const page_;
   std::map<RetainPtr<const CPDF_Stream>, std::unique_ptr<Entry>, std::less<>>
@@ -102,6 +206,11 @@ class CPDF_PageImageCache {
   uint32_t time_count_ = 0;
   uint32_t cache_size_ = 0;
   bool cur_find_cache_ = false;
+  UnownedPtr<ThreadPool> prefetch_pool_;
+  std::vector<std::unique_ptr<PrefetchBatch>> prefetch_batches_;
+  // The batch and index of every prefetch that is not in `image_cache_` yet.
+  std::map<const CPDF_Stream*, std::pair<PrefetchBatch*, size_t>>
+      pending_prefetches_;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_PAGEIMAGECACHE_H_
@@ -0,0 +1,179 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_docpagedata.h"
+#include "core/fpdfapi/page/cpdf_image.h"
+#include "core/fpdfapi/page/cpdf_imageobject.h"
+#include "core/fpdfapi/page/cpdf_page.h"
+#include "core/fpdfapi/page/cpdf_pageimagecache.h"
+#include "core/fpdfapi/page/cpdf_pagemodule.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fxcodec/flate/flatemodule.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/thread_pool.h"
+#include "core/fxge/dib/cfx_dibbase.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_test_helpers.h"
+
+namespace {
+
+constexpr int kImageCount = 8;
+constexpr int kImageSize = 1024;
+constexpr CFX_Size kMaxSize = {kImageSize, kImageSize};
+constexpr size_t kThreads = 4;
+constexpr int kRuns = 5;
+
+// Returns a one page file that draws `kImageCount` Flate encoded RGB images
+// of `kImageSize` squared pixels.
+std::string MakeFile() {
+  std::string file = "%PDF-1.7\n";
+  std::vector<size_t> offsets;
+  auto add_object = [&file, &offsets](const std::string& body) {
+    offsets.push_back(file.size());
+    file += std::to_string(offsets.size()) + " 0 obj\n" + body + "\nendobj\n";
+  };
+
+  std::string content;
+  std::string xobjects;
+  for (int i = 0; i < kImageCount; ++i) {
+    content += "q 72 0 0 72 " + std::to_string(i * 72) + " 0 cm /Im" +
+               std::to_string(i) + " Do Q\n";
+    xobjects += "/Im" + std::to_string(i) + " " + std::to_string(i + 5) +
+                " 0 R ";
+  }
+  add_object("<</Type /Catalog /Pages 2 0 R>>");
+  add_object("<</Type /Pages /Kids [3 0 R] /Count 1>>");
+  add_object(
+      "<</Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] /Contents 4 0 R "
+      "/Resources <</XObject <<" +
+      xobjects + ">>>>>>");
+  add_object("<</Length " + std::to_string(content.size()) + ">>\nstream\n" +
+             content + "\nendstream");
+
+  std::vector<uint8_t> pixels(kImageSize * kImageSize * 3);
+  for (int i = 0; i < kImageCount; ++i) {
+    for (size_t j = 0; j < pixels.size(); ++j) {
+      pixels[j] = static_cast<uint8_t>((j * (i + 1)) ^ (j >> 11));
+    }
+    DataVector<uint8_t> data = FlateModule::Encode(pixels);
+    add_object("<</Type /XObject /Subtype /Image /Width " +
+               std::to_string(kImageSize) + " /Height " +
+               std::to_string(kImageSize) +
+               " /ColorSpace /DeviceRGB /BitsPerComponent 8 "
+               "/Filter /FlateDecode /Length " +
+               std::to_string(data.size()) + ">>\nstream\n" +
+               std::string(data.begin(), data.end()) + "\nendstream");
+  }
+
+  const size_t xref_offset = file.size();
+  file += "xref\n0 " + std::to_string(offsets.size() + 1) + "\n";
+  file += "0000000000 65535 f\r\n";
+  for (size_t offset : offsets) {
+    char entry[21];
+    snprintf(entry, sizeof(entry), "%010zu 00000 n\r\n", offset);
+    file += entry;
+  }
+  file += "trailer\n<</Size " + std::to_string(offsets.size() + 1) +
+          " /Root 1 0 R>>\nstartxref\n" + std::to_string(xref_offset) +
+          "\n%%EOF\n";
+  return file;
+}
+
+// Loads `file` anew, so that no cache holds its images yet, and decodes all
+// of its images, prefetching them on `pool` first if there is one. Adds how
+// long the first image took to be ready to `first_image_times`.
+void DecodeImages(const std::string& file,
+                  ThreadPool* pool,
+                  std::vector<std::chrono::microseconds>* first_image_times) {
+  auto document =
+      std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
+                                      std::make_unique<CPDF_DocPageData>());
+  ASSERT_EQ(CPDF_Parser::SUCCESS,
+            document->LoadDoc(pdfium::MakeRetain<CFX_ReadOnlySpanStream>(
+                                  pdfium::as_bytes(pdfium::span(file))),
+                              nullptr));
+  auto page = pdfium::MakeRetain<CPDF_Page>(
+      document.get(), document->GetMutablePageDictionary(0));
+  page->AddPageImageCache();
+  page->ParseContent();
+
+  std::vector<RetainPtr<CPDF_Image>> images;
+  for (size_t i = 0; i < page->GetPageObjectCount(); ++i) {
+    images.push_back(page->GetPageObjectByIndex(i)->AsImage()->GetImage());
+  }
+  ASSERT_EQ(static_cast<size_t>(kImageCount), images.size());
+
+  CPDF_PageImageCache* cache = page->GetPageImageCache();
+  const auto start = std::chrono::steady_clock::now();
+  if (pool) {
+    std::vector<CPDF_PageImageCache::PrefetchRequest> requests;
+    for (const RetainPtr<CPDF_Image>& image : images) {
+      requests.push_back({image, kMaxSize});
+    }
+    cache->PrefetchBitmaps(pool, requests, nullptr,
+                           page->GetMutablePageResources(), false,
+                           CPDF_ColorSpace::Family::kUnknown, false);
+  }
+  for (size_t i = 0; i < images.size(); ++i) {
+    bool should_continue = cache->StartGetCachedBitmap(
+        std::move(images[i]), nullptr, page->GetMutablePageResources(), false,
+        CPDF_ColorSpace::Family::kUnknown, false, kMaxSize, FX_RECT());
+    while (should_continue) {
+      should_continue = cache->Continue(nullptr);
+    }
+    ASSERT_TRUE(cache->DetachCurBitmap());
+    if (i == 0) {
+      first_image_times->push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start));
+    }
+  }
+  page->ClearView();
+}
+
+std::chrono::microseconds Median(std::vector<std::chrono::microseconds> times) {
+  std::ranges::sort(times);
+  return times[times.size() / 2];
+}
+
+}  // namespace
+
+TEST(PageImageCachePerfTest, PrefetchBitmaps) {
+  pdfium::InitializePageModule();
+  const std::string file = MakeFile();
+  ThreadPool pool({.max_threads = kThreads});
+
+  std::vector<std::chrono::microseconds> serial_first_times;
+  PrintPerfResult("page_image_cache_decode_8_images", "one_at_a_time",
+                  MedianRunTime(kRuns, [&file, &serial_first_times] {
+                    DecodeImages(file, nullptr, &serial_first_times);
+                  }));
+  std::vector<std::chrono::microseconds> prefetch_first_times;
+  PrintPerfResult("page_image_cache_decode_8_images", "prefetched_4_threads",
+                  MedianRunTime(kRuns, [&file, &pool, &prefetch_first_times] {
+                    DecodeImages(file, &pool, &prefetch_first_times);
+                  }));
+
+  // Drawing can start once the first image is ready.
+  PrintPerfResult("page_image_cache_first_of_8_images", "one_at_a_time",
+                  Median(serial_first_times));
+  PrintPerfResult("page_image_cache_first_of_8_images", "prefetched_4_threads",
+                  Median(prefetch_first_times));
+  pdfium::DestroyPageModule();
+}
@@ -4,9 +4,11 @@
 
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_docpagedata.h"
 #include "core/fpdfapi/page/cpdf_image.h"
@@ -16,11 +18,76 @@
 #include "core/fpdfapi/parser/cpdf_parser.h"
 #include "core/fpdfapi/render/cpdf_docrenderdata.h"
 #include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/thread_pool.h"
+#include "core/fxge/dib/cfx_dibbase.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/utils/path_service.h"
 
 namespace pdfium {
 
+namespace {
+
+std::unique_ptr<CPDF_Document> LoadDocument(const char* name) {
+  std::string file_path = PathService::GetTestFilePath(name);
+  if (file_path.empty()) {
+    return nullptr;
+  }
+  auto document =
+      std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
+                                      std::make_unique<CPDF_DocPageData>());
+  if (document->LoadDoc(
+          IFX_SeekableReadStream::CreateFromFilename(file_path.c_str()),
+          nullptr) != CPDF_Parser::SUCCESS) {
+    return nullptr;
+  }
+  return document;
+}
+
+RetainPtr<CPDF_Page> LoadPage(CPDF_Document* document) {
+  auto page = pdfium::MakeRetain<CPDF_Page>(
+      document, document->GetMutablePageDictionary(0));
+  page->AddPageImageCache();
+  page->ParseContent();
+  return page;
+}
+
+std::vector<RetainPtr<CPDF_Image>> GetImages(CPDF_Page* page) {
+  std::vector<RetainPtr<CPDF_Image>> images;
+  for (size_t i = 0; i < page->GetPageObjectCount(); ++i) {
+    CPDF_ImageObject* image = page->GetPageObjectByIndex(i)->AsImage();
+    if (image) {
+      images.push_back(image->GetImage());
+    }
+  }
+  return images;
+}
+
+RetainPtr<CFX_DIBBase> GetCachedBitmap(CPDF_Page* page,
+                                       RetainPtr<CPDF_Image> image) {
+  CPDF_PageImageCache* page_image_cache = page->GetPageImageCache();
+  bool should_continue = page_image_cache->StartGetCachedBitmap(
+      std::move(image), nullptr, page->GetMutablePageResources(), false,
+      CPDF_ColorSpace::Family::kUnknown, false, {300, 300}, FX_RECT());
+  while (should_continue) {
+    should_continue = page_image_cache->Continue(nullptr);
+  }
+  return page_image_cache->DetachCurBitmap();
+}
+
+struct PostedTask {
+  void (*task)(void*);
+  void* task_data;
+};
+
+void RecordTask(void* executor_context,
+                void (*task)(void* task_data),
+                void* task_data) {
+  static_cast<std::vector<PostedTask>*>(executor_context)
+      ->push_back({task, task_data});
+}
+
+}  // namespace
+
 TEST(CPDFPageImageCache, RenderBug1924) {
   // If you render a page with a JPEG2000 image as a thumbnail (small picture)
   // first, the image that gets cached has a low resolution. If you afterwards
@@ -58,7 +125,7 @@ TEST(CPDFPageImageCache, RenderBug1924) {
     // Render with small scale.
     bool should_continue = page_image_cache->StartGetCachedBitmap(
         image->GetImage(), nullptr, page->GetMutablePageResources(), true,
-        CPDF_ColorSpace::Family::kICCBased, false, {50, 50});
+        CPDF_ColorSpace::Family::kICCBased, false, {50, 50}, FX_RECT());
     while (should_continue) {
       should_continue = page_image_cache->Continue(nullptr);
     }
@@ -68,7 +135,7 @@ TEST(CPDFPageImageCache, RenderBug1924) {
     // And render with large scale.
     should_continue = page_image_cache->StartGetCachedBitmap(
         image->GetImage(), nullptr, page->GetMutablePageResources(), true,
-        CPDF_ColorSpace::Family::kICCBased, false, {100, 100});
+        CPDF_ColorSpace::Family::kICCBased, false, {100, 100}, FX_RECT());
     while (should_continue) {
       should_continue = page_image_cache->Continue(nullptr);
     }
@@ -84,4 +151,107 @@ TEST(CPDFPageImageCache, RenderBug1924) {
   DestroyPageModule();
 }
 
+TEST(CPDFPageImageCache, PrefetchBitmaps) {
+  // Prefetching needs more than one thread, even on single core machines.
+  ThreadPool pool({.max_threads = 4});
+  InitializePageModule();
+  {
+    // Load the same file twice, so that the document image caches do not
+    // share anything between the two.
+    std::unique_ptr<CPDF_Document> serial_document =
+        LoadDocument("embedded_images.pdf");
+    ASSERT_TRUE(serial_document);
+    std::unique_ptr<CPDF_Document> prefetch_document =
+        LoadDocument("embedded_images.pdf");
+    ASSERT_TRUE(prefetch_document);
+
+    RetainPtr<CPDF_Page> serial_page = LoadPage(serial_document.get());
+    RetainPtr<CPDF_Page> prefetch_page = LoadPage(prefetch_document.get());
+    std::vector<RetainPtr<CPDF_Image>> serial_images =
+        GetImages(serial_page.Get());
+    std::vector<RetainPtr<CPDF_Image>> prefetch_images =
+        GetImages(prefetch_page.Get());
+    ASSERT_EQ(serial_images.size(), prefetch_images.size());
+    ASSERT_GE(prefetch_images.size(), 2u);
+
+    std::vector<CPDF_PageImageCache::PrefetchRequest> requests;
+    for (const RetainPtr<CPDF_Image>& image : prefetch_images) {
+      requests.push_back({image, {300, 300}});
+    }
+    prefetch_page->GetPageImageCache()->PrefetchBitmaps(
+        &pool, requests, nullptr, prefetch_page->GetMutablePageResources(),
+        false, CPDF_ColorSpace::Family::kUnknown, false);
+
+    for (size_t i = 0; i < prefetch_images.size(); ++i) {
+      RetainPtr<CFX_DIBBase> expected =
+          GetCachedBitmap(serial_page.Get(), serial_images[i]);
+      RetainPtr<CFX_DIBBase> actual =
+          GetCachedBitmap(prefetch_page.Get(), prefetch_images[i]);
+      ASSERT_TRUE(expected);
+      ASSERT_TRUE(actual);
+      ASSERT_EQ(expected->GetFormat(), actual->GetFormat());
+      ASSERT_EQ(expected->GetWidth(), actual->GetWidth());
+      ASSERT_EQ(expected->GetHeight(), actual->GetHeight());
+      for (int row = 0; row < expected->GetHeight(); ++row) {
+        pdfium::span<const uint8_t> expected_row =
+            expected->GetScanline(row);
+        pdfium::span<const uint8_t> actual_row = actual->GetScanline(row);
+        EXPECT_TRUE(std::ranges::equal(expected_row, actual_row))
+            << "image " << i << ", row " << row;
+      }
+
+      // The renderer asks again with the same arguments, and gets the same
+      // bitmap without decoding it again.
+      EXPECT_EQ(actual,
+                GetCachedBitmap(prefetch_page.Get(), prefetch_images[i]));
+    }
+
+    serial_page->AsPDFPage()->ClearView();
+    prefetch_page->AsPDFPage()->ClearView();
+  }
+  DestroyPageModule();
+}
+
+TEST(CPDFPageImageCache, PrefetchBitmapsWaitsForOneImage) {
+  // An executor that runs no tasks until told to, so that prefetched images
+  // are still waiting for other threads when they get drawn.
+  std::vector<PostedTask> tasks;
+  ThreadPool pool({.max_threads = 4,
+                   .post_task = RecordTask,
+                   .executor_context = &tasks});
+  InitializePageModule();
+  {
+    std::unique_ptr<CPDF_Document> document =
+        LoadDocument("embedded_images.pdf");
+    ASSERT_TRUE(document);
+    RetainPtr<CPDF_Page> page = LoadPage(document.get());
+    std::vector<RetainPtr<CPDF_Image>> images = GetImages(page.Get());
+    ASSERT_GE(images.size(), 2u);
+
+    std::vector<CPDF_PageImageCache::PrefetchRequest> requests;
+    for (const RetainPtr<CPDF_Image>& image : images) {
+      requests.push_back({image, {300, 300}});
+    }
+    page->GetPageImageCache()->PrefetchBitmaps(
+        &pool, requests, nullptr, page->GetMutablePageResources(), false,
+        CPDF_ColorSpace::Family::kUnknown, false);
+    EXPECT_FALSE(tasks.empty());
+
+    // The first image does not wait for the others, nor for the tasks, which
+    // leave it to this thread.
+    EXPECT_TRUE(GetCachedBitmap(page.Get(), images[0]));
+
+    // Tasks that run late realize the rest in the background.
+    for (const PostedTask& task : tasks) {
+      task.task(task.task_data);
+    }
+    for (size_t i = 1; i < images.size(); ++i) {
+      EXPECT_TRUE(GetCachedBitmap(page.Get(), images[i])) << "image " << i;
+    }
+
+    page->AsPDFPage()->ClearView();
+  }
+  DestroyPageModule();
+}
+
 }  // namespace pdfium
@@ -25,4 +25,15 @@ void DestroyPageModule() {
   CPDF_ColorSpace::DestroyGlobals();
 }
 
+void InitializePageModuleForCurrentThread() {
+  CPDF_ColorSpace::InitializeGlobalsForCurrentThread();
+  CPDF_FontGlobals::CreateForCurrentThread();
+  CPDF_FontGlobals::GetInstance()->LoadEmbeddedMaps();
+}
+
+void DestroyPageModuleForCurrentThread() {
+  CPDF_FontGlobals::DestroyForCurrentThread();
+  CPDF_ColorSpace::DestroyGlobalsForCurrentThread();
+}
+
 }  // namespace pdfium
@@ -15,6 +15,14 @@ void InitializePageModule();
 // Tears down the page module.
 void DestroyPageModule();
 
+// Gives the calling thread its own copy of the page module's mutable state
+// (font globals and stock colorspaces). Read-only tables such as the
+// embedded cmaps and the content operator map remain shared.
+void InitializePageModuleForCurrentThread();
+
+// Tears down the calling thread's page module state.
+void DestroyPageModuleForCurrentThread();
+
 }  // namespace pdfium
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_PAGEMODULE_H_
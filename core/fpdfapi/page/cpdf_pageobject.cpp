@@ -8,6 +8,7 @@
 
 #include <utility>
 
+#include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fxcrt/fx_coordinates.h"
 
 CPDF_PageObject::CPDF_PageObject(int32_t content_stream)
@@ -15,6 +16,13 @@ CPDF_PageObject::CPDF_PageObject(int32_t content_stream)
 
 CPDF_PageObject::~CPDF_PageObject() = default;
 
+void CPDF_PageObject::SetRect(const CFX_FloatRect& rect) {
+  rect_ = rect;
+  if (holder_) {
+    holder_->OnPageObjectRectChanged();
+  }
+}
+
 bool CPDF_PageObject::IsText() const {
   return false;
 }
@@ -14,9 +14,11 @@
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/span.h"
+#include "core/fxcrt/unowned_ptr.h"
 
 class CPDF_FormObject;
 class CPDF_ImageObject;
+class CPDF_PageObjectHolder;
 class CPDF_PathObject;
 class CPDF_ShadingObject;
 class CPDF_TextObject;
@@ -69,7 +71,7 @@ class CPDF_PageObject {
 
   void SetOriginalRect(const CFX_FloatRect& rect) { original_rect_ = rect; }
   const CFX_FloatRect& GetOriginalRect() const { return original_rect_; }
-  void SetRect(const CFX_FloatRect& rect) { rect_ = rect; }
+  void SetRect(const CFX_FloatRect& rect);
   const CFX_FloatRect& GetRect() const { return rect_; }
   FX_RECT GetBBox() const;
   FX_RECT GetTransformedBBox(const CFX_Matrix& matrix) const;
@@ -138,12 +140,17 @@ class CPDF_PageObject {
 
   const CFX_Matrix& original_matrix() const { return original_matrix_; }
 
+  // The holder whose object list contains this object, if any. It gets told
+  // about bounding box changes.
+  void SetHolder(CPDF_PageObjectHolder* holder) { holder_ = holder; }
+
  protected:
   void CopyData(const CPDF_PageObject* pSrcObject);
   void InitializeOriginalMatrix(const CFX_Matrix& matrix);
 
  private:
   CPDF_GraphicStates graphic_states_;
+  UnownedPtr<CPDF_PageObjectHolder> holder_;
   CFX_FloatRect rect_;
   CFX_FloatRect original_rect_;
   // Only used with `CPDF_ImageObject` for now.
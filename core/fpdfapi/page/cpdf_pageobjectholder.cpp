@@ -13,6 +13,7 @@
 #include "core/fpdfapi/page/cpdf_allstates.h"
 #include "core/fpdfapi/page/cpdf_contentparser.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/page/cpdf_pageobjectspatialindex.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fxcrt/check.h"
@@ -21,6 +22,14 @@
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/stl_util.h"
 
+namespace {
+
+// Below this, scanning the object list is about as fast as querying a
+// spatial index, and building one is not worth it.
+constexpr size_t kMinObjectCountForSpatialIndex = 256;
+
+}  // namespace
+
 bool GraphicsData::operator<(const GraphicsData& other) const {
   if (!FXSYS_SafeEQ(fillAlpha, other.fillAlpha)) {
     return FXSYS_SafeLT(fillAlpha, other.fillAlpha);
@@ -186,7 +195,9 @@ CPDF_PageObject* CPDF_PageObjectHolder::GetPageObjectByIndex(
 void CPDF_PageObjectHolder::AppendPageObject(
     std::unique_ptr<CPDF_PageObject> pPageObj) {
   CHECK(pPageObj);
+  pPageObj->SetHolder(this);
   page_object_list_.push_back(std::move(pPageObj));
+  spatial_index_.reset();
 }
 
 bool CPDF_PageObjectHolder::InsertPageObjectAtIndex(
@@ -197,10 +208,12 @@ bool CPDF_PageObjectHolder::InsertPageObjectAtIndex(
     return false;
   }
 
+  page_obj->SetHolder(this);
   // Unsafe, but the compiler will not complain, because
   // std::deque::iterator::operator++() has not been marked as unsafe yet.
   page_object_list_.insert(UNSAFE_TODO(page_object_list_.begin() + index),
                            std::move(page_obj));
+  spatial_index_.reset();
   return true;
 }
 
@@ -214,6 +227,8 @@ std::unique_ptr<CPDF_PageObject> CPDF_PageObjectHolder::RemovePageObject(
 
   std::unique_ptr<CPDF_PageObject> result = std::move(*it);
   page_object_list_.erase(it);
+  result->SetHolder(nullptr);
+  spatial_index_.reset();
 
   int32_t content_stream = pPageObj->GetContentStream();
   if (content_stream >= 0) {
@@ -231,5 +246,32 @@ bool CPDF_PageObjectHolder::ErasePageObjectAtIndex(size_t index) {
   // Unsafe, but the compiler will not complain, because
   // std::deque::iterator::operator++() has not been marked as unsafe yet.
   page_object_list_.erase(UNSAFE_TODO(page_object_list_.begin() + index));
+  spatial_index_.reset();
   return true;
 }
+
+void CPDF_PageObjectHolder::OnPageObjectRectChanged() {
+  spatial_index_.reset();
+}
+
+bool CPDF_PageObjectHolder::ShouldUseSpatialIndex(
+    const CFX_FloatRect& rect) const {
+  // While parsing, objects keep arriving and any index would be rebuilt over
+  // and over. When `rect` covers the whole holder, nothing can be culled.
+  return parse_state_ == ParseState::kParsed &&
+         page_object_list_.size() >= kMinObjectCountForSpatialIndex &&
+         !rect.Contains(bbox_);
+}
+
+std::vector<size_t> CPDF_PageObjectHolder::GetPageObjectIndicesInRect(
+    const CFX_FloatRect& rect) const {
+  if (!spatial_index_) {
+    std::vector<CFX_FloatRect> rects;
+    rects.reserve(page_object_list_.size());
+    for (const auto& page_object : page_object_list_) {
+      rects.push_back(page_object->GetRect());
+    }
+    spatial_index_ = std::make_unique<CPDF_PageObjectSpatialIndex>(rects);
+  }
+  return spatial_index_->Query(rect);
+}
@@ -30,6 +30,7 @@
 class CPDF_ContentParser;
 class CPDF_Document;
 class CPDF_PageObject;
+class CPDF_PageObjectSpatialIndex;
 class PauseIndicatorIface;
 
 // These structs are used to keep track of resources that have already been
@@ -108,6 +109,20 @@ class CPDF_PageObjectHolder {
   std::unique_ptr<CPDF_PageObject> RemovePageObject(CPDF_PageObject* pPageObj);
   bool ErasePageObjectAtIndex(size_t index);
 
+  // Returns whether finding the objects that intersect `rect` is cheaper
+  // through GetPageObjectIndicesInRect() than by visiting every object.
+  bool ShouldUseSpatialIndex(const CFX_FloatRect& rect) const;
+
+  // Returns the indices, in ascending (paint) order, of the page objects whose
+  // bounding boxes intersect `rect`. Backed by a spatial index that is built on
+  // first use and discarded whenever objects are added, removed, or change
+  // their bounding boxes.
+  std::vector<size_t> GetPageObjectIndicesInRect(
+      const CFX_FloatRect& rect) const;
+
+  // Called by member objects whenever their bounding boxes change.
+  void OnPageObjectRectChanged();
+
   iterator begin() { return page_object_list_.begin(); }
   const_iterator begin() const { return page_object_list_.begin(); }
 
@@ -164,6 +179,7 @@ class CPDF_PageObjectHolder {
   std::vector<CFX_FloatRect> mask_bounding_boxes_;
   std::unique_ptr<CPDF_ContentParser> parser_;
   std::deque<std::unique_ptr<CPDF_PageObject>> page_object_list_;
+  mutable std::unique_ptr<CPDF_PageObjectSpatialIndex> spatial_index_;
 
   CTMMap all_ctms_;
 
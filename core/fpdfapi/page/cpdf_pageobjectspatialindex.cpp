@@ -0,0 +1,144 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_pageobjectspatialindex.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "core/fxcrt/numerics/safe_conversions.h"
+
+namespace {
+
+constexpr size_t kNodeCapacity = 16;
+
+bool HasNaN(const CFX_FloatRect& rect) {
+  return isnan(rect.left) || isnan(rect.right) || isnan(rect.bottom) ||
+         isnan(rect.top);
+}
+
+// Unlike CFX_FloatRect::Union(), keeps inverted rects as they are, so that
+// the bounds accept every query that one of the children accepts.
+CFX_FloatRect CoverRect(const CFX_FloatRect& a, const CFX_FloatRect& b) {
+  return CFX_FloatRect(std::min(a.left, b.left), std::min(a.bottom, b.bottom),
+                       std::max(a.right, b.right), std::max(a.top, b.top));
+}
+
+float CenterX(const CFX_FloatRect& rect) {
+  return (rect.left + rect.right) / 2;
+}
+
+float CenterY(const CFX_FloatRect& rect) {
+  return (rect.bottom + rect.top) / 2;
+}
+
+// Orders `items` so that runs of `kNodeCapacity` consecutive items are
+// spatially compact: sort by x into vertical slices, then each slice by y.
+template <typename T, typename GetRect>
+void SortTileRecursive(std::vector<T>& items, GetRect get_rect) {
+  const size_t node_count = (items.size() + kNodeCapacity - 1) / kNodeCapacity;
+  const size_t slice_count =
+      static_cast<size_t>(ceil(sqrt(static_cast<double>(node_count))));
+  const size_t slice_size = slice_count * kNodeCapacity;
+  std::sort(items.begin(), items.end(), [&get_rect](const T& a, const T& b) {
+    return CenterX(get_rect(a)) < CenterX(get_rect(b));
+  });
+  for (size_t start = 0; start < items.size(); start += slice_size) {
+    auto slice_begin = items.begin() + start;
+    auto slice_end = items.begin() + std::min(start + slice_size, items.size());
+    std::sort(slice_begin, slice_end, [&get_rect](const T& a, const T& b) {
+      return CenterY(get_rect(a)) < CenterY(get_rect(b));
+    });
+  }
+}
+
+}  // namespace
+
+CPDF_PageObjectSpatialIndex::CPDF_PageObjectSpatialIndex(
+    const std::vector<CFX_FloatRect>& rects) {
+  for (size_t i = 0; i < rects.size(); ++i) {
+    if (HasNaN(rects[i])) {
+      unindexed_.push_back({rects[i], i});
+    } else {
+      entries_.push_back({rects[i], i});
+    }
+  }
+  if (entries_.empty()) {
+    return;
+  }
+
+  auto entry_rect = [](const Entry& entry) { return entry.rect; };
+  auto node_rect = [](const Node& node) { return node.bounds; };
+  auto make_parents = [](const auto& children, auto get_rect) {
+    std::vector<Node> parents;
+    for (size_t first = 0; first < children.size(); first += kNodeCapacity) {
+      const size_t last = std::min(first + kNodeCapacity, children.size());
+      Node parent;
+      parent.bounds = get_rect(children[first]);
+      for (size_t i = first + 1; i < last; ++i) {
+        parent.bounds = CoverRect(parent.bounds, get_rect(children[i]));
+      }
+      parent.first = pdfium::checked_cast<uint32_t>(first);
+      parent.count = pdfium::checked_cast<uint32_t>(last - first);
+      parents.push_back(parent);
+    }
+    return parents;
+  };
+
+  SortTileRecursive(entries_, entry_rect);
+  levels_.push_back(make_parents(entries_, entry_rect));
+  while (levels_.back().size() > 1) {
+    SortTileRecursive(levels_.back(), node_rect);
+    std::vector<Node> parents = make_parents(levels_.back(), node_rect);
+    levels_.push_back(std::move(parents));
+  }
+}
+
+CPDF_PageObjectSpatialIndex::~CPDF_PageObjectSpatialIndex() = default;
+
+// static
+bool CPDF_PageObjectSpatialIndex::Intersects(const CFX_FloatRect& a,
+                                             const CFX_FloatRect& b) {
+  return !(a.left > b.right || a.right < b.left || a.bottom > b.top ||
+           a.top < b.bottom);
+}
+
+std::vector<size_t> CPDF_PageObjectSpatialIndex::Query(
+    const CFX_FloatRect& rect) const {
+  std::vector<size_t> result;
+  for (const Entry& entry : unindexed_) {
+    if (Intersects(entry.rect, rect)) {
+      result.push_back(entry.position);
+    }
+  }
+  if (!levels_.empty()) {
+    QueryNode(levels_.size() - 1, levels_.back().front(), rect, &result);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+void CPDF_PageObjectSpatialIndex::QueryNode(size_t level,
+                                            const Node& node,
+                                            const CFX_FloatRect& rect,
+                                            std::vector<size_t>* result) const {
+  if (!Intersects(node.bounds, rect)) {
+    return;
+  }
+  const size_t end = node.first + node.count;
+  if (level == 0) {
+    for (size_t i = node.first; i < end; ++i) {
+      if (Intersects(entries_[i].rect, rect)) {
+        result->push_back(entries_[i].position);
+      }
+    }
+    return;
+  }
+  const std::vector<Node>& children = levels_[level - 1];
+  for (size_t i = node.first; i < end; ++i) {
+    QueryNode(level - 1, children[i], rect, result);
+  }
+}
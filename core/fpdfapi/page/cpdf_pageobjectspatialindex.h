@@ -0,0 +1,61 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTSPATIALINDEX_H_
+#define CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTSPATIALINDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+
+// Immutable R-tree over the bounding boxes of a list of page objects, bulk
+// loaded with the Sort-Tile-Recursive algorithm. Entries are identified by
+// their position in the list the index was built from.
+class CPDF_PageObjectSpatialIndex {
+ public:
+  // `rects[i]` is the bounding box of the object at position `i`.
+  explicit CPDF_PageObjectSpatialIndex(
+      const std::vector<CFX_FloatRect>& rects);
+  ~CPDF_PageObjectSpatialIndex();
+
+  // Same test the renderer applies when culling, with inclusive edges.
+  static bool Intersects(const CFX_FloatRect& a, const CFX_FloatRect& b);
+
+  // Returns the positions of all entries intersecting `rect`, in ascending
+  // order.
+  std::vector<size_t> Query(const CFX_FloatRect& rect) const;
+
+  size_t size() const { return entries_.size() + unindexed_.size(); }
+
+ private:
+  struct Entry {
+    CFX_FloatRect rect;
+    size_t position;
+  };
+
+  // Covers `count` consecutive items, starting at `first`, of the level below,
+  // or of `entries_` for the leaf level.
+  struct Node {
+    CFX_FloatRect bounds;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  void QueryNode(size_t level,
+                 const Node& node,
+                 const CFX_FloatRect& rect,
+                 std::vector<size_t>* result) const;
+
+  std::vector<Entry> entries_;
+  // Entries with NaN coordinates, which cannot be ordered and are tested
+  // individually on every query.
+  std::vector<Entry> unindexed_;
+  // `levels_[0]` holds the leaves, `levels_.back()` the single root.
+  std::vector<std::vector<Node>> levels_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_PAGEOBJECTSPATIALINDEX_H_
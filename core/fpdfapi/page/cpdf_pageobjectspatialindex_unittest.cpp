@@ -0,0 +1,95 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_pageobjectspatialindex.h"
+
+#include <limits>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+std::vector<size_t> BruteForceQuery(const std::vector<CFX_FloatRect>& rects,
+                                    const CFX_FloatRect& rect) {
+  std::vector<size_t> result;
+  for (size_t i = 0; i < rects.size(); ++i) {
+    if (CPDF_PageObjectSpatialIndex::Intersects(rects[i], rect)) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+// Deterministic pseudo-random rects scattered over a 1000x1000 area.
+std::vector<CFX_FloatRect> MakeRects(size_t count) {
+  std::vector<CFX_FloatRect> rects;
+  uint32_t state = 12345;
+  auto next = [&state]() {
+    state = state * 1103515245 + 12345;
+    return static_cast<float>((state >> 16) % 1000);
+  };
+  for (size_t i = 0; i < count; ++i) {
+    float left = next();
+    float bottom = next();
+    float width = next() / 20;
+    float height = next() / 20;
+    rects.emplace_back(left, bottom, left + width, bottom + height);
+  }
+  return rects;
+}
+
+}  // namespace
+
+TEST(CPDFPageObjectSpatialIndexTest, Empty) {
+  CPDF_PageObjectSpatialIndex index({});
+  EXPECT_EQ(0u, index.size());
+  EXPECT_TRUE(index.Query(CFX_FloatRect(0, 0, 100, 100)).empty());
+}
+
+TEST(CPDFPageObjectSpatialIndexTest, EdgesAreInclusive) {
+  CPDF_PageObjectSpatialIndex index({CFX_FloatRect(10, 10, 20, 20)});
+  EXPECT_EQ(std::vector<size_t>{0}, index.Query(CFX_FloatRect(20, 20, 30, 30)));
+  EXPECT_EQ(std::vector<size_t>{0}, index.Query(CFX_FloatRect(0, 0, 10, 10)));
+  EXPECT_TRUE(index.Query(CFX_FloatRect(21, 21, 30, 30)).empty());
+}
+
+TEST(CPDFPageObjectSpatialIndexTest, MatchesBruteForce) {
+  const std::vector<CFX_FloatRect> rects = MakeRects(5000);
+  CPDF_PageObjectSpatialIndex index(rects);
+  EXPECT_EQ(rects.size(), index.size());
+
+  const CFX_FloatRect queries[] = {
+      CFX_FloatRect(0, 0, 1000, 1000),   CFX_FloatRect(100, 100, 150, 150),
+      CFX_FloatRect(500, 0, 510, 1000),  CFX_FloatRect(0, 500, 1000, 501),
+      CFX_FloatRect(-50, -50, -10, -10), CFX_FloatRect(999, 999, 999, 999),
+  };
+  for (const CFX_FloatRect& query : queries) {
+    EXPECT_EQ(BruteForceQuery(rects, query), index.Query(query));
+  }
+}
+
+TEST(CPDFPageObjectSpatialIndexTest, UnusualRects) {
+  constexpr float kNan = std::numeric_limits<float>::quiet_NaN();
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  const std::vector<CFX_FloatRect> rects = {
+      CFX_FloatRect(10, 10, 20, 20),
+      CFX_FloatRect(30, 30, 25, 25),  // Inverted.
+      CFX_FloatRect(kNan, 0, 5, 5),
+      CFX_FloatRect(-kInf, -kInf, kInf, kInf),
+      CFX_FloatRect(),
+  };
+  CPDF_PageObjectSpatialIndex index(rects);
+  EXPECT_EQ(rects.size(), index.size());
+
+  const CFX_FloatRect queries[] = {
+      CFX_FloatRect(0, 0, 100, 100),
+      CFX_FloatRect(26, 26, 27, 27),
+      CFX_FloatRect(1, 1, 2, 2),
+      CFX_FloatRect(0, 0, 0, 0),
+  };
+  for (const CFX_FloatRect& query : queries) {
+    EXPECT_EQ(BruteForceQuery(rects, query), index.Query(query));
+  }
+}
@@ -78,6 +78,7 @@ class CPDF_PSOP {
   void Execute(CPDF_PSEngine* pEngine);
   float GetFloatValue() const;
   PDF_PSOP GetOp() const { return op_; }
+  const CPDF_PSProc* GetProc() const { return proc_.get(); }
 
  private:
   const PDF_PSOP op_;
@@ -93,6 +94,10 @@ class CPDF_PSProc {
   bool Parse(CPDF_SimpleParser* parser, int depth);
   bool Execute(CPDF_PSEngine* pEngine);
 
+  const std::vector<std::unique_ptr<CPDF_PSOP>>& operators() const {
+    return operators_;
+  }
+
   // These methods are exposed for testing.
   void AddOperatorForTesting(ByteStringView word);
   const std::unique_ptr<CPDF_PSOP>& last_operator() {
@@ -109,6 +114,15 @@ class CPDF_PSProc {
 
 class CPDF_PSEngine {
  public:
+  static constexpr uint32_t kPSEngineStackSize = 100;
+
+  // Operators that pop one or two operands and push one result, computed by
+  // DoUnaryOperator() and DoBinaryOperator(). `d1` is the deeper operand.
+  static bool IsUnaryOperator(PDF_PSOP op);
+  static bool IsBinaryOperator(PDF_PSOP op);
+  static float DoUnaryOperator(PDF_PSOP op, float d1);
+  static float DoBinaryOperator(PDF_PSOP op, float d1, float d2);
+
   CPDF_PSEngine();
   ~CPDF_PSEngine();
 
@@ -120,10 +134,9 @@ class CPDF_PSEngine {
   float Pop();
   int PopInt();
   uint32_t GetStackSize() const { return stack_count_; }
+  const CPDF_PSProc& main_proc() const { return main_proc_; }
 
  private:
-  static constexpr uint32_t kPSEngineStackSize = 100;
-
   uint32_t stack_count_ = 0;
   CPDF_PSProc main_proc_;
   std::array<float, kPSEngineStackSize> stack_ = {};
@@ -6,8 +6,12 @@
 
 #include "core/fpdfapi/page/cpdf_psfunc.h"
 
+#include <bit>
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
+#include "core/fxcrt/span_util.h"
 
 CPDF_PSFunc::CPDF_PSFunc() : CPDF_Function(Type::kType4PostScript) {}
 
@@ -17,11 +21,48 @@ bool CPDF_PSFunc::v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) {
   auto pAcc =
       pdfium::MakeRetain<CPDF_StreamAcc>(pdfium::WrapRetain(pObj->AsStream()));
   pAcc->LoadAllDataFiltered();
-  return ps_.Parse(pAcc->GetSpan());
+  if (!ps_.Parse(pAcc->GetSpan())) {
+    return false;
+  }
+  program_ = CPDF_PSProgram::Compile(ps_.main_proc(), inputs_, outputs_);
+  return true;
 }
 
 bool CPDF_PSFunc::v_Call(pdfium::span<const float> inputs,
                          pdfium::span<float> results) const {
+  if (inputs_ > kMaxCachedInputs || outputs_ > kMaxCachedOutputs) {
+    return Evaluate(inputs, results);
+  }
+
+  std::array<uint32_t, kMaxCachedInputs> input_bits = {};
+  uint32_t hash = 0;
+  for (uint32_t i = 0; i < inputs_; i++) {
+    input_bits[i] = std::bit_cast<uint32_t>(inputs[i]);
+    hash = (hash ^ input_bits[i]) * 0x9e3779b1;
+  }
+  if (cache_.empty()) {
+    cache_.resize(1 << kCacheSizeBits);
+  }
+  CacheEntry& entry = cache_[hash >> (32 - kCacheSizeBits)];
+  if (entry.valid && entry.inputs == input_bits) {
+    fxcrt::spancpy(results, pdfium::span(entry.results).first(outputs_));
+    return true;
+  }
+  if (!Evaluate(inputs, results)) {
+    return false;
+  }
+  entry.valid = true;
+  entry.inputs = input_bits;
+  fxcrt::spancpy(pdfium::span(entry.results), results.first(outputs_));
+  return true;
+}
+
+bool CPDF_PSFunc::Evaluate(pdfium::span<const float> inputs,
+                           pdfium::span<float> results) const {
+  if (program_) {
+    return program_->Run(inputs, results);
+  }
+
   ps_.Reset();
   for (uint32_t i = 0; i < inputs_; i++) {
     ps_.Push(inputs[i]);
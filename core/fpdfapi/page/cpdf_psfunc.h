@@ -7,10 +7,17 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_PSFUNC_H_
 #define CORE_FPDFAPI_PAGE_CPDF_PSFUNC_H_
 
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "core/fpdfapi/page/cpdf_function.h"
 #include "core/fpdfapi/page/cpdf_psengine.h"
 
 class CPDF_Object;
+class CPDF_PSProgram;
 
 class CPDF_PSFunc final : public CPDF_Function {
  public:
@@ -23,7 +30,28 @@ class CPDF_PSFunc final : public CPDF_Function {
               pdfium::span<float> results) const override;
 
  private:
+  // Tint transforms get called for every pixel of DeviceN images, which tend
+  // to have few distinct colors. So remember the results for recent inputs,
+  // where there are few enough inputs and outputs.
+  static constexpr uint32_t kMaxCachedInputs = 4;
+  static constexpr uint32_t kMaxCachedOutputs = 8;
+  static constexpr int kCacheSizeBits = 8;
+
+  struct CacheEntry {
+    bool valid = false;
+    // The bit patterns of the inputs, so that -0 and NaN inputs match
+    // exactly.
+    std::array<uint32_t, kMaxCachedInputs> inputs;
+    std::array<float, kMaxCachedOutputs> results;
+  };
+
+  bool Evaluate(pdfium::span<const float> inputs,
+                pdfium::span<float> results) const;
+
   mutable CPDF_PSEngine ps_;  // Pre-initialized scratch space for v_Call().
+  // Used instead of `ps_` where the program compiles.
+  std::unique_ptr<CPDF_PSProgram> program_;
+  mutable std::vector<CacheEntry> cache_;  // Allocated on first use.
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_PSFUNC_H_
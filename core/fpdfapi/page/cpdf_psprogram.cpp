@@ -0,0 +1,355 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/ptr_util.h"
+#include "core/fxcrt/unowned_ptr.h"
+
+namespace {
+
+// Keeps pathological programs from using unbounded memory. Programs that
+// need more fall back to CPDF_PSEngine.
+constexpr size_t kMaxRegisters = 1 << 16;
+
+}  // namespace
+
+class CPDF_PSProgram::Compiler {
+ public:
+  explicit Compiler(CPDF_PSProgram* program) : program_(program) {}
+
+  void PushInputs(uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint32_t reg = NewRegister(0.0f);
+      if (stack_.size() < CPDF_PSEngine::kPSEngineStackSize) {
+        stack_.push_back(reg);
+      }
+    }
+  }
+
+  // Returns false where `proc` does not compile. Check too_big() as well.
+  bool CompileProc(const CPDF_PSProc& proc) {
+    const std::vector<std::unique_ptr<CPDF_PSOP>>& ops = proc.operators();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      if (too_big_) {
+        return false;
+      }
+
+      const PDF_PSOP op = ops[i]->GetOp();
+      if (op == PSOP_PROC) {
+        continue;
+      }
+
+      if (op == PSOP_CONST) {
+        Push(Constant(ops[i]->GetFloatValue()));
+        continue;
+      }
+
+      // Malformed conditionals stop the procedure, as in
+      // CPDF_PSProc::Execute().
+      if (op == PSOP_IF) {
+        if (i == 0 || ops[i - 1]->GetOp() != PSOP_PROC) {
+          return true;
+        }
+        if (!CompileConditional(Pop(), ops[i - 1]->GetProc(), nullptr)) {
+          return false;
+        }
+        continue;
+      }
+
+      if (op == PSOP_IFELSE) {
+        if (i < 2 || ops[i - 1]->GetOp() != PSOP_PROC ||
+            ops[i - 2]->GetOp() != PSOP_PROC) {
+          return true;
+        }
+        if (!CompileConditional(Pop(), ops[i - 2]->GetProc(),
+                                ops[i - 1]->GetProc())) {
+          return false;
+        }
+        continue;
+      }
+
+      if (!CompileOperator(op)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const std::vector<uint32_t>& stack() const { return stack_; }
+  bool too_big() const { return too_big_; }
+
+ private:
+  uint32_t NewRegister(float value) {
+    if (program_->registers_.size() >= kMaxRegisters) {
+      too_big_ = true;
+      return 0;
+    }
+    program_->registers_.push_back(value);
+    is_constant_.push_back(false);
+    return static_cast<uint32_t>(program_->registers_.size() - 1);
+  }
+
+  uint32_t Constant(float value) {
+    const uint32_t bits = std::bit_cast<uint32_t>(value);
+    auto it = constants_.find(bits);
+    if (it != constants_.end()) {
+      return it->second;
+    }
+    const uint32_t reg = NewRegister(value);
+    if (too_big_) {
+      return reg;
+    }
+    is_constant_[reg] = true;
+    constants_[bits] = reg;
+    return reg;
+  }
+
+  bool IsConstant(uint32_t reg) const { return is_constant_[reg]; }
+
+  float GetConstant(uint32_t reg) const {
+    DCHECK(IsConstant(reg));
+    return program_->registers_[reg];
+  }
+
+  // Returns the integer that CPDF_PSEngine::PopInt() would, where it does not
+  // depend on the inputs.
+  std::optional<int> PopConstantInt() {
+    const uint32_t reg = Pop();
+    if (!IsConstant(reg)) {
+      return std::nullopt;
+    }
+    return static_cast<int>(GetConstant(reg));
+  }
+
+  uint32_t Emit(Kind kind, PDF_PSOP op, uint32_t a, uint32_t b, uint32_t c) {
+    const uint32_t dest = NewRegister(0.0f);
+    program_->instructions_.push_back({
+        .kind = kind,
+        .op = op,
+        .dest = dest,
+        .a = a,
+        .b = b,
+        .c = c,
+    });
+    return dest;
+  }
+
+  // Same as CPDF_PSEngine::Push() and Pop(), for registers.
+  void Push(uint32_t reg) {
+    if (stack_.size() < CPDF_PSEngine::kPSEngineStackSize) {
+      stack_.push_back(reg);
+    }
+  }
+
+  uint32_t Pop() {
+    if (stack_.empty()) {
+      return Constant(0.0f);
+    }
+    const uint32_t reg = stack_.back();
+    stack_.pop_back();
+    return reg;
+  }
+
+  bool CompileConditional(uint32_t condition,
+                          const CPDF_PSProc* if_true,
+                          const CPDF_PSProc* if_false) {
+    if (IsConstant(condition)) {
+      const CPDF_PSProc* taken =
+          static_cast<int>(GetConstant(condition)) ? if_true : if_false;
+      return !taken || CompileProc(*taken);
+    }
+
+    const std::vector<uint32_t> before = stack_;
+    if (!CompileProc(*if_true)) {
+      return false;
+    }
+    std::vector<uint32_t> true_stack = std::exchange(stack_, before);
+    if (if_false && !CompileProc(*if_false)) {
+      return false;
+    }
+    if (true_stack.size() != stack_.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < stack_.size(); ++i) {
+      if (true_stack[i] != stack_[i]) {
+        stack_[i] = Emit(Kind::kSelect, PSOP_IFELSE, condition, true_stack[i],
+                         stack_[i]);
+      }
+    }
+    return true;
+  }
+
+  // Mirrors CPDF_PSEngine::DoOperator().
+  bool CompileOperator(PDF_PSOP op) {
+    if (CPDF_PSEngine::IsUnaryOperator(op)) {
+      const uint32_t d1 = Pop();
+      Push(IsConstant(d1) ? Constant(CPDF_PSEngine::DoUnaryOperator(
+                                op, GetConstant(d1)))
+                          : Emit(Kind::kUnary, op, d1, 0, 0));
+      return true;
+    }
+    if (CPDF_PSEngine::IsBinaryOperator(op)) {
+      const uint32_t d2 = Pop();
+      const uint32_t d1 = Pop();
+      Push(IsConstant(d1) && IsConstant(d2)
+               ? Constant(CPDF_PSEngine::DoBinaryOperator(op, GetConstant(d1),
+                                                          GetConstant(d2)))
+               : Emit(Kind::kBinary, op, d1, d2, 0));
+      return true;
+    }
+
+    switch (op) {
+      case PSOP_TRUE:
+        Push(Constant(1.0f));
+        return true;
+      case PSOP_FALSE:
+        Push(Constant(0.0f));
+        return true;
+      case PSOP_POP:
+        Pop();
+        return true;
+      case PSOP_EXCH: {
+        const uint32_t d2 = Pop();
+        const uint32_t d1 = Pop();
+        Push(d2);
+        Push(d1);
+        return true;
+      }
+      case PSOP_DUP: {
+        const uint32_t d1 = Pop();
+        Push(d1);
+        Push(d1);
+        return true;
+      }
+      case PSOP_COPY: {
+        std::optional<int> n = PopConstantInt();
+        if (!n.has_value()) {
+          return false;
+        }
+        const size_t count = stack_.size();
+        if (n.value() < 0 ||
+            count + n.value() > CPDF_PSEngine::kPSEngineStackSize ||
+            n.value() > static_cast<int>(count)) {
+          return true;
+        }
+        for (size_t i = count - n.value(); i < count; ++i) {
+          stack_.push_back(stack_[i]);
+        }
+        return true;
+      }
+      case PSOP_INDEX: {
+        std::optional<int> n = PopConstantInt();
+        if (!n.has_value()) {
+          return false;
+        }
+        if (n.value() < 0 || n.value() >= static_cast<int>(stack_.size())) {
+          return true;
+        }
+        Push(stack_[stack_.size() - n.value() - 1]);
+        return true;
+      }
+      case PSOP_ROLL: {
+        std::optional<int> j = PopConstantInt();
+        std::optional<int> n = PopConstantInt();
+        if (!j.has_value() || !n.has_value()) {
+          return false;
+        }
+        if (j.value() == 0 || n.value() == 0 || stack_.empty()) {
+          return true;
+        }
+        if (n.value() < 0 || n.value() > static_cast<int>(stack_.size())) {
+          return true;
+        }
+
+        int shift = j.value() % n.value();
+        if (shift > 0) {
+          shift -= n.value();
+        }
+        auto begin_it = stack_.end() - n.value();
+        std::rotate(begin_it, begin_it - shift, stack_.end());
+        return true;
+      }
+      default:
+        return true;
+    }
+  }
+
+  UnownedPtr<CPDF_PSProgram> const program_;
+  // The register in each stack slot.
+  std::vector<uint32_t> stack_;
+  std::vector<bool> is_constant_;
+  // Registers holding constants, by their bit patterns.
+  std::map<uint32_t, uint32_t> constants_;
+  bool too_big_ = false;
+};
+
+// static
+std::unique_ptr<CPDF_PSProgram> CPDF_PSProgram::Compile(
+    const CPDF_PSProc& main_proc,
+    uint32_t input_count,
+    uint32_t output_count) {
+  auto program = pdfium::WrapUnique(new CPDF_PSProgram());
+  program->input_count_ =
+      std::min(input_count, CPDF_PSEngine::kPSEngineStackSize);
+  Compiler compiler(program.get());
+  compiler.PushInputs(program->input_count_);
+  if (!compiler.CompileProc(main_proc) || compiler.too_big()) {
+    return nullptr;
+  }
+
+  const std::vector<uint32_t>& stack = compiler.stack();
+  if (stack.size() >= output_count) {
+    program->has_outputs_ = true;
+    program->output_registers_.assign(stack.end() - output_count,
+                                      stack.end());
+  }
+  return program;
+}
+
+CPDF_PSProgram::CPDF_PSProgram() = default;
+
+CPDF_PSProgram::~CPDF_PSProgram() = default;
+
+bool CPDF_PSProgram::Run(pdfium::span<const float> inputs,
+                         pdfium::span<float> results) {
+  if (!has_outputs_) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < input_count_; ++i) {
+    registers_[i] = inputs[i];
+  }
+  for (const Instruction& instruction : instructions_) {
+    float value;
+    switch (instruction.kind) {
+      case Kind::kUnary:
+        value = CPDF_PSEngine::DoUnaryOperator(instruction.op,
+                                               registers_[instruction.a]);
+        break;
+      case Kind::kBinary:
+        value = CPDF_PSEngine::DoBinaryOperator(
+            instruction.op, registers_[instruction.a],
+            registers_[instruction.b]);
+        break;
+      case Kind::kSelect:
+        value = static_cast<int>(registers_[instruction.a])
+                    ? registers_[instruction.b]
+                    : registers_[instruction.c];
+        break;
+    }
+    registers_[instruction.dest] = value;
+  }
+  for (size_t i = 0; i < output_registers_.size(); ++i) {
+    results[i] = registers_[output_registers_[i]];
+  }
+  return true;
+}
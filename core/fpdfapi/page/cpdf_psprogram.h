@@ -0,0 +1,77 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
+#define CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fxcrt/span.h"
+
+// A PostScript calculator program, compiled once into straight-line code over
+// registers so that running it does not need CPDF_PSEngine's stack.
+//
+// The compiler tracks which register each stack slot holds. Operators that
+// only move values around the stack cost nothing at run time, and operators
+// whose operands are all constants are folded. Conditionals on computed values
+// run both procedures and then select the results of the taken one, which is
+// safe as the operators have no side effects.
+//
+// Programs whose stack layout depends on their inputs, such as `copy`,
+// `index` and `roll` with computed counts, or conditionals whose procedures
+// leave different numbers of values, do not compile.
+class CPDF_PSProgram {
+ public:
+  // Returns nullptr where `main_proc` does not compile.
+  static std::unique_ptr<CPDF_PSProgram> Compile(const CPDF_PSProc& main_proc,
+                                                 uint32_t input_count,
+                                                 uint32_t output_count);
+
+  ~CPDF_PSProgram();
+
+  // Gives the same results as pushing `inputs` to a CPDF_PSEngine, executing
+  // `main_proc` and popping `output_count` values. Returns false where that
+  // would find fewer values on the stack. Not const, as the registers are
+  // scratch space.
+  bool Run(pdfium::span<const float> inputs, pdfium::span<float> results);
+
+  size_t instruction_count_for_testing() const { return instructions_.size(); }
+
+ private:
+  class Compiler;
+
+  enum class Kind : uint8_t {
+    kUnary,
+    kBinary,
+    // `dest` = `a` ? `b` : `c`, where `a` is converted to an integer as
+    // CPDF_PSEngine::PopInt() does.
+    kSelect,
+  };
+
+  struct Instruction {
+    Kind kind;
+    PDF_PSOP op;
+    uint32_t dest;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+  };
+
+  CPDF_PSProgram();
+
+  std::vector<Instruction> instructions_;
+  // The inputs, then constants and instruction results, in the order they
+  // were allocated. The constants are set at compile time.
+  std::vector<float> registers_;
+  uint32_t input_count_ = 0;
+  std::vector<uint32_t> output_registers_;
+  bool has_outputs_ = false;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
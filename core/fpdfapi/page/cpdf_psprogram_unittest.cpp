@@ -0,0 +1,160 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+
+#include <stdint.h>
+
+#include <bit>
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fxcrt/bytestring.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr float kInputs[] = {0.0f, 0.25f, 0.5f, 1.0f, -1.5f, 2.75f, 100.0f};
+
+// Compares bit patterns, so that NaN results match.
+std::vector<uint32_t> ToBits(const std::vector<float>& values) {
+  std::vector<uint32_t> bits;
+  for (float value : values) {
+    bits.push_back(std::bit_cast<uint32_t>(value));
+  }
+  return bits;
+}
+
+// Runs `program` on `engine` and on its compiled form with every combination
+// of 2 inputs from `kInputs`, and expects the same results.
+void ExpectSameResults(const char* program, uint32_t output_count) {
+  CPDF_PSEngine engine;
+  ASSERT_TRUE(engine.Parse(ByteStringView(program).unsigned_span()))
+      << program;
+  std::unique_ptr<CPDF_PSProgram> compiled =
+      CPDF_PSProgram::Compile(engine.main_proc(), 2, output_count);
+  ASSERT_TRUE(compiled) << program;
+
+  for (float input1 : kInputs) {
+    for (float input2 : kInputs) {
+      engine.Reset();
+      engine.Push(input1);
+      engine.Push(input2);
+      engine.Execute();
+      const bool expected_ok = engine.GetStackSize() >= output_count;
+      std::vector<float> expected(output_count);
+      if (expected_ok) {
+        for (uint32_t i = 0; i < output_count; ++i) {
+          expected[output_count - i - 1] = engine.Pop();
+        }
+      }
+
+      const float inputs[] = {input1, input2};
+      std::vector<float> actual(output_count);
+      EXPECT_EQ(expected_ok, compiled->Run(inputs, actual)) << program;
+      if (expected_ok) {
+        EXPECT_EQ(ToBits(expected), ToBits(actual))
+            << program << " with " << input1 << ", " << input2;
+      }
+    }
+  }
+}
+
+size_t CountInstructions(const char* program, uint32_t input_count) {
+  CPDF_PSEngine engine;
+  EXPECT_TRUE(engine.Parse(ByteStringView(program).unsigned_span()));
+  std::unique_ptr<CPDF_PSProgram> compiled =
+      CPDF_PSProgram::Compile(engine.main_proc(), input_count, 1);
+  return compiled ? compiled->instruction_count_for_testing() : SIZE_MAX;
+}
+
+bool Compiles(const char* program) {
+  CPDF_PSEngine engine;
+  EXPECT_TRUE(engine.Parse(ByteStringView(program).unsigned_span()));
+  return !!CPDF_PSProgram::Compile(engine.main_proc(), 2, 1);
+}
+
+}  // namespace
+
+TEST(CPDFPSProgramTest, SameResultsAsEngine) {
+  static const char* const kPrograms[] = {
+      "{ add }",
+      "{ sub }",
+      "{ exch sub }",
+      "{ mul 3 div }",
+      "{ idiv }",
+      "{ mod }",
+      "{ atan }",
+      "{ exp }",
+      "{ 2 copy eq 3 1 roll ne }",
+      "{ 2 copy gt 3 1 roll le }",
+      "{ and }",
+      "{ or not }",
+      "{ xor }",
+      "{ bitshift }",
+      "{ pop dup mul sqrt }",
+      "{ pop 90 mul sin }",
+      "{ exch pop 45 mul cos }",
+      "{ pop abs ln }",
+      "{ pop abs log }",
+      "{ pop neg ceiling }",
+      "{ pop floor }",
+      "{ pop round }",
+      "{ pop truncate cvi cvr }",
+      "{ 1 index 1 index }",
+      "{ 3 1 roll 2 -1 roll true false }",
+      "{ 2 copy 2 copy 4 2 roll }",
+      // Conditionals on the inputs, which run both procedures.
+      "{ 2 copy gt { exch } if pop }",
+      "{ 0.5 gt { 1 sub } { 2 mul } ifelse }",
+      "{ dup 1 lt { dup 0.2 lt { 0 } { 1 } ifelse } { 2 } ifelse add }",
+      "{ dup 0 gt { 2 copy } { 1 1 } ifelse add add add }",
+      // Conditionals on constants, which compile into just one procedure.
+      "{ 1 { add } { sub } ifelse }",
+      "{ false { add } if }",
+      // Too few values on the stack, which reads zeroes.
+      "{ pop pop pop add }",
+      "{ pop pop exch }",
+      // Malformed conditionals stop the procedure.
+      "{ add if 5 }",
+      "{ { 1 } ifelse 3 }",
+      "{ dup 0.5 gt { { 3 } ifelse 4 } { pop 5 } ifelse }",
+  };
+  for (const char* program : kPrograms) {
+    ExpectSameResults(program, 1);
+  }
+
+  // More outputs than values on the stack.
+  ExpectSameResults("{ pop }", 2);
+  ExpectSameResults("{ dup }", 3);
+}
+
+TEST(CPDFPSProgramTest, StackLimit) {
+  // Copies that would go over the stack size do nothing, and pushes that
+  // would are dropped.
+  ExpectSameResults("{ 2 copy 4 copy 8 copy 16 copy 32 copy 64 copy add }",
+                    1);
+  ExpectSameResults(
+      "{ 2 copy 4 copy 8 copy 16 copy 32 copy 32 copy 1 2 3 4 5 6 add add }",
+      1);
+}
+
+TEST(CPDFPSProgramTest, FoldsConstants) {
+  EXPECT_EQ(0u, CountInstructions("{ pop 2 3 add 4 mul }", 1));
+  EXPECT_EQ(1u, CountInstructions("{ 2 3 add mul }", 1));
+  EXPECT_EQ(0u, CountInstructions("{ dup exch pop 1 index pop }", 1));
+  EXPECT_EQ(1u, CountInstructions("{ 1 2 lt { 2 mul } { 3 mul } ifelse }", 1));
+  // Both procedures, then a select.
+  EXPECT_EQ(4u, CountInstructions(
+                    "{ dup 0.5 lt { 2 mul } { 3 mul } ifelse }", 1));
+}
+
+TEST(CPDFPSProgramTest, DoesNotCompileComputedStackLayouts) {
+  EXPECT_FALSE(Compiles("{ copy }"));
+  EXPECT_FALSE(Compiles("{ index }"));
+  EXPECT_FALSE(Compiles("{ 2 exch roll }"));
+  EXPECT_FALSE(Compiles("{ dup 0 gt { dup } if }"));
+  EXPECT_TRUE(Compiles("{ 1 copy 0 index 2 1 roll }"));
+}
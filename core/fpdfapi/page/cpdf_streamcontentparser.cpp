@@ -1372,9 +1372,9 @@ float CPDF_StreamContentParser::GetVerticalTextSize(float fKerning) const {
 }
 
 int32_t CPDF_StreamContentParser::GetCurrentStreamIndex() {
-  auto it = std::ranges::upper_bound(stream_start_offsets_,
+  auto it = std::ranges::upper_bound(*stream_start_offsets_,
                                      syntax_->GetPos() + start_parse_offset_);
-  return (it - stream_start_offsets_.begin()) - 1;
+  return (it - stream_start_offsets_->begin()) - 1;
 }
 
 void CPDF_StreamContentParser::Handle_ShowText() {
@@ -1631,29 +1631,29 @@ void CPDF_StreamContentParser::AddPathObject(
 }
 
 uint32_t CPDF_StreamContentParser::Parse(
-    pdfium::span<const uint8_t> pData,
-    uint32_t start_offset,
+    pdfium::span<const uint8_t> data,
+    uint32_t data_offset,
     uint32_t max_cost,
-    const std::vector<uint32_t>& stream_start_offsets) {
-  DCHECK(start_offset < pData.size());
+    const std::vector<uint32_t>& stream_start_offsets,
+    CPDF_StreamParser::DataSource* source) {
+  DCHECK(!data.empty());
 
-  // Parsing will be done from within |pDataStart|.
-  pdfium::span<const uint8_t> pDataStart = pData.subspan(start_offset);
-  start_parse_offset_ = start_offset;
+  start_parse_offset_ = data_offset;
   if (recursion_state_->parsed_set.size() > kMaxFormLevel ||
-      pdfium::Contains(recursion_state_->parsed_set, pDataStart.data())) {
-    return fxcrt::CollectionSize<uint32_t>(pDataStart);
+      pdfium::Contains(recursion_state_->parsed_set, data.data())) {
+    return fxcrt::CollectionSize<uint32_t>(data);
   }
 
-  stream_start_offsets_ = stream_start_offsets;
+  AutoNuller<UnownedPtr<const std::vector<uint32_t>>> offsets_clearer(
+      &stream_start_offsets_);
+  stream_start_offsets_ = &stream_start_offsets;
 
-  ScopedSetInsertion scoped_insert(&recursion_state_->parsed_set,
-                                   pDataStart.data());
+  ScopedSetInsertion scoped_insert(&recursion_state_->parsed_set, data.data());
 
   uint32_t init_obj_count = object_holder_->GetPageObjectCount();
   AutoNuller<std::unique_ptr<CPDF_StreamParser>> auto_clearer(&syntax_);
-  syntax_ = std::make_unique<CPDF_StreamParser>(pDataStart,
-                                                document_->GetByteStringPool());
+  syntax_ = std::make_unique<CPDF_StreamParser>(
+      data, document_->GetByteStringPool(), source);
 
   while (true) {
     uint32_t cost = object_holder_->GetPageObjectCount() - init_obj_count;
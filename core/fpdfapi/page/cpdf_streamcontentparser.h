@@ -16,6 +16,7 @@
 #include "core/fpdfapi/page/cpdf_contentmarks.h"
 #include "core/fpdfapi/page/cpdf_form.h"
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
+#include "core/fpdfapi/page/cpdf_streamparser.h"
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/fx_number.h"
@@ -37,7 +38,6 @@ class CPDF_PageObject;
 class CPDF_Pattern;
 class CPDF_ShadingPattern;
 class CPDF_Stream;
-class CPDF_StreamParser;
 class CPDF_TextObject;
 
 class CPDF_StreamContentParser {
@@ -56,10 +56,15 @@ class CPDF_StreamContentParser {
                            CPDF_Form::RecursionState* parse_state);
   ~CPDF_StreamContentParser();
 
-  uint32_t Parse(pdfium::span<const uint8_t> pData,
-                 uint32_t start_offset,
+  // Parses `data`, which starts at `data_offset` within the merged streams
+  // that `stream_start_offsets` refers to, and gets more of it from `source`,
+  // if any. `stream_start_offsets` may grow while parsing gets more data.
+  // Returns how many bytes it parsed.
+  uint32_t Parse(pdfium::span<const uint8_t> data,
+                 uint32_t data_offset,
                  uint32_t max_cost,
-                 const std::vector<uint32_t>& stream_start_offsets);
+                 const std::vector<uint32_t>& stream_start_offsets,
+                 CPDF_StreamParser::DataSource* source);
   CPDF_PageObjectHolder* GetPageObjectHolder() const { return object_holder_; }
   CPDF_AllStates* GetCurStates() const { return cur_states_.get(); }
   bool IsColored() const { return colored_; }
@@ -237,8 +242,8 @@ class CPDF_StreamContentParser {
   CPDF_PageObjectHolder::CTMMap all_ctms_;
 
   // The merged stream offsets at which a content stream ends and another
-  // begins.
-  std::vector<uint32_t> stream_start_offsets_;
+  // begins. Only set while parsing.
+  UnownedPtr<const std::vector<uint32_t>> stream_start_offsets_;
 
   // The merged stream offset at which the last |syntax_| started parsing.
   uint32_t start_parse_offset_ = 0;
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "constants/stream_dict_common.h"
@@ -23,6 +24,7 @@
 #include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fxcodec/data_and_bytes_consumed.h"
+#include "core/fxcodec/flate/flatemodule.h"
 #include "core/fxcodec/jpeg/jpegmodule.h"
 #include "core/fxcodec/scanlinedecoder.h"
 #include "core/fxcrt/autorestorer.h"
@@ -104,7 +106,8 @@ uint32_t DecodeInlineStream(pdfium::span<const uint8_t> src_span,
   if (decoder == "DCTDecode") {
     std::unique_ptr<ScanlineDecoder> pDecoder = JpegModule::CreateDecoder(
         src_span, width, height, 0,
-        !pParam || pParam->GetIntegerFor("ColorTransform", 1));
+        !pParam || pParam->GetIntegerFor("ColorTransform", 1),
+        /*scale_denom=*/1);
     return DecodeAllScanlines(std::move(pDecoder));
   }
   if (decoder == "CCITTFaxDecode") {
@@ -133,7 +136,12 @@ CPDF_StreamParser::CPDF_StreamParser(pdfium::span<const uint8_t> span)
 
 CPDF_StreamParser::CPDF_StreamParser(pdfium::span<const uint8_t> span,
                                      const WeakPtr<ByteStringPool>& pPool)
-    : pool_(pPool), buf_(span) {}
+    : CPDF_StreamParser(span, pPool, nullptr) {}
+
+CPDF_StreamParser::CPDF_StreamParser(pdfium::span<const uint8_t> span,
+                                     const WeakPtr<ByteStringPool>& pPool,
+                                     DataSource* source)
+    : pool_(pPool), buf_(span), source_(source) {}
 
 CPDF_StreamParser::~CPDF_StreamParser() = default;
 
@@ -141,15 +149,13 @@ RetainPtr<CPDF_Stream> CPDF_StreamParser::ReadInlineStream(
     CPDF_Document* doc,
     RetainPtr<CPDF_Dictionary> dict,
     const CPDF_Object* pCSObj) {
-  auto stream_span = buf_.subspan(pos_);
-  if (stream_span.empty()) {
+  if (!PositionIsInBounds()) {
     return nullptr;
   }
 
-  if (PDFCharIsWhitespace(stream_span.front())) {
+  if (PDFCharIsWhitespace(buf_[pos_])) {
     pos_++;
-    stream_span = stream_span.subspan<1>();
-    if (stream_span.empty()) {
+    if (!PositionIsInBounds()) {
       return nullptr;
     }
   }
@@ -197,15 +203,48 @@ RetainPtr<CPDF_Stream> CPDF_StreamParser::ReadInlineStream(
   DataVector<uint8_t> data;
   uint32_t actual_stream_size;
   if (decoder.IsEmpty()) {
+    while (buf_.size() - pos_ < original_size &&
+           ReadMore(original_size - (buf_.size() - pos_))) {
+    }
+    auto stream_span = buf_.subspan(pos_);
     original_size = std::min<uint32_t>(original_size, stream_span.size());
     auto src_span = stream_span.first(original_size);
     data = DataVector<uint8_t>(src_span.begin(), src_span.end());
     actual_stream_size = original_size;
     pos_ += original_size;
   } else {
-    actual_stream_size =
-        DecodeInlineStream(stream_span, width, height, decoder,
-                           std::move(param_dict), original_size);
+    // Flate data gets inflated as it arrives. Other filters decode from the
+    // start again whenever more arrives, which reading as much again as there
+    // is each time keeps to twice the work of one decode.
+    std::unique_ptr<FlateModule::EndFinder> flate_end_finder =
+        decoder == "FlateDecode" ? FlateModule::CreateEndFinder() : nullptr;
+    size_t taken_size = 0;
+    while (true) {
+      auto stream_span = buf_.subspan(pos_);
+      if (flate_end_finder) {
+        std::optional<uint32_t> end =
+            flate_end_finder->Take(stream_span.subspan(taken_size));
+        taken_size = stream_span.size();
+        actual_stream_size = end.value_or(stream_span.size());
+        if (end.has_value() || !ReadMore(stream_span.size())) {
+          break;
+        }
+        continue;
+      }
+      actual_stream_size = DecodeInlineStream(stream_span, width, height,
+                                              decoder, param_dict,
+                                              original_size);
+      // More data cannot help a filter that is not supported.
+      if (actual_stream_size == FX_INVALID_OFFSET) {
+        break;
+      }
+      // Decoding stops where the data does, so only stopping before that
+      // means it got to the end of the image.
+      if (actual_stream_size < stream_span.size() ||
+          !ReadMore(stream_span.size())) {
+        break;
+      }
+    }
     if (!pdfium::IsValueInRangeForNumericType<int>(actual_stream_size)) {
       return nullptr;
     }
@@ -227,7 +266,7 @@ RetainPtr<CPDF_Stream> CPDF_StreamParser::ReadInlineStream(
         actual_stream_size += pos_ - saved_iteration_position;
       }
     }
-    auto src_span = stream_span.first(actual_stream_size);
+    auto src_span = buf_.subspan(pos_, actual_stream_size);
     data = DataVector<uint8_t>(src_span.begin(), src_span.end());
     pos_ += actual_stream_size;
   }
@@ -633,6 +672,15 @@ DataVector<uint8_t> CPDF_StreamParser::ReadHexString() {
   return buf;
 }
 
-bool CPDF_StreamParser::PositionIsInBounds() const {
-  return pos_ < buf_.size();
+bool CPDF_StreamParser::PositionIsInBounds() {
+  return pos_ < buf_.size() || ReadMore(1);
+}
+
+bool CPDF_StreamParser::ReadMore(size_t size) {
+  if (!source_) {
+    return false;
+  }
+  const size_t old_size = buf_.size();
+  buf_ = source_->ReadMore(size);
+  return buf_.size() > old_size;
 }
@@ -7,6 +7,7 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_STREAMPARSER_H_
 #define CORE_FPDFAPI_PAGE_CPDF_STREAMPARSER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <array>
@@ -16,6 +17,7 @@
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/string_pool_template.h"
+#include "core/fxcrt/unowned_ptr.h"
 #include "core/fxcrt/weak_ptr.h"
 
 class CPDF_Dictionary;
@@ -27,9 +29,25 @@ class CPDF_StreamParser {
  public:
   enum ElementType { kEndOfData, kNumber, kKeyword, kName, kOther };
 
+  // Supplies the data to parse a piece at a time, as parsing gets to the end
+  // of what it has.
+  class DataSource {
+   public:
+    virtual ~DataSource() = default;
+
+    // Adds at least `size` more bytes to the end of the data, or all that is
+    // left if less, and returns all of the data, which still starts where it
+    // did. Spans of the data from before are no longer valid afterwards.
+    virtual pdfium::span<const uint8_t> ReadMore(size_t size) = 0;
+  };
+
   explicit CPDF_StreamParser(pdfium::span<const uint8_t> span);
   CPDF_StreamParser(pdfium::span<const uint8_t> span,
                     const WeakPtr<ByteStringPool>& pPool);
+  // Gets more data than `span` from `source`, which must outlive `this`.
+  CPDF_StreamParser(pdfium::span<const uint8_t> span,
+                    const WeakPtr<ByteStringPool>& pPool,
+                    DataSource* source);
   ~CPDF_StreamParser();
 
   ElementType ParseNextElement();
@@ -53,13 +71,17 @@ class CPDF_StreamParser {
   void GetNextWord(bool& bIsNumber);
   ByteString ReadString();
   DataVector<uint8_t> ReadHexString();
-  bool PositionIsInBounds() const;
+  // Gets more data from `source_` if needed.
+  bool PositionIsInBounds();
+  // Returns whether `source_` had any more data.
+  bool ReadMore(size_t size);
 
   uint32_t pos_ = 0;        // Current byte position within |buf_|.
   uint32_t word_size_ = 0;  // Current byte position within |word_buffer_|.
   WeakPtr<ByteStringPool> pool_;
   RetainPtr<CPDF_Object> last_obj_;
   pdfium::raw_span<const uint8_t> buf_;
+  UnownedPtr<DataSource> const source_;
   // Include space for NUL.
   std::array<uint8_t, kMaxWordLength + 1> word_buffer_ = {};
 };
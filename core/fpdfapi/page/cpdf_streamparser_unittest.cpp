@@ -3,12 +3,47 @@
 // found in the LICENSE file.
 
 #include "core/fpdfapi/page/cpdf_streamparser.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcodec/flate/flatemodule.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using testing::ElementsAre;
 using testing::IsEmpty;
 
+namespace {
+
+// Gives as little as it may, so that words get split between reads.
+class ByteAtATime final : public CPDF_StreamParser::DataSource {
+ public:
+  explicit ByteAtATime(pdfium::span<const uint8_t> data) : data_(data) {}
+
+  pdfium::span<const uint8_t> ReadMore(size_t size) override {
+    size_ = std::min(size_ + size, data_.size());
+    return data_.first(size_);
+  }
+
+  size_t size() const { return size_; }
+
+ private:
+  pdfium::span<const uint8_t> const data_;
+  size_t size_ = 0;
+};
+
+}  // namespace
+
 TEST(CPDFStreamParserTest, ReadHexString) {
   {
     // Position out of bounds.
@@ -49,3 +84,64 @@ TEST(CPDFStreamParserTest, ReadHexString) {
     EXPECT_EQ(1u, parser.GetPos());
   }
 }
+
+TEST(CPDFStreamParserTest, DataSource) {
+  static constexpr uint8_t kData[] = {'1', '0', ' ', '2', '0', '0',
+                                      ' ', 'r', 'e', ' ', 'f'};
+  ByteAtATime source(kData);
+  CPDF_StreamParser parser(pdfium::span<const uint8_t>(),
+                           WeakPtr<ByteStringPool>(), &source);
+  EXPECT_EQ(CPDF_StreamParser::kNumber, parser.ParseNextElement());
+  EXPECT_EQ("10", parser.GetWord());
+  EXPECT_EQ(CPDF_StreamParser::kNumber, parser.ParseNextElement());
+  EXPECT_EQ("200", parser.GetWord());
+  EXPECT_EQ(CPDF_StreamParser::kKeyword, parser.ParseNextElement());
+  EXPECT_EQ("re", parser.GetWord());
+  EXPECT_EQ(CPDF_StreamParser::kKeyword, parser.ParseNextElement());
+  EXPECT_EQ("f", parser.GetWord());
+  EXPECT_EQ(CPDF_StreamParser::kEndOfData, parser.ParseNextElement());
+  EXPECT_EQ(11u, parser.GetPos());
+}
+
+TEST(CPDFStreamParserTest, InlineFlateStreamFromDataSource) {
+  DataVector<uint8_t> pixels(64 * 64);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<uint8_t>(i * 7 % 251);
+  }
+  const DataVector<uint8_t> flate = FlateModule::Encode(pixels);
+  DataVector<uint8_t> data = {' '};
+  data.insert(data.end(), flate.begin(), flate.end());
+  data.insert(data.end(), {' ', 'E', 'I', ' ', 'Q'});
+
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("Width", 512);
+  dict->SetNewFor<CPDF_Number>("Height", 64);
+  dict->SetNewFor<CPDF_Name>("Filter", "FlateDecode");
+  ByteAtATime source(data);
+  CPDF_StreamParser parser(pdfium::span<const uint8_t>(),
+                           WeakPtr<ByteStringPool>(), &source);
+  RetainPtr<CPDF_Stream> stream =
+      parser.ReadInlineStream(nullptr, std::move(dict), nullptr);
+  ASSERT_TRUE(stream);
+  EXPECT_EQ(static_cast<int>(flate.size()),
+            stream->GetDict()->GetIntegerFor("Length"));
+  EXPECT_EQ(CPDF_StreamParser::kKeyword, parser.ParseNextElement());
+  EXPECT_EQ("EI", parser.GetWord());
+}
+
+TEST(CPDFStreamParserTest, InlineStreamWithUnsupportedFilter) {
+  DataVector<uint8_t> data(4096, 'x');
+  data.insert(data.end(), {' ', 'E', 'I', ' ', 'Q'});
+
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("Width", 64);
+  dict->SetNewFor<CPDF_Number>("Height", 64);
+  dict->SetNewFor<CPDF_Name>("Filter", "JBIG2Decode");
+  ByteAtATime source(data);
+  CPDF_StreamParser parser(pdfium::span<const uint8_t>(),
+                           WeakPtr<ByteStringPool>(), &source);
+  EXPECT_FALSE(parser.ReadInlineStream(nullptr, std::move(dict), nullptr));
+
+  // It gives up without reading to the end of the content.
+  EXPECT_LT(source.size(), data.size());
+}
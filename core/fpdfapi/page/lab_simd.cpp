@@ -0,0 +1,38 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/lab_simd.h"
+
+#include "build/build_config.h"
+#include "core/fpdfapi/page/lab_simd_impl.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxge/dib/simd_level.h"
+
+namespace {
+
+const fpdfapi::simd_internal::LabKernels* GetKernels() {
+  static constexpr fxge::SimdKernelSet<fpdfapi::simd_internal::LabKernels>
+      kKernels = {
+#if defined(ARCH_CPU_X86_FAMILY)
+      .sse2 = &fpdfapi::simd_internal::GetSse2LabKernels,
+#elif defined(ARCH_CPU_ARM64)
+      .neon = &fpdfapi::simd_internal::GetNeonLabKernels,
+#endif
+  };
+  return fxge::GetSimdKernels(kKernels);
+}
+
+}  // namespace
+
+size_t LabToSRGBScales(pdfium::span<const float> lab,
+                       pdfium::span<int32_t> scales) {
+  CHECK_EQ(lab.size() % 3, 0u);
+  CHECK_LE(lab.size(), scales.size());
+  const fpdfapi::simd_internal::LabKernels* kernels = GetKernels();
+  if (!kernels) {
+    return 0;
+  }
+  return kernels->lab_to_srgb_scales(lab.data(), scales.data(),
+                                     lab.size() / 3);
+}
@@ -0,0 +1,23 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_LAB_SIMD_H_
+#define CORE_FPDFAPI_PAGE_LAB_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+
+// Converts the leading colors in `lab`, which has L*, a* and b* values for
+// each, as far as CPDF_LabCS::GetRGB() goes before it looks up the sRGB
+// samples. That gives 3 sample indices per color, for red, green and blue, in
+// `scales`. Uses the SIMD kernels for fxge::GetSimdLevel(), which do the same
+// float operations in the same order as CPDF_LabCS::GetRGB(). Returns how many
+// colors it converted, which is 0 where there are no kernels. The caller
+// converts the rest.
+size_t LabToSRGBScales(pdfium::span<const float> lab,
+                       pdfium::span<int32_t> scales);
+
+#endif  // CORE_FPDFAPI_PAGE_LAB_SIMD_H_
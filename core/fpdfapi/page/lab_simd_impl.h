@@ -0,0 +1,29 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_LAB_SIMD_IMPL_H_
+#define CORE_FPDFAPI_PAGE_LAB_SIMD_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared by the per-instruction set translation units. See
+// core/fxge/dib/composite_simd_impl.h for what may go in here.
+
+namespace fpdfapi::simd_internal {
+
+struct LabKernels {
+  // LabToSRGBScales() for `count` colors, after the dispatcher in lab_simd.cpp
+  // has checked that `lab` and `scales` have 3 values for each.
+  size_t (*lab_to_srgb_scales)(const float* lab,
+                               int32_t* scales,
+                               size_t count);
+};
+
+const LabKernels& GetSse2LabKernels();
+const LabKernels& GetNeonLabKernels();
+
+}  // namespace fpdfapi::simd_internal
+
+#endif  // CORE_FPDFAPI_PAGE_LAB_SIMD_IMPL_H_
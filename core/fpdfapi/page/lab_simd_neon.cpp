@@ -0,0 +1,78 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "core/fpdfapi/page/lab_simd_impl.h"
+#include "core/fxcrt/compiler_specific.h"
+
+namespace fpdfapi::simd_internal {
+
+namespace {
+
+// As CPDF_LabCS::GetRGB() gets X, Y and Z from L, M and N:
+// `linear_scale * (t - 0.1379f)` below 0.2069, and `cube_scale * t * t * t`
+// elsewhere. Without fused multiply-adds.
+float32x4_t FromLab(float32x4_t t, float linear_scale, float cube_scale) {
+  const float32x4_t linear =
+      vmulq_n_f32(vsubq_f32(t, vdupq_n_f32(0.1379f)), linear_scale);
+  const float32x4_t cube =
+      vmulq_f32(vmulq_f32(vmulq_n_f32(t, cube_scale), t), t);
+  return vbslq_f32(vcltq_f32(t, vdupq_n_f32(0.2069f)), linear, cube);
+}
+
+// The sRGB sample index for linear sRGB values, as in cpdf_colorspace.cpp.
+// NaN values stay NaN through the clamp and convert to 0, as in the scalar
+// code.
+int32x4_t ToScale(float32x4_t value) {
+  const float32x4_t clamped =
+      vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+  return vcvtq_s32_f32(vmulq_n_f32(clamped, 1023.0f));
+}
+
+size_t LabToSRGBScales(const float* lab, int32_t* scales, size_t count) {
+  size_t i = 0;
+  // SAFETY: the caller makes sure `lab` and `scales` have 3 values for each of
+  // `count` colors.
+  UNSAFE_BUFFERS({
+    for (; i + 4 <= count; i += 4) {
+      const float32x4x3_t colors = vld3q_f32(lab + i * 3);
+      const float32x4_t m = vdivq_f32(
+          vaddq_f32(colors.val[0], vdupq_n_f32(16.0f)), vdupq_n_f32(116.0f));
+      const float32x4_t l =
+          vaddq_f32(m, vdivq_f32(colors.val[1], vdupq_n_f32(500.0f)));
+      const float32x4_t n =
+          vsubq_f32(m, vdivq_f32(colors.val[2], vdupq_n_f32(200.0f)));
+      const float32x4_t x = FromLab(l, 0.957f * 0.12842f, 0.957f);
+      const float32x4_t y = FromLab(m, 0.12842f, 1.0f);
+      const float32x4_t z = FromLab(n, 1.0889f * 0.12842f, 1.0889f);
+
+      // As in XYZ_to_sRGB().
+      int32x4x3_t rgb;
+      rgb.val[0] = ToScale(vsubq_f32(
+          vsubq_f32(vmulq_n_f32(x, 3.2410f), vmulq_n_f32(y, 1.5374f)),
+          vmulq_n_f32(z, 0.4986f)));
+      rgb.val[1] = ToScale(vaddq_f32(
+          vaddq_f32(vmulq_n_f32(x, -0.9692f), vmulq_n_f32(y, 1.8760f)),
+          vmulq_n_f32(z, 0.0416f)));
+      rgb.val[2] = ToScale(vaddq_f32(
+          vsubq_f32(vmulq_n_f32(x, 0.0556f), vmulq_n_f32(y, 0.2040f)),
+          vmulq_n_f32(z, 1.0570f)));
+      vst3q_s32(scales + i * 3, rgb);
+    }
+  });
+  return i;
+}
+
+constexpr LabKernels kKernels = {
+    .lab_to_srgb_scales = &LabToSRGBScales,
+};
+
+}  // namespace
+
+const LabKernels& GetNeonLabKernels() {
+  return kKernels;
+}
+
+}  // namespace fpdfapi::simd_internal
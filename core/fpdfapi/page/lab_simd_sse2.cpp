@@ -0,0 +1,107 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <emmintrin.h>
+
+#include "core/fpdfapi/page/lab_simd_impl.h"
+#include "core/fxcrt/compiler_specific.h"
+
+namespace fpdfapi::simd_internal {
+
+namespace {
+
+// Value `offset` of 4 colors with 3 values each.
+__m128 LoadComponent(const float* colors, size_t offset) {
+  // SAFETY: the caller makes sure `colors` has 12 values.
+  return UNSAFE_BUFFERS(_mm_setr_ps(colors[offset], colors[offset + 3],
+                                    colors[offset + 6], colors[offset + 9]));
+}
+
+// Selects `a` where `mask` is set, and `b` elsewhere.
+__m128 Select(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__m128 MulConstant(float constant, __m128 value) {
+  return _mm_mul_ps(_mm_set1_ps(constant), value);
+}
+
+// As CPDF_LabCS::GetRGB() gets X, Y and Z from L, M and N:
+// `linear_scale * (t - 0.1379f)` below 0.2069, and `cube_scale * t * t * t`
+// elsewhere.
+__m128 FromLab(__m128 t, float linear_scale, float cube_scale) {
+  const __m128 linear =
+      MulConstant(linear_scale, _mm_sub_ps(t, _mm_set1_ps(0.1379f)));
+  const __m128 cube = _mm_mul_ps(_mm_mul_ps(MulConstant(cube_scale, t), t), t);
+  return Select(_mm_cmplt_ps(t, _mm_set1_ps(0.2069f)), linear, cube);
+}
+
+// The sRGB sample index for linear sRGB values, as in cpdf_colorspace.cpp.
+// _mm_max_ps() picks 0 for NaN values, which the scalar code ends up with too.
+__m128i ToScale(__m128 value) {
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()),
+                                    _mm_set1_ps(1.0f));
+  return _mm_cvttps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(1023.0f)));
+}
+
+size_t LabToSRGBScales(const float* lab, int32_t* scales, size_t count) {
+  size_t i = 0;
+  // SAFETY: the caller makes sure `lab` and `scales` have 3 values for each of
+  // `count` colors.
+  UNSAFE_BUFFERS({
+    for (; i + 4 <= count; i += 4) {
+      const float* colors = lab + i * 3;
+      const __m128 m = _mm_div_ps(
+          _mm_add_ps(LoadComponent(colors, 0), _mm_set1_ps(16.0f)),
+          _mm_set1_ps(116.0f));
+      const __m128 l = _mm_add_ps(
+          m, _mm_div_ps(LoadComponent(colors, 1), _mm_set1_ps(500.0f)));
+      const __m128 n = _mm_sub_ps(
+          m, _mm_div_ps(LoadComponent(colors, 2), _mm_set1_ps(200.0f)));
+      const __m128 x = FromLab(l, 0.957f * 0.12842f, 0.957f);
+      const __m128 y = FromLab(m, 0.12842f, 1.0f);
+      const __m128 z = FromLab(n, 1.0889f * 0.12842f, 1.0889f);
+
+      // As in XYZ_to_sRGB().
+      alignas(16) int32_t red[4];
+      alignas(16) int32_t green[4];
+      alignas(16) int32_t blue[4];
+      _mm_store_si128(
+          reinterpret_cast<__m128i*>(red),
+          ToScale(_mm_sub_ps(_mm_sub_ps(MulConstant(3.2410f, x),
+                                        MulConstant(1.5374f, y)),
+                             MulConstant(0.4986f, z))));
+      _mm_store_si128(
+          reinterpret_cast<__m128i*>(green),
+          ToScale(_mm_add_ps(_mm_add_ps(MulConstant(-0.9692f, x),
+                                        MulConstant(1.8760f, y)),
+                             MulConstant(0.0416f, z))));
+      _mm_store_si128(
+          reinterpret_cast<__m128i*>(blue),
+          ToScale(_mm_add_ps(_mm_sub_ps(MulConstant(0.0556f, x),
+                                        MulConstant(0.2040f, y)),
+                             MulConstant(1.0570f, z))));
+      int32_t* dest = scales + i * 3;
+      for (int lane = 0; lane < 4; ++lane) {
+        dest[0] = red[lane];
+        dest[1] = green[lane];
+        dest[2] = blue[lane];
+        dest += 3;
+      }
+    }
+  });
+  return i;
+}
+
+constexpr LabKernels kKernels = {
+    .lab_to_srgb_scales = &LabToSRGBScales,
+};
+
+}  // namespace
+
+const LabKernels& GetSse2LabKernels() {
+  return kKernels;
+}
+
+}  // namespace fpdfapi::simd_internal
@@ -0,0 +1,305 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/parser/cpdf_cross_ref_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include "core/fdrm/fx_crypt_sha.h"
+#include "core/fpdfapi/parser/cpdf_cross_ref_table.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fpdfapi/parser/cpdf_syntax_parser.h"
+#include "core/fpdfapi/parser/fpdf_parser_utility.h"
+#include "core/fxcrt/binary_buffer.h"
+#include "core/fxcrt/byteorder.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/fx_string_wrappers.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/retain_ptr.h"
+
+using ObjectType = CPDF_CrossRefTable::ObjectType;
+using ObjectInfo = CPDF_CrossRefTable::ObjectInfo;
+
+namespace {
+
+// All fields are big-endian. The layout is:
+//   magic, version, file size, last xref offset, file digest, flags,
+//   trailer object number, trailer length, trailer, object count,
+//   objects (object number, type, object stream flag, gennum, location).
+constexpr std::array<uint8_t, 8> kMagic = {'P', 'D', 'F', 'X',
+                                           'R', 'E', 'F', 'C'};
+constexpr uint32_t kVersion = 2;
+constexpr size_t kDigestSize = 32;
+
+// The file digest covers the first and the last `kEndSize` bytes of the file,
+// and the first `kXRefSectionSize` bytes at the last xref offset. The start
+// holds the header, and the first cross reference section of linearized
+// files. The end holds the trailer and startxref, and changes with every
+// appended update.
+constexpr FX_FILESIZE kEndSize = 4 * 1024;
+constexpr FX_FILESIZE kXRefSectionSize = 64 * 1024;
+
+constexpr uint8_t kXRefStreamFlag = 1 << 0;
+constexpr uint8_t kXRefTableRebuiltFlag = 1 << 1;
+
+class CacheWriter {
+ public:
+  void WriteBytes(pdfium::span<const uint8_t> bytes) { buf_.AppendSpan(bytes); }
+  void Write8(uint8_t value) { buf_.AppendUint8(value); }
+
+  void Write16(uint16_t value) {
+    std::array<uint8_t, 2> bytes;
+    fxcrt::PutUInt16MSBFirst(value, bytes);
+    WriteBytes(bytes);
+  }
+
+  void Write32(uint32_t value) {
+    std::array<uint8_t, 4> bytes;
+    fxcrt::PutUInt32MSBFirst(value, bytes);
+    WriteBytes(bytes);
+  }
+
+  void Write64(uint64_t value) {
+    Write32(static_cast<uint32_t>(value >> 32));
+    Write32(static_cast<uint32_t>(value));
+  }
+
+  DataVector<uint8_t> Detach() { return buf_.DetachBuffer(); }
+
+ private:
+  fxcrt::BinaryBuffer buf_;
+};
+
+// Reads past the end return zeros and make failed() true.
+class CacheReader {
+ public:
+  explicit CacheReader(pdfium::span<const uint8_t> data) : data_(data) {}
+
+  bool failed() const { return failed_; }
+  bool AtEnd() const { return data_.empty(); }
+
+  pdfium::span<const uint8_t> ReadBytes(size_t size) {
+    if (failed_ || size > data_.size()) {
+      failed_ = true;
+      return {};
+    }
+    pdfium::span<const uint8_t> result = data_.first(size);
+    data_ = data_.subspan(size);
+    return result;
+  }
+
+  uint8_t Read8() {
+    pdfium::span<const uint8_t> bytes = ReadBytes(1);
+    return bytes.empty() ? 0 : bytes[0];
+  }
+
+  uint16_t Read16() {
+    pdfium::span<const uint8_t> bytes = ReadBytes(2);
+    return bytes.empty() ? 0 : fxcrt::GetUInt16MSBFirst(bytes.first<2u>());
+  }
+
+  uint32_t Read32() {
+    pdfium::span<const uint8_t> bytes = ReadBytes(4);
+    return bytes.empty() ? 0 : fxcrt::GetUInt32MSBFirst(bytes.first<4u>());
+  }
+
+  uint64_t Read64() {
+    const uint64_t high = Read32();
+    return (high << 32) | Read32();
+  }
+
+ private:
+  pdfium::raw_span<const uint8_t> data_;
+  bool failed_ = false;
+};
+
+DataVector<uint8_t> ComputeFileDigest(IFX_SeekableReadStream* file,
+                                      FX_FILESIZE last_xref_offset) {
+  const FX_FILESIZE size = file->GetSize();
+  pdfium::span<const uint8_t> in_memory = file->GetInMemorySpan();
+  DataVector<uint8_t> buffer;
+  CRYPT_sha2_context context;
+  CRYPT_SHA256Start(&context);
+  const std::array<std::pair<FX_FILESIZE, FX_FILESIZE>, 3> regions = {{
+      {0, kEndSize},
+      {last_xref_offset, kXRefSectionSize},
+      {size - kEndSize, kEndSize},
+  }};
+  for (auto [offset, length] : regions) {
+    offset = std::clamp<FX_FILESIZE>(offset, 0, size);
+    const size_t region_size =
+        static_cast<size_t>(std::min(length, size - offset));
+    if (!region_size) {
+      continue;
+    }
+    if (!in_memory.empty()) {
+      CRYPT_SHA256Update(
+          &context,
+          in_memory.subspan(static_cast<size_t>(offset), region_size));
+      continue;
+    }
+    buffer.resize(region_size);
+    if (!file->ReadBlockAtOffset(buffer, offset)) {
+      return DataVector<uint8_t>();
+    }
+    CRYPT_SHA256Update(&context, buffer);
+  }
+
+  DataVector<uint8_t> digest(kDigestSize);
+  CRYPT_SHA256Finish(&context, pdfium::span(digest).first<kDigestSize>());
+  return digest;
+}
+
+bool IsValidObjectInfo(const ObjectInfo& info, FX_FILESIZE file_size) {
+  switch (info.type) {
+    case ObjectType::kFree:
+      return true;
+    case ObjectType::kNormal:
+      return info.pos >= 0 && info.pos < file_size;
+    case ObjectType::kCompressed:
+      return info.archive.obj_num <= CPDF_Parser::kMaxObjectNumber;
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+DataVector<uint8_t> CPDF_CrossRefCache::Serialize(
+    const CPDF_CrossRefTable& table,
+    const ParserState& state,
+    IFX_SeekableReadStream* file) {
+  DataVector<uint8_t> digest =
+      ComputeFileDigest(file, state.last_xref_offset);
+  if (digest.empty()) {
+    return DataVector<uint8_t>();
+  }
+
+  ByteString trailer;
+  if (table.trailer()) {
+    fxcrt::ostringstream trailer_stream;
+    trailer_stream << table.trailer();
+    trailer = ByteString(trailer_stream);
+  }
+
+  CacheWriter writer;
+  writer.WriteBytes(kMagic);
+  writer.Write32(kVersion);
+  writer.Write64(static_cast<uint64_t>(file->GetSize()));
+  writer.Write64(static_cast<uint64_t>(state.last_xref_offset));
+  writer.WriteBytes(digest);
+  writer.Write8((state.xref_stream ? kXRefStreamFlag : 0) |
+                (state.xref_table_rebuilt ? kXRefTableRebuiltFlag : 0));
+  writer.Write32(table.trailer_object_number());
+  writer.Write32(trailer.GetLength());
+  writer.WriteBytes(trailer.unsigned_span());
+  writer.Write32(static_cast<uint32_t>(table.objects_info().size()));
+  for (const auto& [obj_num, info] : table.objects_info()) {
+    writer.Write32(obj_num);
+    writer.Write8(static_cast<uint8_t>(info.type));
+    writer.Write8(info.is_object_stream_flag);
+    writer.Write16(info.gennum);
+    if (info.type == ObjectType::kCompressed) {
+      writer.Write32(info.archive.obj_num);
+      writer.Write32(info.archive.obj_index);
+    } else {
+      writer.Write64(static_cast<uint64_t>(info.pos));
+    }
+  }
+  return writer.Detach();
+}
+
+// static
+std::unique_ptr<CPDF_CrossRefTable> CPDF_CrossRefCache::Deserialize(
+    pdfium::span<const uint8_t> data,
+    IFX_SeekableReadStream* file,
+    CPDF_IndirectObjectHolder* holder,
+    ParserState* state) {
+  CacheReader reader(data);
+  if (reader.ReadBytes(kMagic.size()) != pdfium::span(kMagic) ||
+      reader.Read32() != kVersion) {
+    return nullptr;
+  }
+
+  const FX_FILESIZE file_size = file->GetSize();
+  if (reader.Read64() != static_cast<uint64_t>(file_size)) {
+    return nullptr;
+  }
+
+  const FX_FILESIZE last_xref_offset =
+      static_cast<FX_FILESIZE>(reader.Read64());
+  pdfium::span<const uint8_t> digest = reader.ReadBytes(kDigestSize);
+  const uint8_t flags = reader.Read8();
+  const uint32_t trailer_object_number = reader.Read32();
+  pdfium::span<const uint8_t> trailer_bytes =
+      reader.ReadBytes(reader.Read32());
+  const uint32_t object_count = reader.Read32();
+  if (reader.failed() || last_xref_offset < 0 ||
+      last_xref_offset >= file_size ||
+      trailer_object_number > CPDF_Parser::kMaxObjectNumber) {
+    return nullptr;
+  }
+
+  std::map<uint32_t, ObjectInfo> objects_info;
+  for (uint32_t i = 0; i < object_count; ++i) {
+    const uint32_t obj_num = reader.Read32();
+    const uint8_t type = reader.Read8();
+    const uint8_t is_object_stream = reader.Read8();
+    ObjectInfo info;
+    info.gennum = reader.Read16();
+    if (reader.failed() ||
+        type > static_cast<uint8_t>(ObjectType::kCompressed) ||
+        is_object_stream > 1 || obj_num > CPDF_Parser::kMaxObjectNumber ||
+        (!objects_info.empty() && obj_num <= objects_info.rbegin()->first)) {
+      return nullptr;
+    }
+
+    info.type = static_cast<ObjectType>(type);
+    info.is_object_stream_flag = is_object_stream;
+    if (info.type == ObjectType::kCompressed) {
+      info.archive.obj_num = reader.Read32();
+      info.archive.obj_index = reader.Read32();
+    } else {
+      info.pos = static_cast<FX_FILESIZE>(reader.Read64());
+    }
+    if (reader.failed() || !IsValidObjectInfo(info, file_size)) {
+      return nullptr;
+    }
+    objects_info.emplace_hint(objects_info.end(), obj_num, info);
+  }
+  if (!reader.AtEnd()) {
+    return nullptr;
+  }
+
+  RetainPtr<CPDF_Dictionary> trailer;
+  if (!trailer_bytes.empty()) {
+    CPDF_SyntaxParser parser(
+        pdfium::MakeRetain<CFX_ReadOnlySpanStream>(trailer_bytes));
+    trailer = ToDictionary(parser.GetObjectBody(holder));
+    if (!trailer) {
+      return nullptr;
+    }
+  }
+
+  // Only hash the file once the rest of `data` checks out, as this reads
+  // from it.
+  const DataVector<uint8_t> file_digest =
+      ComputeFileDigest(file, last_xref_offset);
+  if (pdfium::span(file_digest) != digest) {
+    return nullptr;
+  }
+
+  state->last_xref_offset = last_xref_offset;
+  state->xref_stream = flags & kXRefStreamFlag;
+  state->xref_table_rebuilt = flags & kXRefTableRebuiltFlag;
+  return std::make_unique<CPDF_CrossRefTable>(
+      std::move(trailer), trailer_object_number, std::move(objects_info));
+}
@@ -0,0 +1,55 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PARSER_CPDF_CROSS_REF_CACHE_H_
+#define CORE_FPDFAPI_PARSER_CPDF_CROSS_REF_CACHE_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_types.h"
+#include "core/fxcrt/span.h"
+
+class CPDF_CrossRefTable;
+class CPDF_IndirectObjectHolder;
+class IFX_SeekableReadStream;
+
+// Serializes the outcome of CPDF_Parser's cross reference parsing, so a later
+// parse of the same file can skip it. Embedders store the data next to the
+// file. The data records the size of the file, and a SHA-256 digest of its
+// start, its end and its last cross reference section, and is rejected for
+// files where these differ. That takes a few small reads rather than a read
+// of the whole file, and catches other files as well as appended updates,
+// but not changes elsewhere that keep the size. For those, CPDF_Parser checks
+// the "objnum gennum obj" header of each object the first time it parses it,
+// and on a mismatch drops the cached table and parses the file's own.
+class CPDF_CrossRefCache {
+ public:
+  // Parser state that goes along with the table.
+  struct ParserState {
+    FX_FILESIZE last_xref_offset = 0;
+    bool xref_stream = false;
+    bool xref_table_rebuilt = false;
+  };
+
+  // Returns an empty vector if `file` cannot be read.
+  static DataVector<uint8_t> Serialize(const CPDF_CrossRefTable& table,
+                                       const ParserState& state,
+                                       IFX_SeekableReadStream* file);
+
+  // Returns nullptr if `data` is malformed or does not describe `file`. The
+  // trailer's references are bound to `holder`. The digest of `file` is only
+  // computed once everything else checks out.
+  static std::unique_ptr<CPDF_CrossRefTable> Deserialize(
+      pdfium::span<const uint8_t> data,
+      IFX_SeekableReadStream* file,
+      CPDF_IndirectObjectHolder* holder,
+      ParserState* state);
+
+  CPDF_CrossRefCache() = delete;
+};
+
+#endif  // CORE_FPDFAPI_PARSER_CPDF_CROSS_REF_CACHE_H_
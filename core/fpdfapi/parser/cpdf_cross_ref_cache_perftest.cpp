@@ -0,0 +1,118 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/parser/cpdf_object.h"
+#include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_test_helpers.h"
+
+namespace {
+
+constexpr int kObjectCount = 50000;
+constexpr int kRuns = 9;
+
+// Returns a file with `kObjectCount` small objects and a cross reference
+// table. With `damaged`, startxref points nowhere, so that parsing has to
+// search the whole file for objects.
+std::string MakeFile(bool damaged) {
+  std::string file = "%PDF-1.7\n";
+  std::vector<size_t> offsets;
+  auto add_object = [&file, &offsets](const std::string& body) {
+    offsets.push_back(file.size());
+    file += std::to_string(offsets.size()) + " 0 obj\n" + body + "\nendobj\n";
+  };
+  add_object("<</Type /Catalog /Pages 2 0 R>>");
+  add_object("<</Type /Pages /Kids [] /Count 0>>");
+  while (offsets.size() < kObjectCount) {
+    add_object("<</Index " + std::to_string(offsets.size()) + ">>");
+  }
+
+  const size_t xref_offset = file.size();
+  file += "xref\n0 " + std::to_string(offsets.size() + 1) + "\n";
+  file += "0000000000 65535 f\r\n";
+  for (size_t offset : offsets) {
+    char entry[21];
+    snprintf(entry, sizeof(entry), "%010zu 00000 n\r\n", offset);
+    file += entry;
+  }
+  file += "trailer\n<</Size " + std::to_string(offsets.size() + 1) +
+          " /Root 1 0 R>>\nstartxref\n" +
+          std::to_string(damaged ? xref_offset / 2 : xref_offset) +
+          "\n%%EOF\n";
+  return file;
+}
+
+// Parses objects with the parser, like CPDF_Document, which the parser needs
+// to find the catalog.
+class ParsingObjectsHolder final : public CPDF_Parser::ParsedObjectsHolder {
+ public:
+  ParsingObjectsHolder() = default;
+  ~ParsingObjectsHolder() override = default;
+
+  // CPDF_Parser::ParsedObjectsHolder:
+  bool TryInit() override { return true; }
+  RetainPtr<CPDF_Object> ParseIndirectObject(uint32_t objnum) override {
+    return parser_->ParseIndirectObject(objnum);
+  }
+
+  void set_parser(CPDF_Parser* parser) { parser_ = parser; }
+
+ private:
+  UnownedPtr<CPDF_Parser> parser_;
+};
+
+// Parses `file` with `cache`, if not empty, and returns the cache data of the
+// parse.
+DataVector<uint8_t> Parse(const std::string& file,
+                          pdfium::span<const uint8_t> cache) {
+  ParsingObjectsHolder holder;
+  CPDF_Parser parser(&holder);
+  holder.set_parser(&parser);
+  auto stream = pdfium::MakeRetain<CFX_ReadOnlySpanStream>(
+      pdfium::as_bytes(pdfium::span(file)));
+  const CPDF_Parser::Error error =
+      cache.empty()
+          ? parser.StartParse(std::move(stream), ByteString())
+          : parser.StartParseWithCrossRefCache(std::move(stream),
+                                               ByteString(), cache);
+  EXPECT_EQ(CPDF_Parser::SUCCESS, error);
+  return parser.GetCrossRefCache();
+}
+
+void CompareParseTimes(const char* name, bool damaged) {
+  const std::string file = MakeFile(damaged);
+  const DataVector<uint8_t> cache = Parse(file, {});
+  ASSERT_FALSE(cache.empty());
+
+  const std::chrono::microseconds uncached =
+      MedianRunTime(kRuns, [&file] { Parse(file, {}); });
+  const std::chrono::microseconds cached =
+      MedianRunTime(kRuns, [&file, &cache] { Parse(file, cache); });
+  PrintPerfResult(name, "uncached", uncached);
+  PrintPerfResult(name, "cached", cached);
+  EXPECT_LT(cached, uncached);
+}
+
+}  // namespace
+
+TEST(CrossRefCachePerfTest, XRefTable) {
+  CompareParseTimes("cross_ref_cache_xref_table", /*damaged=*/false);
+}
+
+TEST(CrossRefCachePerfTest, DamagedFile) {
+  CompareParseTimes("cross_ref_cache_damaged_file", /*damaged=*/true);
+}
@@ -0,0 +1,238 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/parser/cpdf_cross_ref_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "core/fpdfapi/parser/cpdf_cross_ref_table.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_indirect_object_holder.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
+#include "core/fpdfapi/parser/cpdf_string.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/span_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ObjectType = CPDF_CrossRefTable::ObjectType;
+
+namespace {
+
+const char kFileData[] = "%PDF-1.7\n1 0 obj\n<<>>\nendobj\n%%EOF\n";
+
+RetainPtr<CFX_ReadOnlySpanStream> MakeFile(pdfium::span<const char> data) {
+  return pdfium::MakeRetain<CFX_ReadOnlySpanStream>(pdfium::as_bytes(data));
+}
+
+// Serves reads from memory without exposing the data as a span, and counts
+// the bytes read.
+class CountingStream final : public IFX_SeekableReadStream {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  // IFX_SeekableReadStream:
+  FX_FILESIZE GetSize() override {
+    return static_cast<FX_FILESIZE>(data_.size());
+  }
+  bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                         FX_FILESIZE offset) override {
+    if (offset < 0 || static_cast<size_t>(offset) > data_.size() ||
+        buffer.size() > data_.size() - static_cast<size_t>(offset)) {
+      return false;
+    }
+    fxcrt::spancpy(buffer, pdfium::as_bytes(pdfium::span(data_)).subspan(
+                               static_cast<size_t>(offset), buffer.size()));
+    bytes_read_ += buffer.size();
+    return true;
+  }
+
+  std::string& data() { return data_; }
+  size_t bytes_read() const { return bytes_read_; }
+
+ private:
+  explicit CountingStream(std::string data) : data_(std::move(data)) {}
+  ~CountingStream() override = default;
+
+  std::string data_;
+  size_t bytes_read_ = 0;
+};
+
+std::unique_ptr<CPDF_CrossRefTable> MakeTable() {
+  auto trailer = pdfium::MakeRetain<CPDF_Dictionary>();
+  trailer->SetNewFor<CPDF_Reference>("Root", nullptr, 1);
+  trailer->SetNewFor<CPDF_Number>("Size", 5);
+  trailer->SetNewFor<CPDF_Name>("Type", "XRef");
+  trailer->SetNewFor<CPDF_String>("ID",
+                                  ByteString("\x01(\x02").unsigned_span(),
+                                  CPDF_String::DataType::kIsHex);
+  auto table = std::make_unique<CPDF_CrossRefTable>(std::move(trailer), 4);
+  table->SetFree(0, 65535);
+  table->AddNormal(1, 0, false, 9);
+  table->AddCompressed(2, 3, 7);
+  table->AddNormal(3, 2, true, 20);
+  return table;
+}
+
+}  // namespace
+
+TEST(CrossRefCacheTest, RoundTrip) {
+  auto file = MakeFile(kFileData);
+  std::unique_ptr<CPDF_CrossRefTable> table = MakeTable();
+  const CPDF_CrossRefCache::ParserState state = {
+      .last_xref_offset = 30, .xref_stream = true, .xref_table_rebuilt = true};
+  DataVector<uint8_t> data =
+      CPDF_CrossRefCache::Serialize(*table, state, file.Get());
+  ASSERT_FALSE(data.empty());
+
+  CPDF_IndirectObjectHolder holder;
+  CPDF_CrossRefCache::ParserState restored_state;
+  std::unique_ptr<CPDF_CrossRefTable> restored =
+      CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder,
+                                      &restored_state);
+  ASSERT_TRUE(restored);
+  EXPECT_EQ(30, restored_state.last_xref_offset);
+  EXPECT_TRUE(restored_state.xref_stream);
+  EXPECT_TRUE(restored_state.xref_table_rebuilt);
+
+  EXPECT_EQ(4u, restored->trailer_object_number());
+  const CPDF_Dictionary* trailer = restored->trailer();
+  ASSERT_TRUE(trailer);
+  RetainPtr<const CPDF_Reference> root =
+      ToReference(trailer->GetObjectFor("Root"));
+  ASSERT_TRUE(root);
+  EXPECT_EQ(1u, root->GetRefObjNum());
+  EXPECT_EQ(5, trailer->GetIntegerFor("Size"));
+  EXPECT_EQ("XRef", trailer->GetNameFor("Type"));
+  EXPECT_EQ("\x01(\x02", trailer->GetByteStringFor("ID"));
+
+  ASSERT_EQ(table->objects_info().size(), restored->objects_info().size());
+  for (const auto& [obj_num, info] : table->objects_info()) {
+    const CPDF_CrossRefTable::ObjectInfo* restored_info =
+        restored->GetObjectInfo(obj_num);
+    ASSERT_TRUE(restored_info) << obj_num;
+    EXPECT_EQ(info.type, restored_info->type) << obj_num;
+    EXPECT_EQ(info.gennum, restored_info->gennum) << obj_num;
+    EXPECT_EQ(info.is_object_stream_flag, restored_info->is_object_stream_flag)
+        << obj_num;
+    if (info.type == ObjectType::kCompressed) {
+      EXPECT_EQ(info.archive.obj_num, restored_info->archive.obj_num);
+      EXPECT_EQ(info.archive.obj_index, restored_info->archive.obj_index);
+    } else {
+      EXPECT_EQ(info.pos, restored_info->pos) << obj_num;
+    }
+  }
+}
+
+TEST(CrossRefCacheTest, RejectsOtherFiles) {
+  DataVector<uint8_t> data = CPDF_CrossRefCache::Serialize(
+      *MakeTable(), CPDF_CrossRefCache::ParserState(),
+      MakeFile(kFileData).Get());
+  ASSERT_FALSE(data.empty());
+
+  CPDF_IndirectObjectHolder holder;
+  CPDF_CrossRefCache::ParserState state;
+
+  // Same size, different contents.
+  const char kModifiedData[] = "%PDF-1.7\n1 0 obj\n<<>>\nendobj\n%%EOF\r";
+  static_assert(sizeof(kModifiedData) == sizeof(kFileData));
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(
+      data, MakeFile(kModifiedData).Get(), &holder, &state));
+
+  // Appended update.
+  const char kLongerData[] = "%PDF-1.7\n1 0 obj\n<<>>\nendobj\n%%EOF\n\n";
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(
+      data, MakeFile(kLongerData).Get(), &holder, &state));
+}
+
+TEST(CrossRefCacheTest, OnlyReadsPartsOfLargeFiles) {
+  constexpr size_t kFileSize = 4 * 1024 * 1024;
+  constexpr size_t kXRefOffset = 3 * 1024 * 1024;
+  auto file = pdfium::MakeRetain<CountingStream>(std::string(kFileSize, ' '));
+  const CPDF_CrossRefCache::ParserState state = {.last_xref_offset =
+                                                     kXRefOffset};
+  DataVector<uint8_t> data =
+      CPDF_CrossRefCache::Serialize(*MakeTable(), state, file.Get());
+  ASSERT_FALSE(data.empty());
+  EXPECT_LE(file->bytes_read(), 72u * 1024);
+
+  CPDF_IndirectObjectHolder holder;
+  CPDF_CrossRefCache::ParserState restored_state;
+  EXPECT_TRUE(CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder,
+                                              &restored_state));
+  EXPECT_LE(file->bytes_read(), 2u * 72 * 1024);
+
+  // Changes in the last cross reference section are noticed.
+  file->data()[kXRefOffset + 100] = 'x';
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder,
+                                               &restored_state));
+  file->data()[kXRefOffset + 100] = ' ';
+
+  // So are changes at the start and at the end.
+  file->data()[100] = 'x';
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder,
+                                               &restored_state));
+  file->data()[100] = ' ';
+  file->data()[kFileSize - 100] = 'x';
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder,
+                                               &restored_state));
+  file->data()[kFileSize - 100] = ' ';
+
+  // Other changes that keep the size are not.
+  file->data()[kFileSize / 2] = 'x';
+  EXPECT_TRUE(CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder,
+                                              &restored_state));
+}
+
+TEST(CrossRefCacheTest, RejectsMalformedData) {
+  auto file = MakeFile(kFileData);
+  DataVector<uint8_t> data = CPDF_CrossRefCache::Serialize(
+      *MakeTable(), CPDF_CrossRefCache::ParserState(), file.Get());
+  ASSERT_FALSE(data.empty());
+
+  CPDF_IndirectObjectHolder holder;
+  CPDF_CrossRefCache::ParserState state;
+  EXPECT_FALSE(
+      CPDF_CrossRefCache::Deserialize({}, file.Get(), &holder, &state));
+
+  // Truncated.
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(
+      pdfium::span(data).first(data.size() - 1), file.Get(), &holder,
+      &state));
+
+  // Trailing data.
+  DataVector<uint8_t> longer_data = data;
+  longer_data.push_back(0);
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(longer_data, file.Get(),
+                                               &holder, &state));
+
+  // Unknown version.
+  DataVector<uint8_t> other_version = data;
+  other_version[11] = 3;
+  EXPECT_FALSE(CPDF_CrossRefCache::Deserialize(other_version, file.Get(),
+                                               &holder, &state));
+
+  // Object type of the last entry out of range. Each entry takes 16 bytes,
+  // with the type after the object number.
+  DataVector<uint8_t> bad_type = data;
+  bad_type[bad_type.size() - 12] = 3;
+  EXPECT_FALSE(
+      CPDF_CrossRefCache::Deserialize(bad_type, file.Get(), &holder, &state));
+
+  // Object position past the end of the file.
+  DataVector<uint8_t> bad_pos = data;
+  bad_pos[bad_pos.size() - 2] = 1;
+  EXPECT_FALSE(
+      CPDF_CrossRefCache::Deserialize(bad_pos, file.Get(), &holder, &state));
+
+  EXPECT_TRUE(
+      CPDF_CrossRefCache::Deserialize(data, file.Get(), &holder, &state));
+}
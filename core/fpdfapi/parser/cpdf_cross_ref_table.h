@@ -48,6 +48,10 @@ class CPDF_CrossRefTable {
   CPDF_CrossRefTable();
   CPDF_CrossRefTable(RetainPtr<CPDF_Dictionary> trailer,
                      uint32_t trailer_object_number);
+  // Restores a table from the objects_info() of another one.
+  CPDF_CrossRefTable(RetainPtr<CPDF_Dictionary> trailer,
+                     uint32_t trailer_object_number,
+                     std::map<uint32_t, ObjectInfo> objects_info);
   ~CPDF_CrossRefTable();
 
   void AddCompressed(uint32_t obj_num,
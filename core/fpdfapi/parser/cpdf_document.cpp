@@ -223,6 +223,18 @@ CPDF_Parser::Error CPDF_Document::LoadDoc(
       parser_->StartParse(std::move(pFileAccess), password));
 }
 
+CPDF_Parser::Error CPDF_Document::LoadDocWithCrossRefCache(
+    RetainPtr<IFX_SeekableReadStream> pFileAccess,
+    const ByteString& password,
+    pdfium::span<const uint8_t> cross_ref_cache) {
+  if (!parser_) {
+    SetParser(std::make_unique<CPDF_Parser>(this));
+  }
+
+  return HandleLoadResult(parser_->StartParseWithCrossRefCache(
+      std::move(pFileAccess), password, cross_ref_cache));
+}
+
 CPDF_Parser::Error CPDF_Document::LoadLinearizedDoc(
     RetainPtr<CPDF_ReadValidator> validator,
     const ByteString& password) {
@@ -149,6 +149,11 @@ class CPDF_Document : public Observable,
 
   CPDF_Parser::Error LoadDoc(RetainPtr<IFX_SeekableReadStream> pFileAccess,
                              const ByteString& password);
+  // See CPDF_Parser::StartParseWithCrossRefCache().
+  CPDF_Parser::Error LoadDocWithCrossRefCache(
+      RetainPtr<IFX_SeekableReadStream> pFileAccess,
+      const ByteString& password,
+      pdfium::span<const uint8_t> cross_ref_cache);
   CPDF_Parser::Error LoadLinearizedDoc(RetainPtr<CPDF_ReadValidator> validator,
                                        const ByteString& password);
   bool has_valid_cross_reference_table() const {
@@ -15,21 +15,34 @@
 #include "core/fpdfapi/parser/cpdf_syntax_parser.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fxcrt/cfx_read_only_span_stream.h"
-#include "core/fxcrt/check.h"
+#include "core/fxcrt/cfx_read_only_vector_stream.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/ptr_util.h"
 
-namespace {
+//  static
+std::unique_ptr<CPDF_ObjectStream> CPDF_ObjectStream::Create(
+    RetainPtr<const CPDF_Stream> stream) {
+  std::optional<Params> params = GetParams(stream.Get());
+  if (!params.has_value()) {
+    return nullptr;
+  }
+
+  // Protected constructor.
+  return pdfium::WrapUnique(
+      new CPDF_ObjectStream(std::move(stream), params.value()));
+}
 
-bool IsObjectStream(const CPDF_Stream* stream) {
+// static
+std::optional<CPDF_ObjectStream::Params> CPDF_ObjectStream::GetParams(
+    const CPDF_Stream* stream) {
   if (!stream) {
-    return false;
+    return std::nullopt;
   }
 
   // See ISO 32000-1:2008 spec, table 16.
   RetainPtr<const CPDF_Dictionary> stream_dict = stream->GetDict();
   if (!ValidateDictType(stream_dict.Get(), "ObjStm")) {
-    return false;
+    return std::nullopt;
   }
 
   RetainPtr<const CPDF_Number> number_of_objects =
@@ -38,37 +51,45 @@ bool IsObjectStream(const CPDF_Stream* stream) {
       number_of_objects->GetInteger() < 0 ||
       number_of_objects->GetInteger() >
           static_cast<int>(CPDF_Parser::kMaxObjectNumber)) {
-    return false;
+    return std::nullopt;
   }
 
   RetainPtr<const CPDF_Number> first_object_offset =
       stream_dict->GetNumberFor("First");
   if (!first_object_offset || !first_object_offset->IsInteger() ||
       first_object_offset->GetInteger() < 0) {
-    return false;
+    return std::nullopt;
   }
 
-  return true;
+  return Params{.object_count = number_of_objects->GetInteger(),
+                .first_object_offset = first_object_offset->GetInteger()};
 }
 
-}  // namespace
-
-//  static
-std::unique_ptr<CPDF_ObjectStream> CPDF_ObjectStream::Create(
-    RetainPtr<const CPDF_Stream> stream) {
-  if (!IsObjectStream(stream.Get())) {
-    return nullptr;
-  }
-
+// static
+std::unique_ptr<CPDF_ObjectStream> CPDF_ObjectStream::CreateFromDecodedData(
+    DataVector<uint8_t> decoded_data,
+    const Params& params) {
   // Protected constructor.
-  return pdfium::WrapUnique(new CPDF_ObjectStream(std::move(stream)));
+  return pdfium::WrapUnique(
+      new CPDF_ObjectStream(std::move(decoded_data), params));
+}
+
+CPDF_ObjectStream::CPDF_ObjectStream(RetainPtr<const CPDF_Stream> obj_stream,
+                                     const Params& params)
+    : stream_acc_(pdfium::MakeRetain<CPDF_StreamAcc>(std::move(obj_stream))),
+      first_object_offset_(params.first_object_offset) {
+  stream_acc_->LoadAllDataFiltered();
+  data_stream_ =
+      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(stream_acc_->GetSpan());
+  Init(params.object_count);
 }
 
-CPDF_ObjectStream::CPDF_ObjectStream(RetainPtr<const CPDF_Stream> obj_stream)
-    : stream_acc_(pdfium::MakeRetain<CPDF_StreamAcc>(obj_stream)),
-      first_object_offset_(obj_stream->GetDict()->GetIntegerFor("First")) {
-  DCHECK(IsObjectStream(obj_stream.Get()));
-  Init(obj_stream.Get());
+CPDF_ObjectStream::CPDF_ObjectStream(DataVector<uint8_t> decoded_data,
+                                     const Params& params)
+    : data_stream_(pdfium::MakeRetain<CFX_ReadOnlyVectorStream>(
+          std::move(decoded_data))),
+      first_object_offset_(params.first_object_offset) {
+  Init(params.object_count);
 }
 
 CPDF_ObjectStream::~CPDF_ObjectStream() = default;
@@ -94,13 +115,8 @@ RetainPtr<CPDF_Object> CPDF_ObjectStream::ParseObject(
   return result;
 }
 
-void CPDF_ObjectStream::Init(const CPDF_Stream* stream) {
-  stream_acc_->LoadAllDataFiltered();
-  data_stream_ =
-      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(stream_acc_->GetSpan());
-
+void CPDF_ObjectStream::Init(int object_count) {
   CPDF_SyntaxParser syntax(data_stream_);
-  const int object_count = stream->GetDict()->GetIntegerFor("N");
   for (int32_t i = object_count; i > 0; --i) {
     if (syntax.GetPos() >= data_stream_->GetSize()) {
       break;
@@ -6,9 +6,11 @@
 #define CORE_FPDFAPI_PARSER_CPDF_OBJECT_STREAM_H_
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "core/fpdfapi/parser/cpdf_object.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
 
 class CPDF_IndirectObjectHolder;
@@ -31,9 +33,25 @@ class CPDF_ObjectStream {
     uint32_t obj_offset;
   };
 
+  // The /N and /First entries of an object stream's dictionary.
+  struct Params {
+    int object_count;
+    int first_object_offset;
+  };
+
   static std::unique_ptr<CPDF_ObjectStream> Create(
       RetainPtr<const CPDF_Stream> stream);
 
+  // Returns std::nullopt if `stream` is not an object stream.
+  static std::optional<Params> GetParams(const CPDF_Stream* stream);
+
+  // Creates an object stream from contents that the caller already decoded,
+  // for a stream with `params`. Only touches `decoded_data`, so it may be
+  // called off the main thread.
+  static std::unique_ptr<CPDF_ObjectStream> CreateFromDecodedData(
+      DataVector<uint8_t> decoded_data,
+      const Params& params);
+
   ~CPDF_ObjectStream();
 
   RetainPtr<CPDF_Object> ParseObject(CPDF_IndirectObjectHolder* pObjList,
@@ -42,14 +60,15 @@ class CPDF_ObjectStream {
   const std::vector<ObjectInfo>& object_info() const { return object_info_; }
 
  private:
-  explicit CPDF_ObjectStream(RetainPtr<const CPDF_Stream> stream);
+  CPDF_ObjectStream(RetainPtr<const CPDF_Stream> stream, const Params& params);
+  CPDF_ObjectStream(DataVector<uint8_t> decoded_data, const Params& params);
 
-  void Init(const CPDF_Stream* stream);
+  void Init(int object_count);
   RetainPtr<CPDF_Object> ParseObjectAtOffset(
       CPDF_IndirectObjectHolder* pObjList,
       uint32_t object_offset) const;
 
-  // Must outlive `data_stream_`.
+  // Must outlive `data_stream_`. Null when created from decoded data.
   RetainPtr<CPDF_StreamAcc> const stream_acc_;
   RetainPtr<IFX_SeekableReadStream> data_stream_;
   int first_object_offset_ = 0;
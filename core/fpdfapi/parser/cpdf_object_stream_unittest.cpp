@@ -5,6 +5,7 @@
 #include "core/fpdfapi/parser/cpdf_object_stream.h"
 
 #include <iterator>
+#include <optional>
 #include <utility>
 
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
@@ -80,6 +81,42 @@ TEST(ObjectStreamTest, StreamDictNormal) {
   EXPECT_FALSE(obj_stream->ParseObject(&holder, 12, 3));
 }
 
+TEST(ObjectStreamTest, CreateFromDecodedData) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Name>("Type", "ObjStm");
+  dict->SetNewFor<CPDF_Number>("N", 3);
+  dict->SetNewFor<CPDF_Number>("First", kNormalStreamContentOffset);
+
+  ByteStringView contents_view(kNormalStreamContent);
+  DataVector<uint8_t> contents(contents_view.begin(), contents_view.end());
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(contents, dict);
+  std::optional<CPDF_ObjectStream::Params> params =
+      CPDF_ObjectStream::GetParams(stream.Get());
+  ASSERT_TRUE(params.has_value());
+  EXPECT_EQ(3, params.value().object_count);
+  EXPECT_EQ(kNormalStreamContentOffset, params.value().first_object_offset);
+
+  auto obj_stream = CPDF_ObjectStream::CreateFromDecodedData(
+      std::move(contents), params.value());
+  ASSERT_TRUE(obj_stream);
+  EXPECT_THAT(obj_stream->object_info(),
+              ElementsAre(CPDF_ObjectStream::ObjectInfo(10, 0),
+                          CPDF_ObjectStream::ObjectInfo(11, 14),
+                          CPDF_ObjectStream::ObjectInfo(12, 21)));
+
+  CPDF_IndirectObjectHolder holder;
+  RetainPtr<CPDF_Object> obj10 = obj_stream->ParseObject(&holder, 10, 0);
+  ASSERT_TRUE(obj10);
+  EXPECT_EQ(10u, obj10->GetObjNum());
+  EXPECT_TRUE(obj10->IsDictionary());
+
+  RetainPtr<CPDF_Object> obj12 = obj_stream->ParseObject(&holder, 12, 2);
+  ASSERT_TRUE(obj12);
+  EXPECT_EQ(12u, obj12->GetObjNum());
+  EXPECT_TRUE(obj12->IsNumber());
+  EXPECT_FALSE(obj_stream->ParseObject(&holder, 11, 2));
+}
+
 TEST(ObjectStreamTest, StreamEmptyDict) {
   ByteStringView contents_view(kNormalStreamContent);
   auto stream = pdfium::MakeRetain<CPDF_Stream>(
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_cross_ref_cache.h"
 #include "core/fpdfapi/parser/cpdf_crypto_handler.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
@@ -26,6 +27,7 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fpdfapi/parser/cpdf_syntax_parser.h"
+#include "core/fpdfapi/parser/fpdf_parser_decode.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fxcrt/autorestorer.h"
 #include "core/fxcrt/check.h"
@@ -38,6 +40,7 @@
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/scoped_set_insertion.h"
 #include "core/fxcrt/span.h"
+#include "core/fxcrt/thread_pool.h"
 
 using ObjectType = CPDF_CrossRefTable::ObjectType;
 using ObjectInfo = CPDF_CrossRefTable::ObjectInfo;
@@ -59,6 +62,68 @@ constexpr size_t kMinFieldCount = 3;
 // Trailers are inline.
 constexpr uint32_t kNoTrailerObjectNumber = 0;
 
+// Hints that `validator` is read front to back for as long as this exists.
+class ScopedSequentialAccess {
+ public:
+  explicit ScopedSequentialAccess(RetainPtr<CPDF_ReadValidator> validator)
+      : validator_(std::move(validator)) {
+    validator_->SetAccessPattern(
+        IFX_SeekableReadStream::AccessPattern::kSequential);
+  }
+  ~ScopedSequentialAccess() {
+    validator_->SetAccessPattern(
+        IFX_SeekableReadStream::AccessPattern::kNormal);
+  }
+
+ private:
+  RetainPtr<CPDF_ReadValidator> const validator_;
+};
+
+// An object stream for PreloadObjectStreams() to decode. Workers only read
+// `raw_acc`'s data and `decode_params`, and set `result`. Reference counts are
+// not thread-safe, so `decode_params` is a copy that shares nothing with the
+// document.
+struct ObjectStreamPreloadJob {
+  uint32_t obj_num;
+  CPDF_ObjectStream::Params params;
+  RetainPtr<CPDF_StreamAcc> raw_acc;
+  RetainPtr<const CPDF_Dictionary> decode_params;
+  std::unique_ptr<CPDF_ObjectStream> result;
+};
+
+// Copies the entries of `params` that FlateOrLZWDecode() reads, resolving
+// references on the calling thread.
+RetainPtr<const CPDF_Dictionary> CopyFlateDecodeParams(
+    const CPDF_Dictionary* params) {
+  if (!params) {
+    return nullptr;
+  }
+
+  auto copy = pdfium::MakeRetain<CPDF_Dictionary>();
+  for (const char* key :
+       {"Predictor", "EarlyChange", "Colors", "BitsPerComponent", "Columns"}) {
+    RetainPtr<const CPDF_Object> value = params->GetObjectFor(key);
+    if (value) {
+      copy->SetNewFor<CPDF_Number>(key, value->GetInteger());
+    }
+  }
+  return copy;
+}
+
+// Matches what CPDF_StreamAcc::LoadAllDataFiltered() produces for a
+// FlateDecode stream, which falls back to the raw data when decoding fails.
+void RunObjectStreamPreloadJob(ObjectStreamPreloadJob& job) {
+  pdfium::span<const uint8_t> raw_data = job.raw_acc->GetSpan();
+  fxcodec::DataAndBytesConsumed decoded = FlateOrLZWDecode(
+      /*use_lzw=*/false, raw_data, job.decode_params.Get(),
+      /*estimated_size=*/0);
+  if (decoded.bytes_consumed == FX_INVALID_OFFSET || decoded.data.empty()) {
+    decoded.data = DataVector<uint8_t>(raw_data.begin(), raw_data.end());
+  }
+  job.result = CPDF_ObjectStream::CreateFromDecodedData(
+      std::move(decoded.data), job.params);
+}
+
 struct CrossRefStreamIndexEntry {
   uint32_t start_obj_num;
   uint32_t obj_count;
@@ -207,6 +272,9 @@ bool CPDF_Parser::InitSyntaxParser(RetainPtr<CPDF_ReadValidator> validator) {
 
   syntax_ = std::make_unique<CPDF_SyntaxParser>(std::move(validator),
                                                 header_offset.value());
+  // Embedders keep in-memory documents valid until they close them, and
+  // memory-mapped files are retained by the streams that refer to them.
+  syntax_->SetShareInMemoryStreamData(true);
   return ParseFileVersion();
 }
 
@@ -236,36 +304,64 @@ bool CPDF_Parser::ParseFileVersion() {
 CPDF_Parser::Error CPDF_Parser::StartParse(
     RetainPtr<IFX_SeekableReadStream> pFileAccess,
     const ByteString& password) {
+  return StartParseWithCrossRefCache(std::move(pFileAccess), password,
+                                     pdfium::span<const uint8_t>());
+}
+
+CPDF_Parser::Error CPDF_Parser::StartParseWithCrossRefCache(
+    RetainPtr<IFX_SeekableReadStream> pFileAccess,
+    const ByteString& password,
+    pdfium::span<const uint8_t> cross_ref_cache) {
   if (!InitSyntaxParser(pdfium::MakeRetain<CPDF_ReadValidator>(
           std::move(pFileAccess), nullptr))) {
     return FORMAT_ERROR;
   }
   SetPassword(password);
-  return StartParseInternal();
+  return StartParseInternalWithCrossRefCache(cross_ref_cache);
+}
+
+DataVector<uint8_t> CPDF_Parser::GetCrossRefCache() const {
+  if (!has_parsed_ || linearized_ || !syntax_) {
+    return DataVector<uint8_t>();
+  }
+
+  CPDF_CrossRefCache::ParserState state;
+  state.last_xref_offset = last_xref_offset_;
+  state.xref_stream = xref_stream_;
+  state.xref_table_rebuilt = xref_table_rebuilt_;
+  return CPDF_CrossRefCache::Serialize(*cross_ref_table_, state,
+                                       syntax_->GetValidator().Get());
 }
 
 CPDF_Parser::Error CPDF_Parser::StartParseInternal() {
+  return StartParseInternalWithCrossRefCache({});
+}
+
+CPDF_Parser::Error CPDF_Parser::StartParseInternalWithCrossRefCache(
+    pdfium::span<const uint8_t> cross_ref_cache) {
   DCHECK(!has_parsed_);
   DCHECK(!xref_table_rebuilt_);
   has_parsed_ = true;
   xref_stream_ = false;
 
-  last_xref_offset_ = ParseStartXRef();
-  if (last_xref_offset_ >= kPDFHeaderSize) {
-    if (!LoadAllCrossRefTablesAndStreams(last_xref_offset_)) {
+  if (!LoadCrossRefCache(cross_ref_cache)) {
+    last_xref_offset_ = ParseStartXRef();
+    if (last_xref_offset_ >= kPDFHeaderSize) {
+      if (!LoadAllCrossRefTablesAndStreams(last_xref_offset_)) {
+        if (!RebuildCrossRef()) {
+          return FORMAT_ERROR;
+        }
+
+        xref_table_rebuilt_ = true;
+        last_xref_offset_ = 0;
+      }
+    } else {
       if (!RebuildCrossRef()) {
         return FORMAT_ERROR;
       }
 
       xref_table_rebuilt_ = true;
-      last_xref_offset_ = 0;
-    }
-  } else {
-    if (!RebuildCrossRef()) {
-      return FORMAT_ERROR;
     }
-
-    xref_table_rebuilt_ = true;
   }
   Error eRet = SetEncryptHandler();
   if (eRet != SUCCESS) {
@@ -313,6 +409,84 @@ CPDF_Parser::Error CPDF_Parser::StartParseInternal() {
   return SUCCESS;
 }
 
+bool CPDF_Parser::LoadCrossRefCache(
+    pdfium::span<const uint8_t> cross_ref_cache) {
+  if (cross_ref_cache.empty()) {
+    return false;
+  }
+
+  CPDF_CrossRefCache::ParserState state;
+  std::unique_ptr<CPDF_CrossRefTable> cross_ref_table =
+      CPDF_CrossRefCache::Deserialize(cross_ref_cache,
+                                      syntax_->GetValidator().Get(),
+                                      objects_holder_, &state);
+  if (!cross_ref_table) {
+    return false;
+  }
+
+  cross_ref_table_ = std::move(cross_ref_table);
+  cross_ref_table_from_cache_ = true;
+  last_xref_offset_ = state.last_xref_offset;
+  xref_stream_ = state.xref_stream;
+  xref_table_rebuilt_ = state.xref_table_rebuilt;
+  return true;
+}
+
+bool CPDF_Parser::VerifyCachedObjectHeader(uint32_t objnum) {
+  if (!cross_ref_table_from_cache_) {
+    return true;
+  }
+
+  const auto* info = cross_ref_table_->GetObjectInfo(objnum);
+  if (info && info->type == ObjectType::kCompressed) {
+    objnum = info->archive.obj_num;
+    info = cross_ref_table_->GetObjectInfo(objnum);
+  }
+  if (!info || info->type != ObjectType::kNormal || info->pos <= 0 ||
+      pdfium::Contains(verified_cached_obj_nums_, objnum)) {
+    return true;
+  }
+
+  const FX_FILESIZE saved_pos = syntax_->GetPos();
+  syntax_->SetPos(info->pos);
+  const CPDF_SyntaxParser::WordResult objnum_result = syntax_->GetNextWord();
+  const CPDF_SyntaxParser::WordResult gennum_result = syntax_->GetNextWord();
+  const bool matches =
+      objnum_result.is_number && gennum_result.is_number &&
+      FXSYS_atoui(objnum_result.word.c_str()) == objnum &&
+      FXSYS_atoui(gennum_result.word.c_str()) == info->gennum &&
+      syntax_->GetKeyword() == "obj";
+  syntax_->SetPos(saved_pos);
+  if (matches) {
+    verified_cached_obj_nums_.insert(objnum);
+  }
+  return matches;
+}
+
+void CPDF_Parser::DropCrossRefCache() {
+  dropped_cross_ref_table_ = std::move(cross_ref_table_);
+  cross_ref_table_ = std::make_unique<CPDF_CrossRefTable>();
+  cross_ref_table_from_cache_ = false;
+  verified_cached_obj_nums_.clear();
+  // Object streams already loaded passed VerifyCachedObjectHeader(), but the
+  // file's table may place objects in other streams.
+  object_stream_map_.clear();
+  xref_stream_ = false;
+  xref_table_rebuilt_ = false;
+  // This can happen in the middle of parsing another object, such as a stream
+  // whose /Length refers to an object.
+  const FX_FILESIZE saved_pos = syntax_->GetPos();
+  last_xref_offset_ = ParseStartXRef();
+  if (last_xref_offset_ < kPDFHeaderSize ||
+      !LoadAllCrossRefTablesAndStreams(last_xref_offset_)) {
+    cross_ref_table_ = std::make_unique<CPDF_CrossRefTable>();
+    RebuildCrossRef();
+    xref_table_rebuilt_ = true;
+    last_xref_offset_ = 0;
+  }
+  syntax_->SetPos(saved_pos);
+}
+
 FX_FILESIZE CPDF_Parser::ParseStartXRef() {
   static constexpr auto kStartXRefKeyword =
       pdfium::span_from_cstring("startxref");
@@ -759,6 +933,8 @@ bool CPDF_Parser::RebuildCrossRef() {
   const uint32_t kBufferSize = 4096;
   syntax_->SetReadBufferSize(kBufferSize);
   syntax_->SetPos(0);
+  // The scan below reads the whole file front to back.
+  ScopedSequentialAccess sequential_access(syntax_->GetValidator());
 
   std::vector<std::pair<uint32_t, FX_FILESIZE>> numbers;
   for (CPDF_SyntaxParser::WordResult result = syntax_->GetNextWord();
@@ -1077,6 +1253,9 @@ RetainPtr<CPDF_Object> CPDF_Parser::ParseIndirectObject(uint32_t objnum) {
   }
 
   ScopedSetInsertion local_insert(&parsing_obj_nums_, objnum);
+  if (!VerifyCachedObjectHeader(objnum)) {
+    DropCrossRefCache();
+  }
   const auto* info = cross_ref_table_->GetObjectInfo(objnum);
   if (!info) {
     return nullptr;
@@ -1114,6 +1293,9 @@ const CPDF_ObjectStream* CPDF_Parser::GetObjectStream(uint32_t object_number) {
     return it->second.get();
   }
 
+  if (!VerifyCachedObjectHeader(object_number)) {
+    DropCrossRefCache();
+  }
   const auto* info = cross_ref_table_->GetObjectInfo(object_number);
   if (!info || !info->is_object_stream_flag) {
     return nullptr;
@@ -1141,6 +1323,68 @@ const CPDF_ObjectStream* CPDF_Parser::GetObjectStream(uint32_t object_number) {
   return result;
 }
 
+size_t CPDF_Parser::PreloadObjectStreams() {
+  if (!cross_ref_table_ || !syntax_) {
+    return 0;
+  }
+
+  // Parsing the stream objects and reading their dictionaries touches the
+  // document, so it happens here. Only the decoding and indexing are spread
+  // over worker threads.
+  std::vector<ObjectStreamPreloadJob> jobs;
+  for (const auto& [obj_num, info] : cross_ref_table_->objects_info()) {
+    if (info.type != ObjectType::kNormal || !info.is_object_stream_flag ||
+        info.pos <= 0 || pdfium::Contains(object_stream_map_, obj_num) ||
+        !VerifyCachedObjectHeader(obj_num)) {
+      continue;
+    }
+
+    RetainPtr<const CPDF_Stream> stream;
+    {
+      ScopedSetInsertion local_insert(&parsing_obj_nums_, obj_num);
+      stream = ToStream(ParseIndirectObjectAt(info.pos, obj_num));
+    }
+    std::optional<CPDF_ObjectStream::Params> params =
+        CPDF_ObjectStream::GetParams(stream.Get());
+    if (!params.has_value()) {
+      continue;
+    }
+
+    // Other filters are rare in object streams. Leave those for
+    // GetObjectStream() to load on first use.
+    std::optional<DecoderArray> decoders = GetDecoderArray(stream->GetDict());
+    if (!decoders.has_value() || decoders.value().size() != 1 ||
+        (decoders.value()[0].first != "FlateDecode" &&
+         decoders.value()[0].first != "Fl")) {
+      continue;
+    }
+
+    auto raw_acc = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(stream));
+    raw_acc->LoadAllDataRaw();
+    if (raw_acc->GetSize() == 0) {
+      continue;
+    }
+
+    jobs.push_back({.obj_num = obj_num,
+                    .params = params.value(),
+                    .raw_acc = std::move(raw_acc),
+                    .decode_params = CopyFlateDecodeParams(
+                        ToDictionary(decoders.value()[0].second).Get())});
+  }
+  if (jobs.empty()) {
+    return 0;
+  }
+
+  ThreadPool::ParallelFor(jobs.size(), [&jobs](size_t i) {
+    RunObjectStreamPreloadJob(jobs[i]);
+  });
+
+  for (ObjectStreamPreloadJob& job : jobs) {
+    object_stream_map_[job.obj_num] = std::move(job.result);
+  }
+  return jobs.size();
+}
+
 RetainPtr<CPDF_Object> CPDF_Parser::ParseIndirectObjectAt(FX_FILESIZE pos,
                                                           uint32_t objnum) {
   const FX_FILESIZE saved_pos = syntax_->GetPos();
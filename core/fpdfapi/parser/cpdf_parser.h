@@ -19,8 +19,10 @@
 #include "core/fpdfapi/parser/cpdf_cross_ref_table.h"
 #include "core/fpdfapi/parser/cpdf_indirect_object_holder.h"
 #include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_types.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 
 class CPDF_Array;
@@ -74,6 +76,19 @@ class CPDF_Parser {
   Error StartLinearizedParse(RetainPtr<CPDF_ReadValidator> validator,
                              const ByteString& password);
 
+  // Like StartParse(), but first tries to restore the cross reference table
+  // from `cross_ref_cache`, as returned by GetCrossRefCache() for the same
+  // file. Parses the file as usual when the cache does not match it.
+  Error StartParseWithCrossRefCache(
+      RetainPtr<IFX_SeekableReadStream> pFile,
+      const ByteString& password,
+      pdfium::span<const uint8_t> cross_ref_cache);
+
+  // Returns the data StartParseWithCrossRefCache() takes, or an empty vector
+  // if parsing has not succeeded or the cross reference tables of a
+  // linearized file have only been partially loaded.
+  DataVector<uint8_t> GetCrossRefCache() const;
+
   ByteString GetPassword() const { return password_; }
 
   // Take the GetPassword() value and encode it, if necessary, based on the
@@ -97,6 +112,11 @@ class CPDF_Parser {
 
   RetainPtr<CPDF_Object> ParseIndirectObject(uint32_t objnum);
 
+  // Decodes and indexes all FlateDecode object streams that have not been
+  // loaded yet, spreading the decoding over the thread pool. Object streams
+  // are otherwise loaded on first use. Returns how many were loaded.
+  size_t PreloadObjectStreams();
+
   uint32_t GetLastObjNum() const;
   bool IsValidObjectNumber(uint32_t objnum) const;
   FX_FILESIZE GetObjectPositionOrZero(uint32_t objnum) const;
@@ -136,6 +156,8 @@ class CPDF_Parser {
   bool LoadCrossRefTable(FX_FILESIZE pos, bool skip);
   bool RebuildCrossRef();
   Error StartParseInternal();
+  Error StartParseInternalWithCrossRefCache(
+      pdfium::span<const uint8_t> cross_ref_cache);
   FX_FILESIZE ParseStartXRef();
   std::unique_ptr<CPDF_LinearizedHeader> ParseLinearizedHeader();
 
@@ -149,6 +171,7 @@ class CPDF_Parser {
     CPDF_CrossRefTable::ObjectInfo info;
   };
 
+  bool LoadCrossRefCache(pdfium::span<const uint8_t> cross_ref_cache);
   bool LoadAllCrossRefTablesAndStreams(FX_FILESIZE xref_offset);
   bool FindAllCrossReferenceTablesAndStream(
       FX_FILESIZE main_xref_offset,
@@ -166,6 +189,15 @@ class CPDF_Parser {
   Error LoadLinearizedMainXRefTable();
 
   const CPDF_ObjectStream* GetObjectStream(uint32_t object_number);
+
+  // Returns false if `cross_ref_table_` came from a cross reference cache, and
+  // the "objnum gennum obj" header of `objnum`, or of the object stream that
+  // holds it, is not where the table says. Each object is checked once.
+  bool VerifyCachedObjectHeader(uint32_t objnum);
+
+  // Replaces a table from a cross reference cache with the file's own, or a
+  // rebuilt one.
+  void DropCrossRefCache();
   RetainPtr<const CPDF_Dictionary> GetRoot() const;
 
   // A simple check whether the cross reference table matches with
@@ -200,6 +232,13 @@ class CPDF_Parser {
   // cross_ref_table_ must be destroyed after security_handler_ due to the
   // ownership of the ID array data.
   std::unique_ptr<CPDF_CrossRefTable> cross_ref_table_;
+  // The table DropCrossRefCache() replaced. Its trailer may still be in use.
+  std::unique_ptr<CPDF_CrossRefTable> dropped_cross_ref_table_;
+  // Set while `cross_ref_table_` came from a cross reference cache. The cache
+  // is only checked against parts of the file, so the objects it locates are
+  // checked as they are first parsed.
+  bool cross_ref_table_from_cache_ = false;
+  std::set<uint32_t> verified_cached_obj_nums_;
   FX_FILESIZE last_xref_offset_ = 0;
   ByteString password_;
   std::unique_ptr<CPDF_LinearizedHeader> linearized_;
@@ -12,14 +12,19 @@
 #include <utility>
 #include <vector>
 
+#include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_cross_ref_cache.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_linearized_header.h"
 #include "core/fpdfapi/parser/cpdf_object.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
 #include "core/fpdfapi/parser/cpdf_syntax_parser.h"
 #include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/fx_stream.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/stl_util.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/utils/path_service.h"
@@ -98,6 +103,32 @@ std::ostream& operator<<(std::ostream& os,
   return os;
 }
 
+// Reads from a buffer, and records the access pattern hints it gets.
+class AccessPatternRecordingStream final : public IFX_SeekableReadStream {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  // IFX_SeekableReadStream:
+  FX_FILESIZE GetSize() override { return stream_->GetSize(); }
+  bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                         FX_FILESIZE offset) override {
+    return stream_->ReadBlockAtOffset(buffer, offset);
+  }
+  void SetAccessPattern(AccessPattern pattern) override {
+    patterns_.push_back(pattern);
+  }
+
+  const std::vector<AccessPattern>& patterns() const { return patterns_; }
+
+ private:
+  explicit AccessPatternRecordingStream(pdfium::span<const uint8_t> data)
+      : stream_(pdfium::MakeRetain<CFX_ReadOnlySpanStream>(data)) {}
+  ~AccessPatternRecordingStream() override = default;
+
+  RetainPtr<CFX_ReadOnlySpanStream> const stream_;
+  std::vector<AccessPattern> patterns_;
+};
+
 // A wrapper class to help test member functions of CPDF_Parser.
 class CPDF_TestParser final : public CPDF_Parser {
  public:
@@ -130,12 +161,18 @@ class CPDF_TestParser final : public CPDF_Parser {
     return InitTestFromBufferWithOffset(buffer, 0 /*header_offset*/);
   }
 
+  void InitTestFromStream(RetainPtr<IFX_SeekableReadStream> stream) {
+    SetSyntaxParserForTesting(
+        CPDF_SyntaxParser::CreateForTesting(std::move(stream), 0));
+  }
+
   // Expose protected CPDF_Parser methods for testing.
   using CPDF_Parser::LoadCrossRefTable;
   using CPDF_Parser::ParseLinearizedHeader;
   using CPDF_Parser::ParseStartXRef;
   using CPDF_Parser::RebuildCrossRef;
   using CPDF_Parser::StartParseInternal;
+  using CPDF_Parser::StartParseInternalWithCrossRefCache;
 
   TestObjectsHolder& object_holder() { return object_holder_; }
 
@@ -177,6 +214,21 @@ TEST(ParserTest, RebuildCrossRefFailed) {
   ASSERT_FALSE(parser.RebuildCrossRef());
 }
 
+TEST(ParserTest, RebuildCrossRefRestoresAccessPattern) {
+  static const char kData[] = "1 0 obj\n<< /Type /Catalog >>\nendobj\n";
+  auto stream = pdfium::MakeRetain<AccessPatternRecordingStream>(
+      pdfium::as_byte_span(kData));
+  CPDF_TestParser parser;
+  parser.InitTestFromStream(stream);
+
+  // Fails for lack of a trailer, and still goes back to normal access.
+  ASSERT_FALSE(parser.RebuildCrossRef());
+  EXPECT_THAT(
+      stream->patterns(),
+      ElementsAre(IFX_SeekableReadStream::AccessPattern::kSequential,
+                  IFX_SeekableReadStream::AccessPattern::kNormal));
+}
+
 TEST(ParserTest, LoadCrossRefTable) {
   {
     static const unsigned char kXrefTable[] =
@@ -848,3 +900,269 @@ TEST_F(ParserXRefTest, XrefWithIndexAndWrongSize) {
                                         Pair(80, expected_result[1]),
                                         Pair(81, expected_result[2])));
 }
+
+TEST_F(ParserXRefTest, XrefFromCrossRefCache) {
+  const unsigned char kData[] =
+      "%PDF1-7\n%\xa0\xf2\xa4\xf4\n"
+      "7 0 obj <<\n"
+      "  /Filter /ASCIIHexDecode\n"
+      "  /Root 1 0 R\n"
+      "  /Size 3\n"
+      "  /W [1 1 1]\n"
+      ">>\n"
+      "stream\n"
+      "01 00 00\n"
+      "01 0F 00\n"
+      "01 12 00\n"
+      "endstream\n"
+      "endobj\n"
+      "startxref\n"
+      "14\n"
+      "%%EOF\n";
+
+  // Use a table that differs from the one in `kData`, to tell them apart.
+  auto trailer = pdfium::MakeRetain<CPDF_Dictionary>();
+  trailer->SetNewFor<CPDF_Reference>("Root", nullptr, 1);
+  CPDF_CrossRefTable table(std::move(trailer), /*trailer_object_number=*/7);
+  table.AddNormal(1, 0, false, 15);
+  table.AddNormal(5, 0, false, 18);
+  const CPDF_CrossRefCache::ParserState state = {.last_xref_offset = 14,
+                                                 .xref_stream = true};
+  DataVector<uint8_t> cache = CPDF_CrossRefCache::Serialize(
+      table, state, pdfium::MakeRetain<CFX_ReadOnlySpanStream>(kData).Get());
+  ASSERT_FALSE(cache.empty());
+
+  ASSERT_TRUE(parser().InitTestFromBuffer(kData));
+  EXPECT_EQ(CPDF_Parser::SUCCESS,
+            parser().StartParseInternalWithCrossRefCache(cache));
+  EXPECT_FALSE(parser().xref_table_rebuilt());
+  EXPECT_TRUE(parser().IsXRefStream());
+  EXPECT_EQ(14, parser().GetLastXRefOffset());
+  EXPECT_EQ(7u, parser().GetTrailerObjectNumber());
+
+  const CPDF_CrossRefTable::ObjectInfo expected_result[2] = {
+      {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 15},
+      {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 18}};
+  EXPECT_THAT(parser().GetCrossRefTableForTesting()->objects_info(),
+              ElementsAre(Pair(1, expected_result[0]),
+                          Pair(5, expected_result[1])));
+  EXPECT_EQ(cache, parser().GetCrossRefCache());
+}
+
+TEST_F(ParserXRefTest, XrefIgnoresStaleCrossRefCache) {
+  const unsigned char kData[] =
+      "%PDF1-7\n%\xa0\xf2\xa4\xf4\n"
+      "7 0 obj <<\n"
+      "  /Filter /ASCIIHexDecode\n"
+      "  /Root 1 0 R\n"
+      "  /Size 3\n"
+      "  /W [1 1 1]\n"
+      ">>\n"
+      "stream\n"
+      "01 00 00\n"
+      "01 0F 00\n"
+      "01 12 00\n"
+      "endstream\n"
+      "endobj\n"
+      "startxref\n"
+      "14\n"
+      "%%EOF\n";
+  // Same size, but the comment on the second line differs.
+  unsigned char other_data[sizeof(kData)];
+  fxcrt::Copy(kData, other_data);
+  other_data[9] = 0xa1;
+
+  auto trailer = pdfium::MakeRetain<CPDF_Dictionary>();
+  trailer->SetNewFor<CPDF_Reference>("Root", nullptr, 1);
+  CPDF_CrossRefTable table(std::move(trailer), /*trailer_object_number=*/7);
+  table.AddNormal(5, 0, false, 18);
+  DataVector<uint8_t> cache = CPDF_CrossRefCache::Serialize(
+      table, CPDF_CrossRefCache::ParserState(),
+      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(other_data).Get());
+  ASSERT_FALSE(cache.empty());
+
+  ASSERT_TRUE(parser().InitTestFromBuffer(kData));
+  EXPECT_EQ(CPDF_Parser::SUCCESS,
+            parser().StartParseInternalWithCrossRefCache(cache));
+  EXPECT_FALSE(parser().xref_table_rebuilt());
+
+  const CPDF_CrossRefTable::ObjectInfo expected_result[3] = {
+      {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 0},
+      {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 15},
+      {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 18}};
+  EXPECT_THAT(parser().GetCrossRefTableForTesting()->objects_info(),
+              ElementsAre(Pair(0, expected_result[0]),
+                          Pair(1, expected_result[1]),
+                          Pair(2, expected_result[2])));
+}
+
+// Objects located by a cross reference cache are checked when first parsed.
+TEST_F(ParserXRefTest, XrefKeepsCrossRefCacheWithRightObjects) {
+  const unsigned char kData[] =
+      "%PDF1-7\n%\xa0\xf2\xa4\xf4\n"
+      "1 0 obj <<\n"
+      "  /Type /Catalog\n"
+      ">>\n"
+      "endobj\n"
+      "2 0 obj\n"
+      "(two)\n"
+      "endobj\n"
+      "7 0 obj <<\n"
+      "  /Filter /ASCIIHexDecode\n"
+      "  /Root 1 0 R\n"
+      "  /Size 3\n"
+      "  /W [1 1 1]\n"
+      ">>\n"
+      "stream\n"
+      "01 00 00\n"
+      "01 0E 00\n"
+      "01 34 00\n"
+      "endstream\n"
+      "endobj\n"
+      "startxref\n"
+      "73\n"
+      "%%EOF\n";
+
+  // The trailer object number tells this table apart from the file's own.
+  auto trailer = pdfium::MakeRetain<CPDF_Dictionary>();
+  trailer->SetNewFor<CPDF_Reference>("Root", nullptr, 1);
+  CPDF_CrossRefTable table(std::move(trailer), /*trailer_object_number=*/9);
+  table.AddNormal(1, 0, false, 14);
+  table.AddNormal(2, 0, false, 52);
+  DataVector<uint8_t> cache = CPDF_CrossRefCache::Serialize(
+      table, CPDF_CrossRefCache::ParserState{.last_xref_offset = 73},
+      pdfium::MakeRetain<CFX_ReadOnlySpanStream>(kData).Get());
+  ASSERT_FALSE(cache.empty());
+
+  ASSERT_TRUE(parser().InitTestFromBuffer(kData));
+  EXPECT_EQ(CPDF_Parser::SUCCESS,
+            parser().StartParseInternalWithCrossRefCache(cache));
+  RetainPtr<const CPDF_Dictionary> root =
+      ToDictionary(parser().ParseIndirectObject(1));
+  ASSERT_TRUE(root);
+  EXPECT_EQ("Catalog", root->GetNameFor("Type"));
+  RetainPtr<const CPDF_Object> two = parser().ParseIndirectObject(2);
+  ASSERT_TRUE(two);
+  EXPECT_EQ("two", two->GetString());
+  EXPECT_EQ(9u, parser().GetTrailerObjectNumber());
+  EXPECT_EQ(cache, parser().GetCrossRefCache());
+}
+
+// A cache that matches the regions of the file it records a digest of, but
+// not the objects, is dropped at the first object it gets wrong.
+TEST_F(ParserXRefTest, XrefDropsCrossRefCacheWithWrongObjects) {
+  const unsigned char kData[] =
+      "%PDF1-7\n%\xa0\xf2\xa4\xf4\n"
+      "1 0 obj <<\n"
+      "  /Type /Catalog\n"
+      ">>\n"
+      "endobj\n"
+      "2 0 obj\n"
+      "(two)\n"
+      "endobj\n"
+      "7 0 obj <<\n"
+      "  /Filter /ASCIIHexDecode\n"
+      "  /Root 1 0 R\n"
+      "  /Size 3\n"
+      "  /W [1 1 1]\n"
+      ">>\n"
+      "stream\n"
+      "01 00 00\n"
+      "01 0E 00\n"
+      "01 34 00\n"
+      "endstream\n"
+      "endobj\n"
+      "startxref\n"
+      "73\n"
+      "%%EOF\n";
+
+  struct {
+    FX_FILESIZE pos1;
+    uint16_t gennum2;
+  } const kCases[] = {
+      // Object 1 at object 2's offset. Object 2 parses from the cache, and
+      // object 1 drops it.
+      {52, 0},
+      // Object 2 with the wrong generation number, which drops the cache.
+      {14, 1},
+  };
+  for (const auto& test_case : kCases) {
+    auto trailer = pdfium::MakeRetain<CPDF_Dictionary>();
+    trailer->SetNewFor<CPDF_Reference>("Root", nullptr, 1);
+    CPDF_CrossRefTable table(std::move(trailer), /*trailer_object_number=*/9);
+    table.AddNormal(1, 0, false, test_case.pos1);
+    table.AddNormal(2, test_case.gennum2, false, 52);
+    DataVector<uint8_t> cache = CPDF_CrossRefCache::Serialize(
+        table, CPDF_CrossRefCache::ParserState{.last_xref_offset = 73},
+        pdfium::MakeRetain<CFX_ReadOnlySpanStream>(kData).Get());
+    ASSERT_FALSE(cache.empty());
+
+    CPDF_TestParser parser;
+    EXPECT_CALL(parser.object_holder(), ParseIndirectObject)
+        .WillRepeatedly(Return(pdfium::MakeRetain<CPDF_Dictionary>()));
+    ASSERT_TRUE(parser.InitTestFromBuffer(kData));
+    EXPECT_EQ(CPDF_Parser::SUCCESS,
+              parser.StartParseInternalWithCrossRefCache(cache));
+    EXPECT_EQ(9u, parser.GetTrailerObjectNumber());
+
+    RetainPtr<const CPDF_Object> two = parser.ParseIndirectObject(2);
+    ASSERT_TRUE(two);
+    EXPECT_EQ("two", two->GetString());
+    RetainPtr<const CPDF_Dictionary> root =
+        ToDictionary(parser.ParseIndirectObject(1));
+    ASSERT_TRUE(root);
+    EXPECT_EQ("Catalog", root->GetNameFor("Type"));
+    EXPECT_EQ(7u, parser.GetTrailerObjectNumber());
+    EXPECT_FALSE(parser.xref_table_rebuilt());
+    EXPECT_TRUE(parser.IsXRefStream());
+    EXPECT_EQ(73, parser.GetLastXRefOffset());
+
+    const CPDF_CrossRefTable::ObjectInfo expected_result[3] = {
+        {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 0},
+        {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 14},
+        {.type = CPDF_CrossRefTable::ObjectType::kNormal, .pos = 52}};
+    EXPECT_THAT(parser.GetCrossRefTableForTesting()->objects_info(),
+                ElementsAre(Pair(0, expected_result[0]),
+                            Pair(1, expected_result[1]),
+                            Pair(2, expected_result[2])));
+  }
+}
+
+TEST_F(ParserXRefTest, PreloadObjectStreams) {
+  const unsigned char kData[] =
+      "%PDF1-7\n%\xa0\xf2\xa4\xf4\n"
+      "1 0 obj <</Type /ObjStm /N 2 /First 8 /Filter /FlateDecode"
+      " /Length 32>>\n"
+      "stream\n"
+      // "2 0 3 9 <</A 1>> [1 2 3]", compressed.
+      "\x78\x9c\x33\x52\x30\x50\x30\x56\xb0\x54\xb0\xb1\xd1\x77\x54\x30"
+      "\xb4\xb3\x53\x88\x36\x54\x30\x52\x30\x8e\x05\x00\x37\x6c\x04\xb2\n"
+      "endstream\n"
+      "endobj\n"
+      "4 0 obj <</Type /XRef /Filter /ASCIIHexDecode /Root 2 0 R /Size 5"
+      " /W [1 1 1]>>\n"
+      "stream\n"
+      "00 00 00 01 0E 00 02 01 00 02 01 01 01 8F 00\n"
+      "endstream\n"
+      "endobj\n"
+      "startxref\n"
+      "143\n"
+      "%%EOF\n";
+
+  ASSERT_TRUE(parser().InitTestFromBuffer(kData));
+  EXPECT_EQ(CPDF_Parser::SUCCESS, parser().StartParseInternal());
+  EXPECT_FALSE(parser().xref_table_rebuilt());
+  EXPECT_EQ(1u, parser().PreloadObjectStreams());
+  EXPECT_EQ(0u, parser().PreloadObjectStreams());
+
+  RetainPtr<const CPDF_Dictionary> dict =
+      ToDictionary(parser().ParseIndirectObject(2));
+  ASSERT_TRUE(dict);
+  EXPECT_EQ(2u, dict->GetObjNum());
+  EXPECT_EQ(1, dict->GetIntegerFor("A"));
+
+  RetainPtr<const CPDF_Array> array = ToArray(parser().ParseIndirectObject(3));
+  ASSERT_TRUE(array);
+  EXPECT_EQ(3u, array->GetObjNum());
+  EXPECT_EQ(3u, array->size());
+}
@@ -87,6 +87,19 @@ FX_FILESIZE CPDF_ReadValidator::GetSize() {
   return file_size_;
 }
 
+pdfium::span<const uint8_t> CPDF_ReadValidator::GetInMemorySpan() {
+  // With `file_avail_`, data may still be downloading, so every read needs to
+  // be validated.
+  if (file_avail_) {
+    return {};
+  }
+  return file_read_->GetInMemorySpan();
+}
+
+void CPDF_ReadValidator::SetAccessPattern(AccessPattern pattern) {
+  file_read_->SetAccessPattern(pattern);
+}
+
 void CPDF_ReadValidator::ScheduleDownload(FX_FILESIZE offset, size_t size) {
   has_unavailable_data_ = true;
   if (!hints_ || size == 0) {
@@ -48,6 +48,8 @@ class CPDF_ReadValidator : public IFX_SeekableReadStream {
   bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                          FX_FILESIZE offset) override;
   FX_FILESIZE GetSize() override;
+  pdfium::span<const uint8_t> GetInMemorySpan() override;
+  void SetAccessPattern(AccessPattern pattern) override;
 
  protected:
   CPDF_ReadValidator(RetainPtr<IFX_SeekableReadStream> file_read,
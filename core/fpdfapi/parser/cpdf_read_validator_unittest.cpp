@@ -300,3 +300,20 @@ TEST(ReadValidatorTest, CheckDataRangeAndRequestIfUnavailable) {
 
   validator->SetDownloadHints(nullptr);
 }
+
+TEST(ReadValidatorTest, InMemorySpan) {
+  DataVector<uint8_t> test_data(kTestDataSize);
+  auto file = pdfium::MakeRetain<CFX_ReadOnlySpanStream>(test_data);
+  {
+    auto validator = pdfium::MakeRetain<CPDF_ReadValidator>(file, nullptr);
+    pdfium::span<const uint8_t> span = validator->GetInMemorySpan();
+    EXPECT_EQ(test_data.data(), span.data());
+    EXPECT_EQ(test_data.size(), span.size());
+  }
+  {
+    // Data that may not have been downloaded yet must not be exposed.
+    MockFileAvail file_avail;
+    auto validator = pdfium::MakeRetain<CPDF_ReadValidator>(file, &file_avail);
+    EXPECT_TRUE(validator->GetInMemorySpan().empty());
+  }
+}
@@ -215,6 +215,14 @@ pdfium::span<const uint8_t> CPDF_Stream::GetInMemoryRawData() const {
   return std::get<DataVector<uint8_t>>(data_);
 }
 
+RetainPtr<IFX_SeekableReadStream> CPDF_Stream::GetInMemoryFile() const {
+  if (!IsFileBased()) {
+    return nullptr;
+  }
+  const auto& file = std::get<RetainPtr<IFX_SeekableReadStream>>(data_);
+  return file->GetInMemorySpan().empty() ? nullptr : file;
+}
+
 void CPDF_Stream::SetLengthInDict(int length) {
   dict_->SetNewFor<CPDF_Number>("Length", length);
 }
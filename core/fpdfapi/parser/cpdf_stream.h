@@ -40,6 +40,12 @@ class CPDF_Stream final : public CPDF_Object {
   // Other callers should use CPDF_StreamAcc to access data in all cases.
   pdfium::span<const uint8_t> GetInMemoryRawData() const;
 
+  // Returns the file of a file-based stream if its data is already in memory,
+  // and nullptr otherwise. The file's GetInMemorySpan() can then be read
+  // without copying for as long as the file is retained.
+  // This is meant to be used by CPDF_StreamAcc only.
+  RetainPtr<IFX_SeekableReadStream> GetInMemoryFile() const;
+
   // Copies span or stream into internally-owned buffer.
   void SetData(pdfium::span<const uint8_t> pData);
   void SetDataFromStringstream(fxcrt::ostringstream* stream);
@@ -6,6 +6,7 @@
 
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
 
+#include <algorithm>
 #include <utility>
 #include <variant>
 
@@ -16,6 +17,8 @@
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
 
 CPDF_StreamAcc::CPDF_StreamAcc(RetainPtr<const CPDF_Stream> pStream)
     : stream_(std::move(pStream)) {}
@@ -79,6 +82,9 @@ pdfium::span<const uint8_t> CPDF_StreamAcc::GetSpan() const {
   if (is_owned()) {
     return std::get<DataVector<uint8_t>>(data_);
   }
+  if (borrowed_file_) {
+    return std::get<pdfium::raw_span<const uint8_t>>(data_);
+  }
   if (stream_ && stream_->IsMemoryBased()) {
     return stream_->GetInMemoryRawData();
   }
@@ -113,6 +119,12 @@ void CPDF_StreamAcc::ProcessRawData() {
     return;
   }
 
+  pdfium::span<const uint8_t> borrowed = BorrowRawFileData();
+  if (!borrowed.empty()) {
+    data_ = borrowed;
+    return;
+  }
+
   DataVector<uint8_t> data = ReadRawStream();
   if (data.empty()) {
     return;
@@ -129,9 +141,10 @@ void CPDF_StreamAcc::ProcessFilteredData(uint32_t estimated_size,
   }
 
   std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>> src_data;
-  pdfium::span<const uint8_t> src_span;
-  if (stream_->IsMemoryBased()) {
-    src_span = stream_->GetInMemoryRawData();
+  pdfium::span<const uint8_t> src_span = stream_->IsMemoryBased()
+                                            ? stream_->GetInMemoryRawData()
+                                            : BorrowRawFileData();
+  if (!src_span.empty()) {
     src_data = src_span;
   } else {
     DataVector<uint8_t> temp_src_data = ReadRawStream();
@@ -150,6 +163,13 @@ void CPDF_StreamAcc::ProcessFilteredData(uint32_t estimated_size,
     return;
   }
 
+  // /DL gives the size of the data once all filters are undone, which saves
+  // decoders from guessing how much room it needs.
+  if (!estimated_size) {
+    estimated_size = pdfium::checked_cast<uint32_t>(
+        std::max(stream_->GetDict()->GetIntegerFor("DL"), 0));
+  }
+
   std::optional<PDFDataDecodeResult> result = PDF_DataDecode(
       src_span, estimated_size, bImageAcc, decoder_array.value());
   if (!result.has_value()) {
@@ -166,6 +186,7 @@ void CPDF_StreamAcc::ProcessFilteredData(uint32_t estimated_size,
   }
 
   data_ = std::move(result.value().data);
+  borrowed_file_.Reset();
 }
 
 DataVector<uint8_t> CPDF_StreamAcc::ReadRawStream() const {
@@ -173,3 +194,11 @@ DataVector<uint8_t> CPDF_StreamAcc::ReadRawStream() const {
   DCHECK(stream_->IsFileBased());
   return stream_->ReadAllRawData();
 }
+
+pdfium::span<const uint8_t> CPDF_StreamAcc::BorrowRawFileData() {
+  borrowed_file_ = stream_->GetInMemoryFile();
+  if (!borrowed_file_) {
+    return {};
+  }
+  return borrowed_file_->GetInMemorySpan();
+}
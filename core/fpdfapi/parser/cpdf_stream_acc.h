@@ -20,6 +20,7 @@
 
 class CPDF_Dictionary;
 class CPDF_Stream;
+class IFX_SeekableReadStream;
 
 class CPDF_StreamAcc final : public Retainable {
  public:
@@ -56,6 +57,11 @@ class CPDF_StreamAcc final : public Retainable {
   // Returns the raw data from `stream_`, or no data on failure.
   DataVector<uint8_t> ReadRawStream() const;
 
+  // Returns the raw data of a file-based `stream_` without copying it, if the
+  // file is in memory, and retains the file in `borrowed_file_`. Returns an
+  // empty span otherwise.
+  pdfium::span<const uint8_t> BorrowRawFileData();
+
   bool is_owned() const {
     return std::holds_alternative<DataVector<uint8_t>>(data_);
   }
@@ -64,6 +70,9 @@ class CPDF_StreamAcc final : public Retainable {
   RetainPtr<const CPDF_Dictionary> image_param_;
   // Needs to outlive `data_` when the data is not owned.
   RetainPtr<const CPDF_Stream> const stream_;
+  // Holds the data `data_` borrows from a file-based `stream_`, which may stop
+  // being file-based in the meantime.
+  RetainPtr<IFX_SeekableReadStream> borrowed_file_;
   std::variant<pdfium::raw_span<const uint8_t>, DataVector<uint8_t>> data_;
 };
 
@@ -8,7 +8,13 @@
 #include <utility>
 
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcodec/flate/flatemodule.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/cfx_read_only_vector_stream.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_stream.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/invalid_seekable_read_stream.h"
@@ -34,3 +40,52 @@ TEST(StreamAccTest, DataStreamLifeTime) {
   EXPECT_TRUE(
       std::equal(std::begin(kData), std::end(kData), span.begin(), span.end()));
 }
+
+TEST(StreamAccTest, BorrowInMemoryFileData) {
+  auto file = pdfium::MakeRetain<CFX_ReadOnlyVectorStream>(
+      DataVector<uint8_t>{'a', 'b', 'c'});
+  const uint8_t* const file_data = file->GetInMemorySpan().data();
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      std::move(file), pdfium::MakeRetain<CPDF_Dictionary>());
+
+  auto raw_acc = pdfium::MakeRetain<CPDF_StreamAcc>(stream);
+  raw_acc->LoadAllDataRaw();
+  EXPECT_EQ(file_data, raw_acc->GetSpan().data());
+
+  auto filtered_acc = pdfium::MakeRetain<CPDF_StreamAcc>(stream);
+  filtered_acc->LoadAllDataFiltered();
+  EXPECT_EQ(file_data, filtered_acc->GetSpan().data());
+
+  // Replacing the stream's data releases the file, but not the data already
+  // borrowed from it.
+  static constexpr uint8_t kNewData[] = {'x', 'y'};
+  stream->SetData(kNewData);
+  EXPECT_EQ("abc", ByteStringView(raw_acc->GetSpan()));
+  EXPECT_EQ("abc", ByteStringView(filtered_acc->GetSpan()));
+  EXPECT_EQ("abc", ByteStringView(raw_acc->DetachData()));
+}
+
+TEST(StreamAccTest, DecodedLengthHint) {
+  ByteString content;
+  for (int i = 0; i < 1000; ++i) {
+    content += "0 0 m 100 100 l S\n";
+  }
+  const DataVector<uint8_t> encoded =
+      FlateModule::Encode(content.unsigned_span());
+
+  // The hint only sizes the first try, so wrong ones decode the same.
+  for (int hint : {0, -1, 1, static_cast<int>(content.GetLength()) - 1,
+                   static_cast<int>(content.GetLength()),
+                   static_cast<int>(content.GetLength()) * 100}) {
+    auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+    dict->SetNewFor<CPDF_Name>("Filter", "FlateDecode");
+    if (hint) {
+      dict->SetNewFor<CPDF_Number>("DL", hint);
+    }
+    auto stream = pdfium::MakeRetain<CPDF_Stream>(encoded, std::move(dict));
+    auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(std::move(stream));
+    stream_acc->LoadAllDataFiltered();
+    EXPECT_EQ(content.AsStringView(), ByteStringView(stream_acc->GetSpan()))
+        << hint;
+  }
+}
@@ -68,6 +68,15 @@ class ReadableSubStream final : public IFX_SeekableReadStream {
 
   FX_FILESIZE GetSize() override { return part_size_; }
 
+  pdfium::span<const uint8_t> GetInMemorySpan() override {
+    pdfium::span<const uint8_t> file_span = file_read_->GetInMemorySpan();
+    if (file_span.empty()) {
+      return {};
+    }
+    return file_span.subspan(static_cast<size_t>(part_offset_),
+                             static_cast<size_t>(part_size_));
+  }
+
  private:
   RetainPtr<IFX_SeekableReadStream> file_read_;
   FX_FILESIZE part_offset_;
@@ -101,6 +110,12 @@ CPDF_SyntaxParser::CPDF_SyntaxParser(RetainPtr<CPDF_ReadValidator> validator,
       header_offset_(HeaderOffset),
       file_len_(file_access_->GetSize()) {
   DCHECK(header_offset_ <= file_len_);
+  pdfium::span<const uint8_t> in_memory = file_access_->GetInMemorySpan();
+  if (static_cast<FX_FILESIZE>(in_memory.size()) == file_len_) {
+    // Read straight from memory. Every position is then already "read", so
+    // ReadBlockAt() is never needed.
+    buf_ = in_memory;
+  }
 }
 
 CPDF_SyntaxParser::~CPDF_SyntaxParser() = default;
@@ -125,9 +140,11 @@ bool CPDF_SyntaxParser::ReadBlockAt(FX_FILESIZE read_pos) {
   file_buf_.resize(read_size);
   if (!file_access_->ReadBlockAtOffset(file_buf_, read_pos)) {
     file_buf_.clear();
+    buf_ = {};
     return false;
   }
 
+  buf_ = file_buf_;
   buf_offset_ = read_pos;
   return true;
 }
@@ -142,7 +159,7 @@ bool CPDF_SyntaxParser::GetNextChar(uint8_t& ch) {
     return false;
   }
 
-  ch = file_buf_[pos - buf_offset_];
+  ch = buf_[pos - buf_offset_];
   pos_++;
   return true;
 }
@@ -166,7 +183,7 @@ bool CPDF_SyntaxParser::GetCharAtBackward(FX_FILESIZE pos, uint8_t* ch) {
       return false;
     }
   }
-  *ch = file_buf_[pos - buf_offset_];
+  *ch = buf_[pos - buf_offset_];
   return true;
 }
 
@@ -853,7 +870,13 @@ RetainPtr<CPDF_Stream> CPDF_SyntaxParser::ReadStream(
   }
 
   RetainPtr<CPDF_Stream> stream;
-  if (substream) {
+  if (substream && share_in_memory_stream_data_ &&
+      !substream->GetInMemorySpan().empty()) {
+    // The file outlives the objects parsed from it, so `stream` can read
+    // straight from it.
+    stream = pdfium::MakeRetain<CPDF_Stream>(std::move(substream),
+                                             std::move(dict));
+  } else if (substream) {
     // It is unclear from CPDF_SyntaxParser's perspective what object
     // `substream` is ultimately holding references to. To avoid unexpectedly
     // changing object lifetimes by handing `substream` to `stream`, make a
@@ -1007,5 +1030,5 @@ FX_FILESIZE CPDF_SyntaxParser::FindTag(ByteStringView tag) {
 
 bool CPDF_SyntaxParser::IsPositionRead(FX_FILESIZE pos) const {
   return buf_offset_ <= pos &&
-         pos < static_cast<FX_FILESIZE>(buf_offset_ + file_buf_.size());
+         pos < static_cast<FX_FILESIZE>(buf_offset_ + buf_.size());
 }
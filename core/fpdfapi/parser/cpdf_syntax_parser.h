@@ -16,6 +16,7 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_types.h"
+#include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/string_pool_template.h"
@@ -51,6 +52,13 @@ class CPDF_SyntaxParser {
     read_buffer_size_ = read_buffer_size;
   }
 
+  // Lets streams refer to the file's data instead of copying it, when the
+  // file is in memory. Only for files that outlive every object parsed from
+  // them, like the one a document is loaded from.
+  void SetShareInMemoryStreamData(bool share) {
+    share_in_memory_stream_data_ = share;
+  }
+
   FX_FILESIZE GetPos() const { return pos_; }
   void SetPos(FX_FILESIZE pos);
 
@@ -125,9 +133,13 @@ class CPDF_SyntaxParser {
   FX_FILESIZE pos_ = 0;
   WeakPtr<ByteStringPool> pool_;
   DataVector<uint8_t> file_buf_;
+  // The bytes starting at `buf_offset_`, either in `file_buf_` or, when the
+  // whole file is in memory, in the file itself.
+  pdfium::raw_span<const uint8_t> buf_;
   FX_FILESIZE buf_offset_ = 0;
   uint32_t word_size_ = 0;
   uint32_t read_buffer_size_ = CPDF_Stream::kFileBufSize;
+  bool share_in_memory_stream_data_ = false;
   std::array<uint8_t, 257> word_buffer_ = {};
 
   // The syntax parser records traversed trailer end byte offsets here.
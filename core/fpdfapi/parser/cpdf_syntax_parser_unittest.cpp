@@ -6,6 +6,8 @@
 
 #include "core/fpdfapi/parser/cpdf_object.h"
 #include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fpdfapi/parser/cpdf_syntax_parser.h"
 #include "core/fxcrt/cfx_read_only_span_stream.h"
 #include "core/fxcrt/fx_extension.h"
@@ -147,3 +149,26 @@ TEST(SyntaxParserTest, PeekNextWord) {
   EXPECT_EQ("WORD", parser.PeekNextWord());
   EXPECT_EQ("WORD", parser.GetNextWord().word);
 }
+
+TEST(SyntaxParserTest, ShareInMemoryStreamData) {
+  static const char kData[] =
+      "1 0 obj\n<</Length 3>>\nstream\nabc\nendstream\nendobj\n";
+  const pdfium::span<const uint8_t> data =
+      ByteStringView(kData).unsigned_span();
+  const uint8_t* const stream_data = data.subspan(29u).data();
+  ASSERT_EQ('a', *stream_data);
+
+  for (bool share : {false, true}) {
+    CPDF_SyntaxParser parser(
+        pdfium::MakeRetain<CFX_ReadOnlySpanStream>(data));
+    parser.SetShareInMemoryStreamData(share);
+    RetainPtr<CPDF_Stream> stream = ToStream(parser.GetIndirectObject(
+        nullptr, CPDF_SyntaxParser::ParseType::kLoose));
+    ASSERT_TRUE(stream);
+
+    auto stream_acc = pdfium::MakeRetain<CPDF_StreamAcc>(stream);
+    stream_acc->LoadAllDataRaw();
+    EXPECT_EQ("abc", ByteStringView(stream_acc->GetSpan()));
+    EXPECT_EQ(share, stream_acc->GetSpan().data() == stream_data);
+  }
+}
@@ -22,6 +22,7 @@
 #include "core/fxcodec/fax/faxmodule.h"
 #include "core/fxcodec/flate/flatemodule.h"
 #include "core/fxcodec/scanlinedecoder.h"
+#include "core/fxcodec/streamdecoder.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/containers/contains.h"
@@ -363,6 +364,26 @@ std::unique_ptr<ScanlineDecoder> CreateFlateDecoder(
                                     Columns);
 }
 
+std::unique_ptr<StreamDecoder> CreateFlateStreamDecoder(
+    pdfium::span<const uint8_t> src_span,
+    const CPDF_Dictionary* pParams) {
+  int predictor = 0;
+  int Colors = 0;
+  int BitsPerComponent = 0;
+  int Columns = 0;
+  if (pParams) {
+    predictor = pParams->GetIntegerFor("Predictor");
+    Colors = pParams->GetIntegerFor("Colors", 1);
+    BitsPerComponent = pParams->GetIntegerFor("BitsPerComponent", 8);
+    Columns = pParams->GetIntegerFor("Columns", 1);
+    if (!CheckFlateDecodeParams(Colors, BitsPerComponent, Columns)) {
+      return nullptr;
+    }
+  }
+  return FlateModule::CreateStreamDecoder(src_span, predictor, Colors,
+                                          BitsPerComponent, Columns);
+}
+
 DataAndBytesConsumed FlateOrLZWDecode(bool use_lzw,
                                       pdfium::span<const uint8_t> src_span,
                                       const CPDF_Dictionary* pParams,
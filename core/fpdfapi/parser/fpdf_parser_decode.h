@@ -27,6 +27,7 @@ class CPDF_Object;
 
 namespace fxcodec {
 class ScanlineDecoder;
+class StreamDecoder;
 }
 
 // Indexed by 8-bit char code, contains unicode code points.
@@ -53,6 +54,11 @@ std::unique_ptr<fxcodec::ScanlineDecoder> CreateFlateDecoder(
     int bpc,
     const CPDF_Dictionary* pParams);
 
+// Returns nullptr where FlateOrLZWDecode() would fail for the parameters.
+std::unique_ptr<fxcodec::StreamDecoder> CreateFlateStreamDecoder(
+    pdfium::span<const uint8_t> src_span,
+    const CPDF_Dictionary* pParams);
+
 fxcodec::DataAndBytesConsumed RunLengthDecode(
     pdfium::span<const uint8_t> src_span);
 
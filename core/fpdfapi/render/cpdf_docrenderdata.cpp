@@ -38,7 +38,8 @@ CPDF_DocRenderData* CPDF_DocRenderData::FromDocument(const CPDF_Document* doc) {
   return static_cast<CPDF_DocRenderData*>(doc->GetRenderData());
 }
 
-CPDF_DocRenderData::CPDF_DocRenderData() = default;
+CPDF_DocRenderData::CPDF_DocRenderData()
+    : shading_steps_cache_(kMaxCachedShadingSteps) {}
 
 CPDF_DocRenderData::~CPDF_DocRenderData() = default;
 
@@ -68,6 +69,22 @@ RetainPtr<CPDF_TransferFunc> CPDF_DocRenderData::GetTransferFunc(
   return func;
 }
 
+const ShadingSteps* CPDF_DocRenderData::GetCachedShadingSteps(
+    const RetainPtr<const CPDF_Object>& shading,
+    float t_min,
+    float t_max) {
+  return shading_steps_cache_.Lookup({shading, t_min, t_max});
+}
+
+void CPDF_DocRenderData::CacheShadingSteps(RetainPtr<const CPDF_Object> shading,
+                                           float t_min,
+                                           float t_max,
+                                           const ShadingSteps& steps) {
+  // Counts entries rather than bytes, as they are all the same size.
+  shading_steps_cache_.Store({std::move(shading), t_min, t_max}, steps,
+                             /*size=*/1);
+}
+
 #if BUILDFLAG(IS_WIN)
 CFX_PSFontTracker* CPDF_DocRenderData::GetPSFontTracker() {
   if (!psfont_tracker_) {
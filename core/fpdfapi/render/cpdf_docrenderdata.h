@@ -7,11 +7,17 @@
 #ifndef CORE_FPDFAPI_RENDER_CPDF_DOCRENDERDATA_H_
 #define CORE_FPDFAPI_RENDER_CPDF_DOCRENDERDATA_H_
 
+#include <stddef.h>
+
 #include <functional>
 #include <map>
+#include <tuple>
 
 #include "build/build_config.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/render/cpdf_patterncellcache.h"
+#include "core/fpdfapi/render/shading_simd.h"
+#include "core/fxcrt/lru_cache.h"
 #include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
 
@@ -31,6 +37,8 @@ class CFX_PSFontTracker;
 
 class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
  public:
+  static constexpr size_t kMaxCachedShadingSteps = 256;
+
   static CPDF_DocRenderData* FromDocument(const CPDF_Document* doc);
 
   CPDF_DocRenderData();
@@ -44,6 +52,22 @@ class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
   RetainPtr<CPDF_TransferFunc> GetTransferFunc(
       RetainPtr<const CPDF_Object> obj);
 
+  CPDF_PatternCellCache* GetPatternCellCache() { return &pattern_cell_cache_; }
+
+  // The colors of axial and radial shadings along their axis, for the domain
+  // [`t_min`, `t_max`] and with alpha 0, as computing them runs the shading
+  // functions for every step. `shading` is the shading dictionary or stream.
+  // Keeps the `kMaxCachedShadingSteps` most recently used domains of
+  // shadings, and the shadings with them.
+  const ShadingSteps* GetCachedShadingSteps(
+      const RetainPtr<const CPDF_Object>& shading,
+      float t_min,
+      float t_max);
+  void CacheShadingSteps(RetainPtr<const CPDF_Object> shading,
+                         float t_min,
+                         float t_max,
+                         const ShadingSteps& steps);
+
 #if BUILDFLAG(IS_WIN)
   CFX_PSFontTracker* GetPSFontTracker();
 #endif
@@ -54,12 +78,18 @@ class CPDF_DocRenderData : public CPDF_Document::RenderDataIface {
       RetainPtr<const CPDF_Object> pObj) const;
 
  private:
+  // The shading, `t_min` and `t_max`.
+  using ShadingStepsKey =
+      std::tuple<RetainPtr<const CPDF_Object>, float, float>;
+
   // TODO(tsepez): investigate this map outliving its font keys.
   std::map<CPDF_Font*, ObservedPtr<CPDF_Type3Cache>> type3_face_map_;
   std::map<RetainPtr<const CPDF_Object>,
            ObservedPtr<CPDF_TransferFunc>,
            std::less<>>
       transfer_func_map_;
+  CPDF_PatternCellCache pattern_cell_cache_;
+  LruCache<ShadingStepsKey, ShadingSteps> shading_steps_cache_;
 
 #if BUILDFLAG(IS_WIN)
   std::unique_ptr<CFX_PSFontTracker> psfont_tracker_;
@@ -257,4 +257,33 @@ TEST(CPDFDocRenderDataTest, BadTransferFunctions) {
   }
 }
 
+TEST(CPDFDocRenderDataTest, ShadingStepsCache) {
+  CPDF_DocRenderData render_data;
+  ShadingSteps steps;
+  steps.fill(0x123456);
+
+  auto shading = pdfium::MakeRetain<CPDF_Dictionary>();
+  EXPECT_FALSE(render_data.GetCachedShadingSteps(shading, 0.0f, 1.0f));
+  render_data.CacheShadingSteps(shading, 0.0f, 1.0f, steps);
+  const ShadingSteps* cached =
+      render_data.GetCachedShadingSteps(shading, 0.0f, 1.0f);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(steps, *cached);
+  EXPECT_FALSE(render_data.GetCachedShadingSteps(shading, 0.0f, 0.5f));
+
+  // Makes room for more shadings by dropping the least recently used ones.
+  auto first_other = pdfium::MakeRetain<CPDF_Dictionary>();
+  render_data.CacheShadingSteps(first_other, 0.0f, 1.0f, steps);
+  for (size_t i = 1; i < CPDF_DocRenderData::kMaxCachedShadingSteps; ++i) {
+    EXPECT_TRUE(render_data.GetCachedShadingSteps(shading, 0.0f, 1.0f));
+    render_data.CacheShadingSteps(pdfium::MakeRetain<CPDF_Dictionary>(), 0.0f,
+                                  1.0f, steps);
+  }
+  EXPECT_TRUE(render_data.GetCachedShadingSteps(shading, 0.0f, 1.0f));
+  EXPECT_FALSE(render_data.GetCachedShadingSteps(first_other, 0.0f, 1.0f));
+
+  // Does not keep dropped shadings alive.
+  EXPECT_TRUE(first_other->HasOneRef());
+}
+
 }  // namespace
@@ -58,6 +58,15 @@ bool IsImageValueTooBig(int val) {
   return safe_val.ValueOrDefault(kLimit) >= kLimit;
 }
 
+// How many of `pixels` image pixels fit along `length` device pixels.
+int GetDevicePixels(float length, int pixels) {
+  // Also catches NaN.
+  if (!(length < pixels)) {
+    return pixels;
+  }
+  return std::max(1, static_cast<int>(ceilf(length)));
+}
+
 }  // namespace
 
 CPDF_ImageRenderer::CPDF_ImageRenderer(CPDF_RenderStatus* pStatus)
@@ -65,6 +74,21 @@ CPDF_ImageRenderer::CPDF_ImageRenderer(CPDF_RenderStatus* pStatus)
 
 CPDF_ImageRenderer::~CPDF_ImageRenderer() = default;
 
+// static
+CFX_Size CPDF_ImageRenderer::GetMaxSizeRequired(
+    const CPDF_Image* image,
+    const CFX_Matrix& image_matrix) {
+  const int width = image->GetPixelWidth();
+  const int height = image->GetPixelHeight();
+  if (width <= 0 || height <= 0) {
+    return CFX_Size();
+  }
+  // An image drawn larger than it is needs all of its pixels, which is the
+  // same size at every zoom level past that, so one decode serves them all.
+  return CFX_Size(GetDevicePixels(image_matrix.GetXUnit(), width),
+                  GetDevicePixels(image_matrix.GetYUnit(), height));
+}
+
 bool CPDF_ImageRenderer::StartLoadDIBBase() {
   if (!GetUnitRect().has_value()) {
     return false;
@@ -75,14 +99,46 @@ bool CPDF_ImageRenderer::StartLoadDIBBase() {
           render_status_->GetFormResource(), render_status_->GetPageResource(),
           std_cs_, render_status_->GetGroupFamily(),
           render_status_->GetLoadMask(),
-          {render_status_->GetRenderDevice()->GetWidth(),
-           render_status_->GetRenderDevice()->GetHeight()})) {
+          GetMaxSizeRequired(image_object_->GetImage().Get(), image_matrix_),
+          GetVisibleImageRegion())) {
     return false;
   }
   mode_ = Mode::kDefault;
   return true;
 }
 
+FX_RECT CPDF_ImageRenderer::GetVisibleImageRegion() const {
+  const CPDF_Image* image = image_object_->GetImage().Get();
+  const int width = image->GetPixelWidth();
+  const int height = image->GetPixelHeight();
+  const float determinant =
+      image_matrix_.a * image_matrix_.d - image_matrix_.b * image_matrix_.c;
+  if (width <= 0 || height <= 0 || determinant == 0) {
+    return FX_RECT();
+  }
+
+  CFX_FloatRect unit = image_matrix_.GetInverse().TransformRect(
+      CFX_FloatRect(render_status_->GetRenderDevice()->GetClipBox()));
+  unit.Intersect(CFX_FloatRect(0, 0, 1, 1));
+  if (unit.IsEmpty()) {
+    return FX_RECT();
+  }
+
+  // Image rows go down from the top of the unit square. Leave a margin for
+  // the pixels that resampling reads around the visible ones.
+  constexpr int kMargin = 2;
+  FX_RECT region(static_cast<int>(floorf(unit.left * width)) - kMargin,
+                 static_cast<int>(floorf((1 - unit.top) * height)) - kMargin,
+                 static_cast<int>(ceilf(unit.right * width)) + kMargin,
+                 static_cast<int>(ceilf((1 - unit.bottom) * height)) + kMargin);
+  region.Intersect(FX_RECT(0, 0, width, height));
+  if (region == FX_RECT(0, 0, width, height)) {
+    // All of it shows, which is the same as not asking for a part.
+    return FX_RECT();
+  }
+  return region;
+}
+
 bool CPDF_ImageRenderer::StartRenderDIBBase() {
   if (!loader_->GetBitmap()) {
     return false;
@@ -20,6 +20,7 @@ class CFX_AggImageRenderer;
 class CFX_DIBBase;
 class CFX_DIBitmap;
 class CFX_DefaultRenderDevice;
+class CPDF_Image;
 class CPDF_ImageLoader;
 class CPDF_ImageObject;
 class CPDF_Pattern;
@@ -36,6 +37,12 @@ class CPDF_ImageRenderer {
   explicit CPDF_ImageRenderer(CPDF_RenderStatus* pStatus);
   ~CPDF_ImageRenderer();
 
+  // The size that `image` needs to be decoded at to be drawn with
+  // `image_matrix`: the pixels it covers on the device along each of its
+  // axes, but no more than it has.
+  static CFX_Size GetMaxSizeRequired(const CPDF_Image* image,
+                                     const CFX_Matrix& image_matrix);
+
   bool Start(CPDF_ImageObject* pImageObject,
              const CFX_Matrix& mtObj2Device,
              bool bStdCS);
@@ -63,6 +70,7 @@ class CPDF_ImageRenderer {
   bool StartDIBBase();
   bool StartRenderDIBBase();
   bool StartLoadDIBBase();
+  FX_RECT GetVisibleImageRegion() const;
   bool ContinueDefault(PauseIndicatorIface* pPause);
   bool ContinueBlend(PauseIndicatorIface* pPause);
   bool DrawMaskedImage();
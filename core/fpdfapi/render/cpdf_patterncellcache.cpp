@@ -0,0 +1,107 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_patterncellcache.h"
+
+#include <limits>
+#include <tuple>
+#include <utility>
+
+#include "core/fpdfapi/page/cpdf_tilingpattern.h"
+#include "core/fxcrt/fx_system.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace {
+
+int32_t Quantize(float value) {
+  return FXSYS_roundf(value * CPDF_PatternCellCache::kMatrixScale);
+}
+
+}  // namespace
+
+CPDF_PatternCellCache::Key::Key(CPDF_TilingPattern* pattern,
+                                const CFX_Matrix& pattern_to_device,
+                                const CFX_Size& size)
+    : pattern(pattern),
+      matrix({Quantize(pattern_to_device.a), Quantize(pattern_to_device.b),
+              Quantize(pattern_to_device.c), Quantize(pattern_to_device.d)}),
+      size(size) {}
+
+CPDF_PatternCellCache::Key::Key(const Key& that) = default;
+
+CPDF_PatternCellCache::Key::~Key() = default;
+
+bool CPDF_PatternCellCache::Key::operator<(const Key& other) const {
+  return std::tie(pattern, matrix, size.width, size.height, color_mode,
+                  option_flags, fill_alpha, stroke_alpha, blend_mode,
+                  stroke_adjust) <
+         std::tie(other.pattern, other.matrix, other.size.width,
+                  other.size.height, other.color_mode, other.option_flags,
+                  other.fill_alpha, other.stroke_alpha, other.blend_mode,
+                  other.stroke_adjust);
+}
+
+CPDF_PatternCellCache::PatternObserver::PatternObserver(
+    CPDF_PatternCellCache* cache,
+    CPDF_TilingPattern* pattern)
+    : cache_(cache), pattern_(pattern) {
+  pattern_->AddObserver(this);
+}
+
+CPDF_PatternCellCache::PatternObserver::~PatternObserver() {
+  if (pattern_) {
+    pattern_->RemoveObserver(this);
+  }
+}
+
+void CPDF_PatternCellCache::PatternObserver::OnObservableDestroyed() {
+  // Leaves `pattern_` null, so that the destructor, which runs within
+  // OnPatternDestroyed(), does not touch the pattern.
+  cache_->OnPatternDestroyed(pattern_.ExtractAsDangling());
+}
+
+CPDF_PatternCellCache::CPDF_PatternCellCache() : cache_(kDefaultLimit) {}
+
+CPDF_PatternCellCache::~CPDF_PatternCellCache() = default;
+
+RetainPtr<const CFX_DIBitmap> CPDF_PatternCellCache::Lookup(const Key& key) {
+  RetainPtr<const CFX_DIBitmap>* cell = cache_.Lookup(key);
+  return cell ? *cell : nullptr;
+}
+
+void CPDF_PatternCellCache::Store(const Key& key,
+                                  RetainPtr<const CFX_DIBitmap> cell) {
+  if (!cell) {
+    return;
+  }
+  const size_t size = static_cast<size_t>(cell->GetPitch()) * cell->GetHeight();
+  if (!cache_.Store(key, std::move(cell), size)) {
+    return;
+  }
+  CPDF_TilingPattern* pattern = key.pattern.get();
+  if (!observers_.contains(pattern)) {
+    observers_.emplace(pattern,
+                       std::make_unique<PatternObserver>(this, pattern));
+  }
+}
+
+void CPDF_PatternCellCache::SetLimit(size_t limit) {
+  cache_.SetLimit(limit);
+}
+
+CPDF_PatternCellCache::Stats CPDF_PatternCellCache::GetStats() const {
+  return cache_.GetStats();
+}
+
+void CPDF_PatternCellCache::OnPatternDestroyed(CPDF_TilingPattern* pattern) {
+  // All cells of `pattern` are next to each other. Cells are at least one
+  // pixel in size, so they all come after `first`.
+  constexpr int32_t kMin = std::numeric_limits<int32_t>::min();
+  Key first(pattern, CFX_Matrix(), CFX_Size(kMin, kMin));
+  first.matrix.fill(kMin);
+  cache_.EraseRange(first, [pattern](const Key& key) {
+    return key.pattern.get() == pattern;
+  });
+  observers_.erase(pattern);
+}
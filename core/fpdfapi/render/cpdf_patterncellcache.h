@@ -0,0 +1,104 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_PATTERNCELLCACHE_H_
+#define CORE_FPDFAPI_RENDER_CPDF_PATTERNCELLCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <map>
+#include <memory>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/lru_cache.h"
+#include "core/fxcrt/observed_ptr.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "core/fxge/dib/fx_dib.h"
+
+class CFX_DIBitmap;
+class CPDF_TilingPattern;
+
+// Rendered cells of the tiling patterns of one document, so that filling
+// many objects with the same pattern, on one page or on many, renders its
+// cell once, up to SetLimit() bytes of them.
+//
+// Does not keep patterns alive. Cells of a pattern go away with it.
+class CPDF_PatternCellCache {
+ public:
+  // Everything a rendered cell depends on, besides the pattern content.
+  struct Key {
+    Key(CPDF_TilingPattern* pattern,
+        const CFX_Matrix& pattern_to_device,
+        const CFX_Size& size);
+    Key(const Key& that);
+    ~Key();
+
+    bool operator<(const Key& other) const;
+
+    // Cells go away with their pattern, so no other pattern can take its
+    // address while they are here.
+    UnownedPtr<CPDF_TilingPattern> pattern;
+    // The a, b, c and d of the pattern to device matrix, in steps of
+    // 1 / kMatrixScale, so that matrices that differ only by float rounding
+    // share cells. The cell does not depend on e and f.
+    std::array<int32_t, 4> matrix;
+    CFX_Size size;
+
+    // The parts of the render options and of the state of the filled object
+    // that end up in the cell.
+    uint8_t color_mode = 0;
+    uint16_t option_flags = 0;
+    float fill_alpha = 1.0f;
+    float stroke_alpha = 1.0f;
+    BlendMode blend_mode = BlendMode::kNormal;
+    bool stroke_adjust = false;
+  };
+
+  using Stats = LruCacheStats;
+
+  static constexpr float kMatrixScale = 65536.0f;
+  static constexpr size_t kDefaultLimit = 16 * 1024 * 1024;
+
+  CPDF_PatternCellCache();
+  ~CPDF_PatternCellCache();
+
+  // Returns the cell stored for `key`, if any.
+  RetainPtr<const CFX_DIBitmap> Lookup(const Key& key);
+
+  // Adds `cell`, unless it alone is over the limit.
+  void Store(const Key& key, RetainPtr<const CFX_DIBitmap> cell);
+
+  // 0 turns the cache off.
+  void SetLimit(size_t limit);
+
+  Stats GetStats() const;
+
+ private:
+  // Drops the cells of one pattern when it goes away.
+  class PatternObserver final : public Observable::ObserverIface {
+   public:
+    PatternObserver(CPDF_PatternCellCache* cache, CPDF_TilingPattern* pattern);
+    ~PatternObserver() override;
+
+    // Observable::ObserverIface:
+    void OnObservableDestroyed() override;
+
+   private:
+    UnownedPtr<CPDF_PatternCellCache> const cache_;
+    // Null once the pattern is gone.
+    UnownedPtr<CPDF_TilingPattern> pattern_;
+  };
+
+  void OnPatternDestroyed(CPDF_TilingPattern* pattern);
+
+  LruCache<Key, RetainPtr<const CFX_DIBitmap>> cache_;
+  // One for every live pattern that had cells stored. Evicting the cells
+  // leaves the observer in place until the pattern goes away.
+  std::map<CPDF_TilingPattern*, std::unique_ptr<PatternObserver>> observers_;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_PATTERNCELLCACHE_H_
@@ -0,0 +1,161 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_patterncellcache.h"
+
+#include <memory>
+#include <utility>
+
+#include "core/fpdfapi/page/cpdf_tilingpattern.h"
+#include "core/fpdfapi/page/test_with_page_module.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fpdfapi/parser/cpdf_test_document.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Key = CPDF_PatternCellCache::Key;
+
+constexpr CFX_Matrix kMatrix(2.0f, 0.0f, 0.0f, 3.0f, 10.0f, 20.0f);
+constexpr CFX_Size kSize(10, 10);
+
+class CPDFPatternCellCacheTest : public TestWithPageModule {
+ public:
+  void SetUp() override {
+    TestWithPageModule::SetUp();
+    doc_ = std::make_unique<CPDF_TestDocument>();
+  }
+
+  void TearDown() override {
+    doc_.reset();
+    TestWithPageModule::TearDown();
+  }
+
+ protected:
+  RetainPtr<CPDF_TilingPattern> MakePattern() {
+    auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+    dict->SetNewFor<CPDF_Number>("PaintType", 1);
+    return pdfium::MakeRetain<CPDF_TilingPattern>(
+        doc_.get(), pdfium::MakeRetain<CPDF_Stream>(std::move(dict)),
+        CFX_Matrix());
+  }
+
+ private:
+  std::unique_ptr<CPDF_TestDocument> doc_;
+};
+
+// Each cell takes 4 bytes per pixel.
+RetainPtr<CFX_DIBitmap> MakeCell(int width, int height) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, FXDIB_Format::kBgra));
+  return bitmap;
+}
+
+}  // namespace
+
+TEST_F(CPDFPatternCellCacheTest, LookupAndStats) {
+  CPDF_PatternCellCache cache;
+  RetainPtr<CPDF_TilingPattern> pattern = MakePattern();
+  RetainPtr<CPDF_TilingPattern> other_pattern = MakePattern();
+  const Key key(pattern.Get(), kMatrix, kSize);
+  EXPECT_FALSE(cache.Lookup(key));
+
+  RetainPtr<CFX_DIBitmap> cell = MakeCell(10, 10);
+  cache.Store(key, cell);
+  EXPECT_EQ(cell, cache.Lookup(key));
+
+  // Moving the pattern does not change the cell, but scaling it does.
+  CFX_Matrix moved = kMatrix;
+  moved.Translate(100.0f, 50.0f);
+  EXPECT_EQ(cell, cache.Lookup(Key(pattern.Get(), moved, kSize)));
+  CFX_Matrix scaled = kMatrix;
+  scaled.Scale(1.5f, 1.5f);
+  EXPECT_FALSE(cache.Lookup(Key(pattern.Get(), scaled, kSize)));
+
+  // Differences well below a pixel do not matter.
+  CFX_Matrix rounded = kMatrix;
+  rounded.a += 1e-6f;
+  EXPECT_EQ(cell, cache.Lookup(Key(pattern.Get(), rounded, kSize)));
+
+  EXPECT_FALSE(cache.Lookup(Key(other_pattern.Get(), kMatrix, kSize)));
+  Key gray_key = key;
+  gray_key.color_mode = 1;
+  EXPECT_FALSE(cache.Lookup(gray_key));
+  Key alpha_key = key;
+  alpha_key.fill_alpha = 0.5f;
+  EXPECT_FALSE(cache.Lookup(alpha_key));
+
+  const CPDF_PatternCellCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(CPDF_PatternCellCache::kDefaultLimit, stats.limit);
+  EXPECT_EQ(400u, stats.size);
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_EQ(3u, stats.hits);
+  EXPECT_EQ(5u, stats.misses);
+}
+
+TEST_F(CPDFPatternCellCacheTest, EvictsLeastRecentlyUsed) {
+  CPDF_PatternCellCache cache;
+  cache.SetLimit(1000);
+  RetainPtr<CPDF_TilingPattern> pattern1 = MakePattern();
+  RetainPtr<CPDF_TilingPattern> pattern2 = MakePattern();
+  RetainPtr<CPDF_TilingPattern> pattern3 = MakePattern();
+  const Key key1(pattern1.Get(), kMatrix, kSize);
+  const Key key2(pattern2.Get(), kMatrix, kSize);
+  const Key key3(pattern3.Get(), kMatrix, kSize);
+
+  cache.Store(key1, MakeCell(10, 10));
+  cache.Store(key2, MakeCell(10, 10));
+  EXPECT_TRUE(cache.Lookup(key1));
+
+  // Makes room by dropping `key2`, which was used longest ago.
+  cache.Store(key3, MakeCell(10, 10));
+  EXPECT_EQ(800u, cache.GetStats().size);
+  EXPECT_TRUE(cache.Lookup(key1));
+  EXPECT_FALSE(cache.Lookup(key2));
+  EXPECT_TRUE(cache.Lookup(key3));
+
+  // Too large on its own.
+  cache.Store(key2, MakeCell(20, 20));
+  EXPECT_FALSE(cache.Lookup(key2));
+  EXPECT_EQ(2u, cache.GetStats().count);
+
+  cache.SetLimit(500);
+  EXPECT_EQ(1u, cache.GetStats().count);
+  EXPECT_TRUE(cache.Lookup(key3));
+
+  cache.SetLimit(0);
+  EXPECT_EQ(0u, cache.GetStats().count);
+  cache.Store(key1, MakeCell(1, 1));
+  EXPECT_EQ(0u, cache.GetStats().count);
+}
+
+TEST_F(CPDFPatternCellCacheTest, CellsGoAwayWithTheirPattern) {
+  CPDF_PatternCellCache cache;
+  RetainPtr<CPDF_TilingPattern> pattern1 = MakePattern();
+  RetainPtr<CPDF_TilingPattern> pattern2 = MakePattern();
+  CFX_Matrix scaled = kMatrix;
+  scaled.Scale(-2.0f, 2.0f);
+  cache.Store(Key(pattern1.Get(), kMatrix, kSize), MakeCell(10, 10));
+  cache.Store(Key(pattern1.Get(), scaled, kSize), MakeCell(10, 10));
+  cache.Store(Key(pattern2.Get(), kMatrix, kSize), MakeCell(10, 10));
+  EXPECT_EQ(3u, cache.GetStats().count);
+
+  // The cache does not keep `pattern1` alive.
+  pattern1.Reset();
+  EXPECT_EQ(1u, cache.GetStats().count);
+  EXPECT_EQ(400u, cache.GetStats().size);
+  EXPECT_TRUE(cache.Lookup(Key(pattern2.Get(), kMatrix, kSize)));
+
+  // A pattern may outlive the cache.
+  auto other_cache = std::make_unique<CPDF_PatternCellCache>();
+  other_cache->Store(Key(pattern2.Get(), kMatrix, kSize), MakeCell(10, 10));
+  other_cache.reset();
+  pattern2.Reset();
+  EXPECT_EQ(0u, cache.GetStats().count);
+}
@@ -6,16 +6,24 @@
 
 #include "core/fpdfapi/render/cpdf_progressiverenderer.h"
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include "build/build_config.h"
+#include "core/fpdfapi/page/cpdf_clippath.h"
+#include "core/fpdfapi/page/cpdf_generalstate.h"
 #include "core/fpdfapi/page/cpdf_image.h"
 #include "core/fpdfapi/page/cpdf_imageobject.h"
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
+#include "core/fpdfapi/render/cpdf_imagerenderer.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfapi/render/cpdf_renderstatus.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/pauseindicator_iface.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxge/cfx_renderdevice.h"
 
 CPDF_ProgressiveRenderer::CPDF_ProgressiveRenderer(
@@ -60,8 +68,16 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
           current_layer_->GetObjectHolder()->GetTransparency());
       render_status_->Initialize(nullptr, nullptr);
       device_->SaveState();
-      clip_rect_ = current_layer_->GetMatrix().GetInverse().TransformRect(
-          CFX_FloatRect(device_->GetClipBox()));
+      clip_rect_ = render_status_->GetCullRect(current_layer_->GetMatrix());
+      visible_objects_.reset();
+      const CPDF_PageObjectHolder* holder = current_layer_->GetObjectHolder();
+      if (holder->ShouldUseSpatialIndex(clip_rect_)) {
+        visible_objects_ = holder->GetPageObjectIndicesInRect(clip_rect_);
+      }
+      // Progressive callers get to pause between images instead.
+      if (!pPause) {
+        PrefetchImages();
+      }
     }
     CPDF_PageObjectHolder::const_iterator iter;
     CPDF_PageObjectHolder::const_iterator iterEnd =
@@ -72,14 +88,12 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
     } else {
       iter = current_layer_->GetObjectHolder()->begin();
     }
+    iter = SkipCulledObjects(iter);
     int nObjsToGo = kStepLimit;
     bool is_mask = false;
     while (iter != iterEnd) {
       CPDF_PageObject* pCurObj = iter->get();
-      if (pCurObj->IsActive() && pCurObj->GetRect().left <= clip_rect_.right &&
-          pCurObj->GetRect().right >= clip_rect_.left &&
-          pCurObj->GetRect().bottom <= clip_rect_.top &&
-          pCurObj->GetRect().top >= clip_rect_.bottom) {
+      if (IsObjectInClipRect(pCurObj)) {
         if (options_->GetOptions().bBreakForMasks && pCurObj->IsImage() &&
             pCurObj->AsImage()->GetImage()->IsMask()) {
 #if BUILDFLAG(IS_WIN)
@@ -116,6 +130,7 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
         nObjsToGo = kStepLimit;
       }
       ++iter;
+      iter = SkipCulledObjects(iter);
       if (is_mask && iter != iterEnd) {
         return;
       }
@@ -140,3 +155,72 @@ void CPDF_ProgressiveRenderer::Continue(PauseIndicatorIface* pPause) {
     }
   }
 }
+
+CPDF_PageObjectHolder::const_iterator
+CPDF_ProgressiveRenderer::SkipCulledObjects(
+    CPDF_PageObjectHolder::const_iterator iter) const {
+  if (!visible_objects_.has_value()) {
+    return iter;
+  }
+  const CPDF_PageObjectHolder* holder = current_layer_->GetObjectHolder();
+  const size_t position = std::distance(holder->begin(), iter);
+  auto it = std::lower_bound(visible_objects_->begin(),
+                             visible_objects_->end(), position);
+  if (it == visible_objects_->end()) {
+    return holder->end();
+  }
+  return std::next(holder->begin(), *it);
+}
+
+bool CPDF_ProgressiveRenderer::IsObjectInClipRect(
+    const CPDF_PageObject* object) const {
+  return object->IsActive() && object->GetRect().left <= clip_rect_.right &&
+         object->GetRect().right >= clip_rect_.left &&
+         object->GetRect().bottom <= clip_rect_.top &&
+         object->GetRect().top >= clip_rect_.bottom;
+}
+
+void CPDF_ProgressiveRenderer::PrefetchImages() {
+  CPDF_PageImageCache* cache = context_->GetPageCache();
+  const CPDF_RenderOptions& options = render_status_->GetRenderOptions();
+  const CPDF_PageObjectHolder* holder = current_layer_->GetObjectHolder();
+  if (!cache || options.GetOptions().bLimitedImageCache ||
+      holder->GetParseState() != CPDF_PageObjectHolder::ParseState::kParsed) {
+    return;
+  }
+
+  std::vector<CPDF_PageImageCache::PrefetchRequest> requests;
+  for (auto iter = SkipCulledObjects(holder->begin()); iter != holder->end();
+       iter = SkipCulledObjects(++iter)) {
+    const CPDF_PageObject* object = iter->get();
+    if (!object->IsImage() || !IsObjectInClipRect(object) ||
+        !options.CheckPageObjectVisible(object)) {
+      continue;
+    }
+    // These draw through a transparency group, whose status may load the
+    // image with other arguments.
+    if (object->general_state().GetBlendType() != BlendMode::kNormal ||
+        object->general_state().GetSoftMask() ||
+        (object->clip_path().HasRef() &&
+         object->clip_path().GetTextCount() > 0)) {
+      continue;
+    }
+    const CPDF_ImageObject* image_object = object->AsImage();
+    RetainPtr<CPDF_Image> image = image_object->GetImage();
+    const CFX_Size max_size_required = CPDF_ImageRenderer::GetMaxSizeRequired(
+        image.Get(), image_object->matrix() * current_layer_->GetMatrix());
+    requests.push_back({std::move(image), max_size_required});
+  }
+  if (requests.size() < 2) {
+    return;
+  }
+
+  // The same arguments that CPDF_ImageRenderer passes for top level images,
+  // apart from the visible region, which only matters for the JPEG 2000
+  // images that PrefetchBitmaps() leaves alone.
+  cache->PrefetchBitmaps(ThreadPool::Get(), requests,
+                         render_status_->GetFormResource(),
+                         render_status_->GetPageResource(),
+                         /*bStdCS=*/false, render_status_->GetGroupFamily(),
+                         render_status_->GetLoadMask());
+}
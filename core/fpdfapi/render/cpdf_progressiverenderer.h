@@ -10,12 +10,15 @@
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_pageobjectholder.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/unowned_ptr.h"
 
+class CPDF_PageObject;
 class CPDF_RenderOptions;
 class CPDF_RenderStatus;
 class CFX_RenderDevice;
@@ -46,6 +49,17 @@ class CPDF_ProgressiveRenderer {
   // Maximum page objects to render before checking for pause.
   static constexpr int kStepLimit = 100;
 
+  // Returns `iter`, or the first object after it that is not culled by the
+  // spatial index lookup, if any.
+  CPDF_PageObjectHolder::const_iterator SkipCulledObjects(
+      CPDF_PageObjectHolder::const_iterator iter) const;
+
+  bool IsObjectInClipRect(const CPDF_PageObject* object) const;
+
+  // Starts decoding the current layer's visible images ahead of drawing them,
+  // so that they decode in parallel, with each other and with the drawing.
+  void PrefetchImages();
+
   Status status_ = kReady;
   UnownedPtr<CPDF_RenderContext> const context_;
   UnownedPtr<CFX_RenderDevice> const device_;
@@ -55,6 +69,9 @@ class CPDF_ProgressiveRenderer {
   uint32_t layer_index_ = 0;
   UnownedPtr<CPDF_RenderContext::Layer> current_layer_;
   CPDF_PageObjectHolder::const_iterator last_object_rendered_;
+  // Indices of the current layer's objects that intersect `clip_rect_`, when
+  // looked up through the layer's spatial index.
+  std::optional<std::vector<size_t>> visible_objects_;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_PROGRESSIVERENDERER_H_
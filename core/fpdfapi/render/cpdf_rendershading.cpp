@@ -18,12 +18,16 @@
 #include "core/fpdfapi/page/cpdf_dib.h"
 #include "core/fpdfapi/page/cpdf_function.h"
 #include "core/fpdfapi/page/cpdf_meshstream.h"
+#include "core/fpdfapi/page/cpdf_shadingpattern.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fpdfapi/render/cpdf_devicebuffer.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
+#include "core/fpdfapi/render/shading_simd.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
@@ -33,6 +37,7 @@
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_fillrenderoptions.h"
@@ -42,7 +47,9 @@
 
 namespace {
 
-constexpr int kShadingSteps = 256;
+// Bitmaps with fewer pixels than this are shaded on one thread, as handing
+// work to other threads would cost more than it saves.
+constexpr int64_t kMinPixelsForThreads = 1 << 20;
 
 uint32_t CountOutputsFromFunctions(
     const std::vector<std::unique_ptr<CPDF_Function>>& funcs) {
@@ -106,11 +113,73 @@ float ComponentToShadingIndex(float c, float c_min, float c_max) {
   return ((c - c_min) / (c_max - c_min)) * (kShadingSteps - 1);
 }
 
+// Returns the steps of an axial or radial shading, from the document's cache
+// where it has them.
+bool GetAxisShadingSteps(CPDF_RenderContext* context,
+                         const CPDF_ShadingPattern* pattern,
+                         float t_min,
+                         float t_max,
+                         int alpha,
+                         ShadingSteps* output) {
+  CPDF_DocRenderData* render_data =
+      CPDF_DocRenderData::FromDocument(context->GetDocument());
+  if (!render_data) {
+    return GetShadingSteps(t_min, t_max, pattern->GetFuncs(), pattern->GetCS(),
+                           alpha, output);
+  }
+
+  RetainPtr<const CPDF_Object> shading = pattern->GetShadingObject();
+  const ShadingSteps* steps =
+      render_data->GetCachedShadingSteps(shading, t_min, t_max);
+  ShadingSteps new_steps;
+  if (!steps) {
+    if (!GetShadingSteps(t_min, t_max, pattern->GetFuncs(), pattern->GetCS(),
+                         /*alpha=*/0, &new_steps)) {
+      return false;
+    }
+    render_data->CacheShadingSteps(std::move(shading), t_min, t_max,
+                                   new_steps);
+    steps = &new_steps;
+  }
+  for (int i = 0; i < kShadingSteps; ++i) {
+    (*output)[i] = (*steps)[i] | ArgbEncode(alpha, 0, 0, 0);
+  }
+  return true;
+}
+
+// Calls `fn(row)` for every row of `bitmap`, on several threads for bitmaps
+// large enough to make that worth it. `fn` may only write to its row.
+template <typename Fn>
+void ForEachRow(const CFX_DIBitmap* bitmap, const Fn& fn) {
+  const int height = bitmap->GetHeight();
+  const int64_t pixels = static_cast<int64_t>(bitmap->GetWidth()) * height;
+  const size_t thread_count = pixels < kMinPixelsForThreads
+                                  ? 1
+                                  : ThreadPool::GetMaxConcurrency();
+  if (thread_count <= 1) {
+    for (int row = 0; row < height; ++row) {
+      fn(row);
+    }
+    return;
+  }
+
+  const int per_thread =
+      (height + static_cast<int>(thread_count) - 1) / thread_count;
+  const int band_count = (height + per_thread - 1) / per_thread;
+  ThreadPool::ParallelFor(band_count, [&](size_t band) {
+    const int begin = static_cast<int>(band) * per_thread;
+    const int end = std::min(begin + per_thread, height);
+    for (int row = begin; row < end; ++row) {
+      fn(row);
+    }
+  });
+}
+
 void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
                       const CFX_Matrix& mtObject2Bitmap,
                       const CPDF_Dictionary* dict,
-                      const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
-                      const RetainPtr<CPDF_ColorSpace>& pCS,
+                      CPDF_RenderContext* context,
+                      const CPDF_ShadingPattern* pattern,
                       int alpha) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
@@ -119,8 +188,9 @@ void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
     return;
   }
 
-  float start_x = pCoords->GetFloatAt(0);
-  float start_y = pCoords->GetFloatAt(1);
+  AxialShadingParams params;
+  params.start_x = pCoords->GetFloatAt(0);
+  params.start_y = pCoords->GetFloatAt(1);
   float end_x = pCoords->GetFloatAt(2);
   float end_y = pCoords->GetFloatAt(3);
   float t_min = 0;
@@ -131,54 +201,35 @@ void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
     t_max = pArray->GetFloatAt(1);
   }
   pArray = dict->GetArrayFor("Extend");
-  const bool bStartExtend = pArray && pArray->GetBooleanAt(0, false);
-  const bool bEndExtend = pArray && pArray->GetBooleanAt(1, false);
+  params.extend_start = pArray && pArray->GetBooleanAt(0, false);
+  params.extend_end = pArray && pArray->GetBooleanAt(1, false);
 
-  int width = pBitmap->GetWidth();
-  int height = pBitmap->GetHeight();
-  float x_span = end_x - start_x;
-  float y_span = end_y - start_y;
-  float axis_len_square = (x_span * x_span) + (y_span * y_span);
+  params.x_span = end_x - params.start_x;
+  params.y_span = end_y - params.start_y;
+  params.axis_len_square =
+      (params.x_span * params.x_span) + (params.y_span * params.y_span);
 
-  std::array<FX_ARGB, kShadingSteps> shading_steps;
-  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, &shading_steps)) {
+  ShadingSteps shading_steps;
+  if (!GetAxisShadingSteps(context, pattern, t_min, t_max, alpha,
+                           &shading_steps)) {
     return;
   }
 
-  CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
-  for (int row = 0; row < height; row++) {
-    auto dest_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
-        static_cast<size_t>(width));
-    size_t column_counter = 0;
-    for (auto& pix : dest_buf) {
-      const float column = static_cast<float>(column_counter++);
-      const CFX_PointF pos =
-          matrix.Transform(CFX_PointF(column, static_cast<float>(row)));
-      float scale =
-          (((pos.x - start_x) * x_span) + ((pos.y - start_y) * y_span)) /
-          axis_len_square;
-      int index = static_cast<int32_t>(scale * (kShadingSteps - 1));
-      if (index < 0) {
-        if (!bStartExtend) {
-          continue;
-        }
-        index = 0;
-      } else if (index >= kShadingSteps) {
-        if (!bEndExtend) {
-          continue;
-        }
-        index = kShadingSteps - 1;
-      }
-      pix = shading_steps[index];
-    }
-  }
+  params.bitmap_to_shading = mtObject2Bitmap.GetInverse();
+  const size_t width = pBitmap->GetWidth();
+  CFX_DIBitmap* bitmap = pBitmap.Get();
+  ForEachRow(bitmap, [&](int row) {
+    FillAxialShadingRow(params, shading_steps, row,
+                        bitmap->GetWritableScanlineAs<uint32_t>(row).first(
+                            width));
+  });
 }
 
 void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
                        const CFX_Matrix& mtObject2Bitmap,
                        const CPDF_Dictionary* dict,
-                       const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
-                       const RetainPtr<CPDF_ColorSpace>& pCS,
+                       CPDF_RenderContext* context,
+                       const CPDF_ShadingPattern* pattern,
                        int alpha) {
   DCHECK_EQ(pBitmap->GetFormat(), FXDIB_Format::kBgra);
 
@@ -187,9 +238,10 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
     return;
   }
 
-  float start_x = pCoords->GetFloatAt(0);
-  float start_y = pCoords->GetFloatAt(1);
-  float start_r = pCoords->GetFloatAt(2);
+  RadialShadingParams params;
+  params.start_x = pCoords->GetFloatAt(0);
+  params.start_y = pCoords->GetFloatAt(1);
+  params.start_r = pCoords->GetFloatAt(2);
   float end_x = pCoords->GetFloatAt(3);
   float end_y = pCoords->GetFloatAt(4);
   float end_r = pCoords->GetFloatAt(5);
@@ -201,77 +253,32 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
     t_max = pArray->GetFloatAt(1);
   }
   pArray = dict->GetArrayFor("Extend");
-  const bool bStartExtend = pArray && pArray->GetBooleanAt(0, false);
-  const bool bEndExtend = pArray && pArray->GetBooleanAt(1, false);
+  params.extend_start = pArray && pArray->GetBooleanAt(0, false);
+  params.extend_end = pArray && pArray->GetBooleanAt(1, false);
 
-  std::array<FX_ARGB, kShadingSteps> shading_steps;
-  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, &shading_steps)) {
+  ShadingSteps shading_steps;
+  if (!GetAxisShadingSteps(context, pattern, t_min, t_max, alpha,
+                           &shading_steps)) {
     return;
   }
 
-  const float dx = end_x - start_x;
-  const float dy = end_y - start_y;
-  const float dr = end_r - start_r;
-  const float a = dx * dx + dy * dy - dr * dr;
-  const bool a_is_float_zero = FXSYS_IsFloatZero(a);
-
-  int width = pBitmap->GetWidth();
-  int height = pBitmap->GetHeight();
-  bool bDecreasing = dr < 0 && static_cast<int>(hypotf(dx, dy)) < -dr;
-
-  CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
-  for (int row = 0; row < height; row++) {
-    auto dest_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
-        static_cast<size_t>(width));
-    size_t column_counter = 0;
-    for (auto& pix : dest_buf) {
-      const float column = static_cast<float>(column_counter++);
-      const CFX_PointF pos =
-          matrix.Transform(CFX_PointF(column, static_cast<float>(row)));
-      float pos_dx = pos.x - start_x;
-      float pos_dy = pos.y - start_y;
-      float b = -2 * (pos_dx * dx + pos_dy * dy + start_r * dr);
-      float c = pos_dx * pos_dx + pos_dy * pos_dy - start_r * start_r;
-      float s;
-      if (FXSYS_IsFloatZero(b)) {
-        s = sqrt(-c / a);
-      } else if (a_is_float_zero) {
-        s = -c / b;
-      } else {
-        float b2_4ac = (b * b) - 4 * (a * c);
-        if (b2_4ac < 0) {
-          continue;
-        }
-        float root = sqrt(b2_4ac);
-        float s1 = (-b - root) / (2 * a);
-        float s2 = (-b + root) / (2 * a);
-        if (a <= 0) {
-          std::swap(s1, s2);
-        }
-        if (bDecreasing) {
-          s = (s1 >= 0 || bStartExtend) ? s1 : s2;
-        } else {
-          s = (s2 <= 1.0f || bEndExtend) ? s2 : s1;
-        }
-        if (start_r + s * dr < 0) {
-          continue;
-        }
-      }
-      int index = static_cast<int32_t>(s * (kShadingSteps - 1));
-      if (index < 0) {
-        if (!bStartExtend) {
-          continue;
-        }
-        index = 0;
-      } else if (index >= kShadingSteps) {
-        if (!bEndExtend) {
-          continue;
-        }
-        index = kShadingSteps - 1;
-      }
-      pix = shading_steps[index];
-    }
-  }
+  params.dx = end_x - params.start_x;
+  params.dy = end_y - params.start_y;
+  params.dr = end_r - params.start_r;
+  params.a = params.dx * params.dx + params.dy * params.dy -
+             params.dr * params.dr;
+  params.decreasing = params.dr < 0 &&
+                      static_cast<int>(hypotf(params.dx, params.dy)) <
+                          -params.dr;
+
+  params.bitmap_to_shading = mtObject2Bitmap.GetInverse();
+  const size_t width = pBitmap->GetWidth();
+  CFX_DIBitmap* bitmap = pBitmap.Get();
+  ForEachRow(bitmap, [&](int row) {
+    FillRadialShadingRow(params, shading_steps, row,
+                         bitmap->GetWritableScanlineAs<uint32_t>(row).first(
+                             width));
+  });
 }
 
 void DrawFuncShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
@@ -1059,11 +1066,11 @@ void CPDF_RenderShading::Draw(CFX_RenderDevice* pDevice,
                       alpha);
       break;
     case kAxialShading:
-      DrawAxialShading(pBitmap, final_matrix, dict.Get(), funcs, pColorSpace,
+      DrawAxialShading(pBitmap, final_matrix, dict.Get(), pContext, pPattern,
                        alpha);
       break;
     case kRadialShading:
-      DrawRadialShading(pBitmap, final_matrix, dict.Get(), funcs, pColorSpace,
+      DrawRadialShading(pBitmap, final_matrix, dict.Get(), pContext, pPattern,
                         alpha);
       break;
     case kFreeFormGouraudTriangleMeshShading: {
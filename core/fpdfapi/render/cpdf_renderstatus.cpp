@@ -80,7 +80,7 @@
 namespace {
 
 constexpr int kRenderMaxRecursionDepth = 64;
-int g_CurrentRecursionDepth = 0;
+thread_local int g_CurrentRecursionDepth = 0;
 
 CFX_FillRenderOptions GetFillOptionsForDrawPathWithBlend(
     const CPDF_RenderOptions::Options& options,
@@ -208,11 +208,34 @@ void CPDF_RenderStatus::Initialize(const CPDF_RenderStatus* pParentStatus,
   }
 }
 
+CFX_FloatRect CPDF_RenderStatus::GetCullRect(
+    const CFX_Matrix& mtObj2Device) const {
+  CFX_FloatRect rect(device_->GetClipBox());
+  rect.Inflate(1.0f, 1.0f);
+  return mtObj2Device.GetInverse().TransformRect(rect);
+}
+
 void CPDF_RenderStatus::RenderObjectList(
     const CPDF_PageObjectHolder* pObjectHolder,
     const CFX_Matrix& mtObj2Device) {
-  CFX_FloatRect clip_rect = mtObj2Device.GetInverse().TransformRect(
-      CFX_FloatRect(device_->GetClipBox()));
+  const CFX_FloatRect clip_rect = GetCullRect(mtObj2Device);
+
+  // `stop_obj_` may lie outside `clip_rect`, so only a full walk is
+  // guaranteed to find it.
+  if (!stop_obj_ && pObjectHolder->ShouldUseSpatialIndex(clip_rect)) {
+    for (size_t index : pObjectHolder->GetPageObjectIndicesInRect(clip_rect)) {
+      CPDF_PageObject* pCurObj = pObjectHolder->GetPageObjectByIndex(index);
+      if (!pCurObj || !pCurObj->IsActive()) {
+        continue;
+      }
+      RenderSingleObject(pCurObj, mtObj2Device);
+      if (stopped_) {
+        return;
+      }
+    }
+    return;
+  }
+
   for (const auto& pCurObj : *pObjectHolder) {
     if (pCurObj.get() == stop_obj_) {
       stopped_ = true;
@@ -1055,7 +1078,8 @@ bool CPDF_RenderStatus::ProcessType3Text(CPDF_TextObject* textobj,
       RetainPtr<CPDF_Type3Cache> pCache =
           CPDF_DocRenderData::FromDocument(doc)->GetCachedType3(pType3Font);
 
-      const CFX_GlyphBitmap* pBitmap = pCache->LoadGlyph(charcode, matrix);
+      RetainPtr<const CFX_GlyphBitmap> pBitmap =
+          pCache->LoadGlyph(charcode, matrix);
       if (!pBitmap) {
         continue;
       }
@@ -71,6 +71,10 @@ class CPDF_RenderStatus {
   void Initialize(const CPDF_RenderStatus* pParentStatus,
                   const CPDF_GraphicStates* pInitialStates);
 
+  // Returns the part of object space that objects must intersect to be drawn.
+  // It reaches a pixel past the clip box, since glyphs can stick out of the
+  // bounds of their text objects by that much.
+  CFX_FloatRect GetCullRect(const CFX_Matrix& mtObj2Device) const;
   void RenderObjectList(const CPDF_PageObjectHolder* pObjectHolder,
                         const CFX_Matrix& mtObj2Device);
   void RenderSingleObject(CPDF_PageObject* pObj,
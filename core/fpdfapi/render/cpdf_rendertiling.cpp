@@ -8,12 +8,17 @@
 
 #include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "core/fpdfapi/page/cpdf_form.h"
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
+#include "core/fpdfapi/page/cpdf_pageobject.h"
 #include "core/fpdfapi/page/cpdf_tilingpattern.h"
+#include "core/fpdfapi/page/cpdf_transferfunc.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_patterncellcache.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fpdfapi/render/cpdf_renderstatus.h"
@@ -67,6 +72,82 @@ RetainPtr<CFX_DIBitmap> DrawPatternBitmap(
   return pBitmap;
 }
 
+RetainPtr<const CFX_DIBitmap> DrawPatternCell(
+    CPDF_RenderContext* pContext,
+    CPDF_TilingPattern* pPattern,
+    CPDF_Form* pPatternForm,
+    const CFX_Matrix& mtObj2Device,
+    int width,
+    int height,
+    const CPDF_RenderOptions& options) {
+  RetainPtr<CFX_DIBitmap> pPatternBitmap;
+  if (width * height < 16) {
+    RetainPtr<CFX_DIBitmap> pEnlargedBitmap = DrawPatternBitmap(
+        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
+        pPatternForm, mtObj2Device, 8, 8, options.GetOptions());
+    pPatternBitmap = pEnlargedBitmap->StretchTo(
+        width, height, FXDIB_ResampleOptions(), nullptr);
+  } else {
+    pPatternBitmap = DrawPatternBitmap(
+        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
+        pPatternForm, mtObj2Device, width, height, options.GetOptions());
+  }
+  if (!pPatternBitmap) {
+    return nullptr;
+  }
+
+  if (options.ColorModeIs(CPDF_RenderOptions::kGray)) {
+    pPatternBitmap->ConvertColorScale(0, 0xffffff);
+  }
+  return pPatternBitmap;
+}
+
+// Returns the key of the cell, or nothing if it should not be cached. Leaves
+// out the fill color, as that goes on after the cell for uncolored patterns,
+// and is not used at all for colored ones.
+std::optional<CPDF_PatternCellCache::Key> GetPatternCellKey(
+    CPDF_TilingPattern* pPattern,
+    const CPDF_PageObject* pPageObj,
+    const CFX_Matrix& mtPattern2Device,
+    int width,
+    int height,
+    const CPDF_RenderOptions& options) {
+  const CPDF_RenderOptions::Options& draw_options = options.GetOptions();
+  if (draw_options.bLimitedImageCache) {
+    return std::nullopt;
+  }
+
+  // CPDF_TilingPattern::Load() parses the pattern content with the general
+  // state of the filled object, so the cell depends on it. Leave out the rare
+  // states with parts that are hard to compare.
+  const CPDF_GeneralState& state = pPageObj->general_state();
+  if (state.GetSoftMask() || state.GetTR() || state.GetTransferFunc()) {
+    return std::nullopt;
+  }
+
+  CPDF_PatternCellCache::Key key(pPattern, mtPattern2Device,
+                                 CFX_Size(width, height));
+  // The cell is drawn with options of its own, so of the color modes, only
+  // the gray conversion after it matters.
+  if (options.ColorModeIs(CPDF_RenderOptions::kGray)) {
+    key.color_mode = CPDF_RenderOptions::kGray;
+  }
+  const bool flags[] = {
+      draw_options.bClearType,     draw_options.bNoNativeText,
+      draw_options.bForceHalftone, draw_options.bRectAA,
+      draw_options.bBreakForMasks, draw_options.bNoTextSmooth,
+      draw_options.bNoPathSmooth,  draw_options.bNoImageSmooth,
+  };
+  for (bool flag : flags) {
+    key.option_flags = (key.option_flags << 1) | flag;
+  }
+  key.fill_alpha = state.GetFillAlpha();
+  key.stroke_alpha = state.GetStrokeAlpha();
+  key.blend_mode = state.GetBlendType();
+  key.stroke_adjust = state.GetStrokeAdjust();
+  return key;
+}
+
 }  // namespace
 
 // static
@@ -120,8 +201,11 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderTiling::Draw(
   CFX_RenderDevice* pDevice = pRenderStatus->GetRenderDevice();
   CPDF_RenderContext* pContext = pRenderStatus->GetContext();
   const CPDF_RenderOptions& options = pRenderStatus->GetRenderOptions();
-  if (width > clip_box.Width() || height > clip_box.Height() ||
-      width * height > clip_box.Width() * clip_box.Height()) {
+  // Cells too big for the device are drawn in place rather than as a bitmap.
+  // This goes by the device rather than by the clip box, so that parts of a
+  // page drawn through different clips still match.
+  if (width > pDevice->GetWidth() || height > pDevice->GetHeight() ||
+      width * height > pDevice->GetWidth() * pDevice->GetHeight()) {
     std::unique_ptr<CPDF_GraphicStates> pStates;
     if (!pPattern->colored()) {
       pStates = CPDF_RenderStatus::CloneObjStates(&pPageObj->graphic_states(),
@@ -185,24 +269,28 @@ RetainPtr<CFX_DIBitmap> CPDF_RenderTiling::Draw(
   }
   float left_offset = cell_bbox.left - mtPattern2Device.e;
   float top_offset = cell_bbox.bottom - mtPattern2Device.f;
-  RetainPtr<CFX_DIBitmap> pPatternBitmap;
-  if (width * height < 16) {
-    RetainPtr<CFX_DIBitmap> pEnlargedBitmap = DrawPatternBitmap(
-        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
-        pPatternForm, mtObj2Device, 8, 8, options.GetOptions());
-    pPatternBitmap = pEnlargedBitmap->StretchTo(
-        width, height, FXDIB_ResampleOptions(), nullptr);
-  } else {
-    pPatternBitmap = DrawPatternBitmap(
-        pContext->GetDocument(), pContext->GetPageCache(), pPattern,
-        pPatternForm, mtObj2Device, width, height, options.GetOptions());
+  CPDF_DocRenderData* pRenderData =
+      CPDF_DocRenderData::FromDocument(pContext->GetDocument());
+  CPDF_PatternCellCache* pCellCache =
+      pRenderData ? pRenderData->GetPatternCellCache() : nullptr;
+  std::optional<CPDF_PatternCellCache::Key> cell_key;
+  if (pCellCache) {
+    cell_key = GetPatternCellKey(pPattern, pPageObj, mtPattern2Device, width,
+                                 height, options);
   }
-  if (!pPatternBitmap) {
-    return nullptr;
+  RetainPtr<const CFX_DIBitmap> pPatternBitmap;
+  if (cell_key.has_value()) {
+    pPatternBitmap = pCellCache->Lookup(cell_key.value());
   }
-
-  if (options.ColorModeIs(CPDF_RenderOptions::kGray)) {
-    pPatternBitmap->ConvertColorScale(0, 0xffffff);
+  if (!pPatternBitmap) {
+    pPatternBitmap = DrawPatternCell(pContext, pPattern, pPatternForm,
+                                     mtObj2Device, width, height, options);
+    if (!pPatternBitmap) {
+      return nullptr;
+    }
+    if (cell_key.has_value()) {
+      pCellCache->Store(cell_key.value(), pPatternBitmap);
+    }
   }
 
   FX_ARGB fill_argb = pRenderStatus->GetFillArgb(pPageObj);
@@ -50,12 +50,13 @@ std::pair<int, int> CPDF_Type3GlyphMap::AdjustBlue(float top, float bottom) {
                         AdjustBlueHelper(bottom, &bottom_blue_));
 }
 
-const CFX_GlyphBitmap* CPDF_Type3GlyphMap::GetBitmap(uint32_t charcode) const {
+RetainPtr<const CFX_GlyphBitmap> CPDF_Type3GlyphMap::GetBitmap(
+    uint32_t charcode) const {
   auto it = glyph_map_.find(charcode);
-  return it != glyph_map_.end() ? it->second.get() : nullptr;
+  return it != glyph_map_.end() ? it->second : nullptr;
 }
 
 void CPDF_Type3GlyphMap::SetBitmap(uint32_t charcode,
-                                   std::unique_ptr<CFX_GlyphBitmap> bitmap) {
+                                   RetainPtr<CFX_GlyphBitmap> bitmap) {
   glyph_map_[charcode] = std::move(bitmap);
 }
@@ -10,10 +10,11 @@
 #include <stdint.h>
 
 #include <map>
-#include <memory>
 #include <utility>
 #include <vector>
 
+#include "core/fxcrt/retain_ptr.h"
+
 class CFX_GlyphBitmap;
 
 class CPDF_Type3GlyphMap {
@@ -24,13 +25,13 @@ class CPDF_Type3GlyphMap {
   // Returns a pair of integers (top_line, bottom_line).
   std::pair<int, int> AdjustBlue(float top, float bottom);
 
-  const CFX_GlyphBitmap* GetBitmap(uint32_t charcode) const;
-  void SetBitmap(uint32_t charcode, std::unique_ptr<CFX_GlyphBitmap> bitmap);
+  RetainPtr<const CFX_GlyphBitmap> GetBitmap(uint32_t charcode) const;
+  void SetBitmap(uint32_t charcode, RetainPtr<CFX_GlyphBitmap> bitmap);
 
  private:
   std::vector<int> top_blue_;
   std::vector<int> bottom_blue_;
-  std::map<uint32_t, std::unique_ptr<CFX_GlyphBitmap>> glyph_map_;
+  std::map<uint32_t, RetainPtr<CFX_GlyphBitmap>> glyph_map_;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_TYPE3GLYPHMAP_H_
@@ -2,11 +2,30 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+
+#include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_patterncellcache.h"
 #include "public/cpp/fpdf_scopers.h"
+#include "public/fpdfview.h"
 #include "testing/embedder_test.h"
 #include "testing/embedder_test_constants.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+CPDF_PatternCellCache* GetPatternCellCache(FPDF_DOCUMENT document) {
+  // This is cheating slightly to avoid a layering violation, since this file
+  // cannot include fpdfsdk/cpdfsdk_helpers.h to get access to
+  // CPDFDocumentFromFPDFDocument().
+  return CPDF_DocRenderData::FromDocument(
+             reinterpret_cast<CPDF_Document*>(document))
+      ->GetPatternCellCache();
+}
+
+}  // namespace
+
 class FPDFRenderPatternEmbedderTest : public EmbedderTest {};
 
 TEST_F(FPDFRenderPatternEmbedderTest, LoadError547706) {
@@ -17,3 +36,31 @@ TEST_F(FPDFRenderPatternEmbedderTest, LoadError547706) {
   ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
   CompareBitmap(bitmap.get(), 612, 792, pdfium::kBlankPage612By792Checksum);
 }
+
+TEST_F(FPDFRenderPatternEmbedderTest, CachedCellsRenderTheSame) {
+  ASSERT_TRUE(OpenDocument("tiling_pattern_fills.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  CPDF_PatternCellCache* cache = GetPatternCellCache(document());
+
+  for (int flags : {0, FPDF_GRAYSCALE}) {
+    SCOPED_TRACE(flags);
+    cache->SetLimit(0);
+    ScopedFPDFBitmap uncached = RenderLoadedPageWithFlags(page.get(), flags);
+    const std::string uncached_hash = HashBitmap(uncached.get());
+
+    cache->SetLimit(CPDF_PatternCellCache::kDefaultLimit);
+    ScopedFPDFBitmap filled = RenderLoadedPageWithFlags(page.get(), flags);
+    EXPECT_EQ(uncached_hash, HashBitmap(filled.get()));
+    const CPDF_PatternCellCache::Stats filled_stats = cache->GetStats();
+    EXPECT_GT(filled_stats.count, 0u);
+    EXPECT_GT(filled_stats.hits, 0u);
+
+    // Every fill finds its cell now.
+    ScopedFPDFBitmap cached = RenderLoadedPageWithFlags(page.get(), flags);
+    EXPECT_EQ(uncached_hash, HashBitmap(cached.get()));
+    const CPDF_PatternCellCache::Stats cached_stats = cache->GetStats();
+    EXPECT_EQ(filled_stats.count, cached_stats.count);
+    EXPECT_EQ(filled_stats.misses, cached_stats.misses);
+  }
+}
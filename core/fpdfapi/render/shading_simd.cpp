@@ -0,0 +1,198 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/shading_simd.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "build/build_config.h"
+#include "core/fpdfapi/render/shading_simd_impl.h"
+#include "core/fxcrt/fx_system.h"
+#include "core/fxge/dib/simd_level.h"
+
+namespace {
+
+using fpdfapi::simd_internal::AxialArgs;
+using fpdfapi::simd_internal::RadialArgs;
+using fpdfapi::simd_internal::ShadingKernels;
+using fpdfapi::simd_internal::ShadingRowArgs;
+
+const ShadingKernels* GetKernels() {
+  static constexpr fxge::SimdKernelSet<ShadingKernels> kKernels = {
+#if defined(ARCH_CPU_X86_FAMILY)
+      .sse2 = &fpdfapi::simd_internal::GetSse2ShadingKernels,
+#elif defined(ARCH_CPU_ARM64)
+      .neon = &fpdfapi::simd_internal::GetNeonShadingKernels,
+#endif
+  };
+  return fxge::GetSimdKernels(kKernels);
+}
+
+ShadingRowArgs GetRowArgs(const CFX_Matrix& matrix,
+                          const ShadingSteps& steps,
+                          int row,
+                          pdfium::span<uint32_t> dest,
+                          bool extend_start,
+                          bool extend_end) {
+  return {
+      .a = matrix.a,
+      .b = matrix.b,
+      .c = matrix.c,
+      .d = matrix.d,
+      .e = matrix.e,
+      .f = matrix.f,
+      .row = static_cast<float>(row),
+      .steps = steps.data(),
+      .dest = dest.data(),
+      .width = dest.size(),
+      .extend_start = extend_start,
+      .extend_end = extend_end,
+  };
+}
+
+// Sets `pix` to the step at `s`, unless that is outside of the shading.
+void SetPixel(float s,
+              const ShadingSteps& steps,
+              bool extend_start,
+              bool extend_end,
+              uint32_t& pix) {
+  int index = static_cast<int32_t>(s * (kShadingSteps - 1));
+  if (index < 0) {
+    if (!extend_start) {
+      return;
+    }
+    index = 0;
+  } else if (index >= kShadingSteps) {
+    if (!extend_end) {
+      return;
+    }
+    index = kShadingSteps - 1;
+  }
+  pix = steps[index];
+}
+
+void FillAxialPixels(const AxialShadingParams& params,
+                     const ShadingSteps& steps,
+                     int row,
+                     pdfium::span<uint32_t> dest,
+                     size_t begin,
+                     size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    const CFX_PointF pos = params.bitmap_to_shading.Transform(
+        CFX_PointF(static_cast<float>(i), static_cast<float>(row)));
+    float scale = (((pos.x - params.start_x) * params.x_span) +
+                   ((pos.y - params.start_y) * params.y_span)) /
+                  params.axis_len_square;
+    SetPixel(scale, steps, params.extend_start, params.extend_end, dest[i]);
+  }
+}
+
+void FillRadialPixels(const RadialShadingParams& params,
+                      const ShadingSteps& steps,
+                      int row,
+                      pdfium::span<uint32_t> dest,
+                      size_t begin,
+                      size_t end) {
+  const float a = params.a;
+  const bool a_is_float_zero = FXSYS_IsFloatZero(a);
+  for (size_t i = begin; i < end; ++i) {
+    const CFX_PointF pos = params.bitmap_to_shading.Transform(
+        CFX_PointF(static_cast<float>(i), static_cast<float>(row)));
+    float pos_dx = pos.x - params.start_x;
+    float pos_dy = pos.y - params.start_y;
+    float b = -2 * (pos_dx * params.dx + pos_dy * params.dy +
+                    params.start_r * params.dr);
+    float c = pos_dx * pos_dx + pos_dy * pos_dy -
+              params.start_r * params.start_r;
+    float s;
+    if (FXSYS_IsFloatZero(b)) {
+      s = sqrt(-c / a);
+    } else if (a_is_float_zero) {
+      s = -c / b;
+    } else {
+      float b2_4ac = (b * b) - 4 * (a * c);
+      if (b2_4ac < 0) {
+        continue;
+      }
+      float root = sqrt(b2_4ac);
+      float s1 = (-b - root) / (2 * a);
+      float s2 = (-b + root) / (2 * a);
+      if (a <= 0) {
+        std::swap(s1, s2);
+      }
+      if (params.decreasing) {
+        s = (s1 >= 0 || params.extend_start) ? s1 : s2;
+      } else {
+        s = (s2 <= 1.0f || params.extend_end) ? s2 : s1;
+      }
+      if (params.start_r + s * params.dr < 0) {
+        continue;
+      }
+    }
+    SetPixel(s, steps, params.extend_start, params.extend_end, dest[i]);
+  }
+}
+
+}  // namespace
+
+void FillAxialShadingRow(const AxialShadingParams& params,
+                         const ShadingSteps& steps,
+                         int row,
+                         pdfium::span<uint32_t> dest) {
+  size_t i = 0;
+  const ShadingKernels* kernels = GetKernels();
+  if (kernels) {
+    const ShadingRowArgs row_args =
+        GetRowArgs(params.bitmap_to_shading, steps, row, dest,
+                   params.extend_start, params.extend_end);
+    const AxialArgs axial_args = {
+        .start_x = params.start_x,
+        .start_y = params.start_y,
+        .x_span = params.x_span,
+        .y_span = params.y_span,
+        .axis_len_square = params.axis_len_square,
+    };
+    i = kernels->fill_axial_row(row_args, axial_args, 0);
+  }
+  FillAxialPixels(params, steps, row, dest, i, dest.size());
+}
+
+void FillRadialShadingRow(const RadialShadingParams& params,
+                          const ShadingSteps& steps,
+                          int row,
+                          pdfium::span<uint32_t> dest) {
+  const ShadingKernels* kernels =
+      FXSYS_IsFloatZero(params.a) ? nullptr : GetKernels();
+  if (!kernels) {
+    FillRadialPixels(params, steps, row, dest, 0, dest.size());
+    return;
+  }
+
+  const ShadingRowArgs row_args =
+      GetRowArgs(params.bitmap_to_shading, steps, row, dest,
+                 params.extend_start, params.extend_end);
+  const RadialArgs radial_args = {
+      .start_x = params.start_x,
+      .start_y = params.start_y,
+      .start_r = params.start_r,
+      .dx = params.dx,
+      .dy = params.dy,
+      .dr = params.dr,
+      .a = params.a,
+      .decreasing = params.decreasing,
+  };
+  size_t i = 0;
+  while (i < dest.size()) {
+    i = kernels->fill_radial_row(row_args, radial_args, i);
+    // Where the kernel stopped early, the next pixels are near the point where
+    // the scalar code takes another path.
+    const size_t end =
+        std::min(i + fpdfapi::simd_internal::kShadingVectorPixels, dest.size());
+    FillRadialPixels(params, steps, row, dest, i, end);
+    i = end;
+  }
+}
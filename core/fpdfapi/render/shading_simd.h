@@ -0,0 +1,69 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_SHADING_SIMD_H_
+#define CORE_FPDFAPI_RENDER_SHADING_SIMD_H_
+
+#include <stdint.h>
+
+#include <array>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/fx_dib.h"
+
+// Row functions for filling bitmaps with axial and radial shadings. They use
+// the SIMD kernels for fxge::GetSimdLevel() where there are some, and do the
+// same float operations in the same order either way, so the results do not
+// depend on it.
+
+inline constexpr int kShadingSteps = 256;
+
+// The colors of a shading at `kShadingSteps` evenly spaced points of its
+// domain.
+using ShadingSteps = std::array<FX_ARGB, kShadingSteps>;
+
+struct AxialShadingParams {
+  // Maps bitmap pixels to shading space.
+  CFX_Matrix bitmap_to_shading;
+  float start_x = 0.0f;
+  float start_y = 0.0f;
+  float x_span = 0.0f;
+  float y_span = 0.0f;
+  // x_span^2 + y_span^2.
+  float axis_len_square = 0.0f;
+  bool extend_start = false;
+  bool extend_end = false;
+};
+
+struct RadialShadingParams {
+  // Maps bitmap pixels to shading space.
+  CFX_Matrix bitmap_to_shading;
+  float start_x = 0.0f;
+  float start_y = 0.0f;
+  float start_r = 0.0f;
+  // The differences between the end and start circles.
+  float dx = 0.0f;
+  float dy = 0.0f;
+  float dr = 0.0f;
+  // dx^2 + dy^2 - dr^2.
+  float a = 0.0f;
+  // Whether the start circle encloses the end one.
+  bool decreasing = false;
+  bool extend_start = false;
+  bool extend_end = false;
+};
+
+// Sets the pixels of row `row` of a bitmap, `dest`, that the shading covers to
+// their color in `steps`, and leaves the others as they are.
+void FillAxialShadingRow(const AxialShadingParams& params,
+                         const ShadingSteps& steps,
+                         int row,
+                         pdfium::span<uint32_t> dest);
+void FillRadialShadingRow(const RadialShadingParams& params,
+                          const ShadingSteps& steps,
+                          int row,
+                          pdfium::span<uint32_t> dest);
+
+#endif  // CORE_FPDFAPI_RENDER_SHADING_SIMD_H_
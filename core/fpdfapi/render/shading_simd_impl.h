@@ -0,0 +1,75 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_SHADING_SIMD_IMPL_H_
+#define CORE_FPDFAPI_RENDER_SHADING_SIMD_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared by the per-instruction set translation units. See
+// core/fxge/dib/composite_simd_impl.h for what may go in here.
+
+namespace fpdfapi::simd_internal {
+
+// The arguments of the row functions in shading_simd.h, flattened. `steps`
+// has 256 entries and `dest` has `width` pixels.
+struct ShadingRowArgs {
+  // The bitmap to shading matrix.
+  float a;
+  float b;
+  float c;
+  float d;
+  float e;
+  float f;
+  float row;
+  const uint32_t* steps;
+  uint32_t* dest;
+  size_t width;
+  bool extend_start;
+  bool extend_end;
+};
+
+struct AxialArgs {
+  float start_x;
+  float start_y;
+  float x_span;
+  float y_span;
+  float axis_len_square;
+};
+
+struct RadialArgs {
+  float start_x;
+  float start_y;
+  float start_r;
+  float dx;
+  float dy;
+  float dr;
+  // Not close to 0, for which the callers use the scalar code.
+  float a;
+  bool decreasing;
+};
+
+// Each kernel fills the pixels of a row from column `begin` on, and returns
+// where it stopped: before the last pixels that do not fill a vector, or
+// before a vector of pixels that needs the scalar code. The caller does those,
+// and may then call the kernel again.
+struct ShadingKernels {
+  size_t (*fill_axial_row)(const ShadingRowArgs& row,
+                           const AxialArgs& axial,
+                           size_t begin);
+  size_t (*fill_radial_row)(const ShadingRowArgs& row,
+                            const RadialArgs& radial,
+                            size_t begin);
+};
+
+// How many pixels the kernels do at a time.
+constexpr size_t kShadingVectorPixels = 4;
+
+const ShadingKernels& GetSse2ShadingKernels();
+const ShadingKernels& GetNeonShadingKernels();
+
+}  // namespace fpdfapi::simd_internal
+
+#endif  // CORE_FPDFAPI_RENDER_SHADING_SIMD_IMPL_H_
@@ -0,0 +1,165 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "core/fpdfapi/render/shading_simd_impl.h"
+#include "core/fxcrt/compiler_specific.h"
+
+namespace fpdfapi::simd_internal {
+
+namespace {
+
+uint32x4_t AllLanes(bool value) {
+  return vdupq_n_u32(value ? 0xffffffff : 0);
+}
+
+// The shading space position of 4 pixels, from the matrix in `row`.
+struct Positions {
+  float32x4_t x;
+  float32x4_t y;
+};
+
+Positions GetPositions(const ShadingRowArgs& row, size_t column) {
+  static constexpr uint32_t kLanes[4] = {0, 1, 2, 3};
+  const float32x4_t columns = vcvtq_f32_u32(
+      vaddq_u32(vdupq_n_u32(static_cast<uint32_t>(column)), vld1q_u32(kLanes)));
+  // In the same order as CFX_Matrix::Transform(), without fused multiply-adds.
+  return {
+      .x = vaddq_f32(vaddq_f32(vmulq_n_f32(columns, row.a),
+                               vdupq_n_f32(row.c * row.row)),
+                     vdupq_n_f32(row.e)),
+      .y = vaddq_f32(vaddq_f32(vmulq_n_f32(columns, row.b),
+                               vdupq_n_f32(row.d * row.row)),
+                     vdupq_n_f32(row.f)),
+  };
+}
+
+// Sets the pixels at `column` to the steps at `s`, for the lanes set in
+// `covered` that are within the shading or its extensions.
+void SetPixels(const ShadingRowArgs& row,
+               size_t column,
+               float32x4_t s,
+               uint32x4_t covered) {
+  const int32x4_t index = vcvtq_s32_f32(vmulq_n_f32(s, 255.0f));
+  const uint32x4_t below = vcltq_s32(index, vdupq_n_s32(0));
+  const uint32x4_t above = vcgtq_s32(index, vdupq_n_s32(255));
+  uint32x4_t outside = vdupq_n_u32(0);
+  if (!row.extend_start) {
+    outside = vorrq_u32(outside, below);
+  }
+  if (!row.extend_end) {
+    outside = vorrq_u32(outside, above);
+  }
+  const uint32x4_t set = vbicq_u32(covered, outside);
+  if (!vmaxvq_u32(set)) {
+    return;
+  }
+
+  uint32_t lanes[4];
+  int32_t indices[4];
+  vst1q_u32(lanes, set);
+  vst1q_s32(indices, vminq_s32(vmaxq_s32(index, vdupq_n_s32(0)),
+                               vdupq_n_s32(255)));
+  // SAFETY: the caller makes sure `column + 4 <= row.width`, and `indices`
+  // are in [0, 255].
+  UNSAFE_BUFFERS({
+    for (int lane = 0; lane < 4; ++lane) {
+      if (lanes[lane]) {
+        row.dest[column + lane] = row.steps[indices[lane]];
+      }
+    }
+  });
+}
+
+size_t FillAxialRow(const ShadingRowArgs& row,
+                    const AxialArgs& axial,
+                    size_t begin) {
+  const float32x4_t start_x = vdupq_n_f32(axial.start_x);
+  const float32x4_t start_y = vdupq_n_f32(axial.start_y);
+  const float32x4_t axis_len_square = vdupq_n_f32(axial.axis_len_square);
+  const uint32x4_t all = AllLanes(true);
+  size_t i = begin;
+  for (; i + kShadingVectorPixels <= row.width; i += kShadingVectorPixels) {
+    const Positions pos = GetPositions(row, i);
+    const float32x4_t scale = vdivq_f32(
+        vaddq_f32(vmulq_n_f32(vsubq_f32(pos.x, start_x), axial.x_span),
+                  vmulq_n_f32(vsubq_f32(pos.y, start_y), axial.y_span)),
+        axis_len_square);
+    SetPixels(row, i, scale, all);
+  }
+  return i;
+}
+
+size_t FillRadialRow(const ShadingRowArgs& row,
+                     const RadialArgs& radial,
+                     size_t begin) {
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t start_x = vdupq_n_f32(radial.start_x);
+  const float32x4_t start_y = vdupq_n_f32(radial.start_y);
+  const float32x4_t start_r = vdupq_n_f32(radial.start_r);
+  const float32x4_t start_r_dr = vdupq_n_f32(radial.start_r * radial.dr);
+  const float32x4_t start_r_square =
+      vdupq_n_f32(radial.start_r * radial.start_r);
+  const float32x4_t two_a = vdupq_n_f32(2 * radial.a);
+  // FXSYS_IsFloatZero() compares with a double, so leave a little room.
+  const float32x4_t near_zero = vdupq_n_f32(0.0002f);
+  const uint32x4_t extend_start = AllLanes(row.extend_start);
+  const uint32x4_t extend_end = AllLanes(row.extend_end);
+  size_t i = begin;
+  for (; i + kShadingVectorPixels <= row.width; i += kShadingVectorPixels) {
+    const Positions pos = GetPositions(row, i);
+    const float32x4_t pos_dx = vsubq_f32(pos.x, start_x);
+    const float32x4_t pos_dy = vsubq_f32(pos.y, start_y);
+    const float32x4_t b = vmulq_n_f32(
+        vaddq_f32(vaddq_f32(vmulq_n_f32(pos_dx, radial.dx),
+                            vmulq_n_f32(pos_dy, radial.dy)),
+                  start_r_dr),
+        -2.0f);
+    if (vmaxvq_u32(vcltq_f32(vabsq_f32(b), near_zero))) {
+      break;
+    }
+
+    const float32x4_t c =
+        vsubq_f32(vaddq_f32(vmulq_f32(pos_dx, pos_dx),
+                            vmulq_f32(pos_dy, pos_dy)),
+                  start_r_square);
+    const float32x4_t b2_4ac =
+        vsubq_f32(vmulq_f32(b, b), vmulq_n_f32(vmulq_n_f32(c, radial.a), 4.0f));
+    const float32x4_t root = vsqrtq_f32(b2_4ac);
+    const float32x4_t minus_b = vnegq_f32(b);
+    float32x4_t s1 = vdivq_f32(vsubq_f32(minus_b, root), two_a);
+    float32x4_t s2 = vdivq_f32(vaddq_f32(minus_b, root), two_a);
+    if (radial.a <= 0) {
+      const float32x4_t swap = s1;
+      s1 = s2;
+      s2 = swap;
+    }
+    float32x4_t s;
+    if (radial.decreasing) {
+      s = vbslq_f32(vorrq_u32(vcgeq_f32(s1, zero), extend_start), s1, s2);
+    } else {
+      s = vbslq_f32(
+          vorrq_u32(vcleq_f32(s2, vdupq_n_f32(1.0f)), extend_end), s2, s1);
+    }
+    const uint32x4_t uncovered = vorrq_u32(
+        vcltq_f32(b2_4ac, zero),
+        vcltq_f32(vaddq_f32(start_r, vmulq_n_f32(s, radial.dr)), zero));
+    SetPixels(row, i, s, vmvnq_u32(uncovered));
+  }
+  return i;
+}
+
+constexpr ShadingKernels kKernels = {
+    .fill_axial_row = &FillAxialRow,
+    .fill_radial_row = &FillRadialRow,
+};
+
+}  // namespace
+
+const ShadingKernels& GetNeonShadingKernels() {
+  return kKernels;
+}
+
+}  // namespace fpdfapi::simd_internal
@@ -0,0 +1,80 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fpdfapi/render/shading_simd.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxge/dib/simd_level.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_test_helpers.h"
+
+namespace {
+
+constexpr int kSize = 2048;
+constexpr int kRuns = 9;
+
+ShadingSteps MakeSteps() {
+  ShadingSteps steps;
+  for (int i = 0; i < kShadingSteps; ++i) {
+    steps[i] = ArgbEncode(255, i, 255 - i, i / 2);
+  }
+  return steps;
+}
+
+// Fills a `kSize` squared bitmap with `fill_row`, once without SIMD and once
+// at the level of the running CPU.
+template <typename Params, typename FillRow>
+void CompareFillTimes(const char* name,
+                      const Params& params,
+                      FillRow fill_row) {
+  const ShadingSteps steps = MakeSteps();
+  std::vector<uint32_t> bitmap(kSize * kSize);
+  auto fill = [&params, &fill_row, &steps, &bitmap] {
+    for (int row = 0; row < kSize; ++row) {
+      fill_row(params, steps, row,
+               pdfium::span(bitmap).subspan(static_cast<size_t>(row) * kSize,
+                                            static_cast<size_t>(kSize)));
+    }
+  };
+
+  {
+    fxge::ScopedSimdLevelForTesting scoped_level(fxge::SimdLevel::kNone);
+    PrintPerfResult(name, "scalar", MedianRunTime(kRuns, fill));
+  }
+  PrintPerfResult(name, "simd", MedianRunTime(kRuns, fill));
+}
+
+}  // namespace
+
+TEST(ShadingSimdPerfTest, FillAxialShadingRow) {
+  AxialShadingParams params;
+  params.bitmap_to_shading = CFX_Matrix(0.0005f, 0.0002f, -0.0002f, 0.0005f,
+                                        0.0f, 0.0f);
+  params.x_span = 1.0f;
+  params.y_span = 0.5f;
+  params.axis_len_square = 1.25f;
+  params.extend_start = true;
+  params.extend_end = true;
+  CompareFillTimes("shading_fill_axial_2048", params, &FillAxialShadingRow);
+}
+
+TEST(ShadingSimdPerfTest, FillRadialShadingRow) {
+  RadialShadingParams params;
+  params.bitmap_to_shading =
+      CFX_Matrix(1.0f / kSize, 0.0f, 0.0f, 1.0f / kSize, 0.0f, 0.0f);
+  params.start_x = 0.3f;
+  params.start_y = 0.5f;
+  params.start_r = 0.05f;
+  params.dx = 0.2f;
+  params.dy = 0.0f;
+  params.dr = 0.65f;
+  params.a = params.dx * params.dx + params.dy * params.dy -
+             params.dr * params.dr;
+  params.extend_start = true;
+  params.extend_end = true;
+  CompareFillTimes("shading_fill_radial_2048", params, &FillRadialShadingRow);
+}
@@ -0,0 +1,175 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <emmintrin.h>
+
+#include "core/fpdfapi/render/shading_simd_impl.h"
+#include "core/fxcrt/compiler_specific.h"
+
+namespace fpdfapi::simd_internal {
+
+namespace {
+
+// Selects `a` where `mask` is set, and `b` elsewhere.
+__m128 Select(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__m128 AllLanes(bool value) {
+  return _mm_castsi128_ps(_mm_set1_epi32(value ? -1 : 0));
+}
+
+// The shading space position of 4 pixels, from the matrix in `row`.
+struct Positions {
+  __m128 x;
+  __m128 y;
+};
+
+Positions GetPositions(const ShadingRowArgs& row, size_t column) {
+  const __m128 columns = _mm_cvtepi32_ps(
+      _mm_add_epi32(_mm_set1_epi32(static_cast<int>(column)),
+                    _mm_setr_epi32(0, 1, 2, 3)));
+  // In the same order as CFX_Matrix::Transform().
+  return {
+      .x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row.a), columns),
+                                 _mm_set1_ps(row.c * row.row)),
+                      _mm_set1_ps(row.e)),
+      .y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row.b), columns),
+                                 _mm_set1_ps(row.d * row.row)),
+                      _mm_set1_ps(row.f)),
+  };
+}
+
+// Sets the pixels at `column` to the steps at `s`, for the lanes set in
+// `covered` that are within the shading or its extensions.
+void SetPixels(const ShadingRowArgs& row,
+               size_t column,
+               __m128 s,
+               __m128 covered) {
+  __m128i index = _mm_cvttps_epi32(_mm_mul_ps(s, _mm_set1_ps(255.0f)));
+  const __m128i below = _mm_cmplt_epi32(index, _mm_setzero_si128());
+  const __m128i above = _mm_cmpgt_epi32(index, _mm_set1_epi32(255));
+  __m128i outside = _mm_setzero_si128();
+  if (!row.extend_start) {
+    outside = _mm_or_si128(outside, below);
+  }
+  if (!row.extend_end) {
+    outside = _mm_or_si128(outside, above);
+  }
+  index = _mm_andnot_si128(below, index);
+  index = _mm_or_si128(_mm_andnot_si128(above, index),
+                       _mm_and_si128(above, _mm_set1_epi32(255)));
+  const int mask =
+      _mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(outside), covered));
+  if (!mask) {
+    return;
+  }
+
+  alignas(16) int32_t indices[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+  // SAFETY: the caller makes sure `column + 4 <= row.width`, and `indices`
+  // are in [0, 255].
+  UNSAFE_BUFFERS({
+    for (int lane = 0; lane < 4; ++lane) {
+      if (mask & (1 << lane)) {
+        row.dest[column + lane] = row.steps[indices[lane]];
+      }
+    }
+  });
+}
+
+size_t FillAxialRow(const ShadingRowArgs& row,
+                    const AxialArgs& axial,
+                    size_t begin) {
+  const __m128 start_x = _mm_set1_ps(axial.start_x);
+  const __m128 start_y = _mm_set1_ps(axial.start_y);
+  const __m128 x_span = _mm_set1_ps(axial.x_span);
+  const __m128 y_span = _mm_set1_ps(axial.y_span);
+  const __m128 axis_len_square = _mm_set1_ps(axial.axis_len_square);
+  const __m128 all = AllLanes(true);
+  size_t i = begin;
+  for (; i + kShadingVectorPixels <= row.width; i += kShadingVectorPixels) {
+    const Positions pos = GetPositions(row, i);
+    const __m128 scale = _mm_div_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_sub_ps(pos.x, start_x), x_span),
+                   _mm_mul_ps(_mm_sub_ps(pos.y, start_y), y_span)),
+        axis_len_square);
+    SetPixels(row, i, scale, all);
+  }
+  return i;
+}
+
+size_t FillRadialRow(const ShadingRowArgs& row,
+                     const RadialArgs& radial,
+                     size_t begin) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  const __m128 start_x = _mm_set1_ps(radial.start_x);
+  const __m128 start_y = _mm_set1_ps(radial.start_y);
+  const __m128 start_r = _mm_set1_ps(radial.start_r);
+  const __m128 dx = _mm_set1_ps(radial.dx);
+  const __m128 dy = _mm_set1_ps(radial.dy);
+  const __m128 dr = _mm_set1_ps(radial.dr);
+  const __m128 a = _mm_set1_ps(radial.a);
+  const __m128 start_r_dr = _mm_set1_ps(radial.start_r * radial.dr);
+  const __m128 start_r_square = _mm_set1_ps(radial.start_r * radial.start_r);
+  const __m128 two_a = _mm_set1_ps(2 * radial.a);
+  // FXSYS_IsFloatZero() compares with a double, so leave a little room.
+  const __m128 near_zero = _mm_set1_ps(0.0002f);
+  const __m128 extend_start = AllLanes(row.extend_start);
+  const __m128 extend_end = AllLanes(row.extend_end);
+  size_t i = begin;
+  for (; i + kShadingVectorPixels <= row.width; i += kShadingVectorPixels) {
+    const Positions pos = GetPositions(row, i);
+    const __m128 pos_dx = _mm_sub_ps(pos.x, start_x);
+    const __m128 pos_dy = _mm_sub_ps(pos.y, start_y);
+    const __m128 b = _mm_mul_ps(
+        _mm_set1_ps(-2.0f),
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(pos_dx, dx), _mm_mul_ps(pos_dy, dy)),
+                   start_r_dr));
+    if (_mm_movemask_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, b), near_zero))) {
+      break;
+    }
+
+    const __m128 c = _mm_sub_ps(
+        _mm_add_ps(_mm_mul_ps(pos_dx, pos_dx), _mm_mul_ps(pos_dy, pos_dy)),
+        start_r_square);
+    const __m128 b2_4ac = _mm_sub_ps(
+        _mm_mul_ps(b, b), _mm_mul_ps(_mm_set1_ps(4.0f), _mm_mul_ps(a, c)));
+    const __m128 root = _mm_sqrt_ps(b2_4ac);
+    const __m128 minus_b = _mm_xor_ps(b, sign);
+    __m128 s1 = _mm_div_ps(_mm_sub_ps(minus_b, root), two_a);
+    __m128 s2 = _mm_div_ps(_mm_add_ps(minus_b, root), two_a);
+    if (radial.a <= 0) {
+      const __m128 swap = s1;
+      s1 = s2;
+      s2 = swap;
+    }
+    __m128 s;
+    if (radial.decreasing) {
+      s = Select(_mm_or_ps(_mm_cmpge_ps(s1, zero), extend_start), s1, s2);
+    } else {
+      s = Select(_mm_or_ps(_mm_cmple_ps(s2, _mm_set1_ps(1.0f)), extend_end),
+                 s2, s1);
+    }
+    const __m128 uncovered =
+        _mm_or_ps(_mm_cmplt_ps(b2_4ac, zero),
+                  _mm_cmplt_ps(_mm_add_ps(start_r, _mm_mul_ps(s, dr)), zero));
+    SetPixels(row, i, s, _mm_xor_ps(uncovered, AllLanes(true)));
+  }
+  return i;
+}
+
+constexpr ShadingKernels kKernels = {
+    .fill_axial_row = &FillAxialRow,
+    .fill_radial_row = &FillRadialRow,
+};
+
+}  // namespace
+
+const ShadingKernels& GetSse2ShadingKernels() {
+  return kKernels;
+}
+
+}  // namespace fpdfapi::simd_internal
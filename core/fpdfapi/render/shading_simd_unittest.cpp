@@ -0,0 +1,156 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/shading_simd.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxge/dib/simd_test_support.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Pixels that the shading does not cover keep this value.
+constexpr uint32_t kBackground = 0xcdcdcdcd;
+
+// Bitmap to shading matrices: plain scaling, scaling with an offset and a
+// rotation, so that the shading runs across rows in different directions.
+const CFX_Matrix kMatrices[] = {
+    CFX_Matrix(0.01f, 0, 0, 0.01f, 0, 0),
+    CFX_Matrix(0.013f, 0, 0, -0.011f, -0.2f, 0.9f),
+    CFX_Matrix(0.007f, 0.007f, -0.007f, 0.007f, 0.3f, -0.1f),
+};
+
+ShadingSteps MakeSteps() {
+  ShadingSteps steps;
+  for (int i = 0; i < kShadingSteps; ++i) {
+    steps[i] = ArgbEncode(255, i, 255 - i, i / 2);
+  }
+  return steps;
+}
+
+template <typename Params, typename FillRow>
+void ExpectSameAtAllLevels(const Params& params, FillRow fill_row) {
+  const ShadingSteps steps = MakeSteps();
+  for (size_t width : fxge::kSimdTestLengths) {
+    for (int row : {0, 7, 50}) {
+      auto fill = [&] {
+        std::vector<uint32_t> result(width, kBackground);
+        fill_row(params, steps, row, result);
+        return result;
+      };
+      const std::vector<uint32_t> expected = fxge::RunWithoutSimd(fill);
+      fxge::ForEachSupportedSimdLevel([&] {
+        EXPECT_EQ(expected, fill()) << "width " << width << ", row " << row;
+      });
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ShadingSimd, FillAxialShadingRow) {
+  struct Axis {
+    float start_x;
+    float start_y;
+    float end_x;
+    float end_y;
+  };
+  static constexpr Axis kAxes[] = {
+      {0.0f, 0.0f, 1.0f, 0.0f},
+      {0.2f, 0.1f, 0.6f, 0.8f},
+      {1.0f, 1.0f, 0.0f, 0.25f},
+  };
+  for (const CFX_Matrix& matrix : kMatrices) {
+    for (const Axis& axis : kAxes) {
+      for (bool extend_start : {false, true}) {
+        for (bool extend_end : {false, true}) {
+          AxialShadingParams params;
+          params.bitmap_to_shading = matrix;
+          params.start_x = axis.start_x;
+          params.start_y = axis.start_y;
+          params.x_span = axis.end_x - axis.start_x;
+          params.y_span = axis.end_y - axis.start_y;
+          params.axis_len_square = (params.x_span * params.x_span) +
+                                   (params.y_span * params.y_span);
+          params.extend_start = extend_start;
+          params.extend_end = extend_end;
+          ExpectSameAtAllLevels(params, &FillAxialShadingRow);
+        }
+      }
+    }
+  }
+}
+
+TEST(ShadingSimd, FillRadialShadingRow) {
+  struct Circles {
+    float start_x;
+    float start_y;
+    float start_r;
+    float end_x;
+    float end_y;
+    float end_r;
+  };
+  static constexpr Circles kCircles[] = {
+      // Concentric, growing.
+      {0.5f, 0.5f, 0.0f, 0.5f, 0.5f, 0.5f},
+      // Concentric, shrinking, so the start circle encloses the end one.
+      {0.4f, 0.3f, 0.6f, 0.4f, 0.3f, 0.1f},
+      // Apart, so that parts of the bitmap are not covered.
+      {0.1f, 0.2f, 0.1f, 0.8f, 0.7f, 0.2f},
+      // The end circle touches the start one, so `a` is 0.
+      {0.2f, 0.2f, 0.1f, 0.5f, 0.6f, 0.6f},
+      // Offset with the end circle enclosing the start one.
+      {0.3f, 0.5f, 0.05f, 0.5f, 0.5f, 0.7f},
+  };
+  for (const CFX_Matrix& matrix : kMatrices) {
+    for (const Circles& circles : kCircles) {
+      for (bool extend_start : {false, true}) {
+        for (bool extend_end : {false, true}) {
+          RadialShadingParams params;
+          params.bitmap_to_shading = matrix;
+          params.start_x = circles.start_x;
+          params.start_y = circles.start_y;
+          params.start_r = circles.start_r;
+          params.dx = circles.end_x - circles.start_x;
+          params.dy = circles.end_y - circles.start_y;
+          params.dr = circles.end_r - circles.start_r;
+          params.a = params.dx * params.dx + params.dy * params.dy -
+                     params.dr * params.dr;
+          params.decreasing =
+              params.dr < 0 &&
+              static_cast<int>(hypotf(params.dx, params.dy)) < -params.dr;
+          params.extend_start = extend_start;
+          params.extend_end = extend_end;
+          ExpectSameAtAllLevels(params, &FillRadialShadingRow);
+        }
+      }
+    }
+  }
+}
+
+TEST(ShadingSimd, FillAxialShadingRowValues) {
+  fxge::ScopedSimdLevelForTesting scoped_level(fxge::SimdLevel::kNone);
+  const ShadingSteps steps = MakeSteps();
+  AxialShadingParams params;
+  // Pixel i is at i / 4 along the axis.
+  params.bitmap_to_shading = CFX_Matrix(0.25f, 0, 0, 1, 0, 0);
+  params.x_span = 1.0f;
+  params.axis_len_square = 1.0f;
+
+  std::vector<uint32_t> row(6, kBackground);
+  FillAxialShadingRow(params, steps, 0, row);
+  EXPECT_EQ(std::vector<uint32_t>({steps[0], steps[63], steps[127], steps[191],
+                                   steps[255], kBackground}),
+            row);
+
+  params.extend_end = true;
+  FillAxialShadingRow(params, steps, 0, row);
+  EXPECT_EQ(steps[255], row[5]);
+}
@@ -0,0 +1,143 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/bilevel_reducer.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "core/fxcodec/scanlinedecoder.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxge/calculate_pitch.h"
+
+namespace fxcodec {
+
+namespace {
+
+class ReducedBilevelDecoder final : public ScanlineDecoder {
+ public:
+  ReducedBilevelDecoder(std::unique_ptr<ScanlineDecoder> src,
+                        int width,
+                        int height,
+                        int factor)
+      : ScanlineDecoder(
+            width,
+            height,
+            BilevelReducer::ReducedSize(width, factor),
+            BilevelReducer::ReducedSize(height, factor),
+            /*nComps=*/1,
+            /*nBpc=*/8,
+            fxge::CalculatePitch32OrDie(
+                8,
+                BilevelReducer::ReducedSize(width, factor))),
+        src_(std::move(src)),
+        reducer_(width, factor),
+        factor_(factor),
+        line_buf_(pitch_) {}
+
+  ~ReducedBilevelDecoder() override {
+    // Span in superclass can't outlive our buffer.
+    last_scanline_ = pdfium::span<uint8_t>();
+  }
+
+  // ScanlineDecoder:
+  bool Rewind() override {
+    src_line_ = 0;
+    return true;
+  }
+
+  pdfium::span<uint8_t> GetNextLine() override {
+    if (src_line_ >= orig_height_) {
+      return pdfium::span<uint8_t>();
+    }
+    for (int i = 0; i < factor_ && src_line_ < orig_height_; ++i) {
+      reducer_.AddRow(src_->GetScanline(src_line_++));
+    }
+    reducer_.TakeRow(pdfium::span(line_buf_).first(
+        static_cast<size_t>(reducer_.dest_width())));
+    return line_buf_;
+  }
+
+  uint32_t GetSrcOffset() override { return src_->GetSrcOffset(); }
+
+ private:
+  std::unique_ptr<ScanlineDecoder> const src_;
+  BilevelReducer reducer_;
+  const int factor_;
+  int src_line_ = 0;
+  DataVector<uint8_t> line_buf_;
+};
+
+}  // namespace
+
+// static
+std::unique_ptr<ScanlineDecoder> BilevelReducer::CreateDecoder(
+    std::unique_ptr<ScanlineDecoder> decoder,
+    int width,
+    int height,
+    int factor) {
+  CHECK_EQ(decoder->CountComps() * decoder->GetBPC(), 1);
+  CHECK_GE(decoder->GetWidth(), width);
+  return std::make_unique<ReducedBilevelDecoder>(std::move(decoder), width,
+                                                 height, factor);
+}
+
+BilevelReducer::BilevelReducer(int src_width, int factor)
+    : src_width_(src_width),
+      factor_(factor),
+      sums_(ReducedSize(src_width, factor)) {
+  CHECK_GT(src_width, 0);
+  CHECK(std::has_single_bit(static_cast<unsigned>(factor)));
+  CHECK_LE(factor, kMaxFactor);
+}
+
+BilevelReducer::~BilevelReducer() = default;
+
+void BilevelReducer::AddRow(pdfium::span<const uint8_t> src) {
+  ++rows_;
+  const size_t row_bytes = (static_cast<size_t>(src_width_) + 7) / 8;
+  src = src.first(std::min(src.size(), row_bytes));
+  const size_t tail_byte = src_width_ / 8;
+  const int tail_bits = src_width_ % 8;
+  pdfium::span<uint32_t> sums = sums_;
+  for (size_t i = 0; i < src.size(); ++i) {
+    uint8_t byte = src[i];
+    if (i == tail_byte) {
+      // Bits past `src_width_` are padding.
+      byte &= static_cast<uint8_t>(0xff << (8 - tail_bits));
+    }
+    if (!byte) {
+      continue;
+    }
+    if (factor_ >= 8) {
+      sums[i / (factor_ / 8)] += std::popcount(byte);
+      continue;
+    }
+    // Blocks are `factor_` bits, so several fit in one byte.
+    const uint8_t block_mask = (1 << factor_) - 1;
+    size_t x = i * (8 / factor_);
+    for (int shift = 8 - factor_; shift >= 0 && x < sums.size();
+         shift -= factor_, ++x) {
+      sums[x] += std::popcount(static_cast<uint8_t>((byte >> shift) &
+                                                    block_mask));
+    }
+  }
+}
+
+void BilevelReducer::TakeRow(pdfium::span<uint8_t> dest) {
+  for (size_t x = 0; x < sums_.size(); ++x) {
+    const int columns =
+        std::min(factor_, src_width_ - static_cast<int>(x) * factor_);
+    const uint32_t count = static_cast<uint32_t>(columns * rows_);
+    dest[x] = count ? static_cast<uint8_t>((sums_[x] * 255 + count / 2) /
+                                           count)
+                    : 0;
+  }
+  std::ranges::fill(sums_, 0);
+  rows_ = 0;
+}
+
+}  // namespace fxcodec
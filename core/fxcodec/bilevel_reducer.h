@@ -0,0 +1,65 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCODEC_BILEVEL_REDUCER_H_
+#define CORE_FXCODEC_BILEVEL_REDUCER_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+
+namespace fxcodec {
+
+class ScanlineDecoder;
+
+// Shrinks 1 bit per pixel rows by a power of two `factor` in both directions
+// as they come in, so full size images never have to exist. Each block of
+// `factor` by `factor` pixels becomes one 8 bit pixel, the share of its bits
+// that are set, scaled to 0 to 255. Blocks on the right and bottom edges may
+// be smaller.
+class BilevelReducer {
+ public:
+  static constexpr int kMaxFactor = 32;
+
+  static int ReducedSize(int size, int factor) {
+    return (size + factor - 1) / factor;
+  }
+
+  // Wraps `decoder`, which must decode at least `width` pixels wide 1 bit per
+  // pixel rows, into one that decodes reduced rows of its first `width` by
+  // `height` pixels.
+  static std::unique_ptr<ScanlineDecoder> CreateDecoder(
+      std::unique_ptr<ScanlineDecoder> decoder,
+      int width,
+      int height,
+      int factor);
+
+  BilevelReducer(int src_width, int factor);
+  ~BilevelReducer();
+
+  int dest_width() const { return static_cast<int>(sums_.size()); }
+
+  // Adds the next source row. An empty `src` counts as a row of zeros.
+  void AddRow(pdfium::span<const uint8_t> src);
+
+  // Writes the row of blocks made of the rows added since the last call to
+  // `dest`, which must hold dest_width() bytes.
+  void TakeRow(pdfium::span<uint8_t> dest);
+
+ private:
+  const int src_width_;
+  const int factor_;
+  int rows_ = 0;
+  // The set bits in each block so far.
+  DataVector<uint32_t> sums_;
+};
+
+}  // namespace fxcodec
+
+using fxcodec::BilevelReducer;
+
+#endif  // CORE_FXCODEC_BILEVEL_REDUCER_H_
@@ -0,0 +1,131 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/bilevel_reducer.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/fxcodec/scanlinedecoder.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::ElementsAre;
+
+namespace {
+
+// Hands out the rows it was made with, 1 bit per pixel.
+class FakeBilevelDecoder final : public ScanlineDecoder {
+ public:
+  FakeBilevelDecoder(int width, std::vector<std::vector<uint8_t>> rows)
+      : ScanlineDecoder(width,
+                        static_cast<int>(rows.size()),
+                        width,
+                        static_cast<int>(rows.size()),
+                        /*nComps=*/1,
+                        /*nBpc=*/1,
+                        /*nPitch=*/(width + 7) / 8),
+        rows_(std::move(rows)) {}
+
+  int rewind_count() const { return rewind_count_; }
+
+  // ScanlineDecoder:
+  bool Rewind() override {
+    ++rewind_count_;
+    row_ = 0;
+    return true;
+  }
+  pdfium::span<uint8_t> GetNextLine() override {
+    return row_ < rows_.size() ? pdfium::span(rows_[row_++])
+                               : pdfium::span<uint8_t>();
+  }
+  uint32_t GetSrcOffset() override { return 0; }
+
+ private:
+  std::vector<std::vector<uint8_t>> rows_;
+  size_t row_ = 0;
+  int rewind_count_ = 0;
+};
+
+}  // namespace
+
+TEST(BilevelReducer, Factor2) {
+  BilevelReducer reducer(8, 2);
+  ASSERT_EQ(4, reducer.dest_width());
+
+  const uint8_t kRow1[] = {0b11001001};
+  const uint8_t kRow2[] = {0b10000111};
+  std::array<uint8_t, 4> dest;
+  reducer.AddRow(kRow1);
+  reducer.AddRow(kRow2);
+  reducer.TakeRow(dest);
+  EXPECT_THAT(dest, ElementsAre(191, 0, 128, 191));
+
+  // Starts over after each row.
+  const uint8_t kRow3[] = {0b11111111};
+  reducer.AddRow(kRow3);
+  reducer.AddRow({});
+  reducer.TakeRow(dest);
+  EXPECT_THAT(dest, ElementsAre(128, 128, 128, 128));
+}
+
+TEST(BilevelReducer, PartialBlocks) {
+  // The last block is 2 pixels wide, and the padding bits do not count.
+  BilevelReducer reducer(10, 4);
+  ASSERT_EQ(3, reducer.dest_width());
+
+  const uint8_t kRow[] = {0b11110001, 0b10111111};
+  std::array<uint8_t, 3> dest;
+  reducer.AddRow(kRow);
+  reducer.TakeRow(dest);
+  EXPECT_THAT(dest, ElementsAre(255, 64, 128));
+}
+
+TEST(BilevelReducer, LargeFactors) {
+  BilevelReducer reducer(20, 16);
+  ASSERT_EQ(2, reducer.dest_width());
+
+  const uint8_t kRow1[] = {0xff, 0x00, 0xf0};
+  const uint8_t kRow2[] = {0xff, 0xff, 0x0f};
+  std::array<uint8_t, 2> dest;
+  reducer.AddRow(kRow1);
+  reducer.AddRow(kRow2);
+  reducer.TakeRow(dest);
+  // 24 of 32 bits, and 4 of 8 bits.
+  EXPECT_THAT(dest, ElementsAre(191, 128));
+}
+
+TEST(BilevelReducer, Decoder) {
+  auto source = std::make_unique<FakeBilevelDecoder>(
+      12, std::vector<std::vector<uint8_t>>{{0xff, 0xf0},
+                                            {0xff, 0xf0},
+                                            {0x00, 0x00},
+                                            {0xf0, 0x00},
+                                            {0xff, 0xff}});
+  FakeBilevelDecoder* source_ptr = source.get();
+
+  // Only the first 8 columns and 4 rows.
+  std::unique_ptr<ScanlineDecoder> decoder =
+      BilevelReducer::CreateDecoder(std::move(source), 8, 4, 4);
+  EXPECT_EQ(2, decoder->GetWidth());
+  EXPECT_EQ(1, decoder->GetHeight());
+  EXPECT_EQ(1, decoder->CountComps());
+  EXPECT_EQ(8, decoder->GetBPC());
+
+  pdfium::span<const uint8_t> line = decoder->GetScanline(0);
+  ASSERT_GE(line.size(), 2u);
+  EXPECT_EQ(191, line[0]);
+  EXPECT_EQ(128, line[1]);
+  EXPECT_TRUE(decoder->GetScanline(1).empty());
+
+  // Going back to the start rewinds the source too.
+  line = decoder->GetScanline(0);
+  ASSERT_GE(line.size(), 2u);
+  EXPECT_EQ(191, line[0]);
+  EXPECT_EQ(2, source_ptr->rewind_count());
+}
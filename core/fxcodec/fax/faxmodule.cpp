@@ -10,13 +10,16 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <iterator>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "build/build_config.h"
 #include "core/fxcodec/scanlinedecoder.h"
 #include "core/fxcrt/binary_buffer.h"
+#include "core/fxcrt/byteorder.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
@@ -38,122 +41,125 @@ namespace fxcodec {
 
 namespace {
 
-constexpr std::array<const uint8_t, 256> kOneLeadPos = {{
-    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3,
-    3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-}};
-
 // Limit of image dimension. Use the same limit as the JBIG2 codecs.
 constexpr int kFaxMaxImageDimension = 65535;
 
 constexpr int kFaxBpc = 1;
 constexpr int kFaxComps = 1;
 
+// The 64 bits of `data` from `byte_pos` on, first bit first. Bits past the end
+// of `data` are 0.
+uint64_t LoadBitsMSBFirst(pdfium::span<const uint8_t> data, size_t byte_pos) {
+  if (byte_pos + 8 <= data.size()) {
+    return fxcrt::GetUInt64MSBFirst(data.subspan(byte_pos).first<8u>());
+  }
+  uint64_t bits = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    bits <<= 8;
+    if (byte_pos + i < data.size()) {
+      bits |= data[byte_pos + i];
+    }
+  }
+  return bits;
+}
+
+// The next 32 bits of `data` from `bitpos` on, first bit first.
+uint32_t PeekBits(pdfium::span<const uint8_t> data, int bitpos) {
+  return static_cast<uint32_t>(
+      (LoadBitsMSBFirst(data, bitpos / 8) << (bitpos % 8)) >> 32);
+}
+
+// Returns the position of the first bit in [`start_pos`, `max_pos`) that is
+// `bit`, or `max_pos` if there is none.
 int FindBit(pdfium::span<const uint8_t> data_buf,
             int max_pos,
             int start_pos,
             bool bit) {
   DCHECK(start_pos >= 0);
-  if (start_pos >= max_pos) {
-    return max_pos;
-  }
-
-  const uint8_t bit_xor = bit ? 0x00 : 0xff;
-  int bit_offset = start_pos % 8;
-  if (bit_offset) {
-    const int byte_pos = start_pos / 8;
-    uint8_t data = (data_buf[byte_pos] ^ bit_xor) & (0xff >> bit_offset);
-    if (data) {
-      return byte_pos * 8 + kOneLeadPos[data];
-    }
-    start_pos += 7;
-  }
-
-  const int max_byte = (max_pos + 7) / 8;
-  int byte_pos = start_pos / 8;
-
-  // Try reading in bigger chunks in case there are long runs to be skipped.
-  static constexpr int kBulkReadSize = 8;
-  if (max_byte >= kBulkReadSize && byte_pos < max_byte - kBulkReadSize) {
-    static constexpr uint8_t skip_block_0[kBulkReadSize] = {
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-    static constexpr uint8_t skip_block_1[kBulkReadSize] = {
-        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
-    const uint8_t* skip_block = bit ? skip_block_0 : skip_block_1;
-    while (byte_pos < max_byte - kBulkReadSize &&
-           UNSAFE_TODO(
-               memcmp(data_buf.subspan(static_cast<size_t>(byte_pos)).data(),
-                      skip_block, kBulkReadSize)) == 0) {
-      byte_pos += kBulkReadSize;
-    }
-  }
-
-  while (byte_pos < max_byte) {
-    uint8_t data = data_buf[byte_pos] ^ bit_xor;
-    if (data) {
-      return std::min(byte_pos * 8 + kOneLeadPos[data], max_pos);
+  // Looks for set bits, 64 at a time, so runs of the other color take one
+  // step per word.
+  const uint64_t bit_xor = bit ? 0 : ~uint64_t{0};
+  int64_t pos = start_pos;
+  while (pos < max_pos) {
+    const int shift = pos % 8;
+    const uint64_t bits =
+        (LoadBitsMSBFirst(data_buf, pos / 8) ^ bit_xor) << shift;
+    if (bits) {
+      return static_cast<int>(
+          std::min<int64_t>(pos + std::countl_zero(bits), max_pos));
     }
-    ++byte_pos;
+    pos += 64 - shift;
   }
   return max_pos;
 }
 
-void FaxG4FindB1B2(pdfium::span<const uint8_t> ref_buf,
+// Finds b1 and b2 from `ref_changes`, which are where the colors of the
+// reference row change, from left to right, starting from white.
+// `next_change` is the first of them past the previous a0, and moves along
+// with a0, which only ever increases within a row.
+void FaxG4FindB1B2(pdfium::span<const int> ref_changes,
                    int columns,
                    int a0,
                    bool a0color,
+                   size_t* next_change,
                    int* b1,
                    int* b2) {
-  bool first_bit = a0 < 0 || (ref_buf[a0 / 8] & (1 << (7 - a0 % 8))) != 0;
-  *b1 = FindBit(ref_buf, columns, a0 + 1, !first_bit);
-  if (*b1 >= columns) {
-    *b1 = *b2 = columns;
-    return;
+  size_t i = *next_change;
+  while (i < ref_changes.size() && ref_changes[i] <= a0) {
+    ++i;
   }
-  if (first_bit == !a0color) {
-    *b1 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
-    first_bit = !first_bit;
+  *next_change = i;
+
+  // Changes come in pairs, so the reference row is white at a0 after an even
+  // number of them. b1 is the first change past a0 to the opposite of
+  // `a0color`.
+  const bool ref_white_at_a0 = i % 2 == 0;
+  if (ref_white_at_a0 != a0color) {
+    ++i;
   }
-  if (*b1 >= columns) {
+  if (i >= ref_changes.size()) {
     *b1 = *b2 = columns;
     return;
   }
-  *b2 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
+  *b1 = ref_changes[i];
+  *b2 = i + 1 < ref_changes.size() ? ref_changes[i + 1] : columns;
 }
 
-void FaxFillBits(uint8_t* dest_buf, int columns, int startpos, int endpos) {
+// Makes [`startpos`, `endpos`) black, and records where that changes the
+// colors in `changes`. Runs of black only ever come from left to right.
+void FaxFillBits(uint8_t* dest_buf,
+                 int columns,
+                 int startpos,
+                 int endpos,
+                 std::vector<int>* changes) {
   startpos = std::max(startpos, 0);
   endpos = std::clamp(endpos, 0, columns);
   if (startpos >= endpos) {
     return;
   }
-  int first_byte = startpos / 8;
-  int last_byte = (endpos - 1) / 8;
-  if (first_byte == last_byte) {
-    for (int i = startpos % 8; i <= (endpos - 1) % 8; ++i) {
-      UNSAFE_TODO(dest_buf[first_byte] -= 1 << (7 - i));
-    }
-    return;
-  }
-  for (int i = startpos % 8; i < 8; ++i) {
-    UNSAFE_TODO(dest_buf[first_byte] -= 1 << (7 - i));
-  }
-  for (int i = 0; i <= (endpos - 1) % 8; ++i) {
-    UNSAFE_TODO(dest_buf[last_byte] -= 1 << (7 - i));
-  }
-  if (last_byte > first_byte + 1) {
-    UNSAFE_TODO(
-        FXSYS_memset(dest_buf + first_byte + 1, 0, last_byte - first_byte - 1));
+  if (!changes->empty() && changes->back() == startpos) {
+    // Continues the previous run.
+    changes->back() = endpos;
+  } else {
+    DCHECK(changes->empty() || changes->back() < startpos);
+    changes->push_back(startpos);
+    changes->push_back(endpos);
   }
+  const int first_byte = startpos / 8;
+  const int last_byte = (endpos - 1) / 8;
+  const uint8_t first_mask = 0xff >> (startpos % 8);
+  const uint8_t last_mask = 0xff << (7 - (endpos - 1) % 8);
+  UNSAFE_TODO({
+    if (first_byte == last_byte) {
+      dest_buf[first_byte] &= ~(first_mask & last_mask);
+      return;
+    }
+    dest_buf[first_byte] &= ~first_mask;
+    dest_buf[last_byte] &= ~last_mask;
+    if (last_byte > first_byte + 1) {
+      FXSYS_memset(dest_buf + first_byte + 1, 0, last_byte - first_byte - 1);
+    }
+  });
 }
 
 inline bool NextBit(const uint8_t* src_buf, int* bitpos) {
@@ -276,47 +282,122 @@ const uint8_t kFaxWhiteRunIns[] = {
     0xff,
 };
 
-int FaxGetRun(pdfium::span<const uint8_t> ins_array,
-              const uint8_t* src_buf,
-              int* bitpos,
-              int bitsize) {
-  uint32_t code = 0;
-  int ins_off = 0;
-  while (true) {
-    uint8_t ins = ins_array[ins_off++];
-    if (ins == 0xff) {
-      return -1;
-    }
+// Run length codes are at most this long.
+constexpr int kFaxRunCodeBits = 13;
 
-    if (*bitpos >= bitsize) {
-      return -1;
-    }
+struct FaxRunCode {
+  // -1 for invalid codes.
+  int16_t run;
+  uint8_t length;
+};
 
-    code <<= 1;
-    UNSAFE_TODO({
-      if (src_buf[*bitpos / 8] & (1 << (7 - *bitpos % 8))) {
-        ++code;
+// Maps every `kFaxRunCodeBits` bits to the run length code they start with.
+using FaxRunTable = std::array<FaxRunCode, 1 << kFaxRunCodeBits>;
+
+// `ins_array` lists the codes of each length in turn, starting from 1 bit:
+// their count, then the code and 16-bit run length of each. A count of 0xff
+// ends it.
+FaxRunTable BuildFaxRunTable(pdfium::span<const uint8_t> ins_array) {
+  FaxRunTable table;
+  for (uint32_t bits = 0; bits < table.size(); ++bits) {
+    FaxRunCode& entry = table[bits];
+    entry = {-1, 0};
+    uint32_t code = 0;
+    size_t ins_off = 0;
+    while (true) {
+      const uint8_t ins = ins_array[ins_off++];
+      if (ins == 0xff) {
+        break;
       }
-    });
-    ++(*bitpos);
-    int next_off = ins_off + ins * 3;
-    for (; ins_off < next_off; ins_off += 3) {
-      if (ins_array[ins_off] == code) {
-        return ins_array[ins_off + 1] + ins_array[ins_off + 2] * 256;
+      ++entry.length;
+      CHECK_LE(entry.length, kFaxRunCodeBits);
+      code = (code << 1) | ((bits >> (kFaxRunCodeBits - entry.length)) & 1);
+      const size_t next_off = ins_off + ins * 3;
+      for (; ins_off < next_off; ins_off += 3) {
+        if (ins_array[ins_off] == code) {
+          entry.run = ins_array[ins_off + 1] + ins_array[ins_off + 2] * 256;
+          break;
+        }
       }
+      if (entry.run >= 0) {
+        break;
+      }
+      ins_off = next_off;
+    }
+  }
+  return table;
+}
+
+const FaxRunTable& GetFaxRunTable(bool white) {
+  static const FaxRunTable kWhiteTable = BuildFaxRunTable(kFaxWhiteRunIns);
+  static const FaxRunTable kBlackTable = BuildFaxRunTable(kFaxBlackRunIns);
+  return white ? kWhiteTable : kBlackTable;
+}
+
+// Returns -1 for invalid codes, which still use up the bits looked at.
+int FaxGetRun(const FaxRunTable& table,
+              pdfium::span<const uint8_t> src_span,
+              int* bitpos,
+              int bitsize) {
+  if (*bitpos >= bitsize) {
+    return -1;
+  }
+
+  const FaxRunCode& code =
+      table[PeekBits(src_span, *bitpos) >> (32 - kFaxRunCodeBits)];
+  if (code.length > bitsize - *bitpos) {
+    // The data ends inside the code.
+    *bitpos = bitsize;
+    return -1;
+  }
+  *bitpos += code.length;
+  return code.run;
+}
+
+// Adds up make-up codes and the terminating code after them. Invalid codes
+// count as -1 and end the run.
+int FaxGetRunLength(bool white,
+                    pdfium::span<const uint8_t> src_span,
+                    int* bitpos,
+                    int bitsize) {
+  const FaxRunTable& table = GetFaxRunTable(white);
+  int run_len = 0;
+  while (true) {
+    int run = FaxGetRun(table, src_span, bitpos, bitsize);
+    run_len += run;
+    if (run < 64) {
+      return run_len;
     }
   }
 }
 
-void FaxG4GetRow(const uint8_t* src_buf,
+// Moves `bitpos` past the next 1 bit, or to the end. Returns whether there
+// was one.
+bool FaxSkipPastOne(pdfium::span<const uint8_t> src_span,
+                    int bitsize,
+                    int* bitpos) {
+  if (*bitpos >= bitsize) {
+    return false;
+  }
+  const int one_pos = FindBit(src_span, bitsize, *bitpos, true);
+  *bitpos = one_pos < bitsize ? one_pos + 1 : bitsize;
+  return one_pos < bitsize;
+}
+
+void FaxG4GetRow(pdfium::span<const uint8_t> src_span,
                  int bitsize,
                  int* bitpos,
                  uint8_t* dest_buf,
-                 pdfium::span<const uint8_t> ref_buf,
-                 int columns) {
-  // See TABLE 1/T.6 "Code table" in ITU-T T.6.
+                 int columns,
+                 pdfium::span<const int> ref_changes,
+                 std::vector<int>* changes) {
+  // See TABLE 1/T.6 "Code table" in ITU-T T.6. Mode codes are told apart by
+  // their leading zeros, and the bit after the first 1 picks the side of
+  // vertical modes.
+  static constexpr int kModeCodeLength[] = {1, 3, 3, 4, 6, 7, 7, 7};
   int a0 = -1;
   bool a0color = true;
+  size_t next_change = 0;
   while (true) {
     if (*bitpos >= bitsize) {
       return;
@@ -326,38 +407,31 @@ void FaxG4GetRow(const uint8_t* src_buf,
     int a2;
     int b1;
     int b2;
-    FaxG4FindB1B2(ref_buf, columns, a0, a0color, &b1, &b2);
+    FaxG4FindB1B2(ref_changes, columns, a0, a0color, &next_change, &b1, &b2);
+
+    const uint32_t bits = PeekBits(src_span, *bitpos);
+    const int leading_zeros = std::min(std::countl_zero(bits), 7);
+    const int code_len = kModeCodeLength[leading_zeros];
+    if (code_len > bitsize - *bitpos) {
+      // The data ends inside the code.
+      *bitpos = bitsize;
+      return;
+    }
+    *bitpos += code_len;
+    const bool last_bit = (bits >> (32 - code_len)) & 1;
 
     int v_delta = 0;
-    if (!NextBit(src_buf, bitpos)) {
-      if (*bitpos >= bitsize) {
-        return;
-      }
-
-      bool bit1 = NextBit(src_buf, bitpos);
-      if (*bitpos >= bitsize) {
-        return;
-      }
-
-      bool bit2 = NextBit(src_buf, bitpos);
-      if (bit1) {
+    switch (leading_zeros) {
+      case 0:
+        // Mode "Vertical", V(0).
+        break;
+      case 1:
         // Mode "Vertical", VR(1), VL(1).
-        v_delta = bit2 ? 1 : -1;
-      } else if (bit2) {
+        v_delta = last_bit ? 1 : -1;
+        break;
+      case 2: {
         // Mode "Horizontal".
-        int run_len1 = 0;
-        while (true) {
-          int run = FaxGetRun(
-              a0color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxWhiteRunIns)
-                      : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxBlackRunIns),
-              src_buf, bitpos, bitsize);
-          run_len1 += run;
-          if (run < 64) {
-            break;
-          }
-        }
+        int run_len1 = FaxGetRunLength(a0color, src_span, bitpos, bitsize);
         if (a0 < 0) {
           ++run_len1;
         }
@@ -367,28 +441,16 @@ void FaxG4GetRow(const uint8_t* src_buf,
 
         a1 = a0 + run_len1;
         if (!a0color) {
-          FaxFillBits(dest_buf, columns, a0, a1);
+          FaxFillBits(dest_buf, columns, a0, a1, changes);
         }
 
-        int run_len2 = 0;
-        while (true) {
-          int run = FaxGetRun(
-              a0color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxBlackRunIns)
-                      : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                            kFaxWhiteRunIns),
-              src_buf, bitpos, bitsize);
-          run_len2 += run;
-          if (run < 64) {
-            break;
-          }
-        }
+        int run_len2 = FaxGetRunLength(!a0color, src_span, bitpos, bitsize);
         if (run_len2 < 0) {
           return;
         }
         a2 = a1 + run_len2;
         if (a0color) {
-          FaxFillBits(dest_buf, columns, a1, a2);
+          FaxFillBits(dest_buf, columns, a1, a2, changes);
         }
 
         a0 = a2;
@@ -397,65 +459,38 @@ void FaxG4GetRow(const uint8_t* src_buf,
         }
 
         return;
-      } else {
-        if (*bitpos >= bitsize) {
-          return;
-        }
-
-        if (NextBit(src_buf, bitpos)) {
-          // Mode "Pass".
-          if (!a0color) {
-            FaxFillBits(dest_buf, columns, a0, b2);
-          }
-
-          if (b2 >= columns) {
-            return;
-          }
-
-          a0 = b2;
-          continue;
-        }
-
-        if (*bitpos >= bitsize) {
-          return;
+      }
+      case 3:
+        // Mode "Pass".
+        if (!a0color) {
+          FaxFillBits(dest_buf, columns, a0, b2, changes);
         }
 
-        bool next_bit1 = NextBit(src_buf, bitpos);
-        if (*bitpos >= bitsize) {
+        if (b2 >= columns) {
           return;
         }
 
-        bool next_bit2 = NextBit(src_buf, bitpos);
-        if (next_bit1) {
-          // Mode "Vertical", VR(2), VL(2).
-          v_delta = next_bit2 ? 2 : -2;
-        } else if (next_bit2) {
-          if (*bitpos >= bitsize) {
-            return;
-          }
-
-          // Mode "Vertical", VR(3), VL(3).
-          v_delta = NextBit(src_buf, bitpos) ? 3 : -3;
-        } else {
-          if (*bitpos >= bitsize) {
-            return;
-          }
-
-          // Extension
-          if (NextBit(src_buf, bitpos)) {
-            *bitpos += 3;
-            continue;
-          }
-          *bitpos += 5;
-          return;
-        }
-      }
-    } else {
-      // Mode "Vertical", V(0).
+        a0 = b2;
+        continue;
+      case 4:
+        // Mode "Vertical", VR(2), VL(2).
+        v_delta = last_bit ? 2 : -2;
+        break;
+      case 5:
+        // Mode "Vertical", VR(3), VL(3).
+        v_delta = last_bit ? 3 : -3;
+        break;
+      case 6:
+        // Extension
+        *bitpos += 3;
+        continue;
+      default:
+        *bitpos += 5;
+        return;
     }
     a1 = b1 + v_delta;
     if (!a0color) {
-      FaxFillBits(dest_buf, columns, a0, a1);
+      FaxFillBits(dest_buf, columns, a0, a1, changes);
     }
 
     if (a1 >= columns) {
@@ -472,24 +507,22 @@ void FaxG4GetRow(const uint8_t* src_buf,
   }
 }
 
-void FaxSkipEOL(const uint8_t* src_buf, int bitsize, int* bitpos) {
+void FaxSkipEOL(pdfium::span<const uint8_t> src_span,
+                int bitsize,
+                int* bitpos) {
   int startbit = *bitpos;
-  while (*bitpos < bitsize) {
-    if (!NextBit(src_buf, bitpos)) {
-      continue;
-    }
-    if (*bitpos - startbit <= 11) {
-      *bitpos = startbit;
-    }
-    return;
+  if (FaxSkipPastOne(src_span, bitsize, bitpos) &&
+      *bitpos - startbit <= 11) {
+    *bitpos = startbit;
   }
 }
 
-void FaxGet1DLine(const uint8_t* src_buf,
+void FaxGet1DLine(pdfium::span<const uint8_t> src_span,
                   int bitsize,
                   int* bitpos,
                   uint8_t* dest_buf,
-                  int columns) {
+                  int columns,
+                  std::vector<int>* changes) {
   bool color = true;
   int startpos = 0;
   while (true) {
@@ -497,20 +530,12 @@ void FaxGet1DLine(const uint8_t* src_buf,
       return;
     }
 
+    const FaxRunTable& table = GetFaxRunTable(color);
     int run_len = 0;
     while (true) {
-      int run =
-          FaxGetRun(color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                                kFaxWhiteRunIns)
-                          : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
-                                kFaxBlackRunIns),
-                    src_buf, bitpos, bitsize);
+      int run = FaxGetRun(table, src_span, bitpos, bitsize);
       if (run < 0) {
-        while (*bitpos < bitsize) {
-          if (NextBit(src_buf, bitpos)) {
-            return;
-          }
-        }
+        FaxSkipPastOne(src_span, bitsize, bitpos);
         return;
       }
       run_len += run;
@@ -519,7 +544,8 @@ void FaxGet1DLine(const uint8_t* src_buf,
       }
     }
     if (!color) {
-      FaxFillBits(dest_buf, columns, startpos, startpos + run_len);
+      FaxFillBits(dest_buf, columns, startpos, startpos + run_len,
+                  changes);
     }
 
     startpos += run_len;
@@ -557,7 +583,9 @@ class FaxDecoder final : public ScanlineDecoder {
   const bool black_;
   const pdfium::raw_span<const uint8_t> src_span_;
   DataVector<uint8_t> scanline_buf_;
-  DataVector<uint8_t> ref_buf_;
+  // Where the colors of the current row and the one above change.
+  std::vector<int> changes_;
+  std::vector<int> ref_changes_;
 };
 
 FaxDecoder::FaxDecoder(pdfium::span<const uint8_t> src_span,
@@ -579,8 +607,7 @@ FaxDecoder::FaxDecoder(pdfium::span<const uint8_t> src_span,
       end_of_line_(EndOfLine),
       black_(BlackIs1),
       src_span_(src_span),
-      scanline_buf_(pitch_),
-      ref_buf_(pitch_) {}
+      scanline_buf_(pitch_) {}
 
 FaxDecoder::~FaxDecoder() {
   // Span in superclass can't outlive our buffer.
@@ -588,38 +615,39 @@ FaxDecoder::~FaxDecoder() {
 }
 
 bool FaxDecoder::Rewind() {
-  std::ranges::fill(ref_buf_, 0xff);
+  ref_changes_.clear();
   bitpos_ = 0;
   return true;
 }
 
 pdfium::span<uint8_t> FaxDecoder::GetNextLine() {
   int bitsize = pdfium::checked_cast<int>(src_span_.size() * 8);
-  FaxSkipEOL(src_span_.data(), bitsize, &bitpos_);
+  FaxSkipEOL(src_span_, bitsize, &bitpos_);
   if (bitpos_ >= bitsize) {
     return pdfium::span<uint8_t>();
   }
 
   std::ranges::fill(scanline_buf_, 0xff);
+  changes_.clear();
   if (encoding_ < 0) {
-    FaxG4GetRow(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                ref_buf_, orig_width_);
-    ref_buf_ = scanline_buf_;
+    FaxG4GetRow(src_span_, bitsize, &bitpos_, scanline_buf_.data(),
+                orig_width_, ref_changes_, &changes_);
+    std::swap(ref_changes_, changes_);
   } else if (encoding_ == 0) {
-    FaxGet1DLine(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                 orig_width_);
+    FaxGet1DLine(src_span_, bitsize, &bitpos_, scanline_buf_.data(),
+                 orig_width_, &changes_);
   } else {
     if (NextBit(src_span_.data(), &bitpos_)) {
-      FaxGet1DLine(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                   orig_width_);
+      FaxGet1DLine(src_span_, bitsize, &bitpos_, scanline_buf_.data(),
+                   orig_width_, &changes_);
     } else {
-      FaxG4GetRow(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
-                  ref_buf_, orig_width_);
+      FaxG4GetRow(src_span_, bitsize, &bitpos_, scanline_buf_.data(),
+                  orig_width_, ref_changes_, &changes_);
     }
-    ref_buf_ = scanline_buf_;
+    std::swap(ref_changes_, changes_);
   }
   if (end_of_line_) {
-    FaxSkipEOL(src_span_.data(), bitsize, &bitpos_);
+    FaxSkipEOL(src_span_, bitsize, &bitpos_);
   }
 
   if (byte_align_ && bitpos_ < bitsize) {
@@ -696,22 +724,48 @@ int FaxModule::FaxG4Decode(pdfium::span<const uint8_t> src_span,
                            uint8_t* dest_buf) {
   DCHECK(pitch != 0);
 
-  const uint8_t* src_buf = src_span.data();
-  uint32_t src_size = pdfium::checked_cast<uint32_t>(src_span.size());
+  const int bitsize = pdfium::checked_cast<int>(src_span.size() * 8);
 
-  DataVector<uint8_t> ref_buf(pitch, 0xff);
+  std::vector<int> ref_changes;
+  std::vector<int> changes;
   int bitpos = starting_bitpos;
   for (int iRow = 0; iRow < height; ++iRow) {
     uint8_t* line_buf = UNSAFE_TODO(dest_buf + iRow * pitch);
     UNSAFE_TODO(FXSYS_memset(line_buf, 0xff, pitch));
-    FaxG4GetRow(src_buf, src_size << 3, &bitpos, line_buf, ref_buf, width);
-    UNSAFE_TODO(FXSYS_memcpy(ref_buf.data(), line_buf, pitch));
+    changes.clear();
+    FaxG4GetRow(src_span, bitsize, &bitpos, line_buf, width, ref_changes,
+                &changes);
+    std::swap(ref_changes, changes);
   }
   return bitpos;
 }
 
 #if BUILDFLAG(IS_WIN)
 namespace {
+
+void FaxG4FindB1B2(pdfium::span<const uint8_t> ref_buf,
+                   int columns,
+                   int a0,
+                   bool a0color,
+                   int* b1,
+                   int* b2) {
+  bool first_bit = a0 < 0 || (ref_buf[a0 / 8] & (1 << (7 - a0 % 8))) != 0;
+  *b1 = FindBit(ref_buf, columns, a0 + 1, !first_bit);
+  if (*b1 >= columns) {
+    *b1 = *b2 = columns;
+    return;
+  }
+  if (first_bit == !a0color) {
+    *b1 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
+    first_bit = !first_bit;
+  }
+  if (*b1 >= columns) {
+    *b1 = *b2 = columns;
+    return;
+  }
+  *b2 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
+}
+
 const uint8_t BlackRunTerminator[128] = {
     0x37, 10, 0x02, 3,  0x03, 2,  0x02, 2,  0x03, 3,  0x03, 4,  0x02, 4,
     0x03, 5,  0x05, 6,  0x04, 6,  0x04, 7,  0x05, 7,  0x07, 7,  0x04, 8,
@@ -0,0 +1,1081 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Checks FaxModule against the decoder it replaced, which decoded a bit at a
+// time, on generated images and on damaged copies of them.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/fxcodec/fax/faxmodule.h"
+#include "core/fxcodec/scanlinedecoder.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_2d_size.h"
+#include "core/fxcrt/fx_memcpy_wrappers.h"
+#include "core/fxcrt/fx_memory.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/span_util.h"
+#include "core/fxge/calculate_pitch.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace fxcodec {
+namespace {
+
+// The decoder before it worked a word at a time, unchanged but for
+// FaxModule's functions becoming free functions.
+namespace old_decoder {
+
+namespace {
+
+constexpr std::array<const uint8_t, 256> kOneLeadPos = {{
+    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+}};
+
+// Limit of image dimension. Use the same limit as the JBIG2 codecs.
+constexpr int kFaxMaxImageDimension = 65535;
+
+constexpr int kFaxBpc = 1;
+constexpr int kFaxComps = 1;
+
+int FindBit(pdfium::span<const uint8_t> data_buf,
+            int max_pos,
+            int start_pos,
+            bool bit) {
+  DCHECK(start_pos >= 0);
+  if (start_pos >= max_pos) {
+    return max_pos;
+  }
+
+  const uint8_t bit_xor = bit ? 0x00 : 0xff;
+  int bit_offset = start_pos % 8;
+  if (bit_offset) {
+    const int byte_pos = start_pos / 8;
+    uint8_t data = (data_buf[byte_pos] ^ bit_xor) & (0xff >> bit_offset);
+    if (data) {
+      return byte_pos * 8 + kOneLeadPos[data];
+    }
+    start_pos += 7;
+  }
+
+  const int max_byte = (max_pos + 7) / 8;
+  int byte_pos = start_pos / 8;
+
+  // Try reading in bigger chunks in case there are long runs to be skipped.
+  static constexpr int kBulkReadSize = 8;
+  if (max_byte >= kBulkReadSize && byte_pos < max_byte - kBulkReadSize) {
+    static constexpr uint8_t skip_block_0[kBulkReadSize] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    static constexpr uint8_t skip_block_1[kBulkReadSize] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    const uint8_t* skip_block = bit ? skip_block_0 : skip_block_1;
+    while (byte_pos < max_byte - kBulkReadSize &&
+           UNSAFE_TODO(
+               memcmp(data_buf.subspan(static_cast<size_t>(byte_pos)).data(),
+                      skip_block, kBulkReadSize)) == 0) {
+      byte_pos += kBulkReadSize;
+    }
+  }
+
+  while (byte_pos < max_byte) {
+    uint8_t data = data_buf[byte_pos] ^ bit_xor;
+    if (data) {
+      return std::min(byte_pos * 8 + kOneLeadPos[data], max_pos);
+    }
+    ++byte_pos;
+  }
+  return max_pos;
+}
+
+void FaxG4FindB1B2(pdfium::span<const uint8_t> ref_buf,
+                   int columns,
+                   int a0,
+                   bool a0color,
+                   int* b1,
+                   int* b2) {
+  bool first_bit = a0 < 0 || (ref_buf[a0 / 8] & (1 << (7 - a0 % 8))) != 0;
+  *b1 = FindBit(ref_buf, columns, a0 + 1, !first_bit);
+  if (*b1 >= columns) {
+    *b1 = *b2 = columns;
+    return;
+  }
+  if (first_bit == !a0color) {
+    *b1 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
+    first_bit = !first_bit;
+  }
+  if (*b1 >= columns) {
+    *b1 = *b2 = columns;
+    return;
+  }
+  *b2 = FindBit(ref_buf, columns, *b1 + 1, first_bit);
+}
+
+void FaxFillBits(uint8_t* dest_buf, int columns, int startpos, int endpos) {
+  startpos = std::max(startpos, 0);
+  endpos = std::clamp(endpos, 0, columns);
+  if (startpos >= endpos) {
+    return;
+  }
+  int first_byte = startpos / 8;
+  int last_byte = (endpos - 1) / 8;
+  if (first_byte == last_byte) {
+    for (int i = startpos % 8; i <= (endpos - 1) % 8; ++i) {
+      UNSAFE_TODO(dest_buf[first_byte] -= 1 << (7 - i));
+    }
+    return;
+  }
+  for (int i = startpos % 8; i < 8; ++i) {
+    UNSAFE_TODO(dest_buf[first_byte] -= 1 << (7 - i));
+  }
+  for (int i = 0; i <= (endpos - 1) % 8; ++i) {
+    UNSAFE_TODO(dest_buf[last_byte] -= 1 << (7 - i));
+  }
+  if (last_byte > first_byte + 1) {
+    UNSAFE_TODO(
+        FXSYS_memset(dest_buf + first_byte + 1, 0, last_byte - first_byte - 1));
+  }
+}
+
+inline bool NextBit(const uint8_t* src_buf, int* bitpos) {
+  int pos = (*bitpos)++;
+  return !!UNSAFE_TODO((src_buf[pos / 8] & (1 << (7 - pos % 8))));
+}
+
+const uint8_t kFaxBlackRunIns[] = {
+    0,          2,          0x02,       3,          0,          0x03,
+    2,          0,          2,          0x02,       1,          0,
+    0x03,       4,          0,          2,          0x02,       6,
+    0,          0x03,       5,          0,          1,          0x03,
+    7,          0,          2,          0x04,       9,          0,
+    0x05,       8,          0,          3,          0x04,       10,
+    0,          0x05,       11,         0,          0x07,       12,
+    0,          2,          0x04,       13,         0,          0x07,
+    14,         0,          1,          0x18,       15,         0,
+    5,          0x08,       18,         0,          0x0f,       64,
+    0,          0x17,       16,         0,          0x18,       17,
+    0,          0x37,       0,          0,          10,         0x08,
+    0x00,       0x07,       0x0c,       0x40,       0x07,       0x0d,
+    0x80,       0x07,       0x17,       24,         0,          0x18,
+    25,         0,          0x28,       23,         0,          0x37,
+    22,         0,          0x67,       19,         0,          0x68,
+    20,         0,          0x6c,       21,         0,          54,
+    0x12,       1984 % 256, 1984 / 256, 0x13,       2048 % 256, 2048 / 256,
+    0x14,       2112 % 256, 2112 / 256, 0x15,       2176 % 256, 2176 / 256,
+    0x16,       2240 % 256, 2240 / 256, 0x17,       2304 % 256, 2304 / 256,
+    0x1c,       2368 % 256, 2368 / 256, 0x1d,       2432 % 256, 2432 / 256,
+    0x1e,       2496 % 256, 2496 / 256, 0x1f,       2560 % 256, 2560 / 256,
+    0x24,       52,         0,          0x27,       55,         0,
+    0x28,       56,         0,          0x2b,       59,         0,
+    0x2c,       60,         0,          0x33,       320 % 256,  320 / 256,
+    0x34,       384 % 256,  384 / 256,  0x35,       448 % 256,  448 / 256,
+    0x37,       53,         0,          0x38,       54,         0,
+    0x52,       50,         0,          0x53,       51,         0,
+    0x54,       44,         0,          0x55,       45,         0,
+    0x56,       46,         0,          0x57,       47,         0,
+    0x58,       57,         0,          0x59,       58,         0,
+    0x5a,       61,         0,          0x5b,       256 % 256,  256 / 256,
+    0x64,       48,         0,          0x65,       49,         0,
+    0x66,       62,         0,          0x67,       63,         0,
+    0x68,       30,         0,          0x69,       31,         0,
+    0x6a,       32,         0,          0x6b,       33,         0,
+    0x6c,       40,         0,          0x6d,       41,         0,
+    0xc8,       128,        0,          0xc9,       192,        0,
+    0xca,       26,         0,          0xcb,       27,         0,
+    0xcc,       28,         0,          0xcd,       29,         0,
+    0xd2,       34,         0,          0xd3,       35,         0,
+    0xd4,       36,         0,          0xd5,       37,         0,
+    0xd6,       38,         0,          0xd7,       39,         0,
+    0xda,       42,         0,          0xdb,       43,         0,
+    20,         0x4a,       640 % 256,  640 / 256,  0x4b,       704 % 256,
+    704 / 256,  0x4c,       768 % 256,  768 / 256,  0x4d,       832 % 256,
+    832 / 256,  0x52,       1280 % 256, 1280 / 256, 0x53,       1344 % 256,
+    1344 / 256, 0x54,       1408 % 256, 1408 / 256, 0x55,       1472 % 256,
+    1472 / 256, 0x5a,       1536 % 256, 1536 / 256, 0x5b,       1600 % 256,
+    1600 / 256, 0x64,       1664 % 256, 1664 / 256, 0x65,       1728 % 256,
+    1728 / 256, 0x6c,       512 % 256,  512 / 256,  0x6d,       576 % 256,
+    576 / 256,  0x72,       896 % 256,  896 / 256,  0x73,       960 % 256,
+    960 / 256,  0x74,       1024 % 256, 1024 / 256, 0x75,       1088 % 256,
+    1088 / 256, 0x76,       1152 % 256, 1152 / 256, 0x77,       1216 % 256,
+    1216 / 256, 0xff};
+
+const uint8_t kFaxWhiteRunIns[] = {
+    0,          0,          0,          6,          0x07,       2,
+    0,          0x08,       3,          0,          0x0B,       4,
+    0,          0x0C,       5,          0,          0x0E,       6,
+    0,          0x0F,       7,          0,          6,          0x07,
+    10,         0,          0x08,       11,         0,          0x12,
+    128,        0,          0x13,       8,          0,          0x14,
+    9,          0,          0x1b,       64,         0,          9,
+    0x03,       13,         0,          0x07,       1,          0,
+    0x08,       12,         0,          0x17,       192,        0,
+    0x18,       1664 % 256, 1664 / 256, 0x2a,       16,         0,
+    0x2B,       17,         0,          0x34,       14,         0,
+    0x35,       15,         0,          12,         0x03,       22,
+    0,          0x04,       23,         0,          0x08,       20,
+    0,          0x0c,       19,         0,          0x13,       26,
+    0,          0x17,       21,         0,          0x18,       28,
+    0,          0x24,       27,         0,          0x27,       18,
+    0,          0x28,       24,         0,          0x2B,       25,
+    0,          0x37,       256 % 256,  256 / 256,  42,         0x02,
+    29,         0,          0x03,       30,         0,          0x04,
+    45,         0,          0x05,       46,         0,          0x0a,
+    47,         0,          0x0b,       48,         0,          0x12,
+    33,         0,          0x13,       34,         0,          0x14,
+    35,         0,          0x15,       36,         0,          0x16,
+    37,         0,          0x17,       38,         0,          0x1a,
+    31,         0,          0x1b,       32,         0,          0x24,
+    53,         0,          0x25,       54,         0,          0x28,
+    39,         0,          0x29,       40,         0,          0x2a,
+    41,         0,          0x2b,       42,         0,          0x2c,
+    43,         0,          0x2d,       44,         0,          0x32,
+    61,         0,          0x33,       62,         0,          0x34,
+    63,         0,          0x35,       0,          0,          0x36,
+    320 % 256,  320 / 256,  0x37,       384 % 256,  384 / 256,  0x4a,
+    59,         0,          0x4b,       60,         0,          0x52,
+    49,         0,          0x53,       50,         0,          0x54,
+    51,         0,          0x55,       52,         0,          0x58,
+    55,         0,          0x59,       56,         0,          0x5a,
+    57,         0,          0x5b,       58,         0,          0x64,
+    448 % 256,  448 / 256,  0x65,       512 % 256,  512 / 256,  0x67,
+    640 % 256,  640 / 256,  0x68,       576 % 256,  576 / 256,  16,
+    0x98,       1472 % 256, 1472 / 256, 0x99,       1536 % 256, 1536 / 256,
+    0x9a,       1600 % 256, 1600 / 256, 0x9b,       1728 % 256, 1728 / 256,
+    0xcc,       704 % 256,  704 / 256,  0xcd,       768 % 256,  768 / 256,
+    0xd2,       832 % 256,  832 / 256,  0xd3,       896 % 256,  896 / 256,
+    0xd4,       960 % 256,  960 / 256,  0xd5,       1024 % 256, 1024 / 256,
+    0xd6,       1088 % 256, 1088 / 256, 0xd7,       1152 % 256, 1152 / 256,
+    0xd8,       1216 % 256, 1216 / 256, 0xd9,       1280 % 256, 1280 / 256,
+    0xda,       1344 % 256, 1344 / 256, 0xdb,       1408 % 256, 1408 / 256,
+    0,          3,          0x08,       1792 % 256, 1792 / 256, 0x0c,
+    1856 % 256, 1856 / 256, 0x0d,       1920 % 256, 1920 / 256, 10,
+    0x12,       1984 % 256, 1984 / 256, 0x13,       2048 % 256, 2048 / 256,
+    0x14,       2112 % 256, 2112 / 256, 0x15,       2176 % 256, 2176 / 256,
+    0x16,       2240 % 256, 2240 / 256, 0x17,       2304 % 256, 2304 / 256,
+    0x1c,       2368 % 256, 2368 / 256, 0x1d,       2432 % 256, 2432 / 256,
+    0x1e,       2496 % 256, 2496 / 256, 0x1f,       2560 % 256, 2560 / 256,
+    0xff,
+};
+
+int FaxGetRun(pdfium::span<const uint8_t> ins_array,
+              const uint8_t* src_buf,
+              int* bitpos,
+              int bitsize) {
+  uint32_t code = 0;
+  int ins_off = 0;
+  while (true) {
+    uint8_t ins = ins_array[ins_off++];
+    if (ins == 0xff) {
+      return -1;
+    }
+
+    if (*bitpos >= bitsize) {
+      return -1;
+    }
+
+    code <<= 1;
+    UNSAFE_TODO({
+      if (src_buf[*bitpos / 8] & (1 << (7 - *bitpos % 8))) {
+        ++code;
+      }
+    });
+    ++(*bitpos);
+    int next_off = ins_off + ins * 3;
+    for (; ins_off < next_off; ins_off += 3) {
+      if (ins_array[ins_off] == code) {
+        return ins_array[ins_off + 1] + ins_array[ins_off + 2] * 256;
+      }
+    }
+  }
+}
+
+void FaxG4GetRow(const uint8_t* src_buf,
+                 int bitsize,
+                 int* bitpos,
+                 uint8_t* dest_buf,
+                 pdfium::span<const uint8_t> ref_buf,
+                 int columns) {
+  // See TABLE 1/T.6 "Code table" in ITU-T T.6.
+  int a0 = -1;
+  bool a0color = true;
+  while (true) {
+    if (*bitpos >= bitsize) {
+      return;
+    }
+
+    int a1;
+    int a2;
+    int b1;
+    int b2;
+    FaxG4FindB1B2(ref_buf, columns, a0, a0color, &b1, &b2);
+
+    int v_delta = 0;
+    if (!NextBit(src_buf, bitpos)) {
+      if (*bitpos >= bitsize) {
+        return;
+      }
+
+      bool bit1 = NextBit(src_buf, bitpos);
+      if (*bitpos >= bitsize) {
+        return;
+      }
+
+      bool bit2 = NextBit(src_buf, bitpos);
+      if (bit1) {
+        // Mode "Vertical", VR(1), VL(1).
+        v_delta = bit2 ? 1 : -1;
+      } else if (bit2) {
+        // Mode "Horizontal".
+        int run_len1 = 0;
+        while (true) {
+          int run = FaxGetRun(
+              a0color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
+                            kFaxWhiteRunIns)
+                      : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
+                            kFaxBlackRunIns),
+              src_buf, bitpos, bitsize);
+          run_len1 += run;
+          if (run < 64) {
+            break;
+          }
+        }
+        if (a0 < 0) {
+          ++run_len1;
+        }
+        if (run_len1 < 0) {
+          return;
+        }
+
+        a1 = a0 + run_len1;
+        if (!a0color) {
+          FaxFillBits(dest_buf, columns, a0, a1);
+        }
+
+        int run_len2 = 0;
+        while (true) {
+          int run = FaxGetRun(
+              a0color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
+                            kFaxBlackRunIns)
+                      : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
+                            kFaxWhiteRunIns),
+              src_buf, bitpos, bitsize);
+          run_len2 += run;
+          if (run < 64) {
+            break;
+          }
+        }
+        if (run_len2 < 0) {
+          return;
+        }
+        a2 = a1 + run_len2;
+        if (a0color) {
+          FaxFillBits(dest_buf, columns, a1, a2);
+        }
+
+        a0 = a2;
+        if (a0 < columns) {
+          continue;
+        }
+
+        return;
+      } else {
+        if (*bitpos >= bitsize) {
+          return;
+        }
+
+        if (NextBit(src_buf, bitpos)) {
+          // Mode "Pass".
+          if (!a0color) {
+            FaxFillBits(dest_buf, columns, a0, b2);
+          }
+
+          if (b2 >= columns) {
+            return;
+          }
+
+          a0 = b2;
+          continue;
+        }
+
+        if (*bitpos >= bitsize) {
+          return;
+        }
+
+        bool next_bit1 = NextBit(src_buf, bitpos);
+        if (*bitpos >= bitsize) {
+          return;
+        }
+
+        bool next_bit2 = NextBit(src_buf, bitpos);
+        if (next_bit1) {
+          // Mode "Vertical", VR(2), VL(2).
+          v_delta = next_bit2 ? 2 : -2;
+        } else if (next_bit2) {
+          if (*bitpos >= bitsize) {
+            return;
+          }
+
+          // Mode "Vertical", VR(3), VL(3).
+          v_delta = NextBit(src_buf, bitpos) ? 3 : -3;
+        } else {
+          if (*bitpos >= bitsize) {
+            return;
+          }
+
+          // Extension
+          if (NextBit(src_buf, bitpos)) {
+            *bitpos += 3;
+            continue;
+          }
+          *bitpos += 5;
+          return;
+        }
+      }
+    } else {
+      // Mode "Vertical", V(0).
+    }
+    a1 = b1 + v_delta;
+    if (!a0color) {
+      FaxFillBits(dest_buf, columns, a0, a1);
+    }
+
+    if (a1 >= columns) {
+      return;
+    }
+
+    // The position of picture element must be monotonic increasing.
+    if (a0 >= a1) {
+      return;
+    }
+
+    a0 = a1;
+    a0color = !a0color;
+  }
+}
+
+void FaxSkipEOL(const uint8_t* src_buf, int bitsize, int* bitpos) {
+  int startbit = *bitpos;
+  while (*bitpos < bitsize) {
+    if (!NextBit(src_buf, bitpos)) {
+      continue;
+    }
+    if (*bitpos - startbit <= 11) {
+      *bitpos = startbit;
+    }
+    return;
+  }
+}
+
+void FaxGet1DLine(const uint8_t* src_buf,
+                  int bitsize,
+                  int* bitpos,
+                  uint8_t* dest_buf,
+                  int columns) {
+  bool color = true;
+  int startpos = 0;
+  while (true) {
+    if (*bitpos >= bitsize) {
+      return;
+    }
+
+    int run_len = 0;
+    while (true) {
+      int run =
+          FaxGetRun(color ? pdfium::span<const uint8_t, pdfium::dynamic_extent>(
+                                kFaxWhiteRunIns)
+                          : pdfium::span<const uint8_t, pdfium::dynamic_extent>(
+                                kFaxBlackRunIns),
+                    src_buf, bitpos, bitsize);
+      if (run < 0) {
+        while (*bitpos < bitsize) {
+          if (NextBit(src_buf, bitpos)) {
+            return;
+          }
+        }
+        return;
+      }
+      run_len += run;
+      if (run < 64) {
+        break;
+      }
+    }
+    if (!color) {
+      FaxFillBits(dest_buf, columns, startpos, startpos + run_len);
+    }
+
+    startpos += run_len;
+    if (startpos >= columns) {
+      break;
+    }
+
+    color = !color;
+  }
+}
+
+class FaxDecoder final : public ScanlineDecoder {
+ public:
+  FaxDecoder(pdfium::span<const uint8_t> src_span,
+             int width,
+             int height,
+             int K,
+             bool EndOfLine,
+             bool EncodedByteAlign,
+             bool BlackIs1);
+  ~FaxDecoder() override;
+
+  // ScanlineDecoder:
+  [[nodiscard]] bool Rewind() override;
+  pdfium::span<uint8_t> GetNextLine() override;
+  uint32_t GetSrcOffset() override;
+
+ private:
+  void InvertBuffer();
+
+  const int encoding_;
+  int bitpos_ = 0;
+  bool byte_align_ = false;
+  const bool end_of_line_;
+  const bool black_;
+  const pdfium::raw_span<const uint8_t> src_span_;
+  DataVector<uint8_t> scanline_buf_;
+  DataVector<uint8_t> ref_buf_;
+};
+
+FaxDecoder::FaxDecoder(pdfium::span<const uint8_t> src_span,
+                       int width,
+                       int height,
+                       int K,
+                       bool EndOfLine,
+                       bool EncodedByteAlign,
+                       bool BlackIs1)
+    : ScanlineDecoder(width,
+                      height,
+                      width,
+                      height,
+                      kFaxComps,
+                      kFaxBpc,
+                      fxge::CalculatePitch32OrDie(kFaxBpc, width)),
+      encoding_(K),
+      byte_align_(EncodedByteAlign),
+      end_of_line_(EndOfLine),
+      black_(BlackIs1),
+      src_span_(src_span),
+      scanline_buf_(pitch_),
+      ref_buf_(pitch_) {}
+
+FaxDecoder::~FaxDecoder() {
+  // Span in superclass can't outlive our buffer.
+  last_scanline_ = pdfium::span<uint8_t>();
+}
+
+bool FaxDecoder::Rewind() {
+  std::ranges::fill(ref_buf_, 0xff);
+  bitpos_ = 0;
+  return true;
+}
+
+pdfium::span<uint8_t> FaxDecoder::GetNextLine() {
+  int bitsize = pdfium::checked_cast<int>(src_span_.size() * 8);
+  FaxSkipEOL(src_span_.data(), bitsize, &bitpos_);
+  if (bitpos_ >= bitsize) {
+    return pdfium::span<uint8_t>();
+  }
+
+  std::ranges::fill(scanline_buf_, 0xff);
+  if (encoding_ < 0) {
+    FaxG4GetRow(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
+                ref_buf_, orig_width_);
+    ref_buf_ = scanline_buf_;
+  } else if (encoding_ == 0) {
+    FaxGet1DLine(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
+                 orig_width_);
+  } else {
+    if (NextBit(src_span_.data(), &bitpos_)) {
+      FaxGet1DLine(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
+                   orig_width_);
+    } else {
+      FaxG4GetRow(src_span_.data(), bitsize, &bitpos_, scanline_buf_.data(),
+                  ref_buf_, orig_width_);
+    }
+    ref_buf_ = scanline_buf_;
+  }
+  if (end_of_line_) {
+    FaxSkipEOL(src_span_.data(), bitsize, &bitpos_);
+  }
+
+  if (byte_align_ && bitpos_ < bitsize) {
+    int bitpos0 = bitpos_;
+    int bitpos1 = FxAlignToBoundary<8>(bitpos_);
+    while (byte_align_ && bitpos0 < bitpos1) {
+      int bit = src_span_[bitpos0 / 8] & (1 << (7 - bitpos0 % 8));
+      if (bit != 0) {
+        byte_align_ = false;
+      } else {
+        ++bitpos0;
+      }
+    }
+    if (byte_align_) {
+      bitpos_ = bitpos1;
+    }
+  }
+  if (black_) {
+    InvertBuffer();
+  }
+  return scanline_buf_;
+}
+
+uint32_t FaxDecoder::GetSrcOffset() {
+  return pdfium::checked_cast<uint32_t>(
+      std::min<size_t>((bitpos_ + 7) / 8, src_span_.size()));
+}
+
+void FaxDecoder::InvertBuffer() {
+  auto byte_span = pdfium::span(scanline_buf_);
+  auto data = fxcrt::reinterpret_span<uint32_t>(byte_span);
+  for (auto& datum : data) {
+    datum = ~datum;
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<ScanlineDecoder> CreateDecoder(
+    pdfium::span<const uint8_t> src_span,
+    int width,
+    int height,
+    int K,
+    bool EndOfLine,
+    bool EncodedByteAlign,
+    bool BlackIs1,
+    int Columns,
+    int Rows) {
+  int actual_width = Columns ? Columns : width;
+  int actual_height = Rows ? Rows : height;
+
+  // Reject invalid values.
+  if (actual_width <= 0 || actual_height <= 0) {
+    return nullptr;
+  }
+
+  // Reject unreasonable large input.
+  if (actual_width > kFaxMaxImageDimension ||
+      actual_height > kFaxMaxImageDimension) {
+    return nullptr;
+  }
+
+  return std::make_unique<FaxDecoder>(src_span, actual_width, actual_height, K,
+                                      EndOfLine, EncodedByteAlign, BlackIs1);
+}
+
+int FaxG4Decode(pdfium::span<const uint8_t> src_span,
+                int starting_bitpos,
+                int width,
+                int height,
+                int pitch,
+                uint8_t* dest_buf) {
+  DCHECK(pitch != 0);
+
+  const uint8_t* src_buf = src_span.data();
+  uint32_t src_size = pdfium::checked_cast<uint32_t>(src_span.size());
+
+  DataVector<uint8_t> ref_buf(pitch, 0xff);
+  int bitpos = starting_bitpos;
+  for (int iRow = 0; iRow < height; ++iRow) {
+    uint8_t* line_buf = UNSAFE_TODO(dest_buf + iRow * pitch);
+    UNSAFE_TODO(FXSYS_memset(line_buf, 0xff, pitch));
+    FaxG4GetRow(src_buf, src_size << 3, &bitpos, line_buf, ref_buf, width);
+    UNSAFE_TODO(FXSYS_memcpy(ref_buf.data(), line_buf, pitch));
+  }
+  return bitpos;
+}
+
+
+}  // namespace old_decoder
+
+// Fills rows from a fixed seed, so that failures reproduce.
+class Random {
+ public:
+  explicit Random(uint32_t seed) : seed_(seed) {}
+
+  // Returns a number in [0, `limit`).
+  uint32_t Next(uint32_t limit) {
+    seed_ = seed_ * 1103515245 + 12345;
+    return (seed_ >> 8) % limit;
+  }
+
+ private:
+  uint32_t seed_;
+};
+
+// Pixels of one row, 1 for black.
+using Row = std::vector<uint8_t>;
+
+struct Code {
+  uint32_t code = 0;
+  int length = 0;
+};
+
+// Writes codes most significant bit first.
+class BitWriter {
+ public:
+  void Write(Code code) {
+    CHECK_GT(code.length, 0);
+    for (int i = code.length - 1; i >= 0; --i) {
+      WriteBit((code.code >> i) & 1);
+    }
+  }
+
+  void WriteBit(bool bit) {
+    if (bit_count_ % 8 == 0) {
+      data_.push_back(0);
+    }
+    if (bit) {
+      data_.back() |= 0x80 >> (bit_count_ % 8);
+    }
+    ++bit_count_;
+  }
+
+  size_t bit_count() const { return bit_count_; }
+  std::vector<uint8_t> TakeData() { return std::move(data_); }
+
+ private:
+  std::vector<uint8_t> data_;
+  size_t bit_count_ = 0;
+};
+
+constexpr Code kEndOfLine = {0b000000000001, 12};
+constexpr Code kPass = {0b0001, 4};
+constexpr Code kHorizontal = {0b001, 3};
+// By the offset of a1 from b1, from -3 to 3.
+constexpr std::array<Code, 7> kVertical = {{
+    {0b0000010, 7},
+    {0b000010, 6},
+    {0b010, 3},
+    {0b1, 1},
+    {0b011, 3},
+    {0b000011, 6},
+    {0b0000011, 7},
+}};
+
+// Run codes by run length, taken from the decoder's own tables.
+std::vector<Code> MakeRunCodes(pdfium::span<const uint8_t> ins_array) {
+  std::vector<Code> codes(2561);
+  size_t offset = 0;
+  for (int length = 1; ins_array[offset] != 0xff; ++length) {
+    const int count = ins_array[offset++];
+    for (int i = 0; i < count; ++i, offset += 3) {
+      const int run = ins_array[offset + 1] + ins_array[offset + 2] * 256;
+      codes[run] = {ins_array[offset], length};
+    }
+  }
+  return codes;
+}
+
+class Encoder {
+ public:
+  Encoder()
+      : white_codes_(MakeRunCodes(old_decoder::kFaxWhiteRunIns)),
+        black_codes_(MakeRunCodes(old_decoder::kFaxBlackRunIns)) {}
+
+  // Encodes `rows` the way a PDF's CCITTFaxDecode parameters describe.
+  std::vector<uint8_t> Encode(const std::vector<Row>& rows,
+                              int k,
+                              bool end_of_line,
+                              bool byte_align) {
+    BitWriter writer;
+    Row ref(rows.front().size(), 0);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      if (k >= 0 && end_of_line) {
+        // Fill bits go before the end of line code, so that it ends a byte.
+        while (byte_align && (writer.bit_count() + 12) % 8) {
+          writer.WriteBit(false);
+        }
+        writer.Write(kEndOfLine);
+      } else {
+        while (byte_align && writer.bit_count() % 8) {
+          writer.WriteBit(false);
+        }
+      }
+      const bool one_dimensional = k == 0 || (k > 0 && i % k == 0);
+      if (k > 0) {
+        writer.WriteBit(one_dimensional);
+      }
+      if (one_dimensional) {
+        Write1DRow(writer, rows[i]);
+      } else {
+        Write2DRow(writer, rows[i], ref);
+      }
+      ref = rows[i];
+    }
+    return writer.TakeData();
+  }
+
+ private:
+  void WriteRun(BitWriter& writer, uint8_t color, int run) {
+    const std::vector<Code>& codes = color ? black_codes_ : white_codes_;
+    while (run >= 2560) {
+      writer.Write(codes[2560]);
+      run -= 2560;
+    }
+    if (run >= 64) {
+      writer.Write(codes[run / 64 * 64]);
+      run %= 64;
+    }
+    writer.Write(codes[run]);
+  }
+
+  void Write1DRow(BitWriter& writer, const Row& row) {
+    const int width = pdfium::checked_cast<int>(row.size());
+    uint8_t color = 0;
+    for (int pos = 0; pos < width;) {
+      const int end = FindColorChange(row, pos, color);
+      WriteRun(writer, color, end - pos);
+      pos = end;
+      color = !color;
+    }
+  }
+
+  // See 4.2.1.3.4 "Coding procedure" in ITU-T T.4.
+  void Write2DRow(BitWriter& writer, const Row& row, const Row& ref) {
+    const int width = pdfium::checked_cast<int>(row.size());
+    int a0 = -1;
+    uint8_t color = 0;
+    while (a0 < width) {
+      const int a1 = FindColorChange(row, a0 + 1, color);
+      int b1 = width;
+      for (int i = a0 + 1; i < width; ++i) {
+        const uint8_t before = i > 0 ? ref[i - 1] : 0;
+        if (ref[i] != before && ref[i] != color) {
+          b1 = i;
+          break;
+        }
+      }
+      const int b2 = b1 < width ? FindColorChange(ref, b1 + 1, ref[b1]) : width;
+      if (b2 < a1) {
+        writer.Write(kPass);
+        a0 = b2;
+        continue;
+      }
+      if (a1 - b1 >= -3 && a1 - b1 <= 3) {
+        writer.Write(kVertical[a1 - b1 + 3]);
+        a0 = a1;
+        color = !color;
+        continue;
+      }
+      const int a2 = FindColorChange(row, a1 + 1, !color);
+      writer.Write(kHorizontal);
+      WriteRun(writer, color, a1 - std::max(a0, 0));
+      WriteRun(writer, !color, a2 - a1);
+      a0 = a2;
+    }
+  }
+
+  // Returns where `row` from `start` on first is not `color`.
+  static int FindColorChange(const Row& row, int start, uint8_t color) {
+    const int width = pdfium::checked_cast<int>(row.size());
+    for (int i = std::max(start, 0); i < width; ++i) {
+      if (row[i] != color) {
+        return i;
+      }
+    }
+    return width;
+  }
+
+  const std::vector<Code> white_codes_;
+  const std::vector<Code> black_codes_;
+};
+
+// Returns a row of runs of random lengths, mostly short ones.
+Row MakeRandomRow(Random& random, int width) {
+  Row row(width);
+  uint8_t color = random.Next(2);
+  for (int pos = 0; pos < width;) {
+    const uint32_t kind = random.Next(8);
+    const int run = kind < 5   ? 1 + random.Next(8)
+                    : kind < 7 ? 1 + random.Next(100)
+                               : 1 + random.Next(3000);
+    std::fill(row.begin() + pos, row.begin() + std::min(pos + run, width),
+              color);
+    pos += run;
+    color = !color;
+  }
+  return row;
+}
+
+// Returns rows that are mostly like the ones above them, as in text and line
+// art, so that all the two-dimensional modes turn up.
+std::vector<Row> MakeRandomImage(Random& random, int width, int height) {
+  std::vector<Row> rows;
+  rows.push_back(MakeRandomRow(random, width));
+  for (int i = 1; i < height; ++i) {
+    const uint32_t kind = random.Next(10);
+    if (kind == 0) {
+      rows.push_back(MakeRandomRow(random, width));
+      continue;
+    }
+    if (kind == 1) {
+      rows.push_back(Row(width, random.Next(2)));
+      continue;
+    }
+    Row row = rows.back();
+    const uint32_t changes = random.Next(4);
+    for (uint32_t j = 0; j < changes; ++j) {
+      const int pos = random.Next(width);
+      const int end = std::min<int>(pos + 1 + random.Next(4), width);
+      for (int x = pos; x < end; ++x) {
+        row[x] = !row[x];
+      }
+    }
+    rows.push_back(std::move(row));
+  }
+  return rows;
+}
+
+// Decodes `data` with both decoders, and expects the same rows and source
+// offsets from each.
+void ExpectSameAsOldDecoder(pdfium::span<const uint8_t> data,
+                            int width,
+                            int height,
+                            int k,
+                            bool end_of_line,
+                            bool byte_align,
+                            bool black_is_1) {
+  std::unique_ptr<ScanlineDecoder> decoder =
+      FaxModule::CreateDecoder(data, width, height, k, end_of_line,
+                               byte_align, black_is_1, width, height);
+  std::unique_ptr<ScanlineDecoder> old = old_decoder::CreateDecoder(
+      data, width, height, k, end_of_line, byte_align, black_is_1, width,
+      height);
+  ASSERT_TRUE(decoder);
+  ASSERT_TRUE(old);
+  for (int row = 0; row < height; ++row) {
+    pdfium::span<const uint8_t> line = decoder->GetScanline(row);
+    pdfium::span<const uint8_t> old_line = old->GetScanline(row);
+    ASSERT_TRUE(std::ranges::equal(line, old_line)) << "row " << row;
+    ASSERT_EQ(old->GetSrcOffset(), decoder->GetSrcOffset()) << "row " << row;
+  }
+}
+
+// Expects `decoder` to give back `rows`.
+void ExpectRows(ScanlineDecoder* decoder,
+                const std::vector<Row>& rows,
+                bool black_is_1) {
+  for (size_t i = 0; i < rows.size(); ++i) {
+    pdfium::span<const uint8_t> line =
+        decoder->GetScanline(pdfium::checked_cast<int>(i));
+    ASSERT_FALSE(line.empty()) << "row " << i;
+    for (size_t x = 0; x < rows[i].size(); ++x) {
+      const bool bit = line[x / 8] & (0x80 >> (x % 8));
+      ASSERT_EQ(rows[i][x] == black_is_1, bit) << "row " << i << ", x " << x;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FaxModuleDifferentialTest, GeneratedAndDamagedStreams) {
+  Encoder encoder;
+  Random random(1);
+  for (int i = 0; i < 2000; ++i) {
+    const int width = 1 + random.Next(i % 10 ? 200 : 3000);
+    const int height = 1 + random.Next(40);
+    const int k = static_cast<int>(random.Next(5)) - 1;
+    const bool end_of_line = k >= 0 && random.Next(2);
+    const bool byte_align = random.Next(2);
+    const bool black_is_1 = random.Next(2);
+    const std::vector<Row> rows = MakeRandomImage(random, width, height);
+    const std::vector<uint8_t> data =
+        encoder.Encode(rows, k, end_of_line, byte_align);
+    SCOPED_TRACE(testing::Message() << "image " << i << ", " << width << "x"
+                                    << height << ", K " << k);
+
+    // Both give back the image.
+    std::unique_ptr<ScanlineDecoder> decoder =
+        FaxModule::CreateDecoder(data, width, height, k, end_of_line,
+                                 byte_align, black_is_1, width, height);
+    ASSERT_TRUE(decoder);
+    ExpectRows(decoder.get(), rows, black_is_1);
+    ExpectSameAsOldDecoder(data, width, height, k, end_of_line, byte_align,
+                           black_is_1);
+
+    // Flipped bits.
+    std::vector<uint8_t> damaged = data;
+    const uint32_t flips = 1 + random.Next(4);
+    for (uint32_t j = 0; j < flips; ++j) {
+      const uint32_t bit = random.Next(damaged.size() * 8);
+      damaged[bit / 8] ^= 0x80 >> (bit % 8);
+    }
+    ExpectSameAsOldDecoder(damaged, width, height, k, end_of_line, byte_align,
+                           black_is_1);
+
+    // Cut off.
+    damaged.assign(data.begin(), data.begin() + random.Next(data.size()));
+    ExpectSameAsOldDecoder(damaged, width, height, k, end_of_line, byte_align,
+                           black_is_1);
+
+    // Followed or replaced by garbage.
+    damaged = random.Next(2) ? data : std::vector<uint8_t>();
+    const uint32_t garbage = 1 + random.Next(64);
+    for (uint32_t j = 0; j < garbage; ++j) {
+      damaged.push_back(random.Next(256));
+    }
+    ExpectSameAsOldDecoder(damaged, width, height, k, end_of_line, byte_align,
+                           black_is_1);
+  }
+}
+
+TEST(FaxModuleDifferentialTest, G4DecodeGeneratedAndDamagedStreams) {
+  Encoder encoder;
+  Random random(2);
+  for (int i = 0; i < 500; ++i) {
+    const int width = 1 + random.Next(300);
+    const int height = 1 + random.Next(40);
+    const int pitch = fxge::CalculatePitch32OrDie(1, width);
+    // Data before the image, as JBIG2 MMR regions have.
+    const int skip_bytes = random.Next(3);
+    std::vector<uint8_t> data(skip_bytes, 0xa5);
+    const std::vector<uint8_t> image =
+        encoder.Encode(MakeRandomImage(random, width, height), /*k=*/-1,
+                       /*end_of_line=*/false, /*byte_align=*/false);
+    data.insert(data.end(), image.begin(), image.end());
+    if (random.Next(2)) {
+      data.resize(random.Next(data.size() + 1));
+    }
+    if (!data.empty() && random.Next(2)) {
+      const uint32_t bit = random.Next(data.size() * 8);
+      data[bit / 8] ^= 0x80 >> (bit % 8);
+    }
+    SCOPED_TRACE(testing::Message() << "image " << i);
+
+    const int starting_bitpos = skip_bytes * 8;
+    std::vector<uint8_t> dest(pitch * height);
+    std::vector<uint8_t> old_dest(pitch * height);
+    EXPECT_EQ(old_decoder::FaxG4Decode(data, starting_bitpos, width, height,
+                                       pitch, old_dest.data()),
+              FaxModule::FaxG4Decode(data, starting_bitpos, width, height,
+                                     pitch, dest.data()));
+    EXPECT_EQ(old_dest, dest);
+  }
+}
+
+}  // namespace fxcodec
@@ -0,0 +1,235 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/fax/faxmodule.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/fxcodec/scanlinedecoder.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/span.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+namespace fxcodec {
+
+namespace {
+
+constexpr int kWidth = 24;
+constexpr int kHeight = 6;
+
+// '#' for black.
+constexpr const char* kImage[kHeight] = {
+    "........................",  //
+    "..####......##....#####.",  //
+    ".#....#....#.#....#.....",  //
+    ".######...#..#....####..",  //
+    ".#....#..######...#.....",  //
+    ".#....#......#....#####.",  //
+};
+
+// kImage in G4, T.6 two-dimensional coding, with no end of block code.
+constexpr uint8_t kG4[] = {0x97, 0x67, 0xb3, 0x67, 0x45, 0x59, 0x56,
+                           0x11, 0x1d, 0x4a, 0xc8, 0xd2, 0xe0, 0xf2,
+                           0xae, 0x85, 0xc1, 0x7c, 0xf2, 0x93, 0x1c};
+
+// kImage in G3, T.4 one-dimensional coding, with an end of line code before
+// each row.
+constexpr uint8_t kG3OneDimensional[] = {
+    0x00, 0x15, 0x00, 0x02, 0xef, 0xbb, 0x31, 0xc0, 0x04, 0x75, 0x6a,
+    0xd0, 0xea, 0xd6, 0x00, 0x08, 0xe5, 0x09, 0xd5, 0xb7, 0x00, 0x11,
+    0xd5, 0xa7, 0x28, 0x58, 0x00, 0x23, 0xab, 0x5c, 0xac, 0xc7};
+
+// kImage in G3 with K = 2, so rows alternate between one-dimensional and
+// two-dimensional coding, with an end of line code and a tag bit before each.
+constexpr uint8_t kG3Mixed[] = {
+    0x00, 0x1a, 0x80, 0x01, 0x17, 0x67, 0xb3, 0x67, 0x00, 0x18, 0xea,
+    0xd5, 0xa1, 0xd5, 0xac, 0x00, 0x14, 0x69, 0x70, 0x70, 0x01, 0x8e,
+    0xad, 0x39, 0x42, 0xc0, 0x01, 0x79, 0xe5, 0x26, 0x38};
+
+// As kG4, with each row padded to a byte.
+constexpr uint8_t kG4ByteAligned[] = {
+    0x80, 0x2e, 0xcf, 0x66, 0xce, 0x45, 0x59, 0x56, 0x11, 0x1d, 0x4a, 0xc0,
+    0x8d, 0x2e, 0x0e, 0x95, 0x74, 0x2e, 0x0a, 0xf3, 0xca, 0x4c, 0x70};
+
+// As kG3OneDimensional, with each end of line code padded to end a byte.
+constexpr uint8_t kG3OneDimensionalByteAligned[] = {
+    0x00, 0x01, 0x50, 0x00, 0x01, 0x77, 0xdd, 0x98, 0xe0, 0x01, 0x1d, 0x5a,
+    0xb4, 0x3a, 0xb5, 0x80, 0x01, 0x1c, 0xa1, 0x3a, 0xb6, 0xe0, 0x01, 0x1d,
+    0x5a, 0x72, 0x85, 0x80, 0x01, 0x1d, 0x5a, 0xe5, 0x66, 0x38};
+
+constexpr uint8_t kGarbage[] = {0xde, 0xad, 0xbe, 0xef,
+                                0x00, 0x00, 0x13, 0x37};
+
+struct Decoded {
+  // One per row, with '#' for 0 bits, which are black unless BlackIs1, and
+  // empty for rows that did not decode.
+  std::vector<std::string> rows;
+  // GetSrcOffset() after each row.
+  std::vector<uint32_t> offsets;
+};
+
+Decoded Decode(pdfium::span<const uint8_t> data,
+               int k,
+               bool end_of_line,
+               bool byte_align,
+               bool black_is_1) {
+  std::unique_ptr<ScanlineDecoder> decoder =
+      FaxModule::CreateDecoder(data, kWidth, kHeight, k, end_of_line,
+                               byte_align, black_is_1, kWidth, kHeight);
+  CHECK(decoder);
+  Decoded decoded;
+  for (int row = 0; row < kHeight; ++row) {
+    pdfium::span<const uint8_t> line = decoder->GetScanline(row);
+    std::string pixels;
+    for (int x = 0; !line.empty() && x < kWidth; ++x) {
+      pixels += line[x / 8] & (0x80 >> (x % 8)) ? '.' : '#';
+    }
+    decoded.rows.push_back(pixels);
+    decoded.offsets.push_back(decoder->GetSrcOffset());
+  }
+  return decoded;
+}
+
+}  // namespace
+
+TEST(FaxModuleTest, G4) {
+  Decoded decoded = Decode(kG4, /*k=*/-1, /*end_of_line=*/false,
+                           /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAreArray(kImage));
+  EXPECT_THAT(decoded.offsets, ElementsAre(1, 4, 11, 14, 18, 21));
+}
+
+TEST(FaxModuleTest, G3OneDimensional) {
+  Decoded decoded =
+      Decode(kG3OneDimensional, /*k=*/0, /*end_of_line=*/true,
+             /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAreArray(kImage));
+  EXPECT_THAT(decoded.offsets, ElementsAre(4, 9, 16, 22, 28, 32));
+
+  // End of line codes are skipped whether or not they are expected.
+  decoded = Decode(kG3OneDimensional, /*k=*/0, /*end_of_line=*/false,
+                   /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAreArray(kImage));
+}
+
+TEST(FaxModuleTest, G3Mixed) {
+  Decoded decoded = Decode(kG3Mixed, /*k=*/2, /*end_of_line=*/true,
+                           /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAreArray(kImage));
+  EXPECT_THAT(decoded.offsets, ElementsAre(4, 10, 17, 21, 27, 31));
+}
+
+TEST(FaxModuleTest, EncodedByteAlign) {
+  Decoded decoded =
+      Decode(kG4ByteAligned, /*k=*/-1, /*end_of_line=*/false,
+             /*byte_align=*/true, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAreArray(kImage));
+  EXPECT_THAT(decoded.offsets, ElementsAre(1, 5, 12, 15, 19, 23));
+
+  decoded = Decode(kG3OneDimensionalByteAligned, /*k=*/0,
+                   /*end_of_line=*/true, /*byte_align=*/true,
+                   /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAreArray(kImage));
+  EXPECT_THAT(decoded.offsets, ElementsAre(5, 10, 17, 23, 29, 34));
+}
+
+TEST(FaxModuleTest, BlackIs1) {
+  Decoded decoded = Decode(kG4, /*k=*/-1, /*end_of_line=*/false,
+                           /*byte_align=*/false, /*black_is_1=*/true);
+  EXPECT_THAT(decoded.rows, ElementsAre("########################",
+                                        "##....######..####.....#",
+                                        "#.####.####.#.####.#####",
+                                        "#......###.##.####....##",
+                                        "#.####.##......###.#####",
+                                        "#.####.######.####.....#"));
+}
+
+TEST(FaxModuleTest, Truncated) {
+  Decoded decoded =
+      Decode(pdfium::span(kG4).first(sizeof(kG4) / 2), /*k=*/-1,
+             /*end_of_line=*/false, /*byte_align=*/false,
+             /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows,
+              ElementsAre(kImage[0], kImage[1], kImage[2], "", "", ""));
+  EXPECT_THAT(decoded.offsets, ElementsAre(1, 4, 10, 10, 10, 10));
+
+  decoded = Decode(
+      pdfium::span(kG3OneDimensional).first(sizeof(kG3OneDimensional) / 2),
+      /*k=*/0, /*end_of_line=*/true, /*byte_align=*/false,
+      /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows,
+              ElementsAre(kImage[0], kImage[1], kImage[2], "", "", ""));
+  EXPECT_THAT(decoded.offsets, ElementsAre(4, 9, 16, 16, 16, 16));
+}
+
+TEST(FaxModuleTest, Garbage) {
+  Decoded decoded = Decode(kGarbage, /*k=*/-1, /*end_of_line=*/false,
+                           /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAre("........................",
+                                        "........................",
+                                        "........................",
+                                        "........................",
+                                        "........................",
+                                        ".......................#"));
+  EXPECT_THAT(decoded.offsets, ElementsAre(1, 1, 1, 1, 1, 2));
+
+  decoded = Decode(kGarbage, /*k=*/0, /*end_of_line=*/false,
+                   /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAre("........................",
+                                        "........................",
+                                        "......##................",
+                                        "........................",
+                                        "........................", ""));
+  EXPECT_THAT(decoded.offsets, ElementsAre(2, 3, 7, 8, 8, 8));
+
+  decoded = Decode(kGarbage, /*k=*/2, /*end_of_line=*/false,
+                   /*byte_align=*/false, /*black_is_1=*/false);
+  EXPECT_THAT(decoded.rows, ElementsAre("....##..................",
+                                        "....##..................",
+                                        "........................",
+                                        "........................",
+                                        "........................",
+                                        "........................"));
+  EXPECT_THAT(decoded.offsets, ElementsAre(2, 3, 4, 7, 7, 8));
+}
+
+TEST(FaxModuleTest, FaxG4Decode) {
+  constexpr size_t kPitch = 4;
+  std::vector<uint8_t> dest(kPitch * kHeight);
+  EXPECT_EQ(166, FaxModule::FaxG4Decode(kG4, /*starting_bitpos=*/0, kWidth,
+                                        kHeight, kPitch, dest.data()));
+  std::unique_ptr<ScanlineDecoder> decoder = FaxModule::CreateDecoder(
+      kG4, kWidth, kHeight, /*K=*/-1, /*EndOfLine=*/false,
+      /*EncodedByteAlign=*/false, /*BlackIs1=*/false, kWidth, kHeight);
+  for (int row = 0; row < kHeight; ++row) {
+    EXPECT_THAT(pdfium::span(dest).subspan(row * kPitch, kPitch),
+                ElementsAreArray(decoder->GetScanline(row)));
+  }
+}
+
+TEST(FaxModuleTest, CreateDecoderRejectsBadSizes) {
+  EXPECT_FALSE(FaxModule::CreateDecoder(kG4, 0, kHeight, -1, false, false,
+                                        false, 0, 0));
+  EXPECT_FALSE(FaxModule::CreateDecoder(kG4, kWidth, kHeight, -1, false,
+                                        false, false, 65536, 0));
+  EXPECT_FALSE(FaxModule::CreateDecoder(kG4, kWidth, kHeight, -1, false,
+                                        false, false, 0, -1));
+  // Columns and Rows win over the image size.
+  std::unique_ptr<ScanlineDecoder> decoder = FaxModule::CreateDecoder(
+      kG4, 1, 1, -1, false, false, false, kWidth, kHeight);
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(kWidth, decoder->GetWidth());
+  EXPECT_EQ(kHeight, decoder->GetHeight());
+}
+
+}  // namespace fxcodec
@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
 
 #include "core/fxcodec/data_and_bytes_consumed.h"
 #include "core/fxcrt/data_vector.h"
@@ -18,9 +19,23 @@
 namespace fxcodec {
 
 class ScanlineDecoder;
+class StreamDecoder;
 
 class FlateModule {
  public:
+  // Finds where Flate data of unknown length ends, as it arrives a piece at a
+  // time, without inflating what came before again for every piece.
+  class EndFinder {
+   public:
+    virtual ~EndFinder() = default;
+
+    // Takes `data`, which follows what the calls before took. Returns how
+    // many bytes of all that the Flate data takes once it ended or failed to
+    // inflate, as FlateOrLZWDecode() would count them, or nullopt while it
+    // needs more.
+    virtual std::optional<uint32_t> Take(pdfium::span<const uint8_t> data) = 0;
+  };
+
   static std::unique_ptr<ScanlineDecoder> CreateDecoder(
       pdfium::span<const uint8_t> src_span,
       int width,
@@ -32,6 +47,18 @@ class FlateModule {
       int BitsPerComponent,
       int Columns);
 
+  // Decodes the same data as FlateOrLZWDecode() does for Flate, a piece at a
+  // time, undoing any predictor a row at a time. Returns nullptr when the
+  // predictor parameters are unusable, where FlateOrLZWDecode() fails.
+  static std::unique_ptr<StreamDecoder> CreateStreamDecoder(
+      pdfium::span<const uint8_t> src_span,
+      int predictor,
+      int Colors,
+      int BitsPerComponent,
+      int Columns);
+
+  static std::unique_ptr<EndFinder> CreateEndFinder();
+
   static DataAndBytesConsumed FlateOrLZWDecode(
       bool bLZW,
       pdfium::span<const uint8_t> src_span,
@@ -42,6 +69,12 @@ class FlateModule {
       int Columns,
       uint32_t estimated_size);
 
+  // Decodes Flate data with zlib alone, as FlateOrLZWDecode() does when it is
+  // built without libdeflate, to compare the libdeflate path against.
+  static DataAndBytesConsumed ZlibDecodeForTesting(
+      pdfium::span<const uint8_t> src_span,
+      uint32_t estimated_size);
+
   static DataVector<uint8_t> Encode(pdfium::span<const uint8_t> src_span);
 
   FlateModule() = delete;
@@ -0,0 +1,205 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/fxcodec/data_and_bytes_consumed.h"
+#include "core/fxcodec/flate/flatemodule.h"
+#include "core/fxcodec/streamdecoder.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_test_helpers.h"
+#include "testing/utils/file_util.h"
+#include "testing/utils/path_service.h"
+
+namespace {
+
+constexpr size_t kContentSize = 8 * 1024 * 1024;
+// What CPDF_ContentStreamReader reads at a time.
+constexpr size_t kReadSize = 64 * 1024;
+constexpr int kRuns = 9;
+// How many times over the real streams get decoded in one run, since they are
+// small.
+constexpr int kRealStreamRepeats = 20;
+
+// Test files with a good mix of Flate content, font and image streams.
+constexpr const char* kRealStreamFiles[] = {
+    "annotation_stamp_with_ap.pdf",
+    "bug_1029.pdf",
+    "bug_707673.pdf",
+    "embedded_images.pdf",
+    "pixel/xfa_specific/resolve_nodes_0.pdf",
+    "pixel/xfa_specific/static_password_field_rotate.pdf",
+};
+
+// Returns about `kContentSize` bytes that look like page content.
+std::string MakeContent() {
+  std::string content;
+  for (int i = 0; content.size() < kContentSize; ++i) {
+    content += "q 1 0 0 1 " + std::to_string(i % 612) + " " +
+               std::to_string(i % 792) + " cm 0." + std::to_string(i % 10) +
+               " g 0 0 " + std::to_string(i % 37) + " " +
+               std::to_string(i % 41) + " re f Q\n";
+  }
+  return content;
+}
+
+// Returns the raw data of each stream in `file` that has no filter but
+// FlateDecode and no predictor, found by scanning for stream keywords.
+std::vector<std::vector<uint8_t>> GetRealFlateStreams(const char* file) {
+  const std::string path = PathService::GetTestFilePath(file);
+  const std::vector<uint8_t> contents = GetFileContents(path.c_str());
+  const std::string text(contents.begin(), contents.end());
+  std::vector<std::vector<uint8_t>> streams;
+  size_t dict_start = 0;
+  size_t pos = 0;
+  while ((pos = text.find("stream", pos)) != std::string::npos) {
+    if (pos > 0 && text[pos - 1] == 'd') {
+      pos += 6;
+      dict_start = pos;
+      continue;
+    }
+    const std::string dict = text.substr(dict_start, pos - dict_start);
+    pos += 6;
+    if (text.compare(pos, 2, "\r\n") == 0) {
+      pos += 2;
+    } else if (text[pos] == '\n') {
+      pos += 1;
+    } else {
+      continue;
+    }
+    const size_t end = text.find("endstream", pos);
+    if (end == std::string::npos) {
+      break;
+    }
+    if (dict.find("/FlateDecode") != std::string::npos &&
+        dict.find("/DecodeParms") == std::string::npos &&
+        dict.find('[') == std::string::npos) {
+      streams.emplace_back(contents.begin() + pos, contents.begin() + end);
+    }
+    pos = end;
+  }
+  return streams;
+}
+
+}  // namespace
+
+// Decoding all at once grows the output as zlib fills it, or goes through
+// libdeflate in builds with pdf_use_libdeflate, which "zlib_only" leaves out.
+// Decoding a piece at a time, as page content does, only ever holds one read's
+// worth of output.
+TEST(FlateModulePerfTest, Decode) {
+  const std::string content = MakeContent();
+  const DataVector<uint8_t> src =
+      FlateModule::Encode(pdfium::as_bytes(pdfium::span(content)));
+
+  PrintPerfResult("flate_decode_8mib_content", "zlib_only",
+                  MedianRunTime(kRuns, [&src, &content] {
+                    DataAndBytesConsumed result =
+                        FlateModule::ZlibDecodeForTesting(
+                            src, /*estimated_size=*/0);
+                    EXPECT_EQ(content.size(), result.data.size());
+                  }));
+
+  PrintPerfResult("flate_decode_8mib_content", "all_at_once",
+                  MedianRunTime(kRuns, [&src, &content] {
+                    DataAndBytesConsumed result =
+                        FlateModule::FlateOrLZWDecode(
+                            /*use_lzw=*/false, src, /*early_change=*/false,
+                            /*predictor=*/0, /*Colors=*/0,
+                            /*BitsPerComponent=*/0, /*Columns=*/0,
+                            /*estimated_size=*/0);
+                    EXPECT_EQ(content.size(), result.data.size());
+                  }));
+  PrintPerfResult("flate_decode_8mib_content", "a_piece_at_a_time",
+                  MedianRunTime(kRuns, [&src, &content] {
+                    std::unique_ptr<StreamDecoder> decoder =
+                        FlateModule::CreateStreamDecoder(
+                            src, /*predictor=*/0, /*Colors=*/0,
+                            /*BitsPerComponent=*/0, /*Columns=*/0);
+                    DataVector<uint8_t> buffer(kReadSize);
+                    size_t total = 0;
+                    while (size_t size = decoder->Read(buffer)) {
+                      total += size;
+                    }
+                    EXPECT_EQ(content.size(), total);
+                  }));
+}
+
+// The same two ways of decoding, on the Flate streams of real PDF files. These
+// are mostly a few KiB each, as most streams are.
+TEST(FlateModulePerfTest, DecodeRealStreams) {
+  std::vector<std::vector<uint8_t>> streams;
+  for (const char* file : kRealStreamFiles) {
+    for (std::vector<uint8_t>& stream : GetRealFlateStreams(file)) {
+      streams.push_back(std::move(stream));
+    }
+  }
+  ASSERT_FALSE(streams.empty());
+
+  size_t src_size = 0;
+  size_t dest_size = 0;
+  for (const std::vector<uint8_t>& stream : streams) {
+    src_size += stream.size();
+    dest_size += FlateModule::FlateOrLZWDecode(
+                     /*use_lzw=*/false, stream, /*early_change=*/false,
+                     /*predictor=*/0, /*Colors=*/0, /*BitsPerComponent=*/0,
+                     /*Columns=*/0, /*estimated_size=*/0)
+                     .data.size();
+  }
+  RecordProperty("streams", static_cast<int>(streams.size()));
+  RecordProperty("src_bytes", static_cast<int>(src_size));
+  RecordProperty("dest_bytes", static_cast<int>(dest_size));
+
+  PrintPerfResult("flate_decode_real_streams", "zlib_only",
+                  MedianRunTime(kRuns, [&streams, dest_size] {
+                    for (int i = 0; i < kRealStreamRepeats; ++i) {
+                      size_t total = 0;
+                      for (const std::vector<uint8_t>& stream : streams) {
+                        total += FlateModule::ZlibDecodeForTesting(
+                                     stream, /*estimated_size=*/0)
+                                     .data.size();
+                      }
+                      EXPECT_EQ(dest_size, total);
+                    }
+                  }));
+  PrintPerfResult("flate_decode_real_streams", "all_at_once",
+                  MedianRunTime(kRuns, [&streams, dest_size] {
+                    for (int i = 0; i < kRealStreamRepeats; ++i) {
+                      size_t total = 0;
+                      for (const std::vector<uint8_t>& stream : streams) {
+                        total += FlateModule::FlateOrLZWDecode(
+                                     /*use_lzw=*/false, stream,
+                                     /*early_change=*/false, /*predictor=*/0,
+                                     /*Colors=*/0, /*BitsPerComponent=*/0,
+                                     /*Columns=*/0, /*estimated_size=*/0)
+                                     .data.size();
+                      }
+                      EXPECT_EQ(dest_size, total);
+                    }
+                  }));
+  PrintPerfResult("flate_decode_real_streams", "a_piece_at_a_time",
+                  MedianRunTime(kRuns, [&streams, dest_size] {
+                    DataVector<uint8_t> buffer(kReadSize);
+                    for (int i = 0; i < kRealStreamRepeats; ++i) {
+                      size_t total = 0;
+                      for (const std::vector<uint8_t>& stream : streams) {
+                        std::unique_ptr<StreamDecoder> decoder =
+                            FlateModule::CreateStreamDecoder(
+                                stream, /*predictor=*/0, /*Colors=*/0,
+                                /*BitsPerComponent=*/0, /*Columns=*/0);
+                        while (size_t size = decoder->Read(buffer)) {
+                          total += size;
+                        }
+                      }
+                      EXPECT_EQ(dest_size, total);
+                    }
+                  }));
+}
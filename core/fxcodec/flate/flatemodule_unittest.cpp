@@ -4,13 +4,40 @@
 
 #include "core/fxcodec/flate/flatemodule.h"
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "core/fxcodec/data_and_bytes_consumed.h"
+#include "core/fxcodec/streamdecoder.h"
+#include "core/fxcrt/data_vector.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/test_support.h"
 
 using testing::ElementsAreArray;
 
+namespace {
+
+DataVector<uint8_t> ReadAll(StreamDecoder* decoder, size_t read_size) {
+  DataVector<uint8_t> result;
+  while (true) {
+    const size_t size = result.size();
+    result.resize(size + read_size);
+    const size_t read = decoder->Read(pdfium::span(result).subspan(size));
+    result.resize(size + read);
+    if (read < read_size) {
+      return result;
+    }
+  }
+}
+
+}  // namespace
+
 // NOTE: python's zlib.compress() and zlib.decompress() may be useful for
 // external validation of the FlateDncode/FlateEecode test cases.
 TEST(FlateModule, Decode) {
@@ -72,3 +99,175 @@ TEST(FlateModule, Encode) {
     ++i;
   }
 }
+
+// Output many times the size of the input outgrows any first guess at its
+// size, and damaged input still decodes as far as it can.
+TEST(FlateModule, DecodeLargeAndDamaged) {
+  DataVector<uint8_t> raw(1024 * 1024);
+  for (size_t i = 0; i < raw.size(); ++i) {
+    raw[i] = static_cast<uint8_t>(i % 251 < 10 ? i : 0);
+  }
+  const DataVector<uint8_t> src = FlateModule::Encode(raw);
+  ASSERT_LT(src.size() * 10, raw.size());
+
+  for (uint32_t estimated_size : {0u, 1000u, 1024u * 1024u}) {
+    DataAndBytesConsumed result = FlateModule::FlateOrLZWDecode(
+        false, src, false, 0, 0, 0, 0, estimated_size);
+    EXPECT_EQ(src.size(), result.bytes_consumed);
+    EXPECT_EQ(raw, result.data) << " for estimated size " << estimated_size;
+  }
+
+  // A wrong checksum at the end does not lose any data.
+  DataVector<uint8_t> bad_checksum = src;
+  bad_checksum.back() ^= 1;
+  EXPECT_EQ(raw, FlateModule::FlateOrLZWDecode(false, bad_checksum, false, 0,
+                                               0, 0, 0, 0)
+                     .data);
+
+  // Cut off input gives what there is of the data.
+  pdfium::span<const uint8_t> truncated =
+      pdfium::span(src).first(src.size() / 2);
+  DataAndBytesConsumed result =
+      FlateModule::FlateOrLZWDecode(false, truncated, false, 0, 0, 0, 0, 0);
+  ASSERT_FALSE(result.data.empty());
+  ASSERT_LT(result.data.size(), raw.size());
+  EXPECT_TRUE(std::ranges::equal(result.data,
+                                 pdfium::span(raw).first(result.data.size())));
+}
+
+// Whichever inflater FlateOrLZWDecode() is built with, it decodes valid and
+// damaged data to the same bytes as zlib and consumes as much of it.
+TEST(FlateModule, DecodeMatchesZlib) {
+  DataVector<uint8_t> compressible(1024 * 1024);
+  for (size_t i = 0; i < compressible.size(); ++i) {
+    compressible[i] = static_cast<uint8_t>(i % 251 < 10 ? i : 0);
+  }
+  // Data that does not compress gets stored as is.
+  DataVector<uint8_t> incompressible(100000);
+  uint32_t seed = 1;
+  for (uint8_t& byte : incompressible) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+
+  std::vector<DataVector<uint8_t>> inputs;
+  for (const DataVector<uint8_t>& raw : {compressible, incompressible}) {
+    const DataVector<uint8_t> src = FlateModule::Encode(raw);
+    inputs.push_back(src);
+    for (size_t size : {size_t{1}, size_t{2}, src.size() / 3, src.size() - 4,
+                        src.size() - 1}) {
+      inputs.emplace_back(src.begin(), src.begin() + size);
+    }
+    DataVector<uint8_t> damaged = src;
+    damaged.back() ^= 1;
+    inputs.push_back(damaged);
+    damaged = src;
+    damaged[src.size() / 2] ^= 0x55;
+    inputs.push_back(damaged);
+    damaged = src;
+    damaged[0] ^= 1;
+    inputs.push_back(damaged);
+    damaged = src;
+    damaged.insert(damaged.end(), {'e', 'n', 'd', 's', 't', 'r', 'e', 'a', 'm'});
+    inputs.push_back(damaged);
+  }
+  inputs.push_back(FlateModule::Encode({}));
+  static constexpr uint8_t kNonsense[] = "preposterous nonsense";
+  inputs.emplace_back(std::begin(kNonsense), std::end(kNonsense));
+
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    for (uint32_t estimated_size : {0u, 1000u, 1024u * 1024u}) {
+      DataAndBytesConsumed expected =
+          FlateModule::ZlibDecodeForTesting(inputs[i], estimated_size);
+      DataAndBytesConsumed result = FlateModule::FlateOrLZWDecode(
+          false, inputs[i], false, 0, 0, 0, 0, estimated_size);
+      EXPECT_EQ(expected.bytes_consumed, result.bytes_consumed)
+          << " for input " << i << " estimated size " << estimated_size;
+      EXPECT_EQ(expected.data, result.data)
+          << " for input " << i << " estimated size " << estimated_size;
+    }
+  }
+}
+
+TEST(FlateModule, StreamDecoder) {
+  // 10 columns of 3 colors give rows of 30 bytes. For PNG predictors, each row
+  // also has a tag in front, which here goes through all of them and an
+  // invalid one. The last row is cut short.
+  DataVector<uint8_t> raw;
+  for (int row = 0; row < 20; ++row) {
+    raw.push_back(row % 6);
+    for (int i = 0; i < 30; ++i) {
+      raw.push_back(static_cast<uint8_t>(row * 7 + i * 13));
+    }
+  }
+  raw.resize(raw.size() - 10);
+  const DataVector<uint8_t> src = FlateModule::Encode(raw);
+
+  for (int predictor : {1, 2, 10, 15}) {
+    DataAndBytesConsumed expected = FlateModule::FlateOrLZWDecode(
+        false, src, false, predictor, 3, 8, 10, 0);
+    ASSERT_FALSE(expected.data.empty());
+    for (size_t read_size : {1u, 7u, 4096u}) {
+      std::unique_ptr<StreamDecoder> decoder =
+          FlateModule::CreateStreamDecoder(src, predictor, 3, 8, 10);
+      ASSERT_TRUE(decoder);
+      EXPECT_THAT(ReadAll(decoder.get(), read_size),
+                  ElementsAreArray(expected.data))
+          << " for predictor " << predictor << " read size " << read_size;
+    }
+  }
+}
+
+TEST(FlateModule, StreamDecoderBadInput) {
+  // Rows without any bytes cannot be predicted.
+  EXPECT_FALSE(FlateModule::CreateStreamDecoder({}, 10, 0, 8, 10));
+  EXPECT_FALSE(FlateModule::CreateStreamDecoder({}, 2, 3, 8, 0));
+
+  static constexpr uint8_t kNonsense[] = "preposterous nonsense";
+  std::unique_ptr<StreamDecoder> decoder =
+      FlateModule::CreateStreamDecoder(kNonsense, 0, 0, 0, 0);
+  ASSERT_TRUE(decoder);
+  EXPECT_TRUE(ReadAll(decoder.get(), 16).empty());
+}
+
+TEST(FlateModule, EndFinder) {
+  DataVector<uint8_t> raw(100000);
+  for (size_t i = 0; i < raw.size(); ++i) {
+    raw[i] = static_cast<uint8_t>(i * i % 253);
+  }
+  DataVector<uint8_t> src = FlateModule::Encode(raw);
+  const uint32_t flate_size = static_cast<uint32_t>(src.size());
+  // What follows the Flate data does not count.
+  src.insert(src.end(), {'E', 'I', ' ', 'Q'});
+
+  for (size_t piece_size : {1u, 100u, 100000u}) {
+    std::unique_ptr<FlateModule::EndFinder> finder =
+        FlateModule::CreateEndFinder();
+    std::optional<uint32_t> end;
+    size_t taken = 0;
+    while (!end.has_value() && taken < src.size()) {
+      const size_t size = std::min(piece_size, src.size() - taken);
+      end = finder->Take(pdfium::span(src).subspan(taken, size));
+      taken += size;
+    }
+    EXPECT_EQ(flate_size, end) << " for piece size " << piece_size;
+    EXPECT_EQ(FlateModule::FlateOrLZWDecode(false, src, false, 0, 0, 0, 0, 0)
+                  .bytes_consumed,
+              end.value_or(0));
+  }
+
+  // Data that does not inflate ends right away.
+  static constexpr uint8_t kNonsense[] = "preposterous nonsense";
+  std::unique_ptr<FlateModule::EndFinder> finder =
+      FlateModule::CreateEndFinder();
+  std::optional<uint32_t> end = finder->Take(kNonsense);
+  ASSERT_TRUE(end.has_value());
+  EXPECT_EQ(FlateModule::FlateOrLZWDecode(false, kNonsense, false, 0, 0, 0, 0,
+                                          0)
+                .bytes_consumed,
+            end.value());
+
+  // Cut off data needs more.
+  finder = FlateModule::CreateEndFinder();
+  EXPECT_FALSE(finder->Take(pdfium::span(src).first(flate_size / 2)));
+}
@@ -0,0 +1,158 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/flate/predictor_simd.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "build/build_config.h"
+#include "core/fxcodec/flate/predictor_simd_impl.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/stl_util.h"
+#include "core/fxge/dib/simd_level.h"
+
+namespace fxcodec {
+
+namespace {
+
+const simd_internal::PredictorKernels* GetKernels() {
+  static constexpr fxge::SimdKernelSet<simd_internal::PredictorKernels>
+      kKernels = {
+#if defined(ARCH_CPU_X86_FAMILY)
+      .sse2 = &simd_internal::GetSse2PredictorKernels,
+#elif defined(ARCH_CPU_ARM64)
+      .neon = &simd_internal::GetNeonPredictorKernels,
+#endif
+  };
+  return fxge::GetSimdKernels(kKernels);
+}
+
+uint8_t GetLeftValue(pdfium::span<const uint8_t> span,
+                     size_t i,
+                     size_t bytes_per_pixel) {
+  return i >= bytes_per_pixel ? span[i - bytes_per_pixel] : 0;
+}
+
+uint8_t GetUpValue(pdfium::span<const uint8_t> span, size_t i) {
+  return span.empty() ? 0 : span[i];
+}
+
+uint8_t GetUpperLeftValue(pdfium::span<const uint8_t> span,
+                          size_t i,
+                          size_t bytes_per_pixel) {
+  if (i >= bytes_per_pixel && !span.empty()) {
+    return span[i - bytes_per_pixel];
+  }
+  return 0;
+}
+
+uint8_t PathPredictor(uint8_t a, uint8_t b, uint8_t c) {
+  int p = static_cast<int>(a) + b - c;
+  int pa = abs(p - a);
+  int pb = abs(p - b);
+  int pc = abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  return pb <= pc ? b : c;
+}
+
+// Returns how much of the row the kernels did.
+size_t UndoPngFilterWithKernels(uint8_t tag,
+                                pdfium::span<const uint8_t> src,
+                                pdfium::span<const uint8_t> up,
+                                pdfium::span<uint8_t> dest,
+                                size_t bytes_per_pixel) {
+  const simd_internal::PredictorKernels* kernels = GetKernels();
+  if (!kernels) {
+    return 0;
+  }
+
+  // Without a row above, Paeth always predicts the left pixel, as Sub does.
+  if (tag == 1 || (tag == 4 && up.empty())) {
+    return kernels->undo_sub(src.data(), dest.data(), src.size(),
+                             bytes_per_pixel);
+  }
+  if (up.size() < src.size()) {
+    return 0;
+  }
+  switch (tag) {
+    case 2:
+      return kernels->undo_up(src.data(), up.data(), dest.data(), src.size());
+    case 3:
+      return kernels->undo_average(src.data(), up.data(), dest.data(),
+                                   src.size(), bytes_per_pixel);
+    case 4:
+      return kernels->undo_paeth(src.data(), up.data(), dest.data(),
+                                 src.size(), bytes_per_pixel);
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+void UndoPngFilter(uint8_t tag,
+                   pdfium::span<const uint8_t> src,
+                   pdfium::span<const uint8_t> up,
+                   pdfium::span<uint8_t> dest,
+                   size_t bytes_per_pixel) {
+  CHECK_LE(src.size(), dest.size());
+  dest = dest.first(src.size());
+  const size_t start =
+      UndoPngFilterWithKernels(tag, src, up, dest, bytes_per_pixel);
+  switch (tag) {
+    case 1: {
+      for (size_t i = start; i < src.size(); ++i) {
+        uint8_t left = GetLeftValue(dest, i, bytes_per_pixel);
+        dest[i] = src[i] + left;
+      }
+      break;
+    }
+    case 2: {
+      for (size_t i = start; i < src.size(); ++i) {
+        uint8_t up_value = GetUpValue(up, i);
+        dest[i] = src[i] + up_value;
+      }
+      break;
+    }
+    case 3: {
+      for (size_t i = start; i < src.size(); ++i) {
+        uint8_t left = GetLeftValue(dest, i, bytes_per_pixel);
+        uint8_t up_value = GetUpValue(up, i);
+        dest[i] = src[i] + (up_value + left) / 2;
+      }
+      break;
+    }
+    case 4: {
+      for (size_t i = start; i < src.size(); ++i) {
+        uint8_t left = GetLeftValue(dest, i, bytes_per_pixel);
+        uint8_t up_value = GetUpValue(up, i);
+        uint8_t upper_left = GetUpperLeftValue(up, i, bytes_per_pixel);
+        dest[i] = src[i] + PathPredictor(left, up_value, upper_left);
+      }
+      break;
+    }
+    default: {
+      fxcrt::Copy(src, dest);
+      break;
+    }
+  }
+}
+
+void UndoHorizontalPredictor(pdfium::span<uint8_t> row,
+                             size_t bytes_per_pixel) {
+  // The predictor adds the pixel to the left, just like PNG's Sub filter.
+  const simd_internal::PredictorKernels* kernels = GetKernels();
+  size_t i = kernels ? kernels->undo_sub(row.data(), row.data(), row.size(),
+                                         bytes_per_pixel)
+                     : 0;
+  for (i = std::max(i, bytes_per_pixel); i < row.size(); ++i) {
+    row[i] += row[i - bytes_per_pixel];
+  }
+}
+
+}  // namespace fxcodec
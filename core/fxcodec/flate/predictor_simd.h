@@ -0,0 +1,35 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCODEC_FLATE_PREDICTOR_SIMD_H_
+#define CORE_FXCODEC_FLATE_PREDICTOR_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+
+namespace fxcodec {
+
+// Row functions for undoing the predictors of Flate and LZW encoded data.
+// They use the SIMD kernels for fxge::GetSimdLevel() where there are some for
+// the pixel size, and give the same results either way.
+
+// Undoes PNG filter `tag` on `src`, one row without its tag byte, into the
+// start of `dest`. `up` is the decoded row above, which is empty for the first
+// row. Unknown tags copy the row as is.
+void UndoPngFilter(uint8_t tag,
+                   pdfium::span<const uint8_t> src,
+                   pdfium::span<const uint8_t> up,
+                   pdfium::span<uint8_t> dest,
+                   size_t bytes_per_pixel);
+
+// Undoes the TIFF horizontal predictor on `row` in place, for components of
+// 8 bits.
+void UndoHorizontalPredictor(pdfium::span<uint8_t> row,
+                             size_t bytes_per_pixel);
+
+}  // namespace fxcodec
+
+#endif  // CORE_FXCODEC_FLATE_PREDICTOR_SIMD_H_
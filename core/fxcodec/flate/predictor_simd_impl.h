@@ -0,0 +1,116 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCODEC_FLATE_PREDICTOR_SIMD_IMPL_H_
+#define CORE_FXCODEC_FLATE_PREDICTOR_SIMD_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+// Shared by the per-instruction set translation units. See
+// core/fxge/dib/composite_simd_impl.h for what may go in here.
+
+namespace fxcodec::simd_internal {
+
+// Each kernel undoes a PNG filter on the leading pixels of a row of `size`
+// bytes, and returns how many bytes that was. The caller does the rest, which
+// only depends on bytes before it. `up` has at least `size` bytes. `dest` may
+// be `src`. Kernels return 0 for pixel sizes they do not handle.
+struct PredictorKernels {
+  size_t (*undo_sub)(const uint8_t* src,
+                     uint8_t* dest,
+                     size_t size,
+                     size_t bytes_per_pixel);
+  size_t (*undo_up)(const uint8_t* src,
+                    const uint8_t* up,
+                    uint8_t* dest,
+                    size_t size);
+  size_t (*undo_average)(const uint8_t* src,
+                         const uint8_t* up,
+                         uint8_t* dest,
+                         size_t size,
+                         size_t bytes_per_pixel);
+  size_t (*undo_paeth)(const uint8_t* src,
+                       const uint8_t* up,
+                       uint8_t* dest,
+                       size_t size,
+                       size_t bytes_per_pixel);
+};
+
+const PredictorKernels& GetSse2PredictorKernels();
+const PredictorKernels& GetNeonPredictorKernels();
+
+// Returns `fn(std::integral_constant<size_t, n>())` for the n of `kSizes` that
+// equals `bytes_per_pixel`, or 0 if there is none.
+template <size_t... kSizes, typename Fn>
+size_t ForPixelSize(size_t bytes_per_pixel, const Fn& fn) {
+  size_t result = 0;
+  ((bytes_per_pixel == kSizes &&
+    (result = fn(std::integral_constant<size_t, kSizes>()), true)) ||
+   ...);
+  return result;
+}
+
+// Implements the kernels on top of `Ops`, which wraps one instruction set, by
+// picking the function for the pixel size. `Ops` provides, all returning how
+// many bytes of the row they did:
+//   UndoSubPrefixSum<n>(src, dest, size)      - Sub for n of 1, 2, 4 and 8,
+//                                               16 bytes at a time.
+//   UndoSubByPixel<n>(src, dest, size)        - Sub for n of 3 and 6.
+//   UndoUp(src, up, dest, size)               - Up, 16 bytes at a time.
+//   UndoAverageByPixel<n>(src, up, dest, size),
+//   UndoPaethByPixel<n>(src, up, dest, size)  - Average and Paeth for n of 2,
+//                                               3, 4, 6 and 8. A byte at a
+//                                               time, the scalar code is just
+//                                               as fast.
+template <typename Ops>
+class PredictorKernelsImpl {
+ public:
+  static size_t UndoSub(const uint8_t* src,
+                        uint8_t* dest,
+                        size_t size,
+                        size_t bytes_per_pixel) {
+    if (bytes_per_pixel == 3 || bytes_per_pixel == 6) {
+      return ForPixelSize<3, 6>(bytes_per_pixel, [&](auto n) {
+        return Ops::template UndoSubByPixel<n.value>(src, dest, size);
+      });
+    }
+    return ForPixelSize<1, 2, 4, 8>(bytes_per_pixel, [&](auto n) {
+      return Ops::template UndoSubPrefixSum<n.value>(src, dest, size);
+    });
+  }
+
+  static size_t UndoAverage(const uint8_t* src,
+                            const uint8_t* up,
+                            uint8_t* dest,
+                            size_t size,
+                            size_t bytes_per_pixel) {
+    return ForPixelSize<2, 3, 4, 6, 8>(bytes_per_pixel, [&](auto n) {
+      return Ops::template UndoAverageByPixel<n.value>(src, up, dest, size);
+    });
+  }
+
+  static size_t UndoPaeth(const uint8_t* src,
+                          const uint8_t* up,
+                          uint8_t* dest,
+                          size_t size,
+                          size_t bytes_per_pixel) {
+    return ForPixelSize<2, 3, 4, 6, 8>(bytes_per_pixel, [&](auto n) {
+      return Ops::template UndoPaethByPixel<n.value>(src, up, dest, size);
+    });
+  }
+
+  static constexpr PredictorKernels kKernels = {
+      .undo_sub = &UndoSub,
+      .undo_up = &Ops::UndoUp,
+      .undo_average = &UndoAverage,
+      .undo_paeth = &UndoPaeth,
+  };
+};
+
+}  // namespace fxcodec::simd_internal
+
+#endif  // CORE_FXCODEC_FLATE_PREDICTOR_SIMD_IMPL_H_
@@ -0,0 +1,164 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "core/fxcodec/flate/predictor_simd_impl.h"
+#include "core/fxcrt/compiler_specific.h"
+
+namespace fxcodec::simd_internal {
+
+namespace {
+
+// Loads the `kBytesPerPixel` bytes at `i` into the low bytes of a register.
+// Reads 8 bytes where they are all before `size`, as the other bytes do not
+// matter.
+template <size_t kBytesPerPixel>
+uint8x8_t LoadPixel(const uint8_t* row, size_t i, size_t size) {
+  // SAFETY: the caller makes sure `i + kBytesPerPixel <= size`.
+  UNSAFE_BUFFERS({
+    if (i + 8 <= size) {
+      return vld1_u8(row + i);
+    }
+    uint8_t bytes[8] = {};
+    memcpy(bytes, row + i, kBytesPerPixel);
+    return vld1_u8(bytes);
+  });
+}
+
+template <size_t kBytesPerPixel>
+void StorePixel(uint8x8_t pixel, uint8_t* row, size_t i) {
+  uint8_t bytes[8];
+  vst1_u8(bytes, pixel);
+  // SAFETY: the caller makes sure the pixel is in bounds.
+  UNSAFE_BUFFERS(memcpy(row + i, bytes, kBytesPerPixel));
+}
+
+// Moves the bytes of `x` up by `kShift`, shifting in zeros.
+template <int kShift>
+uint8x16_t ShiftUp(uint8x16_t x) {
+  return vextq_u8(vdupq_n_u8(0), x, 16 - kShift);
+}
+
+// Pixels go in the low bytes of a 64-bit register.
+struct NeonOps {
+  // Adds the whole pixels before each pixel of 16 bytes in `log2` steps of
+  // doubling shifts, and then the last pixel of the 16 bytes before.
+  template <size_t kBytesPerPixel>
+  static size_t UndoSubPrefixSum(const uint8_t* src,
+                                 uint8_t* dest,
+                                 size_t size) {
+    uint8x16_t carry = vdupq_n_u8(0);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+      // SAFETY: `i + 16 <= size`.
+      UNSAFE_BUFFERS({
+        uint8x16_t x = vld1q_u8(src + i);
+        if constexpr (kBytesPerPixel <= 1) {
+          x = vaddq_u8(x, ShiftUp<1>(x));
+        }
+        if constexpr (kBytesPerPixel <= 2) {
+          x = vaddq_u8(x, ShiftUp<2>(x));
+        }
+        if constexpr (kBytesPerPixel <= 4) {
+          x = vaddq_u8(x, ShiftUp<4>(x));
+        }
+        x = vaddq_u8(x, ShiftUp<8>(x));
+        x = vaddq_u8(x, carry);
+        vst1q_u8(dest + i, x);
+        if constexpr (kBytesPerPixel == 1) {
+          carry = vdupq_laneq_u8(x, 15);
+        } else if constexpr (kBytesPerPixel == 2) {
+          carry = vreinterpretq_u8_u16(
+              vdupq_laneq_u16(vreinterpretq_u16_u8(x), 7));
+        } else if constexpr (kBytesPerPixel == 4) {
+          carry = vreinterpretq_u8_u32(
+              vdupq_laneq_u32(vreinterpretq_u32_u8(x), 3));
+        } else {
+          carry = vreinterpretq_u8_u64(
+              vdupq_laneq_u64(vreinterpretq_u64_u8(x), 1));
+        }
+      });
+    }
+    return i;
+  }
+
+  template <size_t kBytesPerPixel>
+  static size_t UndoSubByPixel(const uint8_t* src, uint8_t* dest, size_t size) {
+    uint8x8_t left = vdup_n_u8(0);
+    size_t i = 0;
+    for (; i + kBytesPerPixel <= size; i += kBytesPerPixel) {
+      left = vadd_u8(LoadPixel<kBytesPerPixel>(src, i, size), left);
+      StorePixel<kBytesPerPixel>(left, dest, i);
+    }
+    return i;
+  }
+
+  template <size_t kBytesPerPixel>
+  static size_t UndoAverageByPixel(const uint8_t* src,
+                                   const uint8_t* up,
+                                   uint8_t* dest,
+                                   size_t size) {
+    uint8x8_t left = vdup_n_u8(0);
+    size_t i = 0;
+    for (; i + kBytesPerPixel <= size; i += kBytesPerPixel) {
+      // vhadd_u8() rounds down, like the filter.
+      const uint8x8_t average =
+          vhadd_u8(left, LoadPixel<kBytesPerPixel>(up, i, size));
+      left = vadd_u8(LoadPixel<kBytesPerPixel>(src, i, size), average);
+      StorePixel<kBytesPerPixel>(left, dest, i);
+    }
+    return i;
+  }
+
+  // With p = a + b - c, compares |p - a| = |b - c|, |p - b| = |a - c| and
+  // |p - c| = |a + b - 2c| in 16-bit lanes.
+  template <size_t kBytesPerPixel>
+  static size_t UndoPaethByPixel(const uint8_t* src,
+                                 const uint8_t* up,
+                                 uint8_t* dest,
+                                 size_t size) {
+    uint8x8_t left = vdup_n_u8(0);
+    uint8x8_t upper_left = vdup_n_u8(0);
+    size_t i = 0;
+    for (; i + kBytesPerPixel <= size; i += kBytesPerPixel) {
+      const uint8x8_t above = LoadPixel<kBytesPerPixel>(up, i, size);
+      const uint16x8_t pa = vabdl_u8(above, upper_left);
+      const uint16x8_t pb = vabdl_u8(left, upper_left);
+      const uint16x8_t pc =
+          vabdq_u16(vaddl_u8(left, above), vaddl_u8(upper_left, upper_left));
+      const uint8x8_t pick_left =
+          vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+      const uint8x8_t pick_above = vmovn_u16(vcleq_u16(pb, pc));
+      const uint8x8_t nearest =
+          vbsl_u8(pick_left, left, vbsl_u8(pick_above, above, upper_left));
+      left = vadd_u8(LoadPixel<kBytesPerPixel>(src, i, size), nearest);
+      StorePixel<kBytesPerPixel>(left, dest, i);
+      upper_left = above;
+    }
+    return i;
+  }
+
+  static size_t UndoUp(const uint8_t* src,
+                       const uint8_t* up,
+                       uint8_t* dest,
+                       size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+      // SAFETY: `i + 16 <= size`.
+      UNSAFE_BUFFERS(
+          vst1q_u8(dest + i, vaddq_u8(vld1q_u8(src + i), vld1q_u8(up + i))));
+    }
+    return i;
+  }
+};
+
+}  // namespace
+
+const PredictorKernels& GetNeonPredictorKernels() {
+  return PredictorKernelsImpl<NeonOps>::kKernels;
+}
+
+}  // namespace fxcodec::simd_internal
@@ -0,0 +1,180 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <emmintrin.h>
+#include <string.h>
+
+#include "core/fxcodec/flate/predictor_simd_impl.h"
+#include "core/fxcrt/compiler_specific.h"
+
+namespace fxcodec::simd_internal {
+
+namespace {
+
+// Loads the `kBytesPerPixel` bytes at `i` into the low bytes of a register.
+// Reads 8 bytes where they are all before `size`, as the other bytes do not
+// matter.
+template <size_t kBytesPerPixel>
+__m128i LoadPixel(const uint8_t* row, size_t i, size_t size) {
+  // SAFETY: the caller makes sure `i + kBytesPerPixel <= size`.
+  UNSAFE_BUFFERS({
+    if (i + 8 <= size) {
+      return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i));
+    }
+    uint8_t bytes[8] = {};
+    memcpy(bytes, row + i, kBytesPerPixel);
+    return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes));
+  });
+}
+
+template <size_t kBytesPerPixel>
+void StorePixel(__m128i pixel, uint8_t* row, size_t i) {
+  uint8_t bytes[8];
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(bytes), pixel);
+  // SAFETY: the caller makes sure the pixel is in bounds.
+  UNSAFE_BUFFERS(memcpy(row + i, bytes, kBytesPerPixel));
+}
+
+// Selects `a` where `mask` is set, and `b` elsewhere.
+__m128i Select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+__m128i Abs16(__m128i x) {
+  return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+// Pixels go in the low bytes of a register, 16-bit lanes where they need
+// room for sums and differences.
+struct Sse2Ops {
+  // Adds the whole pixels before each pixel of 16 bytes in `log2` steps of
+  // doubling shifts, and then the last pixel of the 16 bytes before.
+  template <size_t kBytesPerPixel>
+  static size_t UndoSubPrefixSum(const uint8_t* src,
+                                 uint8_t* dest,
+                                 size_t size) {
+    __m128i carry = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+      // SAFETY: `i + 16 <= size`.
+      UNSAFE_BUFFERS({
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if constexpr (kBytesPerPixel <= 1) {
+          x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+        }
+        if constexpr (kBytesPerPixel <= 2) {
+          x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+        }
+        if constexpr (kBytesPerPixel <= 4) {
+          x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+        }
+        x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi8(x, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), x);
+        if constexpr (kBytesPerPixel == 1) {
+          carry =
+              _mm_set1_epi8(static_cast<char>(_mm_extract_epi16(x, 7) >> 8));
+        } else if constexpr (kBytesPerPixel == 2) {
+          carry = _mm_set1_epi16(static_cast<short>(_mm_extract_epi16(x, 7)));
+        } else if constexpr (kBytesPerPixel == 4) {
+          carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+        } else {
+          carry = _mm_unpackhi_epi64(x, x);
+        }
+      });
+    }
+    return i;
+  }
+
+  template <size_t kBytesPerPixel>
+  static size_t UndoSubByPixel(const uint8_t* src, uint8_t* dest, size_t size) {
+    __m128i left = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + kBytesPerPixel <= size; i += kBytesPerPixel) {
+      left = _mm_add_epi8(LoadPixel<kBytesPerPixel>(src, i, size), left);
+      StorePixel<kBytesPerPixel>(left, dest, i);
+    }
+    return i;
+  }
+
+  template <size_t kBytesPerPixel>
+  static size_t UndoAverageByPixel(const uint8_t* src,
+                                   const uint8_t* up,
+                                   uint8_t* dest,
+                                   size_t size) {
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i left = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + kBytesPerPixel <= size; i += kBytesPerPixel) {
+      const __m128i above = LoadPixel<kBytesPerPixel>(up, i, size);
+      // _mm_avg_epu8() rounds up, where the filter rounds down.
+      __m128i average = _mm_avg_epu8(left, above);
+      average = _mm_sub_epi8(
+          average, _mm_and_si128(_mm_xor_si128(left, above), one));
+      left = _mm_add_epi8(LoadPixel<kBytesPerPixel>(src, i, size), average);
+      StorePixel<kBytesPerPixel>(left, dest, i);
+    }
+    return i;
+  }
+
+  // With p = a + b - c, compares |p - a| = |b - c|, |p - b| = |a - c| and
+  // |p - c| = |a + b - 2c| in 16-bit lanes.
+  template <size_t kBytesPerPixel>
+  static size_t UndoPaethByPixel(const uint8_t* src,
+                                 const uint8_t* up,
+                                 uint8_t* dest,
+                                 size_t size) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i left = zero;
+    __m128i upper_left = zero;
+    size_t i = 0;
+    for (; i + kBytesPerPixel <= size; i += kBytesPerPixel) {
+      const __m128i above =
+          _mm_unpacklo_epi8(LoadPixel<kBytesPerPixel>(up, i, size), zero);
+      __m128i pa = _mm_sub_epi16(above, upper_left);
+      __m128i pb = _mm_sub_epi16(left, upper_left);
+      __m128i pc = _mm_add_epi16(pa, pb);
+      pa = Abs16(pa);
+      pb = Abs16(pb);
+      pc = Abs16(pc);
+      const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+      const __m128i nearest =
+          Select(_mm_cmpeq_epi16(pa, smallest), left,
+                 Select(_mm_cmpeq_epi16(pb, smallest), above, upper_left));
+      const __m128i pixel =
+          _mm_add_epi8(LoadPixel<kBytesPerPixel>(src, i, size),
+                       _mm_packus_epi16(nearest, nearest));
+      StorePixel<kBytesPerPixel>(pixel, dest, i);
+      left = _mm_unpacklo_epi8(pixel, zero);
+      upper_left = above;
+    }
+    return i;
+  }
+
+  static size_t UndoUp(const uint8_t* src,
+                       const uint8_t* up,
+                       uint8_t* dest,
+                       size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+      // SAFETY: `i + 16 <= size`.
+      UNSAFE_BUFFERS({
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dest + i),
+            _mm_add_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i))));
+      });
+    }
+    return i;
+  }
+};
+
+}  // namespace
+
+const PredictorKernels& GetSse2PredictorKernels() {
+  return PredictorKernelsImpl<Sse2Ops>::kKernels;
+}
+
+}  // namespace fxcodec::simd_internal
@@ -0,0 +1,113 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/flate/predictor_simd.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/simd_test_support.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class Rng {
+ public:
+  uint8_t Next() {
+    state_ = state_ * 1103515245 + 12345;
+    return static_cast<uint8_t>(state_ >> 16);
+  }
+
+ private:
+  uint32_t state_ = 1;
+};
+
+std::vector<uint8_t> MakeBytes(size_t size, Rng& rng) {
+  std::vector<uint8_t> bytes(size);
+  for (uint8_t& byte : bytes) {
+    byte = rng.Next();
+  }
+  return bytes;
+}
+
+}  // namespace
+
+TEST(PredictorSimd, UndoPngFilter) {
+  Rng rng;
+  for (size_t bytes_per_pixel = 1; bytes_per_pixel <= 8; ++bytes_per_pixel) {
+    for (size_t length : fxge::kSimdTestLengths) {
+      const std::vector<uint8_t> src = MakeBytes(length, rng);
+      const std::vector<uint8_t> up = MakeBytes(length, rng);
+      for (bool has_up : {false, true}) {
+        const pdfium::span<const uint8_t> up_span =
+            has_up ? pdfium::span<const uint8_t>(up)
+                   : pdfium::span<const uint8_t>();
+        for (uint8_t tag = 0; tag <= 5; ++tag) {
+          auto undo = [&] {
+            // One more byte than the row, which must stay as it is.
+            std::vector<uint8_t> dest(length + 1, 0xcd);
+            fxcodec::UndoPngFilter(tag, src, up_span, dest, bytes_per_pixel);
+            return dest;
+          };
+          const std::vector<uint8_t> expected = fxge::RunWithoutSimd(undo);
+          EXPECT_EQ(0xcd, expected.back());
+
+          fxge::ForEachSupportedSimdLevel([&] {
+            EXPECT_EQ(expected, undo())
+                << "tag " << static_cast<int>(tag) << ", bytes per pixel "
+                << bytes_per_pixel << ", length " << length << ", up "
+                << has_up;
+          });
+        }
+      }
+    }
+  }
+}
+
+TEST(PredictorSimd, UndoPngFilterValues) {
+  fxge::ScopedSimdLevelForTesting scoped_level(fxge::SimdLevel::kNone);
+  static constexpr uint8_t kSrc[] = {10, 20, 30, 40};
+  static constexpr uint8_t kUp[] = {100, 200, 250, 5};
+  uint8_t dest[4];
+
+  fxcodec::UndoPngFilter(1, kSrc, kUp, dest, 1);
+  EXPECT_EQ(std::vector<uint8_t>({10, 30, 60, 100}),
+            std::vector<uint8_t>(std::begin(dest), std::end(dest)));
+
+  fxcodec::UndoPngFilter(2, kSrc, kUp, dest, 1);
+  EXPECT_EQ(std::vector<uint8_t>({110, 220, 24, 45}),
+            std::vector<uint8_t>(std::begin(dest), std::end(dest)));
+
+  // (0 + 100) / 2 + 10, (60 + 200) / 2 + 20, (150 + 250) / 2 + 30 and
+  // (230 + 5) / 2 + 40, rounding down.
+  fxcodec::UndoPngFilter(3, kSrc, kUp, dest, 1);
+  EXPECT_EQ(std::vector<uint8_t>({60, 150, 230, 157}),
+            std::vector<uint8_t>(std::begin(dest), std::end(dest)));
+}
+
+TEST(PredictorSimd, UndoHorizontalPredictor) {
+  Rng rng;
+  for (size_t bytes_per_pixel = 1; bytes_per_pixel <= 8; ++bytes_per_pixel) {
+    for (size_t length : fxge::kSimdTestLengths) {
+      const std::vector<uint8_t> row = MakeBytes(length, rng);
+      std::vector<uint8_t> expected = row;
+      for (size_t i = bytes_per_pixel; i < length; ++i) {
+        expected[i] += expected[i - bytes_per_pixel];
+      }
+
+      auto check = [&] {
+        std::vector<uint8_t> actual = row;
+        fxcodec::UndoHorizontalPredictor(actual, bytes_per_pixel);
+        EXPECT_EQ(expected, actual) << "bytes per pixel " << bytes_per_pixel
+                                    << ", length " << length;
+      };
+      fxge::RunWithoutSimd(check);
+      fxge::ForEachSupportedSimdLevel(check);
+    }
+  }
+}
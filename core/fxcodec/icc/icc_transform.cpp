@@ -15,6 +15,7 @@
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/ptr_util.h"
+#include "core/fxcrt/zip.h"
 
 namespace fxcodec {
 
@@ -27,6 +28,17 @@ struct CmsProfileDeleter {
 
 using ScopedCmsProfile = std::unique_ptr<void, CmsProfileDeleter>;
 
+// The transform may read up to this many values for one color. See the TODO
+// in IccTransform::Translate().
+constexpr size_t kMaxInputValuesPerColor = 16;
+
+// Returns the size of an input buffer for `values` values, with `components`
+// values for each color, that leaves room for the last color.
+size_t GetInputSize(size_t values, size_t components) {
+  return values + kMaxInputValuesPerColor -
+         std::min(components, kMaxInputValuesPerColor);
+}
+
 bool Check3Components(cmsColorSpaceSignature cs) {
   switch (cs) {
     case cmsSigGrayData:
@@ -124,13 +136,15 @@ void IccTransform::Translate(pdfium::span<const float> pSrcValues,
   // places which set transform to verify that only `pSrcValues.size()`
   // components are used.
   if (lab_) {
-    DataVector<double> inputs(std::max<size_t>(pSrcValues.size(), 16));
+    DataVector<double> inputs(
+        GetInputSize(pSrcValues.size(), pSrcValues.size()));
     for (uint32_t i = 0; i < pSrcValues.size(); ++i) {
       inputs[i] = pSrcValues[i];
     }
     cmsDoTransform(transform_, inputs.data(), output, 1);
   } else {
-    DataVector<uint8_t> inputs(std::max<size_t>(pSrcValues.size(), 16));
+    DataVector<uint8_t> inputs(
+        GetInputSize(pSrcValues.size(), pSrcValues.size()));
     for (size_t i = 0; i < pSrcValues.size(); ++i) {
       inputs[i] =
           static_cast<int>(std::clamp(pSrcValues[i] * 255.0f, 0.0f, 255.0f));
@@ -142,6 +156,32 @@ void IccTransform::Translate(pdfium::span<const float> pSrcValues,
   pDestValues[2] = output[0] / 255.0f;
 }
 
+void IccTransform::TranslateColors(pdfium::span<const float> src_values,
+                                   pdfium::span<float> dest_values) {
+  const size_t count = dest_values.size() / 3;
+  src_values = src_values.first(count * src_components_);
+  DataVector<uint8_t> output(count * 3);
+  const cmsUInt32Number pixels = pdfium::checked_cast<cmsUInt32Number>(count);
+  const size_t input_size =
+      GetInputSize(src_values.size(), static_cast<size_t>(src_components_));
+  if (lab_) {
+    DataVector<double> inputs(input_size);
+    std::copy(src_values.begin(), src_values.end(), inputs.begin());
+    cmsDoTransform(transform_, inputs.data(), output.data(), pixels);
+  } else {
+    DataVector<uint8_t> inputs(input_size);
+    for (auto [src, input] : fxcrt::Zip(src_values, inputs)) {
+      input = static_cast<int>(std::clamp(src * 255.0f, 0.0f, 255.0f));
+    }
+    cmsDoTransform(transform_, inputs.data(), output.data(), pixels);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    dest_values[i * 3] = output[i * 3 + 2] / 255.0f;
+    dest_values[i * 3 + 1] = output[i * 3 + 1] / 255.0f;
+    dest_values[i * 3 + 2] = output[i * 3] / 255.0f;
+  }
+}
+
 void IccTransform::TranslateScanline(pdfium::span<uint8_t> pDest,
                                      pdfium::span<const uint8_t> pSrc,
                                      int32_t pixels) {
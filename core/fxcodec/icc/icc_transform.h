@@ -31,6 +31,11 @@ class IccTransform {
 
   void Translate(pdfium::span<const float> pSrcValues,
                  pdfium::span<float> pDestValues);
+  // Same as Translate() for each color in `src_values`, which has components()
+  // values for each color, with 3 values for each in `dest_values`. Converts
+  // all of them with one transform call.
+  void TranslateColors(pdfium::span<const float> src_values,
+                       pdfium::span<float> dest_values);
   void TranslateScanline(pdfium::span<uint8_t> pDest,
                          pdfium::span<const uint8_t> pSrc,
                          int pixels);
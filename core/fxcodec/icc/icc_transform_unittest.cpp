@@ -0,0 +1,86 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/icc/icc_transform.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace fxcodec {
+
+namespace {
+
+// Returns the serialized form of `profile`, and closes it.
+std::vector<uint8_t> SaveProfile(cmsHPROFILE profile) {
+  cmsUInt32Number size = 0;
+  std::vector<uint8_t> data;
+  if (cmsSaveProfileToMem(profile, nullptr, &size)) {
+    data.resize(size);
+    if (!cmsSaveProfileToMem(profile, data.data(), &size)) {
+      data.clear();
+    }
+  }
+  cmsCloseProfile(profile);
+  return data;
+}
+
+// Checks that converting `src_values` in one call gives the same colors as
+// converting them one at a time, for every number of colors.
+void ExpectSameAsOneAtATime(IccTransform& transform,
+                            const std::vector<float>& src_values) {
+  const size_t components = transform.components();
+  const size_t max_count = src_values.size() / components;
+  for (size_t count = 0; count <= max_count; ++count) {
+    SCOPED_TRACE(count);
+    const pdfium::span<const float> src =
+        pdfium::span(src_values).first(count * components);
+    std::vector<float> expected(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+      transform.Translate(src.subspan(i * components, components),
+                          pdfium::span(expected).subspan(i * 3, 3u));
+    }
+    std::vector<float> actual(count * 3);
+    transform.TranslateColors(src, actual);
+    EXPECT_EQ(expected, actual);
+  }
+}
+
+}  // namespace
+
+TEST(IccTransform, TranslateColorsRgb) {
+  const std::vector<uint8_t> profile = SaveProfile(cmsCreate_sRGBProfile());
+  ASSERT_FALSE(profile.empty());
+  std::unique_ptr<IccTransform> transform =
+      IccTransform::CreateTransformSRGB(profile);
+  ASSERT_TRUE(transform);
+  ASSERT_EQ(3, transform->components());
+
+  ExpectSameAsOneAtATime(*transform, {0.0f, 0.0f, 0.0f,   //
+                                      1.0f, 1.0f, 1.0f,   //
+                                      0.2f, 0.5f, 0.9f,   //
+                                      -1.0f, 2.0f, 0.3f,  //
+                                      0.7f, 0.1f, 0.4f});
+}
+
+TEST(IccTransform, TranslateColorsGray) {
+  cmsToneCurve* curve = cmsBuildGamma(nullptr, 2.2);
+  ASSERT_TRUE(curve);
+  const std::vector<uint8_t> profile =
+      SaveProfile(cmsCreateGrayProfile(cmsD50_xyY(), curve));
+  cmsFreeToneCurve(curve);
+  ASSERT_FALSE(profile.empty());
+  std::unique_ptr<IccTransform> transform =
+      IccTransform::CreateTransformSRGB(profile);
+  ASSERT_TRUE(transform);
+  ASSERT_EQ(1, transform->components());
+
+  ExpectSameAsOneAtATime(*transform, {0.0f, 1.0f, 0.25f, 0.5f, -1.0f, 0.9f});
+}
+
+}  // namespace fxcodec
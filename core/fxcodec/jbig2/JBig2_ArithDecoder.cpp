@@ -6,7 +6,9 @@
 
 #include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <iterator>
 
 #include "core/fxcodec/jbig2/JBig2_BitStream.h"
@@ -113,12 +115,18 @@ void CJBig2_ArithDecoder::BYTEIN() {
 }
 
 void CJBig2_ArithDecoder::ReadValueA() {
-  do {
+  // Shifts in as many bits at a time as `a_` needs and `ct_` allows, which
+  // is the same as shifting them in one by one.
+  DCHECK_NE(a_, 0u);
+  unsigned int shift = std::countl_zero(static_cast<uint16_t>(a_));
+  while (shift > 0) {
     if (ct_ == 0) {
       BYTEIN();
     }
-    a_ <<= 1;
-    c_ <<= 1;
-    --ct_;
-  } while ((a_ & kDefaultAValue) == 0);
+    const unsigned int step = std::min(shift, ct_);
+    a_ <<= step;
+    c_ <<= step;
+    ct_ -= step;
+    shift -= step;
+  }
 }
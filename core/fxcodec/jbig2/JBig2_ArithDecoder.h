@@ -33,8 +33,10 @@ class JBig2ArithCtx {
   unsigned int I() const { return i_; }
 
  private:
+  // Kept to 2 bytes, as generic regions use up to 65536 contexts, and are
+  // decoded fastest when those stay in cache.
   bool mps_ = false;
-  unsigned int i_ = 0;
+  uint8_t i_ = 0;
 };
 FX_DATA_PARTITION_EXCEPTION(JBig2ArithCtx);
 
@@ -567,7 +567,7 @@ JBig2_Result CJBig2_Context::ParseSymbolDict(CJBig2_Segment* pSegment) {
     for (auto it = symbol_dict_cache_->begin(); it != symbol_dict_cache_->end();
          ++it) {
       if (it->first == key) {
-        pSegment->symbol_dict_ = it->second->DeepCopy();
+        pSegment->symbol_dict_ = it->second->ShallowCopy();
         symbol_dict_cache_->emplace_front(key, std::move(it->second));
         symbol_dict_cache_->erase(it);
         cache_hit = true;
@@ -596,7 +596,7 @@ JBig2_Result CJBig2_Context::ParseSymbolDict(CJBig2_Segment* pSegment) {
     }
     if (is_global_) {
       std::unique_ptr<CJBig2_SymbolDict> value =
-          pSegment->symbol_dict_->DeepCopy();
+          pSegment->symbol_dict_->ShallowCopy();
       size_t size = symbol_dict_cache_->size();
       while (size >= kSymbolDictCacheMaxSize) {
         symbol_dict_cache_->pop_back();
@@ -6,6 +6,7 @@
 
 #include "core/fxcodec/jbig2/JBig2_GrdProc.h"
 
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <memory>
@@ -36,14 +37,145 @@ constexpr std::array<const uint16_t, 3> kOptConstant7 = {
     {0x0800, 0x0200, 0x0080}};
 constexpr std::array<const uint16_t, 3> kOptConstant8 = {
     {0x0010, 0x0008, 0x0004}};
-constexpr std::array<const uint16_t, 3> kOptConstant9 = {
-    {0x000c, 0x0009, 0x0007}};
-constexpr std::array<const uint16_t, 3> kOptConstant10 = {
-    {0x0007, 0x000f, 0x0007}};
-constexpr std::array<const uint16_t, 3> kOptConstant11 = {
-    {0x001f, 0x001f, 0x000f}};
-constexpr std::array<const uint16_t, 3> kOptConstant12 = {
-    {0x000f, 0x0007, 0x0003}};
+
+// Pixels of a row above the one being decoded that go into the context:
+// `count` pixels, up to x + `max_dx`, from bit `shift` up. The leftmost pixel
+// goes in the highest bit.
+struct TemplateRow {
+  int8_t max_dx;
+  uint8_t count;
+  uint8_t shift;
+};
+
+// Where the pixels of a template go in the context. See 6.2.5.3 in the JBIG2
+// spec.
+struct GenericTemplate {
+  // Pixels decoded just before the current one, which go in the lowest bits.
+  uint8_t previous_pixels;
+  TemplateRow row1;
+  TemplateRow row2;
+  // Context bits of the adaptive template pixels, `GBAT` in pairs.
+  uint8_t at_pixels;
+  std::array<uint8_t, 4> at_shifts;
+  // Context for the SLTP bit of typical prediction.
+  uint16_t sltp_context;
+};
+
+constexpr std::array<const GenericTemplate, 4> kGenericTemplates = {{
+    {4, {2, 5, 5}, {1, 3, 12}, 4, {4, 10, 11, 15}, 0x9b25},
+    {3, {2, 5, 4}, {2, 4, 9}, 1, {3, 0, 0, 0}, 0x0795},
+    {2, {1, 4, 3}, {1, 3, 7}, 1, {2, 0, 0, 0}, 0x00e5},
+    {4, {1, 5, 5}, {0, 0, 0}, 1, {4, 0, 0, 0}, 0x0195},
+}};
+
+const GenericTemplate& GetGenericTemplate(uint8_t gbtemplate) {
+  return kGenericTemplates[std::min<uint8_t>(gbtemplate, 3)];
+}
+
+// Returns the byte of `line` at `index`, or 0 outside of its `size` bytes, or
+// for rows outside the image, where `line` is null.
+uint32_t GetLineByte(const uint8_t* line, int32_t size, int32_t index) {
+  return line && index >= 0 && index < size ? UNSAFE_TODO(line[index]) : 0;
+}
+
+// Like CJBig2_Image::GetPixel(), for a `line` of `width` pixels.
+uint32_t GetLinePixel(const uint8_t* line, int32_t width, int32_t x) {
+  if (!line || x < 0 || x >= width) {
+    return 0;
+  }
+  return UNSAFE_TODO((line[x / 8] >> (7 - x % 8)) & 1);
+}
+
+// Decodes row `y` of `image`, which starts out all 0, for any adaptive
+// template pixels and for SKIP. Rather than looking up each pixel of the
+// context on its own, reads the rows above a byte at a time into windows of
+// 2 or 3 bytes, which move along the row with the current pixel.
+template <uint8_t kGbTemplate>
+bool DecodeGenericRow(const CJBig2_GRDProc& grd,
+                      CJBig2_ArithDecoder* arith_decoder,
+                      pdfium::span<JBig2ArithCtx> contexts,
+                      CJBig2_Image* image,
+                      int32_t y) {
+  constexpr GenericTemplate kTemplate = kGenericTemplates[kGbTemplate];
+  constexpr uint32_t kPreviousMask = (1 << kTemplate.previous_pixels) - 1;
+  constexpr uint32_t kRow1Mask = (1 << kTemplate.row1.count) - 1;
+  constexpr uint32_t kRow2Mask = (1 << kTemplate.row2.count) - 1;
+
+  const int32_t width = image->width();
+  const int32_t line_size = (width + 7) / 8;
+  uint8_t* line = image->GetLine(y);
+  const uint8_t* line1 = image->GetLine(y - 1);
+  const uint8_t* line2 = image->GetLine(y - 2);
+  const uint8_t* skip_line = grd.USESKIP ? grd.SKIP->GetLine(y) : nullptr;
+  const int32_t skip_width = grd.USESKIP ? grd.SKIP->width() : 0;
+
+  // The bytes from `x / 8 - 1` to `x / 8 + 1` of the rows above.
+  uint32_t window1 =
+      GetLineByte(line1, line_size, 0) << 8 | GetLineByte(line1, line_size, 1);
+  uint32_t window2 =
+      GetLineByte(line2, line_size, 0) << 8 | GetLineByte(line2, line_size, 1);
+
+  // Adaptive template pixels in other rows get windows of the 2 bytes from
+  // `(x + dx) / 8` on, with `x + dx` at bit `15 - x % 8 - dx % 8`. The ones
+  // in this row change as it gets decoded, so they get read directly.
+  std::array<const uint8_t*, 4> at_lines = {};
+  std::array<int32_t, 4> at_dx = {};
+  std::array<int32_t, 4> at_byte_offsets = {};
+  std::array<uint32_t, 4> at_windows = {};
+  for (uint8_t i = 0; i < kTemplate.at_pixels; ++i) {
+    at_dx[i] = grd.GBAT[2 * i];
+    at_lines[i] = image->GetLine(y + grd.GBAT[2 * i + 1]);
+    at_byte_offsets[i] = at_dx[i] >> 3;
+    at_windows[i] = GetLineByte(at_lines[i], line_size, at_byte_offsets[i])
+                        << 8 |
+                    GetLineByte(at_lines[i], line_size, at_byte_offsets[i] + 1);
+  }
+
+  uint32_t previous = 0;
+  for (uint32_t w = 0; w < grd.GBW; ++w) {
+    const int32_t x = static_cast<int32_t>(w);
+    const int32_t bit = x % 8;
+    uint32_t value = 0;
+    if (!GetLinePixel(skip_line, skip_width, x)) {
+      uint32_t context = previous & kPreviousMask;
+      context |= ((window1 >> (15 - bit - kTemplate.row1.max_dx)) & kRow1Mask)
+                 << kTemplate.row1.shift;
+      if constexpr (kTemplate.row2.count > 0) {
+        context |=
+            ((window2 >> (15 - bit - kTemplate.row2.max_dx)) & kRow2Mask)
+            << kTemplate.row2.shift;
+      }
+      for (uint8_t i = 0; i < kTemplate.at_pixels; ++i) {
+        const uint32_t pixel =
+            at_lines[i] == line
+                ? GetLinePixel(line, width, x + at_dx[i])
+                : (at_windows[i] >> (15 - bit - (at_dx[i] & 7))) & 1;
+        context |= pixel << kTemplate.at_shifts[i];
+      }
+      if (arith_decoder->IsComplete()) {
+        return false;
+      }
+
+      value = arith_decoder->Decode(&contexts[context]);
+      // Written right away for the adaptive template pixels in this row.
+      if (value && line && x < width) {
+        UNSAFE_TODO(line[x / 8] |= 0x80 >> bit);
+      }
+    }
+    previous = (previous << 1) | value;
+    if (bit == 7) {
+      const int32_t next_byte = x / 8 + 2;
+      window1 = (window1 << 8) | GetLineByte(line1, line_size, next_byte);
+      window2 = (window2 << 8) | GetLineByte(line2, line_size, next_byte);
+      for (uint8_t i = 0; i < kTemplate.at_pixels; ++i) {
+        at_windows[i] =
+            (at_windows[i] << 8) |
+            GetLineByte(at_lines[i], line_size, at_byte_offsets[i] + next_byte);
+      }
+    }
+  }
+  return true;
+}
 
 }  // namespace
 
@@ -71,6 +203,24 @@ bool CJBig2_GRDProc::UseTemplate23Opt3() const {
   return (GBAT[0] == 2) && (GBAT[1] == -1) && !USESKIP;
 }
 
+bool CJBig2_GRDProc::DecodeArithGenericRow(
+    CJBig2_ArithDecoder* pArithDecoder,
+    pdfium::span<JBig2ArithCtx> gbContexts,
+    CJBig2_Image* pImage,
+    uint32_t h) const {
+  const int32_t y = static_cast<int32_t>(h);
+  switch (GBTEMPLATE) {
+    case 0:
+      return DecodeGenericRow<0>(*this, pArithDecoder, gbContexts, pImage, y);
+    case 1:
+      return DecodeGenericRow<1>(*this, pArithDecoder, gbContexts, pImage, y);
+    case 2:
+      return DecodeGenericRow<2>(*this, pArithDecoder, gbContexts, pImage, y);
+    default:
+      return DecodeGenericRow<3>(*this, pArithDecoder, gbContexts, pImage, y);
+  }
+}
+
 std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArith(
     CJBig2_ArithDecoder* pArithDecoder,
     pdfium::span<JBig2ArithCtx> gbContexts) {
@@ -82,19 +232,19 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArith(
     case 0:
       return UseTemplate0Opt3()
                  ? DecodeArithOpt3(pArithDecoder, gbContexts, 0)
-                 : DecodeArithTemplateUnopt(pArithDecoder, gbContexts, 0);
+                 : DecodeArithGeneric(pArithDecoder, gbContexts);
     case 1:
       return UseTemplate1Opt3()
                  ? DecodeArithOpt3(pArithDecoder, gbContexts, 1)
-                 : DecodeArithTemplateUnopt(pArithDecoder, gbContexts, 1);
+                 : DecodeArithGeneric(pArithDecoder, gbContexts);
     case 2:
       return UseTemplate23Opt3()
                  ? DecodeArithOpt3(pArithDecoder, gbContexts, 2)
-                 : DecodeArithTemplateUnopt(pArithDecoder, gbContexts, 2);
+                 : DecodeArithGeneric(pArithDecoder, gbContexts);
     default:
       return UseTemplate23Opt3()
                  ? DecodeArithTemplate3Opt3(pArithDecoder, gbContexts)
-                 : DecodeArithTemplate3Unopt(pArithDecoder, gbContexts);
+                 : DecodeArithGeneric(pArithDecoder, gbContexts);
   }
 }
 
@@ -214,74 +364,6 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithOpt3(
   });
 }
 
-std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplateUnopt(
-    CJBig2_ArithDecoder* pArithDecoder,
-    pdfium::span<JBig2ArithCtx> gbContexts,
-    int UNOPT) {
-  auto GBREG = std::make_unique<CJBig2_Image>(GBW, GBH);
-  if (!GBREG->data()) {
-    return nullptr;
-  }
-
-  GBREG->Fill(false);
-  int LTP = 0;
-  uint8_t MOD2 = UNOPT % 2;
-  uint8_t DIV2 = UNOPT / 2;
-  uint8_t SHIFT = 4 - UNOPT;
-  for (uint32_t h = 0; h < GBH; h++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return nullptr;
-      }
-
-      LTP = LTP ^ pArithDecoder->Decode(&gbContexts[kOptConstant1[UNOPT]]);
-    }
-    if (LTP) {
-      GBREG->CopyLine(h, h - 1);
-      continue;
-    }
-    uint32_t line1 = GBREG->GetPixel(1 + MOD2, h - 2);
-    line1 |= GBREG->GetPixel(MOD2, h - 2) << 1;
-    if (UNOPT == 1) {
-      line1 |= GBREG->GetPixel(0, h - 2) << 2;
-    }
-    uint32_t line2 = GBREG->GetPixel(2 - DIV2, h - 1);
-    line2 |= GBREG->GetPixel(1 - DIV2, h - 1) << 1;
-    if (UNOPT < 2) {
-      line2 |= GBREG->GetPixel(0, h - 1) << 2;
-    }
-    uint32_t line3 = 0;
-    for (uint32_t w = 0; w < GBW; w++) {
-      int bVal = 0;
-      if (!USESKIP || !SKIP->GetPixel(w, h)) {
-        if (pArithDecoder->IsComplete()) {
-          return nullptr;
-        }
-
-        uint32_t CONTEXT = line3;
-        CONTEXT |= GBREG->GetPixel(w + GBAT[0], h + GBAT[1]) << SHIFT;
-        CONTEXT |= line2 << (SHIFT + 1);
-        CONTEXT |= line1 << kOptConstant9[UNOPT];
-        if (UNOPT == 0) {
-          CONTEXT |= GBREG->GetPixel(w + GBAT[2], h + GBAT[3]) << 10;
-          CONTEXT |= GBREG->GetPixel(w + GBAT[4], h + GBAT[5]) << 11;
-          CONTEXT |= GBREG->GetPixel(w + GBAT[6], h + GBAT[7]) << 15;
-        }
-        bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        if (bVal) {
-          GBREG->SetPixel(w, h, bVal);
-        }
-      }
-      line1 = ((line1 << 1) | GBREG->GetPixel(w + 2 + MOD2, h - 2)) &
-              kOptConstant10[UNOPT];
-      line2 = ((line2 << 1) | GBREG->GetPixel(w + 3 - DIV2, h - 1)) &
-              kOptConstant11[UNOPT];
-      line3 = ((line3 << 1) | bVal) & kOptConstant12[UNOPT];
-    }
-  }
-  return GBREG;
-}
-
 std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Opt3(
     CJBig2_ArithDecoder* pArithDecoder,
     pdfium::span<JBig2ArithCtx> gbContexts) {
@@ -375,7 +457,7 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Opt3(
   });
 }
 
-std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Unopt(
+std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithGeneric(
     CJBig2_ArithDecoder* pArithDecoder,
     pdfium::span<JBig2ArithCtx> gbContexts) {
   auto GBREG = std::make_unique<CJBig2_Image>(GBW, GBH);
@@ -384,6 +466,7 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Unopt(
   }
 
   GBREG->Fill(false);
+  const uint32_t sltp_context = GetGenericTemplate(GBTEMPLATE).sltp_context;
   int LTP = 0;
   for (uint32_t h = 0; h < GBH; h++) {
     if (TPGDON) {
@@ -391,34 +474,14 @@ std::unique_ptr<CJBig2_Image> CJBig2_GRDProc::DecodeArithTemplate3Unopt(
         return nullptr;
       }
 
-      LTP = LTP ^ pArithDecoder->Decode(&gbContexts[0x0195]);
+      LTP = LTP ^ pArithDecoder->Decode(&gbContexts[sltp_context]);
     }
-    if (LTP == 1) {
+    if (LTP) {
       GBREG->CopyLine(h, h - 1);
-    } else {
-      uint32_t line1 = GBREG->GetPixel(1, h - 1);
-      line1 |= GBREG->GetPixel(0, h - 1) << 1;
-      uint32_t line2 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, h)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line2;
-          CONTEXT |= GBREG->GetPixel(w + GBAT[0], h + GBAT[1]) << 4;
-          CONTEXT |= line1 << 5;
-          if (pArithDecoder->IsComplete()) {
-            return nullptr;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          GBREG->SetPixel(w, h, bVal);
-        }
-        line1 = ((line1 << 1) | GBREG->GetPixel(w + 2, h - 1)) & 0x1f;
-        line2 = ((line2 << 1) | bVal) & 0x0f;
-      }
+      continue;
+    }
+    if (!DecodeArithGenericRow(pArithDecoder, gbContexts, GBREG.get(), h)) {
+      return nullptr;
     }
   }
   return GBREG;
@@ -459,22 +522,22 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArith(
     case 0:
       func = UseTemplate0Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithGeneric;
       break;
     case 1:
       func = UseTemplate1Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithGeneric;
       break;
     case 2:
       func = UseTemplate23Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithGeneric;
       break;
     default:
       func = UseTemplate23Opt3()
                  ? &CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Opt3
-                 : &CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Unopt;
+                 : &CJBig2_GRDProc::ProgressiveDecodeArithGeneric;
       break;
   }
   CJBig2_Image* pImage = pState->pImage->get();
@@ -640,66 +703,6 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Opt3(
   });
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate0Unopt(
-    ProgressiveArithDecodeState* pState) {
-  CJBig2_Image* pImage = pState->pImage->get();
-  pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
-  CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
-  for (; loop_index_ < GBH; loop_index_++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return FXCODEC_STATUS::kError;
-      }
-
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x9b25]);
-    }
-    if (ltp_) {
-      pImage->CopyLine(loop_index_, loop_index_ - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(1, loop_index_ - 2);
-      line1 |= pImage->GetPixel(0, loop_index_ - 2) << 1;
-      uint32_t line2 = pImage->GetPixel(2, loop_index_ - 1);
-      line2 |= pImage->GetPixel(1, loop_index_ - 1) << 1;
-      line2 |= pImage->GetPixel(0, loop_index_ - 1) << 2;
-      uint32_t line3 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, loop_index_)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line3;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], loop_index_ + GBAT[1]) << 4;
-          CONTEXT |= line2 << 5;
-          CONTEXT |= pImage->GetPixel(w + GBAT[2], loop_index_ + GBAT[3]) << 10;
-          CONTEXT |= pImage->GetPixel(w + GBAT[4], loop_index_ + GBAT[5]) << 11;
-          CONTEXT |= line1 << 12;
-          CONTEXT |= pImage->GetPixel(w + GBAT[6], loop_index_ + GBAT[7]) << 15;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, loop_index_, bVal);
-        }
-        line1 =
-            ((line1 << 1) | pImage->GetPixel(w + 2, loop_index_ - 2)) & 0x07;
-        line2 =
-            ((line2 << 1) | pImage->GetPixel(w + 3, loop_index_ - 1)) & 0x1f;
-        line3 = ((line3 << 1) | bVal) & 0x0f;
-      }
-    }
-    if (pState->pPause && pState->pPause->NeedToPauseNow()) {
-      loop_index_++;
-      progressive_status_ = FXCODEC_STATUS::kDecodeToBeContinued;
-      return FXCODEC_STATUS::kDecodeToBeContinued;
-    }
-  }
-  progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
-  return FXCODEC_STATUS::kDecodeFinished;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Opt3(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
@@ -810,62 +813,6 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Opt3(
   });
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate1Unopt(
-    ProgressiveArithDecodeState* pState) {
-  CJBig2_Image* pImage = pState->pImage->get();
-  pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
-  CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
-  for (uint32_t h = 0; h < GBH; h++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return FXCODEC_STATUS::kError;
-      }
-
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x0795]);
-    }
-    if (ltp_) {
-      pImage->CopyLine(h, h - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(2, h - 2);
-      line1 |= pImage->GetPixel(1, h - 2) << 1;
-      line1 |= pImage->GetPixel(0, h - 2) << 2;
-      uint32_t line2 = pImage->GetPixel(2, h - 1);
-      line2 |= pImage->GetPixel(1, h - 1) << 1;
-      line2 |= pImage->GetPixel(0, h - 1) << 2;
-      uint32_t line3 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, h)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line3;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], h + GBAT[1]) << 3;
-          CONTEXT |= line2 << 4;
-          CONTEXT |= line1 << 9;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, h, bVal);
-        }
-        line1 = ((line1 << 1) | pImage->GetPixel(w + 3, h - 2)) & 0x0f;
-        line2 = ((line2 << 1) | pImage->GetPixel(w + 3, h - 1)) & 0x1f;
-        line3 = ((line3 << 1) | bVal) & 0x07;
-      }
-    }
-    if (pState->pPause && pState->pPause->NeedToPauseNow()) {
-      loop_index_++;
-      progressive_status_ = FXCODEC_STATUS::kDecodeToBeContinued;
-      return FXCODEC_STATUS::kDecodeToBeContinued;
-    }
-  }
-  progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
-  return FXCODEC_STATUS::kDecodeFinished;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Opt3(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
@@ -976,62 +923,6 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Opt3(
   })
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate2Unopt(
-    ProgressiveArithDecodeState* pState) {
-  CJBig2_Image* pImage = pState->pImage->get();
-  pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
-  CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
-  for (; loop_index_ < GBH; loop_index_++) {
-    if (TPGDON) {
-      if (pArithDecoder->IsComplete()) {
-        return FXCODEC_STATUS::kError;
-      }
-
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x00e5]);
-    }
-    if (ltp_) {
-      pImage->CopyLine(loop_index_, loop_index_ - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(1, loop_index_ - 2);
-      line1 |= pImage->GetPixel(0, loop_index_ - 2) << 1;
-      uint32_t line2 = pImage->GetPixel(1, loop_index_ - 1);
-      line2 |= pImage->GetPixel(0, loop_index_ - 1) << 1;
-      uint32_t line3 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, loop_index_)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line3;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], loop_index_ + GBAT[1]) << 2;
-          CONTEXT |= line2 << 3;
-          CONTEXT |= line1 << 7;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, loop_index_, bVal);
-        }
-        line1 =
-            ((line1 << 1) | pImage->GetPixel(w + 2, loop_index_ - 2)) & 0x07;
-        line2 =
-            ((line2 << 1) | pImage->GetPixel(w + 2, loop_index_ - 1)) & 0x0f;
-        line3 = ((line3 << 1) | bVal) & 0x03;
-      }
-    }
-    if (pState->pPause && pState->pPause->NeedToPauseNow()) {
-      loop_index_++;
-      progressive_status_ = FXCODEC_STATUS::kDecodeToBeContinued;
-      return FXCODEC_STATUS::kDecodeToBeContinued;
-    }
-  }
-  progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
-  return FXCODEC_STATUS::kDecodeFinished;
-}
-
 FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Opt3(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
@@ -1127,46 +1018,25 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Opt3(
   });
 }
 
-FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Unopt(
+FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithGeneric(
     ProgressiveArithDecodeState* pState) {
   CJBig2_Image* pImage = pState->pImage->get();
   pdfium::span<JBig2ArithCtx> gbContexts = pState->gbContexts;
   CJBig2_ArithDecoder* pArithDecoder = pState->pArithDecoder;
+  const uint32_t sltp_context = GetGenericTemplate(GBTEMPLATE).sltp_context;
   for (; loop_index_ < GBH; loop_index_++) {
     if (TPGDON) {
       if (pArithDecoder->IsComplete()) {
         return FXCODEC_STATUS::kError;
       }
 
-      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[0x0195]);
+      ltp_ = ltp_ ^ pArithDecoder->Decode(&gbContexts[sltp_context]);
     }
     if (ltp_) {
       pImage->CopyLine(loop_index_, loop_index_ - 1);
-    } else {
-      uint32_t line1 = pImage->GetPixel(1, loop_index_ - 1);
-      line1 |= pImage->GetPixel(0, loop_index_ - 1) << 1;
-      uint32_t line2 = 0;
-      for (uint32_t w = 0; w < GBW; w++) {
-        int bVal;
-        if (USESKIP && SKIP->GetPixel(w, loop_index_)) {
-          bVal = 0;
-        } else {
-          uint32_t CONTEXT = line2;
-          CONTEXT |= pImage->GetPixel(w + GBAT[0], loop_index_ + GBAT[1]) << 4;
-          CONTEXT |= line1 << 5;
-          if (pArithDecoder->IsComplete()) {
-            return FXCODEC_STATUS::kError;
-          }
-
-          bVal = pArithDecoder->Decode(&gbContexts[CONTEXT]);
-        }
-        if (bVal) {
-          pImage->SetPixel(w, loop_index_, bVal);
-        }
-        line1 =
-            ((line1 << 1) | pImage->GetPixel(w + 2, loop_index_ - 1)) & 0x1f;
-        line2 = ((line2 << 1) | bVal) & 0x0f;
-      }
+    } else if (!DecodeArithGenericRow(pArithDecoder, gbContexts, pImage,
+                                      loop_index_)) {
+      return FXCODEC_STATUS::kError;
     }
     if (pState->pPause && pState->pPause->NeedToPauseNow()) {
       loop_index_++;
@@ -1177,3 +1047,4 @@ FXCODEC_STATUS CJBig2_GRDProc::ProgressiveDecodeArithTemplate3Unopt(
   progressive_status_ = FXCODEC_STATUS::kDecodeFinished;
   return FXCODEC_STATUS::kDecodeFinished;
 }
+
@@ -64,36 +64,33 @@ class CJBig2_GRDProc {
   bool UseTemplate1Opt3() const;
   bool UseTemplate23Opt3() const;
 
+  // Decodes row `h` of `pImage` for any template and adaptive template
+  // pixels. Returns false when the data runs out.
+  bool DecodeArithGenericRow(CJBig2_ArithDecoder* pArithDecoder,
+                             pdfium::span<JBig2ArithCtx> gbContexts,
+                             CJBig2_Image* pImage,
+                             uint32_t h) const;
+
   FXCODEC_STATUS ProgressiveDecodeArith(ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate0Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate0Unopt(
-      ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate1Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate1Unopt(
-      ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate2Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate2Unopt(
-      ProgressiveArithDecodeState* pState);
   FXCODEC_STATUS ProgressiveDecodeArithTemplate3Opt3(
       ProgressiveArithDecodeState* pState);
-  FXCODEC_STATUS ProgressiveDecodeArithTemplate3Unopt(
+  FXCODEC_STATUS ProgressiveDecodeArithGeneric(
       ProgressiveArithDecodeState* pState);
 
   std::unique_ptr<CJBig2_Image> DecodeArithOpt3(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts,
       int OPT);
-  std::unique_ptr<CJBig2_Image> DecodeArithTemplateUnopt(
-      CJBig2_ArithDecoder* pArithDecoder,
-      pdfium::span<JBig2ArithCtx> gbContexts,
-      int UNOPT);
   std::unique_ptr<CJBig2_Image> DecodeArithTemplate3Opt3(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts);
-  std::unique_ptr<CJBig2_Image> DecodeArithTemplate3Unopt(
+  std::unique_ptr<CJBig2_Image> DecodeArithGeneric(
       CJBig2_ArithDecoder* pArithDecoder,
       pdfium::span<JBig2ArithCtx> gbContexts);
 
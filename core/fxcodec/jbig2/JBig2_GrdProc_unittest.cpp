@@ -0,0 +1,512 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/jbig2/JBig2_GrdProc.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
+#include "core/fxcodec/jbig2/JBig2_BitStream.h"
+#include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcrt/pauseindicator_iface.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr uint32_t kWidth = 101;
+constexpr uint32_t kHeight = 40;
+
+// The nominal adaptive template pixels of each template.
+constexpr std::array<int8_t, 8> kNominalAt[] = {
+    {3, -1, -3, -1, 2, -2, -2, -2},
+    {3, -1, 0, 0, 0, 0, 0, 0},
+    {2, -1, 0, 0, 0, 0, 0, 0},
+    {2, -1, 0, 0, 0, 0, 0, 0},
+};
+
+// Adaptive template pixels that the optimized decoders do not handle. Some
+// are on the current row, and some are further away than a byte.
+constexpr std::array<int8_t, 8> kOtherAt[] = {
+    {-1, 0, -9, -1, 7, -4, -16, -8},
+    {-7, -3, 0, 0, 0, 0, 0, 0},
+    {5, -2, 0, 0, 0, 0, 0, 0},
+    {-5, 0, 0, 0, 0, 0, 0, 0},
+};
+
+class AlwaysPause final : public PauseIndicatorIface {
+ public:
+  bool NeedToPauseNow() override { return true; }
+};
+
+// Any data decodes to some image, so arbitrary bytes will do.
+std::vector<uint8_t> MakeData(uint32_t seed = 1, size_t size = 4096) {
+  std::vector<uint8_t> data(size);
+  for (uint8_t& byte : data) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+  return data;
+}
+
+size_t GetContextSize(uint8_t gbtemplate) {
+  return gbtemplate == 0 ? 65536 : gbtemplate == 1 ? 8192 : 1024;
+}
+
+std::unique_ptr<CJBig2_GRDProc> MakeProc(uint8_t gbtemplate,
+                                         bool tpgdon,
+                                         const std::array<int8_t, 8>& gbat) {
+  auto proc = std::make_unique<CJBig2_GRDProc>();
+  proc->MMR = false;
+  proc->TPGDON = tpgdon;
+  proc->USESKIP = false;
+  proc->GBTEMPLATE = gbtemplate;
+  proc->GBW = kWidth;
+  proc->GBH = kHeight;
+  proc->GBAT = gbat;
+  return proc;
+}
+
+std::unique_ptr<CJBig2_GRDProc> MakeProc(uint8_t gbtemplate, bool tpgdon) {
+  return MakeProc(gbtemplate, tpgdon, kNominalAt[gbtemplate]);
+}
+
+std::unique_ptr<CJBig2_Image> Decode(CJBig2_GRDProc* proc,
+                                     pdfium::span<const uint8_t> data) {
+  CJBig2_BitStream stream(data, 0);
+  CJBig2_ArithDecoder arith_decoder(&stream);
+  std::vector<JBig2ArithCtx> contexts(GetContextSize(proc->GBTEMPLATE));
+  return proc->DecodeArith(&arith_decoder, contexts);
+}
+
+std::unique_ptr<CJBig2_Image> Decode(CJBig2_GRDProc* proc) {
+  return Decode(proc, MakeData());
+}
+
+std::unique_ptr<CJBig2_Image> DecodeProgressive(
+    CJBig2_GRDProc* proc,
+    pdfium::span<const uint8_t> data,
+    PauseIndicatorIface* pause) {
+  CJBig2_BitStream stream(data, 0);
+  CJBig2_ArithDecoder arith_decoder(&stream);
+  std::vector<JBig2ArithCtx> contexts(GetContextSize(proc->GBTEMPLATE));
+  std::unique_ptr<CJBig2_Image> image;
+  CJBig2_GRDProc::ProgressiveArithDecodeState state;
+  state.pImage = &image;
+  state.pArithDecoder = &arith_decoder;
+  state.gbContexts = contexts;
+  state.pPause = pause;
+  FXCODEC_STATUS status = proc->StartDecodeArith(&state);
+  while (status == FXCODEC_STATUS::kDecodeToBeContinued) {
+    status = proc->ContinueDecode(&state);
+  }
+  return status == FXCODEC_STATUS::kDecodeFinished ? std::move(image)
+                                                   : nullptr;
+}
+
+std::unique_ptr<CJBig2_Image> DecodeProgressive(CJBig2_GRDProc* proc) {
+  return DecodeProgressive(proc, MakeData(), nullptr);
+}
+
+// The arithmetic decoder of Annex E.3 of the JBIG2 specification, one bit
+// per renormalization step. This is the decoder from before it was sped up.
+class ReferenceArithDecoder {
+ public:
+  struct Context {
+    uint8_t index = 0;
+    bool mps = false;
+  };
+
+  explicit ReferenceArithDecoder(CJBig2_BitStream* stream) : stream_(stream) {
+    b_ = stream_->getCurByte_arith();
+    c_ = (b_ ^ 0xff) << 16;
+    ByteIn();
+    c_ <<= 7;
+    ct_ -= 7;
+    a_ = 0x8000;
+  }
+
+  bool IsComplete() const { return complete_; }
+
+  int Decode(Context& cx) {
+    const QeEntry& qe = kQeTable[cx.index];
+    a_ -= qe.qe;
+    int d;
+    if ((c_ >> 16) < a_) {
+      if (a_ & 0x8000) {
+        return cx.mps;
+      }
+      d = a_ < qe.qe ? DecodeLps(cx, qe) : DecodeMps(cx, qe);
+    } else {
+      c_ -= a_ << 16;
+      d = a_ < qe.qe ? DecodeMps(cx, qe) : DecodeLps(cx, qe);
+      a_ = qe.qe;
+    }
+    do {
+      if (ct_ == 0) {
+        ByteIn();
+      }
+      a_ <<= 1;
+      c_ <<= 1;
+      --ct_;
+    } while ((a_ & 0x8000) == 0);
+    return d;
+  }
+
+ private:
+  struct QeEntry {
+    uint16_t qe;
+    uint8_t nmps;
+    uint8_t nlps;
+    bool switch_mps;
+  };
+
+  // Table E.1.
+  static constexpr QeEntry kQeTable[] = {
+      {0x5601, 1, 1, true},    {0x3401, 2, 6, false},   {0x1801, 3, 9, false},
+      {0x0AC1, 4, 12, false},  {0x0521, 5, 29, false},  {0x0221, 38, 33, false},
+      {0x5601, 7, 6, true},    {0x5401, 8, 14, false},  {0x4801, 9, 14, false},
+      {0x3801, 10, 14, false}, {0x3001, 11, 17, false}, {0x2401, 12, 18, false},
+      {0x1C01, 13, 20, false}, {0x1601, 29, 21, false}, {0x5601, 15, 14, true},
+      {0x5401, 16, 14, false}, {0x5101, 17, 15, false}, {0x4801, 18, 16, false},
+      {0x3801, 19, 17, false}, {0x3401, 20, 18, false}, {0x3001, 21, 19, false},
+      {0x2801, 22, 19, false}, {0x2401, 23, 20, false}, {0x2201, 24, 21, false},
+      {0x1C01, 25, 22, false}, {0x1801, 26, 23, false}, {0x1601, 27, 24, false},
+      {0x1401, 28, 25, false}, {0x1201, 29, 26, false}, {0x1101, 30, 27, false},
+      {0x0AC1, 31, 28, false}, {0x09C1, 32, 29, false}, {0x08A1, 33, 30, false},
+      {0x0521, 34, 31, false}, {0x0441, 35, 32, false}, {0x02A1, 36, 33, false},
+      {0x0221, 37, 34, false}, {0x0141, 38, 35, false}, {0x0111, 39, 36, false},
+      {0x0085, 40, 37, false}, {0x0049, 41, 38, false}, {0x0025, 42, 39, false},
+      {0x0015, 43, 40, false}, {0x0009, 44, 41, false}, {0x0005, 45, 42, false},
+      {0x0001, 45, 43, false}, {0x5601, 46, 46, false}};
+
+  static int DecodeMps(Context& cx, const QeEntry& qe) {
+    cx.index = qe.nmps;
+    return cx.mps;
+  }
+
+  static int DecodeLps(Context& cx, const QeEntry& qe) {
+    const int d = !cx.mps;
+    if (qe.switch_mps) {
+      cx.mps = !cx.mps;
+    }
+    cx.index = qe.nlps;
+    return d;
+  }
+
+  void ByteIn() {
+    if (b_ == 0xff) {
+      const uint8_t b1 = stream_->getNextByte_arith();
+      if (b1 > 0x8f) {
+        ct_ = 8;
+      } else {
+        stream_->incByteIdx();
+        b_ = b1;
+        c_ = c_ + 0xfe00 - (b_ << 9);
+        ct_ = 7;
+      }
+    } else {
+      stream_->incByteIdx();
+      b_ = stream_->getCurByte_arith();
+      c_ = c_ + 0xff00 - (b_ << 8);
+      ct_ = 8;
+    }
+    if (!stream_->IsInBounds()) {
+      complete_ = true;
+    }
+  }
+
+  CJBig2_BitStream* const stream_;
+  bool complete_ = false;
+  uint8_t b_;
+  uint32_t c_;
+  uint32_t a_;
+  uint32_t ct_ = 0;
+};
+
+// Decodes a generic region one pixel at a time, forming each context from
+// the pixels of Figures 3 to 6 of the JBIG2 specification, in the bit order
+// the decoder has always used. `at` marks the adaptive template pixels.
+std::unique_ptr<CJBig2_Image> ReferenceDecode(
+    uint8_t gbtemplate,
+    bool tpgdon,
+    const std::array<int8_t, 8>& gbat,
+    const CJBig2_Image* skip,
+    pdfium::span<const uint8_t> data) {
+  struct TemplatePixel {
+    int x;
+    int y;
+    int at;  // The adaptive template pixel to use, or -1.
+  };
+  static const std::vector<TemplatePixel> kTemplates[] = {
+      {{-1, 0, -1},
+       {-2, 0, -1},
+       {-3, 0, -1},
+       {-4, 0, -1},
+       {0, 0, 0},
+       {2, -1, -1},
+       {1, -1, -1},
+       {0, -1, -1},
+       {-1, -1, -1},
+       {-2, -1, -1},
+       {0, 0, 1},
+       {0, 0, 2},
+       {1, -2, -1},
+       {0, -2, -1},
+       {-1, -2, -1},
+       {0, 0, 3}},
+      {{-1, 0, -1},
+       {-2, 0, -1},
+       {-3, 0, -1},
+       {0, 0, 0},
+       {2, -1, -1},
+       {1, -1, -1},
+       {0, -1, -1},
+       {-1, -1, -1},
+       {-2, -1, -1},
+       {2, -2, -1},
+       {1, -2, -1},
+       {0, -2, -1},
+       {-1, -2, -1}},
+      {{-1, 0, -1},
+       {-2, 0, -1},
+       {0, 0, 0},
+       {1, -1, -1},
+       {0, -1, -1},
+       {-1, -1, -1},
+       {-2, -1, -1},
+       {1, -2, -1},
+       {0, -2, -1},
+       {-1, -2, -1}},
+      {{-1, 0, -1},
+       {-2, 0, -1},
+       {-3, 0, -1},
+       {-4, 0, -1},
+       {0, 0, 0},
+       {1, -1, -1},
+       {0, -1, -1},
+       {-1, -1, -1},
+       {-2, -1, -1},
+       {-3, -1, -1}},
+  };
+  // The contexts of the typical prediction bit, SLTP.
+  static constexpr uint32_t kTypicalContexts[] = {0x9b25, 0x0795, 0x00e5,
+                                                  0x0195};
+
+  CJBig2_BitStream stream(data, 0);
+  ReferenceArithDecoder decoder(&stream);
+  std::vector<ReferenceArithDecoder::Context> contexts(
+      GetContextSize(gbtemplate));
+  auto image = std::make_unique<CJBig2_Image>(kWidth, kHeight);
+  image->Fill(false);
+  bool typical = false;
+  for (int32_t y = 0; y < static_cast<int32_t>(kHeight); ++y) {
+    if (tpgdon) {
+      if (decoder.IsComplete()) {
+        return nullptr;
+      }
+      typical ^= decoder.Decode(contexts[kTypicalContexts[gbtemplate]]);
+      if (typical) {
+        for (int32_t x = 0; x < static_cast<int32_t>(kWidth); ++x) {
+          image->SetPixel(x, y, image->GetPixel(x, y - 1));
+        }
+        continue;
+      }
+    }
+    for (int32_t x = 0; x < static_cast<int32_t>(kWidth); ++x) {
+      if (skip && skip->GetPixel(x, y)) {
+        continue;
+      }
+      uint32_t context = 0;
+      const std::vector<TemplatePixel>& pixels = kTemplates[gbtemplate];
+      for (size_t bit = 0; bit < pixels.size(); ++bit) {
+        const TemplatePixel& pixel = pixels[bit];
+        const int dx = pixel.at < 0 ? pixel.x : gbat[2 * pixel.at];
+        const int dy = pixel.at < 0 ? pixel.y : gbat[2 * pixel.at + 1];
+        context |= image->GetPixel(x + dx, y + dy) << bit;
+      }
+      if (decoder.IsComplete()) {
+        return nullptr;
+      }
+      image->SetPixel(x, y, decoder.Decode(contexts[context]));
+    }
+  }
+  return image;
+}
+
+// Skips a scattered set of pixels, with some whole rows and some runs.
+std::unique_ptr<CJBig2_Image> MakeSkip() {
+  auto skip = std::make_unique<CJBig2_Image>(kWidth, kHeight);
+  skip->Fill(false);
+  uint32_t seed = 7;
+  for (int32_t y = 0; y < static_cast<int32_t>(kHeight); ++y) {
+    for (int32_t x = 0; x < static_cast<int32_t>(kWidth); ++x) {
+      seed = seed * 1103515245 + 12345;
+      skip->SetPixel(x, y, y % 13 == 5 || (seed >> 16) % 5 == 0);
+    }
+  }
+  return skip;
+}
+
+void ExpectImagesEqual(const CJBig2_Image* expected,
+                       const CJBig2_Image* actual) {
+  ASSERT_TRUE(expected);
+  ASSERT_TRUE(actual);
+  ASSERT_EQ(expected->width(), actual->width());
+  ASSERT_EQ(expected->height(), actual->height());
+  for (int32_t y = 0; y < expected->height(); ++y) {
+    for (int32_t x = 0; x < expected->width(); ++x) {
+      EXPECT_EQ(expected->GetPixel(x, y), actual->GetPixel(x, y))
+          << " at " << x << " " << y;
+    }
+  }
+}
+
+}  // namespace
+
+// With a SKIP image that skips nothing, decoding goes through the code for
+// any template, which has to give the same image as the code specialized for
+// the nominal adaptive template pixels.
+TEST(JBig2GrdProcTest, GenericDecodingMatchesOptimized) {
+  CJBig2_Image skip(kWidth, kHeight);
+  skip.Fill(false);
+  for (uint8_t gbtemplate = 0; gbtemplate < 4; ++gbtemplate) {
+    for (bool tpgdon : {false, true}) {
+      SCOPED_TRACE(testing::Message()
+                   << "template " << static_cast<int>(gbtemplate)
+                   << " tpgdon " << tpgdon);
+      std::unique_ptr<CJBig2_GRDProc> optimized =
+          MakeProc(gbtemplate, tpgdon);
+      std::unique_ptr<CJBig2_Image> expected = Decode(optimized.get());
+
+      std::unique_ptr<CJBig2_GRDProc> generic = MakeProc(gbtemplate, tpgdon);
+      generic->USESKIP = true;
+      generic->SKIP = &skip;
+      ExpectImagesEqual(expected.get(), Decode(generic.get()).get());
+
+      std::unique_ptr<CJBig2_GRDProc> progressive =
+          MakeProc(gbtemplate, tpgdon);
+      progressive->USESKIP = true;
+      progressive->SKIP = &skip;
+      ExpectImagesEqual(expected.get(),
+                        DecodeProgressive(progressive.get()).get());
+    }
+  }
+}
+
+// Every template, with and without TPGDON, SKIP, and the nominal adaptive
+// template pixels, decodes to the same image as the reference decoder, both
+// at once and progressively with a pause after every row.
+TEST(JBig2GrdProcTest, DecodingMatchesReference) {
+  std::unique_ptr<CJBig2_Image> skip = MakeSkip();
+  AlwaysPause pause;
+  for (uint32_t seed : {1, 2, 3}) {
+    const std::vector<uint8_t> data = MakeData(seed);
+    for (uint8_t gbtemplate = 0; gbtemplate < 4; ++gbtemplate) {
+      for (bool tpgdon : {false, true}) {
+        for (bool nominal_at : {true, false}) {
+          for (bool use_skip : {false, true}) {
+            SCOPED_TRACE(testing::Message()
+                         << "seed " << seed << " template "
+                         << static_cast<int>(gbtemplate) << " tpgdon "
+                         << tpgdon << " nominal_at " << nominal_at
+                         << " skip " << use_skip);
+            const std::array<int8_t, 8>& gbat =
+                nominal_at ? kNominalAt[gbtemplate] : kOtherAt[gbtemplate];
+            std::unique_ptr<CJBig2_Image> expected =
+                ReferenceDecode(gbtemplate, tpgdon, gbat,
+                                use_skip ? skip.get() : nullptr, data);
+
+            std::unique_ptr<CJBig2_GRDProc> proc =
+                MakeProc(gbtemplate, tpgdon, gbat);
+            proc->USESKIP = use_skip;
+            proc->SKIP = skip.get();
+            ExpectImagesEqual(expected.get(), Decode(proc.get(), data).get());
+
+            std::unique_ptr<CJBig2_GRDProc> progressive =
+                MakeProc(gbtemplate, tpgdon, gbat);
+            progressive->USESKIP = use_skip;
+            progressive->SKIP = skip.get();
+            ExpectImagesEqual(
+                expected.get(),
+                DecodeProgressive(progressive.get(), data, &pause).get());
+          }
+        }
+      }
+    }
+  }
+}
+
+// Data that runs out before the region does fails to decode, like it does in
+// the reference decoder.
+TEST(JBig2GrdProcTest, TruncatedDataMatchesReference) {
+  for (size_t size : {0, 1, 16, 64}) {
+    const std::vector<uint8_t> data = MakeData(1, size);
+    for (uint8_t gbtemplate = 0; gbtemplate < 4; ++gbtemplate) {
+      SCOPED_TRACE(testing::Message() << "size " << size << " template "
+                                      << static_cast<int>(gbtemplate));
+      EXPECT_FALSE(ReferenceDecode(gbtemplate, true, kNominalAt[gbtemplate],
+                                   nullptr, data));
+      std::unique_ptr<CJBig2_GRDProc> proc = MakeProc(gbtemplate, true);
+      EXPECT_FALSE(Decode(proc.get(), data));
+      std::unique_ptr<CJBig2_GRDProc> progressive = MakeProc(gbtemplate, true);
+      EXPECT_FALSE(DecodeProgressive(progressive.get(), data, nullptr));
+    }
+  }
+}
+
+// The arithmetic decoder gives the same bits as the reference decoder for
+// any sequence of contexts, so the text and refinement region decoders that
+// share it also decode as before.
+TEST(JBig2GrdProcTest, ArithDecoderMatchesReference) {
+  constexpr size_t kContexts = 64;
+  for (uint32_t seed : {1, 2, 3, 4}) {
+    SCOPED_TRACE(seed);
+    // Runs of 0xff test the marker handling of BYTEIN.
+    std::vector<uint8_t> data = MakeData(seed, 1024);
+    for (size_t i = 100; i < 140; ++i) {
+      data[i] = 0xff;
+    }
+    data[300] = 0xff;
+    data[301] = 0x7f;
+    CJBig2_BitStream stream(data, 0);
+    CJBig2_ArithDecoder decoder(&stream);
+    CJBig2_BitStream reference_stream(data, 0);
+    ReferenceArithDecoder reference(&reference_stream);
+    std::vector<JBig2ArithCtx> contexts(kContexts);
+    std::vector<ReferenceArithDecoder::Context> reference_contexts(kContexts);
+    uint32_t choice = seed;
+    for (int i = 0; i < 20000; ++i) {
+      choice = choice * 1103515245 + 12345;
+      // Favor a few contexts so some of them reach the small probabilities.
+      const size_t cx = (choice >> 16) % 8 == 0 ? (choice >> 20) % kContexts
+                                                 : (choice >> 20) % 4;
+      ASSERT_EQ(reference.Decode(reference_contexts[cx]),
+                decoder.Decode(&contexts[cx]))
+          << " at " << i;
+      EXPECT_EQ(reference_contexts[cx].index, contexts[cx].I());
+      EXPECT_EQ(reference_contexts[cx].mps, contexts[cx].MPS() != 0);
+    }
+  }
+}
+
+// Pixels set in SKIP decode as 0 without using any data.
+TEST(JBig2GrdProcTest, GenericDecodingSkipsPixels) {
+  CJBig2_Image skip(kWidth, kHeight);
+  skip.Fill(true);
+  std::unique_ptr<CJBig2_GRDProc> proc = MakeProc(0, false);
+  proc->USESKIP = true;
+  proc->SKIP = &skip;
+  std::unique_ptr<CJBig2_Image> image = Decode(proc.get());
+  ASSERT_TRUE(image);
+  for (int32_t y = 0; y < image->height(); ++y) {
+    for (int32_t x = 0; x < image->width(); ++x) {
+      EXPECT_FALSE(image->GetPixel(x, y)) << " at " << x << " " << y;
+    }
+  }
+}
@@ -8,16 +8,14 @@
 
 #include "core/fxcodec/jbig2/JBig2_Image.h"
 
-CJBig2_SymbolDict::CJBig2_SymbolDict() = default;
+CJBig2_SymbolDict::CJBig2_SymbolDict()
+    : sdexsyms_(std::make_shared<Images>()) {}
 
 CJBig2_SymbolDict::~CJBig2_SymbolDict() = default;
 
-std::unique_ptr<CJBig2_SymbolDict> CJBig2_SymbolDict::DeepCopy() const {
+std::unique_ptr<CJBig2_SymbolDict> CJBig2_SymbolDict::ShallowCopy() const {
   auto dst = std::make_unique<CJBig2_SymbolDict>();
-  for (const auto& image : sdexsyms_) {
-    dst->sdexsyms_.push_back(image ? std::make_unique<CJBig2_Image>(*image)
-                                   : nullptr);
-  }
+  dst->sdexsyms_ = sdexsyms_;
   dst->gb_contexts_ = gb_contexts_;
   dst->gr_contexts_ = gr_contexts_;
   return dst;
@@ -13,20 +13,27 @@
 
 #include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
 #include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcrt/check.h"
 
 class CJBig2_SymbolDict {
  public:
   CJBig2_SymbolDict();
   ~CJBig2_SymbolDict();
 
-  std::unique_ptr<CJBig2_SymbolDict> DeepCopy() const;
+  // Shares the images, which never change once the dictionary is decoded,
+  // and copies the contexts, which the copy may get new ones for. The copies
+  // may go away on different threads.
+  std::unique_ptr<CJBig2_SymbolDict> ShallowCopy() const;
 
   void AddImage(std::unique_ptr<CJBig2_Image> image) {
-    sdexsyms_.push_back(std::move(image));
+    CHECK(sdexsyms_.use_count() == 1);
+    sdexsyms_->push_back(std::move(image));
   }
 
-  size_t NumImages() const { return sdexsyms_.size(); }
-  CJBig2_Image* GetImage(size_t index) const { return sdexsyms_[index].get(); }
+  size_t NumImages() const { return sdexsyms_->size(); }
+  CJBig2_Image* GetImage(size_t index) const {
+    return (*sdexsyms_)[index].get();
+  }
 
   const std::vector<JBig2ArithCtx>& GbContexts() const { return gb_contexts_; }
   const std::vector<JBig2ArithCtx>& GrContexts() const { return gr_contexts_; }
@@ -39,9 +46,12 @@ class CJBig2_SymbolDict {
   }
 
  private:
+  using Images = std::vector<std::unique_ptr<CJBig2_Image>>;
+
   std::vector<JBig2ArithCtx> gb_contexts_;
   std::vector<JBig2ArithCtx> gr_contexts_;
-  std::vector<std::unique_ptr<CJBig2_Image>> sdexsyms_;
+  // Unlike RetainPtr, std::shared_ptr counts references atomically.
+  std::shared_ptr<Images> sdexsyms_;
 };
 
 #endif  // CORE_FXCODEC_JBIG2_JBIG2_SYMBOLDICT_H_
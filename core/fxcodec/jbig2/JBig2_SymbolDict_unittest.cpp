@@ -0,0 +1,47 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcodec/jbig2/JBig2_SymbolDict.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(JBig2SymbolDictTest, ShallowCopy) {
+  CJBig2_SymbolDict dict;
+  dict.AddImage(std::make_unique<CJBig2_Image>(8, 8));
+  dict.SetGbContexts(std::vector<JBig2ArithCtx>(4));
+
+  std::unique_ptr<CJBig2_SymbolDict> copy = dict.ShallowCopy();
+  ASSERT_EQ(1u, copy->NumImages());
+  EXPECT_EQ(dict.GetImage(0), copy->GetImage(0));
+  EXPECT_EQ(4u, copy->GbContexts().size());
+
+  // Contexts are the copy's own.
+  copy->SetGbContexts(std::vector<JBig2ArithCtx>(2));
+  EXPECT_EQ(4u, dict.GbContexts().size());
+}
+
+TEST(JBig2SymbolDictTest, CopiesGoAwayOnSeveralThreads) {
+  auto dict = std::make_unique<CJBig2_SymbolDict>();
+  dict->AddImage(std::make_unique<CJBig2_Image>(8, 8));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([copy = dict->ShallowCopy()]() mutable {
+      for (int j = 0; j < 1000; ++j) {
+        std::unique_ptr<CJBig2_SymbolDict> other = copy->ShallowCopy();
+        EXPECT_EQ(1u, other->NumImages());
+      }
+      copy.reset();
+    });
+  }
+  dict.reset();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
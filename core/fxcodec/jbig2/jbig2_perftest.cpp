@@ -0,0 +1,452 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "core/fxcodec/jbig2/JBig2_ArithDecoder.h"
+#include "core/fxcodec/jbig2/JBig2_BitStream.h"
+#include "core/fxcodec/jbig2/JBig2_GrdProc.h"
+#include "core/fxcodec/jbig2/JBig2_Image.h"
+#include "core/fxcodec/jbig2/JBig2_TrdProc.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_test_helpers.h"
+
+namespace {
+
+// An A4 page at 300 dpi.
+constexpr int32_t kPageWidth = 2480;
+constexpr int32_t kPageHeight = 3508;
+constexpr int32_t kMargin = 150;
+constexpr int32_t kLineHeight = 40;
+constexpr uint8_t kSymbolCodeLength = 6;
+constexpr uint32_t kSymbolCount = 1 << kSymbolCodeLength;
+constexpr int kRuns = 5;
+
+// The nominal adaptive template pixels of generic template 0, and ones that
+// the optimized decoders do not handle.
+constexpr std::array<int8_t, 8> kNominalAt = {3, -1, -3, -1, 2, -2, -2, -2};
+constexpr std::array<int8_t, 8> kOtherAt = {4, -1, -4, -1, 3, -2, -3, -2};
+
+// The JBIG2 arithmetic encoder, from Annex E.2 of the JBIG2 specification,
+// to make test data with.
+class ArithEncoder {
+ public:
+  struct Context {
+    uint8_t index = 0;
+    bool mps = false;
+  };
+
+  ArithEncoder() : bytes_(1) {}
+
+  void Encode(Context& cx, bool bit) {
+    const QeEntry& qe = kQeTable[cx.index];
+    a_ -= qe.qe;
+    if (bit == cx.mps) {
+      if (a_ & 0x8000) {
+        c_ += qe.qe;
+        return;
+      }
+      if (a_ < qe.qe) {
+        a_ = qe.qe;
+      } else {
+        c_ += qe.qe;
+      }
+      cx.index = qe.nmps;
+    } else {
+      if (a_ < qe.qe) {
+        c_ += qe.qe;
+      } else {
+        a_ = qe.qe;
+      }
+      if (qe.switch_mps) {
+        cx.mps = !cx.mps;
+      }
+      cx.index = qe.nlps;
+    }
+    do {
+      a_ <<= 1;
+      c_ <<= 1;
+      if (--ct_ == 0) {
+        ByteOut();
+      }
+    } while (!(a_ & 0x8000));
+  }
+
+  // Returns the encoded data, with the end marker.
+  std::vector<uint8_t> Finish() {
+    const uint32_t temp = c_ + a_;
+    c_ |= 0xffff;
+    if (c_ >= temp) {
+      c_ -= 0x8000;
+    }
+    c_ <<= ct_;
+    ByteOut();
+    c_ <<= ct_;
+    ByteOut();
+    if (bytes_.back() != 0xff) {
+      bytes_.push_back(0xff);
+    }
+    bytes_.push_back(0xac);
+    // The first byte only ever takes the carry of the ones after it.
+    return std::vector<uint8_t>(bytes_.begin() + 1, bytes_.end());
+  }
+
+ private:
+  struct QeEntry {
+    uint16_t qe;
+    uint8_t nmps;
+    uint8_t nlps;
+    bool switch_mps;
+  };
+
+  // Table E.1.
+  static constexpr QeEntry kQeTable[] = {
+      {0x5601, 1, 1, true},    {0x3401, 2, 6, false},   {0x1801, 3, 9, false},
+      {0x0AC1, 4, 12, false},  {0x0521, 5, 29, false},  {0x0221, 38, 33, false},
+      {0x5601, 7, 6, true},    {0x5401, 8, 14, false},  {0x4801, 9, 14, false},
+      {0x3801, 10, 14, false}, {0x3001, 11, 17, false}, {0x2401, 12, 18, false},
+      {0x1C01, 13, 20, false}, {0x1601, 29, 21, false}, {0x5601, 15, 14, true},
+      {0x5401, 16, 14, false}, {0x5101, 17, 15, false}, {0x4801, 18, 16, false},
+      {0x3801, 19, 17, false}, {0x3401, 20, 18, false}, {0x3001, 21, 19, false},
+      {0x2801, 22, 19, false}, {0x2401, 23, 20, false}, {0x2201, 24, 21, false},
+      {0x1C01, 25, 22, false}, {0x1801, 26, 23, false}, {0x1601, 27, 24, false},
+      {0x1401, 28, 25, false}, {0x1201, 29, 26, false}, {0x1101, 30, 27, false},
+      {0x0AC1, 31, 28, false}, {0x09C1, 32, 29, false}, {0x08A1, 33, 30, false},
+      {0x0521, 34, 31, false}, {0x0441, 35, 32, false}, {0x02A1, 36, 33, false},
+      {0x0221, 37, 34, false}, {0x0141, 38, 35, false}, {0x0111, 39, 36, false},
+      {0x0085, 40, 37, false}, {0x0049, 41, 38, false}, {0x0025, 42, 39, false},
+      {0x0015, 43, 40, false}, {0x0009, 44, 41, false}, {0x0005, 45, 42, false},
+      {0x0001, 45, 43, false}, {0x5601, 46, 46, false}};
+
+  void ByteOut() {
+    if (bytes_.back() == 0xff) {
+      PutByte(20);
+      return;
+    }
+    if (c_ >= 0x8000000) {
+      ++bytes_.back();
+      if (bytes_.back() == 0xff) {
+        c_ &= 0x7ffffff;
+        PutByte(20);
+        return;
+      }
+    }
+    PutByte(19);
+  }
+
+  void PutByte(int shift) {
+    bytes_.push_back(static_cast<uint8_t>(c_ >> shift));
+    c_ &= (1 << shift) - 1;
+    ct_ = shift == 20 ? 7 : 8;
+  }
+
+  std::vector<uint8_t> bytes_;
+  uint32_t a_ = 0x8000;
+  uint32_t c_ = 0;
+  int ct_ = 12;
+};
+
+// Encodes integers the way CJBig2_ArithIntDecoder decodes them, per Annex A.
+class IntEncoder {
+ public:
+  IntEncoder() : contexts_(512) {}
+
+  void Encode(ArithEncoder& encoder, int32_t value) {
+    EncodeParts(encoder, value < 0, value < 0 ? -value : value);
+  }
+  void EncodeOob(ArithEncoder& encoder) { EncodeParts(encoder, true, 0); }
+
+ private:
+  void EncodeParts(ArithEncoder& encoder, bool negative, uint32_t magnitude) {
+    static constexpr struct {
+      int bits;
+      uint32_t base;
+    } kRanges[] = {{2, 0}, {4, 4}, {6, 20}, {8, 84}, {12, 340}, {32, 4436}};
+    size_t range = 0;
+    while (range + 1 < std::size(kRanges) &&
+           magnitude >= kRanges[range + 1].base) {
+      ++range;
+    }
+    uint32_t prev = 1;
+    auto encode = [&](bool bit) {
+      encoder.Encode(contexts_[prev], bit);
+      prev = (prev << 1) | bit;
+      if (prev >= 256) {
+        prev = (prev & 511) | 256;
+      }
+    };
+    encode(negative);
+    for (size_t i = 0; i < range; ++i) {
+      encode(true);
+    }
+    if (range + 1 < std::size(kRanges)) {
+      encode(false);
+    }
+    const uint32_t offset = magnitude - kRanges[range].base;
+    for (int i = kRanges[range].bits - 1; i >= 0; --i) {
+      encode((offset >> i) & 1);
+    }
+  }
+
+  std::vector<ArithEncoder::Context> contexts_;
+};
+
+// Encodes symbol IDs the way CJBig2_ArithIaidDecoder decodes them.
+class IaidEncoder {
+ public:
+  IaidEncoder() : contexts_(kSymbolCount) {}
+
+  void Encode(ArithEncoder& encoder, uint32_t id) {
+    uint32_t prev = 1;
+    for (int i = kSymbolCodeLength - 1; i >= 0; --i) {
+      const bool bit = (id >> i) & 1;
+      encoder.Encode(contexts_[prev], bit);
+      prev = (prev << 1) | bit;
+    }
+  }
+
+ private:
+  std::vector<ArithEncoder::Context> contexts_;
+};
+
+struct SymbolInstance {
+  uint32_t id;
+  int32_t x;
+  int32_t y;
+};
+
+uint32_t NextRandom(uint32_t& seed, uint32_t range) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % range;
+}
+
+// Returns `kSymbolCount` glyph-like images of strokes.
+std::vector<std::unique_ptr<CJBig2_Image>> MakeSymbols() {
+  std::vector<std::unique_ptr<CJBig2_Image>> symbols;
+  uint32_t seed = 1;
+  for (uint32_t id = 0; id < kSymbolCount; ++id) {
+    const int32_t width = 12 + NextRandom(seed, 12);
+    const int32_t height = 20 + NextRandom(seed, 10);
+    const int32_t stem = NextRandom(seed, width - 3);
+    const int32_t bar = NextRandom(seed, height - 3);
+    const int32_t slope = 1 + NextRandom(seed, 3);
+    auto symbol = std::make_unique<CJBig2_Image>(width, height);
+    symbol->Fill(false);
+    for (int32_t y = 0; y < height; ++y) {
+      for (int32_t x = 0; x < width; ++x) {
+        const bool on = (x >= stem && x < stem + 3) ||
+                        (y >= bar && y < bar + 3) ||
+                        (y / slope - x >= 0 && y / slope - x < 3);
+        symbol->SetPixel(x, y, on);
+      }
+    }
+    symbols.push_back(std::move(symbol));
+  }
+  return symbols;
+}
+
+// Returns lines of text, each a list of instances of `symbols`, left to
+// right, with gaps between words.
+std::vector<std::vector<SymbolInstance>> MakeLines(
+    const std::vector<std::unique_ptr<CJBig2_Image>>& symbols) {
+  std::vector<std::vector<SymbolInstance>> lines;
+  uint32_t seed = 2;
+  for (int32_t y = kMargin; y + kLineHeight <= kPageHeight - kMargin;
+       y += kLineHeight) {
+    std::vector<SymbolInstance> line;
+    int32_t x = kMargin + NextRandom(seed, 40);
+    while (true) {
+      const uint32_t id = NextRandom(seed, kSymbolCount);
+      if (x + symbols[id]->width() > kPageWidth - kMargin) {
+        break;
+      }
+      line.push_back({id, x, y});
+      x += symbols[id]->width() + 2 + (NextRandom(seed, 6) == 0 ? 16 : 0);
+    }
+    lines.push_back(std::move(line));
+  }
+  return lines;
+}
+
+size_t CountInstances(const std::vector<std::vector<SymbolInstance>>& lines) {
+  size_t count = 0;
+  for (const auto& line : lines) {
+    count += line.size();
+  }
+  return count;
+}
+
+std::unique_ptr<CJBig2_Image> DrawPage(
+    const std::vector<std::unique_ptr<CJBig2_Image>>& symbols,
+    const std::vector<std::vector<SymbolInstance>>& lines) {
+  auto page = std::make_unique<CJBig2_Image>(kPageWidth, kPageHeight);
+  page->Fill(false);
+  for (const auto& line : lines) {
+    for (const SymbolInstance& instance : line) {
+      symbols[instance.id]->ComposeTo(page.get(), instance.x, instance.y,
+                                      JBIG2_COMPOSE_OR);
+    }
+  }
+  return page;
+}
+
+// Encodes `lines` as a text region with one strip per line, top-left
+// reference corners, and no refinement. See 6.4.5 in the JBIG2 spec.
+std::vector<uint8_t> EncodeTextRegion(
+    const std::vector<std::unique_ptr<CJBig2_Image>>& symbols,
+    const std::vector<std::vector<SymbolInstance>>& lines) {
+  ArithEncoder encoder;
+  IntEncoder iadt;
+  IntEncoder iafs;
+  IntEncoder iads;
+  IaidEncoder iaid;
+  iadt.Encode(encoder, 0);
+  int32_t strip_t = 0;
+  int32_t first_s = 0;
+  for (const auto& line : lines) {
+    iadt.Encode(encoder, line.front().y - strip_t);
+    strip_t = line.front().y;
+    int32_t cur_s = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+      if (i == 0) {
+        iafs.Encode(encoder, line[i].x - first_s);
+        first_s = line[i].x;
+      } else {
+        iads.Encode(encoder, line[i].x - cur_s);
+      }
+      iaid.Encode(encoder, line[i].id);
+      cur_s = line[i].x + symbols[line[i].id]->width() - 1;
+    }
+    iads.EncodeOob(encoder);
+  }
+  return encoder.Finish();
+}
+
+// Encodes `page` as a generic region with template 0 and adaptive template
+// pixels `at`. See 6.2.5.3 in the JBIG2 spec.
+std::vector<uint8_t> EncodeGenericRegion(const CJBig2_Image& page,
+                                         const std::array<int8_t, 8>& at) {
+  ArithEncoder encoder;
+  std::vector<ArithEncoder::Context> contexts(65536);
+  for (int32_t y = 0; y < page.height(); ++y) {
+    for (int32_t x = 0; x < page.width(); ++x) {
+      auto pixel = [&page, x, y](int32_t dx, int32_t dy) -> uint32_t {
+        return page.GetPixel(x + dx, y + dy);
+      };
+      const uint32_t context =
+          pixel(at[6], at[7]) << 15 | pixel(-1, -2) << 14 |
+          pixel(0, -2) << 13 | pixel(1, -2) << 12 | pixel(at[4], at[5]) << 11 |
+          pixel(at[2], at[3]) << 10 | pixel(-2, -1) << 9 |
+          pixel(-1, -1) << 8 | pixel(0, -1) << 7 | pixel(1, -1) << 6 |
+          pixel(2, -1) << 5 | pixel(at[0], at[1]) << 4 | pixel(-4, 0) << 3 |
+          pixel(-3, 0) << 2 | pixel(-2, 0) << 1 | pixel(-1, 0);
+      encoder.Encode(contexts[context], pixel(0, 0));
+    }
+  }
+  return encoder.Finish();
+}
+
+bool SameImage(const CJBig2_Image& a, const CJBig2_Image& b) {
+  if (a.width() != b.width() || a.height() != b.height()) {
+    return false;
+  }
+  for (int32_t y = 0; y < a.height(); ++y) {
+    for (int32_t x = 0; x < a.width(); ++x) {
+      if (a.GetPixel(x, y) != b.GetPixel(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<CJBig2_Image> DecodeGenericRegion(
+    pdfium::span<const uint8_t> data,
+    const std::array<int8_t, 8>& at) {
+  CJBig2_GRDProc proc;
+  proc.MMR = false;
+  proc.TPGDON = false;
+  proc.USESKIP = false;
+  proc.GBTEMPLATE = 0;
+  proc.GBW = kPageWidth;
+  proc.GBH = kPageHeight;
+  proc.GBAT = at;
+  CJBig2_BitStream stream(data, 0);
+  CJBig2_ArithDecoder arith_decoder(&stream);
+  std::vector<JBig2ArithCtx> contexts(65536);
+  return proc.DecodeArith(&arith_decoder, contexts);
+}
+
+std::unique_ptr<CJBig2_Image> DecodeTextRegion(
+    pdfium::span<const uint8_t> data,
+    const std::vector<std::unique_ptr<CJBig2_Image>>& symbols,
+    uint32_t instance_count) {
+  CJBig2_TRDProc proc;
+  proc.SBHUFF = false;
+  proc.SBREFINE = false;
+  proc.SBRTEMPLATE = false;
+  proc.TRANSPOSED = false;
+  proc.SBDEFPIXEL = false;
+  proc.SBDSOFFSET = 0;
+  proc.SBSYMCODELEN = kSymbolCodeLength;
+  proc.SBW = kPageWidth;
+  proc.SBH = kPageHeight;
+  proc.SBNUMINSTANCES = instance_count;
+  proc.SBSTRIPS = 1;
+  proc.SBNUMSYMS = kSymbolCount;
+  for (const auto& symbol : symbols) {
+    proc.SBSYMS.emplace_back(symbol.get());
+  }
+  proc.SBCOMBOP = JBIG2_COMPOSE_OR;
+  proc.REFCORNER = JBIG2_CORNER_TOPLEFT;
+  proc.SBRAT = {};
+  CJBig2_BitStream stream(data, 0);
+  CJBig2_ArithDecoder arith_decoder(&stream);
+  return proc.DecodeArith(&arith_decoder, {}, nullptr);
+}
+
+}  // namespace
+
+TEST(JBig2PerfTest, GenericRegion) {
+  const std::vector<std::unique_ptr<CJBig2_Image>> symbols = MakeSymbols();
+  const std::unique_ptr<CJBig2_Image> page =
+      DrawPage(symbols, MakeLines(symbols));
+
+  for (const std::array<int8_t, 8>& at : {kNominalAt, kOtherAt}) {
+    const std::vector<uint8_t> data = EncodeGenericRegion(*page, at);
+    std::unique_ptr<CJBig2_Image> decoded = DecodeGenericRegion(data, at);
+    ASSERT_TRUE(decoded);
+    ASSERT_TRUE(SameImage(*page, *decoded));
+
+    PrintPerfResult("jbig2_generic_region_page",
+                    at == kNominalAt ? "nominal_at" : "other_at",
+                    MedianRunTime(kRuns, [&data, &at] {
+                      EXPECT_TRUE(DecodeGenericRegion(data, at));
+                    }));
+  }
+}
+
+TEST(JBig2PerfTest, TextRegion) {
+  const std::vector<std::unique_ptr<CJBig2_Image>> symbols = MakeSymbols();
+  const std::vector<std::vector<SymbolInstance>> lines = MakeLines(symbols);
+  const uint32_t instance_count =
+      static_cast<uint32_t>(CountInstances(lines));
+  const std::vector<uint8_t> data = EncodeTextRegion(symbols, lines);
+
+  std::unique_ptr<CJBig2_Image> decoded =
+      DecodeTextRegion(data, symbols, instance_count);
+  ASSERT_TRUE(decoded);
+  ASSERT_TRUE(SameImage(*DrawPage(symbols, lines), *decoded));
+
+  PrintPerfResult("jbig2_text_region_page", "arith",
+                  MedianRunTime(kRuns, [&data, &symbols, instance_count] {
+                    EXPECT_TRUE(
+                        DecodeTextRegion(data, symbols, instance_count));
+                  }));
+}
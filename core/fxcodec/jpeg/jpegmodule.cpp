@@ -90,7 +90,8 @@ class JpegDecoder final : public ScanlineDecoder {
               uint32_t width,
               uint32_t height,
               int nComps,
-              bool ColorTransform);
+              bool ColorTransform,
+              uint32_t scale_denom);
 
   // ScanlineDecoder:
   [[nodiscard]] bool Rewind() override;
@@ -100,6 +101,7 @@ class JpegDecoder final : public ScanlineDecoder {
   bool InitDecode(bool bAcceptKnownBadHeader);
 
  private:
+  void CalcOutputSize();
   void CalcPitch();
   void InitDecompressSrc();
 
@@ -112,9 +114,11 @@ class JpegDecoder final : public ScanlineDecoder {
   // Patch up the in-memory JPEG header for known bad JPEGs.
   void PatchUpKnownBadHeaderWithInvalidHeight(size_t dimension_offset);
 
-  // Patch up the JPEG trailer, even if it is correct.
+  // Patch up the JPEG trailer, unless it is correct already.
   void PatchUpTrailer();
 
+  // The source data may be read-only, such as when it is borrowed from a
+  // memory-mapped file, so this makes a private copy to patch.
   pdfium::span<uint8_t> GetWritableSrcData();
 
   // For a given invalid height byte offset in
@@ -124,11 +128,14 @@ class JpegDecoder final : public ScanlineDecoder {
 
   JpegCommon common_ = {};
   pdfium::raw_span<const uint8_t> src_span_;
+  // Holds `src_span_` once GetWritableSrcData() copied it.
+  DataVector<uint8_t> patched_src_data_;
   DataVector<uint8_t> scanline_buf_;
   bool decompress_created_ = false;
   bool started_ = false;
   bool jpeg_transform_ = false;
   uint32_t default_scale_denom_ = 1;
+  uint32_t scale_denom_ = 1;
 };
 
 JpegDecoder::JpegDecoder() = default;
@@ -201,7 +208,10 @@ bool JpegDecoder::Create(pdfium::span<const uint8_t> src_span,
                          uint32_t width,
                          uint32_t height,
                          int nComps,
-                         bool ColorTransform) {
+                         bool ColorTransform,
+                         uint32_t scale_denom) {
+  CHECK(scale_denom == 1 || scale_denom == 2 || scale_denom == 4 ||
+        scale_denom == 8);
   src_span_ = JpegScanSOI(src_span);
   if (src_span_.size() < 2) {
     return false;
@@ -234,6 +244,10 @@ bool JpegDecoder::Create(pdfium::span<const uint8_t> src_span,
     return false;
   }
 
+  // libjpeg scales while it transforms blocks back to pixels, so smaller
+  // sizes are much cheaper to decode.
+  scale_denom_ = scale_denom;
+  CalcOutputSize();
   CalcPitch();
   scanline_buf_ = DataVector<uint8_t>(pitch_);
   comps_ = common_.cinfo.num_components;
@@ -249,16 +263,21 @@ bool JpegDecoder::Rewind() {
       return false;
     }
   }
-  common_.cinfo.scale_denom = default_scale_denom_;
-  output_width_ = orig_width_;
-  output_height_ = orig_height_;
+  if (scale_denom_ > 1) {
+    common_.cinfo.scale_num = 1;
+    common_.cinfo.scale_denom = scale_denom_;
+  } else {
+    common_.cinfo.scale_denom = default_scale_denom_;
+  }
+  CalcOutputSize();
   if (!jpeg_common_start_decompress(&common_)) {
     jpeg_common_destroy_decompress(&common_);
     return false;
   }
   CHECK_LE(static_cast<int>(common_.cinfo.output_width), orig_width_);
   started_ = true;
-  return true;
+  return static_cast<int>(common_.cinfo.output_width) == output_width_ &&
+         static_cast<int>(common_.cinfo.output_height) == output_height_;
 }
 
 pdfium::span<uint8_t> JpegDecoder::GetNextLine() {
@@ -275,6 +294,11 @@ uint32_t JpegDecoder::GetSrcOffset() {
                                common_.source_mgr.bytes_in_buffer);
 }
 
+void JpegDecoder::CalcOutputSize() {
+  output_width_ = (orig_width_ + scale_denom_ - 1) / scale_denom_;
+  output_height_ = (orig_height_ + scale_denom_ - 1) / scale_denom_;
+}
+
 void JpegDecoder::CalcPitch() {
   pitch_ = static_cast<uint32_t>(common_.cinfo.image_width) *
            common_.cinfo.num_components;
@@ -335,15 +359,22 @@ void JpegDecoder::PatchUpKnownBadHeaderWithInvalidHeight(
 }
 
 void JpegDecoder::PatchUpTrailer() {
+  if (src_span_[src_span_.size() - 2] == 0xff &&
+      src_span_[src_span_.size() - 1] == 0xd9) {
+    return;
+  }
   auto pData = GetWritableSrcData();
   pData[src_span_.size() - 2] = 0xff;
   pData[src_span_.size() - 1] = 0xd9;
 }
 
 pdfium::span<uint8_t> JpegDecoder::GetWritableSrcData() {
-  // SAFETY: const_cast<> doesn't change size.
-  return UNSAFE_BUFFERS(
-      pdfium::span(const_cast<uint8_t*>(src_span_.data()), src_span_.size()));
+  if (patched_src_data_.empty()) {
+    patched_src_data_ =
+        DataVector<uint8_t>(src_span_.begin(), src_span_.end());
+    src_span_ = patched_src_data_;
+  }
+  return patched_src_data_;
 }
 
 }  // namespace
@@ -354,11 +385,13 @@ std::unique_ptr<ScanlineDecoder> JpegModule::CreateDecoder(
     uint32_t width,
     uint32_t height,
     int nComps,
-    bool ColorTransform) {
+    bool ColorTransform,
+    uint32_t scale_denom) {
   DCHECK(!src_span.empty());
 
   auto pDecoder = std::make_unique<JpegDecoder>();
-  if (!pDecoder->Create(src_span, width, height, nComps, ColorTransform)) {
+  if (!pDecoder->Create(src_span, width, height, nComps, ColorTransform,
+                        scale_denom)) {
     return nullptr;
   }
 
@@ -37,12 +37,15 @@ class JpegModule {
     bool color_transform;
   };
 
+  // Decodes at 1 / `scale_denom` of the full size, rounded up, where
+  // `scale_denom` is 1, 2, 4 or 8.
   static std::unique_ptr<ScanlineDecoder> CreateDecoder(
       pdfium::span<const uint8_t> src_span,
       uint32_t width,
       uint32_t height,
       int nComps,
-      bool ColorTransform);
+      bool ColorTransform,
+      uint32_t scale_denom);
 
   static std::optional<ImageInfo> LoadInfo(
       pdfium::span<const uint8_t> src_span);
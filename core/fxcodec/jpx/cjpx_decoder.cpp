@@ -425,6 +425,40 @@ void color_sycc_to_rgb(opj_image_t* img) {
   img->color_space = OPJ_CLRSPC_SRGB;
 }
 
+uint32_t CeilDiv(uint64_t a, uint32_t b) {
+  return static_cast<uint32_t>((a + b - 1) / b);
+}
+
+uint32_t CeilDivPow2(uint32_t a, int shift) {
+  return static_cast<uint32_t>(
+      ((static_cast<uint64_t>(a) + (uint64_t{1} << shift)) - 1) >> shift);
+}
+
+// Converts a position on the reference grid into pixels of a component with
+// subsampling `d`, decoded `reduce` resolution levels down, relative to the
+// image's `origin`. This matches how OpenJPEG sizes decoded components.
+int ToDecodedPixels(uint32_t ref, uint32_t origin, uint32_t d, int reduce) {
+  return static_cast<int>(CeilDivPow2(CeilDiv(ref, d), reduce) -
+                          CeilDivPow2(CeilDiv(origin, d), reduce));
+}
+
+// The inverse of ToDecodedPixels(), rounding down.
+uint64_t ToReferenceGrid(int pixels, uint32_t origin, uint32_t d, int reduce) {
+  const uint64_t decoded_origin = CeilDivPow2(CeilDiv(origin, d), reduce);
+  return ((decoded_origin + std::max(pixels, 0)) << reduce) * d;
+}
+
+int ToTileIndex(uint64_t ref,
+                uint32_t tile_origin,
+                uint32_t tile_size,
+                uint32_t tile_count,
+                bool round_up) {
+  const uint64_t offset = ref > tile_origin ? ref - tile_origin : 0;
+  const uint64_t index =
+      round_up ? (offset + tile_size - 1) / tile_size : offset / tile_size;
+  return static_cast<int>(std::min<uint64_t>(index, tile_count));
+}
+
 }  // namespace
 
 // static
@@ -432,10 +466,12 @@ std::unique_ptr<CJPX_Decoder> CJPX_Decoder::Create(
     pdfium::span<const uint8_t> src_span,
     CJPX_Decoder::ColorSpaceOption option,
     uint8_t resolution_levels_to_skip,
-    bool strict_mode) {
+    bool strict_mode,
+    uint32_t max_threads) {
   // Private ctor.
   auto decoder = pdfium::WrapUnique(new CJPX_Decoder(option));
-  if (!decoder->Init(src_span, resolution_levels_to_skip, strict_mode)) {
+  if (!decoder->Init(src_span, resolution_levels_to_skip, strict_mode,
+                     max_threads)) {
     return nullptr;
   }
   return decoder;
@@ -453,7 +489,8 @@ CJPX_Decoder::~CJPX_Decoder() = default;
 
 bool CJPX_Decoder::Init(pdfium::span<const uint8_t> src_data,
                         uint8_t resolution_levels_to_skip,
-                        bool strict_mode) {
+                        bool strict_mode,
+                        uint32_t max_threads) {
   static constexpr uint8_t kJP2Header[] = {0x00, 0x00, 0x00, 0x0c, 0x6a, 0x50,
                                            0x20, 0x20, 0x0d, 0x0a, 0x87, 0x0a};
   if (src_data.size() < sizeof(kJP2Header) ||
@@ -499,13 +536,43 @@ bool CJPX_Decoder::Init(pdfium::span<const uint8_t> src_data,
     CHECK(opj_decoder_set_strict_mode(codec_.get(), false));
   }
 
+  // Has to happen before reading the header, which sets up the tile decoder
+  // with the codec's threads. Failing to get threads is not an error.
+  if (max_threads > 1 && opj_has_thread_support()) {
+    opj_codec_set_threads(codec_.get(), static_cast<int>(max_threads));
+  }
+
   opj_image_t* pTempImage = nullptr;
   if (!opj_read_header(stream_.get(), codec_.get(), &pTempImage)) {
     return false;
   }
 
   image_.reset(pTempImage);
-  return true;
+  if (!image_->numcomps || !image_->comps[0].dx || !image_->comps[0].dy) {
+    return false;
+  }
+
+  opj_codestream_info_v2_t* cstr_info = opj_get_cstr_info(codec_.get());
+  if (!cstr_info) {
+    return false;
+  }
+  layout_ = {
+      .image_x0 = image_->x0,
+      .image_y0 = image_->y0,
+      .image_x1 = image_->x1,
+      .image_y1 = image_->y1,
+      .tile_x0 = cstr_info->tx0,
+      .tile_y0 = cstr_info->ty0,
+      .tile_width = cstr_info->tdx,
+      .tile_height = cstr_info->tdy,
+      .tile_columns = cstr_info->tw,
+      .tile_rows = cstr_info->th,
+      .dx = image_->comps[0].dx,
+      .dy = image_->comps[0].dy,
+  };
+  opj_destroy_cstr_info(&cstr_info);
+  return layout_.tile_width && layout_.tile_height && layout_.tile_columns &&
+         layout_.tile_rows;
 }
 
 bool CJPX_Decoder::StartDecode() {
@@ -556,6 +623,82 @@ bool CJPX_Decoder::StartDecode() {
   return true;
 }
 
+CFX_Size CJPX_Decoder::GetTileGridSize() const {
+  return {pdfium::checked_cast<int>(layout_.tile_columns),
+          pdfium::checked_cast<int>(layout_.tile_rows)};
+}
+
+FX_RECT CJPX_Decoder::GetTilesForArea(const FX_RECT& area) const {
+  const int reduce = parameters_.cp_reduce;
+  const auto to_column = [&](int x, bool round_up) {
+    const uint64_t ref =
+        ToReferenceGrid(x, layout_.image_x0, layout_.dx, reduce);
+    return ToTileIndex(ref, layout_.tile_x0, layout_.tile_width,
+                       layout_.tile_columns, round_up);
+  };
+  const auto to_row = [&](int y, bool round_up) {
+    const uint64_t ref =
+        ToReferenceGrid(y, layout_.image_y0, layout_.dy, reduce);
+    return ToTileIndex(ref, layout_.tile_y0, layout_.tile_height,
+                       layout_.tile_rows, round_up);
+  };
+  FX_RECT tiles(to_column(area.left, false), to_row(area.top, false),
+                to_column(area.right, true), to_row(area.bottom, true));
+  tiles.right = std::max(tiles.right, tiles.left + 1);
+  tiles.bottom = std::max(tiles.bottom, tiles.top + 1);
+  return tiles;
+}
+
+FX_RECT CJPX_Decoder::GetAreaForTiles(const FX_RECT& tiles) const {
+  const ReferenceArea ref = GetReferenceAreaForTiles(tiles);
+  const int reduce = parameters_.cp_reduce;
+  return FX_RECT(ToDecodedPixels(ref.x0, layout_.image_x0, layout_.dx, reduce),
+                 ToDecodedPixels(ref.y0, layout_.image_y0, layout_.dy, reduce),
+                 ToDecodedPixels(ref.x1, layout_.image_x0, layout_.dx, reduce),
+                 ToDecodedPixels(ref.y1, layout_.image_y0, layout_.dy, reduce));
+}
+
+bool CJPX_Decoder::StartDecodeTiles(const FX_RECT& tiles) {
+  // OpenJPEG takes decode areas as int32_t. Callers decode whole images past
+  // that instead.
+  const ReferenceArea ref = GetReferenceAreaForTiles(tiles);
+  constexpr uint32_t kMaxArea = std::numeric_limits<int32_t>::max();
+  if (ref.x0 >= ref.x1 || ref.y0 >= ref.y1 || ref.x1 > kMaxArea ||
+      ref.y1 > kMaxArea) {
+    return false;
+  }
+  parameters_.DA_x0 = ref.x0;
+  parameters_.DA_y0 = ref.y0;
+  parameters_.DA_x1 = ref.x1;
+  parameters_.DA_y1 = ref.y1;
+  return StartDecode();
+}
+
+CJPX_Decoder::ReferenceArea CJPX_Decoder::GetReferenceAreaForTiles(
+    const FX_RECT& tiles) const {
+  const auto clamp_column = [&](int column) {
+    return static_cast<uint64_t>(std::clamp<int64_t>(
+        column, 0, static_cast<int64_t>(layout_.tile_columns)));
+  };
+  const auto clamp_row = [&](int row) {
+    return static_cast<uint64_t>(
+        std::clamp<int64_t>(row, 0, static_cast<int64_t>(layout_.tile_rows)));
+  };
+  // Clamping to the image keeps the results within uint32_t.
+  const auto to_x = [&](int column) {
+    return static_cast<uint32_t>(std::clamp<uint64_t>(
+        layout_.tile_x0 + clamp_column(column) * layout_.tile_width,
+        layout_.image_x0, layout_.image_x1));
+  };
+  const auto to_y = [&](int row) {
+    return static_cast<uint32_t>(std::clamp<uint64_t>(
+        layout_.tile_y0 + clamp_row(row) * layout_.tile_height,
+        layout_.image_y0, layout_.image_y1));
+  };
+  return {to_x(tiles.left), to_y(tiles.top), to_x(tiles.right),
+          to_y(tiles.bottom)};
+}
+
 CJPX_Decoder::JpxImageInfo CJPX_Decoder::GetInfo() const {
   const auto components = components_span(image_.get());
   return {components[0].w, components[0].h,
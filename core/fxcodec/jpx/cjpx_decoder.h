@@ -11,6 +11,7 @@
 
 #include <memory>
 
+#include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/span.h"
 
@@ -43,11 +44,17 @@ class CJPX_Decoder {
     COLOR_SPACE colorspace;
   };
 
+  // OpenJPEG may start up to `max_threads` threads of its own to decode with,
+  // while the calling thread waits. 1 decodes on the calling thread alone.
+  // Builds of OpenJPEG without thread support always do the latter. How much
+  // faster more threads decode real multi-tile images has not been measured;
+  // the output is the same either way.
   static std::unique_ptr<CJPX_Decoder> Create(
       pdfium::span<const uint8_t> src_span,
       CJPX_Decoder::ColorSpaceOption option,
       uint8_t resolution_levels_to_skip,
-      bool strict_mode);
+      bool strict_mode,
+      uint32_t max_threads);
 
   static void Sycc420ToRgbForTesting(opj_image_t* img);
 
@@ -56,6 +63,17 @@ class CJPX_Decoder {
   JpxImageInfo GetInfo() const;
   bool StartDecode();
 
+  // Tiles are given as a range of tile columns and rows, and areas in pixels
+  // of the decoded image, relative to its top-left corner. Large images are
+  // often split into many tiles, which decode independently of each other.
+  CFX_Size GetTileGridSize() const;
+  FX_RECT GetTilesForArea(const FX_RECT& area) const;
+  FX_RECT GetAreaForTiles(const FX_RECT& tiles) const;
+
+  // Like StartDecode(), but only decodes `tiles`. Afterwards, GetInfo() and
+  // Decode() only cover GetAreaForTiles(`tiles`).
+  bool StartDecodeTiles(const FX_RECT& tiles);
+
   // `swap_rgb` can only be set when an image's color space type contains at
   // least 3 color components. Note that this `component_count` is not
   // equivalent to `JpxImageInfo::channels`. The JpxImageInfo channels can
@@ -85,6 +103,32 @@ class CJPX_Decoder {
     inline void operator()(opj_stream_t* ptr) const { opj_stream_destroy(ptr); }
   };
 
+  // Where the image and its tiles are on the reference grid of the
+  // codestream, which is at full resolution.
+  struct Layout {
+    uint32_t image_x0;
+    uint32_t image_y0;
+    uint32_t image_x1;
+    uint32_t image_y1;
+    uint32_t tile_x0;
+    uint32_t tile_y0;
+    uint32_t tile_width;
+    uint32_t tile_height;
+    uint32_t tile_columns;
+    uint32_t tile_rows;
+    // Subsampling of the first component.
+    uint32_t dx;
+    uint32_t dy;
+  };
+
+  // An area on the reference grid, which may reach past INT_MAX.
+  struct ReferenceArea {
+    uint32_t x0;
+    uint32_t y0;
+    uint32_t x1;
+    uint32_t y1;
+  };
+
   // Use Create() to instantiate.
   explicit CJPX_Decoder(ColorSpaceOption option);
 
@@ -92,7 +136,9 @@ class CJPX_Decoder {
   // worked out in OpenJPEG.
   bool Init(pdfium::span<const uint8_t> src_data,
             uint8_t resolution_levels_to_skip,
-            bool strict_mode);
+            bool strict_mode,
+            uint32_t max_threads);
+  ReferenceArea GetReferenceAreaForTiles(const FX_RECT& tiles) const;
 
   const ColorSpaceOption color_space_option_;
   pdfium::raw_span<const uint8_t> src_data_;
@@ -101,6 +147,7 @@ class CJPX_Decoder {
   std::unique_ptr<opj_stream_t, StreamDeleter> stream_;
   std::unique_ptr<opj_image_t, ImageDeleter> image_;
   opj_dparameters_t parameters_ = {};
+  Layout layout_ = {};
 };
 
 }  // namespace fxcodec
@@ -0,0 +1,171 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/fxcodec/jpx/cjpx_decoder.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/thread_pool.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf_test_helpers.h"
+
+namespace {
+
+constexpr uint32_t kImageSize = 1024;
+constexpr uint32_t kTileSize = 512;
+constexpr size_t kImageCount = 4;
+constexpr size_t kThreads = 4;
+constexpr int kRuns = 5;
+
+// An in-memory stream for OpenJPEG to write a codestream to.
+struct Output {
+  std::vector<uint8_t> data;
+  size_t pos = 0;
+};
+
+OPJ_SIZE_T WriteOutput(void* buffer, OPJ_SIZE_T size, void* user_data) {
+  Output* output = static_cast<Output*>(user_data);
+  if (output->data.size() < output->pos + size) {
+    output->data.resize(output->pos + size);
+  }
+  memcpy(output->data.data() + output->pos, buffer, size);
+  output->pos += size;
+  return size;
+}
+
+OPJ_OFF_T SkipOutput(OPJ_OFF_T size, void* user_data) {
+  Output* output = static_cast<Output*>(user_data);
+  output->pos += size;
+  return size;
+}
+
+OPJ_BOOL SeekOutput(OPJ_OFF_T pos, void* user_data) {
+  static_cast<Output*>(user_data)->pos = pos;
+  return OPJ_TRUE;
+}
+
+// Returns a lossless gray codestream of `image_size` squared pixels, in tiles
+// of up to `kTileSize`, with enough detail that decoding it takes a while.
+std::vector<uint8_t> EncodeImage(uint32_t image_size) {
+  const uint32_t tile_size = std::min(image_size, kTileSize);
+  opj_image_cmptparm_t component = {};
+  component.dx = 1;
+  component.dy = 1;
+  component.w = image_size;
+  component.h = image_size;
+  component.prec = 8;
+  opj_image_t* image = opj_image_create(1, &component, OPJ_CLRSPC_GRAY);
+  image->x1 = image_size;
+  image->y1 = image_size;
+  for (uint32_t y = 0; y < image_size; ++y) {
+    for (uint32_t x = 0; x < image_size; ++x) {
+      image->comps[0].data[y * image_size + x] = ((x * y) ^ (x + y)) & 0xff;
+    }
+  }
+
+  opj_cparameters_t parameters;
+  opj_set_default_encoder_parameters(&parameters);
+  parameters.tcp_numlayers = 1;
+  parameters.tcp_rates[0] = 0;
+  parameters.cp_disto_alloc = 1;
+  parameters.tile_size_on = OPJ_TRUE;
+  parameters.cp_tdx = tile_size;
+  parameters.cp_tdy = tile_size;
+
+  Output output;
+  opj_codec_t* codec = opj_create_compress(OPJ_CODEC_J2K);
+  opj_stream_t* stream = opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE, false);
+  opj_stream_set_write_function(stream, WriteOutput);
+  opj_stream_set_skip_function(stream, SkipOutput);
+  opj_stream_set_seek_function(stream, SeekOutput);
+  opj_stream_set_user_data(stream, &output, nullptr);
+  const bool encoded = opj_setup_encoder(codec, &parameters, image) &&
+                       opj_start_compress(codec, image, stream) &&
+                       opj_encode(codec, stream) &&
+                       opj_end_compress(codec, stream);
+  opj_stream_destroy(stream);
+  opj_destroy_codec(codec);
+  opj_image_destroy(image);
+  EXPECT_TRUE(encoded);
+  return output.data;
+}
+
+void DecodeImage(pdfium::span<const uint8_t> codestream,
+                 uint32_t image_size,
+                 size_t max_threads) {
+  std::unique_ptr<CJPX_Decoder> decoder = CJPX_Decoder::Create(
+      codestream, CJPX_Decoder::ColorSpaceOption::kNone,
+      /*resolution_levels_to_skip=*/0, /*strict_mode=*/true,
+      static_cast<uint32_t>(max_threads));
+  ASSERT_TRUE(decoder);
+  ASSERT_TRUE(decoder->StartDecode());
+  std::vector<uint8_t> pixels(image_size * image_size);
+  ASSERT_TRUE(decoder->Decode(pixels, /*pitch=*/image_size,
+                              /*swap_rgb=*/false, /*component_count=*/1));
+}
+
+}  // namespace
+
+TEST(JpxDecoderPerfTest, OneImage) {
+  const std::vector<uint8_t> codestream = EncodeImage(kImageSize);
+  ASSERT_FALSE(codestream.empty());
+
+  PrintPerfResult("jpx_decode_one_image", "one_thread",
+                  MedianRunTime(kRuns, [&codestream] {
+                    DecodeImage(codestream, kImageSize, 1);
+                  }));
+  PrintPerfResult("jpx_decode_one_image", "library_threads",
+                  MedianRunTime(kRuns, [&codestream] {
+                    DecodeImage(codestream, kImageSize,
+                                ThreadPool::GetMaxLibraryThreads());
+                  }));
+}
+
+// Decodes images side by side on the pool. Each decode gets as many threads
+// as the pool allows it, or as many as the pool has, on top of the pool's own
+// threads.
+TEST(JpxDecoderPerfTest, ImagesOnPool) {
+  const std::vector<uint8_t> codestream = EncodeImage(kImageSize);
+  ASSERT_FALSE(codestream.empty());
+
+  PrintPerfResult("jpx_decode_images_on_pool", "library_threads",
+                  MedianRunTime(kRuns, [&codestream] {
+                    ThreadPool::ParallelFor(kImageCount, [&](size_t) {
+                      DecodeImage(codestream, kImageSize,
+                                  ThreadPool::GetMaxLibraryThreads());
+                    });
+                  }));
+  PrintPerfResult("jpx_decode_images_on_pool", "all_threads_each",
+                  MedianRunTime(kRuns, [&codestream] {
+                    ThreadPool::ParallelFor(kImageCount, [&](size_t) {
+                      DecodeImage(codestream, kImageSize,
+                                  ThreadPool::GetMaxConcurrency());
+                    });
+                  }));
+}
+
+// Decodes images of growing sizes on one thread and on `kThreads` threads, to
+// find the size from which threads pay for starting them.
+TEST(JpxDecoderPerfTest, ImageSizes) {
+  for (uint32_t image_size : {128u, 256u, 512u, 1024u, 2048u}) {
+    const std::vector<uint8_t> codestream = EncodeImage(image_size);
+    ASSERT_FALSE(codestream.empty());
+
+    const std::string name = "jpx_decode_" + std::to_string(image_size) + "px";
+    PrintPerfResult(name.c_str(), "one_thread",
+                    MedianRunTime(kRuns, [&codestream, image_size] {
+                      DecodeImage(codestream, image_size, 1);
+                    }));
+    PrintPerfResult(name.c_str(), "4_threads",
+                    MedianRunTime(kRuns, [&codestream, image_size] {
+                      DecodeImage(codestream, image_size, kThreads);
+                    }));
+  }
+}
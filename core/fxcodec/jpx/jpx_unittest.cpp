@@ -8,12 +8,17 @@
 #include <algorithm>
 #include <array>
 #include <limits>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 #include "core/fxcodec/jpx/cjpx_decoder.h"
 #include "core/fxcodec/jpx/jpx_decode_utils.h"
+#include "core/fxcrt/byteorder.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/fx_memory.h"
+#include "core/fxcrt/span.h"
+#include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/libopenjpeg/opj_malloc.h"
 
@@ -21,6 +26,8 @@ namespace fxcodec {
 
 namespace {
 
+using ::testing::ElementsAre;
+
 constexpr OPJ_OFF_T kSkipError = static_cast<OPJ_OFF_T>(-1);
 constexpr OPJ_SIZE_T kReadError = static_cast<OPJ_SIZE_T>(-1);
 
@@ -31,6 +38,28 @@ constexpr auto kStreamData = std::to_array<const uint8_t>({
     // clang-format on
 });
 
+// An 8x8 gray codestream split into 4x4 tiles, with 2 resolution levels. Each
+// pixel is 40 * tile column + 10 * tile row + (x % 2).
+constexpr auto kTiledCodestream = std::to_array<const uint8_t>({
+    // clang-format off
+    0xff, 0x4f, 0xff, 0x51, 0x00, 0x29, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+    0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x01, 0xff, 0x52, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x04, 0x04, 0x00, 0x01, 0xff,
+    0x5c, 0x00, 0x07, 0x40, 0x40, 0x48, 0x48, 0x50, 0xff, 0x90, 0x00, 0x0a,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x01, 0xff, 0x93, 0xcf, 0xb4,
+    0x08, 0x08, 0x82, 0xc0, 0x11, 0x00, 0x01, 0xcf, 0xff, 0x90, 0x00, 0x0a,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x1a, 0x00, 0x01, 0xff, 0x93, 0xcf, 0xb4,
+    0x10, 0x08, 0x8c, 0x4d, 0x37, 0xc0, 0x11, 0x00, 0x01, 0xcf, 0xff, 0x90,
+    0x00, 0x0a, 0x00, 0x02, 0x00, 0x00, 0x00, 0x1b, 0x00, 0x01, 0xff, 0x93,
+    0xcf, 0xb4, 0x14, 0x08, 0x81, 0x8c, 0xfe, 0xdf, 0xc0, 0x11, 0x00, 0x01,
+    0xcf, 0xff, 0x90, 0x00, 0x0a, 0x00, 0x03, 0x00, 0x00, 0x00, 0x1b, 0x00,
+    0x01, 0xff, 0x93, 0xcf, 0xb4, 0x14, 0x08, 0x8f, 0x9e, 0x9d, 0xbf, 0xc0,
+    0x11, 0x00, 0x01, 0xcf, 0xff, 0xd9,
+    // clang-format on
+});
+
 }  // namespace
 
 TEST(fxcodec, DecodeDataNullDecodeData) {
@@ -463,4 +492,97 @@ TEST(fxcodec, YUV420ToRGB) {
   FX_Free(img.comps);
 }
 
+TEST(fxcodec, DecodeTiles) {
+  std::unique_ptr<CJPX_Decoder> decoder = CJPX_Decoder::Create(
+      kTiledCodestream, CJPX_Decoder::ColorSpaceOption::kNone,
+      /*resolution_levels_to_skip=*/0, /*strict_mode=*/true,
+      /*max_threads=*/1);
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(CFX_Size(2, 2), decoder->GetTileGridSize());
+  EXPECT_EQ(FX_RECT(1, 0, 2, 1),
+            decoder->GetTilesForArea(FX_RECT(5, 1, 6, 3)));
+  EXPECT_EQ(FX_RECT(0, 0, 2, 2),
+            decoder->GetTilesForArea(FX_RECT(3, 3, 5, 5)));
+  EXPECT_EQ(FX_RECT(4, 0, 8, 4),
+            decoder->GetAreaForTiles(FX_RECT(1, 0, 2, 1)));
+
+  ASSERT_TRUE(decoder->StartDecodeTiles(FX_RECT(1, 0, 2, 1)));
+  CJPX_Decoder::JpxImageInfo info = decoder->GetInfo();
+  EXPECT_EQ(4u, info.width);
+  EXPECT_EQ(4u, info.height);
+
+  std::array<uint8_t, 16> pixels;
+  ASSERT_TRUE(decoder->Decode(pixels, /*pitch=*/4, /*swap_rgb=*/false,
+                              /*component_count=*/1));
+  EXPECT_THAT(pixels, ElementsAre(40, 41, 40, 41, 40, 41, 40, 41, 40, 41, 40,
+                                  41, 40, 41, 40, 41));
+}
+
+TEST(fxcodec, DecodeTilesAtLargeOffsets) {
+  // Moves the image and its tiles to just below INT_MAX on the reference
+  // grid, so that their right and bottom edges are past it.
+  constexpr uint32_t kOffset = std::numeric_limits<int32_t>::max() - 3;
+  std::vector<uint8_t> codestream(kTiledCodestream.begin(),
+                                  kTiledCodestream.end());
+  // Xsiz, Ysiz, XOsiz, YOsiz, and after the tile size, XTOsiz and YTOsiz.
+  pdfium::span<uint8_t> siz = pdfium::span(codestream);
+  for (size_t offset : {8u, 12u}) {
+    fxcrt::PutUInt32MSBFirst(kOffset + 8, siz.subspan(offset).first<4>());
+  }
+  for (size_t offset : {16u, 20u, 32u, 36u}) {
+    fxcrt::PutUInt32MSBFirst(kOffset, siz.subspan(offset).first<4>());
+  }
+
+  std::unique_ptr<CJPX_Decoder> decoder = CJPX_Decoder::Create(
+      codestream, CJPX_Decoder::ColorSpaceOption::kNone,
+      /*resolution_levels_to_skip=*/0, /*strict_mode=*/true,
+      /*max_threads=*/1);
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(CFX_Size(2, 2), decoder->GetTileGridSize());
+  EXPECT_EQ(FX_RECT(1, 0, 2, 1),
+            decoder->GetTilesForArea(FX_RECT(5, 1, 6, 3)));
+  EXPECT_EQ(FX_RECT(4, 0, 8, 4),
+            decoder->GetAreaForTiles(FX_RECT(1, 0, 2, 1)));
+  EXPECT_EQ(FX_RECT(0, 0, 8, 8),
+            decoder->GetAreaForTiles(FX_RECT(0, 0, 2, 2)));
+
+  // OpenJPEG takes decode areas as int32_t, so these tiles do not decode, but
+  // asking for them fails cleanly.
+  EXPECT_FALSE(decoder->StartDecodeTiles(FX_RECT(1, 0, 2, 1)));
+}
+
+TEST(fxcodec, DecodeTilesAtLowerResolution) {
+  std::unique_ptr<CJPX_Decoder> decoder = CJPX_Decoder::Create(
+      kTiledCodestream, CJPX_Decoder::ColorSpaceOption::kNone,
+      /*resolution_levels_to_skip=*/1, /*strict_mode=*/true,
+      /*max_threads=*/1);
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(FX_RECT(1, 1, 2, 2),
+            decoder->GetTilesForArea(FX_RECT(2, 3, 3, 4)));
+  EXPECT_EQ(FX_RECT(2, 2, 4, 4),
+            decoder->GetAreaForTiles(FX_RECT(1, 1, 2, 2)));
+
+  ASSERT_TRUE(decoder->StartDecodeTiles(FX_RECT(1, 1, 2, 2)));
+  CJPX_Decoder::JpxImageInfo info = decoder->GetInfo();
+  EXPECT_EQ(2u, info.width);
+  EXPECT_EQ(2u, info.height);
+}
+
+TEST(fxcodec, DecodeWithThreads) {
+  // Whether or not this build of OpenJPEG has threads, the result is the same.
+  std::array<uint8_t, 64> expected;
+  std::array<uint8_t, 64> pixels;
+  for (uint32_t max_threads : {1u, 4u}) {
+    std::unique_ptr<CJPX_Decoder> decoder = CJPX_Decoder::Create(
+        kTiledCodestream, CJPX_Decoder::ColorSpaceOption::kNone,
+        /*resolution_levels_to_skip=*/0, /*strict_mode=*/true, max_threads);
+    ASSERT_TRUE(decoder);
+    ASSERT_TRUE(decoder->StartDecode());
+    ASSERT_TRUE(decoder->Decode(max_threads == 1 ? expected : pixels,
+                                /*pitch=*/8, /*swap_rgb=*/false,
+                                /*component_count=*/1));
+  }
+  EXPECT_EQ(expected, pixels);
+}
+
 }  // namespace fxcodec
@@ -0,0 +1,30 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCODEC_STREAMDECODER_H_
+#define CORE_FXCODEC_STREAMDECODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+
+namespace fxcodec {
+
+// Hands out decoded data a piece at a time, for callers that go through it
+// in order and do not need all of it in memory at once.
+class StreamDecoder {
+ public:
+  virtual ~StreamDecoder() = default;
+
+  // Fills `buffer` with the next decoded bytes, and returns how many there
+  // were. Fills all of `buffer` unless the decoded data runs out.
+  virtual size_t Read(pdfium::span<uint8_t> buffer) = 0;
+};
+
+}  // namespace fxcodec
+
+using StreamDecoder = fxcodec::StreamDecoder;
+
+#endif  // CORE_FXCODEC_STREAMDECODER_H_
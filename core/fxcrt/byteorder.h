@@ -83,6 +83,16 @@ inline uint32_t GetUInt32MSBFirst(pdfium::span<const uint8_t, 4> span) {
          (static_cast<uint32_t>(span[2]) << 8) | static_cast<uint32_t>(span[3]);
 }
 
+inline uint64_t GetUInt64MSBFirst(pdfium::span<const uint8_t, 8> span) {
+  return (static_cast<uint64_t>(span[0]) << 56) |
+         (static_cast<uint64_t>(span[1]) << 48) |
+         (static_cast<uint64_t>(span[2]) << 40) |
+         (static_cast<uint64_t>(span[3]) << 32) |
+         (static_cast<uint64_t>(span[4]) << 24) |
+         (static_cast<uint64_t>(span[5]) << 16) |
+         (static_cast<uint64_t>(span[6]) << 8) | static_cast<uint64_t>(span[7]);
+}
+
 inline uint16_t GetUInt16LSBFirst(pdfium::span<const uint8_t, 2> span) {
   return (static_cast<uint32_t>(span[1]) << 8) | static_cast<uint32_t>(span[0]);
 }
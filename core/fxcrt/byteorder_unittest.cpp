@@ -71,6 +71,11 @@ TEST(ByteOrder, GetUInt32MSBFirst) {
   EXPECT_EQ(0xfffefdfc, GetUInt32MSBFirst(kBuf));
 }
 
+TEST(ByteOrder, GetUInt64MSBFirst) {
+  const uint8_t kBuf[8] = {0xff, 0xfe, 0xfd, 0xfc, 0x04, 0x03, 0x02, 0x01};
+  EXPECT_EQ(0xfffefdfc04030201u, GetUInt64MSBFirst(kBuf));
+}
+
 TEST(ByteOrder, PutUInt16LSBFirst) {
   uint8_t buf[2];
   PutUInt16LSBFirst(0xfffe, buf);
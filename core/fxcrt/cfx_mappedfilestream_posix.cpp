@@ -0,0 +1,73 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cfx_mappedfilestream_posix.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif  // O_CLOEXEC
+
+// static
+RetainPtr<CFX_MappedFileStream> CFX_MappedFileStream::Create(
+    const char* filename) {
+  const int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat s = {};
+  void* address = MAP_FAILED;
+  size_t size = 0;
+  if (fstat(fd, &s) == 0 && S_ISREG(s.st_mode) && s.st_size > 0 &&
+      pdfium::IsValueInRangeForNumericType<size_t>(s.st_size)) {
+    size = static_cast<size_t>(s.st_size);
+    address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // SAFETY: mmap() succeeded in mapping `size` bytes at `address`.
+  return pdfium::MakeRetain<CFX_MappedFileStream>(UNSAFE_BUFFERS(
+      pdfium::span(static_cast<const uint8_t*>(address), size)));
+}
+
+CFX_MappedFileStream::CFX_MappedFileStream(pdfium::span<const uint8_t> mapping)
+    : mapping_(mapping),
+      stream_(pdfium::MakeRetain<CFX_ReadOnlySpanStream>(mapping)) {}
+
+CFX_MappedFileStream::~CFX_MappedFileStream() {
+  munmap(const_cast<uint8_t*>(mapping_.data()), mapping_.size());
+}
+
+FX_FILESIZE CFX_MappedFileStream::GetSize() {
+  return stream_->GetSize();
+}
+
+bool CFX_MappedFileStream::ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                                             FX_FILESIZE offset) {
+  return stream_->ReadBlockAtOffset(buffer, offset);
+}
+
+pdfium::span<const uint8_t> CFX_MappedFileStream::GetInMemorySpan() {
+  return mapping_;
+}
+
+void CFX_MappedFileStream::SetAccessPattern(AccessPattern pattern) {
+  // Purely advisory, so failures are not worth reporting.
+  madvise(const_cast<uint8_t*>(mapping_.data()), mapping_.size(),
+          pattern == AccessPattern::kSequential ? MADV_SEQUENTIAL
+                                                : MADV_NORMAL);
+}
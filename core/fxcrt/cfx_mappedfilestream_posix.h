@@ -0,0 +1,48 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCRT_CFX_MAPPEDFILESTREAM_POSIX_H_
+#define CORE_FXCRT_CFX_MAPPEDFILESTREAM_POSIX_H_
+
+#include <stdint.h>
+
+#include "build/build_config.h"
+#include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+
+#if !BUILDFLAG(IS_POSIX)
+#error "Included on the wrong platform"
+#endif
+
+class CFX_ReadOnlySpanStream;
+
+// Reads a file through a read-only memory mapping, so that parsing it does not
+// copy it into intermediate buffers. The file must not be truncated while it
+// is mapped, as reading the pages past its new end is fatal.
+class CFX_MappedFileStream final : public IFX_SeekableReadStream {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  // Returns nullptr if `filename` can not be opened or mapped, which includes
+  // empty files and anything that is not a regular file.
+  static RetainPtr<CFX_MappedFileStream> Create(const char* filename);
+
+  // IFX_SeekableReadStream:
+  FX_FILESIZE GetSize() override;
+  bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                         FX_FILESIZE offset) override;
+  pdfium::span<const uint8_t> GetInMemorySpan() override;
+  void SetAccessPattern(AccessPattern pattern) override;
+
+ private:
+  explicit CFX_MappedFileStream(pdfium::span<const uint8_t> mapping);
+  ~CFX_MappedFileStream() override;
+
+  const pdfium::raw_span<const uint8_t> mapping_;
+  const RetainPtr<CFX_ReadOnlySpanStream> stream_;
+};
+
+#endif  // CORE_FXCRT_CFX_MAPPEDFILESTREAM_POSIX_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/cfx_mappedfilestream_posix.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/utils/file_util.h"
+#include "testing/utils/path_service.h"
+
+TEST(CFXMappedFileStreamTest, Read) {
+  const std::string path = PathService::GetTestFilePath("hello_world.pdf");
+  ASSERT_FALSE(path.empty());
+  const std::vector<uint8_t> contents = GetFileContents(path.c_str());
+  ASSERT_FALSE(contents.empty());
+
+  RetainPtr<CFX_MappedFileStream> stream =
+      CFX_MappedFileStream::Create(path.c_str());
+  ASSERT_TRUE(stream);
+  EXPECT_EQ(static_cast<FX_FILESIZE>(contents.size()), stream->GetSize());
+
+  pdfium::span<const uint8_t> span = stream->GetInMemorySpan();
+  EXPECT_EQ(contents, std::vector<uint8_t>(span.begin(), span.end()));
+
+  std::vector<uint8_t> buffer(10);
+  ASSERT_TRUE(stream->ReadBlockAtOffset(buffer, 5));
+  EXPECT_EQ(std::vector<uint8_t>(contents.begin() + 5, contents.begin() + 15),
+            buffer);
+  EXPECT_FALSE(stream->ReadBlockAtOffset(buffer, stream->GetSize() - 5));
+  EXPECT_FALSE(stream->ReadBlockAtOffset(buffer, -1));
+
+  // Hints do not change what is read.
+  stream->SetAccessPattern(IFX_SeekableReadStream::AccessPattern::kSequential);
+  ASSERT_TRUE(stream->ReadBlockAtOffset(buffer, 0));
+  EXPECT_EQ(std::vector<uint8_t>(contents.begin(), contents.begin() + 10),
+            buffer);
+  stream->SetAccessPattern(IFX_SeekableReadStream::AccessPattern::kNormal);
+}
+
+TEST(CFXMappedFileStreamTest, CannotMap) {
+  EXPECT_FALSE(CFX_MappedFileStream::Create("does/not/exist.pdf"));
+
+  std::string dir;
+  ASSERT_TRUE(PathService::GetTestDataDir(&dir));
+  EXPECT_FALSE(CFX_MappedFileStream::Create(dir.c_str()));
+}
+
+TEST(CFXMappedFileStreamTest, OnlyMappedWhenAsked) {
+  const std::string path = PathService::GetTestFilePath("hello_world.pdf");
+  ASSERT_FALSE(path.empty());
+
+  RetainPtr<IFX_SeekableReadStream> stream =
+      IFX_SeekableReadStream::CreateFromFilename(path.c_str());
+  ASSERT_TRUE(stream);
+  EXPECT_TRUE(stream->GetInMemorySpan().empty());
+
+  stream = IFX_SeekableReadStream::CreateMappedFromFilename(path.c_str());
+  ASSERT_TRUE(stream);
+  EXPECT_FALSE(stream->GetInMemorySpan().empty());
+}
+
+TEST(CFXMappedFileStreamTest, ReadTruncatedFile) {
+  const std::string path = testing::TempDir() + "truncated_file.pdf";
+  const std::vector<uint8_t> contents(8192, 'x');
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(contents.size(), fwrite(contents.data(), 1, contents.size(), file));
+  ASSERT_EQ(0, fclose(file));
+
+  // Files that are not mapped can be truncated while they are read. Reads past
+  // the new end fail, rather than crash like they would with a mapping.
+  RetainPtr<IFX_SeekableReadStream> stream =
+      IFX_SeekableReadStream::CreateFromFilename(path.c_str());
+  ASSERT_TRUE(stream);
+  ASSERT_EQ(0, truncate(path.c_str(), 100));
+
+  std::vector<uint8_t> buffer(10);
+  EXPECT_FALSE(stream->ReadBlockAtOffset(buffer, 4096));
+  ASSERT_TRUE(stream->ReadBlockAtOffset(buffer, 0));
+  EXPECT_EQ(std::vector<uint8_t>(10, 'x'), buffer);
+
+  stream.Reset();
+  EXPECT_EQ(0, unlink(path.c_str()));
+}
@@ -24,3 +24,7 @@ bool CFX_ReadOnlyStringStream::ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                                                  FX_FILESIZE offset) {
   return stream_->ReadBlockAtOffset(buffer, offset);
 }
+
+pdfium::span<const uint8_t> CFX_ReadOnlyStringStream::GetInMemorySpan() {
+  return stream_->GetInMemorySpan();
+}
@@ -19,6 +19,7 @@ class CFX_ReadOnlyStringStream final : public IFX_SeekableReadStream {
   FX_FILESIZE GetSize() override;
   bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                          FX_FILESIZE offset) override;
+  pdfium::span<const uint8_t> GetInMemorySpan() override;
 
  private:
   explicit CFX_ReadOnlyStringStream(ByteString data);
@@ -9,8 +9,13 @@
 #include <memory>
 #include <utility>
 
+#include "build/build_config.h"
 #include "core/fxcrt/fileaccess_iface.h"
 
+#if BUILDFLAG(IS_POSIX) && defined(ARCH_CPU_64_BITS)
+#include "core/fxcrt/cfx_mappedfilestream_posix.h"
+#endif
+
 namespace {
 
 class CFX_CRTFileStream final : public IFX_SeekableStream {
@@ -77,6 +82,20 @@ RetainPtr<IFX_SeekableReadStream> IFX_SeekableReadStream::CreateFromFilename(
   return pdfium::MakeRetain<CFX_CRTFileStream>(std::move(pFA));
 }
 
+// static
+RetainPtr<IFX_SeekableReadStream>
+IFX_SeekableReadStream::CreateMappedFromFilename(const char* filename) {
+#if BUILDFLAG(IS_POSIX) && defined(ARCH_CPU_64_BITS)
+  // Only map files where there is address space to spare for large ones.
+  RetainPtr<IFX_SeekableReadStream> mapped =
+      CFX_MappedFileStream::Create(filename);
+  if (mapped) {
+    return mapped;
+  }
+#endif
+  return CreateFromFilename(filename);
+}
+
 bool IFX_SeekableReadStream::IsEOF() {
   return false;
 }
@@ -84,3 +103,9 @@ bool IFX_SeekableReadStream::IsEOF() {
 FX_FILESIZE IFX_SeekableReadStream::GetPosition() {
   return 0;
 }
+
+pdfium::span<const uint8_t> IFX_SeekableReadStream::GetInMemorySpan() {
+  return {};
+}
+
+void IFX_SeekableReadStream::SetAccessPattern(AccessPattern pattern) {}
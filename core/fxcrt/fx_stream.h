@@ -51,13 +51,30 @@ class IFX_SeekableWriteStream : virtual public IFX_StreamWithSize,
 class IFX_SeekableReadStream : virtual public Retainable,
                                virtual public IFX_StreamWithSize {
  public:
+  enum class AccessPattern : bool { kNormal, kSequential };
+
   static RetainPtr<IFX_SeekableReadStream> CreateFromFilename(
       const char* filename);
 
+  // Same as CreateFromFilename(), but memory-maps `filename` where the
+  // platform supports it. Reading a mapped file that gets truncated crashes,
+  // so only use this for files that do not change while they are open.
+  static RetainPtr<IFX_SeekableReadStream> CreateMappedFromFilename(
+      const char* filename);
+
   virtual bool IsEOF();
   virtual FX_FILESIZE GetPosition();
   [[nodiscard]] virtual bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
                                                FX_FILESIZE offset) = 0;
+
+  // Returns all of the stream's data if it is already in memory that stays
+  // valid for the lifetime of the stream, so callers can read it without
+  // copying. Returns an empty span otherwise.
+  virtual pdfium::span<const uint8_t> GetInMemorySpan();
+
+  // Hints at how the stream is about to be read. Only streams that can make
+  // use of it, like memory-mapped files, do anything with it.
+  virtual void SetAccessPattern(AccessPattern pattern);
 };
 
 class IFX_SeekableStream : public IFX_SeekableReadStream,
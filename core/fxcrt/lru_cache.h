@@ -0,0 +1,191 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCRT_LRU_CACHE_H_
+#define CORE_FXCRT_LRU_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace fxcrt {
+
+struct LruCacheStats {
+  size_t limit = 0;
+  size_t size = 0;
+  size_t count = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+// Values by key, of at most `limit` bytes in total, which drops the least
+// recently used values to stay within that. Callers give the size of each
+// value as they store it.
+//
+// `Map` indexes the values. It defaults to std::map, which the range methods
+// need. Unordered maps such as absl::flat_hash_map work for the rest.
+template <typename Key,
+          typename Value,
+          template <typename...> class Map = std::map>
+class LruCache {
+ public:
+  using Stats = LruCacheStats;
+
+  explicit LruCache(size_t limit) : limit_(limit) {}
+  LruCache(const LruCache&) = delete;
+  LruCache& operator=(const LruCache&) = delete;
+  ~LruCache() = default;
+
+  // Returns the value for `key`, if any, and makes it the most recently used
+  // one. Counts a hit or a miss, unless the cache is off.
+  Value* Lookup(const Key& key) {
+    if (!limit_) {
+      return nullptr;
+    }
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++misses_;
+      return nullptr;
+    }
+    return Touch(it->second);
+  }
+
+  // Returns the value for `key`, if any, leaving the order and the counts as
+  // they are.
+  Value* Peek(const Key& key) {
+    auto it = index_.find(key);
+    return it != index_.end() ? &it->second->value : nullptr;
+  }
+
+  // Like Lookup(), for the first value, in key order from `first` on, for
+  // which `matches(key, value)` holds, among those whose keys are
+  // `in_range(key)`. The keys in range must follow each other.
+  template <typename InRange, typename Matches>
+  Value* LookupInRange(const Key& first, InRange in_range, Matches matches) {
+    if (!limit_) {
+      return nullptr;
+    }
+    for (auto it = index_.lower_bound(first);
+         it != index_.end() && in_range(it->first); ++it) {
+      if (matches(it->first, it->second->value)) {
+        return Touch(it->second);
+      }
+    }
+    ++misses_;
+    return nullptr;
+  }
+
+  // Adds `value` of `size` bytes for `key`, replacing what was there, and
+  // drops the least recently used values to make room. Returns the stored
+  // value, or null if it alone is over the limit.
+  Value* Store(const Key& key, Value value, size_t size) {
+    if (size > limit_) {
+      return nullptr;
+    }
+    Erase(key);
+    entries_.emplace_front(key, std::move(value), size);
+    index_.emplace(key, entries_.begin());
+    size_ += size;
+    EvictToLimit();
+    return &entries_.front().value;
+  }
+
+  void Erase(const Key& key) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      Erase(it->second);
+    }
+  }
+
+  // Drops the values whose keys are `in_range(key)`, in key order from
+  // `first` on. The keys in range must follow each other.
+  template <typename InRange>
+  void EraseRange(const Key& first, InRange in_range) {
+    auto it = index_.lower_bound(first);
+    while (it != index_.end() && in_range(it->first)) {
+      auto entry = it->second;
+      ++it;
+      Erase(entry);
+    }
+  }
+
+  // Drops the values for which `pred(key, value)` holds. Visits all of them.
+  template <typename Pred>
+  void EraseIf(Pred pred) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      auto entry = it++;
+      if (pred(entry->key, entry->value)) {
+        Erase(entry);
+      }
+    }
+  }
+
+  // 0 turns the cache off.
+  void SetLimit(size_t limit) {
+    limit_ = limit;
+    EvictToLimit();
+  }
+
+  size_t limit() const { return limit_; }
+  size_t size() const { return size_; }
+
+  Stats GetStats() const {
+    Stats stats;
+    stats.limit = limit_;
+    stats.size = size_;
+    stats.count = entries_.size();
+    stats.hits = hits_;
+    stats.misses = misses_;
+    return stats;
+  }
+
+ private:
+  struct Entry {
+    Entry(const Key& key, Value value, size_t size)
+        : key(key), value(std::move(value)), size(size) {}
+
+    Key key;
+    Value value;
+    size_t size;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  Value* Touch(typename EntryList::iterator entry) {
+    entries_.splice(entries_.begin(), entries_, entry);
+    ++hits_;
+    return &entry->value;
+  }
+
+  void Erase(typename EntryList::iterator entry) {
+    size_ -= entry->size;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+  }
+
+  void EvictToLimit() {
+    while (size_ > limit_) {
+      Erase(std::prev(entries_.end()));
+    }
+  }
+
+  size_t limit_;
+  size_t size_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  // Most recently used first.
+  EntryList entries_;
+  Map<Key, typename EntryList::iterator> index_;
+};
+
+}  // namespace fxcrt
+
+using fxcrt::LruCache;
+using fxcrt::LruCacheStats;
+
+#endif  // CORE_FXCRT_LRU_CACHE_H_
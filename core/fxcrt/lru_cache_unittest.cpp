@@ -0,0 +1,131 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/lru_cache.h"
+
+#include <string>
+#include <utility>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+namespace fxcrt {
+
+TEST(LruCache, LookupAndStats) {
+  LruCache<int, std::string> cache(100);
+  EXPECT_FALSE(cache.Lookup(1));
+
+  std::string* stored = cache.Store(1, "one", 10);
+  ASSERT_TRUE(stored);
+  EXPECT_EQ("one", *stored);
+  std::string* found = cache.Lookup(1);
+  ASSERT_TRUE(found);
+  EXPECT_EQ("one", *found);
+  EXPECT_FALSE(cache.Lookup(2));
+
+  // Replaces what was there.
+  cache.Store(1, "uno", 20);
+  EXPECT_EQ("uno", *cache.Lookup(1));
+
+  LruCache<int, std::string>::Stats stats = cache.GetStats();
+  EXPECT_EQ(100u, stats.limit);
+  EXPECT_EQ(20u, stats.size);
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+
+  cache.Erase(1);
+  cache.Erase(2);
+  stats = cache.GetStats();
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_EQ(0u, stats.count);
+}
+
+TEST(LruCache, EvictsLeastRecentlyUsed) {
+  LruCache<int, std::string> cache(30);
+  cache.Store(1, "one", 10);
+  cache.Store(2, "two", 10);
+  cache.Store(3, "three", 10);
+  EXPECT_TRUE(cache.Lookup(1));
+
+  // Makes room by dropping 2, which was used longest ago.
+  cache.Store(4, "four", 10);
+  EXPECT_EQ(30u, cache.size());
+  EXPECT_TRUE(cache.Lookup(1));
+  EXPECT_FALSE(cache.Lookup(2));
+  EXPECT_TRUE(cache.Lookup(3));
+  EXPECT_TRUE(cache.Lookup(4));
+
+  // Too large on its own, which keeps what was there.
+  EXPECT_FALSE(cache.Store(4, "four", 31));
+  EXPECT_TRUE(cache.Lookup(4));
+
+  // 1 was used longest ago now.
+  cache.SetLimit(20);
+  EXPECT_EQ(2u, cache.GetStats().count);
+  EXPECT_FALSE(cache.Lookup(1));
+
+  // Off, without counting lookups.
+  cache.SetLimit(0);
+  EXPECT_EQ(0u, cache.GetStats().count);
+  const uint64_t misses = cache.GetStats().misses;
+  EXPECT_FALSE(cache.Store(1, "one", 1));
+  EXPECT_FALSE(cache.Lookup(1));
+  EXPECT_EQ(misses, cache.GetStats().misses);
+}
+
+TEST(LruCache, Ranges) {
+  using Key = std::pair<int, int>;
+  LruCache<Key, int> cache(100);
+  cache.Store({1, 1}, 11, 1);
+  cache.Store({1, 2}, 12, 1);
+  cache.Store({1, 3}, 13, 1);
+  cache.Store({2, 1}, 21, 1);
+  auto is_1 = [](const Key& key) { return key.first == 1; };
+
+  int* found = cache.LookupInRange(
+      {1, 0}, is_1, [](const Key& key, int value) { return value > 11; });
+  ASSERT_TRUE(found);
+  EXPECT_EQ(12, *found);
+  EXPECT_FALSE(cache.LookupInRange(
+      {1, 0}, is_1, [](const Key& key, int value) { return value > 13; }));
+  EXPECT_EQ(1u, cache.GetStats().hits);
+  EXPECT_EQ(1u, cache.GetStats().misses);
+
+  cache.EraseRange({1, 0}, is_1);
+  EXPECT_EQ(1u, cache.GetStats().count);
+  EXPECT_TRUE(cache.Lookup({2, 1}));
+}
+
+TEST(LruCache, EraseIf) {
+  LruCache<int, int, absl::flat_hash_map> cache(100);
+  for (int i = 0; i < 10; ++i) {
+    cache.Store(i, i * i, 1);
+  }
+  cache.EraseIf([](int key, int value) { return key % 2 || value > 40; });
+  EXPECT_EQ(4u, cache.GetStats().count);
+  EXPECT_EQ(4u, cache.size());
+  EXPECT_TRUE(cache.Lookup(6));
+  EXPECT_FALSE(cache.Lookup(7));
+  EXPECT_FALSE(cache.Lookup(8));
+}
+
+TEST(LruCache, Peek) {
+  LruCache<int, std::string> cache(20);
+  cache.Store(1, "one", 10);
+  cache.Store(2, "two", 10);
+  std::string* found = cache.Peek(1);
+  ASSERT_TRUE(found);
+  EXPECT_EQ("one", *found);
+  EXPECT_FALSE(cache.Peek(3));
+  EXPECT_EQ(0u, cache.GetStats().hits);
+  EXPECT_EQ(0u, cache.GetStats().misses);
+
+  // 1 is still the least recently used.
+  cache.Store(3, "three", 10);
+  EXPECT_FALSE(cache.Peek(1));
+  EXPECT_TRUE(cache.Peek(2));
+}
+
+}  // namespace fxcrt
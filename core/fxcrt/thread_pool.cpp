@@ -0,0 +1,376 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/thread_pool.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "core/fxcrt/autorestorer.h"
+#include "core/fxcrt/check.h"
+
+namespace fxcrt {
+
+namespace {
+
+ThreadPool* g_thread_pool = nullptr;
+
+// Set on worker threads, so tasks they post go to their own queue.
+thread_local ThreadPool* g_current_pool = nullptr;
+thread_local size_t g_current_worker = 0;
+
+// How many ParallelFor() items that share their call with other threads the
+// current thread is in.
+thread_local size_t g_parallel_items_depth = 0;
+
+// Whether the ParallelFor() item the current thread runs belongs to a call
+// that this thread made.
+thread_local bool g_on_calling_thread = false;
+
+// The state of one Run() call. Tasks that only start after the call returned
+// find no items left, and then touch nothing but this, which they keep alive.
+struct ParallelForState {
+  ParallelForState(size_t count, const std::function<void(size_t)>* fn)
+      : count(count), fn(fn) {}
+
+  const size_t count;
+  const std::function<void(size_t)>* const fn;
+  std::atomic<size_t> next_index = 0;
+
+  std::mutex lock;
+  std::condition_variable all_done;
+  size_t done_count = 0;
+};
+
+void RunParallelForItems(ParallelForState& state, bool on_calling_thread) {
+  AutoRestorer<bool> restorer(&g_on_calling_thread);
+  g_on_calling_thread = on_calling_thread;
+  size_t done = 0;
+  ++g_parallel_items_depth;
+  for (size_t i = state.next_index++; i < state.count;
+       i = state.next_index++) {
+    (*state.fn)(i);
+    ++done;
+  }
+  --g_parallel_items_depth;
+  if (done == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(state.lock);
+  state.done_count += done;
+  if (state.done_count == state.count) {
+    state.all_done.notify_all();
+  }
+}
+
+// Runs all items on the calling thread, which takes them all itself.
+void RunAllItems(size_t count, const std::function<void(size_t)>& fn) {
+  AutoRestorer<bool> restorer(&g_on_calling_thread);
+  g_on_calling_thread = true;
+  for (size_t i = 0; i < count; ++i) {
+    fn(i);
+  }
+}
+
+void RunExecutorTask(void* task_data) {
+  std::unique_ptr<std::function<void()>> task(
+      static_cast<std::function<void()>*>(task_data));
+  (*task)();
+}
+
+}  // namespace
+
+// The state of one Start() call. Tasks that only start after all items were
+// claimed touch nothing but this, which they keep alive.
+struct ThreadPool::BatchState {
+  enum class ItemState : uint8_t { kPending, kRunning, kDone };
+
+  BatchState(size_t count, std::function<void(size_t)> fn)
+      : fn(std::move(fn)), items(count, ItemState::kPending) {}
+
+  // Returns whether the current thread gets to run item `index`.
+  bool Claim(size_t index) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (items[index] != ItemState::kPending) {
+      return false;
+    }
+    items[index] = ItemState::kRunning;
+    return true;
+  }
+
+  void RunItem(size_t index, bool on_calling_thread) {
+    {
+      AutoRestorer<bool> restorer(&g_on_calling_thread);
+      g_on_calling_thread = on_calling_thread;
+      ++g_parallel_items_depth;
+      fn(index);
+      --g_parallel_items_depth;
+    }
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      items[index] = ItemState::kDone;
+    }
+    item_done.notify_all();
+  }
+
+  // What tasks do: take items in order, skipping those that Wait() took.
+  void RunItems() {
+    for (size_t i = next_index++; i < items.size(); i = next_index++) {
+      if (Claim(i)) {
+        RunItem(i, false);
+      }
+    }
+  }
+
+  const std::function<void(size_t)> fn;
+  std::atomic<size_t> next_index = 0;
+
+  std::mutex lock;
+  std::condition_variable item_done;
+  // Guarded by `lock`, apart from its size.
+  std::vector<ItemState> items;
+};
+
+ThreadPool::Batch::Batch(std::shared_ptr<BatchState> state)
+    : state_(std::move(state)) {}
+
+ThreadPool::Batch::Batch(Batch&&) = default;
+
+ThreadPool::Batch::~Batch() {
+  if (!state_) {
+    return;
+  }
+  for (size_t i = 0; i < state_->items.size(); ++i) {
+    Wait(i);
+  }
+}
+
+void ThreadPool::Batch::Wait(size_t index) {
+  if (state_->Claim(index)) {
+    state_->RunItem(index, true);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(state_->lock);
+  state_->item_done.wait(lock, [this, index] {
+    return state_->items[index] == BatchState::ItemState::kDone;
+  });
+}
+
+// static
+void ThreadPool::Create(const Options& options) {
+  DCHECK(!g_thread_pool);
+  g_thread_pool = new ThreadPool(options);
+}
+
+// static
+void ThreadPool::Destroy() {
+  DCHECK(g_thread_pool);
+  delete g_thread_pool;
+  g_thread_pool = nullptr;
+}
+
+// static
+ThreadPool* ThreadPool::Get() {
+  return g_thread_pool;
+}
+
+// static
+void ThreadPool::ParallelFor(size_t count,
+                             const std::function<void(size_t)>& fn) {
+  if (g_thread_pool) {
+    g_thread_pool->Run(count, fn);
+    return;
+  }
+  RunAllItems(count, fn);
+}
+
+// static
+bool ThreadPool::IsCallingThread() {
+  return g_on_calling_thread;
+}
+
+// static
+bool ThreadPool::IsPoolThread() {
+  return !!g_current_pool;
+}
+
+// static
+size_t ThreadPool::GetMaxConcurrency() {
+  return g_thread_pool ? g_thread_pool->max_concurrency() : 1;
+}
+
+// static
+size_t ThreadPool::GetMaxLibraryThreads() {
+  return g_thread_pool ? g_thread_pool->max_library_threads() : 1;
+}
+
+size_t ThreadPool::max_library_threads() const {
+  return post_task_ || g_parallel_items_depth ? 1 : max_concurrency_;
+}
+
+ThreadPool::ThreadPool(const Options& options)
+    : max_concurrency_(
+          options.max_threads
+              ? options.max_threads
+              : std::max<size_t>(std::thread::hardware_concurrency(), 1)),
+      post_task_(options.post_task),
+      executor_context_(options.executor_context) {
+  if (post_task_) {
+    return;
+  }
+  // The thread that calls Run() is the remaining one.
+  for (size_t i = 1; i < max_concurrency_; ++i) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  worker_only_tasks_.resize(queues_.size());
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wake_lock_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& fn) {
+  const size_t helper_count = std::min(count, max_concurrency_);
+  if (helper_count <= 1) {
+    RunAllItems(count, fn);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>(count, &fn);
+  for (size_t i = 1; i < helper_count; ++i) {
+    PostTask([state] { RunParallelForItems(*state, false); });
+  }
+  RunParallelForItems(*state, true);
+
+  std::unique_lock<std::mutex> lock(state->lock);
+  state->all_done.wait(lock,
+                       [&state] { return state->done_count == state->count; });
+}
+
+ThreadPool::Batch ThreadPool::Start(size_t count,
+                                    std::function<void(size_t)> fn) {
+  auto state = std::make_shared<BatchState>(count, std::move(fn));
+  // The calling thread gets on with other work, so it leaves the items to all
+  // the other threads.
+  const size_t helper_count = std::min(count, max_concurrency_ - 1);
+  for (size_t i = 0; i < helper_count; ++i) {
+    PostTask([state] { state->RunItems(); });
+  }
+  return Batch(std::move(state));
+}
+
+void ThreadPool::PostToEachWorker(const std::function<void()>& fn) {
+  {
+    std::lock_guard<std::mutex> lock(wake_lock_);
+    if (!workers_started_) {
+      return;
+    }
+    for (std::deque<Task>& tasks : worker_only_tasks_) {
+      tasks.push_back(fn);
+    }
+  }
+  wake_.notify_all();
+}
+
+void ThreadPool::PostTask(Task task) {
+  if (post_task_) {
+    post_task_(executor_context_, &RunExecutorTask,
+               std::make_unique<Task>(std::move(task)).release());
+    return;
+  }
+
+  std::call_once(start_workers_once_, &ThreadPool::StartWorkers, this);
+  size_t index;
+  if (g_current_pool == this) {
+    index = g_current_worker;
+  } else {
+    std::lock_guard<std::mutex> lock(wake_lock_);
+    index = next_queue_++ % queues_.size();
+  }
+  {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.lock);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_lock_);
+    ++unclaimed_tasks_;
+  }
+  wake_.notify_one();
+}
+
+void ThreadPool::StartWorkers() {
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    workers_.emplace_back(&ThreadPool::WorkerMain, this, i);
+  }
+  std::lock_guard<std::mutex> lock(wake_lock_);
+  workers_started_ = true;
+}
+
+void ThreadPool::WorkerMain(size_t index) {
+  g_current_pool = this;
+  g_current_worker = index;
+  std::deque<Task>& own_tasks = worker_only_tasks_[index];
+  while (true) {
+    Task own_task;
+    {
+      std::unique_lock<std::mutex> lock(wake_lock_);
+      wake_.wait(lock, [this, &own_tasks] {
+        return stopping_ || unclaimed_tasks_ > 0 || !own_tasks.empty();
+      });
+      if (!own_tasks.empty()) {
+        own_task = std::move(own_tasks.front());
+        own_tasks.pop_front();
+      } else if (unclaimed_tasks_ == 0) {
+        return;
+      } else {
+        --unclaimed_tasks_;
+      }
+    }
+    if (own_task) {
+      own_task();
+    } else {
+      TakeTask(index)();
+    }
+  }
+}
+
+ThreadPool::Task ThreadPool::TakeTask(size_t index) {
+  // Tasks are queued before they count as unclaimed, so the caller's claim
+  // guarantees that one is waiting somewhere, though other workers may get to
+  // the first ones this looks at.
+  while (true) {
+    for (size_t i = 0; i < queues_.size(); ++i) {
+      WorkerQueue& queue = *queues_[(index + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.lock);
+      if (queue.tasks.empty()) {
+        continue;
+      }
+      // Newest first from the own queue, oldest first from others.
+      Task task;
+      if (i == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      return task;
+    }
+  }
+}
+
+}  // namespace fxcrt
@@ -0,0 +1,167 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXCRT_THREAD_POOL_H_
+#define CORE_FXCRT_THREAD_POOL_H_
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fxcrt {
+
+// A pool of worker threads for all of PDFium's parallel work, so that
+// independent features together stay within one bound instead of each
+// starting threads of their own. Every worker has its own deque of tasks. It
+// runs the newest task in its own deque first, and once that is empty, steals
+// the oldest task from another worker. Workers start on first use.
+//
+// An embedder may instead supply an executor, which then receives every task,
+// and the pool starts no threads at all.
+//
+// Callers of ParallelFor() take part in the work themselves, so tasks that
+// never get to run only cost parallelism, never correctness.
+class ThreadPool {
+ public:
+  // Must eventually call `task(task_data)` exactly once, on any thread.
+  using PostTaskCallback = void (*)(void* executor_context,
+                                    void (*task)(void* task_data),
+                                    void* task_data);
+
+  struct Options {
+    // The most threads that work on one ParallelFor() call, counting the
+    // calling thread. 0 means one per CPU core. The default of 1 starts no
+    // threads, so parallel work only happens when asked for.
+    size_t max_threads = 1;
+
+    // Optional executor, called with `executor_context`.
+    PostTaskCallback post_task = nullptr;
+    void* executor_context = nullptr;
+  };
+
+  // Sets up the process-wide pool. Until then, and after Destroy(),
+  // ParallelFor() runs everything on the calling thread.
+  static void Create(const Options& options);
+  static void Destroy();
+  static ThreadPool* Get();
+
+  // Calls `fn(i)` for every `i` in [0, `count`) on the process-wide pool, and
+  // returns once all the calls have finished. Calls may run concurrently and
+  // in any order. May be nested.
+  static void ParallelFor(size_t count,
+                          const std::function<void(size_t)>& fn);
+
+  // Whether the ParallelFor() item that runs on the current thread is one that
+  // the thread that called ParallelFor() takes itself. False for the items of
+  // tasks, even where an executor runs those on the calling thread.
+  static bool IsCallingThread();
+
+  // Whether the current thread is one that a pool started, and that ends when
+  // that pool is destroyed.
+  static bool IsPoolThread();
+
+  // The most threads ParallelFor() uses, counting the calling thread.
+  static size_t GetMaxConcurrency();
+
+  // The most threads that third-party code with threads of its own, such as a
+  // codec, should use for one call. 1 when an embedder supplied an executor,
+  // which only expects the threads it runs tasks on, and within a ParallelFor()
+  // call that runs on several threads, whose other calls already use them.
+  static size_t GetMaxLibraryThreads();
+
+  // Only defined in the .cpp file.
+  struct BatchState;
+
+  // Items that run in the background while the thread that started them gets
+  // on with other work. See Start().
+  class Batch {
+   public:
+    Batch(Batch&&);
+    Batch& operator=(Batch&&) = delete;
+    // Waits for all items.
+    ~Batch();
+
+    // Returns once item `index` has finished. Runs it on the current thread
+    // if no other thread has started it yet.
+    void Wait(size_t index);
+
+   private:
+    friend class ThreadPool;
+
+    explicit Batch(std::shared_ptr<BatchState> state);
+
+    std::shared_ptr<BatchState> state_;
+  };
+
+  explicit ThreadPool(const Options& options);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  // Waits for the workers to run all queued tasks. Tasks handed to an
+  // executor must have run already.
+  ~ThreadPool();
+
+  // Like the static ParallelFor(), but on this pool.
+  void Run(size_t count, const std::function<void(size_t)>& fn);
+
+  // Like Run(), but returns without running any items, so that the caller can
+  // use each result once Batch::Wait() says it is ready. Other threads take
+  // the items in order. Items that no thread got to by the time they are
+  // waited for run on the waiting thread, so tasks that never get to run
+  // still only cost parallelism.
+  Batch Start(size_t count, std::function<void(size_t)> fn);
+
+  // Has every thread the pool started run `fn` once, for state that each of
+  // them keeps for itself, and returns without waiting. Threads that have not
+  // started yet, and the threads of an executor, are left out.
+  void PostToEachWorker(const std::function<void()>& fn);
+
+  size_t max_concurrency() const { return max_concurrency_; }
+  // Like the static GetMaxLibraryThreads(), but for this pool.
+  size_t max_library_threads() const;
+
+ private:
+  using Task = std::function<void()>;
+
+  struct WorkerQueue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  void PostTask(Task task);
+  void StartWorkers();
+  void WorkerMain(size_t index);
+  Task TakeTask(size_t index);
+
+  const size_t max_concurrency_;
+  const PostTaskCallback post_task_;
+  void* const executor_context_;
+
+  std::once_flag start_workers_once_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+
+  // Guards the members below, and is what idle workers wait on.
+  std::mutex wake_lock_;
+  std::condition_variable wake_;
+  // Tasks in `queues_` that no worker has claimed yet.
+  size_t unclaimed_tasks_ = 0;
+  size_t next_queue_ = 0;
+  bool workers_started_ = false;
+  bool stopping_ = false;
+  // Tasks from PostToEachWorker(), which only the worker of the same index
+  // may run.
+  std::vector<std::deque<Task>> worker_only_tasks_;
+};
+
+}  // namespace fxcrt
+
+using fxcrt::ThreadPool;
+
+#endif  // CORE_FXCRT_THREAD_POOL_H_
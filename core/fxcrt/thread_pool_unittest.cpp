@@ -0,0 +1,316 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxcrt/thread_pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+struct PostedTask {
+  void (*task)(void*);
+  void* task_data;
+};
+
+void RecordTask(void* executor_context,
+                void (*task)(void* task_data),
+                void* task_data) {
+  static_cast<std::vector<PostedTask>*>(executor_context)
+      ->push_back({task, task_data});
+}
+
+void RunTaskNow(void* executor_context,
+                void (*task)(void* task_data),
+                void* task_data) {
+  task(task_data);
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, RunsEveryIndexOnce) {
+  ThreadPool pool({.max_threads = 4});
+  EXPECT_EQ(4u, pool.max_concurrency());
+
+  std::vector<std::atomic<int>> calls(1000);
+  pool.Run(calls.size(), [&calls](size_t i) { ++calls[i]; });
+  for (const std::atomic<int>& count : calls) {
+    EXPECT_EQ(1, count.load());
+  }
+
+  // Again, now that the workers are running.
+  pool.Run(calls.size(), [&calls](size_t i) { ++calls[i]; });
+  for (const std::atomic<int>& count : calls) {
+    EXPECT_EQ(2, count.load());
+  }
+
+  pool.Run(0, [](size_t) { ADD_FAILURE(); });
+}
+
+TEST(ThreadPoolTest, DefaultsToCallingThread) {
+  ThreadPool pool(ThreadPool::Options{});
+  EXPECT_EQ(1u, pool.max_concurrency());
+  EXPECT_EQ(1u, pool.max_library_threads());
+
+  const std::thread::id caller = std::this_thread::get_id();
+  pool.Run(10, [caller](size_t) {
+    EXPECT_EQ(caller, std::this_thread::get_id());
+  });
+}
+
+TEST(ThreadPoolTest, RunsConcurrently) {
+  ThreadPool pool({.max_threads = 2});
+  EXPECT_EQ(2u, pool.max_library_threads());
+
+  // Each call waits for the other, so this only finishes when they run on
+  // two threads at once.
+  std::atomic<int> started = 0;
+  pool.Run(2, [&started](size_t) {
+    ++started;
+    while (started.load() < 2) {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(2, started.load());
+}
+
+TEST(ThreadPoolTest, Nested) {
+  ThreadPool pool({.max_threads = 3});
+
+  std::vector<std::atomic<int>> calls(8 * 8);
+  pool.Run(8, [&pool, &calls](size_t i) {
+    pool.Run(8, [&calls, i](size_t j) { ++calls[i * 8 + j]; });
+  });
+  for (const std::atomic<int>& count : calls) {
+    EXPECT_EQ(1, count.load());
+  }
+}
+
+TEST(ThreadPoolTest, LibraryThreadsWithinRun) {
+  ThreadPool pool({.max_threads = 4});
+  EXPECT_EQ(4u, pool.max_library_threads());
+
+  // Codecs called from items that run side by side get no threads of their
+  // own, on the calling thread as well as on the workers.
+  std::vector<size_t> library_threads(8);
+  pool.Run(library_threads.size(), [&pool, &library_threads](size_t i) {
+    library_threads[i] = pool.max_library_threads();
+  });
+  for (size_t threads : library_threads) {
+    EXPECT_EQ(1u, threads);
+  }
+  EXPECT_EQ(4u, pool.max_library_threads());
+
+  // A single item has the pool to itself.
+  pool.Run(1, [&pool, &library_threads](size_t i) {
+    library_threads[i] = pool.max_library_threads();
+  });
+  EXPECT_EQ(4u, library_threads[0]);
+}
+
+TEST(ThreadPoolTest, SingleThread) {
+  std::vector<PostedTask> tasks;
+  ThreadPool pool({.max_threads = 1,
+                   .post_task = RecordTask,
+                   .executor_context = &tasks});
+
+  const std::thread::id caller = std::this_thread::get_id();
+  std::set<std::thread::id> threads;
+  pool.Run(10,
+           [&threads](size_t) { threads.insert(std::this_thread::get_id()); });
+  EXPECT_EQ(std::set<std::thread::id>{caller}, threads);
+  EXPECT_TRUE(tasks.empty());
+}
+
+TEST(ThreadPoolTest, Executor) {
+  std::vector<PostedTask> tasks;
+  ThreadPool pool({.max_threads = 4,
+                   .post_task = RecordTask,
+                   .executor_context = &tasks});
+  EXPECT_EQ(4u, pool.max_concurrency());
+  EXPECT_EQ(1u, pool.max_library_threads());
+
+  // The executor never runs tasks during Run(), so the calling thread does
+  // all the work.
+  std::vector<int> calls(100);
+  pool.Run(calls.size(), [&calls](size_t i) { ++calls[i]; });
+  for (int count : calls) {
+    EXPECT_EQ(1, count);
+  }
+
+  // Tasks that run late find nothing left to do.
+  EXPECT_EQ(3u, tasks.size());
+  for (const PostedTask& task : tasks) {
+    task.task(task.task_data);
+  }
+  for (int count : calls) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST(ThreadPoolTest, ExecutorOnOtherThreads) {
+  std::vector<PostedTask> tasks;
+  ThreadPool pool({.max_threads = 3,
+                   .post_task = RecordTask,
+                   .executor_context = &tasks});
+
+  // The calling thread takes the first item, then hands the posted task to a
+  // thread of the test's own, and waits for it to take the other item.
+  std::vector<std::thread> threads;
+  std::atomic<int> calls = 0;
+  pool.Run(2, [&](size_t i) {
+    if (i == 0) {
+      for (const PostedTask& task : tasks) {
+        threads.emplace_back(task.task, task.task_data);
+      }
+      while (calls.load() == 0) {
+        std::this_thread::yield();
+      }
+    } else {
+      ++calls;
+    }
+  });
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(1, calls.load());
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+  // Whether or not the process-wide pool exists.
+  std::vector<std::atomic<int>> calls(100);
+  ThreadPool::ParallelFor(calls.size(), [&calls](size_t i) { ++calls[i]; });
+  for (const std::atomic<int>& count : calls) {
+    EXPECT_EQ(1, count.load());
+  }
+  EXPECT_GE(ThreadPool::GetMaxConcurrency(), 1u);
+  EXPECT_GE(ThreadPool::GetMaxLibraryThreads(), 1u);
+}
+
+TEST(ThreadPoolTest, CallingThread) {
+  EXPECT_FALSE(ThreadPool::IsCallingThread());
+  EXPECT_FALSE(ThreadPool::IsPoolThread());
+
+  ThreadPool serial_pool(ThreadPool::Options{});
+  serial_pool.Run(3,
+                  [](size_t) { EXPECT_TRUE(ThreadPool::IsCallingThread()); });
+
+  ThreadPool pool({.max_threads = 4});
+  const std::thread::id caller = std::this_thread::get_id();
+  pool.Run(1000, [caller](size_t) {
+    const bool on_caller = std::this_thread::get_id() == caller;
+    EXPECT_EQ(on_caller, ThreadPool::IsCallingThread());
+    EXPECT_EQ(!on_caller, ThreadPool::IsPoolThread());
+  });
+
+  // Tasks that an executor runs right away, on the calling thread, are still
+  // tasks. Here, they take all the items before the calling thread gets to
+  // any.
+  ThreadPool inline_pool({.max_threads = 2, .post_task = RunTaskNow});
+  serial_pool.Run(1, [&inline_pool](size_t) {
+    inline_pool.Run(4, [](size_t) {
+      EXPECT_FALSE(ThreadPool::IsCallingThread());
+      EXPECT_FALSE(ThreadPool::IsPoolThread());
+    });
+    EXPECT_TRUE(ThreadPool::IsCallingThread());
+  });
+  EXPECT_FALSE(ThreadPool::IsCallingThread());
+}
+
+TEST(ThreadPoolTest, Batch) {
+  ThreadPool pool({.max_threads = 4});
+  std::vector<std::atomic<int>> calls(1000);
+  std::vector<size_t> results(calls.size());
+  {
+    ThreadPool::Batch batch =
+        pool.Start(calls.size(), [&calls, &results](size_t i) {
+          ++calls[i];
+          results[i] = i * i;
+        });
+    for (size_t i = 0; i < calls.size(); i += 2) {
+      batch.Wait(i);
+      EXPECT_EQ(i * i, results[i]);
+    }
+  }
+  // The rest finished before the batch went away.
+  for (size_t i = 0; i < calls.size(); ++i) {
+    EXPECT_EQ(1, calls[i]);
+    EXPECT_EQ(i * i, results[i]);
+  }
+}
+
+TEST(ThreadPoolTest, BatchWithoutHelp) {
+  std::vector<PostedTask> tasks;
+  ThreadPool pool({.max_threads = 3,
+                   .post_task = RecordTask,
+                   .executor_context = &tasks});
+  std::vector<int> calls(10);
+  {
+    // The executor never runs tasks, so waiting runs items on this thread.
+    ThreadPool::Batch batch = pool.Start(calls.size(), [&calls](size_t i) {
+      EXPECT_TRUE(ThreadPool::IsCallingThread());
+      ++calls[i];
+    });
+    batch.Wait(5);
+    EXPECT_EQ(1, calls[5]);
+    EXPECT_EQ(0, calls[4]);
+  }
+  for (int count : calls) {
+    EXPECT_EQ(1, count);
+  }
+
+  // Tasks that run late find nothing left to do.
+  EXPECT_EQ(2u, tasks.size());
+  for (const PostedTask& task : tasks) {
+    task.task(task.task_data);
+  }
+  for (int count : calls) {
+    EXPECT_EQ(1, count);
+  }
+
+  // A pool of one thread leaves all the items to Wait().
+  ThreadPool serial_pool(ThreadPool::Options{});
+  ThreadPool::Batch batch = serial_pool.Start(calls.size(), [&calls](size_t i) {
+    ++calls[i];
+  });
+  batch.Wait(0);
+  EXPECT_EQ(2, calls[0]);
+  EXPECT_EQ(1, calls[1]);
+}
+
+TEST(ThreadPoolTest, PostToEachWorker) {
+  std::mutex lock;
+  std::vector<std::thread::id> threads;
+  auto record_thread = [&lock, &threads] {
+    EXPECT_TRUE(ThreadPool::IsPoolThread());
+    std::lock_guard<std::mutex> guard(lock);
+    threads.push_back(std::this_thread::get_id());
+  };
+  {
+    ThreadPool pool({.max_threads = 4});
+    // No worker has started yet, so nothing runs this.
+    pool.PostToEachWorker(record_thread);
+    pool.Run(100, [](size_t) {});
+    pool.PostToEachWorker(record_thread);
+    pool.PostToEachWorker(record_thread);
+  }
+  // The workers ran their tasks before the pool went away.
+  ASSERT_EQ(6u, threads.size());
+  const std::set<std::thread::id> distinct(threads.begin(), threads.end());
+  EXPECT_EQ(3u, distinct.size());
+  EXPECT_FALSE(distinct.count(std::this_thread::get_id()));
+
+  std::vector<PostedTask> tasks;
+  ThreadPool executor_pool({.max_threads = 3,
+                            .post_task = RecordTask,
+                            .executor_context = &tasks});
+  executor_pool.PostToEachWorker(record_thread);
+  EXPECT_TRUE(tasks.empty());
+}
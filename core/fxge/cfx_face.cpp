@@ -433,12 +433,12 @@ int CFX_Face::GetGlyphCount() const {
   return pdfium::checked_cast<int>(GetRec()->num_glyphs);
 }
 
-std::unique_ptr<CFX_GlyphBitmap> CFX_Face::RenderGlyph(const CFX_Font* font,
-                                                       uint32_t glyph_index,
-                                                       bool bFontStyle,
-                                                       const CFX_Matrix& matrix,
-                                                       int dest_width,
-                                                       int anti_alias) {
+RetainPtr<CFX_GlyphBitmap> CFX_Face::RenderGlyph(const CFX_Font* font,
+                                                 uint32_t glyph_index,
+                                                 bool bFontStyle,
+                                                 const CFX_Matrix& matrix,
+                                                 int dest_width,
+                                                 int anti_alias) {
   FT_Matrix ft_matrix;
   ft_matrix.xx = matrix.a / 64 * 65536;
   ft_matrix.xy = matrix.c / 64 * 65536;
@@ -522,8 +522,8 @@ std::unique_ptr<CFX_GlyphBitmap> CFX_Face::RenderGlyph(const CFX_Font* font,
     return nullptr;
   }
   int dib_width = bitmap.width;
-  auto pGlyphBitmap =
-      std::make_unique<CFX_GlyphBitmap>(glyph->bitmap_left, glyph->bitmap_top);
+  auto pGlyphBitmap = pdfium::MakeRetain<CFX_GlyphBitmap>(glyph->bitmap_left,
+                                                          glyph->bitmap_top);
   const FXDIB_Format format = anti_alias == FT_RENDER_MODE_MONO
                                   ? FXDIB_Format::k1bppMask
                                   : FXDIB_Format::k8bppMask;
@@ -98,12 +98,12 @@ class CFX_Face final : public Retainable, public Observable {
   int GetGlyphCount() const;
   // TODO(crbug.com/pdfium/2037): Can this method be private?
   FX_RECT GetGlyphBBox() const;
-  std::unique_ptr<CFX_GlyphBitmap> RenderGlyph(const CFX_Font* font,
-                                               uint32_t glyph_index,
-                                               bool bFontStyle,
-                                               const CFX_Matrix& matrix,
-                                               int dest_width,
-                                               int anti_alias);
+  RetainPtr<CFX_GlyphBitmap> RenderGlyph(const CFX_Font* font,
+                                         uint32_t glyph_index,
+                                         bool bFontStyle,
+                                         const CFX_Matrix& matrix,
+                                         int dest_width,
+                                         int anti_alias);
   std::unique_ptr<CFX_Path> LoadGlyphPath(uint32_t glyph_index,
                                           int dest_width,
                                           bool is_vertical,
@@ -26,6 +26,7 @@
 #include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/cfx_fontmgr.h"
 #include "core/fxge/cfx_gemodule.h"
+#include "core/fxge/cfx_glyphbitmap.h"
 #include "core/fxge/cfx_glyphcache.h"
 #include "core/fxge/cfx_path.h"
 #include "core/fxge/cfx_substfont.h"
@@ -487,7 +488,7 @@ std::unique_ptr<CFX_Path> CFX_Font::LoadGlyphPathImpl(uint32_t glyph_index,
                               subst_font_.get());
 }
 
-const CFX_GlyphBitmap* CFX_Font::LoadGlyphBitmap(
+RetainPtr<const CFX_GlyphBitmap> CFX_Font::LoadGlyphBitmap(
     uint32_t glyph_index,
     bool bFontStyle,
     const CFX_Matrix& matrix,
@@ -87,7 +87,7 @@ class CFX_Font {
 #endif  // !BUILDFLAG(IS_WIN)
 #endif  // defined(PDF_ENABLE_XFA)
 
-  const CFX_GlyphBitmap* LoadGlyphBitmap(
+  RetainPtr<const CFX_GlyphBitmap> LoadGlyphBitmap(
       uint32_t glyph_index,
       bool bFontStyle,
       const CFX_Matrix& matrix,
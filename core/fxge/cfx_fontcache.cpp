@@ -10,7 +10,8 @@
 #include "core/fxge/cfx_glyphcache.h"
 #include "core/fxge/fx_font.h"
 
-CFX_FontCache::CFX_FontCache() = default;
+CFX_FontCache::CFX_FontCache()
+    : glyph_atlas_(pdfium::MakeRetain<CFX_GlyphAtlas>()) {}
 
 CFX_FontCache::~CFX_FontCache() = default;
 
@@ -23,7 +24,7 @@ RetainPtr<CFX_GlyphCache> CFX_FontCache::GetGlyphCache(const CFX_Font* font) {
     return pdfium::WrapRetain(it->second.Get());
   }
 
-  auto new_cache = pdfium::MakeRetain<CFX_GlyphCache>(face);
+  auto new_cache = pdfium::MakeRetain<CFX_GlyphCache>(face, glyph_atlas_);
   map[face.Get()].Reset(new_cache.Get());
   return new_cache;
 }
@@ -11,6 +11,7 @@
 
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/cfx_glyphatlas.h"
 #include "core/fxge/cfx_glyphcache.h"
 
 class CFX_Font;
@@ -26,6 +27,8 @@ class CFX_FontCache {
 #endif
 
  private:
+  // Shared by all the glyph caches, so that they have one memory limit.
+  RetainPtr<CFX_GlyphAtlas> const glyph_atlas_;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> glyph_cache_map_;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> ext_glyph_cache_map_;
 };
@@ -826,6 +826,11 @@ ByteString CFX_FontMapper::GetFaceName(size_t index) const {
   return face_array_[index].name;
 }
 
+FX_Charset CFX_FontMapper::GetFaceCharset(size_t index) const {
+  CHECK_LT(index, face_array_.size());
+  return static_cast<FX_Charset>(face_array_[index].charset);
+}
+
 bool CFX_FontMapper::HasInstalledFont(ByteStringView name) const {
   for (const auto& font : installed_ttfonts_) {
     if (font == name) {
@@ -63,6 +63,7 @@ class CFX_FontMapper {
 
   void SetSystemFontInfo(std::unique_ptr<SystemFontInfoIface> font_info);
   std::unique_ptr<SystemFontInfoIface> TakeSystemFontInfo();
+  SystemFontInfoIface* GetSystemFontInfo() const { return font_info_.get(); }
   void AddInstalledFont(const ByteString& name, FX_Charset charset);
   void LoadInstalledFonts();
 
@@ -77,6 +78,8 @@ class CFX_FontMapper {
   size_t GetFaceSize() const;
   // `index` must be less than GetFaceSize().
   ByteString GetFaceName(size_t index) const;
+  // `index` must be less than GetFaceSize().
+  FX_Charset GetFaceCharset(size_t index) const;
   bool HasInstalledFont(ByteStringView name) const;
   bool HasLocalizedFont(ByteStringView name) const;
 
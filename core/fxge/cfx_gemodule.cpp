@@ -6,14 +6,28 @@
 
 #include "core/fxge/cfx_gemodule.h"
 
+#include <memory>
+#include <utility>
+
 #include "core/fxcrt/check.h"
 #include "core/fxge/cfx_folderfontinfo.h"
 #include "core/fxge/cfx_fontcache.h"
+#include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/cfx_fontmgr.h"
+#include "core/fxge/cfx_sharedfontinfo.h"
+#include "core/fxge/systemfontinfo_iface.h"
 
 namespace {
 
 CFX_GEModule* g_pGEModule = nullptr;
+thread_local CFX_GEModule* g_pThreadGEModule = nullptr;
+
+void InitModule(CFX_GEModule* module,
+                std::unique_ptr<SystemFontInfoIface> font_info) {
+  module->GetPlatform()->Init();
+  module->GetFontMgr()->GetBuiltinMapper()->SetSystemFontInfo(
+      std::move(font_info));
+}
 
 }  // namespace
 
@@ -29,9 +43,14 @@ CFX_GEModule::~CFX_GEModule() = default;
 void CFX_GEModule::Create(const char** pUserFontPaths) {
   DCHECK(!g_pGEModule);
   g_pGEModule = new CFX_GEModule(pUserFontPaths);
-  g_pGEModule->platform_->Init();
-  g_pGEModule->GetFontMgr()->GetBuiltinMapper()->SetSystemFontInfo(
-      g_pGEModule->platform_->CreateDefaultSystemFontInfo());
+  // Shared, so that modules for other threads find the same fonts without
+  // scanning for them again.
+  std::unique_ptr<SystemFontInfoIface> font_info =
+      g_pGEModule->GetPlatform()->CreateDefaultSystemFontInfo();
+  if (font_info) {
+    font_info = std::make_unique<CFX_SharedFontInfo>(std::move(font_info));
+  }
+  InitModule(g_pGEModule, std::move(font_info));
 }
 
 // static
@@ -41,8 +60,46 @@ void CFX_GEModule::Destroy() {
   g_pGEModule = nullptr;
 }
 
+// static
+void CFX_GEModule::CreateForCurrentThread(const char** pUserFontPaths) {
+  DCHECK(!g_pThreadGEModule);
+  g_pThreadGEModule = new CFX_GEModule(pUserFontPaths);
+
+  // Use the same fonts as the process-wide module, which may be the ones an
+  // embedder installed. Those are only replaced by the platform default when
+  // they cannot be shared.
+  std::unique_ptr<SystemFontInfoIface> font_info;
+  SystemFontInfoIface* process_font_info =
+      g_pGEModule
+          ? g_pGEModule->GetFontMgr()->GetBuiltinMapper()->GetSystemFontInfo()
+          : nullptr;
+  if (process_font_info) {
+    font_info = process_font_info->ShareWithOtherThread();
+    if (!font_info) {
+      font_info =
+          g_pThreadGEModule->GetPlatform()->CreateDefaultSystemFontInfo();
+    }
+  }
+  InitModule(g_pThreadGEModule, std::move(font_info));
+}
+
+// static
+void CFX_GEModule::DestroyForCurrentThread() {
+  DCHECK(g_pThreadGEModule);
+  delete g_pThreadGEModule;
+  g_pThreadGEModule = nullptr;
+}
+
+// static
+bool CFX_GEModule::HasModuleForCurrentThread() {
+  return !!g_pThreadGEModule;
+}
+
 // static
 CFX_GEModule* CFX_GEModule::Get() {
+  if (g_pThreadGEModule) {
+    return g_pThreadGEModule;
+  }
   DCHECK(g_pGEModule);
   return g_pGEModule;
 }
@@ -39,6 +39,16 @@ class CFX_GEModule {
 
   static void Create(const char** pUserFontPaths);
   static void Destroy();
+
+  // Creates a module private to the calling thread. While it exists, Get() on
+  // that thread returns it instead of the process-wide module, so its font
+  // manager and glyph caches are never touched by other threads. Its font
+  // mapper gets the system fonts of the process-wide module, including ones
+  // set by the embedder, when they can be shared.
+  static void CreateForCurrentThread(const char** pUserFontPaths);
+  static void DestroyForCurrentThread();
+  static bool HasModuleForCurrentThread();
+
   static CFX_GEModule* Get();
 
   CFX_FontCache* GetFontCache() const { return font_cache_.get(); }
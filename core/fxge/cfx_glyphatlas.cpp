@@ -0,0 +1,243 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_glyphatlas.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/fixed_size_data_vector.h"
+#include "core/fxge/cfx_glyphbitmap.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace {
+
+// Larger glyphs keep their own buffers, so that pages do not end up mostly
+// empty.
+constexpr size_t kMaxSharedGlyphSize = CFX_GlyphAtlas::kPageSize / 4;
+
+}  // namespace
+
+// Pixels of many glyphs, handed out front to back.
+class CFX_GlyphAtlas::Page final : public Retainable {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  bool IsValid() const { return !data_.empty(); }
+
+  // Bytes of the glyphs in this page that are in the atlas.
+  size_t live_size() const { return live_size_; }
+  void AddLive(size_t size) { live_size_ += size; }
+  void RemoveLive(size_t size) {
+    CHECK_LE(size, live_size_);
+    live_size_ -= size;
+  }
+
+  // Keys of the glyphs put in this page, some of which may since have gone.
+  void AddKey(const Key& key) { keys_.push_back(key); }
+  const std::vector<Key>& keys() const { return keys_; }
+
+  // Returns `size` bytes that no other glyph has, or an empty span when the
+  // page is too full.
+  pdfium::span<uint8_t> Allocate(size_t size) {
+    if (size > data_.size() - used_) {
+      return {};
+    }
+    pdfium::span<uint8_t> result = data_.subspan(used_, size);
+    used_ += size;
+    return result;
+  }
+
+ private:
+  Page() : data_(FixedSizeDataVector<uint8_t>::TryUninit(kPageSize)) {}
+  ~Page() override = default;
+
+  FixedSizeDataVector<uint8_t> data_;
+  size_t used_ = 0;
+  size_t live_size_ = 0;
+  std::vector<Key> keys_;
+};
+
+CFX_GlyphAtlas::Entry::Entry(RetainPtr<const CFX_GlyphBitmap> glyph,
+                             RetainPtr<Page> page)
+    : glyph_(std::move(glyph)), page_(std::move(page)) {
+  if (page_) {
+    page_->AddLive(glyph_->GetBitmap()->GetBuffer().size());
+  }
+}
+
+CFX_GlyphAtlas::Entry::Entry(Entry&& that) noexcept = default;
+
+CFX_GlyphAtlas::Entry& CFX_GlyphAtlas::Entry::operator=(
+    Entry&& that) noexcept {
+  if (this != &that) {
+    Release();
+    glyph_ = std::move(that.glyph_);
+    page_ = std::move(that.page_);
+  }
+  return *this;
+}
+
+CFX_GlyphAtlas::Entry::~Entry() {
+  Release();
+}
+
+void CFX_GlyphAtlas::Entry::Release() {
+  if (page_) {
+    page_->RemoveLive(glyph_->GetBitmap()->GetBuffer().size());
+    page_.Reset();
+  }
+}
+
+CFX_GlyphAtlas::CFX_GlyphAtlas() : cache_(kDefaultLimit) {}
+
+CFX_GlyphAtlas::~CFX_GlyphAtlas() = default;
+
+uint32_t CFX_GlyphAtlas::NewCacheId() {
+  return ++last_cache_id_;
+}
+
+std::optional<RetainPtr<const CFX_GlyphBitmap>> CFX_GlyphAtlas::Lookup(
+    const Key& key) {
+  Entry* entry = cache_.Lookup(key);
+  if (!entry) {
+    return std::nullopt;
+  }
+  return entry->glyph();
+}
+
+RetainPtr<const CFX_GlyphBitmap> CFX_GlyphAtlas::Store(
+    const Key& key,
+    RetainPtr<CFX_GlyphBitmap> glyph) {
+  const size_t size = EstimateSize(glyph.Get());
+  if (size > cache_.limit()) {
+    return glyph;
+  }
+
+  RetainPtr<Page> page;
+  if (glyph) {
+    page = MoveToPage(key, glyph.Get());
+  }
+  cache_.Store(key, Entry(glyph, std::move(page)), size);
+  CompactPages();
+  return glyph;
+}
+
+void CFX_GlyphAtlas::EraseCache(uint32_t cache_id) {
+  // The index has no key order to find the range of a cache by, so this goes
+  // through all glyphs. Glyph caches only go away along with their fonts.
+  cache_.EraseIf([cache_id](const Key& key, const Entry&) {
+    return key.cache_id == cache_id;
+  });
+  CompactPages();
+}
+
+void CFX_GlyphAtlas::SetLimit(size_t limit) {
+  cache_.SetLimit(limit);
+  CompactPages();
+}
+
+CFX_GlyphAtlas::Stats CFX_GlyphAtlas::GetStats() const {
+  return cache_.GetStats();
+}
+
+// static
+size_t CFX_GlyphAtlas::EstimateSize(const CFX_GlyphBitmap* glyph) {
+  // Counts the key and the entry too, so that glyphs that failed to render
+  // take up something.
+  size_t size = sizeof(Key) + sizeof(Entry);
+  if (glyph) {
+    // And the copy of the key in the page, if the glyph goes in one.
+    size += glyph->GetBitmap()->GetBuffer().size() + sizeof(Key);
+  }
+  return size;
+}
+
+pdfium::span<uint8_t> CFX_GlyphAtlas::AllocateInPage(const Key& key,
+                                                     size_t size) {
+  // Bitmap pitches are multiples of 4 bytes, so all glyphs in a page start 4
+  // byte aligned.
+  pdfium::span<uint8_t> buffer;
+  if (page_) {
+    buffer = page_->Allocate(size);
+  }
+  if (buffer.empty()) {
+    auto page = pdfium::MakeRetain<Page>();
+    if (!page->IsValid()) {
+      return {};
+    }
+    if (page_ && page_->live_size()) {
+      full_pages_.push_back(std::move(page_));
+    }
+    page_ = std::move(page);
+    buffer = page_->Allocate(size);
+  }
+  page_->AddKey(key);
+  return buffer;
+}
+
+RetainPtr<CFX_GlyphAtlas::Page> CFX_GlyphAtlas::MoveToPage(
+    const Key& key,
+    CFX_GlyphBitmap* glyph) {
+  const size_t size = glyph->GetBitmap()->GetBuffer().size();
+  if (size == 0 || size > kMaxSharedGlyphSize) {
+    return nullptr;
+  }
+
+  pdfium::span<uint8_t> buffer = AllocateInPage(key, size);
+  if (buffer.empty()) {
+    return nullptr;
+  }
+  glyph->MovePixels(buffer, page_);
+  return page_;
+}
+
+void CFX_GlyphAtlas::CompactPages() {
+  auto is_sparse = [](const RetainPtr<Page>& page) {
+    return page->live_size() < kPageSize / 2;
+  };
+  if (std::ranges::none_of(full_pages_, is_sparse)) {
+    return;
+  }
+
+  std::vector<RetainPtr<Page>> sparse_pages;
+  for (auto it = full_pages_.begin(); it != full_pages_.end();) {
+    if (is_sparse(*it)) {
+      sparse_pages.push_back(std::move(*it));
+      it = full_pages_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto page_it = sparse_pages.begin(); page_it != sparse_pages.end();
+       ++page_it) {
+    const RetainPtr<Page>& page = *page_it;
+    for (const Key& key : page->keys()) {
+      if (!page->live_size()) {
+        break;
+      }
+      Entry* entry = cache_.Peek(key);
+      if (!entry || entry->page() != page.Get()) {
+        continue;
+      }
+      // Whoever holds the old glyph keeps this page alive until they are
+      // done with it.
+      const CFX_GlyphBitmap* glyph = entry->glyph().Get();
+      pdfium::span<uint8_t> buffer =
+          AllocateInPage(key, glyph->GetBitmap()->GetBuffer().size());
+      if (buffer.empty()) {
+        // Keep track of the pages that still have glyphs, to compact them
+        // another time.
+        for (; page_it != sparse_pages.end(); ++page_it) {
+          if ((*page_it)->live_size()) {
+            full_pages_.push_back(std::move(*page_it));
+          }
+        }
+        return;
+      }
+      *entry = Entry(glyph->CopyPixels(buffer, page_), page_);
+    }
+  }
+}
@@ -0,0 +1,133 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_CFX_GLYPHATLAS_H_
+#define CORE_FXGE_CFX_GLYPHATLAS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core/fxcrt/lru_cache.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+class CFX_GlyphBitmap;
+
+// Rendered glyph bitmaps of all the glyph caches of a CFX_FontCache, least
+// recently used first out. Small glyphs have their pixels in pages shared
+// with other glyphs, rather than in an allocation each.
+//
+// The limit counts glyph bytes. Once less than half of a filled page is
+// glyphs still in the atlas, those get copied to the current page, so that
+// the pages the atlas keeps take at most twice what it counts for them.
+//
+// Glyphs are reference counted, and their bitmaps keep their pages alive, so
+// a glyph that is dropped while a caller still holds it, or its bitmap, stays
+// valid for that caller.
+//
+// A glyph cache that goes away erases its glyphs with EraseCache(), so that
+// they do not hold on to memory until the atlas fills up.
+class CFX_GlyphAtlas final : public Retainable {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  // A glyph of one glyph cache, and how it is rendered, packed into integers
+  // so that lookups need neither allocations nor string compares.
+  struct Key {
+    bool operator==(const Key& other) const = default;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.cache_id, key.glyph_index,
+                        key.values);
+    }
+
+    // From NewCacheId().
+    uint32_t cache_id = 0;
+    uint32_t glyph_index = 0;
+    // The matrix, width, anti-aliasing and font style, as the glyph cache
+    // packs them.
+    std::array<int32_t, 10> values = {};
+  };
+
+  using Stats = LruCacheStats;
+
+  static constexpr size_t kDefaultLimit = 32 * 1024 * 1024;
+  static constexpr size_t kPageSize = 64 * 1024;
+
+  // Returns an ID for a glyph cache to put in its keys.
+  uint32_t NewCacheId();
+
+  // Returns the glyph for `key`, which is null if it failed to render, or
+  // nullopt if there is none.
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> Lookup(const Key& key);
+
+  // Adds `glyph`, which may be null, for `key`, and returns it. Moves the
+  // pixels of small glyphs into a shared page.
+  RetainPtr<const CFX_GlyphBitmap> Store(const Key& key,
+                                         RetainPtr<CFX_GlyphBitmap> glyph);
+
+  // Drops the glyphs of the glyph cache with `cache_id`.
+  void EraseCache(uint32_t cache_id);
+
+  // 0 turns the cache off.
+  void SetLimit(size_t limit);
+
+  Stats GetStats() const;
+
+ private:
+  class Page;
+
+  // A stored glyph, which counts towards what is live in its page for as
+  // long as it is stored.
+  class Entry {
+   public:
+    Entry(RetainPtr<const CFX_GlyphBitmap> glyph, RetainPtr<Page> page);
+    Entry(Entry&& that) noexcept;
+    Entry& operator=(Entry&& that) noexcept;
+    ~Entry();
+
+    const RetainPtr<const CFX_GlyphBitmap>& glyph() const { return glyph_; }
+    const Page* page() const { return page_.Get(); }
+
+   private:
+    void Release();
+
+    RetainPtr<const CFX_GlyphBitmap> glyph_;
+    // Null unless the pixels are in a shared page.
+    RetainPtr<Page> page_;
+  };
+
+  CFX_GlyphAtlas();
+  ~CFX_GlyphAtlas() override;
+
+  static size_t EstimateSize(const CFX_GlyphBitmap* glyph);
+
+  // Returns `size` bytes in the current page, for the glyph for `key`, or an
+  // empty span if no page could be had.
+  pdfium::span<uint8_t> AllocateInPage(const Key& key, size_t size);
+
+  // Moves the pixels of `glyph` into the current page if it is small enough,
+  // and returns that page.
+  RetainPtr<Page> MoveToPage(const Key& key, CFX_GlyphBitmap* glyph);
+
+  // Copies the glyphs of filled pages that are less than half live to the
+  // current page, and lets go of the pages that have no glyphs left.
+  void CompactPages();
+
+  uint32_t last_cache_id_ = 0;
+  // The page new glyphs go into. Each glyph bitmap keeps its own page alive.
+  RetainPtr<Page> page_;
+  // Earlier pages with glyphs in the atlas.
+  std::vector<RetainPtr<Page>> full_pages_;
+  LruCache<Key, Entry, absl::flat_hash_map> cache_;
+};
+
+#endif  // CORE_FXGE_CFX_GLYPHATLAS_H_
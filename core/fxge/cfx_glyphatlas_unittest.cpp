@@ -0,0 +1,230 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_glyphatlas.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <optional>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/cfx_font.h"
+#include "core/fxge/cfx_glyphbitmap.h"
+#include "core/fxge/cfx_glyphcache.h"
+#include "core/fxge/cfx_textrenderoptions.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Key = CFX_GlyphAtlas::Key;
+
+Key MakeKey(uint32_t cache_id, uint32_t glyph_index) {
+  Key key;
+  key.cache_id = cache_id;
+  key.glyph_index = glyph_index;
+  key.values = {10000, 0, 0, 10000, 12, 1, 0, 0, 0, 0};
+  return key;
+}
+
+// An 8 bpp glyph with all pixels set to `value`.
+RetainPtr<CFX_GlyphBitmap> MakeGlyph(int width, int height, uint8_t value) {
+  auto glyph = pdfium::MakeRetain<CFX_GlyphBitmap>(1, 2);
+  CHECK(glyph->GetBitmap()->Create(width, height, FXDIB_Format::k8bppMask));
+  std::ranges::fill(glyph->GetBitmap()->GetWritableBuffer(), value);
+  return glyph;
+}
+
+bool HasAllPixels(const CFX_GlyphBitmap* glyph, uint8_t value) {
+  return std::ranges::all_of(glyph->GetBitmap()->GetBuffer(),
+                             [value](uint8_t pixel) { return pixel == value; });
+}
+
+}  // namespace
+
+TEST(CFXGlyphAtlas, LookupAndStore) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const Key key = MakeKey(atlas->NewCacheId(), 5);
+  EXPECT_FALSE(atlas->Lookup(key).has_value());
+
+  RetainPtr<CFX_GlyphBitmap> glyph = MakeGlyph(10, 12, 0x7f);
+  EXPECT_EQ(glyph, atlas->Store(key, glyph));
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> found = atlas->Lookup(key);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(glyph, found.value());
+  EXPECT_EQ(1, found.value()->left());
+  EXPECT_EQ(2, found.value()->top());
+  EXPECT_EQ(10, found.value()->GetBitmap()->GetWidth());
+  EXPECT_EQ(12, found.value()->GetBitmap()->GetHeight());
+  EXPECT_TRUE(HasAllPixels(found.value().Get(), 0x7f));
+
+  // Any other value makes for another glyph.
+  Key other_key = key;
+  other_key.values[4] = 13;
+  EXPECT_FALSE(atlas->Lookup(other_key).has_value());
+  EXPECT_FALSE(atlas->Lookup(MakeKey(key.cache_id, 6)).has_value());
+  EXPECT_FALSE(atlas->Lookup(MakeKey(atlas->NewCacheId(), 5)).has_value());
+
+  CFX_GlyphAtlas::Stats stats = atlas->GetStats();
+  EXPECT_EQ(1u, stats.count);
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(4u, stats.misses);
+}
+
+TEST(CFXGlyphAtlas, StoresFailures) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const Key key = MakeKey(atlas->NewCacheId(), 5);
+  EXPECT_FALSE(atlas->Store(key, nullptr));
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> found = atlas->Lookup(key);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_FALSE(found.value());
+  EXPECT_GT(atlas->GetStats().size, 0u);
+}
+
+TEST(CFXGlyphAtlas, SharesPages) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const uint32_t cache_id = atlas->NewCacheId();
+  RetainPtr<CFX_GlyphBitmap> glyph1 = MakeGlyph(10, 12, 1);
+  RetainPtr<CFX_GlyphBitmap> glyph2 = MakeGlyph(7, 3, 2);
+  atlas->Store(MakeKey(cache_id, 1), glyph1);
+  atlas->Store(MakeKey(cache_id, 2), glyph2);
+  EXPECT_TRUE(HasAllPixels(glyph1.Get(), 1));
+  EXPECT_TRUE(HasAllPixels(glyph2.Get(), 2));
+
+  // The second glyph comes right after the first one.
+  pdfium::span<const uint8_t> buffer1 = glyph1->GetBitmap()->GetBuffer();
+  pdfium::span<const uint8_t> buffer2 = glyph2->GetBitmap()->GetBuffer();
+  EXPECT_EQ(buffer1.data() + buffer1.size(), buffer2.data());
+
+  // Large glyphs keep their own buffers.
+  RetainPtr<CFX_GlyphBitmap> large_glyph = MakeGlyph(200, 200, 3);
+  const uint8_t* large_buffer = large_glyph->GetBitmap()->GetBuffer().data();
+  atlas->Store(MakeKey(cache_id, 3), large_glyph);
+  EXPECT_EQ(large_buffer, large_glyph->GetBitmap()->GetBuffer().data());
+  EXPECT_TRUE(HasAllPixels(large_glyph.Get(), 3));
+}
+
+TEST(CFXGlyphAtlas, EvictsLeastRecentlyUsed) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const uint32_t cache_id = atlas->NewCacheId();
+  atlas->Store(MakeKey(cache_id, 1), MakeGlyph(32, 32, 1));
+  const size_t glyph_size = atlas->GetStats().size;
+  atlas->SetLimit(glyph_size * 2);
+
+  RetainPtr<const CFX_GlyphBitmap> glyph2 =
+      atlas->Store(MakeKey(cache_id, 2), MakeGlyph(32, 32, 2));
+  EXPECT_TRUE(atlas->Lookup(MakeKey(cache_id, 1)).has_value());
+  atlas->Store(MakeKey(cache_id, 3), MakeGlyph(32, 32, 3));
+  EXPECT_TRUE(atlas->Lookup(MakeKey(cache_id, 1)).has_value());
+  EXPECT_FALSE(atlas->Lookup(MakeKey(cache_id, 2)).has_value());
+  EXPECT_TRUE(atlas->Lookup(MakeKey(cache_id, 3)).has_value());
+  EXPECT_EQ(2u, atlas->GetStats().count);
+  EXPECT_EQ(glyph_size * 2, atlas->GetStats().size);
+
+  // Evicted glyphs stay valid for whoever still holds them.
+  EXPECT_TRUE(HasAllPixels(glyph2.Get(), 2));
+
+  // Glyphs over the limit are not kept at all.
+  RetainPtr<const CFX_GlyphBitmap> large_glyph =
+      atlas->Store(MakeKey(cache_id, 4), MakeGlyph(100, 100, 4));
+  ASSERT_TRUE(large_glyph);
+  EXPECT_FALSE(atlas->Lookup(MakeKey(cache_id, 4)).has_value());
+
+  atlas->SetLimit(0);
+  EXPECT_EQ(0u, atlas->GetStats().count);
+  EXPECT_EQ(0u, atlas->GetStats().size);
+}
+
+TEST(CFXGlyphAtlas, GlyphsGoWithTheirCache) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const uint32_t other_cache_id = atlas->NewCacheId();
+  atlas->Store(MakeKey(other_cache_id, 1), MakeGlyph(4, 4, 1));
+  const size_t other_size = atlas->GetStats().size;
+
+  // A glyph cache without a face renders nothing, but still keeps that in
+  // the atlas.
+  CFX_Font font;
+  CFX_TextRenderOptions text_options;
+  text_options.native_text = false;
+  auto glyph_cache = pdfium::MakeRetain<CFX_GlyphCache>(nullptr, atlas);
+  for (uint32_t glyph_index : {1, 2, 3}) {
+    EXPECT_FALSE(glyph_cache->LoadGlyphBitmap(&font, glyph_index,
+                                              /*bFontStyle=*/false,
+                                              CFX_Matrix(), /*dest_width=*/12,
+                                              /*anti_alias=*/1,
+                                              &text_options));
+  }
+  EXPECT_EQ(4u, atlas->GetStats().count);
+  EXPECT_GT(atlas->GetStats().size, other_size);
+
+  glyph_cache.Reset();
+  EXPECT_EQ(1u, atlas->GetStats().count);
+  EXPECT_EQ(other_size, atlas->GetStats().size);
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> found =
+      atlas->Lookup(MakeKey(other_cache_id, 1));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_TRUE(HasAllPixels(found.value().Get(), 1));
+}
+
+TEST(CFXGlyphAtlas, CompactsPages) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const uint32_t cache_id = atlas->NewCacheId();
+
+  // Fill a page with glyphs of 1 KiB, and keep two of them.
+  constexpr uint32_t kGlyphsPerPage = CFX_GlyphAtlas::kPageSize / 1024;
+  RetainPtr<const CFX_GlyphBitmap> first_glyph;
+  for (uint32_t i = 0; i < kGlyphsPerPage; ++i) {
+    RetainPtr<const CFX_GlyphBitmap> glyph =
+        atlas->Store(MakeKey(cache_id, i), MakeGlyph(32, 32, i));
+    if (i == 0) {
+      first_glyph = glyph;
+    }
+  }
+  ASSERT_TRUE(atlas->Lookup(MakeKey(cache_id, 0)).has_value());
+  const size_t glyph_size = atlas->GetStats().size / kGlyphsPerPage;
+  atlas->SetLimit(glyph_size * 2);
+  EXPECT_EQ(2u, atlas->GetStats().count);
+
+  // The next glyph starts a new page and pushes out one of the two, which
+  // leaves the first page all but empty. The other one moves to the new page.
+  RetainPtr<const CFX_GlyphBitmap> next_glyph = atlas->Store(
+      MakeKey(cache_id, kGlyphsPerPage), MakeGlyph(32, 32, 0xff));
+  EXPECT_FALSE(
+      atlas->Lookup(MakeKey(cache_id, kGlyphsPerPage - 1)).has_value());
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> moved_glyph =
+      atlas->Lookup(MakeKey(cache_id, 0));
+  ASSERT_TRUE(moved_glyph.has_value());
+  ASSERT_TRUE(moved_glyph.value());
+  EXPECT_NE(first_glyph, moved_glyph.value());
+  EXPECT_EQ(1, moved_glyph.value()->left());
+  EXPECT_EQ(2, moved_glyph.value()->top());
+  EXPECT_TRUE(HasAllPixels(moved_glyph.value().Get(), 0));
+  pdfium::span<const uint8_t> next_buffer =
+      next_glyph->GetBitmap()->GetBuffer();
+  EXPECT_EQ(next_buffer.data() + next_buffer.size(),
+            moved_glyph.value()->GetBitmap()->GetBuffer().data());
+  EXPECT_EQ(2u, atlas->GetStats().count);
+
+  // The old glyph stays valid for whoever still holds it.
+  EXPECT_TRUE(HasAllPixels(first_glyph.Get(), 0));
+}
+
+TEST(CFXGlyphAtlas, BitmapsOutliveTheAtlas) {
+  auto atlas = pdfium::MakeRetain<CFX_GlyphAtlas>();
+  const uint32_t cache_id = atlas->NewCacheId();
+  RetainPtr<CFX_DIBitmap> bitmap1 =
+      atlas->Store(MakeKey(cache_id, 1), MakeGlyph(10, 12, 1))->GetBitmap();
+  RetainPtr<CFX_DIBitmap> bitmap2 =
+      atlas->Store(MakeKey(cache_id, 2), MakeGlyph(7, 3, 2))->GetBitmap();
+  atlas.Reset();
+
+  // Both bitmaps share a page, which they keep alive past their glyphs.
+  EXPECT_TRUE(std::ranges::all_of(bitmap1->GetBuffer(),
+                                  [](uint8_t pixel) { return pixel == 1; }));
+  EXPECT_TRUE(std::ranges::all_of(bitmap2->GetBuffer(),
+                                  [](uint8_t pixel) { return pixel == 2; }));
+}
@@ -4,9 +4,34 @@
 
 #include "core/fxge/cfx_glyphbitmap.h"
 
+#include <utility>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/span_util.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 
 CFX_GlyphBitmap::CFX_GlyphBitmap(int left, int top)
     : left_(left), top_(top), bitmap_(pdfium::MakeRetain<CFX_DIBitmap>()) {}
 
 CFX_GlyphBitmap::~CFX_GlyphBitmap() = default;
+
+void CFX_GlyphBitmap::MovePixels(pdfium::span<uint8_t> buffer,
+                                 RetainPtr<const Retainable> buffer_owner) {
+  CHECK_EQ(buffer.size(), bitmap_->GetBuffer().size());
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(bitmap_->GetWidth(), bitmap_->GetHeight(),
+                       bitmap_->GetFormat(), buffer, bitmap_->GetPitch(),
+                       std::move(buffer_owner)));
+  fxcrt::spancpy(buffer, bitmap_->GetBuffer());
+  bitmap_ = std::move(bitmap);
+}
+
+RetainPtr<CFX_GlyphBitmap> CFX_GlyphBitmap::CopyPixels(
+    pdfium::span<uint8_t> buffer,
+    RetainPtr<const Retainable> buffer_owner) const {
+  auto glyph = pdfium::MakeRetain<CFX_GlyphBitmap>(left_, top_);
+  glyph->bitmap_ = bitmap_;
+  glyph->MovePixels(buffer, std::move(buffer_owner));
+  return glyph;
+}
@@ -7,23 +7,37 @@
 #ifndef CORE_FXGE_CFX_GLYPHBITMAP_H_
 #define CORE_FXGE_CFX_GLYPHBITMAP_H_
 
+#include <stdint.h>
+
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 
 class CFX_DIBitmap;
 
-class CFX_GlyphBitmap {
+class CFX_GlyphBitmap final : public Retainable {
  public:
-  CFX_GlyphBitmap(int left, int top);
-  ~CFX_GlyphBitmap();
-
-  CFX_GlyphBitmap(const CFX_GlyphBitmap&) = delete;
-  CFX_GlyphBitmap& operator=(const CFX_GlyphBitmap&) = delete;
+  CONSTRUCT_VIA_MAKE_RETAIN;
 
   const RetainPtr<CFX_DIBitmap>& GetBitmap() const { return bitmap_; }
   int left() const { return left_; }
   int top() const { return top_; }
 
+  // Moves the pixels into `buffer`, which is as large as the bitmap's buffer
+  // and which `buffer_owner` keeps alive, so that many glyphs can share one
+  // allocation. The new bitmap holds on to `buffer_owner`.
+  void MovePixels(pdfium::span<uint8_t> buffer,
+                  RetainPtr<const Retainable> buffer_owner);
+
+  // Returns a glyph like this one, with its pixels copied into `buffer` as
+  // MovePixels() would. Leaves this glyph as it is.
+  RetainPtr<CFX_GlyphBitmap> CopyPixels(
+      pdfium::span<uint8_t> buffer,
+      RetainPtr<const Retainable> buffer_owner) const;
+
  private:
+  CFX_GlyphBitmap(int left, int top);
+  ~CFX_GlyphBitmap() override;
+
   const int left_;
   const int top_;
   RetainPtr<CFX_DIBitmap> bitmap_;
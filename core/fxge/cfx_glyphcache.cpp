@@ -6,13 +6,13 @@
 
 #include "core/fxge/cfx_glyphcache.h"
 
-#include <initializer_list>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "build/build_config.h"
+#include "core/fxcrt/check.h"
 #include "core/fxcrt/fx_codepage.h"
-#include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/span.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_font.h"
@@ -42,79 +42,56 @@ namespace {
 
 constexpr uint32_t kInvalidGlyphIndex = static_cast<uint32_t>(-1);
 
-class UniqueKeyGen {
- public:
-  UniqueKeyGen(const CFX_Font* font,
-               const CFX_Matrix& matrix,
-               int dest_width,
-               int anti_alias,
-               bool bNative);
+// Flags in the last of the CFX_GlyphAtlas::Key values.
+constexpr int32_t kHasSubstFont = 1 << 0;
+constexpr int32_t kNative = 1 << 1;
 
-  pdfium::span<const uint8_t> span() const;
-
- private:
-  void Initialize(std::initializer_list<const int> args);
-
-  size_t key_len_;
-  uint32_t key_[32];
-};
+}  // namespace
 
-void UniqueKeyGen::Initialize(std::initializer_list<const int32_t> args) {
-  auto key_span = pdfium::span<uint32_t, pdfium::dynamic_extent>(key_);
-  for (const auto& arg : args) {
-    key_span.front() = arg;
-    key_span = key_span.subspan<1u>();
-  }
-  key_len_ = args.size();
-}
+CFX_GlyphCache::CFX_GlyphCache(RetainPtr<CFX_Face> face,
+                               RetainPtr<CFX_GlyphAtlas> atlas)
+    : face_(std::move(face)),
+      atlas_(std::move(atlas)),
+      atlas_cache_id_(atlas_->NewCacheId()) {}
 
-pdfium::span<const uint8_t> UniqueKeyGen::span() const {
-  return pdfium::as_bytes(pdfium::span(key_).first(key_len_));
+CFX_GlyphCache::~CFX_GlyphCache() {
+  atlas_->EraseCache(atlas_cache_id_);
 }
 
-UniqueKeyGen::UniqueKeyGen(const CFX_Font* font,
-                           const CFX_Matrix& matrix,
-                           int dest_width,
-                           int anti_alias,
-                           bool bNative) {
-  int nMatrixA = static_cast<int>(matrix.a * 10000);
-  int nMatrixB = static_cast<int>(matrix.b * 10000);
-  int nMatrixC = static_cast<int>(matrix.c * 10000);
-  int nMatrixD = static_cast<int>(matrix.d * 10000);
-
-#if BUILDFLAG(IS_APPLE)
-  if (bNative) {
-    if (font->GetSubstFont()) {
-      Initialize({nMatrixA, nMatrixB, nMatrixC, nMatrixD, dest_width,
-                  anti_alias, font->GetSubstFont()->weight_,
-                  font->GetSubstFont()->italic_angle_, font->IsVertical(), 3});
-    } else {
-      Initialize(
-          {nMatrixA, nMatrixB, nMatrixC, nMatrixD, dest_width, anti_alias, 3});
-    }
-    return;
-  }
+CFX_GlyphAtlas::Key CFX_GlyphCache::MakeBitmapKey(const CFX_Font* font,
+                                                  uint32_t glyph_index,
+                                                  const CFX_Matrix& matrix,
+                                                  int dest_width,
+                                                  int anti_alias,
+                                                  bool bNative) const {
+#if !BUILDFLAG(IS_APPLE)
+  CHECK(!bNative);
 #endif
 
-  CHECK(!bNative);
-  if (font->GetSubstFont()) {
-    Initialize({nMatrixA, nMatrixB, nMatrixC, nMatrixD, dest_width, anti_alias,
-                font->GetSubstFont()->weight_,
-                font->GetSubstFont()->italic_angle_, font->IsVertical()});
-  } else {
-    Initialize(
-        {nMatrixA, nMatrixB, nMatrixC, nMatrixD, dest_width, anti_alias});
+  CFX_GlyphAtlas::Key key;
+  key.cache_id = atlas_cache_id_;
+  key.glyph_index = glyph_index;
+  int32_t flags = bNative ? kNative : 0;
+  const CFX_SubstFont* subst_font = font->GetSubstFont();
+  if (subst_font) {
+    flags |= kHasSubstFont;
   }
+  key.values = {
+      static_cast<int32_t>(matrix.a * 10000),
+      static_cast<int32_t>(matrix.b * 10000),
+      static_cast<int32_t>(matrix.c * 10000),
+      static_cast<int32_t>(matrix.d * 10000),
+      dest_width,
+      anti_alias,
+      subst_font ? subst_font->weight_ : 0,
+      subst_font ? subst_font->italic_angle_ : 0,
+      subst_font ? font->IsVertical() : false,
+      flags,
+  };
+  return key;
 }
 
-}  // namespace
-
-CFX_GlyphCache::CFX_GlyphCache(RetainPtr<CFX_Face> face)
-    : face_(std::move(face)) {}
-
-CFX_GlyphCache::~CFX_GlyphCache() = default;
-
-std::unique_ptr<CFX_GlyphBitmap> CFX_GlyphCache::RenderGlyph(
+RetainPtr<CFX_GlyphBitmap> CFX_GlyphCache::RenderGlyph(
     const CFX_Font* font,
     uint32_t glyph_index,
     bool bFontStyle,
@@ -151,7 +128,7 @@ const CFX_Path* CFX_GlyphCache::LoadGlyphPath(const CFX_Font* font,
   return path_map_[key].get();
 }
 
-const CFX_GlyphBitmap* CFX_GlyphCache::LoadGlyphBitmap(
+RetainPtr<const CFX_GlyphBitmap> CFX_GlyphCache::LoadGlyphBitmap(
     const CFX_Font* font,
     uint32_t glyph_index,
     bool bFontStyle,
@@ -168,8 +145,8 @@ const CFX_GlyphBitmap* CFX_GlyphCache::LoadGlyphBitmap(
 #else
   const bool bNative = false;
 #endif
-  UniqueKeyGen keygen(font, matrix, dest_width, anti_alias, bNative);
-  auto FaceGlyphsKey = ByteString(ByteStringView(keygen.span()));
+  const CFX_GlyphAtlas::Key key = MakeBitmapKey(
+      font, glyph_index, matrix, dest_width, anti_alias, bNative);
 
 #if BUILDFLAG(IS_APPLE)
   const bool bDoLookUp =
@@ -178,48 +155,30 @@ const CFX_GlyphBitmap* CFX_GlyphCache::LoadGlyphBitmap(
   const bool bDoLookUp = true;
 #endif
   if (bDoLookUp) {
-    return LookUpGlyphBitmap(font, matrix, FaceGlyphsKey, glyph_index,
-                             bFontStyle, dest_width, anti_alias);
+    return LookUpGlyphBitmap(font, matrix, key, bFontStyle, dest_width,
+                             anti_alias);
   }
 
 #if BUILDFLAG(IS_APPLE)
   DCHECK(!CFX_DefaultRenderDevice::UseSkiaRenderer());
 
-  std::unique_ptr<CFX_GlyphBitmap> pGlyphBitmap;
-  auto it = size_map_.find(FaceGlyphsKey);
-  if (it != size_map_.end()) {
-    SizeGlyphCache* pSizeCache = &(it->second);
-    auto it2 = pSizeCache->find(glyph_index);
-    if (it2 != pSizeCache->end()) {
-      return it2->second.get();
-    }
-
-    pGlyphBitmap = RenderGlyph_Nativetext(font, glyph_index, matrix, dest_width,
-                                          anti_alias);
-    if (pGlyphBitmap) {
-      CFX_GlyphBitmap* pResult = pGlyphBitmap.get();
-      (*pSizeCache)[glyph_index] = std::move(pGlyphBitmap);
-      return pResult;
-    }
-  } else {
-    pGlyphBitmap = RenderGlyph_Nativetext(font, glyph_index, matrix, dest_width,
-                                          anti_alias);
-    if (pGlyphBitmap) {
-      CFX_GlyphBitmap* pResult = pGlyphBitmap.get();
-
-      SizeGlyphCache cache;
-      cache[glyph_index] = std::move(pGlyphBitmap);
-
-      size_map_[FaceGlyphsKey] = std::move(cache);
-      return pResult;
-    }
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> cached = atlas_->Lookup(key);
+  if (cached.has_value() && cached.value()) {
+    return cached.value();
+  }
+
+  RetainPtr<CFX_GlyphBitmap> pGlyphBitmap = RenderGlyph_Nativetext(
+      font, glyph_index, matrix, dest_width, anti_alias);
+  if (pGlyphBitmap) {
+    return atlas_->Store(key, std::move(pGlyphBitmap));
   }
-  UniqueKeyGen keygen2(font, matrix, dest_width, anti_alias,
-                       /*bNative=*/false);
-  auto FaceGlyphsKey2 = ByteString(ByteStringView(keygen2.span()));
+
+  const CFX_GlyphAtlas::Key key2 =
+      MakeBitmapKey(font, glyph_index, matrix, dest_width, anti_alias,
+                    /*bNative=*/false);
   text_options->native_text = false;
-  return LookUpGlyphBitmap(font, matrix, FaceGlyphsKey2, glyph_index,
-                           bFontStyle, dest_width, anti_alias);
+  return LookUpGlyphBitmap(font, matrix, key2, bFontStyle, dest_width,
+                           anti_alias);
 #endif  // BUILDFLAG(IS_APPLE)
 }
 
@@ -299,31 +258,18 @@ CFX_TypeFace* CFX_GlyphCache::GetDeviceCache(const CFX_Font* font) {
 }
 #endif  // defined(PDF_USE_SKIA)
 
-CFX_GlyphBitmap* CFX_GlyphCache::LookUpGlyphBitmap(
+RetainPtr<const CFX_GlyphBitmap> CFX_GlyphCache::LookUpGlyphBitmap(
     const CFX_Font* font,
     const CFX_Matrix& matrix,
-    const ByteString& FaceGlyphsKey,
-    uint32_t glyph_index,
+    const CFX_GlyphAtlas::Key& key,
     bool bFontStyle,
     int dest_width,
     int anti_alias) {
-  SizeGlyphCache* pSizeCache;
-  auto it = size_map_.find(FaceGlyphsKey);
-  if (it == size_map_.end()) {
-    size_map_[FaceGlyphsKey] = SizeGlyphCache();
-    pSizeCache = &(size_map_[FaceGlyphsKey]);
-  } else {
-    pSizeCache = &(it->second);
-  }
-
-  auto it2 = pSizeCache->find(glyph_index);
-  if (it2 != pSizeCache->end()) {
-    return it2->second.get();
+  std::optional<RetainPtr<const CFX_GlyphBitmap>> cached = atlas_->Lookup(key);
+  if (cached.has_value()) {
+    return cached.value();
   }
 
-  std::unique_ptr<CFX_GlyphBitmap> pGlyphBitmap = RenderGlyph(
-      font, glyph_index, bFontStyle, matrix, dest_width, anti_alias);
-  CFX_GlyphBitmap* pResult = pGlyphBitmap.get();
-  (*pSizeCache)[glyph_index] = std::move(pGlyphBitmap);
-  return pResult;
+  return atlas_->Store(key, RenderGlyph(font, key.glyph_index, bFontStyle,
+                                        matrix, dest_width, anti_alias));
 }
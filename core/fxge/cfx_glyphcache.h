@@ -7,14 +7,16 @@
 #ifndef CORE_FXGE_CFX_GLYPHCACHE_H_
 #define CORE_FXGE_CFX_GLYPHCACHE_H_
 
-#include <map>
+#include <stdint.h>
+
 #include <memory>
 #include <tuple>
 
-#include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxge/cfx_face.h"
+#include "core/fxge/cfx_glyphatlas.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
 
 #if defined(PDF_USE_SKIA)
 #include "core/fxge/fx_font.h"
@@ -31,13 +33,14 @@ class CFX_GlyphCache final : public Retainable, public Observable {
  public:
   CONSTRUCT_VIA_MAKE_RETAIN;
 
-  const CFX_GlyphBitmap* LoadGlyphBitmap(const CFX_Font* font,
-                                         uint32_t glyph_index,
-                                         bool bFontStyle,
-                                         const CFX_Matrix& matrix,
-                                         int dest_width,
-                                         int anti_alias,
-                                         CFX_TextRenderOptions* text_options);
+  RetainPtr<const CFX_GlyphBitmap> LoadGlyphBitmap(
+      const CFX_Font* font,
+      uint32_t glyph_index,
+      bool bFontStyle,
+      const CFX_Matrix& matrix,
+      int dest_width,
+      int anti_alias,
+      CFX_TextRenderOptions* text_options);
   const CFX_Path* LoadGlyphPath(const CFX_Font* font,
                                 uint32_t glyph_index,
                                 int dest_width);
@@ -55,38 +58,45 @@ class CFX_GlyphCache final : public Retainable, public Observable {
 #endif
 
  private:
-  explicit CFX_GlyphCache(RetainPtr<CFX_Face> face);
+  // Glyph bitmaps go in `atlas`, shared with the other glyph caches of the
+  // CFX_FontCache.
+  CFX_GlyphCache(RetainPtr<CFX_Face> face, RetainPtr<CFX_GlyphAtlas> atlas);
   ~CFX_GlyphCache() override;
 
-  using SizeGlyphCache = std::map<uint32_t, std::unique_ptr<CFX_GlyphBitmap>>;
   // <glyph_index, width, weight, angle, vertical>
   using PathMapKey = std::tuple<uint32_t, int, int, int, bool>;
   // <glyph_index, dest_width, weight>
   using WidthMapKey = std::tuple<uint32_t, int, int>;
 
-  std::unique_ptr<CFX_GlyphBitmap> RenderGlyph(const CFX_Font* font,
-                                               uint32_t glyph_index,
-                                               bool bFontStyle,
-                                               const CFX_Matrix& matrix,
-                                               int dest_width,
-                                               int anti_alias);
-  std::unique_ptr<CFX_GlyphBitmap> RenderGlyph_Nativetext(
+  CFX_GlyphAtlas::Key MakeBitmapKey(const CFX_Font* font,
+                                    uint32_t glyph_index,
+                                    const CFX_Matrix& matrix,
+                                    int dest_width,
+                                    int anti_alias,
+                                    bool bNative) const;
+  RetainPtr<CFX_GlyphBitmap> RenderGlyph(const CFX_Font* font,
+                                         uint32_t glyph_index,
+                                         bool bFontStyle,
+                                         const CFX_Matrix& matrix,
+                                         int dest_width,
+                                         int anti_alias);
+  RetainPtr<CFX_GlyphBitmap> RenderGlyph_Nativetext(const CFX_Font* font,
+                                                    uint32_t glyph_index,
+                                                    const CFX_Matrix& matrix,
+                                                    int dest_width,
+                                                    int anti_alias);
+  RetainPtr<const CFX_GlyphBitmap> LookUpGlyphBitmap(
       const CFX_Font* font,
-      uint32_t glyph_index,
       const CFX_Matrix& matrix,
+      const CFX_GlyphAtlas::Key& key,
+      bool bFontStyle,
       int dest_width,
       int anti_alias);
-  CFX_GlyphBitmap* LookUpGlyphBitmap(const CFX_Font* font,
-                                     const CFX_Matrix& matrix,
-                                     const ByteString& FaceGlyphsKey,
-                                     uint32_t glyph_index,
-                                     bool bFontStyle,
-                                     int dest_width,
-                                     int anti_alias);
   RetainPtr<CFX_Face> const face_;
-  std::map<ByteString, SizeGlyphCache> size_map_;
-  std::map<PathMapKey, std::unique_ptr<CFX_Path>> path_map_;
-  std::map<WidthMapKey, int> width_map_;
+  RetainPtr<CFX_GlyphAtlas> const atlas_;
+  const uint32_t atlas_cache_id_;
+  absl::flat_hash_map<PathMapKey, std::unique_ptr<CFX_Path>> path_map_;
+  absl::flat_hash_map<WidthMapKey, int> width_map_;
 #if defined(PDF_USE_SKIA)
   sk_sp<SkTypeface> typeface_;
 #endif
@@ -0,0 +1,103 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_sharedfontinfo.h"
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/fxcrt/fx_codepage.h"
+#include "core/fxge/cfx_fontmapper.h"
+
+struct CFX_SharedFontInfo::State {
+  // Recursive, since the wrapped font info calls back into the mapper while
+  // it enumerates fonts, which may in turn call into the font info.
+  std::recursive_mutex lock;
+  std::unique_ptr<SystemFontInfoIface> font_info;
+
+  // The fonts of the first enumeration, as plain strings so that they can be
+  // handed to mappers on any thread.
+  std::optional<std::vector<std::pair<std::string, FX_Charset>>> fonts;
+};
+
+CFX_SharedFontInfo::CFX_SharedFontInfo(
+    std::unique_ptr<SystemFontInfoIface> font_info)
+    : state_(std::make_shared<State>()) {
+  state_->font_info = std::move(font_info);
+}
+
+CFX_SharedFontInfo::CFX_SharedFontInfo(std::shared_ptr<State> state)
+    : state_(std::move(state)) {}
+
+CFX_SharedFontInfo::~CFX_SharedFontInfo() = default;
+
+void CFX_SharedFontInfo::EnumFontList(CFX_FontMapper* pMapper) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  if (state_->fonts.has_value()) {
+    for (const auto& [name, charset] : state_->fonts.value()) {
+      pMapper->AddInstalledFont(ByteString(name.c_str()), charset);
+    }
+    return;
+  }
+
+  const size_t first_face = pMapper->GetFaceSize();
+  state_->font_info->EnumFontList(pMapper);
+  std::vector<std::pair<std::string, FX_Charset>> fonts;
+  for (size_t i = first_face; i < pMapper->GetFaceSize(); ++i) {
+    fonts.emplace_back(pMapper->GetFaceName(i).c_str(),
+                       pMapper->GetFaceCharset(i));
+  }
+  state_->fonts = std::move(fonts);
+}
+
+void* CFX_SharedFontInfo::MapFont(int weight,
+                                  bool bItalic,
+                                  FX_Charset charset,
+                                  int pitch_family,
+                                  const ByteString& face) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  return state_->font_info->MapFont(weight, bItalic, charset, pitch_family,
+                                    ByteString(face.AsStringView()));
+}
+
+void* CFX_SharedFontInfo::GetFont(const ByteString& face) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  return state_->font_info->GetFont(ByteString(face.AsStringView()));
+}
+
+size_t CFX_SharedFontInfo::GetFontData(void* hFont,
+                                       uint32_t table,
+                                       pdfium::span<uint8_t> buffer) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  return state_->font_info->GetFontData(hFont, table, buffer);
+}
+
+bool CFX_SharedFontInfo::GetFaceName(void* hFont, ByteString* name) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  ByteString shared_name;
+  if (!state_->font_info->GetFaceName(hFont, &shared_name)) {
+    return false;
+  }
+  *name = ByteString(shared_name.AsStringView());
+  return true;
+}
+
+bool CFX_SharedFontInfo::GetFontCharset(void* hFont, FX_Charset* charset) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  return state_->font_info->GetFontCharset(hFont, charset);
+}
+
+void CFX_SharedFontInfo::DeleteFont(void* hFont) {
+  std::lock_guard<std::recursive_mutex> lock(state_->lock);
+  state_->font_info->DeleteFont(hFont);
+}
+
+std::unique_ptr<SystemFontInfoIface>
+CFX_SharedFontInfo::ShareWithOtherThread() {
+  // Private constructor, so no std::make_unique().
+  return std::unique_ptr<CFX_SharedFontInfo>(new CFX_SharedFontInfo(state_));
+}
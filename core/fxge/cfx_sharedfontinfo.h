@@ -0,0 +1,54 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_CFX_SHAREDFONTINFO_H_
+#define CORE_FXGE_CFX_SHAREDFONTINFO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "core/fxge/systemfontinfo_iface.h"
+
+// Lets the font mappers of several CFX_GEModules, possibly on different
+// threads, use one SystemFontInfoIface. Each mapper gets its own instance
+// from ShareWithOtherThread(). Calls into the wrapped font info are
+// serialized, and strings are copied on the way in and out, so that no
+// reference counted string is shared between threads. The wrapped font info
+// goes away with the last instance.
+//
+// The fonts the wrapped font info reports on the first EnumFontList() call
+// are remembered and reported to later mappers, since font infos such as
+// CFX_FolderFontInfo only report each font once.
+class CFX_SharedFontInfo final : public SystemFontInfoIface {
+ public:
+  explicit CFX_SharedFontInfo(std::unique_ptr<SystemFontInfoIface> font_info);
+  ~CFX_SharedFontInfo() override;
+
+  // SystemFontInfoIface:
+  void EnumFontList(CFX_FontMapper* pMapper) override;
+  void* MapFont(int weight,
+                bool bItalic,
+                FX_Charset charset,
+                int pitch_family,
+                const ByteString& face) override;
+  void* GetFont(const ByteString& face) override;
+  size_t GetFontData(void* hFont,
+                     uint32_t table,
+                     pdfium::span<uint8_t> buffer) override;
+  bool GetFaceName(void* hFont, ByteString* name) override;
+  bool GetFontCharset(void* hFont, FX_Charset* charset) override;
+  void DeleteFont(void* hFont) override;
+  std::unique_ptr<SystemFontInfoIface> ShareWithOtherThread() override;
+
+ private:
+  struct State;
+
+  explicit CFX_SharedFontInfo(std::shared_ptr<State> state);
+
+  std::shared_ptr<State> const state_;
+};
+
+#endif  // CORE_FXGE_CFX_SHAREDFONTINFO_H_
@@ -0,0 +1,134 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_sharedfontinfo.h"
+
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/fxcrt/fx_codepage.h"
+#include "core/fxge/cfx_fontmapper.h"
+#include "core/fxge/cfx_gemodule.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Reports each font once only, like CFX_FolderFontInfo.
+class FakeFontInfo final : public SystemFontInfoIface {
+ public:
+  explicit FakeFontInfo(int* enum_count) : enum_count_(enum_count) {}
+  ~FakeFontInfo() override = default;
+
+  // SystemFontInfoIface:
+  void EnumFontList(CFX_FontMapper* pMapper) override {
+    ++*enum_count_;
+    if (*enum_count_ > 1) {
+      return;
+    }
+    pMapper->AddInstalledFont("Arimo", FX_Charset::kANSI);
+    pMapper->AddInstalledFont("Tinos", FX_Charset::kSymbol);
+  }
+  void* MapFont(int weight,
+                bool bItalic,
+                FX_Charset charset,
+                int pitch_family,
+                const ByteString& face) override {
+    return GetFont(face);
+  }
+  void* GetFont(const ByteString& face) override {
+    return face == "Arimo" ? this : nullptr;
+  }
+  size_t GetFontData(void* hFont,
+                     uint32_t table,
+                     pdfium::span<uint8_t> buffer) override {
+    return 0;
+  }
+  bool GetFaceName(void* hFont, ByteString* name) override {
+    *name = face_name_;
+    return true;
+  }
+  bool GetFontCharset(void* hFont, FX_Charset* charset) override {
+    *charset = FX_Charset::kANSI;
+    return true;
+  }
+  void DeleteFont(void* hFont) override {}
+
+  const ByteString& face_name() const { return face_name_; }
+
+ private:
+  int* const enum_count_;
+  const ByteString face_name_ = "Arimo";
+};
+
+}  // namespace
+
+TEST(CFXSharedFontInfo, EnumeratesOnceForAllMappers) {
+  int enum_count = 0;
+  auto shared_font_info = std::make_unique<CFX_SharedFontInfo>(
+      std::make_unique<FakeFontInfo>(&enum_count));
+  std::unique_ptr<SystemFontInfoIface> other_font_info =
+      shared_font_info->ShareWithOtherThread();
+  ASSERT_TRUE(other_font_info);
+
+  CFX_FontMapper mapper(CFX_GEModule::Get()->GetFontMgr());
+  mapper.SetSystemFontInfo(std::move(shared_font_info));
+  mapper.LoadInstalledFonts();
+  CFX_FontMapper other_mapper(CFX_GEModule::Get()->GetFontMgr());
+  other_mapper.SetSystemFontInfo(std::move(other_font_info));
+  other_mapper.LoadInstalledFonts();
+
+  EXPECT_EQ(1, enum_count);
+  for (const CFX_FontMapper* m : {&mapper, &other_mapper}) {
+    ASSERT_EQ(2u, m->GetFaceSize());
+    EXPECT_EQ("Arimo", m->GetFaceName(0));
+    EXPECT_EQ(FX_Charset::kANSI, m->GetFaceCharset(0));
+    EXPECT_EQ("Tinos", m->GetFaceName(1));
+    EXPECT_EQ(FX_Charset::kSymbol, m->GetFaceCharset(1));
+  }
+  EXPECT_TRUE(other_mapper.HasInstalledFont("Tinos"));
+}
+
+TEST(CFXSharedFontInfo, CopiesStrings) {
+  int enum_count = 0;
+  auto fake_font_info = std::make_unique<FakeFontInfo>(&enum_count);
+  const FakeFontInfo* fake = fake_font_info.get();
+  CFX_SharedFontInfo shared_font_info(std::move(fake_font_info));
+
+  void* font = shared_font_info.GetFont("Arimo");
+  ASSERT_TRUE(font);
+  ByteString name;
+  ASSERT_TRUE(shared_font_info.GetFaceName(font, &name));
+  EXPECT_EQ(fake->face_name(), name);
+  EXPECT_NE(fake->face_name().c_str(), name.c_str());
+}
+
+TEST(CFXSharedFontInfo, UsableFromSeveralThreads) {
+  int enum_count = 0;
+  CFX_SharedFontInfo shared_font_info(
+      std::make_unique<FakeFontInfo>(&enum_count));
+  std::vector<std::unique_ptr<SystemFontInfoIface>> font_infos;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    font_infos.push_back(shared_font_info.ShareWithOtherThread());
+  }
+  for (auto& font_info : font_infos) {
+    threads.emplace_back([&font_info] {
+      for (int i = 0; i < 1000; ++i) {
+        void* font =
+            font_info->MapFont(400, false, FX_Charset::kANSI, 0, "Arimo");
+        ByteString name;
+        EXPECT_TRUE(font_info->GetFaceName(font, &name));
+        EXPECT_EQ("Arimo", name);
+        font_info->DeleteFont(font);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  // The font info may now go away on any of the threads.
+  font_infos.clear();
+}
@@ -8,9 +8,15 @@
 
 #include <algorithm>
 #include <array>
+#include <vector>
 
+#include "build/build_config.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_system.h"
+#include "core/fxcrt/span_util.h"
+#include "core/fxcrt/zip.h"
+#include "core/fxge/dib/cmyk_simd_impl.h"
+#include "core/fxge/dib/simd_level.h"
 
 namespace fxge {
 
@@ -1665,6 +1671,47 @@ constexpr inline int IndexFromCMYK(int c, int m, int y, int k) {
   return 9 * 9 * 9 * c + 9 * 9 * m + 9 * y + k;
 }
 
+// `kCMYK` with each entry packed as 0x00BBGGRR, so that the SIMD kernels can
+// load an entry with one 32-bit read.
+constexpr std::array<uint32_t, kCMYK.size()> kPackedCMYK = [] {
+  std::array<uint32_t, kCMYK.size()> packed = {};
+  for (size_t i = 0; i < kCMYK.size(); ++i) {
+    packed[i] = kCMYK[i].red | (kCMYK[i].green << 8) | (kCMYK[i].blue << 16);
+  }
+  return packed;
+}();
+
+// Converts to uint8_t with round-to-nearest. Avoid using FXSYS_roundf because
+// it is incredibly expensive with VC++ (tested on VC++ 2015) because round()
+// is very expensive.
+// The 'magic' value of 0.49999997f, the float that precedes 0.5f, was chosen
+// because it gives identical results to FXSYS_roundf(). Using the constant
+// 0.5f gives different results (1 instead of 0) for one value, 0.0019607842.
+// That value is close to the cusp but zero is the correct answer, and
+// getting the same answer as before is desirable.
+// All floats from 0.0 to 1.0 were tested and now give the same results.
+uint8_t ChannelToByte(float value) {
+  static constexpr float kRoundingOffset = 0.49999997f;
+  uint8_t result = static_cast<int>(value * 255.f + kRoundingOffset);
+  DCHECK_EQ(result, FXSYS_roundf(value * 255));
+  return result;
+}
+
+// Multiply by a constant rather than dividing because division is much more
+// expensive.
+constexpr float kToFloat = 1.0f / 255.0f;
+
+const simd_internal::CmykKernels* GetKernels() {
+  static constexpr SimdKernelSet<simd_internal::CmykKernels> kKernels = {
+#if defined(ARCH_CPU_X86_FAMILY)
+      .sse2 = &simd_internal::GetSse2CmykKernels,
+#elif defined(ARCH_CPU_ARM64)
+      .neon = &simd_internal::GetNeonCmykKernels,
+#endif
+  };
+  return GetSimdKernels(kKernels);
+}
+
 }  // namespace
 
 FX_RGB_STRUCT<uint8_t> AdobeCMYK_to_sRGB1(uint8_t c,
@@ -1737,31 +1784,29 @@ FX_RGB_STRUCT<uint8_t> AdobeCMYK_to_sRGB1(uint8_t c,
           static_cast<uint8_t>(fix_b)};
 }
 
-FX_RGB_STRUCT<float> AdobeCMYK_to_sRGB(float c, float m, float y, float k) {
-  // Convert to uint8_t with round-to-nearest. Avoid using FXSYS_roundf because
-  // it is incredibly expensive with VC++ (tested on VC++ 2015) because round()
-  // is very expensive.
-  // The 'magic' value of 0.49999997f, the float that precedes 0.5f, was chosen
-  // because it gives identical results to FXSYS_roundf(). Using the constant
-  // 0.5f gives different results (1 instead of 0) for one value, 0.0019607842.
-  // That value is close to the cusp but zero is the correct answer, and
-  // getting the same answer as before is desirable.
-  // All floats from 0.0 to 1.0 were tested and now give the same results.
-  static constexpr float kRoundingOffset = 0.49999997f;
-  uint8_t c1 = static_cast<int>(c * 255.f + kRoundingOffset);
-  uint8_t m1 = static_cast<int>(m * 255.f + kRoundingOffset);
-  uint8_t y1 = static_cast<int>(y * 255.f + kRoundingOffset);
-  uint8_t k1 = static_cast<int>(k * 255.f + kRoundingOffset);
-
-  DCHECK_EQ(c1, FXSYS_roundf(c * 255));
-  DCHECK_EQ(m1, FXSYS_roundf(m * 255));
-  DCHECK_EQ(y1, FXSYS_roundf(y * 255));
-  DCHECK_EQ(k1, FXSYS_roundf(k * 255));
+void AdobeCMYK_to_sRGB1Row(pdfium::span<const FX_CMYK_STRUCT<uint8_t>> src,
+                           pdfium::span<FX_BGR_STRUCT<uint8_t>> dest) {
+  CHECK_LE(src.size(), dest.size());
+  size_t i = 0;
+  const simd_internal::CmykKernels* kernels = GetKernels();
+  if (kernels) {
+    i = kernels->cmyk_to_bgr_row(
+        kPackedCMYK.data(), fxcrt::reinterpret_span<const uint8_t>(src).data(),
+        fxcrt::reinterpret_span<uint8_t>(dest).data(), src.size());
+  }
+  for (; i < src.size(); ++i) {
+    const FX_CMYK_STRUCT<uint8_t>& cmyk = src[i];
+    const FX_RGB_STRUCT<uint8_t> rgb =
+        AdobeCMYK_to_sRGB1(cmyk.cyan, cmyk.magenta, cmyk.yellow, cmyk.key);
+    dest[i].blue = rgb.blue;
+    dest[i].green = rgb.green;
+    dest[i].red = rgb.red;
+  }
+}
 
-  FX_RGB_STRUCT<uint8_t> int_results = AdobeCMYK_to_sRGB1(c1, m1, y1, k1);
-  // Multiply by a constant rather than dividing because division is much
-  // more expensive.
-  static constexpr float kToFloat = 1.0f / 255.0f;
+FX_RGB_STRUCT<float> AdobeCMYK_to_sRGB(float c, float m, float y, float k) {
+  FX_RGB_STRUCT<uint8_t> int_results = AdobeCMYK_to_sRGB1(
+      ChannelToByte(c), ChannelToByte(m), ChannelToByte(y), ChannelToByte(k));
   return {
       int_results.red * kToFloat,
       int_results.green * kToFloat,
@@ -1769,4 +1814,26 @@ FX_RGB_STRUCT<float> AdobeCMYK_to_sRGB(float c, float m, float y, float k) {
   };
 }
 
+void AdobeCMYK_to_sRGBRow(pdfium::span<const FX_CMYK_STRUCT<float>> src,
+                          pdfium::span<FX_RGB_STRUCT<float>> dest) {
+  std::vector<FX_CMYK_STRUCT<uint8_t>> int_src(src.size());
+  for (auto [cmyk, int_cmyk] : fxcrt::Zip(src, int_src)) {
+    int_cmyk = {
+        ChannelToByte(cmyk.cyan),
+        ChannelToByte(cmyk.magenta),
+        ChannelToByte(cmyk.yellow),
+        ChannelToByte(cmyk.key),
+    };
+  }
+  std::vector<FX_BGR_STRUCT<uint8_t>> int_results(src.size());
+  AdobeCMYK_to_sRGB1Row(int_src, int_results);
+  for (auto [bgr, rgb] : fxcrt::Zip(int_results, dest)) {
+    rgb = {
+        bgr.red * kToFloat,
+        bgr.green * kToFloat,
+        bgr.blue * kToFloat,
+    };
+  }
+}
+
 }  // namespace fxge
@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 
+#include "core/fxcrt/span.h"
 #include "core/fxge/dib/fx_dib.h"
 
 namespace fxge {
@@ -19,9 +20,22 @@ FX_RGB_STRUCT<uint8_t> AdobeCMYK_to_sRGB1(uint8_t c,
                                           uint8_t y,
                                           uint8_t k);
 
+// Converts each pixel of `src` as AdobeCMYK_to_sRGB1() does, using the SIMD
+// kernels for GetSimdLevel() where there are some. The results do not depend
+// on it. `dest` must be at least as long as `src`.
+void AdobeCMYK_to_sRGB1Row(pdfium::span<const FX_CMYK_STRUCT<uint8_t>> src,
+                           pdfium::span<FX_BGR_STRUCT<uint8_t>> dest);
+
+// Same as AdobeCMYK_to_sRGB() for each color of `src`, through
+// AdobeCMYK_to_sRGB1Row(). `dest` must be at least as long as `src`.
+void AdobeCMYK_to_sRGBRow(pdfium::span<const FX_CMYK_STRUCT<float>> src,
+                          pdfium::span<FX_RGB_STRUCT<float>> dest);
+
 }  // namespace fxge
 
 using fxge::AdobeCMYK_to_sRGB;
 using fxge::AdobeCMYK_to_sRGB1;
+using fxge::AdobeCMYK_to_sRGB1Row;
+using fxge::AdobeCMYK_to_sRGBRow;
 
 #endif  // CORE_FXGE_DIB_CFX_CMYK_TO_SRGB_H_
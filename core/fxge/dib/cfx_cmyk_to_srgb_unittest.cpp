@@ -4,6 +4,12 @@
 
 #include "core/fxge/dib/cfx_cmyk_to_srgb.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxge/dib/simd_test_support.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 union Float_t {
@@ -28,3 +34,41 @@ TEST(fxge, CMYKRounding) {
   // Check various other 'special' numbers.
   rgb = AdobeCMYK_to_sRGB(0.0f, 0.25f, 0.5f, 1.0f);
 }
+
+TEST(fxge, CMYKRowSameAsPixels) {
+  // Values at, around and between the table's grid points, which are 32 apart.
+  static constexpr uint8_t kValues[] = {0,   1,   15,  16,  17,  31,  32,  33,
+                                        63,  64,  100, 127, 128, 129, 200, 223,
+                                        224, 225, 239, 240, 254, 255};
+  std::vector<FX_CMYK_STRUCT<uint8_t>> src;
+  for (uint8_t c : kValues) {
+    for (uint8_t m : kValues) {
+      for (uint8_t y : kValues) {
+        for (uint8_t k : kValues) {
+          src.push_back({c, m, y, k});
+        }
+      }
+    }
+  }
+  // Leave a few pixels for the scalar tail.
+  src.resize(src.size() - 3);
+
+  std::vector<FX_BGR_STRUCT<uint8_t>> expected(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    FX_RGB_STRUCT<uint8_t> rgb = AdobeCMYK_to_sRGB1(
+        src[i].cyan, src[i].magenta, src[i].yellow, src[i].key);
+    expected[i] = {rgb.blue, rgb.green, rgb.red};
+  }
+
+  auto check = [&] {
+    std::vector<FX_BGR_STRUCT<uint8_t>> actual(src.size());
+    AdobeCMYK_to_sRGB1Row(src, actual);
+    for (size_t i = 0; i < src.size(); ++i) {
+      ASSERT_EQ(expected[i].blue, actual[i].blue) << i;
+      ASSERT_EQ(expected[i].green, actual[i].green) << i;
+      ASSERT_EQ(expected[i].red, actual[i].red) << i;
+    }
+  };
+  fxge::RunWithoutSimd(check);
+  fxge::ForEachSupportedSimdLevel(check);
+}
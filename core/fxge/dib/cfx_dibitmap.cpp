@@ -51,6 +51,7 @@ bool CFX_DIBitmap::Create(int width,
                           uint8_t* pBuffer,
                           uint32_t pitch) {
   buffer_ = nullptr;
+  buffer_owner_.Reset();
   SetFormat(format);
   SetWidth(0);
   SetHeight(0);
@@ -82,6 +83,21 @@ bool CFX_DIBitmap::Create(int width,
   return true;
 }
 
+bool CFX_DIBitmap::Create(int width,
+                          int height,
+                          FXDIB_Format format,
+                          pdfium::span<uint8_t> buffer,
+                          uint32_t pitch,
+                          RetainPtr<const Retainable> buffer_owner) {
+  CHECK(!buffer.empty());
+  if (!Create(width, height, format, buffer.data(), pitch)) {
+    return false;
+  }
+  CHECK_LE(GetBuffer().size(), buffer.size());
+  buffer_owner_ = std::move(buffer_owner);
+  return true;
+}
+
 bool CFX_DIBitmap::Copy(RetainPtr<const CFX_DIBBase> source) {
   if (buffer_) {
     return false;
@@ -139,6 +155,7 @@ RetainPtr<const CFX_DIBitmap> CFX_DIBitmap::RealizeIfNeeded() const {
 
 void CFX_DIBitmap::TakeOver(RetainPtr<CFX_DIBitmap>&& pSrcBitmap) {
   buffer_ = std::move(pSrcBitmap->buffer_);
+  buffer_owner_ = std::move(pSrcBitmap->buffer_owner_);
   palette_ = std::move(pSrcBitmap->palette_);
   pSrcBitmap->buffer_ = nullptr;
   SetFormat(pSrcBitmap->GetFormat());
@@ -981,6 +998,7 @@ bool CFX_DIBitmap::ConvertFormat(FXDIB_Format dest_format) {
                            GetHeight(), holder, /*src_left=*/0,
                            /*src_top=*/0);
   buffer_ = std::move(dest_buf);
+  buffer_owner_.Reset();
   SetFormat(dest_format);
   SetPitch(dest_pitch);
   return true;
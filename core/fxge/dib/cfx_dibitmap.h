@@ -56,6 +56,15 @@ class CFX_DIBitmap final : public CFX_DIBBase {
                             FXDIB_Format format,
                             uint8_t* pBuffer,
                             uint32_t pitch);
+  // Same as the above, for pixels in `buffer`, which `buffer_owner` keeps
+  // alive. The bitmap holds on to `buffer_owner` for as long as it uses
+  // `buffer`, so that it can share one allocation with other bitmaps.
+  [[nodiscard]] bool Create(int width,
+                            int height,
+                            FXDIB_Format format,
+                            pdfium::span<uint8_t> buffer,
+                            uint32_t pitch,
+                            RetainPtr<const Retainable> buffer_owner);
 
   bool Copy(RetainPtr<const CFX_DIBBase> source);
 
@@ -202,6 +211,8 @@ class CFX_DIBitmap final : public CFX_DIBBase {
                                   int src_left,
                                   int src_top);
 
+  // Keeps an unowned `buffer_` alive, if set.
+  RetainPtr<const Retainable> buffer_owner_;
   MaybeOwned<uint8_t, FxFreeDeleter> buffer_;
 };
 
@@ -6,7 +6,11 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <utility>
+
 #include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 #include "core/fxge/dib/fx_dib.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -16,6 +20,20 @@ namespace {
 
 using ::testing::ElementsAre;
 
+// Pixels that set `destroyed` when they go away.
+class BufferOwner final : public Retainable {
+ public:
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  std::array<uint8_t, 16> data = {};
+
+ private:
+  explicit BufferOwner(bool* destroyed) : destroyed_(destroyed) {}
+  ~BufferOwner() override { *destroyed_ = true; }
+
+  bool* const destroyed_;
+};
+
 }  // namespace
 
 TEST(CFXDIBitmapTest, Create) {
@@ -26,6 +44,25 @@ TEST(CFXDIBitmapTest, Create) {
   EXPECT_TRUE(pBitmap->Create(400, 300, FXDIB_Format::k1bppRgb));
 }
 
+TEST(CFXDIBitmapTest, CreateWithBufferOwner) {
+  bool destroyed = false;
+  auto owner = pdfium::MakeRetain<BufferOwner>(&destroyed);
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  ASSERT_TRUE(bitmap->Create(4, 4, FXDIB_Format::k8bppMask, owner->data,
+                             /*pitch=*/4, owner));
+  EXPECT_EQ(owner->data.data(), bitmap->GetBuffer().data());
+
+  // The bitmap keeps its pixels alive, also when another bitmap takes them.
+  owner.Reset();
+  EXPECT_FALSE(destroyed);
+  auto other = pdfium::MakeRetain<CFX_DIBitmap>();
+  other->TakeOver(std::move(bitmap));
+  bitmap.Reset();
+  EXPECT_FALSE(destroyed);
+  other.Reset();
+  EXPECT_TRUE(destroyed);
+}
+
 TEST(CFXDIBitmapTest, CalculatePitchAndSizeGood) {
   // Simple case with no provided pitch.
   std::optional<CFX_DIBitmap::PitchAndSize> result =
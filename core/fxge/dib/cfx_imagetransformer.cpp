@@ -105,13 +105,19 @@ void AdjustCoords(const FX_RECT& clip_rect, int* col, int* row) {
 
 // Let the compiler deduce the type for |func|, which cheaper than specifying it
 // with std::function.
+//
+// `calc_data.matrix` maps from the top left of `unclipped_result`, so that
+// the fixed point positions of a pixel do not depend on the clip.
 template <typename F>
 void DoBilinearLoop(const CFX_ImageTransformer::CalcData& calc_data,
                     const FX_RECT& result_rect,
+                    const FX_RECT& unclipped_result,
                     const FX_RECT& clip_rect,
                     int increment,
                     const F& func) {
   CFX_BilinearMatrix matrix_fix(calc_data.matrix);
+  const int offset_x = result_rect.left - unclipped_result.left;
+  const int offset_y = result_rect.top - unclipped_result.top;
   for (int row = 0; row < result_rect.Height(); row++) {
     uint8_t* dest = calc_data.bitmap->GetWritableScanline(row).data();
     for (int col = 0; col < result_rect.Width(); col++) {
@@ -120,8 +126,10 @@ void DoBilinearLoop(const CFX_ImageTransformer::CalcData& calc_data,
       d.res_y = 0;
       d.src_col_l = 0;
       d.src_row_l = 0;
-      matrix_fix.Transform(col, row, &d.src_col_l, &d.src_row_l, &d.res_x,
-                           &d.res_y);
+      matrix_fix.Transform(col + offset_x, row + offset_y, &d.src_col_l,
+                           &d.src_row_l, &d.res_x, &d.res_y);
+      d.src_col_l -= clip_rect.left;
+      d.src_row_l -= clip_rect.top;
       if (LIKELY(InStretchBounds(clip_rect, d.src_col_l, d.src_row_l))) {
         AdjustCoords(clip_rect, &d.src_col_l, &d.src_row_l);
         d.src_col_r = d.src_col_l + 1;
@@ -154,6 +162,7 @@ CFX_ImageTransformer::CFX_ImageTransformer(RetainPtr<const CFX_DIBBase> source,
   }
 
   result_ = result_clip;
+  unclipped_result_ = result_rect;
   if (fabs(matrix_.a) < fabs(matrix_.b) / 20 &&
       fabs(matrix_.d) < fabs(matrix_.c) / 20 && fabs(matrix_.a) < 0.5f &&
       fabs(matrix_.d) < 0.5f) {
@@ -200,8 +209,11 @@ CFX_ImageTransformer::CFX_ImageTransformer(RetainPtr<const CFX_DIBBase> source,
                  matrix_.e, matrix_.f));
   CFX_Matrix dest_to_strech = stretch_to_dest.GetInverse();
 
-  FX_RECT stretch_clip =
-      dest_to_strech.TransformRect(CFX_FloatRect(result_clip)).GetOuterRect();
+  CFX_FloatRect stretch_rect =
+      dest_to_strech.TransformRect(CFX_FloatRect(result_clip));
+  // Interpolation reads the pixel after the one a result pixel maps to.
+  stretch_rect.Inflate(1.0f, 1.0f);
+  FX_RECT stretch_clip = stretch_rect.GetOuterRect();
   if (!stretch_clip.Valid()) {
     return;
   }
@@ -267,9 +279,9 @@ void CFX_ImageTransformer::ContinueOther(PauseIndicatorIface* pPause) {
     return;
   }
 
-  CFX_Matrix result2stretch(1.0f, 0.0f, 0.0f, 1.0f, result_.left, result_.top);
+  CFX_Matrix result2stretch(1.0f, 0.0f, 0.0f, 1.0f, unclipped_result_.left,
+                            unclipped_result_.top);
   result2stretch.Concat(dest_to_stretch_);
-  result2stretch.Translate(-stretch_clip_.left, -stretch_clip_.top);
 
   CalcData calc_data = {pTransformed.Get(), result2stretch,
                         storer_.GetBitmap()->GetBuffer().data(),
@@ -295,7 +307,8 @@ void CFX_ImageTransformer::CalcAlpha(const CalcData& calc_data) {
   auto func = [&calc_data](const BilinearData& data, uint8_t* dest) {
     *dest = BilinearInterpolate(calc_data.buf, data, 1, 0);
   };
-  DoBilinearLoop(calc_data, result_, stretch_clip_, 1, func);
+  DoBilinearLoop(calc_data, result_, unclipped_result_, stretch_clip_, 1,
+                 func);
 }
 
 void CFX_ImageTransformer::CalcMono(const CalcData& calc_data) {
@@ -314,7 +327,8 @@ void CFX_ImageTransformer::CalcMono(const CalcData& calc_data) {
     uint8_t idx = BilinearInterpolate(calc_data.buf, data, 1, 0);
     *reinterpret_cast<uint32_t*>(dest) = argb[idx];
   };
-  DoBilinearLoop(calc_data, result_, stretch_clip_, dest_bytes_per_pixel, func);
+  DoBilinearLoop(calc_data, result_, unclipped_result_, stretch_clip_,
+                 dest_bytes_per_pixel, func);
 }
 
 void CFX_ImageTransformer::CalcColor(const CalcData& calc_data,
@@ -334,8 +348,8 @@ void CFX_ImageTransformer::CalcColor(const CalcData& calc_data,
           BilinearInterpolate(calc_data.buf, data, src_bytes_per_pixel, 2);
       *reinterpret_cast<uint32_t*>(dest) = ArgbEncode(kOpaqueAlpha, r, g, b);
     };
-    DoBilinearLoop(calc_data, result_, stretch_clip_, dest_bytes_per_pixel,
-                   func);
+    DoBilinearLoop(calc_data, result_, unclipped_result_, stretch_clip_,
+                   dest_bytes_per_pixel, func);
     return;
   }
 
@@ -352,8 +366,8 @@ void CFX_ImageTransformer::CalcColor(const CalcData& calc_data,
           BilinearInterpolate(calc_data.buf, data, src_bytes_per_pixel, 3);
       *reinterpret_cast<uint32_t*>(dest) = ArgbEncode(alpha, r, g, b);
     };
-    DoBilinearLoop(calc_data, result_, stretch_clip_, dest_bytes_per_pixel,
-                   func);
+    DoBilinearLoop(calc_data, result_, unclipped_result_, stretch_clip_,
+                   dest_bytes_per_pixel, func);
     return;
   }
 
@@ -369,5 +383,6 @@ void CFX_ImageTransformer::CalcColor(const CalcData& calc_data,
         BilinearInterpolate(calc_data.buf, data, src_bytes_per_pixel, 3);
     *reinterpret_cast<uint32_t*>(dest) = FXCMYK_TODIB(CmykEncode(c, m, y, k));
   };
-  DoBilinearLoop(calc_data, result_, stretch_clip_, dest_bytes_per_pixel, func);
+  DoBilinearLoop(calc_data, result_, unclipped_result_, stretch_clip_,
+                 dest_bytes_per_pixel, func);
 }
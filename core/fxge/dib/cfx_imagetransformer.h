@@ -71,6 +71,7 @@ class CFX_ImageTransformer {
   const CFX_Matrix matrix_;
   FX_RECT stretch_clip_;
   FX_RECT result_;
+  FX_RECT unclipped_result_;
   CFX_Matrix dest_to_stretch_;
   std::unique_ptr<CFX_ImageStretcher> stretcher_;
   CFX_BitmapStorer storer_;
@@ -7,16 +7,19 @@
 #include "core/fxge/dib/cfx_scanlinecompositor.h"
 
 #include <algorithm>
+#include <type_traits>
 
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/notreached.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxcrt/zip.h"
 #include "core/fxge/dib/blend.h"
+#include "core/fxge/dib/composite_simd.h"
 #include "core/fxge/dib/fx_dib.h"
 
 using fxge::Blend;
@@ -486,6 +489,13 @@ void CompositeRowBgra2Bgr(pdfium::span<const FX_BGRA_STRUCT<uint8_t>> src_span,
                           pdfium::span<const uint8_t> clip_span,
                           pdfium::span<DestPixelStruct> dest_span,
                           BlendMode blend_type) {
+  if constexpr (std::is_same_v<DestPixelStruct, FX_BGRA_STRUCT<uint8_t>>) {
+    const size_t done = fxge::CompositeRowBgra2BgrxSimd(src_span, clip_span,
+                                                        dest_span, blend_type);
+    src_span = src_span.subspan(done);
+    clip_span = clip_span.empty() ? clip_span : clip_span.subspan(done);
+    dest_span = dest_span.subspan(done);
+  }
   const bool non_separable_blend = IsNonSeparableBlendMode(blend_type);
   if (clip_span.empty()) {
     if (non_separable_blend) {
@@ -592,6 +602,13 @@ void CompositeRowBgra2Bgra(pdfium::span<const FX_BGRA_STRUCT<uint8_t>> src_span,
                            pdfium::span<const uint8_t> clip_span,
                            pdfium::span<DestPixelStruct> dest_span,
                            BlendMode blend_type) {
+  if constexpr (std::is_same_v<DestPixelStruct, FX_BGRA_STRUCT<uint8_t>>) {
+    const size_t done = fxge::CompositeRowBgra2BgraSimd(src_span, clip_span,
+                                                        dest_span, blend_type);
+    src_span = src_span.subspan(done);
+    clip_span = clip_span.empty() ? clip_span : clip_span.subspan(done);
+    dest_span = dest_span.subspan(done);
+  }
   const bool non_separable_blend = IsNonSeparableBlendMode(blend_type);
   if (clip_span.empty()) {
     if (non_separable_blend) {
@@ -1182,7 +1199,13 @@ void CompositeRow_ByteMask2Bgra(pdfium::span<DestPixelStruct> dest_span,
                                 int pixel_count,
                                 BlendMode blend_type,
                                 pdfium::span<const uint8_t> clip_span) {
-  for (int col = 0; col < pixel_count; col++) {
+  int col = 0;
+  if constexpr (std::is_same_v<DestPixelStruct, FX_BGRA_STRUCT<uint8_t>>) {
+    col = pdfium::checked_cast<int>(fxge::CompositeRowByteMask2BgraSimd(
+        src_span.first(static_cast<size_t>(pixel_count)), mask, clip_span,
+        dest_span, blend_type));
+  }
+  for (; col < pixel_count; col++) {
     const int src_alpha = GetAlphaWithSrc(mask.alpha, clip_span, src_span, col);
     auto& dest = dest_span[col];
     const uint8_t back_alpha = dest.alpha;
@@ -1220,9 +1243,17 @@ void CompositeRow_ByteMask2Rgb(pdfium::span<uint8_t> dest_span,
                                BlendMode blend_type,
                                int Bpp,
                                pdfium::span<const uint8_t> clip_span) {
-  uint8_t* dest_scan = dest_span.data();
+  int col = 0;
+  if (Bpp == 4) {
+    col = pdfium::checked_cast<int>(fxge::CompositeRowByteMask2BgrxSimd(
+        src_span.first(static_cast<size_t>(pixel_count)), mask, clip_span,
+        fxcrt::reinterpret_span<FX_BGRA_STRUCT<uint8_t>>(dest_span),
+        blend_type));
+  }
+  uint8_t* dest_scan =
+      dest_span.subspan(static_cast<size_t>(col * Bpp)).data();
   UNSAFE_TODO({
-    for (int col = 0; col < pixel_count; col++) {
+    for (; col < pixel_count; col++) {
       int src_alpha = GetAlphaWithSrc(mask.alpha, clip_span, src_span, col);
       if (src_alpha == 0) {
         dest_scan += Bpp;
@@ -0,0 +1,32 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_CMYK_SIMD_IMPL_H_
+#define CORE_FXGE_DIB_CMYK_SIMD_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared by the per-instruction set translation units. See
+// composite_simd_impl.h for what may go in here.
+
+namespace fxge::simd_internal {
+
+struct CmykKernels {
+  // Converts the leading pixels of `src`, 4 bytes of C, M, Y and K each, to
+  // `dest`, 3 bytes of B, G and R each, as AdobeCMYK_to_sRGB1() does. Returns
+  // how many pixels it converted. `table` is the 9^4 entry table that
+  // AdobeCMYK_to_sRGB1() interpolates, with each entry packed as 0x00BBGGRR.
+  size_t (*cmyk_to_bgr_row)(const uint32_t* table,
+                            const uint8_t* src,
+                            uint8_t* dest,
+                            size_t pixel_count);
+};
+
+const CmykKernels& GetSse2CmykKernels();
+const CmykKernels& GetNeonCmykKernels();
+
+}  // namespace fxge::simd_internal
+
+#endif  // CORE_FXGE_DIB_CMYK_SIMD_IMPL_H_
@@ -0,0 +1,145 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxge/dib/cmyk_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// One of the C, M, Y and K axes of the table, for 4 pixels.
+struct Axis {
+  // The nearest grid point, as in AdobeCMYK_to_sRGB1().
+  int32x4_t index;
+  // How far the table entry of the grid point the pixels interpolate towards
+  // is from the one at `index`.
+  int32x4_t other_offset;
+  // The interpolation rate towards that grid point.
+  int32x4_t rate;
+};
+
+Axis GetAxis(int32x4_t value, int32_t stride) {
+  const int32x4_t fix = vshlq_n_s32(value, 8);
+  const int32x4_t index = vshrq_n_s32(vaddq_s32(fix, vdupq_n_s32(4096)), 13);
+  // `value` is at most 255, so `fix >> 13` is at most 7. Where it matches
+  // `index`, the other grid point is the next one up. Otherwise, it is the one
+  // below `index`.
+  const uint32x4_t next_up = vceqq_s32(vshrq_n_s32(fix, 13), index);
+  const int32x4_t delta = vsubq_s32(fix, vshlq_n_s32(index, 13));
+  return {
+      .index = index,
+      .other_offset =
+          vbslq_s32(next_up, vdupq_n_s32(stride), vdupq_n_s32(-stride)),
+      // `delta` times the difference between the grid points, which is -1
+      // where `next_up` is set and 1 elsewhere.
+      .rate = vbslq_s32(next_up, vnegq_s32(delta), delta),
+  };
+}
+
+int32x4_t LoadEntries(const uint32_t* table, int32x4_t indices) {
+  int32_t lanes[4];
+  vst1q_s32(lanes, indices);
+  uint32_t entries[4];
+  // SAFETY: the indices are for grid points in [0, 8] on every axis.
+  UNSAFE_BUFFERS({
+    for (int lane = 0; lane < 4; ++lane) {
+      entries[lane] = table[lanes[lane]];
+    }
+  });
+  return vreinterpretq_s32_u32(vld1q_u32(entries));
+}
+
+// The channel at `kShift` of packed table entries.
+template <int kShift>
+int32x4_t GetChannel(int32x4_t entries) {
+  if constexpr (kShift == 0) {
+    return vandq_s32(entries, vdupq_n_s32(0xff));
+  } else {
+    return vandq_s32(vshrq_n_s32(entries, kShift), vdupq_n_s32(0xff));
+  }
+}
+
+// (start - other) * rate / 32 for the channel at `kShift`, rounding towards 0
+// as C++ division does.
+template <int kShift>
+int32x4_t Interpolate(int32x4_t start, int32x4_t other, int32x4_t rate) {
+  const int32x4_t product = vmulq_s32(
+      vsubq_s32(GetChannel<kShift>(start), GetChannel<kShift>(other)), rate);
+  const int32x4_t bias = vreinterpretq_s32_u32(
+      vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(product, 31)), 27));
+  return vshrq_n_s32(vaddq_s32(product, bias), 5);
+}
+
+// std::max(fix, 0) >> 8, keeping the low byte as the cast to uint8_t does.
+uint32x4_t ToByte(int32x4_t fix) {
+  return vandq_u32(
+      vreinterpretq_u32_s32(vshrq_n_s32(vmaxq_s32(fix, vdupq_n_s32(0)), 8)),
+      vdupq_n_u32(0xff));
+}
+
+size_t CmykToBgrRow(const uint32_t* table,
+                    const uint8_t* src,
+                    uint8_t* dest,
+                    size_t pixel_count) {
+  const int32x4_t byte_mask = vdupq_n_s32(0xff);
+  size_t i = 0;
+  // SAFETY: the caller makes sure `src` has `pixel_count` 4-byte pixels and
+  // `dest` has room for as many 3-byte pixels.
+  UNSAFE_BUFFERS({
+    for (; i + 4 <= pixel_count; i += 4) {
+      const int32x4_t cmyk = vreinterpretq_s32_u8(vld1q_u8(src + i * 4));
+      const Axis axes[4] = {
+          GetAxis(vandq_s32(cmyk, byte_mask), 9 * 9 * 9),
+          GetAxis(vandq_s32(vshrq_n_s32(cmyk, 8), byte_mask), 9 * 9),
+          GetAxis(vandq_s32(vshrq_n_s32(cmyk, 16), byte_mask), 9),
+          GetAxis(vreinterpretq_s32_u32(
+                      vshrq_n_u32(vreinterpretq_u32_s32(cmyk), 24)),
+                  1),
+      };
+      const int32x4_t start_index = vaddq_s32(
+          vaddq_s32(vmulq_n_s32(axes[0].index, 9 * 9 * 9),
+                    vmulq_n_s32(axes[1].index, 9 * 9)),
+          vaddq_s32(vmulq_n_s32(axes[2].index, 9), axes[3].index));
+      const int32x4_t start = LoadEntries(table, start_index);
+      int32x4_t red = vshlq_n_s32(GetChannel<0>(start), 8);
+      int32x4_t green = vshlq_n_s32(GetChannel<8>(start), 8);
+      int32x4_t blue = vshlq_n_s32(GetChannel<16>(start), 8);
+      for (const Axis& axis : axes) {
+        const int32x4_t other =
+            LoadEntries(table, vaddq_s32(start_index, axis.other_offset));
+        red = vaddq_s32(red, Interpolate<0>(start, other, axis.rate));
+        green = vaddq_s32(green, Interpolate<8>(start, other, axis.rate));
+        blue = vaddq_s32(blue, Interpolate<16>(start, other, axis.rate));
+      }
+
+      uint32_t bgr[4];
+      vst1q_u32(bgr, vorrq_u32(vorrq_u32(ToByte(blue),
+                                         vshlq_n_u32(ToByte(green), 8)),
+                               vshlq_n_u32(ToByte(red), 16)));
+      uint8_t* dest_pixel = dest + i * 3;
+      for (uint32_t pixel : bgr) {
+        dest_pixel[0] = static_cast<uint8_t>(pixel);
+        dest_pixel[1] = static_cast<uint8_t>(pixel >> 8);
+        dest_pixel[2] = static_cast<uint8_t>(pixel >> 16);
+        dest_pixel += 3;
+      }
+    }
+  });
+  return i;
+}
+
+constexpr CmykKernels kKernels = {
+    .cmyk_to_bgr_row = &CmykToBgrRow,
+};
+
+}  // namespace
+
+const CmykKernels& GetNeonCmykKernels() {
+  return kKernels;
+}
+
+}  // namespace fxge::simd_internal
@@ -0,0 +1,146 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <emmintrin.h>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxge/dib/cmyk_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// One of the C, M, Y and K axes of the table, for 4 pixels.
+struct Axis {
+  // The nearest grid point, as in AdobeCMYK_to_sRGB1().
+  __m128i index;
+  // How far the table entry of the grid point the pixels interpolate towards
+  // is from the one at `index`.
+  __m128i other_offset;
+  // The interpolation rate towards that grid point.
+  __m128i rate;
+};
+
+Axis GetAxis(__m128i value, int stride) {
+  const __m128i fix = _mm_slli_epi32(value, 8);
+  const __m128i index =
+      _mm_srai_epi32(_mm_add_epi32(fix, _mm_set1_epi32(4096)), 13);
+  // `value` is at most 255, so `fix >> 13` is at most 7. Where it matches
+  // `index`, the other grid point is the next one up. Otherwise, it is the one
+  // below `index`.
+  const __m128i next_up = _mm_cmpeq_epi32(_mm_srai_epi32(fix, 13), index);
+  const __m128i delta = _mm_sub_epi32(fix, _mm_slli_epi32(index, 13));
+  return {
+      .index = index,
+      .other_offset =
+          _mm_add_epi32(_mm_set1_epi32(-stride),
+                        _mm_and_si128(next_up, _mm_set1_epi32(2 * stride))),
+      // `delta` times the difference between the grid points, which is -1
+      // where `next_up` is set and 1 elsewhere.
+      .rate = _mm_sub_epi32(_mm_xor_si128(delta, next_up), next_up),
+  };
+}
+
+__m128i LoadEntries(const uint32_t* table, __m128i indices) {
+  alignas(16) int32_t lanes[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(lanes), indices);
+  // SAFETY: the indices are for grid points in [0, 8] on every axis.
+  return UNSAFE_BUFFERS(_mm_setr_epi32(
+      static_cast<int>(table[lanes[0]]), static_cast<int>(table[lanes[1]]),
+      static_cast<int>(table[lanes[2]]), static_cast<int>(table[lanes[3]])));
+}
+
+// The channel at `kShift` of packed table entries.
+template <int kShift>
+__m128i GetChannel(__m128i entries) {
+  return _mm_and_si128(_mm_srli_epi32(entries, kShift), _mm_set1_epi32(0xff));
+}
+
+// (start - other) * rate / 32 for the channel at `kShift`, rounding towards 0
+// as C++ division does.
+template <int kShift>
+__m128i Interpolate(__m128i start, __m128i other, __m128i rate) {
+  const __m128i diff =
+      _mm_sub_epi32(GetChannel<kShift>(start), GetChannel<kShift>(other));
+  // SSE2 has no 32-bit multiply, but both factors fit in 16 bits. With the
+  // upper halves cleared, _mm_madd_epi16() gives their 32-bit products.
+  const __m128i low_half = _mm_set1_epi32(0xffff);
+  const __m128i product = _mm_madd_epi16(_mm_and_si128(diff, low_half),
+                                         _mm_and_si128(rate, low_half));
+  const __m128i bias = _mm_srli_epi32(_mm_srai_epi32(product, 31), 27);
+  return _mm_srai_epi32(_mm_add_epi32(product, bias), 5);
+}
+
+// std::max(fix, 0) >> 8, keeping the low byte as the cast to uint8_t does.
+__m128i ToByte(__m128i fix) {
+  const __m128i clamped = _mm_andnot_si128(_mm_srai_epi32(fix, 31), fix);
+  return _mm_and_si128(_mm_srli_epi32(clamped, 8), _mm_set1_epi32(0xff));
+}
+
+size_t CmykToBgrRow(const uint32_t* table,
+                    const uint8_t* src,
+                    uint8_t* dest,
+                    size_t pixel_count) {
+  const __m128i byte_mask = _mm_set1_epi32(0xff);
+  size_t i = 0;
+  // SAFETY: the caller makes sure `src` has `pixel_count` 4-byte pixels and
+  // `dest` has room for as many 3-byte pixels.
+  UNSAFE_BUFFERS({
+    for (; i + 4 <= pixel_count; i += 4) {
+      const __m128i cmyk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+      const Axis axes[4] = {
+          GetAxis(_mm_and_si128(cmyk, byte_mask), 9 * 9 * 9),
+          GetAxis(_mm_and_si128(_mm_srli_epi32(cmyk, 8), byte_mask), 9 * 9),
+          GetAxis(_mm_and_si128(_mm_srli_epi32(cmyk, 16), byte_mask), 9),
+          GetAxis(_mm_srli_epi32(cmyk, 24), 1),
+      };
+      // The products fit in 16 bits, and the upper halves of the lanes are 0.
+      const __m128i start_index = _mm_add_epi32(
+          _mm_add_epi32(
+              _mm_mullo_epi16(axes[0].index, _mm_set1_epi32(9 * 9 * 9)),
+              _mm_mullo_epi16(axes[1].index, _mm_set1_epi32(9 * 9))),
+          _mm_add_epi32(_mm_mullo_epi16(axes[2].index, _mm_set1_epi32(9)),
+                        axes[3].index));
+      const __m128i start = LoadEntries(table, start_index);
+      __m128i red = _mm_slli_epi32(GetChannel<0>(start), 8);
+      __m128i green = _mm_slli_epi32(GetChannel<8>(start), 8);
+      __m128i blue = _mm_slli_epi32(GetChannel<16>(start), 8);
+      for (const Axis& axis : axes) {
+        const __m128i other = LoadEntries(
+            table, _mm_add_epi32(start_index, axis.other_offset));
+        red = _mm_add_epi32(red, Interpolate<0>(start, other, axis.rate));
+        green = _mm_add_epi32(green, Interpolate<8>(start, other, axis.rate));
+        blue = _mm_add_epi32(blue, Interpolate<16>(start, other, axis.rate));
+      }
+
+      alignas(16) uint32_t bgr[4];
+      _mm_store_si128(
+          reinterpret_cast<__m128i*>(bgr),
+          _mm_or_si128(_mm_or_si128(ToByte(blue),
+                                    _mm_slli_epi32(ToByte(green), 8)),
+                       _mm_slli_epi32(ToByte(red), 16)));
+      uint8_t* dest_pixel = dest + i * 3;
+      for (uint32_t pixel : bgr) {
+        dest_pixel[0] = static_cast<uint8_t>(pixel);
+        dest_pixel[1] = static_cast<uint8_t>(pixel >> 8);
+        dest_pixel[2] = static_cast<uint8_t>(pixel >> 16);
+        dest_pixel += 3;
+      }
+    }
+  });
+  return i;
+}
+
+constexpr CmykKernels kKernels = {
+    .cmyk_to_bgr_row = &CmykToBgrRow,
+};
+
+}  // namespace
+
+const CmykKernels& GetSse2CmykKernels() {
+  return kKernels;
+}
+
+}  // namespace fxge::simd_internal
@@ -0,0 +1,108 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/composite_simd.h"
+
+#include <algorithm>
+
+#include "build/build_config.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/composite_simd_impl.h"
+#include "core/fxge/dib/simd_level.h"
+
+namespace fxge {
+
+namespace {
+
+const simd_internal::CompositeKernels* GetKernels(BlendMode blend_type) {
+  if (!simd_internal::IsSimdBlendMode(blend_type)) {
+    return nullptr;
+  }
+  static constexpr SimdKernelSet<simd_internal::CompositeKernels> kKernels = {
+#if defined(ARCH_CPU_X86_FAMILY)
+      .sse2 = &simd_internal::GetSse2CompositeKernels,
+      .avx2 = &simd_internal::GetAvx2CompositeKernels,
+#elif defined(ARCH_CPU_ARM64)
+      .neon = &simd_internal::GetNeonCompositeKernels,
+#endif
+  };
+  return GetSimdKernels(kKernels);
+}
+
+// The number of pixels both the row and the optional clip cover.
+size_t GetPixelCount(size_t src_size,
+                     size_t dest_size,
+                     pdfium::span<const uint8_t> clip_span) {
+  CHECK_LE(src_size, dest_size);
+  return clip_span.empty() ? src_size : std::min(src_size, clip_span.size());
+}
+
+}  // namespace
+
+size_t CompositeRowBgra2BgraSimd(
+    pdfium::span<const FX_BGRA_STRUCT<uint8_t>> src_span,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type) {
+  const simd_internal::CompositeKernels* kernels = GetKernels(blend_type);
+  if (!kernels) {
+    return 0;
+  }
+  return kernels->bgra_to_bgra(
+      reinterpret_cast<const uint8_t*>(src_span.data()),
+      clip_span.empty() ? nullptr : clip_span.data(),
+      reinterpret_cast<uint8_t*>(dest_span.data()),
+      GetPixelCount(src_span.size(), dest_span.size(), clip_span), blend_type);
+}
+
+size_t CompositeRowBgra2BgrxSimd(
+    pdfium::span<const FX_BGRA_STRUCT<uint8_t>> src_span,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type) {
+  const simd_internal::CompositeKernels* kernels = GetKernels(blend_type);
+  if (!kernels) {
+    return 0;
+  }
+  return kernels->bgra_to_bgrx(
+      reinterpret_cast<const uint8_t*>(src_span.data()),
+      clip_span.empty() ? nullptr : clip_span.data(),
+      reinterpret_cast<uint8_t*>(dest_span.data()),
+      GetPixelCount(src_span.size(), dest_span.size(), clip_span), blend_type);
+}
+
+size_t CompositeRowByteMask2BgraSimd(
+    pdfium::span<const uint8_t> src_span,
+    const FX_BGRA_STRUCT<uint8_t>& mask,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type) {
+  const simd_internal::CompositeKernels* kernels = GetKernels(blend_type);
+  if (!kernels) {
+    return 0;
+  }
+  return kernels->byte_mask_to_bgra(
+      src_span.data(), mask, clip_span.empty() ? nullptr : clip_span.data(),
+      reinterpret_cast<uint8_t*>(dest_span.data()),
+      GetPixelCount(src_span.size(), dest_span.size(), clip_span), blend_type);
+}
+
+size_t CompositeRowByteMask2BgrxSimd(
+    pdfium::span<const uint8_t> src_span,
+    const FX_BGRA_STRUCT<uint8_t>& mask,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type) {
+  const simd_internal::CompositeKernels* kernels = GetKernels(blend_type);
+  if (!kernels) {
+    return 0;
+  }
+  return kernels->byte_mask_to_bgrx(
+      src_span.data(), mask, clip_span.empty() ? nullptr : clip_span.data(),
+      reinterpret_cast<uint8_t*>(dest_span.data()),
+      GetPixelCount(src_span.size(), dest_span.size(), clip_span), blend_type);
+}
+
+}  // namespace fxge
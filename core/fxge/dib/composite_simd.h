@@ -0,0 +1,56 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_COMPOSITE_SIMD_H_
+#define CORE_FXGE_DIB_COMPOSITE_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/fx_dib.h"
+
+namespace fxge {
+
+// The functions below composite as many leading pixels of a row as they can
+// in whole vectors, and return how many pixels they wrote. The caller is
+// responsible for the rest of the row. Results are bit-identical to the scalar
+// code in cfx_scanlinecompositor.cpp. They return 0 when SIMD is unavailable or
+// `blend_type` is not one they implement, which is currently the non-separable
+// modes and kSoftLight.
+
+// Composites `src_span` onto a kBgra `dest_span`.
+size_t CompositeRowBgra2BgraSimd(
+    pdfium::span<const FX_BGRA_STRUCT<uint8_t>> src_span,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type);
+
+// Composites `src_span` onto a kBgrx `dest_span`, leaving the x bytes as is.
+size_t CompositeRowBgra2BgrxSimd(
+    pdfium::span<const FX_BGRA_STRUCT<uint8_t>> src_span,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type);
+
+// Composites `mask` in the 8bpp mask `src_span` onto a kBgra `dest_span`.
+size_t CompositeRowByteMask2BgraSimd(
+    pdfium::span<const uint8_t> src_span,
+    const FX_BGRA_STRUCT<uint8_t>& mask,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type);
+
+// Composites `mask` in the 8bpp mask `src_span` onto a kBgrx `dest_span`,
+// leaving the x bytes as is.
+size_t CompositeRowByteMask2BgrxSimd(
+    pdfium::span<const uint8_t> src_span,
+    const FX_BGRA_STRUCT<uint8_t>& mask,
+    pdfium::span<const uint8_t> clip_span,
+    pdfium::span<FX_BGRA_STRUCT<uint8_t>> dest_span,
+    BlendMode blend_type);
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_DIB_COMPOSITE_SIMD_H_
@@ -0,0 +1,112 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Built with AVX2 enabled. Only reached after composite_simd.cpp has checked
+// that the CPU supports it.
+
+#include <immintrin.h>
+
+#include "core/fxge/dib/composite_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// Sixteen pixels per vector. The 256-bit pack and unpack instructions work
+// within 128-bit halves, so channel vectors hold pixels in the order 0-3, 8-11,
+// 4-7, 12-15. StoreBgra() undoes that, and LoadBytes() matches it.
+struct Avx2Ops {
+  using V = __m256i;
+
+  static constexpr size_t kPixels = 16;
+
+  static V Splat(int value) {
+    return _mm256_set1_epi16(static_cast<short>(value));
+  }
+  static V Add(V a, V b) { return _mm256_add_epi16(a, b); }
+  static V Sub(V a, V b) { return _mm256_sub_epi16(a, b); }
+  static V Mul(V a, V b) { return _mm256_mullo_epi16(a, b); }
+  static V Shr8(V a) { return _mm256_srli_epi16(a, 8); }
+  static V Min(V a, V b) { return _mm256_min_epi16(a, b); }
+  static V Max(V a, V b) { return _mm256_max_epi16(a, b); }
+  static V Equal(V a, V b) { return _mm256_cmpeq_epi16(a, b); }
+  static V Greater(V a, V b) { return _mm256_cmpgt_epi16(a, b); }
+  static V And(V a, V b) { return _mm256_and_si256(a, b); }
+
+  static V Select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+
+  static V DivSat(V n, V d) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo = _mm256_cvttps_epi32(
+        _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(n, zero)),
+                      _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(d, zero))));
+    const __m256i hi = _mm256_cvttps_epi32(
+        _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(n, zero)),
+                      _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(d, zero))));
+    return _mm256_packs_epi32(lo, hi);
+  }
+
+  static V MulDiv65025(V a, V b) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256 divisor = _mm256_set1_ps(65025.0f);
+    const __m256i lo = _mm256_cvttps_epi32(_mm256_div_ps(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(a, zero)),
+                      _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(b, zero))),
+        divisor));
+    const __m256i hi = _mm256_cvttps_epi32(_mm256_div_ps(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(a, zero)),
+                      _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(b, zero))),
+        divisor));
+    return _mm256_packs_epi32(lo, hi);
+  }
+
+  static void LoadBgra(const uint8_t* pixels,
+                       V& blue,
+                       V& green,
+                       V& red,
+                       V& alpha) {
+    const __m256i byte_mask = _mm256_set1_epi32(0xff);
+    const __m256i p0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels));
+    // SAFETY: `pixels` holds `kPixels` 4-byte pixels.
+    const __m256i p1 = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(UNSAFE_BUFFERS(pixels + 32)));
+    blue = _mm256_packs_epi32(_mm256_and_si256(p0, byte_mask),
+                              _mm256_and_si256(p1, byte_mask));
+    green = _mm256_packs_epi32(
+        _mm256_and_si256(_mm256_srli_epi32(p0, 8), byte_mask),
+        _mm256_and_si256(_mm256_srli_epi32(p1, 8), byte_mask));
+    red = _mm256_packs_epi32(
+        _mm256_and_si256(_mm256_srli_epi32(p0, 16), byte_mask),
+        _mm256_and_si256(_mm256_srli_epi32(p1, 16), byte_mask));
+    alpha = _mm256_packs_epi32(_mm256_srli_epi32(p0, 24),
+                               _mm256_srli_epi32(p1, 24));
+  }
+
+  static void StoreBgra(uint8_t* pixels, V blue, V green, V red, V alpha) {
+    const __m256i blue_green =
+        _mm256_or_si256(blue, _mm256_slli_epi16(green, 8));
+    const __m256i red_alpha = _mm256_or_si256(red, _mm256_slli_epi16(alpha, 8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels),
+                        _mm256_unpacklo_epi16(blue_green, red_alpha));
+    // SAFETY: `pixels` holds `kPixels` 4-byte pixels.
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(UNSAFE_BUFFERS(pixels + 32)),
+        _mm256_unpackhi_epi16(blue_green, red_alpha));
+  }
+
+  static V LoadBytes(const uint8_t* bytes) {
+    const __m256i widened = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)));
+    return _mm256_permute4x64_epi64(widened, 0xd8);
+  }
+};
+
+}  // namespace
+
+const CompositeKernels& GetAvx2CompositeKernels() {
+  return CompositeKernelsImpl<Avx2Ops>::kKernels;
+}
+
+}  // namespace fxge::simd_internal
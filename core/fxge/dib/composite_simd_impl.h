@@ -0,0 +1,374 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_COMPOSITE_SIMD_IMPL_H_
+#define CORE_FXGE_DIB_COMPOSITE_SIMD_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxge/dib/fx_dib.h"
+
+// Shared by the per-instruction set translation units. Some of those are built
+// with flags the baseline CPU may not support, so this header must stay free
+// of anything that could emit out-of-line code with external linkage. The
+// kernels take raw pointers for the same reason.
+
+namespace fxge::simd_internal {
+
+struct CompositeKernels {
+  size_t (*bgra_to_bgra)(const uint8_t* src,
+                         const uint8_t* clip,
+                         uint8_t* dest,
+                         size_t pixel_count,
+                         BlendMode blend_type);
+  size_t (*bgra_to_bgrx)(const uint8_t* src,
+                         const uint8_t* clip,
+                         uint8_t* dest,
+                         size_t pixel_count,
+                         BlendMode blend_type);
+  size_t (*byte_mask_to_bgra)(const uint8_t* src,
+                              const FX_BGRA_STRUCT<uint8_t>& mask,
+                              const uint8_t* clip,
+                              uint8_t* dest,
+                              size_t pixel_count,
+                              BlendMode blend_type);
+  size_t (*byte_mask_to_bgrx)(const uint8_t* src,
+                              const FX_BGRA_STRUCT<uint8_t>& mask,
+                              const uint8_t* clip,
+                              uint8_t* dest,
+                              size_t pixel_count,
+                              BlendMode blend_type);
+};
+
+const CompositeKernels& GetSse2CompositeKernels();
+const CompositeKernels& GetAvx2CompositeKernels();
+const CompositeKernels& GetNeonCompositeKernels();
+
+constexpr bool IsSimdBlendMode(BlendMode blend_type) {
+  switch (blend_type) {
+    case BlendMode::kNormal:
+    case BlendMode::kMultiply:
+    case BlendMode::kScreen:
+    case BlendMode::kOverlay:
+    case BlendMode::kDarken:
+    case BlendMode::kLighten:
+    case BlendMode::kColorDodge:
+    case BlendMode::kColorBurn:
+    case BlendMode::kHardLight:
+    case BlendMode::kDifference:
+    case BlendMode::kExclusion:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Implements the kernels on top of `Ops`, which wraps one instruction set.
+// `Ops::V` holds one unsigned 16-bit lane per pixel, and all values kept in it
+// fit in 16 bits, so the 8-bit arithmetic of the scalar code can be
+// reproduced exactly. `Ops` provides:
+//   kPixels                     - pixels per vector.
+//   Splat(v)                    - `v` in every lane.
+//   Add, Sub, Mul               - lane-wise, modulo 2^16.
+//   Shr8(a)                     - logical shift right by 8.
+//   Min, Max                    - for values below 2^15.
+//   Equal, Greater              - all-ones masks, for values below 2^15.
+//   Select(m, a, b)             - `a` where `m` is set, else `b`.
+//   And(a, b)                   - bitwise and.
+//   DivSat(n, d)                - n / d for d > 0, saturating above 2^15 - 1.
+//   MulDiv65025(a, b)           - a * b / 65025, for a * b < 2^24.
+//   LoadBgra, StoreBgra         - deinterleave and interleave `kPixels` BGRA
+//                                 pixels into and out of channel vectors.
+//   LoadBytes(p)                - `kPixels` bytes, in the lane order used by
+//                                 LoadBgra().
+template <typename Ops>
+class CompositeKernelsImpl {
+ public:
+  using V = typename Ops::V;
+
+  static constexpr size_t kPixels = Ops::kPixels;
+
+  static size_t Bgra2Bgra(const uint8_t* src,
+                          const uint8_t* clip,
+                          uint8_t* dest,
+                          size_t pixel_count,
+                          BlendMode blend_type) {
+    size_t col = 0;
+    for (; col + kPixels <= pixel_count; col += kPixels) {
+      Pixels input;
+      Pixels output;
+      // SAFETY: `col + kPixels <= pixel_count`, which the caller guarantees
+      // `src`, `clip` and `dest` cover.
+      UNSAFE_BUFFERS({
+        Ops::LoadBgra(src + col * 4, input.blue, input.green, input.red,
+                      input.alpha);
+        if (clip) {
+          input.alpha =
+              Div255(Ops::Mul(input.alpha, Ops::LoadBytes(clip + col)));
+        }
+        Ops::LoadBgra(dest + col * 4, output.blue, output.green, output.red,
+                      output.alpha);
+        CompositeOntoAlpha(input, blend_type, output);
+        Ops::StoreBgra(dest + col * 4, output.blue, output.green, output.red,
+                       output.alpha);
+      });
+    }
+    return col;
+  }
+
+  static size_t Bgra2Bgrx(const uint8_t* src,
+                          const uint8_t* clip,
+                          uint8_t* dest,
+                          size_t pixel_count,
+                          BlendMode blend_type) {
+    size_t col = 0;
+    for (; col + kPixels <= pixel_count; col += kPixels) {
+      Pixels input;
+      Pixels output;
+      // SAFETY: `col + kPixels <= pixel_count`, which the caller guarantees
+      // `src`, `clip` and `dest` cover.
+      UNSAFE_BUFFERS({
+        Ops::LoadBgra(src + col * 4, input.blue, input.green, input.red,
+                      input.alpha);
+        if (clip) {
+          input.alpha =
+              Div255(Ops::Mul(input.alpha, Ops::LoadBytes(clip + col)));
+        }
+        Ops::LoadBgra(dest + col * 4, output.blue, output.green, output.red,
+                      output.alpha);
+        CompositeOntoOpaque(input, blend_type, output);
+        Ops::StoreBgra(dest + col * 4, output.blue, output.green, output.red,
+                       output.alpha);
+      });
+    }
+    return col;
+  }
+
+  static size_t ByteMask2Bgra(const uint8_t* src,
+                              const FX_BGRA_STRUCT<uint8_t>& mask,
+                              const uint8_t* clip,
+                              uint8_t* dest,
+                              size_t pixel_count,
+                              BlendMode blend_type) {
+    Pixels input = SplatColor(mask);
+    const V mask_alpha = Ops::Splat(mask.alpha);
+    size_t col = 0;
+    for (; col + kPixels <= pixel_count; col += kPixels) {
+      Pixels output;
+      // SAFETY: `col + kPixels <= pixel_count`, which the caller guarantees
+      // `src`, `clip` and `dest` cover.
+      UNSAFE_BUFFERS({
+        input.alpha =
+            MaskAlpha(mask_alpha, src + col, clip ? clip + col : nullptr);
+        Ops::LoadBgra(dest + col * 4, output.blue, output.green, output.red,
+                      output.alpha);
+        CompositeOntoAlpha(input, blend_type, output);
+        Ops::StoreBgra(dest + col * 4, output.blue, output.green, output.red,
+                       output.alpha);
+      });
+    }
+    return col;
+  }
+
+  static size_t ByteMask2Bgrx(const uint8_t* src,
+                              const FX_BGRA_STRUCT<uint8_t>& mask,
+                              const uint8_t* clip,
+                              uint8_t* dest,
+                              size_t pixel_count,
+                              BlendMode blend_type) {
+    Pixels input = SplatColor(mask);
+    const V mask_alpha = Ops::Splat(mask.alpha);
+    size_t col = 0;
+    for (; col + kPixels <= pixel_count; col += kPixels) {
+      Pixels output;
+      // SAFETY: `col + kPixels <= pixel_count`, which the caller guarantees
+      // `src`, `clip` and `dest` cover.
+      UNSAFE_BUFFERS({
+        input.alpha =
+            MaskAlpha(mask_alpha, src + col, clip ? clip + col : nullptr);
+        Ops::LoadBgra(dest + col * 4, output.blue, output.green, output.red,
+                      output.alpha);
+        CompositeOntoOpaque(input, blend_type, output);
+        Ops::StoreBgra(dest + col * 4, output.blue, output.green, output.red,
+                       output.alpha);
+      });
+    }
+    return col;
+  }
+
+  static constexpr CompositeKernels kKernels = {
+      .bgra_to_bgra = &Bgra2Bgra,
+      .bgra_to_bgrx = &Bgra2Bgrx,
+      .byte_mask_to_bgra = &ByteMask2Bgra,
+      .byte_mask_to_bgrx = &ByteMask2Bgrx,
+  };
+
+ private:
+  struct Pixels {
+    V blue;
+    V green;
+    V red;
+    V alpha;
+  };
+
+  static Pixels SplatColor(const FX_BGRA_STRUCT<uint8_t>& color) {
+    return {
+        .blue = Ops::Splat(color.blue),
+        .green = Ops::Splat(color.green),
+        .red = Ops::Splat(color.red),
+        .alpha = Ops::Splat(color.alpha),
+    };
+  }
+
+  // x / 255 for x < 65280.
+  static V Div255(V x) {
+    return Ops::Shr8(Ops::Add(Ops::Add(x, Ops::Splat(1)), Ops::Shr8(x)));
+  }
+
+  // FXDIB_ALPHA_MERGE().
+  static V AlphaMerge(V backdrop, V source, V source_alpha) {
+    return Div255(
+        Ops::Add(Ops::Mul(backdrop, Ops::Sub(Ops::Splat(255), source_alpha)),
+                 Ops::Mul(source, source_alpha)));
+  }
+
+  // 2 * a * b / 255, for a, b <= 255.
+  static V TwiceProductDiv255(V a, V b) {
+    const V product = Ops::Mul(a, b);
+    const V quotient = Div255(product);
+    const V remainder = Ops::Sub(product, Ops::Mul(quotient, Ops::Splat(255)));
+    const V round_up =
+        Ops::And(Ops::Greater(remainder, Ops::Splat(127)), Ops::Splat(1));
+    return Ops::Add(Ops::Add(quotient, quotient), round_up);
+  }
+
+  static V Screen(V back, V src) {
+    return Ops::Sub(Ops::Add(src, back), Div255(Ops::Mul(src, back)));
+  }
+
+  static V HardLight(V back, V src) {
+    // The low branch computes 2 * src * back in 16 bits, which only fits
+    // where it is selected.
+    const V low = Div255(Ops::Mul(Ops::Add(src, src), back));
+    const V high = Screen(back, Ops::Sub(Ops::Add(src, src), Ops::Splat(255)));
+    return Ops::Select(Ops::Greater(Ops::Splat(128), src), low, high);
+  }
+
+  // fxge::Blend(), for the modes accepted by IsSimdBlendMode().
+  static V Blend(BlendMode blend_type, V back, V src) {
+    switch (blend_type) {
+      case BlendMode::kMultiply:
+        return Div255(Ops::Mul(src, back));
+      case BlendMode::kScreen:
+        return Screen(back, src);
+      case BlendMode::kOverlay:
+        return HardLight(src, back);
+      case BlendMode::kDarken:
+        return Ops::Min(src, back);
+      case BlendMode::kLighten:
+        return Ops::Max(src, back);
+      case BlendMode::kColorDodge: {
+        const V divisor =
+            Ops::Max(Ops::Sub(Ops::Splat(255), src), Ops::Splat(1));
+        const V result = Ops::Min(
+            Ops::DivSat(Ops::Mul(back, Ops::Splat(255)), divisor),
+            Ops::Splat(255));
+        return Ops::Select(Ops::Equal(src, Ops::Splat(255)), Ops::Splat(255),
+                           result);
+      }
+      case BlendMode::kColorBurn: {
+        const V divisor = Ops::Max(src, Ops::Splat(1));
+        const V quotient = Ops::DivSat(
+            Ops::Mul(Ops::Sub(Ops::Splat(255), back), Ops::Splat(255)),
+            divisor);
+        const V result =
+            Ops::Sub(Ops::Splat(255), Ops::Min(quotient, Ops::Splat(255)));
+        return Ops::Select(Ops::Equal(src, Ops::Splat(0)), Ops::Splat(0),
+                           result);
+      }
+      case BlendMode::kHardLight:
+        return HardLight(back, src);
+      case BlendMode::kDifference:
+        return Ops::Sub(Ops::Max(src, back), Ops::Min(src, back));
+      case BlendMode::kExclusion:
+        return Ops::Sub(Ops::Add(back, src), TwiceProductDiv255(back, src));
+      default:
+        return src;
+    }
+  }
+
+  // GetAlphaWithSrc().
+  static V MaskAlpha(V mask_alpha, const uint8_t* src, const uint8_t* clip) {
+    const V coverage = Ops::Mul(mask_alpha, Ops::LoadBytes(src));
+    if (!clip) {
+      return Div255(coverage);
+    }
+    return Ops::MulDiv65025(coverage, Ops::LoadBytes(clip));
+  }
+
+  // CompositePixelBgra2Bgra*() and CompositeRow_ByteMask2Bgra(). `input.alpha`
+  // must already include the clip.
+  static void CompositeOntoAlpha(const Pixels& input,
+                                 BlendMode blend_type,
+                                 Pixels& output) {
+    const V back_alpha = output.alpha;
+    const V src_alpha = input.alpha;
+    const V dest_alpha = Ops::Sub(Ops::Add(back_alpha, src_alpha),
+                                  Div255(Ops::Mul(back_alpha, src_alpha)));
+    // Lanes with a zero `dest_alpha` are replaced below.
+    const V alpha_ratio =
+        Ops::DivSat(Ops::Mul(src_alpha, Ops::Splat(255)),
+                    Ops::Max(dest_alpha, Ops::Splat(1)));
+
+    Pixels blended = input;
+    if (blend_type != BlendMode::kNormal) {
+      blended.blue = AlphaMerge(
+          input.blue, Blend(blend_type, output.blue, input.blue), back_alpha);
+      blended.green = AlphaMerge(
+          input.green, Blend(blend_type, output.green, input.green),
+          back_alpha);
+      blended.red = AlphaMerge(
+          input.red, Blend(blend_type, output.red, input.red), back_alpha);
+    }
+
+    // A fully transparent backdrop takes the source as is. A fully transparent
+    // source needs no special casing, as it leaves the merge below unchanged.
+    const V empty_back = Ops::Equal(back_alpha, Ops::Splat(0));
+    output.blue =
+        Ops::Select(empty_back, input.blue,
+                    AlphaMerge(output.blue, blended.blue, alpha_ratio));
+    output.green =
+        Ops::Select(empty_back, input.green,
+                    AlphaMerge(output.green, blended.green, alpha_ratio));
+    output.red = Ops::Select(empty_back, input.red,
+                             AlphaMerge(output.red, blended.red, alpha_ratio));
+    output.alpha = Ops::Select(empty_back, src_alpha, dest_alpha);
+  }
+
+  // CompositePixelBgra2Bgr*() and CompositeRow_ByteMask2Rgb(). `input.alpha`
+  // must already include the clip. Leaves `output.alpha` alone.
+  static void CompositeOntoOpaque(const Pixels& input,
+                                  BlendMode blend_type,
+                                  Pixels& output) {
+    if (blend_type == BlendMode::kNormal) {
+      output.blue = AlphaMerge(output.blue, input.blue, input.alpha);
+      output.green = AlphaMerge(output.green, input.green, input.alpha);
+      output.red = AlphaMerge(output.red, input.red, input.alpha);
+      return;
+    }
+    output.blue = AlphaMerge(
+        output.blue, Blend(blend_type, output.blue, input.blue), input.alpha);
+    output.green = AlphaMerge(
+        output.green, Blend(blend_type, output.green, input.green),
+        input.alpha);
+    output.red = AlphaMerge(
+        output.red, Blend(blend_type, output.red, input.red), input.alpha);
+  }
+};
+
+}  // namespace fxge::simd_internal
+
+#endif  // CORE_FXGE_DIB_COMPOSITE_SIMD_IMPL_H_
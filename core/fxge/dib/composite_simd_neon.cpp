@@ -0,0 +1,88 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "core/fxge/dib/composite_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// Eight pixels per vector, deinterleaved by the structure loads and stores.
+struct NeonOps {
+  using V = uint16x8_t;
+
+  static constexpr size_t kPixels = 8;
+
+  static V Splat(int value) {
+    return vdupq_n_u16(static_cast<uint16_t>(value));
+  }
+  static V Add(V a, V b) { return vaddq_u16(a, b); }
+  static V Sub(V a, V b) { return vsubq_u16(a, b); }
+  static V Mul(V a, V b) { return vmulq_u16(a, b); }
+  static V Shr8(V a) { return vshrq_n_u16(a, 8); }
+  static V Min(V a, V b) { return vminq_u16(a, b); }
+  static V Max(V a, V b) { return vmaxq_u16(a, b); }
+  static V Equal(V a, V b) { return vceqq_u16(a, b); }
+  static V Greater(V a, V b) { return vcgtq_u16(a, b); }
+  static V And(V a, V b) { return vandq_u16(a, b); }
+  static V Select(V mask, V a, V b) { return vbslq_u16(mask, a, b); }
+
+  static V DivSat(V n, V d) {
+    const float32x4_t lo =
+        vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(n))),
+                  vcvtq_f32_u32(vmovl_u16(vget_low_u16(d))));
+    const float32x4_t hi =
+        vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(n))),
+                  vcvtq_f32_u32(vmovl_u16(vget_high_u16(d))));
+    return vcombine_u16(vqmovn_u32(vcvtq_u32_f32(lo)),
+                        vqmovn_u32(vcvtq_u32_f32(hi)));
+  }
+
+  static V MulDiv65025(V a, V b) {
+    const float32x4_t divisor = vdupq_n_f32(65025.0f);
+    const float32x4_t lo =
+        vdivq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(a))),
+                            vcvtq_f32_u32(vmovl_u16(vget_low_u16(b)))),
+                  divisor);
+    const float32x4_t hi =
+        vdivq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(a))),
+                            vcvtq_f32_u32(vmovl_u16(vget_high_u16(b)))),
+                  divisor);
+    return vcombine_u16(vqmovn_u32(vcvtq_u32_f32(lo)),
+                        vqmovn_u32(vcvtq_u32_f32(hi)));
+  }
+
+  static void LoadBgra(const uint8_t* pixels,
+                       V& blue,
+                       V& green,
+                       V& red,
+                       V& alpha) {
+    const uint8x8x4_t channels = vld4_u8(pixels);
+    blue = vmovl_u8(channels.val[0]);
+    green = vmovl_u8(channels.val[1]);
+    red = vmovl_u8(channels.val[2]);
+    alpha = vmovl_u8(channels.val[3]);
+  }
+
+  static void StoreBgra(uint8_t* pixels, V blue, V green, V red, V alpha) {
+    uint8x8x4_t channels;
+    channels.val[0] = vmovn_u16(blue);
+    channels.val[1] = vmovn_u16(green);
+    channels.val[2] = vmovn_u16(red);
+    channels.val[3] = vmovn_u16(alpha);
+    vst4_u8(pixels, channels);
+  }
+
+  static V LoadBytes(const uint8_t* bytes) { return vmovl_u8(vld1_u8(bytes)); }
+};
+
+}  // namespace
+
+const CompositeKernels& GetNeonCompositeKernels() {
+  return CompositeKernelsImpl<NeonOps>::kKernels;
+}
+
+}  // namespace fxge::simd_internal
@@ -0,0 +1,106 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <emmintrin.h>
+
+#include "core/fxge/dib/composite_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// Eight pixels per vector. Channels are split out of 32-bit pixels and packed
+// into 16-bit lanes with signed saturation, which never triggers as all
+// packed values are at most 255.
+struct Sse2Ops {
+  using V = __m128i;
+
+  static constexpr size_t kPixels = 8;
+
+  static V Splat(int value) {
+    return _mm_set1_epi16(static_cast<short>(value));
+  }
+  static V Add(V a, V b) { return _mm_add_epi16(a, b); }
+  static V Sub(V a, V b) { return _mm_sub_epi16(a, b); }
+  static V Mul(V a, V b) { return _mm_mullo_epi16(a, b); }
+  static V Shr8(V a) { return _mm_srli_epi16(a, 8); }
+  static V Min(V a, V b) { return _mm_min_epi16(a, b); }
+  static V Max(V a, V b) { return _mm_max_epi16(a, b); }
+  static V Equal(V a, V b) { return _mm_cmpeq_epi16(a, b); }
+  static V Greater(V a, V b) { return _mm_cmpgt_epi16(a, b); }
+  static V And(V a, V b) { return _mm_and_si128(a, b); }
+
+  static V Select(V mask, V a, V b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  }
+
+  static V DivSat(V n, V d) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_cvttps_epi32(
+        _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(n, zero)),
+                   _mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero))));
+    const __m128i hi = _mm_cvttps_epi32(
+        _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(n, zero)),
+                   _mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero))));
+    return _mm_packs_epi32(lo, hi);
+  }
+
+  static V MulDiv65025(V a, V b) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 divisor = _mm_set1_ps(65025.0f);
+    const __m128i lo = _mm_cvttps_epi32(_mm_div_ps(
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a, zero)),
+                   _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero))),
+        divisor));
+    const __m128i hi = _mm_cvttps_epi32(_mm_div_ps(
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a, zero)),
+                   _mm_cvtepi32_ps(_mm_unpackhi_epi16(b, zero))),
+        divisor));
+    return _mm_packs_epi32(lo, hi);
+  }
+
+  static void LoadBgra(const uint8_t* pixels,
+                       V& blue,
+                       V& green,
+                       V& red,
+                       V& alpha) {
+    const __m128i byte_mask = _mm_set1_epi32(0xff);
+    const __m128i p0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    // SAFETY: `pixels` holds `kPixels` 4-byte pixels.
+    const __m128i p1 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(UNSAFE_BUFFERS(pixels + 16)));
+    blue = _mm_packs_epi32(_mm_and_si128(p0, byte_mask),
+                           _mm_and_si128(p1, byte_mask));
+    green = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), byte_mask),
+                            _mm_and_si128(_mm_srli_epi32(p1, 8), byte_mask));
+    red = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), byte_mask),
+                          _mm_and_si128(_mm_srli_epi32(p1, 16), byte_mask));
+    alpha = _mm_packs_epi32(_mm_srli_epi32(p0, 24), _mm_srli_epi32(p1, 24));
+  }
+
+  static void StoreBgra(uint8_t* pixels, V blue, V green, V red, V alpha) {
+    const __m128i blue_green = _mm_or_si128(blue, _mm_slli_epi16(green, 8));
+    const __m128i red_alpha = _mm_or_si128(red, _mm_slli_epi16(alpha, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels),
+                     _mm_unpacklo_epi16(blue_green, red_alpha));
+    // SAFETY: `pixels` holds `kPixels` 4-byte pixels.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(UNSAFE_BUFFERS(pixels + 16)),
+                     _mm_unpackhi_epi16(blue_green, red_alpha));
+  }
+
+  static V LoadBytes(const uint8_t* bytes) {
+    return _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes)),
+        _mm_setzero_si128());
+  }
+};
+
+}  // namespace
+
+const CompositeKernels& GetSse2CompositeKernels() {
+  return CompositeKernelsImpl<Sse2Ops>::kKernels;
+}
+
+}  // namespace fxge::simd_internal
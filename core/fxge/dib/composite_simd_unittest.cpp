@@ -0,0 +1,201 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/composite_simd.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_scanlinecompositor.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "core/fxge/dib/simd_test_support.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr BlendMode kBlendModes[] = {
+    BlendMode::kNormal,     BlendMode::kMultiply,   BlendMode::kScreen,
+    BlendMode::kOverlay,    BlendMode::kDarken,     BlendMode::kLighten,
+    BlendMode::kColorDodge, BlendMode::kColorBurn,  BlendMode::kHardLight,
+    BlendMode::kSoftLight,  BlendMode::kDifference, BlendMode::kExclusion,
+    BlendMode::kHue,        BlendMode::kSaturation, BlendMode::kColor,
+    BlendMode::kLuminosity,
+};
+
+class Rng {
+ public:
+  uint8_t Next() {
+    state_ = state_ * 1103515245 + 12345;
+    return static_cast<uint8_t>(state_ >> 16);
+  }
+
+  // Favors the extreme alpha values, which take separate scalar paths.
+  uint8_t NextAlpha() {
+    switch (Next() % 4) {
+      case 0:
+        return 0;
+      case 1:
+        return 255;
+      default:
+        return Next();
+    }
+  }
+
+ private:
+  uint32_t state_ = 1;
+};
+
+std::vector<uint8_t> MakePixels(Rng& rng, size_t width) {
+  std::vector<uint8_t> pixels(width * 4);
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    pixels[i] = rng.Next();
+    pixels[i + 1] = rng.Next();
+    pixels[i + 2] = rng.Next();
+    pixels[i + 3] = rng.NextAlpha();
+  }
+  return pixels;
+}
+
+std::vector<uint8_t> MakeBytes(Rng& rng, size_t width) {
+  std::vector<uint8_t> bytes(width);
+  for (uint8_t& byte : bytes) {
+    byte = rng.NextAlpha();
+  }
+  return bytes;
+}
+
+// Composites with the scalar code and with each supported SIMD level, and
+// checks the results are identical.
+void CompareWithScalar(FXDIB_Format dest_format,
+                       FXDIB_Format src_format,
+                       uint32_t mask_color,
+                       BlendMode blend_type,
+                       pdfium::span<const uint8_t> src,
+                       pdfium::span<const uint8_t> clip,
+                       pdfium::span<const uint8_t> dest,
+                       size_t width) {
+  CFX_ScanlineCompositor compositor;
+  ASSERT_TRUE(compositor.Init(dest_format, src_format, /*src_palette=*/{},
+                              mask_color, blend_type,
+                              /*bRgbByteOrder=*/false));
+  auto composite = [&] {
+    std::vector<uint8_t> result(dest.begin(), dest.end());
+    if (src_format == FXDIB_Format::k8bppMask) {
+      compositor.CompositeByteMaskLine(result, src, static_cast<int>(width),
+                                       clip);
+    } else {
+      compositor.CompositeRgbBitmapLine(result, src, static_cast<int>(width),
+                                        clip);
+    }
+    return result;
+  };
+
+  const std::vector<uint8_t> expected = fxge::RunWithoutSimd(composite);
+  fxge::ForEachSupportedSimdLevel([&] { EXPECT_EQ(expected, composite()); });
+}
+
+}  // namespace
+
+TEST(CompositeSimdTest, Bgra2Bgra) {
+  Rng rng;
+  for (BlendMode blend_type : kBlendModes) {
+    SCOPED_TRACE(static_cast<int>(blend_type));
+    for (size_t width : fxge::kSimdTestLengths) {
+      SCOPED_TRACE(width);
+      const std::vector<uint8_t> src = MakePixels(rng, width);
+      const std::vector<uint8_t> clip = MakeBytes(rng, width);
+      const std::vector<uint8_t> dest = MakePixels(rng, width);
+      CompareWithScalar(FXDIB_Format::kBgra, FXDIB_Format::kBgra, 0,
+                        blend_type, src, {}, dest, width);
+      CompareWithScalar(FXDIB_Format::kBgra, FXDIB_Format::kBgra, 0,
+                        blend_type, src, clip, dest, width);
+    }
+  }
+}
+
+TEST(CompositeSimdTest, Bgra2Bgrx) {
+  Rng rng;
+  for (BlendMode blend_type : kBlendModes) {
+    SCOPED_TRACE(static_cast<int>(blend_type));
+    for (size_t width : fxge::kSimdTestLengths) {
+      SCOPED_TRACE(width);
+      const std::vector<uint8_t> src = MakePixels(rng, width);
+      const std::vector<uint8_t> clip = MakeBytes(rng, width);
+      const std::vector<uint8_t> dest = MakePixels(rng, width);
+      CompareWithScalar(FXDIB_Format::kBgrx, FXDIB_Format::kBgra, 0,
+                        blend_type, src, {}, dest, width);
+      CompareWithScalar(FXDIB_Format::kBgrx, FXDIB_Format::kBgra, 0,
+                        blend_type, src, clip, dest, width);
+    }
+  }
+}
+
+TEST(CompositeSimdTest, ByteMask2Bgra) {
+  Rng rng;
+  for (BlendMode blend_type : kBlendModes) {
+    SCOPED_TRACE(static_cast<int>(blend_type));
+    for (size_t width : fxge::kSimdTestLengths) {
+      SCOPED_TRACE(width);
+      const uint32_t mask_color = ArgbEncode(rng.NextAlpha(), rng.Next(),
+                                             rng.Next(), rng.Next());
+      const std::vector<uint8_t> src = MakeBytes(rng, width);
+      const std::vector<uint8_t> clip = MakeBytes(rng, width);
+      const std::vector<uint8_t> dest = MakePixels(rng, width);
+      CompareWithScalar(FXDIB_Format::kBgra, FXDIB_Format::k8bppMask,
+                        mask_color, blend_type, src, {}, dest, width);
+      CompareWithScalar(FXDIB_Format::kBgra, FXDIB_Format::k8bppMask,
+                        mask_color, blend_type, src, clip, dest, width);
+    }
+  }
+}
+
+TEST(CompositeSimdTest, ByteMask2Bgrx) {
+  Rng rng;
+  for (BlendMode blend_type : kBlendModes) {
+    SCOPED_TRACE(static_cast<int>(blend_type));
+    for (size_t width : fxge::kSimdTestLengths) {
+      SCOPED_TRACE(width);
+      const uint32_t mask_color = ArgbEncode(rng.NextAlpha(), rng.Next(),
+                                             rng.Next(), rng.Next());
+      const std::vector<uint8_t> src = MakeBytes(rng, width);
+      const std::vector<uint8_t> clip = MakeBytes(rng, width);
+      const std::vector<uint8_t> dest = MakePixels(rng, width);
+      CompareWithScalar(FXDIB_Format::kBgrx, FXDIB_Format::k8bppMask,
+                        mask_color, blend_type, src, {}, dest, width);
+      CompareWithScalar(FXDIB_Format::kBgrx, FXDIB_Format::k8bppMask,
+                        mask_color, blend_type, src, clip, dest, width);
+    }
+  }
+}
+
+// With an opaque source, compositing onto kBgrx yields fxge::Blend() itself,
+// so this covers every pair of channel values for each blend mode.
+TEST(CompositeSimdTest, AllChannelValues) {
+  constexpr int kWidth = 256;
+  for (BlendMode blend_type : kBlendModes) {
+    SCOPED_TRACE(static_cast<int>(blend_type));
+    std::vector<uint8_t> src(kWidth * 4);
+    for (int src_color = 0; src_color < 256; ++src_color) {
+      for (int i = 0; i < kWidth; ++i) {
+        src[i * 4] = src_color;
+        src[i * 4 + 1] = src_color;
+        src[i * 4 + 2] = src_color;
+        src[i * 4 + 3] = 255;
+      }
+      std::vector<uint8_t> dest(kWidth * 4);
+      for (int i = 0; i < kWidth; ++i) {
+        dest[i * 4] = i;
+        dest[i * 4 + 1] = 255 - i;
+        dest[i * 4 + 2] = i;
+        dest[i * 4 + 3] = 255;
+      }
+      CompareWithScalar(FXDIB_Format::kBgrx, FXDIB_Format::kBgra, 0,
+                        blend_type, src, {}, dest, kWidth);
+      CompareWithScalar(FXDIB_Format::kBgra, FXDIB_Format::kBgra, 0,
+                        blend_type, src, {}, dest, kWidth);
+    }
+  }
+}
@@ -13,14 +13,19 @@
 #include <utility>
 
 #include "core/fxcrt/check.h"
+#include "core/fxcrt/fx_2d_size.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/pauseindicator_iface.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/stl_util.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxge/calculate_pitch.h"
 #include "core/fxge/dib/cfx_dibbase.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 #include "core/fxge/dib/fx_dib.h"
 #include "core/fxge/dib/scanlinecomposer_iface.h"
+#include "core/fxge/dib/stretch_simd.h"
 
 static_assert(
     std::is_trivially_destructible<CStretchEngine::PixelWeight>::value,
@@ -28,6 +33,25 @@ static_assert(
 
 namespace {
 
+constexpr int kStretchPauseRows = 10;
+
+// Images with fewer source pixels than this are stretched on one thread, as
+// handing work to other threads would cost more than it saves.
+constexpr int64_t kMinPixelsForThreads = 1 << 22;
+
+// Splits `count` items into `thread_count` contiguous ranges, calls
+// `fn(begin, end)` for each on the shared thread pool, and waits for all of
+// them to finish.
+template <typename Fn>
+void RunInParallel(int thread_count, size_t count, const Fn& fn) {
+  const size_t per_thread = (count + thread_count - 1) / thread_count;
+  const size_t range_count = (count + per_thread - 1) / per_thread;
+  ThreadPool::ParallelFor(range_count, [&](size_t range) {
+    const size_t begin = range * per_thread;
+    fn(begin, std::min(begin + per_thread, count));
+  });
+}
+
 size_t TotalBytesForWeightCount(size_t weight_count) {
   // Always room for one weight even for empty ranges due to declaration
   // of weights_[1] in the header. Don't shrink below this since
@@ -251,10 +275,12 @@ CStretchEngine::CStretchEngine(ScanlineComposerIface* pDestBitmap,
   if (src_top > src_bottom) {
     std::swap(src_top, src_bottom);
   }
-  src_clip_.left = static_cast<int>(floor(src_left));
-  src_clip_.right = static_cast<int>(ceil(src_right));
-  src_clip_.top = static_cast<int>(floor(src_top));
-  src_clip_.bottom = static_cast<int>(ceil(src_bottom));
+  // Resampling reads a pixel past the ones under the clip, so that the output
+  // does not depend on where the clip falls.
+  src_clip_.left = static_cast<int>(floor(src_left)) - 1;
+  src_clip_.right = static_cast<int>(ceil(src_right)) + 1;
+  src_clip_.top = static_cast<int>(floor(src_top)) - 1;
+  src_clip_.bottom = static_cast<int>(ceil(src_bottom)) + 1;
   FX_RECT src_rect(0, 0, src_width_, src_height_);
   src_clip_.Intersect(src_rect);
 
@@ -308,6 +334,17 @@ bool CStretchEngine::StartStretchHorz() {
           src_clip_.left, src_clip_.right, resample_options_)) {
     return false;
   }
+  if (trans_method_ != TransformMethod::k1BppTo8Bpp &&
+      trans_method_ != TransformMethod::k1BppToManyBpp &&
+      trans_method_ != TransformMethod::k8BppToManyBpp) {
+    horz_filter_ = fxge::ResampleFilter();
+    for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+      const PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
+      pdfium::span<const uint32_t> weights = pWeights->GetWeights();
+      horz_filter_.AddPixel(weights.empty() ? 0 : pWeights->src_start_,
+                            weights);
+    }
+  }
   cur_row_ = src_clip_.top;
   state_ = State::kHorizontal;
   return true;
@@ -321,127 +358,138 @@ bool CStretchEngine::ContinueStretchHorz(PauseIndicatorIface* pPause) {
     return true;
   }
 
-  int Bpp = dest_bpp_ / 8;
-  static const int kStrechPauseRows = 10;
-  int rows_to_go = kStrechPauseRows;
+  const int thread_count = GetThreadCount();
+  if (thread_count > 1) {
+    return ContinueStretchHorzParallel(pPause, thread_count);
+  }
+
+  int rows_to_go = kStretchPauseRows;
   for (; cur_row_ < src_clip_.bottom; ++cur_row_) {
     if (rows_to_go == 0) {
       if (pPause && pPause->NeedToPauseNow()) {
         return true;
       }
 
-      rows_to_go = kStrechPauseRows;
+      rows_to_go = kStretchPauseRows;
     }
 
-    const uint8_t* src_scan = source_->GetScanline(cur_row_).data();
-    pdfium::span<uint8_t> dest_span = inter_buf_.subspan(
-        (cur_row_ - src_clip_.top) * inter_pitch_, inter_pitch_);
-    size_t dest_span_index = 0;
-    // TODO(npm): reduce duplicated code here
-    UNSAFE_TODO({
-      switch (trans_method_) {
-        case TransformMethod::k1BppTo8Bpp:
-        case TransformMethod::k1BppToManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_a = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              if (src_scan[j / 8] & (1 << (7 - j % 8))) {
-                dest_a += pixel_weight * 255;
-              }
-            }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_a);
-          }
-          break;
-        }
-        case TransformMethod::k8BppTo8Bpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_a = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              dest_a += pixel_weight * src_scan[j];
-            }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_a);
-          }
-          break;
-        }
-        case TransformMethod::k8BppToManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              FX_ARGB argb = src_palette_[src_scan[j]];
-              if (dest_format_ == FXDIB_Format::kBgr) {
-                dest_r += pixel_weight * static_cast<uint8_t>(argb >> 16);
-                dest_g += pixel_weight * static_cast<uint8_t>(argb >> 8);
-                dest_b += pixel_weight * static_cast<uint8_t>(argb);
-              } else {
-                dest_b += pixel_weight * static_cast<uint8_t>(argb >> 24);
-                dest_g += pixel_weight * static_cast<uint8_t>(argb >> 16);
-                dest_r += pixel_weight * static_cast<uint8_t>(argb >> 8);
-              }
-            }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_b);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_g);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_r);
-          }
-          break;
-        }
-        case TransformMethod::kManyBpptoManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              const uint8_t* src_pixel = src_scan + j * Bpp;
-              dest_b += pixel_weight * (*src_pixel++);
-              dest_g += pixel_weight * (*src_pixel++);
-              dest_r += pixel_weight * (*src_pixel);
+    StretchHorzRow(source_->GetScanline(cur_row_),
+                   inter_buf_.subspan((cur_row_ - src_clip_.top) * inter_pitch_,
+                                      inter_pitch_));
+    rows_to_go--;
+  }
+  return false;
+}
+
+int CStretchEngine::GetThreadCount() const {
+  if (thread_count_for_testing_ > 0) {
+    return thread_count_for_testing_;
+  }
+  const int64_t src_pixels =
+      static_cast<int64_t>(src_clip_.Width()) * src_clip_.Height();
+  if (src_pixels < kMinPixelsForThreads) {
+    return 1;
+  }
+  return static_cast<int>(ThreadPool::GetMaxConcurrency());
+}
+
+bool CStretchEngine::ContinueStretchHorzParallel(PauseIndicatorIface* pPause,
+                                                 int thread_count) {
+  // Sources may decode on demand and only keep the latest scanline around, so
+  // fetch a batch of rows in order on this thread, then filter them in
+  // parallel. Pausing is checked between batches.
+  const size_t src_pitch = source_->GetPitch();
+  const int batch_rows = kStretchPauseRows * thread_count;
+  DataVector<uint8_t> batch(Fx2DSizeOrDie(src_pitch, batch_rows));
+  bool first_batch = true;
+  while (cur_row_ < src_clip_.bottom) {
+    if (!first_batch && pPause && pPause->NeedToPauseNow()) {
+      return true;
+    }
+    first_batch = false;
+
+    const int rows = std::min(batch_rows, src_clip_.bottom - cur_row_);
+    for (int i = 0; i < rows; ++i) {
+      pdfium::span<const uint8_t> scanline = source_->GetScanline(cur_row_ + i);
+      fxcrt::Copy(scanline.first(std::min(scanline.size(), src_pitch)),
+                  pdfium::span(batch).subspan(i * src_pitch, src_pitch));
+    }
+    const int first_row = cur_row_ - src_clip_.top;
+    RunInParallel(thread_count, rows, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        StretchHorzRow(
+            pdfium::span(batch).subspan(i * src_pitch, src_pitch),
+            inter_buf_.subspan((first_row + i) * inter_pitch_, inter_pitch_));
+      }
+    });
+    cur_row_ += rows;
+  }
+  return false;
+}
+
+void CStretchEngine::StretchHorzRow(pdfium::span<const uint8_t> src_span,
+                                    pdfium::span<uint8_t> dest_span) const {
+  const int Bpp = dest_bpp_ / 8;
+  const uint8_t* src_scan = src_span.data();
+  size_t dest_span_index = 0;
+  // TODO(npm): reduce duplicated code here
+  UNSAFE_TODO({
+    switch (trans_method_) {
+      case TransformMethod::k1BppTo8Bpp:
+      case TransformMethod::k1BppToManyBpp: {
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
+          uint32_t dest_a = 0;
+          for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
+            uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
+            if (src_scan[j / 8] & (1 << (7 - j % 8))) {
+              dest_a += pixel_weight * 255;
             }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_b);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_g);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_r);
-            dest_span_index += Bpp - 3;
           }
-          break;
+          dest_span[dest_span_index++] = PixelFromFixed(dest_a);
         }
-        case TransformMethod::kManyBpptoManyBppWithAlpha: {
-          DCHECK(has_alpha_);
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
-            uint32_t dest_a = 0;
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              const uint8_t* src_pixel = src_scan + j * Bpp;
-              uint32_t pixel_weight =
-                  pWeights->GetWeightForPosition(j) * src_pixel[3] / 255;
-              dest_b += pixel_weight * (*src_pixel++);
-              dest_g += pixel_weight * (*src_pixel++);
-              dest_r += pixel_weight * (*src_pixel);
-              dest_a += pixel_weight;
+        break;
+      }
+      case TransformMethod::k8BppTo8Bpp:
+        fxge::ResampleRow(src_span, 1, /*alpha_weighted=*/false, horz_filter_,
+                          dest_span);
+        break;
+      case TransformMethod::k8BppToManyBpp: {
+        for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
+          const PixelWeight* pWeights = weight_table_.GetPixelWeight(col);
+          uint32_t dest_r = 0;
+          uint32_t dest_g = 0;
+          uint32_t dest_b = 0;
+          for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
+            uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
+            FX_ARGB argb = src_palette_[src_scan[j]];
+            if (dest_format_ == FXDIB_Format::kBgr) {
+              dest_r += pixel_weight * static_cast<uint8_t>(argb >> 16);
+              dest_g += pixel_weight * static_cast<uint8_t>(argb >> 8);
+              dest_b += pixel_weight * static_cast<uint8_t>(argb);
+            } else {
+              dest_b += pixel_weight * static_cast<uint8_t>(argb >> 24);
+              dest_g += pixel_weight * static_cast<uint8_t>(argb >> 16);
+              dest_r += pixel_weight * static_cast<uint8_t>(argb >> 8);
             }
-            dest_span[dest_span_index++] = PixelFromFixed(dest_b);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_g);
-            dest_span[dest_span_index++] = PixelFromFixed(dest_r);
-            dest_span[dest_span_index] = PixelFromFixed(255 * dest_a);
-            dest_span_index += Bpp - 3;
           }
-          break;
+          dest_span[dest_span_index++] = PixelFromFixed(dest_b);
+          dest_span[dest_span_index++] = PixelFromFixed(dest_g);
+          dest_span[dest_span_index++] = PixelFromFixed(dest_r);
         }
+        break;
       }
-    });
-    rows_to_go--;
-  }
-  return false;
+      case TransformMethod::kManyBpptoManyBpp:
+        fxge::ResampleRow(src_span, Bpp, /*alpha_weighted=*/false,
+                          horz_filter_, dest_span);
+        break;
+      case TransformMethod::kManyBpptoManyBppWithAlpha:
+        DCHECK(has_alpha_);
+        fxge::ResampleRow(src_span, Bpp, /*alpha_weighted=*/true, horz_filter_,
+                          dest_span);
+        break;
+    }
+  });
 }
 
 void CStretchEngine::StretchVert() {
@@ -456,87 +504,122 @@ void CStretchEngine::StretchVert() {
     return;
   }
 
-  const int DestBpp = dest_bpp_ / 8;
-  UNSAFE_TODO({
-    for (int row = dest_clip_.top; row < dest_clip_.bottom; ++row) {
-      unsigned char* dest_scan = dest_scanline_.data();
-      PixelWeight* pWeights = table.GetPixelWeight(row);
-      switch (trans_method_) {
-        case TransformMethod::k1BppTo8Bpp:
-        case TransformMethod::k1BppToManyBpp:
-        case TransformMethod::k8BppTo8Bpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            pdfium::span<const uint8_t> src_span =
-                inter_buf_.subspan((col - dest_clip_.left) * DestBpp);
-            uint32_t dest_a = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              dest_a +=
-                  pixel_weight * src_span[(j - src_clip_.top) * inter_pitch_];
-            }
-            *dest_scan = PixelFromFixed(dest_a);
-            dest_scan += DestBpp;
+  const int thread_count = GetThreadCount();
+  if (thread_count > 1) {
+    StretchVertParallel(table, thread_count);
+    return;
+  }
+
+  DataVector<uint32_t> acc(dest_clip_.Width() * (dest_bpp_ / 8));
+  for (int row = dest_clip_.top; row < dest_clip_.bottom; ++row) {
+    StretchVertRow(*table.GetPixelWeight(row), acc, dest_scanline_);
+    dest_bitmap_->ComposeScanline(row - dest_clip_.top, dest_scanline_);
+  }
+}
+
+void CStretchEngine::StretchVertParallel(const WeightTable& table,
+                                         int thread_count) {
+  // Rows are computed in parallel a chunk at a time, then composed in order.
+  // Every row starts as a copy of `dest_scanline_`, so bytes StretchVertRow()
+  // does not write match the single-threaded output.
+  const size_t row_size = dest_scanline_.size();
+  const int width = dest_clip_.Width();
+  const bool has_alpha =
+      trans_method_ == TransformMethod::kManyBpptoManyBppWithAlpha;
+  const int chunk_rows = kStretchPauseRows * thread_count;
+  DataVector<uint8_t> rows(Fx2DSizeOrDie(row_size, chunk_rows));
+  for (int i = 0; i < chunk_rows; ++i) {
+    fxcrt::Copy(dest_scanline_,
+                pdfium::span(rows).subspan(i * row_size, row_size));
+  }
+  // Where a pixel ends up fully transparent, StretchVertRow() keeps the color
+  // from the previous row, which is only known once the rows are in order.
+  DataVector<uint8_t> transparent(
+      has_alpha ? Fx2DSizeOrDie(width, chunk_rows) : 0);
+
+  for (int top = dest_clip_.top; top < dest_clip_.bottom; top += chunk_rows) {
+    const int count = std::min(chunk_rows, dest_clip_.bottom - top);
+    RunInParallel(thread_count, count, [&](size_t begin, size_t end) {
+      DataVector<uint32_t> acc(width * (dest_bpp_ / 8));
+      for (size_t i = begin; i < end; ++i) {
+        StretchVertRow(*table.GetPixelWeight(top + static_cast<int>(i)), acc,
+                       pdfium::span(rows).subspan(i * row_size, row_size));
+        if (has_alpha) {
+          for (int col = 0; col < width; ++col) {
+            transparent[i * width + col] = acc[col * 4 + 3] == 0;
           }
-          break;
         }
-        case TransformMethod::k8BppToManyBpp:
-        case TransformMethod::kManyBpptoManyBpp: {
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            pdfium::span<const uint8_t> src_span =
-                inter_buf_.subspan((col - dest_clip_.left) * DestBpp);
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              pdfium::span<const uint8_t> src_pixel = src_span.subspan(
-                  static_cast<size_t>((j - src_clip_.top) * inter_pitch_), 3u);
-              dest_b += pixel_weight * src_pixel[0];
-              dest_g += pixel_weight * src_pixel[1];
-              dest_r += pixel_weight * src_pixel[2];
-            }
-            dest_scan[0] = PixelFromFixed(dest_b);
-            dest_scan[1] = PixelFromFixed(dest_g);
-            dest_scan[2] = PixelFromFixed(dest_r);
-            dest_scan += DestBpp;
+      }
+    });
+    for (int i = 0; i < count; ++i) {
+      pdfium::span<uint8_t> row =
+          pdfium::span(rows).subspan(i * row_size, row_size);
+      if (has_alpha) {
+        for (int col = 0; col < width; ++col) {
+          if (transparent[i * width + col]) {
+            const size_t offset = static_cast<size_t>(col) * 4;
+            fxcrt::Copy(pdfium::span(dest_scanline_).subspan(offset, 3u),
+                        row.subspan(offset, 3u));
           }
-          break;
         }
-        case TransformMethod::kManyBpptoManyBppWithAlpha: {
-          DCHECK(has_alpha_);
-          for (int col = dest_clip_.left; col < dest_clip_.right; ++col) {
-            pdfium::span<const uint8_t> src_span =
-                inter_buf_.subspan((col - dest_clip_.left) * DestBpp);
-            uint32_t dest_a = 0;
-            uint32_t dest_r = 0;
-            uint32_t dest_g = 0;
-            uint32_t dest_b = 0;
-            static constexpr size_t kPixelBytes = 4;
-            for (int j = pWeights->src_start_; j <= pWeights->src_end_; ++j) {
-              uint32_t pixel_weight = pWeights->GetWeightForPosition(j);
-              pdfium::span<const uint8_t> src_pixel = src_span.subspan(
-                  static_cast<size_t>((j - src_clip_.top) * inter_pitch_),
-                  kPixelBytes);
-              dest_b += pixel_weight * src_pixel[0];
-              dest_g += pixel_weight * src_pixel[1];
-              dest_r += pixel_weight * src_pixel[2];
-              dest_a += pixel_weight * src_pixel[3];
-            }
-            if (dest_a) {
-              int r = static_cast<uint32_t>(dest_r) * 255 / dest_a;
-              int g = static_cast<uint32_t>(dest_g) * 255 / dest_a;
-              int b = static_cast<uint32_t>(dest_b) * 255 / dest_a;
-              dest_scan[0] = std::clamp(b, 0, 255);
-              dest_scan[1] = std::clamp(g, 0, 255);
-              dest_scan[2] = std::clamp(r, 0, 255);
-            }
-            dest_scan[3] = PixelFromFixed(dest_a);
-            dest_scan += DestBpp;
-          }
-          break;
+      }
+      fxcrt::Copy(row, dest_scanline_);
+      dest_bitmap_->ComposeScanline(top + i - dest_clip_.top, dest_scanline_);
+    }
+  }
+}
+
+void CStretchEngine::StretchVertRow(const PixelWeight& weights,
+                                    pdfium::span<uint32_t> acc,
+                                    pdfium::span<uint8_t> dest_scan) const {
+  // Sum whole rows of the intermediate buffer at a time, then pick out the
+  // channels each transform method uses.
+  std::fill(acc.begin(), acc.end(), 0);
+  for (int j = weights.src_start_; j <= weights.src_end_; ++j) {
+    fxge::AccumulateWeightedRow(
+        inter_buf_.subspan((j - src_clip_.top) * inter_pitch_, acc.size()),
+        weights.GetWeightForPosition(j), acc);
+  }
+
+  const int DestBpp = dest_bpp_ / 8;
+  const int width = dest_clip_.Width();
+  switch (trans_method_) {
+    case TransformMethod::k1BppTo8Bpp:
+    case TransformMethod::k1BppToManyBpp:
+    case TransformMethod::k8BppTo8Bpp: {
+      for (int col = 0; col < width; ++col) {
+        dest_scan[col * DestBpp] = PixelFromFixed(acc[col * DestBpp]);
+      }
+      break;
+    }
+    case TransformMethod::k8BppToManyBpp:
+    case TransformMethod::kManyBpptoManyBpp: {
+      for (int col = 0; col < width; ++col) {
+        for (int c = 0; c < 3; ++c) {
+          dest_scan[col * DestBpp + c] =
+              PixelFromFixed(acc[col * DestBpp + c]);
         }
       }
-      dest_bitmap_->ComposeScanline(row - dest_clip_.top, dest_scanline_);
+      break;
     }
-  });
+    case TransformMethod::kManyBpptoManyBppWithAlpha: {
+      DCHECK(has_alpha_);
+      for (int col = 0; col < width; ++col) {
+        const size_t offset = col * DestBpp;
+        pdfium::span<const uint32_t> sums = acc.subspan(offset, 4u);
+        pdfium::span<uint8_t> dest_pixel = dest_scan.subspan(offset, 4u);
+        const uint32_t dest_a = sums[3];
+        if (dest_a) {
+          int r = static_cast<uint32_t>(sums[2]) * 255 / dest_a;
+          int g = static_cast<uint32_t>(sums[1]) * 255 / dest_a;
+          int b = static_cast<uint32_t>(sums[0]) * 255 / dest_a;
+          dest_pixel[0] = std::clamp(b, 0, 255);
+          dest_pixel[1] = std::clamp(g, 0, 255);
+          dest_pixel[2] = std::clamp(r, 0, 255);
+        }
+        dest_pixel[3] = PixelFromFixed(dest_a);
+      }
+      break;
+    }
+  }
 }
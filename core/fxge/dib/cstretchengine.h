@@ -16,8 +16,10 @@
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/raw_span.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/dib/fx_dib.h"
+#include "core/fxge/dib/stretch_simd.h"
 
 class CFX_DIBBase;
 class PauseIndicatorIface;
@@ -65,6 +67,16 @@ class CStretchEngine {
       UNSAFE_BUFFERS(weights_[position - src_start_] = weight);
     }
 
+    // Returns the weights for positions `src_start_` to `src_end_`.
+    pdfium::span<const uint32_t> GetWeights() const {
+      if (src_end_ < src_start_) {
+        return {};
+      }
+      // SAFETY: SetStartEnd() checks the weights fit.
+      return UNSAFE_BUFFERS(pdfium::span(
+          weights_, static_cast<size_t>(src_end_ - src_start_ + 1)));
+    }
+
     // NOTE: relies on defined behaviour for unsigned overflow to
     // decrement the previous position, as needed.
     void RemoveLastWeightAndAdjust(uint32_t weight_change) {
@@ -122,6 +134,13 @@ class CStretchEngine {
     return resample_options_;
   }
 
+  // Overrides how many parts the passes split their work into, which is
+  // otherwise picked based on the image size and the thread pool. The parts
+  // run on the shared thread pool. 0 restores the default.
+  void SetThreadCountForTesting(int thread_count) {
+    thread_count_for_testing_ = thread_count;
+  }
+
  private:
   enum class State : uint8_t { kInitial, kHorizontal, kVertical };
 
@@ -134,6 +153,16 @@ class CStretchEngine {
     kManyBpptoManyBppWithAlpha
   };
 
+  int GetThreadCount() const;
+  bool ContinueStretchHorzParallel(PauseIndicatorIface* pPause,
+                                   int thread_count);
+  void StretchHorzRow(pdfium::span<const uint8_t> src_span,
+                      pdfium::span<uint8_t> dest_span) const;
+  void StretchVertParallel(const WeightTable& table, int thread_count);
+  void StretchVertRow(const PixelWeight& weights,
+                      pdfium::span<uint32_t> acc,
+                      pdfium::span<uint8_t> dest_scan) const;
+
   const FXDIB_Format dest_format_;
   const int dest_bpp_;
   const int src_bpp_;
@@ -155,7 +184,9 @@ class CStretchEngine {
   TransformMethod trans_method_;
   State state_ = State::kInitial;
   int cur_row_ = 0;
+  int thread_count_for_testing_ = 0;
   WeightTable weight_table_;
+  fxge::ResampleFilter horz_filter_;
 };
 
 #endif  // CORE_FXGE_DIB_CSTRETCHENGINE_H_
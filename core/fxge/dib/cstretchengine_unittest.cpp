@@ -4,13 +4,21 @@
 
 #include "core/fxge/dib/cstretchengine.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/page/cpdf_dib.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/pauseindicator_iface.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
 #include "core/fxge/dib/fx_dib.h"
+#include "core/fxge/dib/scanlinecomposer_iface.h"
+#include "core/fxge/dib/simd_test_support.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace {
@@ -66,6 +74,182 @@ void ExecuteStretchTests(const FXDIB_ResampleOptions& options) {
   }
 }
 
+class RecordingComposer final : public ScanlineComposerIface {
+ public:
+  explicit RecordingComposer(int height) : rows_(height) {}
+
+  // ScanlineComposerIface:
+  void ComposeScanline(int line,
+                       pdfium::span<const uint8_t> scanline) override {
+    rows_[line] = DataVector<uint8_t>(scanline.begin(), scanline.end());
+  }
+  bool SetInfo(int width,
+               int height,
+               FXDIB_Format src_format,
+               DataVector<uint32_t> src_palette) override {
+    return true;
+  }
+
+  const std::vector<DataVector<uint8_t>>& rows() const { return rows_; }
+
+ private:
+  std::vector<DataVector<uint8_t>> rows_;
+};
+
+class AlwaysPause final : public PauseIndicatorIface {
+ public:
+  // PauseIndicatorIface:
+  bool NeedToPauseNow() override { return true; }
+};
+
+RetainPtr<CFX_DIBitmap> MakeNoiseBitmap(int width,
+                                        int height,
+                                        FXDIB_Format format) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, format));
+  uint32_t state = 1;
+  for (int row = 0; row < height; ++row) {
+    for (uint8_t& byte : bitmap->GetWritableScanline(row)) {
+      state = state * 1103515245 + 12345;
+      // Make a quarter of the bytes 0, so that alpha images have fully
+      // transparent areas.
+      byte = (state >> 30) ? static_cast<uint8_t>(state >> 16) : 0;
+    }
+  }
+  return bitmap;
+}
+
+std::vector<DataVector<uint8_t>> StretchBitmapClipped(
+    const RetainPtr<CFX_DIBitmap>& source,
+    FXDIB_Format dest_format,
+    int dest_width,
+    int dest_height,
+    const FX_RECT& clip_rect,
+    const FXDIB_ResampleOptions& options,
+    int thread_count,
+    PauseIndicatorIface* pause) {
+  RecordingComposer composer(clip_rect.Height());
+  CStretchEngine engine(&composer, dest_format, dest_width, dest_height,
+                        clip_rect, source, options);
+  engine.SetThreadCountForTesting(thread_count);
+  CHECK(engine.StartStretchHorz());
+  while (engine.Continue(pause)) {
+  }
+  return composer.rows();
+}
+
+std::vector<DataVector<uint8_t>> StretchBitmap(
+    const RetainPtr<CFX_DIBitmap>& source,
+    FXDIB_Format dest_format,
+    int dest_width,
+    int dest_height,
+    const FXDIB_ResampleOptions& options,
+    int thread_count,
+    PauseIndicatorIface* pause) {
+  return StretchBitmapClipped(source, dest_format, dest_width, dest_height,
+                              FX_RECT(0, 0, dest_width, dest_height), options,
+                              thread_count, pause);
+}
+
+struct StretchCase {
+  FXDIB_Format src_format;
+  FXDIB_Format dest_format;
+};
+
+constexpr StretchCase kStretchCases[] = {
+    {FXDIB_Format::k1bppMask, FXDIB_Format::k8bppMask},
+    {FXDIB_Format::k8bppMask, FXDIB_Format::k8bppMask},
+    {FXDIB_Format::kBgr, FXDIB_Format::kBgr},
+    {FXDIB_Format::kBgrx, FXDIB_Format::kBgrx},
+    {FXDIB_Format::kBgra, FXDIB_Format::kBgra},
+};
+
+// Source and destination sizes covering downscaling, upscaling and a mix.
+constexpr struct {
+  int src_width;
+  int src_height;
+  int dest_width;
+  int dest_height;
+} kStretchSizes[] = {
+    {211, 97, 37, 23},
+    {19, 13, 83, 61},
+    {64, 150, 150, 64},
+};
+
+// Checks that every instruction set and thread count gives the same output
+// as the scalar single-threaded passes.
+void ExecuteConsistencyTests(const FXDIB_ResampleOptions& options,
+                             PauseIndicatorIface* pause) {
+  for (const StretchCase& test_case : kStretchCases) {
+    for (const auto& size : kStretchSizes) {
+      RetainPtr<CFX_DIBitmap> source = MakeNoiseBitmap(
+          size.src_width, size.src_height, test_case.src_format);
+      const std::vector<DataVector<uint8_t>> expected =
+          fxge::RunWithoutSimd([&] {
+            return StretchBitmap(source, test_case.dest_format,
+                                 size.dest_width, size.dest_height, options,
+                                 /*thread_count=*/1, /*pause=*/nullptr);
+          });
+      auto check = [&] {
+        for (int thread_count : {1, 3}) {
+          EXPECT_EQ(expected,
+                    StretchBitmap(source, test_case.dest_format,
+                                  size.dest_width, size.dest_height, options,
+                                  thread_count, pause))
+              << "format " << static_cast<int>(test_case.src_format)
+              << ", size " << size.src_width << "x" << size.src_height
+              << " to " << size.dest_width << "x" << size.dest_height
+              << ", threads " << thread_count;
+        }
+      };
+      fxge::RunWithoutSimd(check);
+      fxge::ForEachSupportedSimdLevel(check);
+    }
+  }
+}
+
+// Checks that stretching through a clip gives the same pixels as the same part
+// of the whole stretched image, so that a page drawn in parts matches.
+void ExecuteClipTests(const FXDIB_ResampleOptions& options) {
+  for (const StretchCase& test_case : kStretchCases) {
+    const int bytes_per_pixel = GetBppFromFormat(test_case.dest_format) / 8;
+    for (const auto& size : kStretchSizes) {
+      RetainPtr<CFX_DIBitmap> source = MakeNoiseBitmap(
+          size.src_width, size.src_height, test_case.src_format);
+      const std::vector<DataVector<uint8_t>> whole =
+          StretchBitmap(source, test_case.dest_format, size.dest_width,
+                        size.dest_height, options, /*thread_count=*/1,
+                        /*pause=*/nullptr);
+      const FX_RECT clips[] = {
+          FX_RECT(0, 0, size.dest_width, 1),
+          FX_RECT(1, 3, size.dest_width - 2, 4),
+          FX_RECT(size.dest_width / 3, size.dest_height / 2,
+                  size.dest_width / 2 + 1, size.dest_height),
+      };
+      for (const FX_RECT& clip : clips) {
+        const std::vector<DataVector<uint8_t>> clipped = StretchBitmapClipped(
+            source, test_case.dest_format, size.dest_width, size.dest_height,
+            clip, options, /*thread_count=*/1, /*pause=*/nullptr);
+        for (int row = clip.top; row < clip.bottom; ++row) {
+          const pdfium::span<const uint8_t> expected =
+              pdfium::span(whole[row]).subspan(
+                  static_cast<size_t>(clip.left * bytes_per_pixel),
+                  static_cast<size_t>(clip.Width() * bytes_per_pixel));
+          const pdfium::span<const uint8_t> actual =
+              pdfium::span(clipped[row - clip.top])
+                  .first(static_cast<size_t>(clip.Width() * bytes_per_pixel));
+          EXPECT_TRUE(std::ranges::equal(expected, actual))
+              << "format " << static_cast<int>(test_case.src_format)
+              << ", size " << size.src_width << "x" << size.src_height
+              << " to " << size.dest_width << "x" << size.dest_height
+              << ", row " << row << " of clip " << clip.left << ","
+              << clip.top << "-" << clip.right << "," << clip.bottom;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace
 
 TEST(CStretchEngine, OverflowInCtor) {
@@ -150,3 +334,36 @@ TEST(CStretchEngine, TooManyWeights) {
                                       kTooBigSrcLen, 0, kTooBigSrcLen,
                                       options));
 }
+
+TEST(CStretchEngine, ConsistentOutput) {
+  FXDIB_ResampleOptions options;
+  ExecuteConsistencyTests(options, /*pause=*/nullptr);
+}
+
+TEST(CStretchEngine, ConsistentOutputBilinear) {
+  FXDIB_ResampleOptions options;
+  options.bInterpolateBilinear = true;
+  ExecuteConsistencyTests(options, /*pause=*/nullptr);
+}
+
+TEST(CStretchEngine, ConsistentOutputNoSmoothing) {
+  FXDIB_ResampleOptions options;
+  options.bNoSmoothing = true;
+  ExecuteConsistencyTests(options, /*pause=*/nullptr);
+}
+
+TEST(CStretchEngine, ClippedOutputMatchesWhole) {
+  ExecuteClipTests(FXDIB_ResampleOptions());
+}
+
+TEST(CStretchEngine, ClippedOutputMatchesWholeBilinear) {
+  FXDIB_ResampleOptions options;
+  options.bInterpolateBilinear = true;
+  ExecuteClipTests(options);
+}
+
+TEST(CStretchEngine, ConsistentOutputWithPauses) {
+  FXDIB_ResampleOptions options;
+  AlwaysPause pause;
+  ExecuteConsistencyTests(options, &pause);
+}
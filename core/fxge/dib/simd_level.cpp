@@ -0,0 +1,89 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/simd_level.h"
+
+#include "build/build_config.h"
+#include "core/fxcrt/check.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(COMPILER_MSVC)
+#include <intrin.h>
+#endif
+
+namespace fxge {
+
+namespace {
+
+std::optional<SimdLevel> g_simd_level_for_testing;
+
+#if defined(ARCH_CPU_X86_FAMILY)
+bool CpuSupportsAvx2() {
+#if defined(COMPILER_MSVC)
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7) {
+    return false;
+  }
+  // AVX2 needs both the instructions and OS support for the YMM registers.
+  __cpuid(regs, 1);
+  constexpr int kOsXsaveAndAvx = (1 << 27) | (1 << 28);
+  if ((regs[2] & kOsXsaveAndAvx) != kOsXsaveAndAvx) {
+    return false;
+  }
+  if ((_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(regs, 7, 0);
+  return regs[1] & (1 << 5);
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+SimdLevel DetectSimdLevel() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  return CpuSupportsAvx2() ? SimdLevel::kAvx2 : SimdLevel::kSse2;
+#elif defined(ARCH_CPU_ARM64)
+  return SimdLevel::kNeon;
+#else
+  return SimdLevel::kNone;
+#endif
+}
+
+}  // namespace
+
+SimdLevel GetSimdLevel() {
+  if (g_simd_level_for_testing.has_value()) {
+    return g_simd_level_for_testing.value();
+  }
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+bool IsSimdLevelSupported(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kNone:
+      return true;
+    case SimdLevel::kSse2:
+    case SimdLevel::kAvx2: {
+      const SimdLevel detected = DetectSimdLevel();
+      return detected == SimdLevel::kAvx2 || detected == level;
+    }
+    case SimdLevel::kNeon:
+      return DetectSimdLevel() == SimdLevel::kNeon;
+  }
+}
+
+ScopedSimdLevelForTesting::ScopedSimdLevelForTesting(SimdLevel level)
+    : previous_level_(g_simd_level_for_testing) {
+  CHECK(IsSimdLevelSupported(level));
+  g_simd_level_for_testing = level;
+}
+
+ScopedSimdLevelForTesting::~ScopedSimdLevelForTesting() {
+  g_simd_level_for_testing = previous_level_;
+}
+
+}  // namespace fxge
@@ -0,0 +1,71 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_SIMD_LEVEL_H_
+#define CORE_FXGE_DIB_SIMD_LEVEL_H_
+
+#include <optional>
+
+namespace fxge {
+
+enum class SimdLevel {
+  kNone,
+  kSse2,
+  kAvx2,
+  kNeon,
+};
+
+// Returns the widest instruction set the SIMD kernels in this directory can
+// use on the running CPU, or the level set by ScopedSimdLevelForTesting.
+SimdLevel GetSimdLevel();
+
+// Returns whether `level` is available on the running CPU.
+bool IsSimdLevelSupported(SimdLevel level);
+
+// The kernels one SIMD code path provides for each level. Each getter returns
+// the kernels built for that level. Leave out the ones not built for the
+// target CPU.
+template <typename Kernels>
+struct SimdKernelSet {
+  const Kernels& (*sse2)() = nullptr;
+  // Optional. Kernels that go a pixel or a table lookup at a time gain
+  // nothing from the wider registers, and fall back to `sse2`.
+  const Kernels& (*avx2)() = nullptr;
+  const Kernels& (*neon)() = nullptr;
+};
+
+// Returns the kernels in `set` for GetSimdLevel(), or nullptr if the caller
+// should use its scalar code.
+template <typename Kernels>
+const Kernels* GetSimdKernels(const SimdKernelSet<Kernels>& set) {
+  const Kernels& (*get)() = nullptr;
+  switch (GetSimdLevel()) {
+    case SimdLevel::kNone:
+      break;
+    case SimdLevel::kSse2:
+      get = set.sse2;
+      break;
+    case SimdLevel::kAvx2:
+      get = set.avx2 ? set.avx2 : set.sse2;
+      break;
+    case SimdLevel::kNeon:
+      get = set.neon;
+      break;
+  }
+  return get ? &get() : nullptr;
+}
+
+// Overrides GetSimdLevel() for its lifetime. Not thread-safe.
+class ScopedSimdLevelForTesting {
+ public:
+  explicit ScopedSimdLevelForTesting(SimdLevel level);
+  ~ScopedSimdLevelForTesting();
+
+ private:
+  const std::optional<SimdLevel> previous_level_;
+};
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_DIB_SIMD_LEVEL_H_
@@ -0,0 +1,46 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_SIMD_TEST_SUPPORT_H_
+#define CORE_FXGE_DIB_SIMD_TEST_SUPPORT_H_
+
+#include <stddef.h>
+
+#include "core/fxge/dib/simd_level.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace fxge {
+
+// Row lengths, in pixels or in bytes, that exercise whole vectors of every
+// level and pixel size as well as the scalar tails after them.
+inline constexpr size_t kSimdTestLengths[] = {
+    0, 1, 3, 4, 5, 7, 8, 9, 13, 15, 16, 17, 24, 31, 32, 33, 64, 100, 101,
+};
+
+// Returns what `fn` returns with the SIMD kernels turned off.
+template <typename Fn>
+auto RunWithoutSimd(Fn fn) {
+  ScopedSimdLevelForTesting scoped_level(SimdLevel::kNone);
+  return fn();
+}
+
+// Calls `fn` once for each SIMD level the running CPU supports, with
+// GetSimdLevel() returning that level. Failures name the level.
+template <typename Fn>
+void ForEachSupportedSimdLevel(Fn fn) {
+  for (SimdLevel level : {SimdLevel::kSse2, SimdLevel::kAvx2,
+                          SimdLevel::kNeon}) {
+    if (!IsSimdLevelSupported(level)) {
+      continue;
+    }
+    SCOPED_TRACE(testing::Message() << "SIMD level "
+                                    << static_cast<int>(level));
+    ScopedSimdLevelForTesting scoped_level(level);
+    fn();
+  }
+}
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_DIB_SIMD_TEST_SUPPORT_H_
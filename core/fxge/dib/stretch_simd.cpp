@@ -0,0 +1,168 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/stretch_simd.h"
+
+#include <algorithm>
+
+#include "build/build_config.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxge/dib/simd_level.h"
+#include "core/fxge/dib/stretch_simd_impl.h"
+
+namespace fxge {
+
+namespace {
+
+const simd_internal::StretchKernels* GetKernels() {
+  static constexpr SimdKernelSet<simd_internal::StretchKernels> kKernels = {
+#if defined(ARCH_CPU_X86_FAMILY)
+      .sse2 = &simd_internal::GetSse2StretchKernels,
+      .avx2 = &simd_internal::GetAvx2StretchKernels,
+#elif defined(ARCH_CPU_ARM64)
+      .neon = &simd_internal::GetNeonStretchKernels,
+#endif
+  };
+  return GetSimdKernels(kKernels);
+}
+
+uint8_t PixelFromFixed(uint32_t fixed) {
+  return static_cast<uint8_t>(fixed >> 16);
+}
+
+void ResampleGrayRowScalar(const simd_internal::ResampleRowArgs& args) {
+  // SAFETY: the caller checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src_pixel = args.src + args.starts[i];
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      uint32_t dest_a = 0;
+      for (size_t j = 0; j < count; ++j) {
+        dest_a += weights[j] * src_pixel[j];
+      }
+      args.dest[i] = PixelFromFixed(dest_a);
+    }
+  });
+}
+
+template <size_t kBytesPerPixel, bool kAlphaWeighted>
+void ResamplePixelRowScalarImpl(const simd_internal::ResampleRowArgs& args) {
+  // SAFETY: the caller checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src_pixel = args.src + args.starts[i] * kBytesPerPixel;
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      uint32_t dest_a = 0;
+      uint32_t dest_r = 0;
+      uint32_t dest_g = 0;
+      uint32_t dest_b = 0;
+      for (size_t j = 0; j < count; ++j, src_pixel += kBytesPerPixel) {
+        uint32_t pixel_weight = weights[j];
+        if constexpr (kAlphaWeighted) {
+          pixel_weight = pixel_weight * src_pixel[3] / 255;
+          dest_a += pixel_weight;
+        }
+        dest_b += pixel_weight * src_pixel[0];
+        dest_g += pixel_weight * src_pixel[1];
+        dest_r += pixel_weight * src_pixel[2];
+      }
+      uint8_t* dest_pixel = args.dest + i * kBytesPerPixel;
+      dest_pixel[0] = PixelFromFixed(dest_b);
+      dest_pixel[1] = PixelFromFixed(dest_g);
+      dest_pixel[2] = PixelFromFixed(dest_r);
+      if constexpr (kAlphaWeighted) {
+        dest_pixel[3] = PixelFromFixed(255 * dest_a);
+      }
+    }
+  });
+}
+
+void ResamplePixelRowScalar(const simd_internal::ResampleRowArgs& args) {
+  if (args.bytes_per_pixel == 3) {
+    ResamplePixelRowScalarImpl<3, false>(args);
+  } else if (args.alpha_weighted) {
+    ResamplePixelRowScalarImpl<4, true>(args);
+  } else {
+    ResamplePixelRowScalarImpl<4, false>(args);
+  }
+}
+
+}  // namespace
+
+ResampleFilter::ResampleFilter() : offsets_(1, 0) {}
+
+ResampleFilter::ResampleFilter(ResampleFilter&& that) noexcept = default;
+
+ResampleFilter& ResampleFilter::operator=(ResampleFilter&& that) noexcept =
+    default;
+
+ResampleFilter::~ResampleFilter() = default;
+
+void ResampleFilter::AddPixel(size_t start,
+                              pdfium::span<const uint32_t> weights) {
+  starts_.push_back(pdfium::checked_cast<uint32_t>(start));
+  weights_.insert(weights_.end(), weights.begin(), weights.end());
+  offsets_.push_back(pdfium::checked_cast<uint32_t>(weights_.size()));
+  if (!weights.empty()) {
+    src_pixels_ = std::max(src_pixels_, start + weights.size());
+  }
+}
+
+void ResampleRow(pdfium::span<const uint8_t> src,
+                 size_t bytes_per_pixel,
+                 bool alpha_weighted,
+                 const ResampleFilter& filter,
+                 pdfium::span<uint8_t> dest) {
+  CHECK(bytes_per_pixel == 1 || bytes_per_pixel == 3 || bytes_per_pixel == 4);
+  CHECK(!alpha_weighted || bytes_per_pixel == 4);
+  CHECK_LE(filter.src_pixels() * bytes_per_pixel, src.size());
+  CHECK_LE(filter.dest_pixels() * bytes_per_pixel, dest.size());
+
+  const simd_internal::ResampleRowArgs args = {
+      .src = src.data(),
+      .src_size = src.size(),
+      .bytes_per_pixel = bytes_per_pixel,
+      .alpha_weighted = alpha_weighted,
+      .starts = filter.starts().data(),
+      .offsets = filter.offsets().data(),
+      .weights = filter.weights().data(),
+      .dest_pixels = filter.dest_pixels(),
+      .dest = dest.data(),
+  };
+  const simd_internal::StretchKernels* kernels = GetKernels();
+  if (bytes_per_pixel == 1) {
+    if (kernels) {
+      kernels->resample_gray_row(args);
+    } else {
+      ResampleGrayRowScalar(args);
+    }
+  } else if (kernels && kernels->resample_pixel_row) {
+    kernels->resample_pixel_row(args);
+  } else {
+    ResamplePixelRowScalar(args);
+  }
+}
+
+void AccumulateWeightedRow(pdfium::span<const uint8_t> src,
+                           uint32_t weight,
+                           pdfium::span<uint32_t> acc) {
+  CHECK_LE(src.size(), acc.size());
+  size_t i = 0;
+  const simd_internal::StretchKernels* kernels = GetKernels();
+  if (kernels) {
+    i = kernels->accumulate_row(src.data(), weight, acc.data(), src.size());
+  }
+  // SAFETY: `acc` is at least as long as `src`, as checked above.
+  UNSAFE_BUFFERS({
+    for (; i < src.size(); ++i) {
+      acc.data()[i] += weight * src.data()[i];
+    }
+  });
+}
+
+}  // namespace fxge
@@ -0,0 +1,71 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_STRETCH_SIMD_H_
+#define CORE_FXGE_DIB_STRETCH_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+
+namespace fxge {
+
+// Row kernels for the CStretchEngine resampling passes. All arithmetic is done
+// on uint32_t and wraps the same way as the scalar code, so the results do not
+// depend on GetSimdLevel().
+
+// The taps for resampling a row horizontally, flattened so that the kernels
+// can walk them without calling back into CStretchEngine.
+class ResampleFilter {
+ public:
+  ResampleFilter();
+  ResampleFilter(ResampleFilter&& that) noexcept;
+  ResampleFilter& operator=(ResampleFilter&& that) noexcept;
+  ~ResampleFilter();
+
+  // Appends a destination pixel made from `weights.size()` consecutive source
+  // pixels starting at `start`.
+  void AddPixel(size_t start, pdfium::span<const uint32_t> weights);
+
+  size_t dest_pixels() const { return starts_.size(); }
+
+  // The number of source pixels a row needs to have for all the taps.
+  size_t src_pixels() const { return src_pixels_; }
+
+  pdfium::span<const uint32_t> starts() const { return starts_; }
+  // Destination pixel `i` uses `weights()[offsets()[i]]` up to, but not
+  // including, `weights()[offsets()[i + 1]]`.
+  pdfium::span<const uint32_t> offsets() const { return offsets_; }
+  pdfium::span<const uint32_t> weights() const { return weights_; }
+
+ private:
+  DataVector<uint32_t> starts_;
+  DataVector<uint32_t> offsets_;
+  DataVector<uint32_t> weights_;
+  size_t src_pixels_ = 0;
+};
+
+// Resamples `src`, a row of pixels of `bytes_per_pixel` bytes, into `dest`
+// using `filter`. `bytes_per_pixel` must be 1, 3 or 4. For 3 and 4-byte
+// pixels, only the first three channels are written unless `alpha_weighted` is
+// set. In that case the pixels must have 4 bytes, each weight is scaled by its
+// source pixel's alpha, and the fourth channel is set to the resulting
+// coverage.
+void ResampleRow(pdfium::span<const uint8_t> src,
+                 size_t bytes_per_pixel,
+                 bool alpha_weighted,
+                 const ResampleFilter& filter,
+                 pdfium::span<uint8_t> dest);
+
+// Adds `weight` times each byte of `src` to the matching element of `acc`.
+// `acc` must be at least as long as `src`.
+void AccumulateWeightedRow(pdfium::span<const uint8_t> src,
+                           uint32_t weight,
+                           pdfium::span<uint32_t> acc);
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_DIB_STRETCH_SIMD_H_
@@ -0,0 +1,164 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Built with AVX2 enabled. Only reached after stretch_simd.cpp has checked
+// that the CPU supports it.
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxge/dib/stretch_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// Reads 4 bytes when they are all before `src_end`, and only the 3 that belong
+// to the pixel otherwise.
+int32_t LoadPixel(const uint8_t* pixel,
+                  size_t bytes_per_pixel,
+                  const uint8_t* src_end) {
+  int32_t word = 0;
+  // SAFETY: ResampleRow() checked the pixel is in bounds.
+  UNSAFE_BUFFERS({
+    if (bytes_per_pixel == 4 || pixel + 4 <= src_end) {
+      memcpy(&word, pixel, 4);
+    } else {
+      memcpy(&word, pixel, 3);
+    }
+  });
+  return word;
+}
+
+uint32_t SumLanes(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+}
+
+__m128i SumHalves(__m256i v) {
+  return _mm_add_epi32(_mm256_castsi256_si128(v),
+                       _mm256_extracti128_si256(v, 1));
+}
+
+void ResampleGrayRow(const ResampleRowArgs& args) {
+  // SAFETY: ResampleRow() checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src = args.src + args.starts[i];
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      size_t j = 0;
+      uint32_t sum = 0;
+      if (count >= 8) {
+        __m256i total = _mm256_setzero_si256();
+        for (; j + 8 <= count; j += 8) {
+          const __m256i values = _mm256_cvtepu8_epi32(
+              _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + j)));
+          total = _mm256_add_epi32(
+              total,
+              _mm256_mullo_epi32(values,
+                                 _mm256_loadu_si256(
+                                     reinterpret_cast<const __m256i*>(
+                                         weights + j))));
+        }
+        sum = SumLanes(SumHalves(total));
+      }
+      for (; j < count; ++j) {
+        sum += weights[j] * src[j];
+      }
+      args.dest[i] = static_cast<uint8_t>(sum >> 16);
+    }
+  });
+}
+
+template <size_t kBytesPerPixel, bool kAlphaWeighted>
+void ResamplePixelRowImpl(const ResampleRowArgs& args) {
+  const __m128i byte_mask = _mm_set1_epi32(0xff);
+  // SAFETY: ResampleRow() checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    const uint8_t* src_end = args.src + args.src_size;
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src_pixel = args.src + args.starts[i] * kBytesPerPixel;
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      __m128i total = _mm_setzero_si128();
+      uint32_t dest_a = 0;
+      for (size_t j = 0; j < count; ++j, src_pixel += kBytesPerPixel) {
+        uint32_t pixel_weight = weights[j];
+        if constexpr (kAlphaWeighted) {
+          pixel_weight = pixel_weight * src_pixel[3] / 255;
+          dest_a += pixel_weight;
+        }
+        total = _mm_add_epi32(
+            total,
+            _mm_mullo_epi32(
+                _mm_cvtepu8_epi32(_mm_cvtsi32_si128(
+                    LoadPixel(src_pixel, kBytesPerPixel, src_end))),
+                _mm_set1_epi32(static_cast<int>(pixel_weight))));
+      }
+      // Each channel is the low byte of its sum shifted down by 16 bits.
+      const __m128i channels =
+          _mm_and_si128(_mm_srli_epi32(total, 16), byte_mask);
+      const __m128i words = _mm_packs_epi32(channels, channels);
+      const int32_t bgrx = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+      uint8_t* dest_pixel = args.dest + i * kBytesPerPixel;
+      memcpy(dest_pixel, &bgrx, 3);
+      if constexpr (kAlphaWeighted) {
+        dest_pixel[3] = static_cast<uint8_t>((255 * dest_a) >> 16);
+      }
+    }
+  });
+}
+
+void ResamplePixelRow(const ResampleRowArgs& args) {
+  if (args.bytes_per_pixel == 3) {
+    ResamplePixelRowImpl<3, false>(args);
+  } else if (args.alpha_weighted) {
+    ResamplePixelRowImpl<4, true>(args);
+  } else {
+    ResamplePixelRowImpl<4, false>(args);
+  }
+}
+
+size_t AccumulateRow(const uint8_t* src,
+                     uint32_t weight,
+                     uint32_t* acc,
+                     size_t count) {
+  const __m256i factor = _mm256_set1_epi32(static_cast<int>(weight));
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    // SAFETY: `i + 16 <= count`, which the caller guarantees is in bounds of
+    // both `src` and `acc`.
+    UNSAFE_BUFFERS({
+      const __m128i bytes =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      __m256i* dest = reinterpret_cast<__m256i*>(acc + i);
+      const __m256i first =
+          _mm256_mullo_epi32(_mm256_cvtepu8_epi32(bytes), factor);
+      const __m256i second = _mm256_mullo_epi32(
+          _mm256_cvtepu8_epi32(_mm_unpackhi_epi64(bytes, bytes)), factor);
+      _mm256_storeu_si256(dest,
+                          _mm256_add_epi32(_mm256_loadu_si256(dest), first));
+      _mm256_storeu_si256(
+          dest + 1, _mm256_add_epi32(_mm256_loadu_si256(dest + 1), second));
+    });
+  }
+  return i;
+}
+
+constexpr StretchKernels kKernels = {
+    .resample_gray_row = &ResampleGrayRow,
+    .resample_pixel_row = &ResamplePixelRow,
+    .accumulate_row = &AccumulateRow,
+};
+
+}  // namespace
+
+const StretchKernels& GetAvx2StretchKernels() {
+  return kKernels;
+}
+
+}  // namespace fxge::simd_internal
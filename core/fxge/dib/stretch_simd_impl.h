@@ -0,0 +1,54 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_DIB_STRETCH_SIMD_IMPL_H_
+#define CORE_FXGE_DIB_STRETCH_SIMD_IMPL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared by the per-instruction set translation units. See
+// composite_simd_impl.h for what may go in here.
+
+namespace fxge::simd_internal {
+
+// The arguments of ResampleRow(), after the dispatcher in stretch_simd.cpp has
+// checked that every tap is in bounds of `src` and every pixel is in bounds of
+// `dest`. 3-byte pixels may be read as 4 bytes where that stays within
+// `src_size`.
+struct ResampleRowArgs {
+  const uint8_t* src;
+  size_t src_size;
+  size_t bytes_per_pixel;
+  bool alpha_weighted;
+  const uint32_t* starts;
+  const uint32_t* offsets;
+  const uint32_t* weights;
+  size_t dest_pixels;
+  uint8_t* dest;
+};
+
+struct StretchKernels {
+  // ResampleRow() for 1-byte pixels.
+  void (*resample_gray_row)(const ResampleRowArgs& args);
+
+  // ResampleRow() for 3 and 4-byte pixels. Null where the scalar code is just
+  // as fast, as with SSE2, which lacks a 32-bit multiply.
+  void (*resample_pixel_row)(const ResampleRowArgs& args);
+
+  // Adds `weight * src[i]` to `acc[i]` for the leading elements it handles,
+  // and returns how many that was.
+  size_t (*accumulate_row)(const uint8_t* src,
+                           uint32_t weight,
+                           uint32_t* acc,
+                           size_t count);
+};
+
+const StretchKernels& GetSse2StretchKernels();
+const StretchKernels& GetAvx2StretchKernels();
+const StretchKernels& GetNeonStretchKernels();
+
+}  // namespace fxge::simd_internal
+
+#endif  // CORE_FXGE_DIB_STRETCH_SIMD_IMPL_H_
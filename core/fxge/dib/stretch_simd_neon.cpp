@@ -0,0 +1,144 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxge/dib/stretch_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// Loads the pixel at `pixel` into 32-bit lanes. Reads 4 bytes when they are
+// all before `src_end`, and only the 3 that belong to the pixel otherwise.
+uint32x4_t LoadPixel(const uint8_t* pixel,
+                     size_t bytes_per_pixel,
+                     const uint8_t* src_end) {
+  uint32_t word = 0;
+  // SAFETY: ResampleRow() checked the pixel is in bounds.
+  UNSAFE_BUFFERS({
+    if (bytes_per_pixel == 4 || pixel + 4 <= src_end) {
+      memcpy(&word, pixel, 4);
+    } else {
+      memcpy(&word, pixel, 3);
+    }
+  });
+  return vmovl_u16(
+      vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(word)))));
+}
+
+void ResampleGrayRow(const ResampleRowArgs& args) {
+  // SAFETY: ResampleRow() checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src = args.src + args.starts[i];
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      size_t j = 0;
+      uint32_t sum = 0;
+      if (count >= 8) {
+        uint32x4_t total = vdupq_n_u32(0);
+        for (; j + 8 <= count; j += 8) {
+          const uint16x8_t values = vmovl_u8(vld1_u8(src + j));
+          total = vmlaq_u32(total, vmovl_u16(vget_low_u16(values)),
+                            vld1q_u32(weights + j));
+          total = vmlaq_u32(total, vmovl_u16(vget_high_u16(values)),
+                            vld1q_u32(weights + j + 4));
+        }
+        sum = vaddvq_u32(total);
+      }
+      for (; j < count; ++j) {
+        sum += weights[j] * src[j];
+      }
+      args.dest[i] = static_cast<uint8_t>(sum >> 16);
+    }
+  });
+}
+
+template <size_t kBytesPerPixel, bool kAlphaWeighted>
+void ResamplePixelRowImpl(const ResampleRowArgs& args) {
+  // SAFETY: ResampleRow() checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    const uint8_t* src_end = args.src + args.src_size;
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src_pixel = args.src + args.starts[i] * kBytesPerPixel;
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      uint32x4_t total = vdupq_n_u32(0);
+      uint32_t dest_a = 0;
+      for (size_t j = 0; j < count; ++j, src_pixel += kBytesPerPixel) {
+        uint32_t pixel_weight = weights[j];
+        if constexpr (kAlphaWeighted) {
+          pixel_weight = pixel_weight * src_pixel[3] / 255;
+          dest_a += pixel_weight;
+        }
+        total = vmlaq_n_u32(
+            total, LoadPixel(src_pixel, kBytesPerPixel, src_end), pixel_weight);
+      }
+      // Each channel is the low byte of its sum shifted down by 16 bits.
+      const uint8x8_t bytes =
+          vmovn_u16(vcombine_u16(vmovn_u32(vshrq_n_u32(total, 16)),
+                                 vdup_n_u16(0)));
+      uint8_t* dest_pixel = args.dest + i * kBytesPerPixel;
+      dest_pixel[0] = vget_lane_u8(bytes, 0);
+      dest_pixel[1] = vget_lane_u8(bytes, 1);
+      dest_pixel[2] = vget_lane_u8(bytes, 2);
+      if constexpr (kAlphaWeighted) {
+        dest_pixel[3] = static_cast<uint8_t>((255 * dest_a) >> 16);
+      }
+    }
+  });
+}
+
+void ResamplePixelRow(const ResampleRowArgs& args) {
+  if (args.bytes_per_pixel == 3) {
+    ResamplePixelRowImpl<3, false>(args);
+  } else if (args.alpha_weighted) {
+    ResamplePixelRowImpl<4, true>(args);
+  } else {
+    ResamplePixelRowImpl<4, false>(args);
+  }
+}
+
+size_t AccumulateRow(const uint8_t* src,
+                     uint32_t weight,
+                     uint32_t* acc,
+                     size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    // SAFETY: `i + 16 <= count`, which the caller guarantees is in bounds of
+    // both `src` and `acc`.
+    UNSAFE_BUFFERS({
+      const uint8x16_t bytes = vld1q_u8(src + i);
+      const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+      const uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+      uint32_t* dest = acc + i;
+      vst1q_u32(dest, vmlaq_n_u32(vld1q_u32(dest),
+                                  vmovl_u16(vget_low_u16(lo)), weight));
+      vst1q_u32(dest + 4, vmlaq_n_u32(vld1q_u32(dest + 4),
+                                      vmovl_u16(vget_high_u16(lo)), weight));
+      vst1q_u32(dest + 8, vmlaq_n_u32(vld1q_u32(dest + 8),
+                                      vmovl_u16(vget_low_u16(hi)), weight));
+      vst1q_u32(dest + 12, vmlaq_n_u32(vld1q_u32(dest + 12),
+                                       vmovl_u16(vget_high_u16(hi)), weight));
+    });
+  }
+  return i;
+}
+
+constexpr StretchKernels kKernels = {
+    .resample_gray_row = &ResampleGrayRow,
+    .resample_pixel_row = &ResamplePixelRow,
+    .accumulate_row = &AccumulateRow,
+};
+
+}  // namespace
+
+const StretchKernels& GetNeonStretchKernels() {
+  return kKernels;
+}
+
+}  // namespace fxge::simd_internal
@@ -0,0 +1,120 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <emmintrin.h>
+#include <string.h>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxge/dib/stretch_simd_impl.h"
+
+namespace fxge::simd_internal {
+
+namespace {
+
+// SSE2 has no 32-bit multiply that keeps the low halves, so multiply the even
+// and odd lanes separately and put the low halves back together.
+__m128i MulLo32(__m128i a, __m128i b) {
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd =
+      _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Widens the 4 bytes in `word` to 32-bit lanes.
+__m128i WidenBytes(int32_t word) {
+  const __m128i zero = _mm_setzero_si128();
+  return _mm_unpacklo_epi16(
+      _mm_unpacklo_epi8(_mm_cvtsi32_si128(word), zero), zero);
+}
+
+void ResampleGrayRow(const ResampleRowArgs& args) {
+  // SAFETY: ResampleRow() checked all taps and pixels are in bounds.
+  UNSAFE_BUFFERS({
+    for (size_t i = 0; i < args.dest_pixels; ++i) {
+      const uint8_t* src = args.src + args.starts[i];
+      const uint32_t* weights = args.weights + args.offsets[i];
+      const size_t count = args.offsets[i + 1] - args.offsets[i];
+      size_t j = 0;
+      uint32_t sum = 0;
+      if (count >= 4) {
+        __m128i total = _mm_setzero_si128();
+        for (; j + 4 <= count; j += 4) {
+          int32_t word;
+          memcpy(&word, src + j, sizeof(word));
+          total = _mm_add_epi32(
+              total,
+              MulLo32(WidenBytes(word),
+                      _mm_loadu_si128(
+                          reinterpret_cast<const __m128i*>(weights + j))));
+        }
+        total = _mm_add_epi32(
+            total, _mm_shuffle_epi32(total, _MM_SHUFFLE(1, 0, 3, 2)));
+        total = _mm_add_epi32(
+            total, _mm_shuffle_epi32(total, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum = static_cast<uint32_t>(_mm_cvtsi128_si32(total));
+      }
+      for (; j < count; ++j) {
+        sum += weights[j] * src[j];
+      }
+      args.dest[i] = static_cast<uint8_t>(sum >> 16);
+    }
+  });
+}
+
+// Splits `weight` into 16-bit halves so that each byte can be multiplied with
+// 16-bit instructions: b * w == b * low + ((b * high) << 16), modulo 2^32.
+size_t AccumulateRow(const uint8_t* src,
+                     uint32_t weight,
+                     uint32_t* acc,
+                     size_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i low = _mm_set1_epi16(static_cast<short>(weight & 0xffff));
+  const __m128i high = _mm_set1_epi16(static_cast<short>(weight >> 16));
+  const bool has_high = weight >> 16;
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    // SAFETY: `i + 16 <= count`, which the caller guarantees is in bounds of
+    // both `src` and `acc`.
+    UNSAFE_BUFFERS({
+      const __m128i bytes =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128i halves[2] = {_mm_unpacklo_epi8(bytes, zero),
+                                 _mm_unpackhi_epi8(bytes, zero)};
+      __m128i* dest = reinterpret_cast<__m128i*>(acc + i);
+      for (int h = 0; h < 2; ++h) {
+        const __m128i prod_lo = _mm_mullo_epi16(halves[h], low);
+        const __m128i prod_hi = _mm_mulhi_epu16(halves[h], low);
+        __m128i first = _mm_unpacklo_epi16(prod_lo, prod_hi);
+        __m128i second = _mm_unpackhi_epi16(prod_lo, prod_hi);
+        if (has_high) {
+          const __m128i shifted = _mm_mullo_epi16(halves[h], high);
+          first = _mm_add_epi32(first, _mm_unpacklo_epi16(zero, shifted));
+          second = _mm_add_epi32(second, _mm_unpackhi_epi16(zero, shifted));
+        }
+        _mm_storeu_si128(
+            dest + 2 * h,
+            _mm_add_epi32(_mm_loadu_si128(dest + 2 * h), first));
+        _mm_storeu_si128(
+            dest + 2 * h + 1,
+            _mm_add_epi32(_mm_loadu_si128(dest + 2 * h + 1), second));
+      }
+    });
+  }
+  return i;
+}
+
+constexpr StretchKernels kKernels = {
+    .resample_gray_row = &ResampleGrayRow,
+    .resample_pixel_row = nullptr,
+    .accumulate_row = &AccumulateRow,
+};
+
+}  // namespace
+
+const StretchKernels& GetSse2StretchKernels() {
+  return kKernels;
+}
+
+}  // namespace fxge::simd_internal
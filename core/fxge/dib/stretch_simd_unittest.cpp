@@ -0,0 +1,160 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/dib/stretch_simd.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/simd_test_support.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Typical fixed-point weights, plus ones large enough that the products wrap.
+constexpr uint32_t kWeights[] = {
+    0,     1,     255,     32768,    65535,      65536,
+    65537, 70000, 0x12345, 1u << 24, 0x89abcdef, 0xffffffff,
+};
+
+class Rng {
+ public:
+  uint32_t Next() {
+    state_ = state_ * 1103515245 + 12345;
+    return state_ >> 8;
+  }
+
+ private:
+  uint32_t state_ = 1;
+};
+
+std::vector<uint8_t> MakeBytes(size_t size, Rng& rng) {
+  std::vector<uint8_t> bytes(size);
+  for (uint8_t& byte : bytes) {
+    byte = static_cast<uint8_t>(rng.Next());
+  }
+  return bytes;
+}
+
+std::vector<uint32_t> MakeWeights(size_t size, Rng& rng) {
+  std::vector<uint32_t> weights(size);
+  for (size_t i = 0; i < size; ++i) {
+    weights[i] = kWeights[rng.Next() % std::size(kWeights)];
+  }
+  return weights;
+}
+
+}  // namespace
+
+TEST(StretchSimd, AccumulateWeightedRow) {
+  Rng rng;
+  for (size_t length : fxge::kSimdTestLengths) {
+    const std::vector<uint8_t> src = MakeBytes(length, rng);
+    for (uint32_t weight : kWeights) {
+      std::vector<uint32_t> initial(length + 1);
+      for (uint32_t& value : initial) {
+        value = rng.Next();
+      }
+      auto accumulate = [&] {
+        std::vector<uint32_t> dest = initial;
+        fxge::AccumulateWeightedRow(src, weight, dest);
+        return dest;
+      };
+      const std::vector<uint32_t> expected = fxge::RunWithoutSimd(accumulate);
+      for (size_t i = 0; i < length; ++i) {
+        ASSERT_EQ(initial[i] + weight * src[i], expected[i]);
+      }
+      EXPECT_EQ(initial[length], expected[length]);
+
+      fxge::ForEachSupportedSimdLevel([&] {
+        EXPECT_EQ(expected, accumulate())
+            << "length " << length << ", weight " << weight;
+      });
+    }
+  }
+}
+
+TEST(StretchSimd, ResampleRow) {
+  struct Format {
+    size_t bytes_per_pixel;
+    bool alpha_weighted;
+  };
+  constexpr Format kFormats[] = {{1, false}, {3, false}, {4, false}, {4, true}};
+  Rng rng;
+  for (const Format& format : kFormats) {
+    const size_t bpp = format.bytes_per_pixel;
+    // One destination pixel per tap count, at varying source offsets.
+    fxge::ResampleFilter filter;
+    std::vector<std::vector<uint32_t>> taps;
+    std::vector<size_t> starts;
+    for (size_t length : fxge::kSimdTestLengths) {
+      starts.push_back(rng.Next() % 8);
+      taps.push_back(MakeWeights(length, rng));
+      filter.AddPixel(starts.back(), taps.back());
+    }
+    ASSERT_EQ(std::size(fxge::kSimdTestLengths), filter.dest_pixels());
+
+    // Sized exactly, so that the last pixel ends the buffer.
+    const std::vector<uint8_t> src =
+        MakeBytes(filter.src_pixels() * bpp, rng);
+    std::vector<uint8_t> expected(filter.dest_pixels() * bpp, 0xcd);
+    for (size_t i = 0; i < taps.size(); ++i) {
+      const size_t channels = bpp == 1 ? 1 : 3;
+      uint32_t sums[3] = {};
+      uint32_t dest_a = 0;
+      for (size_t j = 0; j < taps[i].size(); ++j) {
+        const size_t offset = (starts[i] + j) * bpp;
+        uint32_t weight = taps[i][j];
+        if (format.alpha_weighted) {
+          weight = weight * src[offset + 3] / 255;
+          dest_a += weight;
+        }
+        for (size_t c = 0; c < channels; ++c) {
+          sums[c] += weight * src[offset + c];
+        }
+      }
+      for (size_t c = 0; c < channels; ++c) {
+        expected[i * bpp + c] = static_cast<uint8_t>(sums[c] >> 16);
+      }
+      if (format.alpha_weighted) {
+        expected[i * bpp + 3] = static_cast<uint8_t>((255 * dest_a) >> 16);
+      }
+    }
+
+    auto check = [&] {
+      std::vector<uint8_t> actual(expected.size(), 0xcd);
+      fxge::ResampleRow(src, bpp, format.alpha_weighted, filter, actual);
+      EXPECT_EQ(expected, actual)
+          << "bytes per pixel " << bpp << ", alpha " << format.alpha_weighted;
+    };
+    fxge::RunWithoutSimd(check);
+    fxge::ForEachSupportedSimdLevel(check);
+  }
+}
+
+TEST(StretchSimd, ResampleFilter) {
+  fxge::ResampleFilter filter;
+  EXPECT_EQ(0u, filter.dest_pixels());
+  EXPECT_EQ(0u, filter.src_pixels());
+  ASSERT_EQ(1u, filter.offsets().size());
+
+  const uint32_t kFirst[] = {1, 2, 3};
+  const uint32_t kSecond[] = {4};
+  filter.AddPixel(5, kFirst);
+  filter.AddPixel(2, kSecond);
+  filter.AddPixel(9, {});
+  EXPECT_EQ(3u, filter.dest_pixels());
+  EXPECT_EQ(8u, filter.src_pixels());
+  EXPECT_EQ((std::vector<uint32_t>{5, 2, 9}),
+            std::vector<uint32_t>(filter.starts().begin(),
+                                  filter.starts().end()));
+  EXPECT_EQ((std::vector<uint32_t>{0, 3, 4, 4}),
+            std::vector<uint32_t>(filter.offsets().begin(),
+                                  filter.offsets().end()));
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 3, 4}),
+            std::vector<uint32_t>(filter.weights().begin(),
+                                  filter.weights().end()));
+}
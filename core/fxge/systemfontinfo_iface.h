@@ -10,6 +10,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
+
 #include "core/fxcrt/bytestring.h"
 #include "core/fxcrt/fx_codepage_forward.h"
 #include "core/fxcrt/span.h"
@@ -35,6 +37,12 @@ class SystemFontInfoIface {
   virtual bool GetFaceName(void* hFont, ByteString* name) = 0;
   virtual bool GetFontCharset(void* hFont, FX_Charset* charset) = 0;
   virtual void DeleteFont(void* hFont) = 0;
+
+  // Returns a font info that finds the same fonts, for the font mapper of a
+  // CFX_GEModule on another thread, or nullptr if this one cannot be shared.
+  virtual std::unique_ptr<SystemFontInfoIface> ShareWithOtherThread() {
+    return nullptr;
+  }
 };
 
 #endif  // CORE_FXGE_SYSTEMFONTINFO_IFACE_H_
@@ -0,0 +1,398 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "fpdfsdk/cpdfsdk_bandrenderer.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/fpdfapi/edit/cpdf_creator.h"
+#include "core/fpdfapi/edit/cpdf_pageexporter.h"
+#include "core/fpdfapi/page/cpdf_docpagedata.h"
+#include "core/fpdfapi/page/cpdf_page.h"
+#include "core/fpdfapi/page/cpdf_pageimagecache.h"
+#include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/parser/cpdf_parser.h"
+#include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fpdfapi/render/cpdf_pagerendercontext.h"
+#include "core/fxcrt/cfx_memorystream.h"
+#include "core/fxcrt/cfx_read_only_span_stream.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/thread_pool.h"
+#include "core/fxge/cfx_defaultrenderdevice.h"
+#include "core/fxge/cfx_gemodule.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "fpdfsdk/cpdfsdk_helpers.h"
+#include "fpdfsdk/cpdfsdk_renderpage.h"
+#include "public/fpdfview.h"
+
+namespace {
+
+// A page whose objects no longer match its content streams cannot be
+// reproduced by copying the page dictionary.
+bool HasUnsavedEdits(const CPDF_Page* page) {
+  if (page->HasDirtyStreams()) {
+    return true;
+  }
+  for (const auto& obj : *page) {
+    if (obj->IsDirty() ||
+        obj->GetContentStream() == CPDF_PageObject::kNoContentStream) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Serializes a single-page document holding a copy of `page`, or returns
+// nullptr if the copy would not render identically to the original.
+RetainPtr<CFX_MemoryStream> SnapshotPage(CPDF_Page* page) {
+  CPDF_Document* src_doc = page->GetDocument();
+  if (src_doc->GetExtension() || HasUnsavedEdits(page)) {
+    return nullptr;
+  }
+
+  // Optional content visibility is configured at the document level, and is
+  // not carried over by the exporter.
+  const CPDF_Dictionary* root = src_doc->GetRoot();
+  if (!root || root->KeyExist("OCProperties")) {
+    return nullptr;
+  }
+
+  int page_index = src_doc->GetPageIndex(page->GetDict()->GetObjNum());
+  if (page_index < 0) {
+    return nullptr;
+  }
+
+  auto dest_doc =
+      std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
+                                      std::make_unique<CPDF_DocPageData>());
+  dest_doc->CreateNewDoc();
+  CPDF_PageExporter exporter(dest_doc.get(), src_doc);
+  const uint32_t page_indices[] = {static_cast<uint32_t>(page_index)};
+  if (!exporter.ExportPages(page_indices, 0)) {
+    return nullptr;
+  }
+
+  auto stream = pdfium::MakeRetain<CFX_MemoryStream>();
+  CPDF_Creator creator(dest_doc.get(), stream);
+  if (!creator.Create(0)) {
+    return nullptr;
+  }
+  return stream;
+}
+
+// Snapshots of a page that did not change only differ in their file IDs,
+// which CPDF_Creator makes up anew every time. The ID is the last entry of the
+// trailer, and always has the same size.
+bool IsSameSnapshot(pdfium::span<const uint8_t> a,
+                    pdfium::span<const uint8_t> b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  static constexpr uint8_t kIdKey[] = {'/', 'I', 'D'};
+  const auto id = std::ranges::find_end(a, kIdKey);
+  if (id.empty()) {
+    return std::ranges::equal(a, b);
+  }
+  const size_t id_start = id.begin() - a.begin();
+  const size_t id_end = std::find(id.end(), a.end(), ']') - a.begin();
+  return std::ranges::equal(a.first(id_start), b.first(id_start)) &&
+         std::ranges::equal(a.subspan(id_end), b.subspan(id_end));
+}
+
+// A copy of a page, parsed from a snapshot with the engine of the thread that
+// uses it.
+struct PageCopy {
+  // The document reads objects from here as it needs them.
+  DataVector<uint8_t> snapshot;
+  std::unique_ptr<CPDF_Document> document;
+  RetainPtr<CPDF_Page> page;
+};
+
+std::unique_ptr<PageCopy> ParsePageCopy(pdfium::span<const uint8_t> snapshot) {
+  auto copy = std::make_unique<PageCopy>();
+  copy->snapshot = DataVector<uint8_t>(snapshot.begin(), snapshot.end());
+  copy->document =
+      std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
+                                      std::make_unique<CPDF_DocPageData>());
+  if (copy->document->LoadDoc(
+          pdfium::MakeRetain<CFX_ReadOnlySpanStream>(copy->snapshot),
+          nullptr) != CPDF_Parser::SUCCESS) {
+    return nullptr;
+  }
+
+  RetainPtr<CPDF_Dictionary> dict = copy->document->GetMutablePageDictionary(0);
+  if (!dict) {
+    return nullptr;
+  }
+
+  copy->page =
+      pdfium::MakeRetain<CPDF_Page>(copy->document.get(), std::move(dict));
+  copy->page->AddPageImageCache();
+  copy->page->ParseContent();
+  return copy;
+}
+
+// How many threads of the pool hold a copy of a page, so that closing a page
+// only bothers them when there may be something to let go of.
+std::atomic<size_t> g_pool_copy_count = 0;
+
+// What a thread of the pool keeps from one call to the next: an engine of its
+// own, and the copy of the page it rendered last, which the next call reuses
+// when the page is the same. The copy goes when that page is closed, and the
+// engine when the pool ends the thread.
+class PoolThreadState {
+ public:
+  PoolThreadState() { InitEngineForCurrentThread(); }
+  ~PoolThreadState() {
+    // The copy holds fonts and color spaces of the engine.
+    ReleaseCopy();
+    DestroyEngineForCurrentThread();
+  }
+
+  // Returns nullptr if `snapshot` does not parse. `page_id` identifies the
+  // page the snapshot is of.
+  PageCopy* GetCopy(pdfium::span<const uint8_t> snapshot, uintptr_t page_id) {
+    if (!copy_ || !IsSameSnapshot(copy_->snapshot, snapshot)) {
+      ReleaseCopy();
+      copy_ = ParsePageCopy(snapshot);
+      if (copy_) {
+        ++g_pool_copy_count;
+      }
+    }
+    page_id_ = page_id;
+    return copy_.get();
+  }
+
+  void ReleaseCopyOf(uintptr_t page_id) {
+    if (page_id_ == page_id) {
+      ReleaseCopy();
+    }
+  }
+
+ private:
+  void ReleaseCopy() {
+    if (copy_) {
+      copy_.reset();
+      --g_pool_copy_count;
+    }
+    page_id_ = 0;
+  }
+
+  std::unique_ptr<PageCopy> copy_;
+  // The address of the page `copy_` was last used for. Only ever compared,
+  // since that page may be gone.
+  uintptr_t page_id_ = 0;
+};
+
+thread_local std::unique_ptr<PoolThreadState> g_pool_thread_state;
+
+// What all bands have in common, as plain data so that no retained object
+// crosses threads.
+struct BandTarget {
+  pdfium::span<const uint8_t> snapshot;
+  uintptr_t page_id;
+  pdfium::span<uint8_t> buffer;
+  int width;
+  int height;
+  FXDIB_Format format;
+  uint32_t pitch;
+  FX_RECT page_rect;
+  int rotate;
+  int flags;
+};
+
+struct Band {
+  FX_RECT rect;
+  bool succeeded = false;
+};
+
+// Bands are handed out to threads in order, as each thread gets to them.
+struct BandQueue {
+  std::vector<Band> bands;
+  std::atomic<size_t> next = 0;
+
+  Band* Take() {
+    size_t index = next++;
+    return index < bands.size() ? &bands[index] : nullptr;
+  }
+};
+
+void RenderBand(CPDF_Page* page,
+                RetainPtr<CFX_DIBitmap> bitmap,
+                const BandTarget& target,
+                const FX_RECT& band_rect) {
+  auto owned_context = std::make_unique<CPDF_PageRenderContext>();
+  CPDF_PageRenderContext* context = owned_context.get();
+  CPDF_Page::RenderContextClearer clearer(page);
+  page->SetRenderContext(std::move(owned_context));
+
+  auto device = std::make_unique<CFX_DefaultRenderDevice>();
+  device->AttachWithRgbByteOrder(std::move(bitmap),
+                                 !!(target.flags & FPDF_REVERSE_BYTE_ORDER));
+  context->device_ = std::move(device);
+
+  // Same matrix as the full-page render, so only the clip differs.
+  CPDFSDK_RenderPage(
+      context, page,
+      page->GetDisplayMatrixForRect(target.page_rect, target.rotate),
+      band_rect, target.flags, /*color_scheme=*/nullptr);
+}
+
+// Renders `first_band`, and then more bands from `queue`, from `copy`.
+void RenderBandsFromCopy(const PageCopy& copy,
+                         const BandTarget& target,
+                         Band* first_band,
+                         BandQueue* queue) {
+  // Wraps the caller's pixels, so bands are drawn in place. Bands cover
+  // disjoint rows, so threads never write the same bytes.
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  if (!bitmap->Create(target.width, target.height, target.format,
+                      target.buffer.data(), target.pitch)) {
+    return;
+  }
+
+  for (Band* band = first_band; band; band = queue->Take()) {
+    RenderBand(copy.page.Get(), bitmap, target, band->rect);
+    band->succeeded = true;
+  }
+}
+
+void RunBandWorker(const BandTarget& target, BandQueue* queue) {
+  // Nothing left to do is common, since the calling thread also takes bands,
+  // so check before paying for an engine and a parse.
+  Band* first_band = queue->Take();
+  if (!first_band) {
+    return;
+  }
+
+  // Threads of the pool live until the library goes, so they keep what they
+  // set up for the next call.
+  if (ThreadPool::IsPoolThread()) {
+    if (!g_pool_thread_state) {
+      g_pool_thread_state = std::make_unique<PoolThreadState>();
+    }
+    PageCopy* copy =
+        g_pool_thread_state->GetCopy(target.snapshot, target.page_id);
+    if (copy) {
+      RenderBandsFromCopy(*copy, target, first_band, queue);
+    }
+    return;
+  }
+
+  // Threads of an executor may outlive the library, so they set up everything
+  // for this call only. A thread that already has an engine lends it to the
+  // copy for that long.
+  const bool has_engine = CFX_GEModule::HasModuleForCurrentThread();
+  if (!has_engine) {
+    InitEngineForCurrentThread();
+  }
+  if (std::unique_ptr<PageCopy> copy = ParsePageCopy(target.snapshot)) {
+    RenderBandsFromCopy(*copy, target, first_band, queue);
+  }
+  if (!has_engine) {
+    DestroyEngineForCurrentThread();
+  }
+}
+
+}  // namespace
+
+bool CPDFSDK_RenderPageInBands(CPDF_Page* pPage,
+                               RetainPtr<CFX_DIBitmap> pBitmap,
+                               const FX_RECT& rect,
+                               int rotate,
+                               int flags,
+                               int band_count) {
+  if (band_count < 2 || CFX_DefaultRenderDevice::UseSkiaRenderer()) {
+    return false;
+  }
+
+  FX_RECT target_rect = rect;
+  target_rect.Intersect(
+      FX_RECT(0, 0, pBitmap->GetWidth(), pBitmap->GetHeight()));
+  if (target_rect.IsEmpty()) {
+    return false;
+  }
+  band_count = std::min(band_count, target_rect.Height());
+
+  // Bands are only worth the copy of the page when other threads can help.
+  const size_t worker_count = std::min<size_t>(
+      band_count, ThreadPool::GetMaxConcurrency());
+  if (worker_count < 2) {
+    return false;
+  }
+
+  RetainPtr<CFX_MemoryStream> snapshot = SnapshotPage(pPage);
+  if (!snapshot) {
+    return false;
+  }
+
+  BandTarget target;
+  target.snapshot = snapshot->GetSpan();
+  target.page_id = reinterpret_cast<uintptr_t>(pPage);
+  target.buffer = pBitmap->GetWritableBuffer();
+  target.width = pBitmap->GetWidth();
+  target.height = pBitmap->GetHeight();
+  target.format = pBitmap->GetFormat();
+  target.pitch = pBitmap->GetPitch();
+  target.page_rect = rect;
+  target.rotate = rotate;
+  target.flags = flags;
+
+  BandQueue queue;
+  const int band_height = (target_rect.Height() + band_count - 1) / band_count;
+  for (int i = 0; i < band_count; ++i) {
+    FX_RECT band_rect(
+        target_rect.left, target_rect.top + i * band_height, target_rect.right,
+        std::min(target_rect.top + (i + 1) * band_height, target_rect.bottom));
+    if (!band_rect.IsEmpty()) {
+      queue.bands.push_back({band_rect});
+    }
+  }
+
+  // The calling thread renders from `pPage` itself, which is already parsed.
+  // Everything else renders from a copy, even where an executor runs it on
+  // the calling thread.
+  ThreadPool::ParallelFor(worker_count, [&](size_t) {
+    if (!ThreadPool::IsCallingThread()) {
+      RunBandWorker(target, &queue);
+      return;
+    }
+    while (Band* band = queue.Take()) {
+      RenderBand(pPage, pBitmap, target, band->rect);
+      band->succeeded = true;
+    }
+  });
+
+  // Bands that could not be rendered from the snapshot, which should not
+  // happen in practice, are drawn from the original page instead.
+  for (const Band& band : queue.bands) {
+    if (!band.succeeded) {
+      RenderBand(pPage, pBitmap, target, band.rect);
+    }
+  }
+  return true;
+}
+
+void CPDFSDK_ReleasePageCopies(const CPDF_Page* pPage) {
+  ThreadPool* pool = ThreadPool::Get();
+  if (!pool || g_pool_copy_count == 0) {
+    return;
+  }
+  const uintptr_t page_id = reinterpret_cast<uintptr_t>(pPage);
+  pool->PostToEachWorker([page_id] {
+    if (g_pool_thread_state) {
+      g_pool_thread_state->ReleaseCopyOf(page_id);
+    }
+  });
+}
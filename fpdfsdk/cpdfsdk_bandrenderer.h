@@ -0,0 +1,40 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FPDFSDK_CPDFSDK_BANDRENDERER_H_
+#define FPDFSDK_CPDFSDK_BANDRENDERER_H_
+
+#include "core/fxcrt/retain_ptr.h"
+
+class CFX_DIBitmap;
+class CPDF_Page;
+struct FX_RECT;
+
+// Renders `pPage` into the `rect` area of `pBitmap`, split into `band_count`
+// horizontal bands that are rendered concurrently on the shared thread pool.
+// The calling thread renders bands from `pPage` itself. Core objects are not
+// safe to share between threads, so everything else renders from a private
+// copy of the page, serialized once up front, with an engine no other thread
+// is using. Threads of the pool keep their engine and copy for the next call,
+// which reuses the copy if the page serializes to the same bytes, until
+// CPDFSDK_ReleasePageCopies(); threads of an embedder's executor set both up
+// for one call only.
+// Each band only draws objects whose bounding boxes intersect it.
+//
+// Returns false without touching `pBitmap` when the pool has no other threads
+// to help, or when the page cannot be copied faithfully, e.g. when it has
+// unsaved edits or depends on document-level state such as optional content.
+// Callers should then render serially.
+bool CPDFSDK_RenderPageInBands(CPDF_Page* pPage,
+                               RetainPtr<CFX_DIBitmap> pBitmap,
+                               const FX_RECT& rect,
+                               int rotate,
+                               int flags,
+                               int band_count);
+
+// Makes the threads of the pool let go of the copies they keep of `pPage`, in
+// the background. Call when `pPage` is closed.
+void CPDFSDK_ReleasePageCopies(const CPDF_Page* pPage);
+
+#endif  // FPDFSDK_CPDFSDK_BANDRENDERER_H_
@@ -12,6 +12,7 @@
 #include "constants/form_fields.h"
 #include "constants/stream_dict_common.h"
 #include "core/fpdfapi/page/cpdf_page.h"
+#include "core/fpdfapi/page/cpdf_pagemodule.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
@@ -28,6 +29,7 @@
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxcrt/unowned_ptr.h"
+#include "core/fxge/cfx_gemodule.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 #include "fpdfsdk/cpdfsdk_formfillenvironment.h"
 
@@ -261,6 +263,21 @@ CPDFSDK_InteractiveForm* FormHandleToInteractiveForm(FPDF_FORMHANDLE hHandle) {
   return pFormFillEnv ? pFormFillEnv->GetInteractiveForm() : nullptr;
 }
 
+void InitEngineForCurrentThread() {
+  DCHECK(!CFX_GEModule::HasModuleForCurrentThread());
+  // Inherit the font paths from the process-wide module, which is what Get()
+  // still returns at this point.
+  CFX_GEModule::CreateForCurrentThread(
+      CFX_GEModule::Get()->GetUserFontPaths());
+  pdfium::InitializePageModuleForCurrentThread();
+}
+
+void DestroyEngineForCurrentThread() {
+  DCHECK(CFX_GEModule::HasModuleForCurrentThread());
+  pdfium::DestroyPageModuleForCurrentThread();
+  CFX_GEModule::DestroyForCurrentThread();
+}
+
 ByteString ByteStringFromFPDFWideString(FPDF_WIDESTRING wide_string) {
   // SAFETY: caller ensures `wide_string` is NUL-terminated and enforced
   // by UNSAFE_BUFFER_USAGE in header file.
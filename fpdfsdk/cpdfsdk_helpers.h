@@ -274,6 +274,12 @@ void ValidateBitmapPremultiplyState(CFX_DIBitmap* bitmap);
 
 CPDFSDK_InteractiveForm* FormHandleToInteractiveForm(FPDF_FORMHANDLE hHandle);
 
+// Gives the current thread an engine of its own, which takes over from the
+// process-wide one on this thread until DestroyEngineForCurrentThread(). The
+// library must be initialized, and the thread must not have an engine yet.
+void InitEngineForCurrentThread();
+void DestroyEngineForCurrentThread();
+
 // PRECONDITIONS: `wide_string` must be terminated by a NUL FPDF_WCHAR.
 UNSAFE_BUFFER_USAGE ByteString
 ByteStringFromFPDFWideString(FPDF_WIDESTRING wide_string);
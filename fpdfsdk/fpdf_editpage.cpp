@@ -21,6 +21,7 @@
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/page/cpdf_pageimagecache.h"
 #include "core/fpdfapi/page/cpdf_pageobject.h"
+#include "core/fpdfapi/page/cpdf_pageobjectspatialindex.h"
 #include "core/fpdfapi/page/cpdf_pathobject.h"
 #include "core/fpdfapi/page/cpdf_shadingobject.h"
 #include "core/fpdfapi/page/cpdf_textobject.h"
@@ -34,6 +35,7 @@
 #include "core/fpdfdoc/cpdf_annot.h"
 #include "core/fpdfdoc/cpdf_annotlist.h"
 #include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/containers/adapters.h"
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/notreached.h"
@@ -334,6 +336,66 @@ FPDF_EXPORT FPDF_PAGEOBJECT FPDF_CALLCONV FPDFPage_GetObject(FPDF_PAGE page,
   return FPDFPageObjectFromCPDFPageObject(pPage->GetPageObjectByIndex(index));
 }
 
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFPage_GetObjectsInRect(FPDF_PAGE page,
+                          const FS_RECTF* rect,
+                          FPDF_PAGEOBJECT* objects,
+                          unsigned long max_objects) {
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  if (!IsPageObject(pPage) || !rect || (!objects && max_objects)) {
+    return -1;
+  }
+
+  // SAFETY: required from caller.
+  auto objects_span = UNSAFE_BUFFERS(pdfium::span(objects, max_objects));
+  size_t count = 0;
+  for (size_t index :
+       pPage->GetPageObjectIndicesInRect(CFXFloatRectFromFSRectF(*rect))) {
+    CPDF_PageObject* pPageObj = pPage->GetPageObjectByIndex(index);
+    if (!pPageObj->IsActive()) {
+      continue;
+    }
+    if (count < objects_span.size()) {
+      objects_span[count] = FPDFPageObjectFromCPDFPageObject(pPageObj);
+    }
+    ++count;
+  }
+  return pdfium::checked_cast<int>(count);
+}
+
+FPDF_EXPORT FPDF_PAGEOBJECT FPDF_CALLCONV
+FPDFPage_HitTestObject(FPDF_PAGE page,
+                       float x,
+                       float y,
+                       float tolerance,
+                       int type) {
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  if (!IsPageObject(pPage) || tolerance < 0) {
+    return nullptr;
+  }
+
+  // Candidates are in paint order, so the topmost match is the last one.
+  const CFX_FloatRect point_rect(x, y, x, y);
+  std::vector<size_t> indices = pPage->GetPageObjectIndicesInRect(
+      CFX_FloatRect(x - tolerance, y - tolerance, x + tolerance, y + tolerance));
+  for (size_t index : pdfium::Reversed(indices)) {
+    CPDF_PageObject* pPageObj = pPage->GetPageObjectByIndex(index);
+    if (!pPageObj->IsActive()) {
+      continue;
+    }
+    if (type != FPDF_PAGEOBJ_UNKNOWN &&
+        static_cast<int>(pPageObj->GetType()) != type) {
+      continue;
+    }
+    CFX_FloatRect bounds = pPageObj->GetRect();
+    bounds.Inflate(tolerance, tolerance);
+    if (CPDF_PageObjectSpatialIndex::Intersects(bounds, point_rect)) {
+      return FPDFPageObjectFromCPDFPageObject(pPageObj);
+    }
+  }
+  return nullptr;
+}
+
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDFPage_HasTransparency(FPDF_PAGE page) {
   CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
   return pPage && pPage->BackgroundAlphaNeeded();
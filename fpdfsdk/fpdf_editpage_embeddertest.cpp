@@ -759,3 +759,84 @@ TEST_F(FPDFEditPageEmbedderTest, Bug378464305) {
     CloseSavedDocument();
   }
 }
+
+TEST_F(FPDFEditPageEmbedderTest, GetObjectsInRect) {
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  ASSERT_EQ(8, FPDFPage_CountObjects(page.get()));
+
+  // Negative testing.
+  const FS_RECTF page_rect = {0, 300, 200, 0};
+  EXPECT_EQ(-1, FPDFPage_GetObjectsInRect(nullptr, &page_rect, nullptr, 0));
+  EXPECT_EQ(-1, FPDFPage_GetObjectsInRect(page.get(), nullptr, nullptr, 0));
+  EXPECT_EQ(-1, FPDFPage_GetObjectsInRect(page.get(), &page_rect, nullptr, 1));
+
+  // The whole page intersects every object, in paint order.
+  std::array<FPDF_PAGEOBJECT, 8> objects = {};
+  ASSERT_EQ(8, FPDFPage_GetObjectsInRect(page.get(), &page_rect, nullptr, 0));
+  ASSERT_EQ(8, FPDFPage_GetObjectsInRect(page.get(), &page_rect,
+                                         objects.data(), objects.size()));
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(FPDFPage_GetObject(page.get(), i), objects[i]);
+  }
+
+  // A truncated buffer still reports the full count.
+  objects.fill(nullptr);
+  EXPECT_EQ(8, FPDFPage_GetObjectsInRect(page.get(), &page_rect,
+                                         objects.data(), 2));
+  EXPECT_EQ(FPDFPage_GetObject(page.get(), 1), objects[1]);
+  EXPECT_FALSE(objects[2]);
+
+  // A rectangle off the page intersects nothing.
+  const FS_RECTF off_page_rect = {1000, 1100, 1100, 1000};
+  EXPECT_EQ(0,
+            FPDFPage_GetObjectsInRect(page.get(), &off_page_rect, nullptr, 0));
+
+  // Inactive objects are skipped.
+  FPDF_PAGEOBJECT page_obj = FPDFPage_GetObject(page.get(), 4);
+  ASSERT_TRUE(FPDFPageObj_SetIsActive(page_obj, /*active=*/false));
+  EXPECT_EQ(7, FPDFPage_GetObjectsInRect(page.get(), &page_rect, nullptr, 0));
+}
+
+TEST_F(FPDFEditPageEmbedderTest, HitTestObject) {
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  EXPECT_FALSE(FPDFPage_HitTestObject(nullptr, 0, 0, 0, FPDF_PAGEOBJ_UNKNOWN));
+  EXPECT_FALSE(
+      FPDFPage_HitTestObject(page.get(), 0, 0, -1, FPDF_PAGEOBJ_UNKNOWN));
+  EXPECT_FALSE(
+      FPDFPage_HitTestObject(page.get(), 1000, 1000, 0, FPDF_PAGEOBJ_UNKNOWN));
+
+  // Hit testing the center of each object finds the topmost object there.
+  const int count = FPDFPage_CountObjects(page.get());
+  for (int i = 0; i < count; ++i) {
+    float left;
+    float bottom;
+    float right;
+    float top;
+    ASSERT_TRUE(FPDFPageObj_GetBounds(FPDFPage_GetObject(page.get(), i), &left,
+                                      &bottom, &right, &top));
+    const float x = (left + right) / 2;
+    const float y = (bottom + top) / 2;
+
+    FPDF_PAGEOBJECT expected = nullptr;
+    for (int j = count - 1; j >= 0 && !expected; --j) {
+      FPDF_PAGEOBJECT candidate = FPDFPage_GetObject(page.get(), j);
+      ASSERT_TRUE(
+          FPDFPageObj_GetBounds(candidate, &left, &bottom, &right, &top));
+      if (x >= left && x <= right && y >= bottom && y <= top) {
+        expected = candidate;
+      }
+    }
+    ASSERT_TRUE(expected);
+    EXPECT_EQ(expected, FPDFPage_HitTestObject(page.get(), x, y, 0,
+                                               FPDF_PAGEOBJ_UNKNOWN));
+    EXPECT_EQ(expected,
+              FPDFPage_HitTestObject(page.get(), x, y, 0, FPDF_PAGEOBJ_PATH));
+    EXPECT_FALSE(
+        FPDFPage_HitTestObject(page.get(), x, y, 0, FPDF_PAGEOBJ_IMAGE));
+  }
+}
@@ -21,6 +21,7 @@
 #include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/cfx_fontmgr.h"
 #include "core/fxge/cfx_gemodule.h"
+#include "core/fxge/cfx_sharedfontinfo.h"
 #include "core/fxge/fx_font.h"
 #include "core/fxge/systemfontinfo_iface.h"
 
@@ -165,8 +166,10 @@ FPDF_SetSystemFontInfo(FPDF_SYSFONTINFO* font_infoExt) {
     return;
   }
 
-  mapper->SetSystemFontInfo(
-      std::make_unique<CFX_ExternalFontInfo>(font_infoExt));
+  // Shared, so that engines created by FPDF_InitEngineForCurrentThread() use
+  // it as well.
+  mapper->SetSystemFontInfo(std::make_unique<CFX_SharedFontInfo>(
+      std::make_unique<CFX_ExternalFontInfo>(font_infoExt)));
 
 #ifdef PDF_ENABLE_XFA
   CFGAS_GEModule::Get()->GetFontMgr()->EnumFonts();
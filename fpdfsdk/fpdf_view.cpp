@@ -35,6 +35,7 @@
 #include "core/fxcrt/cfx_timer.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/fx_safe_types.h"
@@ -45,12 +46,14 @@
 #include "core/fxcrt/ptr_util.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/stl_util.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/cfx_gemodule.h"
 #include "core/fxge/cfx_glyphcache.h"
 #include "core/fxge/cfx_renderdevice.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
+#include "fpdfsdk/cpdfsdk_bandrenderer.h"
 #include "fpdfsdk/cpdfsdk_customaccess.h"
 #include "fpdfsdk/cpdfsdk_formfillenvironment.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
@@ -120,6 +123,7 @@ static_assert(static_cast<int>(CFX_DefaultRenderDevice::RendererType::kSkia) ==
 namespace {
 
 bool g_bLibraryInitialized = false;
+bool g_bMapFiles = false;
 
 void SetRendererType(FPDF_RENDERER_TYPE public_type) {
   // Internal definition of renderer types must stay updated with respect to
@@ -207,7 +211,8 @@ std::vector<XFAPacket> GetXFAPackets(RetainPtr<const CPDF_Object> xfa_object) {
 }
 
 FPDF_DOCUMENT LoadDocumentImpl(RetainPtr<IFX_SeekableReadStream> pFileAccess,
-                               FPDF_BYTESTRING password) {
+                               FPDF_BYTESTRING password,
+                               pdfium::span<const uint8_t> cross_ref_cache) {
   if (!pFileAccess) {
     ProcessParseError(CPDF_Parser::FILE_ERROR);
     return nullptr;
@@ -217,8 +222,8 @@ FPDF_DOCUMENT LoadDocumentImpl(RetainPtr<IFX_SeekableReadStream> pFileAccess,
       std::make_unique<CPDF_Document>(std::make_unique<CPDF_DocRenderData>(),
                                       std::make_unique<CPDF_DocPageData>());
 
-  CPDF_Parser::Error error =
-      document->LoadDoc(std::move(pFileAccess), password);
+  CPDF_Parser::Error error = document->LoadDocWithCrossRefCache(
+      std::move(pFileAccess), password, cross_ref_cache);
   if (error != CPDF_Parser::SUCCESS) {
     ProcessParseError(error);
     return nullptr;
@@ -228,6 +233,18 @@ FPDF_DOCUMENT LoadDocumentImpl(RetainPtr<IFX_SeekableReadStream> pFileAccess,
   return FPDFDocumentFromCPDFDocument(document.release());
 }
 
+FPDF_DOCUMENT LoadDocumentImpl(RetainPtr<IFX_SeekableReadStream> pFileAccess,
+                               FPDF_BYTESTRING password) {
+  return LoadDocumentImpl(std::move(pFileAccess), password,
+                          pdfium::span<const uint8_t>());
+}
+
+RetainPtr<IFX_SeekableReadStream> CreateFileStream(FPDF_STRING file_path) {
+  return g_bMapFiles
+             ? IFX_SeekableReadStream::CreateMappedFromFilename(file_path)
+             : IFX_SeekableReadStream::CreateFromFilename(file_path);
+}
+
 }  // namespace
 
 FPDF_EXPORT void FPDF_CALLCONV FPDF_InitLibrary() {
@@ -242,6 +259,14 @@ FPDF_InitLibraryWithConfig(const FPDF_LIBRARY_CONFIG* config) {
 
   FX_InitializeMemoryAllocators();
   CFX_Timer::InitializeGlobals();
+
+  ThreadPool::Options thread_pool_options;
+  if (config && config->version >= 5) {
+    thread_pool_options.max_threads = config->m_MaxThreads;
+    thread_pool_options.post_task = config->m_pPostTask;
+    thread_pool_options.executor_context = config->m_pExecutorContext;
+  }
+  ThreadPool::Create(thread_pool_options);
   CFX_GEModule::Create(config ? config->m_pUserFontPaths : nullptr);
   pdfium::InitializePageModule();
 
@@ -261,6 +286,9 @@ FPDF_InitLibraryWithConfig(const FPDF_LIBRARY_CONFIG* config) {
     if (config->version >= 4) {
       SetRendererType(config->m_RendererType);
     }
+    if (config->version >= 6) {
+      g_bMapFiles = !!config->m_bMapFiles;
+    }
   }
   g_bLibraryInitialized = true;
 }
@@ -270,6 +298,10 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary() {
     return;
   }
 
+  // Threads of the pool may have engines of their own, which must go before
+  // the process-wide one they share fonts with, so the pool goes first.
+  ThreadPool::Destroy();
+
   // Note: we teardown/destroy things in reverse order.
   ResetRendererType();
 
@@ -288,9 +320,27 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary() {
   CFX_Timer::DestroyGlobals();
   FX_DestroyMemoryAllocators();
 
+  g_bMapFiles = false;
   g_bLibraryInitialized = false;
 }
 
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_InitEngineForCurrentThread() {
+  if (!g_bLibraryInitialized || CFX_GEModule::HasModuleForCurrentThread()) {
+    return false;
+  }
+
+  InitEngineForCurrentThread();
+  return true;
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyEngineForCurrentThread() {
+  if (!CFX_GEModule::HasModuleForCurrentThread()) {
+    return;
+  }
+
+  DestroyEngineForCurrentThread();
+}
+
 FPDF_EXPORT void FPDF_CALLCONV FPDF_SetSandBoxPolicy(FPDF_DWORD policy,
                                                      FPDF_BOOL enable) {
   return SetPDFSandboxPolicy(policy, enable);
@@ -312,8 +362,18 @@ FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
 FPDF_LoadDocument(FPDF_STRING file_path, FPDF_BYTESTRING password) {
   // NOTE: the creation of the file needs to be by the embedder on the
   // other side of this API.
-  return LoadDocumentImpl(IFX_SeekableReadStream::CreateFromFilename(file_path),
-                          password);
+  return LoadDocumentImpl(CreateFileStream(file_path), password);
+}
+
+FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
+FPDF_LoadDocumentWithCrossRefCache(FPDF_STRING file_path,
+                                   FPDF_BYTESTRING password,
+                                   const void* cache,
+                                   unsigned long cache_size) {
+  // SAFETY: required from caller.
+  auto cache_span = UNSAFE_BUFFERS(
+      pdfium::span(static_cast<const uint8_t*>(cache), cache_size));
+  return LoadDocumentImpl(CreateFileStream(file_path), password, cache_span);
 }
 
 FPDF_EXPORT int FPDF_CALLCONV FPDF_GetFormType(FPDF_DOCUMENT document) {
@@ -784,6 +844,36 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                 /*pause=*/nullptr);
 }
 
+FPDF_EXPORT void FPDF_CALLCONV
+FPDF_RenderPageBitmapParallel(FPDF_BITMAP bitmap,
+                              FPDF_PAGE page,
+                              int start_x,
+                              int start_y,
+                              int size_x,
+                              int size_y,
+                              int rotate,
+                              int flags,
+                              int band_count) {
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  if (!pPage) {
+    return;
+  }
+
+  RetainPtr<CFX_DIBitmap> pBitmap(CFXDIBitmapFromFPDFBitmap(bitmap));
+  if (!pBitmap) {
+    return;
+  }
+  ValidateBitmapPremultiplyState(pBitmap);
+
+  const FX_RECT rect(start_x, start_y, start_x + size_x, start_y + size_y);
+  if (CPDFSDK_RenderPageInBands(pPage, std::move(pBitmap), rect, rotate, flags,
+                                band_count)) {
+    return;
+  }
+  FPDF_RenderPageBitmap(bitmap, page, start_x, start_y, size_x, size_y, rotate,
+                        flags);
+}
+
 FPDF_EXPORT void FPDF_CALLCONV
 FPDF_RenderPageBitmapWithMatrix(FPDF_BITMAP bitmap,
                                 FPDF_PAGE page,
@@ -877,6 +967,7 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_ClosePage(FPDF_PAGE page) {
   // cleanup the PageView before releasing the reference on |pPage| as it will
   // attempt to reset the PageView during destruction.
   pPage->AsPDFPage()->ClearView();
+  CPDFSDK_ReleasePageCopies(pPage->AsPDFPage());
 }
 
 FPDF_EXPORT void FPDF_CALLCONV FPDF_CloseDocument(FPDF_DOCUMENT document) {
@@ -1527,3 +1618,91 @@ FPDF_GetTrailerEnds(FPDF_DOCUMENT document,
 
   return trailer_ends_len;
 }
+
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDF_GetCrossRefCache(FPDF_DOCUMENT document,
+                      void* buffer,
+                      unsigned long length) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || !doc->GetParser()) {
+    return 0;
+  }
+
+  DataVector<uint8_t> cache = doc->GetParser()->GetCrossRefCache();
+  const unsigned long cache_len = fxcrt::CollectionSize<unsigned long>(cache);
+  if (buffer && length >= cache_len) {
+    // SAFETY: required from caller.
+    fxcrt::Copy(cache, UNSAFE_BUFFERS(pdfium::span(
+                           static_cast<uint8_t*>(buffer), length)));
+  }
+  return cache_len;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_PreloadObjectStreams(FPDF_DOCUMENT document) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || !doc->GetParser()) {
+    return false;
+  }
+
+  doc->GetParser()->PreloadObjectStreams();
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_SetImageCacheLimit(FPDF_DOCUMENT document, size_t limit) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc) {
+    return false;
+  }
+
+  CPDF_DocPageData::FromDocument(doc)->GetImageCache()->SetLimit(limit);
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_GetImageCacheStats(FPDF_DOCUMENT document,
+                        FPDF_IMAGE_CACHE_STATS* stats) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || !stats) {
+    return false;
+  }
+
+  const CPDF_DocImageCache::Stats cache_stats =
+      CPDF_DocPageData::FromDocument(doc)->GetImageCache()->GetStats();
+  stats->limit = cache_stats.limit;
+  stats->size = cache_stats.size;
+  stats->image_count = cache_stats.count;
+  stats->hits = cache_stats.hits;
+  stats->misses = cache_stats.misses;
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_SetJpxTileCacheLimit(FPDF_DOCUMENT document, size_t limit) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc) {
+    return false;
+  }
+
+  CPDF_DocPageData::FromDocument(doc)->GetJpxTileCache()->SetLimit(limit);
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_GetJpxTileCacheStats(FPDF_DOCUMENT document,
+                          FPDF_IMAGE_CACHE_STATS* stats) {
+  auto* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || !stats) {
+    return false;
+  }
+
+  const CPDF_JpxTileCache::Stats cache_stats =
+      CPDF_DocPageData::FromDocument(doc)->GetJpxTileCache()->GetStats();
+  stats->limit = cache_stats.limit;
+  stats->size = cache_stats.size;
+  stats->image_count = cache_stats.count;
+  stats->hits = cache_stats.hits;
+  stats->misses = cache_stats.misses;
+  return true;
+}
@@ -249,8 +249,10 @@ int CheckPDFiumCApi() {
     CHK(FPDFPage_Delete);
     CHK(FPDFPage_GenerateContent);
     CHK(FPDFPage_GetObject);
+    CHK(FPDFPage_GetObjectsInRect);
     CHK(FPDFPage_GetRotation);
     CHK(FPDFPage_HasTransparency);
+    CHK(FPDFPage_HitTestObject);
     CHK(FPDFPage_InsertObject);
     CHK(FPDFPage_InsertObjectAtIndex);
     CHK(FPDFPage_New);
@@ -503,15 +505,19 @@ int CheckPDFiumCApi() {
     CHK(FPDF_CloseDocument);
     CHK(FPDF_ClosePage);
     CHK(FPDF_CountNamedDests);
+    CHK(FPDF_DestroyEngineForCurrentThread);
     CHK(FPDF_DestroyLibrary);
     CHK(FPDF_DeviceToPage);
     CHK(FPDF_DocumentHasValidCrossReferenceTable);
 #ifdef PDF_ENABLE_V8
     CHK(FPDF_GetArrayBufferAllocatorSharedInstance);
 #endif
+    CHK(FPDF_GetCrossRefCache);
     CHK(FPDF_GetDocPermissions);
     CHK(FPDF_GetDocUserPermissions);
     CHK(FPDF_GetFileVersion);
+    CHK(FPDF_GetImageCacheStats);
+    CHK(FPDF_GetJpxTileCacheStats);
     CHK(FPDF_GetLastError);
     CHK(FPDF_GetNamedDest);
     CHK(FPDF_GetNamedDestByName);
@@ -531,22 +537,28 @@ int CheckPDFiumCApi() {
     CHK(FPDF_GetXFAPacketContent);
     CHK(FPDF_GetXFAPacketCount);
     CHK(FPDF_GetXFAPacketName);
+    CHK(FPDF_InitEngineForCurrentThread);
     CHK(FPDF_InitLibrary);
     CHK(FPDF_InitLibraryWithConfig);
     CHK(FPDF_LoadCustomDocument);
     CHK(FPDF_LoadDocument);
+    CHK(FPDF_LoadDocumentWithCrossRefCache);
     CHK(FPDF_LoadMemDocument);
     CHK(FPDF_LoadMemDocument64);
     CHK(FPDF_LoadPage);
     CHK(FPDF_PageToDevice);
+    CHK(FPDF_PreloadObjectStreams);
 #ifdef _WIN32
     CHK(FPDF_RenderPage);
 #endif
     CHK(FPDF_RenderPageBitmap);
+    CHK(FPDF_RenderPageBitmapParallel);
     CHK(FPDF_RenderPageBitmapWithMatrix);
 #if defined(PDF_USE_SKIA)
     CHK(FPDF_RenderPageSkia);
 #endif
+    CHK(FPDF_SetImageCacheLimit);
+    CHK(FPDF_SetJpxTileCacheLimit);
 #if defined(_WIN32)
     CHK(FPDF_SetPrintMode);
 #endif
@@ -3,20 +3,24 @@
 // found in the LICENSE file.
 
 #include <math.h>
+#include <string.h>
 
 #include <algorithm>
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "build/build_config.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
 #include "fpdfsdk/fpdf_view_c_api_test.h"
 #include "public/cpp/fpdf_scopers.h"
+#include "public/fpdf_edit.h"
 #include "public/fpdfview.h"
 #include "testing/embedder_test.h"
 #include "testing/embedder_test_constants.h"
@@ -151,6 +155,15 @@ ScopedFPDFBitmap SkPictureToPdfiumBitmap(sk_sp<SkPicture> picture,
 }
 #endif  // defined(PDF_USE_SKIA)
 
+// An executor for FPDF_LIBRARY_CONFIG that runs tasks right away, and counts
+// them in `executor_context`.
+void RunTaskNow(void* executor_context,
+                void (*task)(void* task_data),
+                void* task_data) {
+  ++*static_cast<int*>(executor_context);
+  task(task_data);
+}
+
 }  // namespace
 
 TEST(fpdf, CApiTest) {
@@ -1442,6 +1455,237 @@ TEST_F(FPDFViewEmbedderTest, DocumentHasInvalidCrossReferenceTable) {
   EXPECT_FALSE(FPDF_DocumentHasValidCrossReferenceTable(document()));
 }
 
+TEST_F(FPDFViewEmbedderTest, LoadDocumentWithCrossRefCache) {
+  EXPECT_EQ(0u, FPDF_GetCrossRefCache(nullptr, nullptr, 0));
+
+  // bug_664284.pdf needs its cross reference table rebuilt.
+  std::string file_path = PathService::GetTestFilePath("bug_664284.pdf");
+  ASSERT_FALSE(file_path.empty());
+  std::vector<uint8_t> cache;
+  {
+    ScopedFPDFDocument doc(FPDF_LoadDocument(file_path.c_str(), ""));
+    ASSERT_TRUE(doc);
+    unsigned long cache_len = FPDF_GetCrossRefCache(doc.get(), nullptr, 0);
+    ASSERT_GT(cache_len, 0u);
+    cache.resize(cache_len);
+    EXPECT_EQ(cache_len,
+              FPDF_GetCrossRefCache(doc.get(), cache.data(), cache.size()));
+  }
+  {
+    ScopedFPDFDocument doc(FPDF_LoadDocumentWithCrossRefCache(
+        file_path.c_str(), "", cache.data(), cache.size()));
+    ASSERT_TRUE(doc);
+    EXPECT_FALSE(FPDF_DocumentHasValidCrossReferenceTable(doc.get()));
+    EXPECT_EQ(1, FPDF_GetPageCount(doc.get()));
+  }
+
+  // A cache for a different file is ignored.
+  std::string other_file_path = PathService::GetTestFilePath("hello_world.pdf");
+  ASSERT_FALSE(other_file_path.empty());
+  {
+    ScopedFPDFDocument doc(FPDF_LoadDocumentWithCrossRefCache(
+        other_file_path.c_str(), "", cache.data(), cache.size()));
+    ASSERT_TRUE(doc);
+    EXPECT_TRUE(FPDF_DocumentHasValidCrossReferenceTable(doc.get()));
+    EXPECT_EQ(1, FPDF_GetPageCount(doc.get()));
+  }
+}
+
+TEST_F(FPDFViewEmbedderTest, PreloadObjectStreams) {
+  EXPECT_FALSE(FPDF_PreloadObjectStreams(nullptr));
+
+  // annotation_stamp_with_ap.pdf keeps its objects in FlateDecode object
+  // streams. Preloading them must not change what the page looks like.
+  std::string lazy_checksum;
+  {
+    ASSERT_TRUE(OpenDocument("annotation_stamp_with_ap.pdf"));
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    lazy_checksum = HashBitmap(bitmap.get());
+  }
+  CloseDocument();
+
+  ASSERT_TRUE(OpenDocument("annotation_stamp_with_ap.pdf"));
+  EXPECT_TRUE(FPDF_PreloadObjectStreams(document()));
+  // Already loaded streams are skipped.
+  EXPECT_TRUE(FPDF_PreloadObjectStreams(document()));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+  EXPECT_EQ(lazy_checksum, HashBitmap(bitmap.get()));
+}
+
+TEST_F(FPDFViewEmbedderTest, ImageCache) {
+  FPDF_IMAGE_CACHE_STATS stats;
+  EXPECT_FALSE(FPDF_GetImageCacheStats(nullptr, &stats));
+  EXPECT_FALSE(FPDF_SetImageCacheLimit(nullptr, 0));
+
+  ASSERT_TRUE(OpenDocument("rotated_image.pdf"));
+  EXPECT_FALSE(FPDF_GetImageCacheStats(document(), nullptr));
+  ASSERT_TRUE(FPDF_GetImageCacheStats(document(), &stats));
+  EXPECT_EQ(32u * 1024 * 1024, stats.limit);
+  EXPECT_EQ(0u, stats.image_count);
+
+  std::string checksum;
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    checksum = HashBitmap(bitmap.get());
+  }
+  ASSERT_TRUE(FPDF_GetImageCacheStats(document(), &stats));
+  EXPECT_EQ(1u, stats.image_count);
+  EXPECT_GT(stats.size, 0u);
+  EXPECT_EQ(0u, stats.hits);
+  EXPECT_GT(stats.misses, 0u);
+  const unsigned long long misses = stats.misses;
+
+  // The image outlives the page, and the page looks the same with it.
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    EXPECT_EQ(checksum, HashBitmap(bitmap.get()));
+  }
+  ASSERT_TRUE(FPDF_GetImageCacheStats(document(), &stats));
+  EXPECT_GT(stats.hits, 0u);
+  EXPECT_EQ(misses, stats.misses);
+
+  EXPECT_TRUE(FPDF_SetImageCacheLimit(document(), 0));
+  ASSERT_TRUE(FPDF_GetImageCacheStats(document(), &stats));
+  EXPECT_EQ(0u, stats.limit);
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_EQ(0u, stats.image_count);
+}
+
+TEST_F(FPDFViewEmbedderTest, JpxTileCache) {
+  FPDF_IMAGE_CACHE_STATS stats;
+  EXPECT_FALSE(FPDF_GetJpxTileCacheStats(nullptr, &stats));
+  EXPECT_FALSE(FPDF_SetJpxTileCacheLimit(nullptr, 0));
+
+  ASSERT_TRUE(OpenDocument("rotated_image.pdf"));
+  EXPECT_FALSE(FPDF_GetJpxTileCacheStats(document(), nullptr));
+  ASSERT_TRUE(FPDF_GetJpxTileCacheStats(document(), &stats));
+  EXPECT_EQ(64u * 1024 * 1024, stats.limit);
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_EQ(0u, stats.image_count);
+
+  // Separate from the cache of whole images.
+  EXPECT_TRUE(FPDF_SetJpxTileCacheLimit(document(), 1024));
+  ASSERT_TRUE(FPDF_GetJpxTileCacheStats(document(), &stats));
+  EXPECT_EQ(1024u, stats.limit);
+  ASSERT_TRUE(FPDF_GetImageCacheStats(document(), &stats));
+  EXPECT_EQ(32u * 1024 * 1024, stats.limit);
+}
+
+TEST_F(FPDFViewEmbedderTest, ZoomedInJpegMatchesFullDecode) {
+  ASSERT_TRUE(OpenDocument("embedded_images.pdf"));
+  // Keep the first render from handing its image to the second one.
+  ASSERT_TRUE(FPDF_SetImageCacheLimit(document(), 0));
+
+  // Find the first JPEG, and where it is on the page.
+  FS_RECTF bounds = {};
+  unsigned int image_width = 0;
+  float page_height = 0;
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    page_height = FPDF_GetPageHeightF(page.get());
+    for (int i = 0; i < FPDFPage_CountObjects(page.get()); ++i) {
+      FPDF_PAGEOBJECT obj = FPDFPage_GetObject(page.get(), i);
+      if (FPDFPageObj_GetType(obj) != FPDF_PAGEOBJ_IMAGE ||
+          FPDFImageObj_GetImageFilterCount(obj) != 1) {
+        continue;
+      }
+      char filter[16];
+      if (FPDFImageObj_GetImageFilter(obj, 0, filter, sizeof(filter)) !=
+              sizeof("DCTDecode") ||
+          strcmp(filter, "DCTDecode") != 0) {
+        continue;
+      }
+      unsigned int height;
+      ASSERT_TRUE(FPDFImageObj_GetImagePixelSize(obj, &image_width, &height));
+      ASSERT_TRUE(FPDFPageObj_GetBounds(obj, &bounds.left, &bounds.bottom,
+                                        &bounds.right, &bounds.top));
+      break;
+    }
+  }
+  ASSERT_GT(image_width, 0u);
+
+  // Zoom in until the image is drawn at 4 times its size, much larger than
+  // the small bitmap, and render the middle of it into both bitmaps.
+  const float scale = 4 * image_width / (bounds.right - bounds.left);
+  const float center_x = scale * (bounds.left + bounds.right) / 2;
+  const float center_y =
+      scale * (page_height - (bounds.top + bounds.bottom) / 2);
+  auto render = [&](int size, const FS_RECTF& clip) {
+    ScopedPage page = LoadScopedPage(0);
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(size, size, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, size, size, 0xFFFFFFFF);
+    const FS_MATRIX matrix = {scale, 0, 0, scale, size / 2 - center_x,
+                              size / 2 - center_y};
+    FPDF_RenderPageBitmapWithMatrix(bitmap.get(), page.get(), &matrix, &clip,
+                                    0);
+    return bitmap;
+  };
+
+  // The small bitmap is smaller than the image. Its pixels still need to come
+  // from a full size decode, which the large one gets. Both draw through the
+  // same clip, shifted by a whole number of pixels, since resampling near the
+  // clip edges depends on where the clip is.
+  constexpr int kSmallSize = 40;
+  constexpr int kLargeSize = 240;
+  constexpr int kOffset = (kLargeSize - kSmallSize) / 2;
+  ScopedFPDFBitmap small = render(kSmallSize, {0, 0, kSmallSize, kSmallSize});
+  ScopedFPDFBitmap large = render(
+      kLargeSize, {kOffset, kOffset, kOffset + kSmallSize, kOffset + kSmallSize});
+  const uint8_t* small_buffer =
+      static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(small.get()));
+  const uint8_t* large_buffer =
+      static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(large.get()));
+  const int small_stride = FPDFBitmap_GetStride(small.get());
+  const int large_stride = FPDFBitmap_GetStride(large.get());
+  for (int row = 0; row < kSmallSize; ++row) {
+    EXPECT_EQ(0, memcmp(small_buffer + row * small_stride,
+                        large_buffer + (row + kOffset) * large_stride +
+                            kOffset * 4,
+                        kSmallSize * 4))
+        << "row " << row;
+  }
+}
+
+TEST_F(FPDFViewEmbedderTest, LoadDocumentFromMappedFile) {
+  FPDF_DestroyLibrary();
+
+  const FPDF_LIBRARY_CONFIG config = {
+      .version = 6,
+      .m_pUserFontPaths = nullptr,
+      .m_pIsolate = nullptr,
+      .m_v8EmbedderSlot = 0,
+      .m_pPlatform = nullptr,
+      .m_RendererType = FPDF_RENDERERTYPE_AGG,
+      .m_MaxThreads = 0,
+      .m_pPostTask = nullptr,
+      .m_pExecutorContext = nullptr,
+      .m_bMapFiles = true,
+  };
+  FPDF_InitLibraryWithConfig(&config);
+  {
+    std::string file_path = PathService::GetTestFilePath("rectangles.pdf");
+    ASSERT_FALSE(file_path.empty());
+    ScopedFPDFDocument doc(FPDF_LoadDocument(file_path.c_str(), ""));
+    ASSERT_TRUE(doc);
+    ScopedFPDFPage page(FPDF_LoadPage(doc.get(), 0));
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderPage(page.get());
+    CompareBitmap(bitmap.get(), 200, 300, pdfium::RectanglesChecksum());
+  }
+
+  EmbedderTestEnvironment::GetInstance()->TearDown();
+  EmbedderTestEnvironment::GetInstance()->SetUp();
+}
+
 // Related to https://crbug.com/pdfium/1197
 TEST_F(FPDFViewEmbedderTest, LoadDocumentWithEmptyXRefConsistently) {
   ASSERT_TRUE(OpenDocument("empty_xref.pdf"));
@@ -2271,3 +2515,309 @@ TEST_F(FPDFViewEmbedderTest, DocumentVersionInCatalog) {
   EXPECT_TRUE(FPDF_GetFileVersion(document(), &version));
   EXPECT_EQ(16, version);
 }
+
+TEST_F(FPDFViewEmbedderTest, ThreadEngineRequiresInitializedLibrary) {
+  FPDF_DestroyLibrary();
+  EXPECT_FALSE(FPDF_InitEngineForCurrentThread());
+
+  // Puts the test environment back the way it was.
+  EmbedderTestEnvironment::GetInstance()->TearDown();
+  EmbedderTestEnvironment::GetInstance()->SetUp();
+
+  ASSERT_TRUE(FPDF_InitEngineForCurrentThread());
+  FPDF_DestroyEngineForCurrentThread();
+}
+
+TEST_F(FPDFViewEmbedderTest, ThreadEngineInitOncePerThread) {
+  ASSERT_TRUE(FPDF_InitEngineForCurrentThread());
+  EXPECT_FALSE(FPDF_InitEngineForCurrentThread());
+  FPDF_DestroyEngineForCurrentThread();
+
+  // Destroying a non-existent engine is a no-op.
+  FPDF_DestroyEngineForCurrentThread();
+}
+
+TEST_F(FPDFViewEmbedderTest, RenderConcurrentlyWithThreadEngines) {
+  // Includes text, which thread engines must render with the test font
+  // mapper installed on the process-wide engine.
+  static constexpr const char* kFileNames[] = {
+      "rectangles.pdf",
+      "many_rectangles.pdf",
+      "bug_890322.pdf",
+      "annotation_stamp_with_ap.pdf",
+      "hello_world.pdf",
+      "text_render_mode.pdf",
+  };
+  static constexpr int kRendersPerThread = 3;
+
+  auto render_first_page = [](const char* file_name) -> std::string {
+    std::string file_path = PathService::GetTestFilePath(file_name);
+    ScopedFPDFDocument doc(FPDF_LoadDocument(file_path.c_str(), nullptr));
+    if (!doc) {
+      return std::string();
+    }
+    ScopedFPDFPage page(FPDF_LoadPage(doc.get(), 0));
+    if (!page) {
+      return std::string();
+    }
+    ScopedFPDFBitmap bitmap = RenderPage(page.get());
+    return HashBitmap(bitmap.get());
+  };
+
+  // Serial reference renderings, made with the process-wide state.
+  std::vector<std::string> expected_checksums;
+  for (const char* file_name : kFileNames) {
+    expected_checksums.push_back(render_first_page(file_name));
+    ASSERT_FALSE(expected_checksums.back().empty());
+  }
+
+  // Each thread gets its own engine and renders a different document at the
+  // same time as the others.
+  std::vector<std::vector<std::string>> actual_checksums(
+      std::size(kFileNames));
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < std::size(kFileNames); ++i) {
+    threads.emplace_back([&render_first_page, &actual_checksums, i] {
+      if (!FPDF_InitEngineForCurrentThread()) {
+        return;
+      }
+      for (int j = 0; j < kRendersPerThread; ++j) {
+        actual_checksums[i].push_back(render_first_page(kFileNames[i]));
+      }
+      FPDF_DestroyEngineForCurrentThread();
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < std::size(kFileNames); ++i) {
+    ASSERT_EQ(static_cast<size_t>(kRendersPerThread),
+              actual_checksums[i].size());
+    for (const std::string& checksum : actual_checksums[i]) {
+      EXPECT_EQ(expected_checksums[i], checksum) << kFileNames[i];
+    }
+  }
+}
+
+// Renders on a pool of four threads, however many cores there are, instead of
+// the environment's serial one.
+class FPDFViewParallelEmbedderTest : public FPDFViewEmbedderTest {
+ protected:
+  void SetUp() override {
+    FPDFViewEmbedderTest::SetUp();
+    UseThreadPool({.max_threads = 4});
+  }
+
+  void TearDown() override {
+    FPDFViewEmbedderTest::TearDown();
+    UseThreadPool({});
+  }
+
+  static void UseThreadPool(const fxcrt::ThreadPool::Options& options) {
+    fxcrt::ThreadPool::Destroy();
+    fxcrt::ThreadPool::Create(options);
+  }
+};
+
+TEST_F(FPDFViewParallelEmbedderTest, RenderPageBitmapParallelMatchesSerial) {
+  ASSERT_TRUE(OpenDocument("many_rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  const int width = static_cast<int>(FPDF_GetPageWidth(page.get()));
+  const int height = static_cast<int>(FPDF_GetPageHeight(page.get()));
+  for (int band_count : {1, 2, 3, 7, height + 1}) {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+    ASSERT_TRUE(
+        FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF));
+    FPDF_RenderPageBitmapParallel(bitmap.get(), page.get(), 0, 0, width,
+                                  height, 0, 0, band_count);
+    CompareBitmap(bitmap.get(), width, height, ManyRectanglesChecksum());
+  }
+}
+
+TEST_F(FPDFViewParallelEmbedderTest, RenderPageBitmapParallelAfterClosePage) {
+  // Closing a page has the pool threads let go of their copies of it, so
+  // rendering it again parses new ones.
+  ASSERT_TRUE(OpenDocument("many_rectangles.pdf"));
+  for (int i = 0; i < 3; ++i) {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+
+    const int width = static_cast<int>(FPDF_GetPageWidth(page.get()));
+    const int height = static_cast<int>(FPDF_GetPageHeight(page.get()));
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+    ASSERT_TRUE(
+        FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF));
+    FPDF_RenderPageBitmapParallel(bitmap.get(), page.get(), 0, 0, width,
+                                  height, 0, 0, /*band_count=*/4);
+    CompareBitmap(bitmap.get(), width, height, ManyRectanglesChecksum());
+  }
+}
+
+TEST_F(FPDFViewParallelEmbedderTest,
+       RenderPageBitmapParallelWithImagesAndPatternsMatchesSerial) {
+  // Images that cross a band edge resample from pixels on both sides of it,
+  // and tiling pattern cells can be taller than a band. Scaling moves the band
+  // edges around within the images and cells.
+  for (const char* file_name : {"embedded_images.pdf", "rotated_image.pdf",
+                                "tiling_pattern_fills.pdf"}) {
+    ASSERT_TRUE(OpenDocument(file_name));
+    {
+      ScopedPage page = LoadScopedPage(0);
+      ASSERT_TRUE(page);
+
+      for (double scale : {0.8, 1.0, 2.3, 3.7}) {
+        const int width =
+            static_cast<int>(FPDF_GetPageWidth(page.get()) * scale);
+        const int height =
+            static_cast<int>(FPDF_GetPageHeight(page.get()) * scale);
+        ScopedFPDFBitmap expected(FPDFBitmap_Create(width, height, 0));
+        ASSERT_TRUE(FPDFBitmap_FillRect(expected.get(), 0, 0, width, height,
+                                        0xFFFFFFFF));
+        FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, width, height,
+                              0, 0);
+        const std::string expected_checksum = HashBitmap(expected.get());
+
+        for (int band_count : {2, 3, 7, 64}) {
+          ScopedFPDFBitmap actual(FPDFBitmap_Create(width, height, 0));
+          ASSERT_TRUE(FPDFBitmap_FillRect(actual.get(), 0, 0, width, height,
+                                          0xFFFFFFFF));
+          FPDF_RenderPageBitmapParallel(actual.get(), page.get(), 0, 0, width,
+                                        height, 0, 0, band_count);
+          EXPECT_EQ(expected_checksum, HashBitmap(actual.get()))
+              << file_name << " in " << band_count << " bands at scale "
+              << scale;
+        }
+      }
+    }
+    CloseDocument();
+  }
+}
+
+TEST_F(FPDFViewParallelEmbedderTest,
+       RenderPageBitmapParallelWithTextMatchesSerial) {
+  // Band threads must find the same fonts as the calling thread, including
+  // the test font mapper set on the process-wide engine.
+  for (const char* file_name : {"hello_world.pdf", "text_render_mode.pdf"}) {
+    ASSERT_TRUE(OpenDocument(file_name));
+    {
+      ScopedPage page = LoadScopedPage(0);
+      ASSERT_TRUE(page);
+
+      const int width = static_cast<int>(FPDF_GetPageWidth(page.get()));
+      const int height = static_cast<int>(FPDF_GetPageHeight(page.get()));
+      ScopedFPDFBitmap expected(FPDFBitmap_Create(width, height, 0));
+      ASSERT_TRUE(
+          FPDFBitmap_FillRect(expected.get(), 0, 0, width, height, 0xFFFFFFFF));
+      FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, width, height, 0,
+                            0);
+      const std::string expected_checksum = HashBitmap(expected.get());
+
+      for (int band_count : {2, 3, 7}) {
+        ScopedFPDFBitmap actual(FPDFBitmap_Create(width, height, 0));
+        ASSERT_TRUE(
+            FPDFBitmap_FillRect(actual.get(), 0, 0, width, height, 0xFFFFFFFF));
+        FPDF_RenderPageBitmapParallel(actual.get(), page.get(), 0, 0, width,
+                                      height, 0, 0, band_count);
+        EXPECT_EQ(expected_checksum, HashBitmap(actual.get()))
+            << file_name << " in " << band_count << " bands";
+      }
+    }
+    CloseDocument();
+  }
+}
+
+TEST_F(FPDFViewParallelEmbedderTest, RenderPageBitmapParallelWithUnsavedEdits) {
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  // The new object is not in any content stream, so the page is rendered
+  // serially rather than from a copy.
+  FPDF_PAGEOBJECT rect = FPDFPageObj_CreateNewRect(10, 10, 20, 20);
+  ASSERT_TRUE(FPDFPageObj_SetFillColor(rect, 0, 0, 255, 255));
+  ASSERT_TRUE(FPDFPath_SetDrawMode(rect, FPDF_FILLMODE_ALTERNATE, 0));
+  FPDFPage_InsertObject(page.get(), rect);
+
+  const int width = static_cast<int>(FPDF_GetPageWidth(page.get()));
+  const int height = static_cast<int>(FPDF_GetPageHeight(page.get()));
+  ScopedFPDFBitmap expected(FPDFBitmap_Create(width, height, 0));
+  ASSERT_TRUE(
+      FPDFBitmap_FillRect(expected.get(), 0, 0, width, height, 0xFFFFFFFF));
+  FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, width, height, 0, 0);
+
+  ScopedFPDFBitmap actual(FPDFBitmap_Create(width, height, 0));
+  ASSERT_TRUE(
+      FPDFBitmap_FillRect(actual.get(), 0, 0, width, height, 0xFFFFFFFF));
+  FPDF_RenderPageBitmapParallel(actual.get(), page.get(), 0, 0, width, height,
+                                0, 0, 4);
+  EXPECT_EQ(HashBitmap(expected.get()), HashBitmap(actual.get()));
+}
+
+TEST_F(FPDFViewParallelEmbedderTest, RenderPageBitmapParallelAfterEdits) {
+  ASSERT_TRUE(OpenDocument("rectangles.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  // Leaves threads of the pool with copies of the page as it was.
+  const int width = static_cast<int>(FPDF_GetPageWidth(page.get()));
+  const int height = static_cast<int>(FPDF_GetPageHeight(page.get()));
+  {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+    ASSERT_TRUE(
+        FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF));
+    FPDF_RenderPageBitmapParallel(bitmap.get(), page.get(), 0, 0, width,
+                                  height, 0, 0, 16);
+    CompareBitmap(bitmap.get(), width, height, pdfium::RectanglesChecksum());
+  }
+
+  // Once saved to the content stream, the edit shows in copies made after it.
+  FPDF_PAGEOBJECT rect = FPDFPageObj_CreateNewRect(10, 10, 20, 20);
+  ASSERT_TRUE(FPDFPageObj_SetFillColor(rect, 0, 0, 255, 255));
+  ASSERT_TRUE(FPDFPath_SetDrawMode(rect, FPDF_FILLMODE_ALTERNATE, 0));
+  FPDFPage_InsertObject(page.get(), rect);
+  ASSERT_TRUE(FPDFPage_GenerateContent(page.get()));
+
+  ScopedFPDFBitmap expected(FPDFBitmap_Create(width, height, 0));
+  ASSERT_TRUE(
+      FPDFBitmap_FillRect(expected.get(), 0, 0, width, height, 0xFFFFFFFF));
+  FPDF_RenderPageBitmap(expected.get(), page.get(), 0, 0, width, height, 0, 0);
+  const std::string expected_checksum = HashBitmap(expected.get());
+  EXPECT_NE(pdfium::RectanglesChecksum(), expected_checksum);
+
+  ScopedFPDFBitmap actual(FPDFBitmap_Create(width, height, 0));
+  ASSERT_TRUE(
+      FPDFBitmap_FillRect(actual.get(), 0, 0, width, height, 0xFFFFFFFF));
+  FPDF_RenderPageBitmapParallel(actual.get(), page.get(), 0, 0, width, height,
+                                0, 0, 16);
+  EXPECT_EQ(expected_checksum, HashBitmap(actual.get()));
+}
+
+TEST_F(FPDFViewParallelEmbedderTest, RenderPageBitmapParallelWithExecutor) {
+  int task_count = 0;
+  UseThreadPool({
+      .max_threads = 4,
+      .post_task = RunTaskNow,
+      .executor_context = &task_count,
+  });
+  ASSERT_TRUE(OpenDocument("many_rectangles.pdf"));
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+
+    const int width = static_cast<int>(FPDF_GetPageWidth(page.get()));
+    const int height = static_cast<int>(FPDF_GetPageHeight(page.get()));
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(width, height, 0));
+    ASSERT_TRUE(
+        FPDFBitmap_FillRect(bitmap.get(), 0, 0, width, height, 0xFFFFFFFF));
+    FPDF_RenderPageBitmapParallel(bitmap.get(), page.get(), 0, 0, width,
+                                  height, 0, 0, 3);
+    CompareBitmap(bitmap.get(), width, height, ManyRectanglesChecksum());
+  }
+  CloseDocument();
+
+  // Three bands on up to four threads take two tasks besides the caller.
+  EXPECT_EQ(2, task_count);
+}
@@ -9,28 +9,19 @@ PdfHitImageResult PdfHitImageAt(FPDF_PAGE page, double pageX, double pageY, doub
     float px = (float)pageX;
     float py = (float)(pageHeight - pageY);
     
-    const int count = FPDFPage_CountObjects(page);
+    // Topmost image whose bounds, grown by the tolerance, contain the point.
+    // The page keeps a spatial index, so this does not visit every object.
+    FPDF_PAGEOBJECT obj = FPDFPage_HitTestObject(page, px, py, tolerancePx, FPDF_PAGEOBJ_IMAGE);
+    if (!obj) return result;
     
-    for (int i = count - 1; i >= 0; --i) {
-        FPDF_PAGEOBJECT obj = FPDFPage_GetObject(page, i);
-        if (!obj) continue;
-        
-        int objType = FPDFPageObj_GetType(obj);
-        if (objType != FPDF_PAGEOBJ_IMAGE) continue;
-        
-        FS_QUADPOINTSF qp{}; 
-        if (!FPDFPageObj_GetRotatedBounds(obj, &qp)) continue;
-        
-        float minx = std::min(std::min(qp.x1, qp.x2), std::min(qp.x3, qp.x4)) - tolerancePx;
-        float maxx = std::max(std::max(qp.x1, qp.x2), std::max(qp.x3, qp.x4)) + tolerancePx;
-        float miny = std::min(std::min(qp.y1, qp.y2), std::min(qp.y3, qp.y4)) - tolerancePx;
-        float maxy = std::max(std::max(qp.y1, qp.y2), std::max(qp.y3, qp.y4)) + tolerancePx;
-        
-        if (px >= minx && px <= maxx && py >= miny && py <= maxy) {
-            result.imageObj = obj; result.minx = minx; result.miny = miny; result.maxx = maxx; result.maxy = maxy;
-            return result;
-        }
-    }
+    FS_QUADPOINTSF qp{}; 
+    if (!FPDFPageObj_GetRotatedBounds(obj, &qp)) return result;
+    
+    result.imageObj = obj;
+    result.minx = std::min(std::min(qp.x1, qp.x2), std::min(qp.x3, qp.x4)) - tolerancePx;
+    result.maxx = std::max(std::max(qp.x1, qp.x2), std::max(qp.x3, qp.x4)) + tolerancePx;
+    result.miny = std::min(std::min(qp.y1, qp.y2), std::min(qp.y3, qp.y4)) - tolerancePx;
+    result.maxy = std::max(std::max(qp.y1, qp.y2), std::max(qp.y3, qp.y4)) + tolerancePx;
     return result;
 }
 
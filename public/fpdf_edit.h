@@ -236,6 +236,42 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFPage_CountObjects(FPDF_PAGE page);
 FPDF_EXPORT FPDF_PAGEOBJECT FPDF_CALLCONV FPDFPage_GetObject(FPDF_PAGE page,
                                                              int index);
 
+// Experimental API.
+// Get the page objects in |page| whose bounding boxes intersect a rectangle.
+//
+//   page        - handle to a page.
+//   rect        - the rectangle, in page coordinates.
+//   objects     - buffer for the handles of the intersecting objects, in the
+//                 order they are painted. May be NULL if |max_objects| is 0.
+//   max_objects - the number of handles |objects| can hold.
+//
+// Returns the number of intersecting objects, or -1 on failure. If this is
+// more than |max_objects|, only the first |max_objects| handles are written.
+// Inactive objects are not included.
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFPage_GetObjectsInRect(FPDF_PAGE page,
+                          const FS_RECTF* rect,
+                          FPDF_PAGEOBJECT* objects,
+                          unsigned long max_objects);
+
+// Experimental API.
+// Get the topmost page object in |page| whose bounding box contains a point.
+//
+//   page      - handle to a page.
+//   x         - the x coordinate of the point, in page coordinates.
+//   y         - the y coordinate of the point, in page coordinates.
+//   tolerance - distance by which bounding boxes are grown before testing.
+//   type      - one of the FPDF_PAGEOBJ_* values to only consider objects of
+//               that type, or FPDF_PAGEOBJ_UNKNOWN to consider all objects.
+//
+// Returns the handle to the page object, or NULL if none is found.
+FPDF_EXPORT FPDF_PAGEOBJECT FPDF_CALLCONV
+FPDFPage_HitTestObject(FPDF_PAGE page,
+                       float x,
+                       float y,
+                       float tolerance,
+                       int type);
+
 // Checks if |page| contains transparency.
 //
 //   page - handle to a page.
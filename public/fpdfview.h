@@ -280,6 +280,37 @@ typedef struct FPDF_LIBRARY_CONFIG_ {
   // corresponding render library is not included in the build will similarly
   // fail with an immediate crash.
   FPDF_RENDERER_TYPE m_RendererType;
+
+  // Version 5 - Experimental.
+
+  // The most threads that parallel work, such as
+  // FPDF_RenderPageBitmapParallel() and FPDF_PreloadObjectStreams(), uses for
+  // one call, counting the calling thread. All such work shares one pool of
+  // threads. 0 means one per CPU core, and 1 keeps all work on the calling
+  // thread. Configs older than version 5 get 1, so PDFium only starts threads
+  // for embedders that ask for them. Without an executor, JPEG 2000 images of
+  // a megapixel or more also decode on up to this many threads, and smaller
+  // ones on one. That cut-off has not been tuned on multi-core machines.
+  unsigned int m_MaxThreads;
+
+  // Optional executor for parallel work. When set, PDFium starts no threads of
+  // its own, and instead calls |m_pPostTask| with |m_pExecutorContext|, a
+  // task, and the task's data. The embedder must eventually call
+  // |task|(|task_data|) exactly once, on any thread. The calling thread also
+  // does the work, so tasks that run late only cost parallelism.
+  void (*m_pPostTask)(void* executor_context,
+                      void (*task)(void* task_data),
+                      void* task_data);
+  void* m_pExecutorContext;
+
+  // Version 6 - Experimental.
+
+  // Whether FPDF_LoadDocument() and FPDF_LoadDocumentWithCrossRefCache()
+  // memory-map files where the platform supports it, instead of reading them
+  // into buffers. Only enable this if no file gets truncated while a document
+  // loaded from it is open, since reading past the new end of a mapped file
+  // crashes the process.
+  FPDF_BOOL m_bMapFiles;
 } FPDF_LIBRARY_CONFIG;
 
 // Function: FPDF_InitLibraryWithConfig
@@ -323,6 +354,50 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_InitLibrary();
 //          closing the library with this function.
 FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary();
 
+// Experimental API.
+// Function: FPDF_InitEngineForCurrentThread
+//          Give the calling thread its own isolated engine.
+// Parameters:
+//          None.
+// Return value:
+//          TRUE on success. FALSE if the library is not initialized, or if the
+//          calling thread already has an engine.
+// Comments:
+//          An engine holds a private copy of PDFium's mutable global state:
+//          the font manager, glyph caches, standard font and cmap caches, and
+//          stock colorspaces. Read-only data such as the built-in fonts and
+//          embedded cmap tables stay shared. Threads that each have an engine
+//          can load and render unrelated documents concurrently without any
+//          external locking.
+//
+//          The engine uses the same system font info as the rest of the
+//          library, including one set with FPDF_SetSystemFontInfo(). Calls
+//          into that font info are serialized across engines.
+//          FPDF_SetSystemFontInfo() must not be called while any engine
+//          exists.
+//
+//          Documents loaded on a thread with an engine must only be used, and
+//          closed, on that thread, and before the engine is destroyed.
+//          JavaScript and XFA forms are not supported on such threads.
+//
+//          FPDF_InitLibraryWithConfig() must have been called beforehand, and
+//          FPDF_DestroyLibrary() must not be called until every engine has
+//          been destroyed.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_InitEngineForCurrentThread();
+
+// Experimental API.
+// Function: FPDF_DestroyEngineForCurrentThread
+//          Release the engine created by FPDF_InitEngineForCurrentThread() on
+//          the calling thread.
+// Parameters:
+//          None.
+// Return value:
+//          None.
+// Comments:
+//          All documents loaded on this thread must be closed beforehand.
+//          Does nothing if the calling thread has no engine.
+FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyEngineForCurrentThread();
+
 // Policy for accessing the local machine time.
 #define FPDF_POLICY_MACHINETIME_ACCESS 0
 
@@ -390,6 +465,39 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDF_SetPrintMode(int mode);
 FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
 FPDF_LoadDocument(FPDF_STRING file_path, FPDF_BYTESTRING password);
 
+// Experimental API.
+// Function: FPDF_LoadDocumentWithCrossRefCache
+//          Open and load a PDF document, reusing the cross reference table
+//          data that FPDF_GetCrossRefCache() returned for the same file.
+// Parameters:
+//          file_path   -   Path to the PDF file (including extension).
+//          password    -   A string used as the password for the PDF file.
+//                          If no password is needed, empty or NULL can be used.
+//          cache       -   Pointer to a buffer containing the cache data.
+//                          May be NULL if |cache_size| is 0.
+//          cache_size  -   Number of bytes in |cache|.
+// Return value:
+//          A handle to the loaded document, or NULL on failure.
+// Comments:
+//          Same as FPDF_LoadDocument(), except that parsing skips the cross
+//          reference tables, and the search through the whole file for
+//          objects that damaged files need, when |cache| matches the file.
+//          The cache records the file's size, and a SHA-256 digest of the
+//          file's start, end and last cross reference section. A cache for a
+//          file where these differ, or an invalid one, is ignored. Checking
+//          the digest reads no more than 72 KiB of the file. The first time
+//          an object is loaded, PDFium checks that its header is where the
+//          cache says. If not, it drops the cache and parses the file's own
+//          cross reference tables. This catches most in-place edits elsewhere
+//          that keep the file size. Edits that keep every object where it was
+//          are not noticed, so embedders that rewrite files in place should
+//          still drop the cache.
+FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
+FPDF_LoadDocumentWithCrossRefCache(FPDF_STRING file_path,
+                                   FPDF_BYTESTRING password,
+                                   const void* cache,
+                                   unsigned long cache_size);
+
 // Function: FPDF_LoadMemDocument
 //          Open and load a PDF document from memory.
 // Parameters:
@@ -638,6 +746,119 @@ FPDF_GetTrailerEnds(FPDF_DOCUMENT document,
                     unsigned int* buffer,
                     unsigned long length);
 
+// Experimental API.
+// Function: FPDF_GetCrossRefCache
+//          Get data that lets FPDF_LoadDocumentWithCrossRefCache() open the
+//          same file again without parsing its cross reference tables.
+// Parameters:
+//          document    -   Handle to document. Returned by FPDF_LoadDocument().
+//          buffer      -   A buffer for the cache data. May be NULL.
+//          length      -   The length of |buffer|, in bytes. May be 0.
+// Return value:
+//          Returns the number of bytes in the cache data, or 0 on error or if
+//          |document| was loaded with FPDFAvail_GetDocument() and its cross
+//          reference tables are only partially loaded.
+//
+// Embedders typically store the cache data next to the file. If |length| is
+// less than the returned length, or |buffer| is NULL, |buffer| will not be
+// modified. This reads parts of the file to compute a digest of them, see
+// FPDF_LoadDocumentWithCrossRefCache().
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FPDF_GetCrossRefCache(FPDF_DOCUMENT document,
+                      void* buffer,
+                      unsigned long length);
+
+// Experimental API.
+// Function: FPDF_PreloadObjectStreams
+//          Decode all object streams of a document up front, spreading the
+//          work over several threads.
+// Parameters:
+//          document    -   Handle to document. Returned by FPDF_LoadDocument().
+// Return value:
+//          Returns TRUE on success, FALSE if |document| is invalid.
+//
+// Object streams hold most objects of many files, and are otherwise decoded
+// one by one as their objects are first used. Call this right after loading
+// |document| so later page loads and text extraction do not stall on
+// decoding them. Only streams compressed with FlateDecode are preloaded.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_PreloadObjectStreams(FPDF_DOCUMENT document);
+
+// Experimental API.
+// Statistics of the cache of decoded images of a document.
+typedef struct FPDF_IMAGE_CACHE_STATS_ {
+  // The most bytes of decoded images the cache holds.
+  size_t limit;
+  // The bytes of decoded images the cache holds.
+  size_t size;
+  // The number of decoded images the cache holds.
+  size_t image_count;
+  // How often an image was found in the cache, and how often it was not.
+  unsigned long long hits;
+  unsigned long long misses;
+} FPDF_IMAGE_CACHE_STATS;
+
+// Experimental API.
+// Function: FPDF_SetImageCacheLimit
+//          Set how many bytes of decoded images a document keeps for reuse.
+// Parameters:
+//          document    -   Handle to document. Returned by FPDF_LoadDocument().
+//          limit       -   The most bytes of decoded images to keep. 0 turns
+//                          the cache off.
+// Return value:
+//          Returns TRUE on success, FALSE if |document| is invalid.
+//
+// A document keeps images it decoded for one page, so that other pages that
+// show the same images, or the same page loaded again, do not decode them
+// again. When the cache is full, the images used least recently are dropped.
+// The limit defaults to 32 MiB.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_SetImageCacheLimit(FPDF_DOCUMENT document, size_t limit);
+
+// Experimental API.
+// Function: FPDF_GetImageCacheStats
+//          Get statistics of the cache of decoded images of a document.
+// Parameters:
+//          document    -   Handle to document. Returned by FPDF_LoadDocument().
+//          stats       -   Receives the statistics.
+// Return value:
+//          Returns TRUE on success, FALSE if |document| or |stats| is invalid.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_GetImageCacheStats(FPDF_DOCUMENT document, FPDF_IMAGE_CACHE_STATS* stats);
+
+// Experimental API.
+// Function: FPDF_SetJpxTileCacheLimit
+//          Set how many bytes of decoded JPEG 2000 tiles a document keeps for
+//          reuse.
+// Parameters:
+//          document    -   Handle to document. Returned by FPDF_LoadDocument().
+//          limit       -   The most bytes of decoded tiles to keep. 0 turns
+//                          the cache off.
+// Return value:
+//          Returns TRUE on success, FALSE if |document| is invalid.
+//
+// Large tiled JPEG 2000 images only get decoded where they are visible. A
+// document keeps the tiles it decoded, so that showing another part of such
+// an image only decodes the tiles it did not have yet. When the cache is
+// full, the tiles used least recently are dropped. The limit defaults to
+// 64 MiB.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_SetJpxTileCacheLimit(FPDF_DOCUMENT document, size_t limit);
+
+// Experimental API.
+// Function: FPDF_GetJpxTileCacheStats
+//          Get statistics of the cache of decoded JPEG 2000 tiles of a
+//          document.
+// Parameters:
+//          document    -   Handle to document. Returned by FPDF_LoadDocument().
+//          stats       -   Receives the statistics. |image_count| is the
+//                          number of decoded tiles.
+// Return value:
+//          Returns TRUE on success, FALSE if |document| or |stats| is invalid.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDF_GetJpxTileCacheStats(FPDF_DOCUMENT document,
+                          FPDF_IMAGE_CACHE_STATS* stats);
+
 // Function: FPDF_GetDocPermissions
 //          Get file permission flags of the document.
 // Parameters:
@@ -905,6 +1126,54 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_RenderPageBitmap(FPDF_BITMAP bitmap,
                                                      int rotate,
                                                      int flags);
 
+// Experimental API.
+// Function: FPDF_RenderPageBitmapParallel
+//          Render contents of a page to a device independent bitmap, using
+//          several threads.
+// Parameters:
+//          bitmap      -   Handle to the device independent bitmap, as for
+//                          FPDF_RenderPageBitmap().
+//          page        -   Handle to the page, as for FPDF_RenderPageBitmap().
+//          start_x     -   Left pixel position of the display area in
+//                          bitmap coordinates.
+//          start_y     -   Top pixel position of the display area in bitmap
+//                          coordinates.
+//          size_x      -   Horizontal size (in pixels) for displaying the page.
+//          size_y      -   Vertical size (in pixels) for displaying the page.
+//          rotate      -   Page orientation, as for FPDF_RenderPageBitmap().
+//          flags       -   Page rendering flags, as for
+//                          FPDF_RenderPageBitmap().
+//          band_count  -   Number of horizontal bands to split the display
+//                          area into. Bands are rendered concurrently, on up to
+//                          |m_MaxThreads| threads of FPDF_LIBRARY_CONFIG.
+// Return value:
+//          None.
+// Comments:
+//          The output is identical to that of FPDF_RenderPageBitmap() with the
+//          same arguments. The calling thread renders bands from |page|. The
+//          rest of the bands render from a private copy of the page, which each
+//          call serializes once. Threads that PDFium started keep their parsed
+//          copy until the next call, and parse the page again only if it
+//          serializes differently; they let go of it soon after
+//          FPDF_ClosePage() closes |page|, or when the library is destroyed,
+//          so each such thread holds at most one copy. Tasks run by
+//          |m_pPostTask| parse a copy for each call.
+//          Falls back to rendering on the calling thread when |band_count| is
+//          less than 2, when the library has no other threads to use, when the
+//          page has edits that have not been committed with
+//          FPDFPage_GenerateContent(), when the document uses optional content
+//          or XFA, and when the Skia renderer is in use.
+FPDF_EXPORT void FPDF_CALLCONV
+FPDF_RenderPageBitmapParallel(FPDF_BITMAP bitmap,
+                              FPDF_PAGE page,
+                              int start_x,
+                              int start_y,
+                              int size_x,
+                              int size_y,
+                              int rotate,
+                              int flags,
+                              int band_count);
+
 // Function: FPDF_RenderPageBitmapWithMatrix
 //          Render contents of a page to a device independent bitmap.
 // Parameters:
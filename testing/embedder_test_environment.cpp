@@ -39,7 +39,7 @@ EmbedderTestEnvironment* EmbedderTestEnvironment::GetInstance() {
 
 void EmbedderTestEnvironment::SetUp() {
   FPDF_LIBRARY_CONFIG config = {
-      .version = 4,
+      .version = 5,
       .m_pUserFontPaths = test_fonts_.font_paths(),
 
 #ifdef PDF_ENABLE_V8
@@ -53,6 +53,9 @@ void EmbedderTestEnvironment::SetUp() {
 #endif  // PDF_ENABLE_V8
 
       .m_RendererType = renderer_type_,
+      .m_MaxThreads = max_threads_,
+      .m_pPostTask = nullptr,
+      .m_pExecutorContext = nullptr,
   };
 
   FPDF_InitLibraryWithConfig(&config);
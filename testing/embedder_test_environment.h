@@ -33,6 +33,8 @@ class EmbedderTestEnvironment : public testing::Environment {
 
   FPDF_RENDERER_TYPE renderer_type_;
   bool write_pngs_ = false;
+  // Tests run serially unless they swap in a pool of their own.
+  unsigned int max_threads_ = 1;
   TestFonts test_fonts_;
 };
 
@@ -41,7 +41,8 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
 
   std::unique_ptr<CJPX_Decoder> decoder =
       CJPX_Decoder::Create(span.subspan(3u), color_space_option,
-                           resolution_levels_to_skip, strict_mode);
+                           resolution_levels_to_skip, strict_mode,
+                           /*max_threads=*/1);
   if (!decoder) {
     return 0;
   }
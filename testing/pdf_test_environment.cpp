@@ -4,6 +4,7 @@
 
 #include "testing/pdf_test_environment.h"
 
+#include "core/fxcrt/thread_pool.h"
 #include "core/fxge/cfx_gemodule.h"
 
 PDFTestEnvironment::PDFTestEnvironment() = default;
@@ -12,9 +13,11 @@ PDFTestEnvironment::~PDFTestEnvironment() = default;
 
 // testing::Environment:
 void PDFTestEnvironment::SetUp() {
+  ThreadPool::Create(ThreadPool::Options());
   CFX_GEModule::Create(test_fonts_.font_paths());
 }
 
 void PDFTestEnvironment::TearDown() {
   CFX_GEModule::Destroy();
+  ThreadPool::Destroy();
 }
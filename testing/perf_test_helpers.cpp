@@ -0,0 +1,38 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "testing/perf_test_helpers.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/fxcrt/check_op.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+std::chrono::microseconds MedianRunTime(int runs,
+                                        const std::function<void()>& fn) {
+  CHECK_GT(runs, 0);
+  std::vector<std::chrono::microseconds> times;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start));
+  }
+  auto median = times.begin() + times.size() / 2;
+  std::nth_element(times.begin(), median, times.end());
+  return *median;
+}
+
+void PrintPerfResult(const char* name,
+                     const char* trace,
+                     std::chrono::microseconds time) {
+  printf("*RESULT %s: %s= %lld us\n", name, trace,
+         static_cast<long long>(time.count()));
+  testing::Test::RecordProperty(std::string(name) + "." + trace,
+                                std::to_string(time.count()));
+}
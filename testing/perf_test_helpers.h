@@ -0,0 +1,21 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TESTING_PERF_TEST_HELPERS_H_
+#define TESTING_PERF_TEST_HELPERS_H_
+
+#include <chrono>
+#include <functional>
+
+// Runs `fn` `runs` times, and returns the median wall time of a run.
+std::chrono::microseconds MedianRunTime(int runs,
+                                        const std::function<void()>& fn);
+
+// Prints `time` in the "*RESULT" format that Chromium's perf dashboards parse,
+// and records it as a property of the current test.
+void PrintPerfResult(const char* name,
+                     const char* trace,
+                     std::chrono::microseconds time);
+
+#endif  // TESTING_PERF_TEST_HELPERS_H_
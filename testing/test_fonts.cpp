@@ -11,6 +11,7 @@
 #include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/cfx_fontmgr.h"
 #include "core/fxge/cfx_gemodule.h"
+#include "core/fxge/cfx_sharedfontinfo.h"
 #include "core/fxge/systemfontinfo_iface.h"
 #include "testing/utils/path_service.h"
 
@@ -107,8 +108,10 @@ TestFonts::~TestFonts() = default;
 
 void TestFonts::InstallFontMapper() {
   auto* font_mapper = CFX_GEModule::Get()->GetFontMgr()->GetBuiltinMapper();
-  font_mapper->SetSystemFontInfo(std::make_unique<SystemFontInfoWrapper>(
-      font_mapper->TakeSystemFontInfo()));
+  // Shared, so that per-thread engines use the renamed fonts as well.
+  font_mapper->SetSystemFontInfo(std::make_unique<CFX_SharedFontInfo>(
+      std::make_unique<SystemFontInfoWrapper>(
+          font_mapper->TakeSystemFontInfo())));
 }
 
 // static